@@ -17,6 +17,7 @@ echo --enable-qpipe   -  Includes QPipe files, defines CFG_QPIPE
 echo --enable-bt      -  Enables backtracing facility. defines CFG_BT
 echo --enable-simics  -  Adds the simics MAGIC instructions. defines CFG_SIMICS
 echo --enable-hack    -  Enables physical design haks. Padding padding TPC-B tables, and partitioning indexes, such as OL_IDX
+echo --enable-perfctrs - Hardware counters per xct type and region. defines CFG_PERFCTRS
 echo   
 echo   
 echo There are 3 supported compilation options
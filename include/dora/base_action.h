@@ -190,6 +190,12 @@ public:
     // should give memory back to the atomic trash stack
     virtual void giveback()=0;
 
+    // the perf counters region of the action type
+    virtual int perfctr_region() const { 
+        static const int region = ::perfctr_region("dora-action");
+        return (region); 
+    }
+
 #ifdef WORKER_VERBOSE_STATS
     void mark_enqueue();
     double waited();
@@ -117,6 +117,7 @@ public:
 
     // stats
     virtual void statistics(worker_stats_t& gather)=0;
+    virtual void peek_stats(worker_stats_t& gather)=0; // does not reset
     virtual void stlsize(uint& gather)=0;
 
     // dumps information
@@ -585,6 +585,9 @@ const int ACTIONS_PER_RVP_POOL_SZ = 30; // should be comparable with batch_sz
                 _in = in;                                               \
                 _range_act_set(axct,atid,prvp,keylen); }                \
             w_rc_t trx_exec();                                          \
+            int perfctr_region() const {                                \
+                static const int region = ::perfctr_region(#aname);     \
+                return (region); }                                      \
             void calc_keys(); }
 
 
@@ -608,6 +611,9 @@ const int ACTIONS_PER_RVP_POOL_SZ = 30; // should be comparable with batch_sz
                 _in = in;                                               \
                 _range_act_set(axct,atid,prvp,keylen); }                \
             w_rc_t trx_exec();                                          \
+            int perfctr_region() const {                                \
+                static const int region = ::perfctr_region(#aname);     \
+                return (region); }                                      \
             void calc_keys(); }
 
 
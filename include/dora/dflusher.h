@@ -136,7 +136,8 @@ public:
 
     dora_flusher_t(ShoreEnv* penv, c_str tname,
                    processorid_t aprsid = PBIND_NONE, 
-                   const int use_sli = 0);
+                   const int use_sli = 0,
+                   processorid_t anotifierprsid = PBIND_NONE);
     virtual ~dora_flusher_t();
 
     inline void enqueue_toflush(terminal_rvp_t* arvp) 
@@ -98,6 +98,10 @@ protected:
     // A vector of dora-flusher thread(s)
     std::vector<dora_flusher_t*> _vec_flusher;
 
+    // Topology-aware placement of the partitions and flushers, if 
+    // "dora-cpu-placement" is set to "topology"
+    guard<cpu_placement_t> _placement;
+
 public:
     
     DoraEnv();
@@ -149,6 +153,11 @@ protected:
     int _dump(ShoreEnv* penv);
     int _info(const ShoreEnv* penv) const;
     int _statistics(ShoreEnv* penv);
+    void _gather_worker_stats(worker_stats_t& agg);
+    void _gather_flusher_stats(flusher_stats_t& agg);
+
+    // creates the topology-aware placement, if configured
+    cpu_placement_t* _init_placement(ShoreEnv* penv);
 
     // algorithm for deciding the distribution of tables 
     processorid_t _next_cpu(const processorid_t& aprd,
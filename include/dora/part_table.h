@@ -40,6 +40,7 @@
 #include <cstdio>
 
 #include "util.h"
+#include "util/topology.h"
 
 #include "sm/shore/shore_env.h"
 #include "sm/shore/shore_table.h"
@@ -86,6 +87,9 @@ protected:
 
     // per partition key estimation
     uint               _key_estimation;
+
+    // topology-aware placement, if enabled (not owned)
+    cpu_placement_t*   _placement;
    
 public:
 
@@ -125,6 +129,13 @@ public:
     // decide the next processor
     virtual processorid_t next_cpu(const processorid_t& aprd);
 
+    // use the topology-aware placement instead of the cpu steps
+    void set_placement(cpu_placement_t* aplacement);
+
+    // the cpu of the apos-th out of atotal partitions, if placement is set
+    processorid_t placed_cpu(const uint apos, const uint atotal,
+                             const processorid_t& adefault);
+
     table_desc_t* table() const;
 
     //// For debugging ////
@@ -132,6 +143,9 @@ public:
     // information
     void statistics() const;
 
+    // adds up the worker stats of the partitions, without resetting them
+    void gather_stats(worker_stats_t& agg) const;
+
     // information
     void info() const;
 
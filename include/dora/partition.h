@@ -207,6 +207,7 @@ public:
 
     // stats
     virtual void statistics(worker_stats_t& gather);
+    virtual void peek_stats(worker_stats_t& gather);
 
     virtual void dump();
 
@@ -689,6 +690,12 @@ void partition_t<DataType>::statistics(worker_stats_t& gather)
     }
 }
 
+template <class DataType>
+void partition_t<DataType>::peek_stats(worker_stats_t& gather) 
+{
+    if (_owner) gather += _owner->get_stats();
+}
+
 
 /****************************************************************** 
  *
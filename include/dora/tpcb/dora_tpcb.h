@@ -87,6 +87,8 @@ public:
     int dump();
     int info() const;    
     int statistics();    
+    void gather_worker_stats(worker_stats_t& agg) { DoraEnv::_gather_worker_stats(agg); }
+    void gather_flusher_stats(flusher_stats_t& agg) { DoraEnv::_gather_flusher_stats(agg); }
     int conf();
 
 
@@ -4,11 +4,14 @@
 
 #include "util.h"
 #include "qpipe/core/tuple.h"
+#include "qpipe/core/functors.h"
+#include "qpipe/common/simd_select.h"
 #include <vector>
 #include <algorithm>
 #include <functional>
 #include <string>
 #include <cmath>
+#include <cstring>
 #include <cassert>
 
 using std::vector;
@@ -31,6 +34,27 @@ ENTER_NAMESPACE(qpipe);
 struct predicate_t {
     virtual bool select(const tuple_t &tuple)=0;
 
+    /**
+     * @brief Batch form of select(). (sel) holds (n) indexes of
+     * tuples of (stride) bytes starting at (base); the indexes of the
+     * tuples that pass are compacted, in order, to the front of (sel)
+     * and their count is returned. Conjunctions call it once per term
+     * on the shrinking vector instead of once per term per tuple.
+     *
+     * This default implementation calls select() once per tuple.
+     */
+    virtual size_t select_batch(const char* base, size_t stride,
+                                unsigned int* sel, size_t n)
+    {
+        size_t k = 0;
+        for (size_t i=0; i<n; i++) {
+            unsigned int idx = sel[i];
+            sel[k] = idx;
+            k += select(tuple_t((char*)base + idx*stride, stride));
+        }
+        return (k);
+    }
+
     virtual predicate_t* clone() const=0;
     
     virtual ~predicate_t() { }
@@ -56,14 +80,87 @@ public:
     {
     }
     virtual bool select(const tuple_t &tuple) {
-        V* field = aligned_cast<V>(tuple.data + _offset);
-        return T<V>()(*field, _value);
+        V field = load_field<V>(tuple.data + _offset);
+        return T<V>()(field, _value);
+    }
+    virtual size_t select_batch(const char* base, size_t stride,
+                                unsigned int* sel, size_t n)
+    {
+        return (batch_cmp_t<V,T>::select(base, stride, _offset, _value, sel, n));
     }
     virtual scalar_predicate_t* clone() const {
         return new scalar_predicate_t(*this);
     }
 };
 
+
+
+/**
+ * @brief range predicate. Selects the tuples whose field at the
+ * given offset lies in [lo, hi]. Equivalent to the conjunction of two
+ * scalar predicates, but tests both bounds in one pass.
+ */
+
+template <typename V>
+class range_predicate_t : public predicate_t {
+    V _lo;
+    V _hi;
+    size_t _offset;
+public:
+    range_predicate_t(V lo, V hi, size_t offset)
+        : _lo(lo), _hi(hi), _offset(offset)
+    {
+    }
+    virtual bool select(const tuple_t &tuple) {
+        V field = load_field<V>(tuple.data + _offset);
+        return !(field < _lo) && !(_hi < field);
+    }
+    virtual size_t select_batch(const char* base, size_t stride,
+                                unsigned int* sel, size_t n)
+    {
+        return (batch_cmp_t<V,less>::select_range(base, stride, _offset,
+                                                  _lo, _hi, sel, n));
+    }
+    virtual range_predicate_t* clone() const {
+        return new range_predicate_t(*this);
+    }
+};
+
+
+
+/**
+ * @brief range predicate on a fixed-length string field, e.g. a
+ * 'YYYY-MM-DD' date stored as FIXCHAR. Selects the tuples whose first
+ * lo.size() chars are in [lo, hi). Only that prefix is compared, so
+ * whatever follows it in the field does not matter.
+ */
+class fixchar_range_predicate_t : public predicate_t {
+    string _lo;
+    string _hi;
+    size_t _offset;
+public:
+    fixchar_range_predicate_t(const string &lo, const string &hi, size_t offset)
+        : _lo(lo), _hi(hi), _offset(offset)
+    {
+        assert(_lo.size() == _hi.size());
+    }
+    virtual bool select(const tuple_t &tuple) {
+        const char* field = tuple.data + _offset;
+        size_t len = _lo.size();
+        return (memcmp(field, _lo.data(), len) >= 0) &&
+            (memcmp(field, _hi.data(), len) < 0);
+    }
+    virtual size_t select_batch(const char* base, size_t stride,
+                                unsigned int* sel, size_t n)
+    {
+        return (fixchar_range_select(base, stride, _offset, _lo.data(),
+                                     _hi.data(), _lo.size(), sel, n));
+    }
+    virtual fixchar_range_predicate_t* clone() const {
+        return new fixchar_range_predicate_t(*this);
+    }
+};
+
 /**
  * @brief string predicate. Given a field type and offset in the
  * tuple, it extracts the field and tests it against the given
@@ -92,7 +189,54 @@ public:
 
 
 /**
- * @brief string predicate that performs 'like' comparisons.
+ * @brief Precompiled substring search (Boyer-Moore-Horspool). The
+ * skip table is built once per pattern, so the per-tuple cost is a
+ * sublinear scan instead of strstr's restart at every position.
+ */
+class substring_matcher_t {
+    string _needle;
+    unsigned int _skip[256];
+public:
+    substring_matcher_t(const string &needle)
+        : _needle(needle)
+    {
+        size_t m = _needle.size();
+        for (int c=0; c<256; c++)
+            _skip[c] = m;
+        for (size_t i=0; i+1 < m; i++)
+            _skip[(unsigned char)_needle[i]] = m - 1 - i;
+    }
+
+    size_t size() const { return _needle.size(); }
+
+    // returns the first occurrence in [hay, hay+len), or NULL
+    const char* find(const char* hay, size_t len) const {
+        size_t m = _needle.size();
+        if (m == 0)
+            return (hay);
+        if (len < m)
+            return (NULL);
+
+        const char* needle = _needle.data();
+        size_t last = m - 1;
+        for (size_t pos=0; pos <= len - m; ) {
+            unsigned char c = hay[pos + last];
+            if (c == (unsigned char)needle[last] &&
+                !memcmp(hay + pos, needle, last))
+                return (hay + pos);
+            pos += _skip[c];
+        }
+        return (NULL);
+    }
+};
+
+
+
+/**
+ * @brief string predicate that performs 'like' comparisons. Only '%'
+ * is a wildcard. The pattern is split once into an anchored prefix,
+ * an anchored suffix and the inner fragments, which are compiled into
+ * substring matchers.
  */
 template <bool INVERTED=false>
 class like_predicate : public predicate_t {
@@ -102,30 +246,63 @@ class like_predicate : public predicate_t {
     string _bol;
     // the last fragment in tests without a trailing '%' (eg "%abc")
     string _eol;
+    // no '%' at all: _bol must match the whole field
+    bool _exact;
     // the fragments surrounded by '%' on both sides
-    typedef vector<string> fragment_list;
+    typedef vector<substring_matcher_t> fragment_list;
     fragment_list _fragments;
     void init(const string &value) {
+        vector<string> pieces;
         size_t beg = 0;
-        size_t end = value.find('%');
-
-        // bol fragment?
-        if(beg != end)
-            _bol = value.substr(beg, end);
-
-        // inner fragments
         while(1) {
-            beg = end;
-            end = value.find('%', end+1);
-            if(end == string::npos)
+            size_t end = value.find('%', beg);
+            if(end == string::npos) {
+                pieces.push_back(value.substr(beg));
                 break;
-            
-            _fragments.push_back(value.substr(beg, end));
+            }
+            pieces.push_back(value.substr(beg, end - beg));
+            beg = end + 1;
         }
 
-        // eol fragment?
-        if((beg + 1) != value.size())
-            _eol = value.substr(beg, value.size());
+        _exact = (pieces.size() == 1);
+        _bol = pieces.front();
+        if(_exact)
+            return;
+
+        _eol = pieces.back();
+        for(size_t i=1; i+1 < pieces.size(); i++) {
+            if(pieces[i].size())
+                _fragments.push_back(substring_matcher_t(pieces[i]));
+        }
+    }
+
+    bool match(const char* field) const {
+        const char* end = field + strlen(field);
+        size_t bol = _bol.size();
+        size_t eol = _eol.size();
+
+        // check bol fragment
+        if((size_t)(end - field) < bol || memcmp(field, _bol.data(), bol))
+            return false;
+        field += bol;
+        if(_exact)
+            return (field == end);
+
+        // check eol fragment; it may not overlap the bol one
+        if((size_t)(end - field) < eol || memcmp(end - eol, _eol.data(), eol))
+            return false;
+        end -= eol;
+
+        // check inner fragments, in order and without overlap
+        for(fragment_list::const_iterator it=_fragments.begin(); it != _fragments.end(); ++it) {
+            const char* mark = it->find(field, end - field);
+            if(!mark)
+                return false;
+            field = mark + it->size();
+        }
+
+        // full match
+        return true;
     }
 public:
     like_predicate(const string &value, size_t offset)
@@ -135,38 +312,18 @@ public:
         init(value);
     }
     virtual bool select(const tuple_t &tuple) {
-        const char* field = tuple.data + _offset;
-        const char* mark;
-
-        // check bol fragment
-        if(_bol.size()) {
-            mark = strstr(field, _bol.c_str());
-            if(mark != field)
-                return INVERTED;
-            
-            // bol match
-            field = mark + _bol.size();
-        }
-
-        // check inner fragments
-        for(fragment_list::iterator it=_fragments.begin(); it != _fragments.end(); ++it) {
-            mark = strstr(field, it->c_str());
-            if(!mark)
-                return INVERTED;
-            
-            field = mark + it->size();
-        }
-            
-        // check eol fragment
-        if(_eol.size()) {
-            mark = strstr(field, _eol.c_str());
-            // not found || not at the end (hit the '\0' terminator)
-            if(!mark || mark[_eol.size()])
-                return INVERTED;
+        return match(tuple.data + _offset) != INVERTED;
+    }
+    virtual size_t select_batch(const char* base, size_t stride,
+                                unsigned int* sel, size_t n)
+    {
+        size_t k = 0;
+        for (size_t i=0; i<n; i++) {
+            unsigned int idx = sel[i];
+            sel[k] = idx;
+            k += (match(base + idx*stride + _offset) != INVERTED);
         }
-
-        // full match
-        return !INVERTED;
+        return (k);
     }
     virtual like_predicate* clone() const {
         return new like_predicate(*this);
@@ -190,9 +347,23 @@ public:
     {
     }
     virtual bool select(const tuple_t &tuple) {
-        V* field1 = aligned_cast<V>(tuple.data + _offset1);
-        V* field2 = aligned_cast<V>(tuple.data + _offset2);
-        return T<V>()(*field1, *field2);
+        V field1 = load_field<V>(tuple.data + _offset1);
+        V field2 = load_field<V>(tuple.data + _offset2);
+        return T<V>()(field1, field2);
+    }
+    virtual size_t select_batch(const char* base, size_t stride,
+                                unsigned int* sel, size_t n)
+    {
+        T<V> cmp;
+        size_t k = 0;
+        for (size_t i=0; i<n; i++) {
+            unsigned int idx = sel[i];
+            const char* data = base + idx*stride;
+            sel[k] = idx;
+            k += cmp(load_field<V>(data + _offset1),
+                     load_field<V>(data + _offset2));
+        }
+        return (k);
     }
     virtual field_predicate_t* clone() const {
         return new field_predicate_t(*this);
@@ -255,6 +426,20 @@ public:
         // the list; else success means we did
         return DISJUNCTION? result != _list.end() : result == _list.end();
     }
+    virtual size_t select_batch(const char* base, size_t stride,
+                                unsigned int* sel, size_t n)
+    {
+        // a disjunction would need to merge the per-term vectors;
+        // evaluate it tuple at a time
+        if(DISJUNCTION)
+            return (predicate_t::select_batch(base, stride, sel, n));
+
+        // a conjunction refines the vector term by term
+        predicate_list_t::iterator it;
+        for(it=_list.begin(); n && it != _list.end(); ++it)
+            n = (*it)->select_batch(base, stride, sel, n);
+        return (n);
+    }
     virtual compound_predicate_t* clone() const {
         return new compound_predicate_t(*this);
     }
@@ -280,6 +465,57 @@ typedef compound_predicate_t<true> or_predicate_t;
 
 
 
+/**
+ * @brief Selection filter driven by a predicate. Since select() and
+ * project() share no state, the stage adaptor evaluates it a page at a
+ * time through select_page(). Subclasses may override project() as
+ * long as it depends only on its source tuple.
+ */
+class predicate_filter_t : public tuple_filter_t {
+    predicate_t* _predicate;
+    c_str _name;
+public:
+    predicate_filter_t(size_t input_tuple_size, predicate_t* predicate,
+                       const c_str &name)
+        : tuple_filter_t(input_tuple_size),
+          _predicate(predicate), _name(name)
+    {
+    }
+    predicate_filter_t(const predicate_filter_t &other)
+        : tuple_filter_t(other),
+          _predicate(other._predicate->clone()), _name(other._name)
+    {
+    }
+    virtual ~predicate_filter_t() {
+        delete _predicate;
+    }
+
+    virtual bool select(const tuple_t &tuple) {
+        return _predicate->select(tuple);
+    }
+    virtual size_t select_page(page* p, selection_t &sel) {
+        sel.fill(p->tuple_count());
+        size_t n = _predicate->select_batch(p->base(), p->tuple_size(),
+                                            sel.data(), sel.size());
+        sel.set_size(n);
+        return (n);
+    }
+    virtual bool batch_select() const {
+        return true;
+    }
+    virtual predicate_filter_t* clone() const {
+        return new predicate_filter_t(*this);
+    }
+    virtual c_str to_string() const {
+        return _name;
+    }
+
+private:
+    predicate_filter_t &operator =(const predicate_filter_t &);
+};
+
+
+
 /**
  * @brief Use a special wrapper class around randgen_t when we
  * generate predicates so we can control whether predicates are
@@ -0,0 +1,246 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   simd_select.h
+ *
+ *  @brief:  Batch comparison kernels used by predicate_t::select_batch().
+ *
+ *  Each kernel refines a selection vector in place: it walks the
+ *  (n) tuple indexes in (sel), compares the field at (offset) of each
+ *  tuple against a constant, and compacts the indexes of the tuples
+ *  that pass to the front of (sel). The write of an index is
+ *  unconditional and only the output cursor depends on the
+ *  comparison, so the loops carry no data-dependent branches.
+ *
+ *  With SSE2, 32-bit integer fields are compared four at a time. The
+ *  pages are row-major, so the four lanes are gathered with scalar
+ *  loads; the win is the single compare and the branch-free
+ *  compaction of the movemask result.
+ *
+ *  The fields are loaded with memcpy, since the table scans produce
+ *  records in the disk format, whose fields need not be aligned.
+ *  Fixed-length strings (e.g. the 'YYYY-MM-DD' dates of TPC-H) have
+ *  no SIMD kernel; they are compared with memcmp on their prefix.
+ */
+
+#ifndef __QPIPE_SIMD_SELECT_H
+#define __QPIPE_SIMD_SELECT_H
+
+#include "util.h"
+#include <functional>
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+
+
+ENTER_NAMESPACE(qpipe);
+
+
+
+/**
+ * @brief Reads the field at (data), which may be unaligned.
+ */
+template <typename V>
+inline V load_field(const char* data)
+{
+    V value;
+    memcpy(&value, data, sizeof(V));
+    return (value);
+}
+
+
+/**
+ * @brief Scalar kernels. Work for any V that T<V> can compare.
+ */
+template <typename V, template<class> class T>
+inline size_t scalar_cmp_select(const char* base, size_t stride, size_t offset,
+                                const V &value, unsigned int* sel,
+                                size_t i, size_t k, size_t n)
+{
+    T<V> cmp;
+    for ( ; i<n; i++) {
+        unsigned int idx = sel[i];
+        V field = load_field<V>(base + idx*stride + offset);
+        sel[k] = idx;
+        k += cmp(field, value);
+    }
+    return (k);
+}
+
+template <typename V>
+inline size_t scalar_range_select(const char* base, size_t stride, size_t offset,
+                                  const V &lo, const V &hi, unsigned int* sel,
+                                  size_t i, size_t k, size_t n)
+{
+    for ( ; i<n; i++) {
+        unsigned int idx = sel[i];
+        V field = load_field<V>(base + idx*stride + offset);
+        sel[k] = idx;
+        k += (!(field < lo) & !(hi < field));
+    }
+    return (k);
+}
+
+
+/**
+ * @brief Selects the fixed-length strings whose first (len) chars are
+ * in [lo, hi). There is no SIMD version, the compares are memcmp on
+ * the prefix, but the compaction is still branch-free.
+ */
+inline size_t fixchar_range_select(const char* base, size_t stride, size_t offset,
+                                   const char* lo, const char* hi, size_t len,
+                                   unsigned int* sel, size_t n)
+{
+    size_t k = 0;
+    for (size_t i=0; i<n; i++) {
+        unsigned int idx = sel[i];
+        const char* field = base + idx*stride + offset;
+        sel[k] = idx;
+        k += ((memcmp(field, lo, len) >= 0) & (memcmp(field, hi, len) < 0));
+    }
+    return (k);
+}
+
+
+template <typename V, template<class> class T>
+struct batch_cmp_t {
+
+    static size_t select(const char* base, size_t stride, size_t offset,
+                         const V &value, unsigned int* sel, size_t n)
+    {
+        return (scalar_cmp_select<V,T>(base, stride, offset, value, sel, 0, 0, n));
+    }
+
+    static size_t select_range(const char* base, size_t stride, size_t offset,
+                               const V &lo, const V &hi,
+                               unsigned int* sel, size_t n)
+    {
+        return (scalar_range_select<V>(base, stride, offset, lo, hi, sel, 0, 0, n));
+    }
+};
+
+
+
+#ifdef __SSE2__
+
+/**
+ * @brief Lane masks for the std comparators on 32-bit ints. The
+ * primary template marks a comparator without an SSE2 equivalent.
+ */
+template <template<class> class T>
+struct sse_int_cmp_t {
+    enum { ENABLED = 0 };
+    static __m128i mask(__m128i x, __m128i) { return (x); }
+};
+
+#define DEFINE_SSE_INT_CMP(cmp, expr)                                   \
+    template <> struct sse_int_cmp_t<std::cmp> {                        \
+        enum { ENABLED = 1 };                                           \
+        static __m128i mask(__m128i x, __m128i v) { return (expr); }    \
+    };
+
+DEFINE_SSE_INT_CMP(equal_to,      _mm_cmpeq_epi32(x, v))
+DEFINE_SSE_INT_CMP(less,          _mm_cmplt_epi32(x, v))
+DEFINE_SSE_INT_CMP(greater,       _mm_cmpgt_epi32(x, v))
+DEFINE_SSE_INT_CMP(not_equal_to,  _mm_xor_si128(_mm_cmpeq_epi32(x, v), _mm_set1_epi32(-1)))
+DEFINE_SSE_INT_CMP(less_equal,    _mm_xor_si128(_mm_cmpgt_epi32(x, v), _mm_set1_epi32(-1)))
+DEFINE_SSE_INT_CMP(greater_equal, _mm_xor_si128(_mm_cmplt_epi32(x, v), _mm_set1_epi32(-1)))
+
+#undef DEFINE_SSE_INT_CMP
+
+
+// gathers the int at (offset) of the four tuples idx[0..3]
+static inline __m128i sse_gather_int(const char* base, size_t stride,
+                                     size_t offset, const unsigned int* idx)
+{
+    return (_mm_set_epi32(load_field<int>(base + idx[3]*stride + offset),
+                          load_field<int>(base + idx[2]*stride + offset),
+                          load_field<int>(base + idx[1]*stride + offset),
+                          load_field<int>(base + idx[0]*stride + offset)));
+}
+
+// appends the lanes of idx[0..3] whose bit is set in (bits) at sel[k]
+static inline size_t sse_compact(unsigned int* sel, size_t k,
+                                 const unsigned int* idx, int bits)
+{
+    sel[k] = idx[0]; k += bits & 1;
+    sel[k] = idx[1]; k += (bits >> 1) & 1;
+    sel[k] = idx[2]; k += (bits >> 2) & 1;
+    sel[k] = idx[3]; k += (bits >> 3) & 1;
+    return (k);
+}
+
+static inline int sse_bits(__m128i m) {
+    return (_mm_movemask_ps(_mm_castsi128_ps(m)));
+}
+
+
+template <template<class> class T>
+struct batch_cmp_t<int, T> {
+
+    static size_t select(const char* base, size_t stride, size_t offset,
+                         const int &value, unsigned int* sel, size_t n)
+    {
+        size_t i = 0;
+        size_t k = 0;
+        if (sse_int_cmp_t<T>::ENABLED) {
+            __m128i v = _mm_set1_epi32(value);
+            for ( ; i+4 <= n; i+=4) {
+                // copy out first: the compacted writes may overlap them
+                unsigned int idx[4] = { sel[i], sel[i+1], sel[i+2], sel[i+3] };
+                __m128i x = sse_gather_int(base, stride, offset, idx);
+                k = sse_compact(sel, k, idx, sse_bits(sse_int_cmp_t<T>::mask(x, v)));
+            }
+        }
+        return (scalar_cmp_select<int,T>(base, stride, offset, value, sel, i, k, n));
+    }
+
+    static size_t select_range(const char* base, size_t stride, size_t offset,
+                               const int &lo, const int &hi,
+                               unsigned int* sel, size_t n)
+    {
+        __m128i vlo = _mm_set1_epi32(lo);
+        __m128i vhi = _mm_set1_epi32(hi);
+        size_t i = 0;
+        size_t k = 0;
+        for ( ; i+4 <= n; i+=4) {
+            unsigned int idx[4] = { sel[i], sel[i+1], sel[i+2], sel[i+3] };
+            __m128i x = sse_gather_int(base, stride, offset, idx);
+            __m128i out = _mm_or_si128(_mm_cmplt_epi32(x, vlo),
+                                       _mm_cmpgt_epi32(x, vhi));
+            k = sse_compact(sel, k, idx, ~sse_bits(out) & 0xf);
+        }
+        return (scalar_range_select<int>(base, stride, offset, lo, hi, sel, i, k, n));
+    }
+};
+
+#endif
+
+
+
+EXIT_NAMESPACE(qpipe);
+
+#endif
@@ -24,10 +24,14 @@
 #ifndef __QPIPE_CORE_H
 #define __QPIPE_CORE_H
 
+#include "qpipe/core/coro_sched.h"
 #include "qpipe/core/cpu_bind.h"
 #include "qpipe/core/dispatcher.h"
 #include "qpipe/core/functors.h"
+#include "qpipe/core/mem_broker.h"
 #include "qpipe/core/packet.h"
+#include "qpipe/core/result_cache.h"
+#include "qpipe/core/page_file.h"
 #include "qpipe/core/stage.h"
 #include "qpipe/core/stage_container.h"
 #include "qpipe/core/tuple.h"
@@ -0,0 +1,213 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+#ifndef __QPIPE_CORO_SCHED_H
+#define __QPIPE_CORO_SCHED_H
+
+#include "util.h"
+#include <ucontext.h>
+#include <deque>
+#include <vector>
+
+
+ENTER_NAMESPACE(qpipe);
+
+
+/* exported constants */
+
+static const int    CORO_DEFAULT_SCHEDULERS = 0;  /* 0: thread per stage */
+static const size_t CORO_DEFAULT_STACK_KB   = 256;
+
+
+/* exported datatypes */
+
+class coro_sched_t;
+class coro_pool_t;
+typedef void (*coro_func_t)(void* arg);
+
+
+/**
+ *  @brief A stage worker that runs on a user-level context instead of
+ *  its own thread. It runs on one of the scheduler threads of the
+ *  coro_pool_t until it parks (e.g., on a full or empty tuple_fifo)
+ *  and it is woken up again, possibly on another scheduler.
+ *
+ *  Only code that keeps no per-thread state across a park may run in
+ *  a coroutine. The storage manager does (attached xct, latches), so
+ *  the stages that call it keep their own threads.
+ */
+class coro_t {
+
+    friend class coro_sched_t;
+    friend class coro_pool_t;
+
+public:
+
+    enum coro_state_t {
+        CS_READY,
+        CS_RUNNING,
+        CS_PARKING,     /* switching out, then waits for wake() */
+        CS_WAITING,
+        CS_YIELDING,    /* switching out, then back to a run queue */
+        CS_DONE
+    };
+
+private:
+
+    ucontext_t    _ctx;
+    char*         _stack;
+    size_t        _stack_size;
+
+    coro_func_t   _func;
+    void*         _arg;
+
+    volatile coro_state_t _state;
+    coro_sched_t*         _sched;     /* where it runs or ran last */
+    pthread_mutex_t*      _release;   /* unlocked once it parked */
+
+    static void _trampoline();
+
+    coro_t(coro_func_t func, void* arg, size_t stack_size);
+    ~coro_t();
+
+public:
+
+    /**
+     *  @brief The coroutine running on the calling thread, NULL if the
+     *  caller is an ordinary thread.
+     */
+    static coro_t* self();
+
+    /**
+     *  @brief Switches out until someone calls wake(). The caller must
+     *  hold 'mutex', which is released once the switch is complete and
+     *  locked again before park() returns. Whoever wakes us must do it
+     *  while holding the same mutex, so no wake-up is lost.
+     */
+    static void park(pthread_mutex_t &mutex);
+
+    /**
+     *  @brief Goes to the back of the run queue, letting the other
+     *  coroutines of the scheduler run.
+     */
+    static void yield();
+
+    /**
+     *  @brief Makes a parked coroutine runnable again, on the
+     *  scheduler it last ran on.
+     */
+    static void wake(coro_t* coro);
+};
+
+
+
+/**
+ *  @brief One scheduler thread (per core). It runs the coroutines of
+ *  its run queue and, when that is empty, steals from the other
+ *  schedulers.
+ */
+class coro_sched_t : public thread_t {
+
+    friend class coro_t;
+    friend class coro_pool_t;
+
+    coro_pool_t*        _pool;
+    int                 _id;
+    ucontext_t          _main;
+
+    pthread_mutex_t     _lock;
+    std::deque<coro_t*> _runq;
+
+    /* stats (don't affect correctness) */
+    uint64_t _switches;
+    uint64_t _steals;
+
+    void    _push(coro_t* coro);
+    coro_t* _pop();
+    coro_t* _steal();
+    void    _run(coro_t* coro);
+
+public:
+
+    coro_sched_t(const c_str &name, coro_pool_t* pool, int id);
+    ~coro_sched_t();
+
+    virtual void work();
+};
+
+
+
+/**
+ *  @brief The fixed pool of schedulers. Singleton, created on the
+ *  first spawn() with the number of schedulers of the
+ *  "qpipe-coro-schedulers" parameter (-1 for one per CPU).
+ */
+class coro_pool_t {
+
+    friend class coro_t;
+    friend class coro_sched_t;
+
+    std::vector<coro_sched_t*> _scheds;
+    size_t _stack_size;
+
+    /* idle schedulers sleep here until something is runnable */
+    pthread_mutex_t _idle_lock;
+    pthread_cond_t  _idle_cond;
+    int             _sleeping;
+    volatile uint_t _runnable;
+    volatile uint_t _next;     /* round-robin placement of new ones */
+
+    static coro_pool_t*    _instance;
+    static pthread_mutex_t _instance_lock;
+
+    coro_pool_t(int schedulers, size_t stack_size);
+    ~coro_pool_t() { }
+
+    void _ready(coro_sched_t* sched, coro_t* coro);
+    bool _idle_wait();
+
+public:
+
+    /**
+     *  @brief Whether the stages should run as coroutines at all. It
+     *  is read once, from "qpipe-coro-schedulers".
+     */
+    static bool enabled();
+
+    static coro_pool_t* instance();
+
+    /**
+     *  @brief Creates a coroutine that runs func(arg) and queues it
+     *  on one of the schedulers.
+     */
+    void spawn(coro_func_t func, void* arg);
+
+    void print_stats();
+};
+
+
+
+EXIT_NAMESPACE(qpipe);
+
+
+#endif
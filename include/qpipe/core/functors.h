@@ -73,6 +73,43 @@ public:
     }
 
 
+    /**
+     *  @brief Page-at-a-time selection. Fills (sel) with the indexes
+     *  of the tuples of (p) that pass select() and returns their
+     *  count. The caller then project()s the selected tuples.
+     *
+     *  Only called when batch_select() is true. Filters whose
+     *  project() relies on state left behind by the last select()
+     *  (eg the tscan filters that load the row in select) must keep
+     *  the tuple-at-a-time path.
+     *
+     *  This default implementation calls select() once per tuple.
+     */
+
+    virtual size_t select_page(page* p, selection_t &sel) {
+        size_t count = p->tuple_count();
+        sel.reserve(count);
+        unsigned int* idx = sel.data();
+        size_t n = 0;
+        for (size_t i=0; i<count; i++) {
+            idx[n] = i;
+            n += select(p->get_tuple(i));
+        }
+        sel.set_size(n);
+        return (n);
+    }
+
+
+    /**
+     *  @brief True if select_page() may be used in place of select()
+     *  for this filter, ie if select() and project() are independent.
+     */
+
+    virtual bool batch_select() const {
+        return false;
+    }
+
+
     /**
      *  @brief Project some threads from the src to the dest tuple.
      *
@@ -123,6 +160,15 @@ struct trivial_filter_t : public tuple_filter_t {
         // nothing happens
         return c_str::EMPTY_STRING;
     }
+
+    virtual size_t select_page(page* p, selection_t &sel) {
+        sel.fill(p->tuple_count());
+        return (sel.size());
+    }
+
+    virtual bool batch_select() const {
+        return true;
+    }
     
     trivial_filter_t(size_t input_tuple_size)
         : tuple_filter_t(input_tuple_size)
@@ -0,0 +1,199 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+   
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+   
+                         All Rights Reserved.
+   
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+   
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+#ifndef __QPIPE_MEM_BROKER_H
+#define __QPIPE_MEM_BROKER_H
+
+#include "util.h"
+#include "qpipe/core/coro_sched.h"
+
+#include <map>
+#include <deque>
+
+
+ENTER_NAMESPACE(qpipe);
+
+
+/* exported constants */
+
+static const int MEM_BROKER_DEFAULT_PAGES = 0;    /* 0: no budget */
+static const int MEM_BROKER_MIN_GRANT     = 64;   /* pages */
+static const int MEM_BROKER_MAX_WAIT_MS   = 2000;
+
+
+/* exported datatypes */
+
+class mem_grant_t;
+class mem_broker_timer_t;
+
+
+/**
+ *  @brief The memory broker. Singleton that shares a budget of
+ *  "qpipe-mem-pages" pages among the packets of the memory hungry
+ *  stages (hash join, aggregation, sort), the way the dispatcher
+ *  shares the worker threads.
+ *
+ *  A stage asks for a grant when it starts a packet and gives it back
+ *  when the packet is done. If the budget cannot cover the whole
+ *  request the packet gets what is left (but at least its minimum)
+ *  and spills to disk earlier. If not even the minimum is left, the
+ *  packet waits until other packets release their grants. The waiters
+ *  are queued and admitted in FIFO order as the pages are released;
+ *  threads sleep on a condition variable, coroutines park. A running
+ *  packet can grow its grant from the free pages, unless someone is
+ *  waiting and it already holds its fair share.
+ *
+ *  Stages that depend on each other through their tuple_fifo's may
+ *  hold memory while waiting for one another. So a packet does not
+ *  wait for more than MEM_BROKER_MAX_WAIT_MS, after that it gets its
+ *  minimum over the budget. Coroutines have no timers, so a timer
+ *  thread, started by the first wait, expires the waiters.
+ *
+ *  With no budget (the default) every request is granted in full and
+ *  the grants are only tracked, to be printed.
+ */
+class mem_broker_t {
+
+    friend class mem_grant_t;
+
+    struct grant_info_t {
+        c_str _owner;
+        int   _wanted;
+        int   _pages;
+        bool  _downgraded;
+    };
+
+    typedef std::map<int, grant_info_t> grant_map_t;
+
+    enum waiter_state_t { WS_WAITING, WS_ADMITTED, WS_EXPIRED };
+
+    struct waiter_t {
+        int            _min;
+        long long      _deadline;   /* ms, then it is expired */
+        coro_t*        _coro;       /* NULL for a thread, which waits on _cond */
+        pthread_cond_t _cond;
+        volatile waiter_state_t _state;
+    };
+
+    pthread_mutex_t _lock;
+
+    int         _total;         /* the budget, in pages */
+    int         _granted;
+    int         _reserved;      /* the minimum of the admitted waiters */
+    int         _waiting;
+    int         _next_id;
+    grant_map_t _grants;
+
+    std::deque<waiter_t*> _waiters;    /* in arrival order */
+    mem_broker_timer_t*   _timer;
+    pthread_cond_t        _timer_cond;
+
+    /* stats (don't affect correctness) */
+    uint64_t _requests;
+    uint64_t _downgrades;
+    uint64_t _waits;
+    uint64_t _overcommits;
+    uint64_t _growths;
+    uint64_t _refusals;
+
+    static mem_broker_t*   _instance;
+    static pthread_mutex_t _instance_lock;
+
+    mem_broker_t(int total);
+    ~mem_broker_t() { }
+
+    int  _free() const;
+    int  _fair_share() const;
+    bool _wait(int min);
+    void _wake(waiter_t* waiter, waiter_state_t state);
+    void _admit();
+
+    int  _acquire(const c_str &owner, int want, int min, int &id);
+    int  _grow(int id, int extra, bool force);
+    void _release(int id);
+
+public:
+
+    static mem_broker_t* instance();
+
+    /**
+     *  @brief The loop of the timer thread. It expires the oldest
+     *  waiter once it has waited for MEM_BROKER_MAX_WAIT_MS.
+     */
+    void expire_waiters();
+
+    bool enabled() const { return (_total > 0); }
+
+    void print_grants();
+    void print_stats();
+};
+
+
+
+/**
+ *  @brief The pages a packet got from the broker. The grant is given
+ *  back by release() or when the object goes out of scope, so a
+ *  process_packet() that returns early does not leak it.
+ */
+class mem_grant_t {
+
+    int _id;
+    int _pages;
+
+public:
+
+    mem_grant_t()
+        : _id(0), _pages(0)
+    {
+    }
+
+    ~mem_grant_t() {
+        release();
+    }
+
+    /**
+     *  @brief Asks for 'want' pages. Returns the pages granted, which
+     *  are less than 'want' (but not less than 'min') when the budget
+     *  is tight. It blocks while not even 'min' pages are free.
+     */
+    int acquire(const c_str &owner, int want, int min=MEM_BROKER_MIN_GRANT);
+
+    /**
+     *  @brief Asks for 'extra' more pages without blocking. Returns
+     *  the pages added to the grant, 0 if the caller should spill
+     *  instead. Stages that cannot spill 'force' the growth, so that
+     *  the pages they use are still accounted.
+     */
+    int grow(int extra, bool force=false);
+
+    void release();
+
+    int pages() const { return (_pages); }
+};
+
+
+
+EXIT_NAMESPACE(qpipe);
+
+
+#endif
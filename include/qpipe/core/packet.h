@@ -25,6 +25,7 @@
 #define __QPIPE_PACKET_H
 
 #include <list>
+#include <vector>
 #include "qpipe/core/tuple.h"
 #include "qpipe/core/tuple_fifo.h"
 #include "qpipe/core/functors.h"
@@ -53,6 +54,25 @@ void set_osp_for_type(const c_str& packet_type, bool osp_switch);
 class   packet_t;
 typedef list<packet_t*> packet_list_t;
 
+
+/* A snapshot of the version of some data (e.g. a table), whose
+   counter is bumped by every write to it. */
+struct data_version_t {
+    volatile unsigned int const* counter;
+    unsigned int version;
+
+    data_version_t(volatile unsigned int const* c)
+        : counter(c), version(*c)
+    {
+    }
+
+    bool current() const {
+        return (*counter == version);
+    }
+};
+
+typedef std::vector<data_version_t> data_version_list_t;
+
 struct query_plan {
     c_str action;
     c_str filter;
@@ -234,6 +254,21 @@ public:
     }
     
     virtual void declare_worker_needs(resource_declare_t* declare)=0;
+
+    /**
+     *  @brief Appends the packets that produce our input (not yet
+     *  dispatched). Used by the scheduling policies that walk the
+     *  packet tree.
+     */
+    virtual void get_producers(std::vector<packet_t*> &) { }
+
+    /**
+     *  @brief Appends the versions of the data our output is computed
+     *  from, by default those of our producers. Returns false if the
+     *  output cannot be reused by the result cache, because it depends
+     *  on anything else or producing it has side effects.
+     */
+    virtual bool get_versions(data_version_list_t &versions);
 };
 
 
@@ -0,0 +1,223 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+   
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+   
+                         All Rights Reserved.
+   
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+   
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+#ifndef __QPIPE_PAGE_FILE_H
+#define __QPIPE_PAGE_FILE_H
+
+#include "util.h"
+#include "qpipe/core/tuple.h"
+
+#include <deque>
+#include <vector>
+
+
+ENTER_NAMESPACE(qpipe);
+
+
+/* exported constants */
+
+static const int PAGE_IO_DEFAULT_THREADS = 2;    /* 0: synchronous I/O */
+static const int PAGE_IO_ALIGN           = 4096; /* of the batch buffers, for O_DIRECT */
+static const int PAGE_FILE_WRITE_BEHIND  = 8;    /* pages */
+static const int PAGE_FILE_READ_AHEAD    = 16;   /* pages */
+static const int PAGE_FILE_SPARES        = 2;    /* written pages kept for reuse */
+
+
+/* exported datatypes */
+
+class page_io_pool_t;
+
+
+/**
+ *  @brief A file of whole pages, written and read in order, for the
+ *  stages that spill (the tuple_fifo overflow files and the hash join
+ *  partitions).
+ *
+ *  The I/O is done by the threads of the page_io_pool_t. A write
+ *  queues the page and returns, unless PAGE_FILE_WRITE_BEHIND pages
+ *  are already queued. Once the reader asks for the first page, the
+ *  file keeps up to PAGE_FILE_READ_AHEAD of the written pages read
+ *  ahead. Each I/O thread writes or reads a batch of consecutive
+ *  pages of a file with one system call, through an aligned buffer,
+ *  so that the file can also be opened with O_DIRECT. If the file
+ *  system refuses O_DIRECT at open() or on the first I/O (EINVAL), the
+ *  file uses buffered I/O instead.
+ *
+ *  With no I/O threads the caller does the I/O, one page at a time.
+ *
+ *  A page is stored as the page_size() bytes of its image, like
+ *  page::fwrite_full_page(), and all the pages of the file must be of
+ *  the default page size.
+ */
+class page_file_t {
+
+    friend class page_io_pool_t;
+
+    c_str  _name;
+    int    _fd;
+    size_t _page_size;
+
+    page_io_pool_t* _io;    /* NULL for synchronous I/O */
+
+    char* _buffer;          /* for the batches, _base is its aligned start */
+    void* _base;
+
+    pthread_mutex_t _lock;
+    pthread_cond_t  _cond;
+
+    /* writing: pages [_written, _pages) are in _writes */
+    std::deque<page*>  _writes;
+    std::vector<page*> _spares;
+    size_t _pages;
+    size_t _written;
+
+    /* reading: pages [_next_read, _next_read + _ready.size()) are in _ready */
+    std::deque<page*> _ready;
+    size_t _next_read;
+    bool   _read_ahead;
+
+    bool _busy;             /* queued on or served by an I/O thread */
+    int  _error;            /* errno of a failed I/O */
+    bool _direct;           /* opened with O_DIRECT */
+
+    bool _can_read_ahead() const;
+    bool _has_work() const;
+    void _schedule();
+    void _wait();
+    void _check_error();
+    void _recycle(page* p);
+
+    bool _drop_direct();
+    int  _write_pages(size_t first, size_t count);
+    int  _read_pages(size_t first, size_t count);
+    void _write_batch();
+    void _read_batch();
+    void _serve();
+
+public:
+
+    /**
+     *  @brief Opens the file. With 'create' it is created (or
+     *  truncated) to be written and read, otherwise the pages it has
+     *  are read.
+     *
+     *  @throw FileException if the file cannot be opened.
+     */
+    page_file_t(const c_str &name, bool create);
+
+    /**
+     *  @brief Waits for the queued writes and closes the file. The
+     *  file is not removed.
+     */
+    ~page_file_t();
+
+    /**
+     *  @brief Creates a temporary file, of a unique name starting with
+     *  'prefix', returned in 'name'.
+     */
+    static page_file_t* create_tmp(c_str &name, const c_str &prefix);
+
+    const c_str &name() const { return (_name); }
+
+    /**
+     *  @brief Appends the page. The file takes it and frees it once
+     *  written.
+     *
+     *  @throw FileException if a previous write failed.
+     */
+    void write(page* p);
+
+    /**
+     *  @brief Appends the page, like write(), and returns an empty one
+     *  of the same tuple size to fill next.
+     */
+    page* write_swap(page* p);
+
+    /**
+     *  @brief Waits until the appended pages are written.
+     *
+     *  @throw FileException if a write failed.
+     */
+    void flush();
+
+    /**
+     *  @brief Returns the next page, in the order they were appended,
+     *  NULL if no more pages were appended. The caller owns the page.
+     *
+     *  @throw FileException if the read failed.
+     */
+    page* read();
+};
+
+
+
+/**
+ *  @brief The I/O threads of the page files. Singleton, created with
+ *  "qpipe-io-threads" threads, NULL with none. The files that have
+ *  I/O to do are queued and served one batch at a time, so a file
+ *  never has more than one I/O in progress.
+ */
+class page_io_pool_t {
+
+    friend class page_file_t;
+
+    pthread_mutex_t _lock;
+    pthread_cond_t  _cond;
+    std::deque<page_file_t*> _queue;
+    int _threads;
+
+    /* stats (don't affect correctness) */
+    uint64_t _write_batches;
+    uint64_t _pages_written;
+    uint64_t _read_batches;
+    uint64_t _pages_read;
+    uint64_t _stalls;       /* waits of the writers and readers */
+
+    static page_io_pool_t* _instance;
+    static bool            _initialized;
+    static pthread_mutex_t _instance_lock;
+
+    page_io_pool_t(int threads);
+    ~page_io_pool_t() { }
+
+    void submit(page_file_t* file);
+    void count_batch(bool write, size_t pages);
+    void count_stall();
+
+public:
+
+    static page_io_pool_t* instance();
+
+    /* whether the files are opened with O_DIRECT ("qpipe-io-direct") */
+    static bool direct();
+
+    void work();
+    void print_stats();
+};
+
+
+
+EXIT_NAMESPACE(qpipe);
+
+
+#endif
@@ -0,0 +1,192 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+   
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+   
+                         All Rights Reserved.
+   
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+   
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+#ifndef __QPIPE_RESULT_CACHE_H
+#define __QPIPE_RESULT_CACHE_H
+
+#include "util.h"
+#include "qpipe/core/packet.h"
+#include "qpipe/core/tuple.h"
+
+#include <list>
+#include <map>
+#include <vector>
+
+
+ENTER_NAMESPACE(qpipe);
+
+
+/* exported constants */
+
+static const int RESULT_CACHE_DEFAULT_MB  = 0;    /* 0: disabled */
+static const int RESULT_CACHE_ENTRY_SHARE = 4;    /* an entry takes at most 1/4 of it */
+
+
+/* exported datatypes */
+
+class result_capture_t;
+
+
+/**
+ *  @brief The result cache. Singleton that keeps the output of
+ *  completed stages, so that a later packet with the same plan (the
+ *  same action and the same child filters and plans, all the way down
+ *  to the table scans) is answered without running the stage and its
+ *  whole subtree. It extends work sharing to queries that do not
+ *  overlap in time.
+ *
+ *  An entry holds the pages the stage produced, before any packet's
+ *  output filter, together with the versions of the tables its
+ *  subtree read. Every write to a table bumps its version, and an
+ *  entry is dropped when it is found to be stale. The entries share
+ *  "qpipe-result-cache-mb" megabytes and the least recently used
+ *  ones are evicted to make room.
+ *
+ *  Only the packets whose every producer reports the versions of the
+ *  data it reads (see packet_t::get_versions()) are cached. A packet
+ *  matches an entry only if its plan is equal to the one of the entry
+ *  in every filter, so the filters' to_string() must print all their
+ *  parameters, the same as required for merging.
+ */
+class result_cache_t {
+
+public:
+
+    struct entry_t {
+        c_str               _key;
+        data_version_list_t _versions;
+        std::vector<page*>  _pages;
+        size_t              _bytes;
+        int                 _refs;  /* the cache's and the readers' */
+    };
+
+private:
+
+    typedef std::list<entry_t*> lru_list_t;
+    typedef std::map<c_str, lru_list_t::iterator> entry_map_t;
+
+    pthread_mutex_t _lock;
+
+    size_t      _capacity;      /* in bytes */
+    size_t      _used;
+    lru_list_t  _lru;           /* the most recently used first */
+    entry_map_t _entries;
+
+    /* stats (don't affect correctness) */
+    uint64_t _lookups;
+    uint64_t _hits;
+    uint64_t _stale;
+    uint64_t _inserts;
+    uint64_t _evictions;
+
+    static result_cache_t* _instance;
+    static pthread_mutex_t _instance_lock;
+
+    result_cache_t(size_t capacity);
+    ~result_cache_t() { }
+
+    void _remove(entry_map_t::iterator it);
+    void _unref(entry_t* entry);
+
+public:
+
+    static result_cache_t* instance();
+
+    bool enabled() const { return (_capacity > 0); }
+
+    size_t max_entry_bytes() const {
+        return (_capacity / RESULT_CACHE_ENTRY_SHARE);
+    }
+
+    /**
+     *  @brief Computes the key of the packet's output and takes a
+     *  snapshot of the versions of the data it is computed from.
+     *  Returns false if the output cannot be cached, or is not worth
+     *  caching (the output of a table scan).
+     */
+    static bool signature(packet_t* packet, c_str &key,
+                          data_version_list_t &versions);
+
+    /**
+     *  @brief Returns the entry for the key, if its versions are the
+     *  given ones, NULL otherwise. The caller reads the pages of the
+     *  entry and gives it back with release().
+     */
+    entry_t* acquire(const c_str &key, const data_version_list_t &versions);
+    void release(entry_t* entry);
+
+    /**
+     *  @brief Takes the pages of the capture as the entry of the key,
+     *  unless one of the versions changed while they were produced.
+     */
+    void insert(const c_str &key, const data_version_list_t &versions,
+                result_capture_t &capture);
+
+    void print_stats();
+};
+
+
+
+/**
+ *  @brief Copies the pages a stage outputs, to be inserted in the
+ *  result cache if the stage completes. It gives up (and frees the
+ *  copies) once the pages exceed the limit.
+ */
+class result_capture_t {
+
+    friend class result_cache_t;
+
+    std::vector<page*> _pages;
+    size_t _bytes;
+    size_t _limit;
+    bool   _active;
+
+public:
+
+    result_capture_t()
+        : _bytes(0), _limit(0), _active(false)
+    {
+    }
+
+    ~result_capture_t() {
+        abandon();
+    }
+
+    void start(size_t limit) {
+        abandon();
+        _limit = limit;
+        _active = true;
+    }
+
+    bool active() const { return (_active); }
+
+    void append(page* p);
+    void abandon();
+};
+
+
+
+EXIT_NAMESPACE(qpipe);
+
+
+#endif
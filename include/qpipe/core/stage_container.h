@@ -26,6 +26,7 @@
 
 #include "util.h"
 #include "qpipe/core/packet.h"
+#include "qpipe/core/result_cache.h"
 #include "qpipe/core/stage.h"
 
 using std::list;
@@ -72,6 +73,8 @@ protected:
     void container_queue_enqueue_no_merge(packet_t* packet);
     packet_list_t* container_queue_dequeue();
     void create_worker();
+    void _run_packets(packet_list_t* packets, critical_section_t &cs);
+    static void _run_coro(void* container);
    
     
 public:
@@ -81,7 +84,7 @@ public:
                                           stage_adaptor_t* adaptor);
 
     stage_container_t(const c_str &container_name, stage_factory_t* stage_maker,
-		      int active_count, int max_count=-1);
+		      int active_count, int max_count=-1, bool coro=false);
 
     ~stage_container_t();
   
@@ -93,6 +96,7 @@ public:
     void unreserve(int n);
     
     void run();
+    void run_one();
 
 private:
 
@@ -114,6 +118,12 @@ private:
        more threads. */
     int _next_thread;
 
+    /* If set, the workers are coroutines of the coro_pool_t instead
+       of threads. There is one per packet list in the container
+       queue, spawned when the list is enqueued, and a "worker" is
+       only a unit of _rp capacity. */
+    bool _coro;
+
     /* Used to track the reservation of worker threads by clients who
        want to submit queries. A client is responsible for reserving
        all required workers before submitting the query.
@@ -149,6 +159,13 @@ protected:
     // Group many output() tuples into a page before "sending"
     // entire page to packet list
     guard<page> out_page;
+
+    // Reused by output_page() for the filters that select a page at
+    // a time
+    selection_t _selection;
+
+    // Copies of the output pages, for the result cache
+    result_capture_t _capture;
 	
     // Checked independently of other variables. Don't need to
     // protect this with _stage_adaptor_mutex.
@@ -192,6 +192,8 @@ class tuple_fifo;
  */
 class page 
 {
+    friend class page_file_t;
+
     page_pool* _pool;
     size_t _tuple_size;
     size_t _padded_size;
@@ -288,6 +290,16 @@ private:
     }
 
 
+    /**
+     *  @brief Address of the first tuple on this page. Tuple (i)
+     *  starts at base()+i*tuple_size(). Used by the page-at-a-time
+     *  filters to walk a column without building tuple_t's.
+     */
+    const char* base() {
+        return _data();
+    }
+
+
     /**
      *  @brief Fill this page with tuples read from the specified
      *  file. If this page already contains tuples, we will overwrite
@@ -492,6 +504,67 @@ private:
 
 
 
+/**
+ *  @brief Selection vector: the indexes of the tuples of a page that
+ *  passed a filter, in page order. Filled by
+ *  tuple_filter_t::select_page() and refined in place by
+ *  predicate_t::select_batch(). The storage is grown on demand and
+ *  kept across pages, so a long-lived owner (eg the stage adaptor)
+ *  does not allocate in the steady state.
+ */
+class selection_t
+{
+    unsigned int* _idx;
+    size_t _count;
+    size_t _capacity;
+
+public:
+
+    selection_t()
+        : _idx(NULL), _count(0), _capacity(0)
+    {
+    }
+
+    ~selection_t() {
+        delete [] _idx;
+    }
+
+    /**
+     *  @brief Select every tuple [0, n)
+     */
+    void fill(size_t n) {
+        reserve(n);
+        for (size_t i=0; i<n; i++)
+            _idx[i] = i;
+        _count = n;
+    }
+
+    /**
+     *  @brief Make room for (n) indexes and empty the vector
+     */
+    void reserve(size_t n) {
+        if (n > _capacity) {
+            delete [] _idx;
+            _idx = new unsigned int[n];
+            _capacity = n;
+        }
+        _count = 0;
+    }
+
+    unsigned int* data() { return _idx; }
+    size_t size() const { return _count; }
+    void set_size(size_t n) { assert(n <= _capacity); _count = n; }
+    unsigned int operator[](size_t i) const { return _idx[i]; }
+
+private:
+
+    // not copyable
+    selection_t(const selection_t &);
+    selection_t &operator =(const selection_t &);
+};
+
+
+
 EXIT_NAMESPACE(qpipe);
 
 
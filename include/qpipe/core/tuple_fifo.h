@@ -25,6 +25,7 @@
 #define __QPIPE_TUPLE_FIFO_H
 
 #include "qpipe/core/tuple.h"
+#include "qpipe/core/coro_sched.h"
 #include <cstdio>
 #include <vector>
 #include <list>
@@ -40,6 +41,8 @@ int tuple_fifo_generate_id();
 
 typedef std::list<page*> page_list;
 
+class page_file_t;
+
 /**
  *  @brief Thread-safe tuple buffer. This class allows one thread to
  *  safely pass tuples to another. The producer will fill a page of
@@ -121,7 +124,7 @@ private:
     size_t _threshold;
 
     /* page file management */
-    FILE*  _page_file;
+    page_file_t* _page_file;
     size_t _next_page;
     size_t _file_head_page;
     
@@ -146,6 +149,10 @@ private:
     pthread_cond_t _reader_notify;
     pthread_cond_t _writer_notify;
 
+    /* the reader or writer parked on us, if they are coroutines */
+    coro_t* _reader_coro;
+    coro_t* _writer_coro;
+
     /* debug vars */
     pthread_t _reader_tid;
     pthread_t _writer_tid;
@@ -180,6 +187,7 @@ public:
           _pages_in_memory(0),
           _memory_capacity(capacity),
           _threshold(threshold),
+          _page_file(NULL),
           _next_page(0),
           _file_head_page(0),
           _tuple_size(tuple_size),
@@ -191,6 +199,8 @@ public:
           _lock(thread_mutex_create()),
           _reader_notify(thread_cond_create()),
           _writer_notify(thread_cond_create()),
+          _reader_coro(NULL),
+          _writer_coro(NULL),
 	  _reader_tid(0),
           _writer_tid(0)
     {
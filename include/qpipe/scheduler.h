@@ -35,6 +35,7 @@
 #include "qpipe/scheduler/cpu_set.h"
 #include "qpipe/scheduler/policy.h"
 #include "qpipe/scheduler/policy_os.h"
+#include "qpipe/scheduler/policy_pipeline.h"
 #include "qpipe/scheduler/policy_query_cpu.h"
 #include "qpipe/scheduler/policy_rr_cpu.h"
 #include "qpipe/scheduler/policy_rr_module.h"
@@ -46,6 +46,7 @@ typedef struct cpu_set_s* cpu_set_p;
 void cpu_set_init(cpu_set_p cpu_set);
 int cpu_set_get_num_cpus(cpu_set_p cpu_set);
 cpu_t cpu_set_get_cpu(cpu_set_p cpu_set, int index);
+int cpu_set_sort_by_topology(cpu_set_p cpu_set);
 void cpu_set_finish(cpu_set_p cpu_set);
 
 EXIT_NAMESPACE(qpipe);
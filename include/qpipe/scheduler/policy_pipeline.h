@@ -0,0 +1,198 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+   
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+   
+                         All Rights Reserved.
+   
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+   
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+#ifndef __QPIPE_POLICY_PIPELINE_H
+#define __QPIPE_POLICY_PIPELINE_H
+
+#include "util.h"
+#include "qpipe/core/coro_sched.h"
+#include "qpipe/scheduler/policy.h"
+#include "qpipe/scheduler/cpu_set_struct.h"
+#include "qpipe/scheduler/cpu_set.h"
+
+#include <map>
+#include <vector>
+
+
+
+ENTER_NAMESPACE(qpipe);
+
+
+
+/* exported datatypes */
+
+/**
+ *  @brief Places the stages of a query next to the stages they
+ *  exchange tuple pages with. The CPUs are ordered by topology (SMT
+ *  siblings, then the cores of a last-level cache, then the NUMA
+ *  nodes) and each query gets consecutive CPUs, starting at the next
+ *  last-level cache group in round-robin order. The packet tree is
+ *  laid out in pre-order, so every packet runs next to its first
+ *  producer and close to the others. A query with more stages than
+ *  CPUs in its group spills into the following groups, and wraps
+ *  around when the whole machine is used.
+ */
+class policy_pipeline_t : public policy_t {
+
+protected:
+
+    pthread_mutex_t _next_group_mutex;
+    struct cpu_set_s _cpu_set;
+    int _cpu_num;
+    int _group_size;
+    int _group_num;
+    int _next_group;
+
+
+    class pipeline_query_state_t : public qpipe::query_state_t {
+
+    private:
+
+        policy_pipeline_t* _policy;
+
+    public:
+
+        typedef std::map<packet_t*, int> slot_map_t;
+
+        pthread_mutex_t _mutex;
+        int _first_cpu;
+        int _next_slot;
+        slot_map_t _slots;
+
+        pipeline_query_state_t(policy_pipeline_t* policy, int first_cpu)
+            : _policy(policy),
+              _mutex(thread_mutex_create()),
+              _first_cpu(first_cpu),
+              _next_slot(0)
+        {
+        }
+
+        virtual ~pipeline_query_state_t() {
+            thread_mutex_destroy(_mutex);
+        }
+
+        virtual void rebind_self(packet_t* packet) {
+            /* A coroutine shares its scheduler thread with the other
+               stages, binding it would move all of them. */
+            if (coro_t::self() != NULL)
+                return;
+            cpu_bind_self( _policy->assign(packet, this) );
+        }
+    };
+
+
+    /* Gives consecutive slots to the tree rooted at 'packet', in
+       pre-order. The producers are still held by their consumers,
+       they are released as they get dispatched. */
+    void place(packet_t* packet, pipeline_query_state_t* qstate) {
+        if (packet == NULL || qstate->_slots.count(packet))
+            return;
+        qstate->_slots[packet] = qstate->_next_slot++;
+
+        std::vector<packet_t*> producers;
+        packet->get_producers(producers);
+        for (size_t i = 0; i < producers.size(); i++)
+            place(producers[i], qstate);
+    }
+
+
+    virtual cpu_t assign(packet_t* packet, query_state_t* qs) {
+
+        // Dynamic cast acts like an assert(), verifying the type.
+        pipeline_query_state_t* qstate = dynamic_cast<pipeline_query_state_t*>(qs);
+
+        critical_section_t cs(qstate->_mutex);
+
+        // The root is the first packet to start, it places the whole
+        // tree. Packets we did not see (e.g. the merges of a sort)
+        // go after the tree.
+        pipeline_query_state_t::slot_map_t::iterator it =
+            qstate->_slots.find(packet);
+        if (it == qstate->_slots.end()) {
+            place(packet, qstate);
+            it = qstate->_slots.find(packet);
+        }
+        int slot = it->second;
+
+        cs.exit();
+
+        return
+            cpu_set_get_cpu( &_cpu_set, (qstate->_first_cpu + slot) % _cpu_num );
+    }
+
+
+public:
+
+    policy_pipeline_t()
+        : _next_group_mutex(thread_mutex_create())
+    {
+        cpu_set_init(&_cpu_set);
+        _cpu_num    = cpu_set_get_num_cpus(&_cpu_set);
+        _group_size = cpu_set_sort_by_topology(&_cpu_set);
+        _group_num  = _cpu_num / _group_size;
+        _next_group = 0;
+
+        TRACE( TRACE_ALWAYS, "(%d) CPUs in (%d) last-level cache groups\n",
+               _cpu_num, _group_num );
+    }
+
+
+    virtual ~policy_pipeline_t() {
+        cpu_set_finish(&_cpu_set);
+        thread_mutex_destroy(_next_group_mutex);
+    }
+
+
+    virtual query_state_t* query_state_create() {
+
+        int next_group;
+
+        critical_section_t cs(_next_group_mutex);
+
+        // Every new query starts at the next group, so concurrent
+        // queries spread over the caches.
+        next_group = _next_group;
+        _next_group = (_next_group + 1) % _group_num;
+
+        cs.exit();
+
+        return new pipeline_query_state_t( this, next_group * _group_size );
+    }
+
+
+    virtual void query_state_destroy(query_state_t* qs) {
+        // Dynamic cast acts like an assert(), verifying the type.
+        pipeline_query_state_t* qstate = dynamic_cast<pipeline_query_state_t*>(qs);
+        delete qstate;
+    }
+
+
+};
+
+
+
+EXIT_NAMESPACE(qpipe);
+
+
+
+#endif
@@ -108,6 +108,10 @@ struct aggregate_packet_t : public packet_t
         declare->declare(_packet_type, 1);
         _input->declare_worker_needs(declare);
     }
+
+    virtual void get_producers(std::vector<packet_t*> &producers) {
+        producers.push_back(_input);
+    }
 };
 
 
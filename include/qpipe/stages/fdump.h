@@ -156,6 +156,16 @@ public:
         }
     }
 
+    virtual void get_producers(std::vector<packet_t*> &producers) {
+        if (_child)
+            producers.push_back(_child);
+    }
+
+    /* our output is a file, which must be written again */
+    virtual bool get_versions(data_version_list_t &) {
+        return false;
+    }
+
 };
 
 /**
@@ -71,6 +71,10 @@ struct hash_aggregate_packet_t : public packet_t {
         declare->declare(_packet_type, 1);
         _input->declare_worker_needs(declare);
     }
+
+    virtual void get_producers(std::vector<packet_t*> &producers) {
+        producers.push_back(_input);
+    }
 };
 
 
@@ -79,6 +83,7 @@ class hash_aggregate_stage_t : public stage_t {
 
     page_trash_stack _page_list;
     size_t _page_count;
+    mem_grant_t* _grant;    /* of the packet being processed */
     tuple_aggregate_t* _aggregate;
     qpipe::page* _agg_page;
     size_t _tuple_align;
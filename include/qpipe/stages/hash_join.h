@@ -50,6 +50,11 @@ ENTER_NAMESPACE(qpipe);
 #define HASH_JOIN_STAGE_NAME  "HASH_JOIN"
 #define HASH_JOIN_PACKET_TYPE "HASH_JOIN"
 
+/* pages of the in-memory partitions, and how many more we ask the
+   memory broker for before spilling one to disk */
+static const int HASH_JOIN_PAGE_QUOTA = 10000;
+static const int HASH_JOIN_GROW_PAGES = 256;
+
 
 
 /********************
@@ -145,6 +150,11 @@ public:
         _left->declare_worker_needs(declare);
         _right->declare_worker_needs(declare);
     }
+
+    virtual void get_producers(std::vector<packet_t*> &producers) {
+        producers.push_back(_left);
+        producers.push_back(_right);
+    }
 };
 
 
@@ -225,7 +235,7 @@ private:
 
         page* _page;
         int size;
-        FILE *file;
+        page_file_t *file;
         c_str file_name1;
         c_str file_name2;
 
@@ -254,9 +264,10 @@ private:
         }
         void operator()(partition_list_t::iterator it) {
             // open a new file for the left side partition
-            it->file = create_tmp_file(it->file_name2, "hash-join-left");
+            it->file = page_file_t::create_tmp(it->file_name2, "hash-join-left");
             
             // resize the page to match left-side tuples
+            it->_page->free();
             it->_page = page::alloc(_left_tuple_size);
         }
     };
@@ -267,6 +278,7 @@ private:
     
     int page_quota;
     int page_count;
+    mem_grant_t* _grant;    /* of the packet being processed */
     tuple_join_t *_join;
     partition_list_t partitions;
 
@@ -274,6 +286,8 @@ private:
 
     /* methods */
     void test_overflow(int partition);
+    void join_disk_partition(partition_t &p, bool outer_join, bool distinct);
+    void clear_partitions();
 
     template<class Action>
     void close_file(partition_list_t::iterator it, Action a);
@@ -292,13 +306,15 @@ public:
     
     // Allocate in-memory partitions...
     hash_join_stage_t()
-        : page_quota(10000)
+        : page_quota(HASH_JOIN_PAGE_QUOTA)
         , page_count(0)
+        , _grant(NULL)
         , partitions(512)
     {
     }
 
     ~hash_join_stage_t() {
+        clear_partitions();
     }
 
 };
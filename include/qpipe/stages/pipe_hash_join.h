@@ -133,6 +133,11 @@ public:
         _left->declare_worker_needs(declare);
         _right->declare_worker_needs(declare);
     }
+
+    virtual void get_producers(std::vector<packet_t*> &producers) {
+        producers.push_back(_left);
+        producers.push_back(_right);
+    }
 };
 
 
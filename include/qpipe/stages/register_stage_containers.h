@@ -34,12 +34,17 @@
 
 ENTER_NAMESPACE(qpipe);
 
+// The stages that call the storage manager keep per-thread state (the
+// attached xct, pinned pages) while they wait on their output, so they
+// never run as coroutines (see coro_sched.h).
 template <class Stage>
-void register_stage(int worker_threads=10, bool osp=true) 
+void register_stage(int worker_threads=10, bool osp=true, bool uses_sm=false) 
 {
     stage_container_t* sc;
     c_str name("%s_CONTAINER", Stage::DEFAULT_STAGE_NAME.data());
-    sc = new stage_container_t(name, new stage_factory<Stage>, worker_threads);
+    bool coro = !uses_sm && coro_pool_t::enabled();
+    sc = new stage_container_t(name, new stage_factory<Stage>, worker_threads,
+                               -1, coro);
     dispatcher_t::register_stage_container(Stage::stage_packet_t::PACKET_TYPE.data(), sc, osp);
 }
 
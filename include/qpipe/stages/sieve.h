@@ -71,6 +71,10 @@ struct sieve_packet_t : public packet_t {
         declare->declare(_packet_type, 1);
         _input->declare_worker_needs(declare);
     }
+
+    virtual void get_producers(std::vector<packet_t*> &producers) {
+        producers.push_back(_input);
+    }
 };
 
 
@@ -64,6 +64,11 @@ struct sorted_in_packet_t : public packet_t {
         _left->declare_worker_needs(declare);
         _right->declare_worker_needs(declare);
     }
+
+    virtual void get_producers(std::vector<packet_t*> &producers) {
+        producers.push_back(_left);
+        producers.push_back(_right);
+    }
 };
 
 struct sorted_in_stage_t : public stage_t {
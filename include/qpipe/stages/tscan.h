@@ -55,6 +55,13 @@ struct tscan_packet_t : public packet_t
     xct_t*        _xct;
     lock_mode_t   _lm;
 
+    // predicates pushed down to the scan, and the columnar replica read
+    // instead of the heap file while it is valid, or the zone maps used
+    // to skip the pages of the heap file
+    vector<column_pred_t> _col_preds;
+    column_replica_t*     _pcolumns;
+    zone_map_t*           _pzones;
+
     static const c_str PACKET_TYPE;
    
     /**
@@ -94,6 +101,31 @@ struct tscan_packet_t : public packet_t
     static query_plan* create_plan(tuple_filter_t* filter, table_desc_t* file);
     void declare_worker_needs(resource_declare_t* declare);
 
+    /* the version of the table, bumped by every write to it */
+    bool get_versions(data_version_list_t &versions);
+
+    /**
+     *  @brief Push predicates down to the scan, which may then skip
+     *  (some of) the rows that do not satisfy all of them. The output
+     *  filter still sees every produced tuple, so the predicates only
+     *  need to be a (conservative) part of its selection. Should be
+     *  called before the packet is dispatched or used in the plan of
+     *  another one.
+     */
+    void where(const vector<column_pred_t>& preds);
+
+    /**
+     *  @brief Scan the columnar replica, if valid, producing only the
+     *  rows that satisfy the predicates. NULL for none.
+     */
+    void use_columns(column_replica_t* pcolumns);
+
+    /**
+     *  @brief Otherwise, read only the pages of the heap file that may
+     *  hold rows that satisfy the predicates. NULL for none.
+     */
+    void use_zones(zone_map_t* pzones);
+
 }; // EOF: tscan_packet_t
 
 
@@ -120,6 +152,8 @@ protected:
     
     virtual void process_packet();
 
+    void process_columns(column_scan_t& cscan, tscan_packet_t* packet);
+
 }; // EOF: tscan_stage_t
 
 
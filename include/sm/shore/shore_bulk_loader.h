@@ -0,0 +1,266 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   shore_bulk_loader.h
+ *
+ *  @brief:  Bulk index construction used while populating the database
+ *
+ *  @note:   index_bulk_buf_t - (key,rid) pairs collected for one index
+ *                              (partition) during the load
+ *           bulk_loader_t    - the buffers of all the indexes of a table
+ *
+ *  While a table is in bulk-load mode add_tuple() only appends the record
+ *  to the heap file and remembers the formatted key of each index. Once
+ *  all the loaders have finished, the keys of each index are sorted (one
+ *  index per builder thread) and the B+tree is built bottom-up by the
+ *  storage manager (ss_m::bulkld_index), instead of doing one top-down
+ *  insertion per record. The buffers take up to db-bulkload-mem MB, the
+ *  entries that do not fit are inserted one by one.
+ *
+ */
+
+#ifndef __SHORE_BULK_LOADER_H
+#define __SHORE_BULK_LOADER_H
+
+#include "sm_vas.h"
+#include "util.h"
+
+#include "shore_index.h"
+
+#include <vector>
+
+using std::vector;
+
+
+ENTER_NAMESPACE(shore);
+
+
+class table_desc_t;
+
+
+// Number of entries allocated at once by an index buffer
+const unsigned int BULK_ENTRIES_PER_CHUNK = 8192;
+
+
+
+/* ---------------------------------------------------------------
+ *
+ * @class: bulk_key_cmp_t
+ *
+ * @brief: Compares two keys formatted by table_man_t::format_key(),
+ *         in the order the B+tree keeps them.
+ *
+ * @note:  The keys have fixed size, each field occupies its maxsize.
+ *         Integers are compared as signed numbers, floats as doubles,
+ *         and everything else (strings, timestamps) byte-by-byte,
+ *         which is what the key description of the index asks for.
+ *
+ * --------------------------------------------------------------- */
+
+class bulk_key_cmp_t
+{
+public:
+
+    enum ekind_t { KC_INT, KC_FLOAT, KC_BYTES };
+
+private:
+
+    struct part_t {
+        ekind_t _kind;
+        uint_t  _offset;
+        uint_t  _size;
+    };
+
+    vector<part_t> _parts;
+
+public:
+
+    bulk_key_cmp_t() { }
+
+    void setup(table_desc_t* ptable, index_desc_t* pindex);
+
+    int compare(const char* a, const char* b) const;
+
+    // used by std::sort
+    inline bool operator()(const char* a, const char* b) const {
+        return (compare(a,b) < 0);
+    }
+
+}; // EOF: bulk_key_cmp_t
+
+
+
+/* ---------------------------------------------------------------
+ *
+ * @class: index_bulk_buf_t
+ *
+ * @brief: The (key,rid) entries collected for one index partition
+ *         while the table is being loaded
+ *
+ * @note:  Many loader threads append concurrently. Entries are kept in
+ *         fixed-size chunks so that their address does not change, and
+ *         sorting moves only the pointers.
+ *
+ * @note:  The chunks of all the buffers share a memory cap. A buffer
+ *         that needs a chunk over the cap stops collecting, and the
+ *         loaders insert its further entries to the index themselves.
+ *
+ * --------------------------------------------------------------- */
+
+class index_bulk_buf_t
+{
+private:
+
+    table_desc_t*     _ptable;
+    index_desc_t*     _pindex;
+    int               _pnum;
+
+    uint_t            _ksz;      // size of the formatted key
+    uint_t            _esz;      // size of an entry (key + rid)
+
+    vector<char*>     _chunks;
+    uint_t            _used;     // entries used in the last chunk
+    vector<char*>     _entries;  // pointers to the entries (sorted by build)
+    bool              _full;     // over the memory cap, see add()
+
+    bulk_key_cmp_t    _cmp;
+    mcs_lock          _lock;
+
+    // the memory of the chunks of all the buffers, and its cap
+    static volatile uint64_t _mem_used;
+    static uint64_t          _mem_cap;
+
+    w_rc_t _bulkld(ss_m* db);
+    w_rc_t _insert_sorted(ss_m* db);
+    w_rc_t _is_empty(ss_m* db, bool& empty);
+
+public:
+
+    index_bulk_buf_t(table_desc_t* ptable, index_desc_t* pindex,
+                     const int pnum, const uint_t ksz);
+    ~index_bulk_buf_t();
+
+    // the memory (in MB) the chunks of all the buffers may take, 0 is
+    // no limit
+    static void set_mem_cap(const uint_t mb);
+
+    // Appends a formatted key and the rid of its record. Returns false
+    // if the buffers are over the memory cap, and then the caller
+    // inserts the entry to the index.
+    bool add(const char* key, const uint_t ksz, const rid_t& rid);
+
+    // sorts the entries and builds the index
+    w_rc_t build(ss_m* db);
+
+    index_desc_t* index() { return (_pindex); }
+    int           pnum() const { return (_pnum); }
+    uint_t        count() const { return (_entries.size()); }
+
+}; // EOF: index_bulk_buf_t
+
+
+// orders the buffers by increasing number of entries
+inline bool bulk_buf_smaller(index_bulk_buf_t* a, index_bulk_buf_t* b) {
+    return (a->count() < b->count());
+}
+
+
+
+/* ---------------------------------------------------------------
+ *
+ * @class: bulk_loader_t
+ *
+ * @brief: The index buffers of a table. Owned by the table manager
+ *         while the table is in bulk-load mode.
+ *
+ * --------------------------------------------------------------- */
+
+class bulk_loader_t
+{
+private:
+
+    table_desc_t*             _ptable;
+    vector<index_bulk_buf_t*> _bufs;     // per index, per partition
+
+public:
+
+    bulk_loader_t(table_desc_t* ptable);
+    ~bulk_loader_t();
+
+    // the buffer for partition pnum of the index
+    index_bulk_buf_t* buf(index_desc_t* pindex, const int pnum);
+
+    vector<index_bulk_buf_t*>& bufs() { return (_bufs); }
+
+    // Whether all the indexes of the table can be built by the bulk
+    // loader. MRBT indexes keep their partitioning (and the PLP heap
+    // placement) during insertion, so they are loaded normally.
+    static bool supports(table_desc_t* ptable);
+
+}; // EOF: bulk_loader_t
+
+
+
+/* ---------------------------------------------------------------
+ *
+ * @class: index_builder_smt_t
+ *
+ * @brief: Thread that builds index buffers taken from a shared list,
+ *         until the list is empty
+ *
+ * --------------------------------------------------------------- */
+
+class index_builder_smt_t : public thread_t
+{
+private:
+
+    ss_m*                       _pssm;
+    vector<index_bulk_buf_t*>*  _pwork;
+    mcs_lock*                   _pwork_lock;
+    int                         _rv;
+
+public:
+
+    index_builder_smt_t(c_str tname, ss_m* assm,
+                        vector<index_bulk_buf_t*>* awork,
+                        mcs_lock* awork_lock)
+        : thread_t(tname), _pssm(assm),
+          _pwork(awork), _pwork_lock(awork_lock), _rv(0)
+    {
+        assert (_pssm);
+        assert (_pwork);
+        assert (_pwork_lock);
+    }
+
+    ~index_builder_smt_t() { }
+
+    // thread entrance
+    void work();
+    inline int rv() { return (_rv); }
+
+}; // EOF: index_builder_smt_t
+
+
+EXIT_NAMESPACE(shore);
+
+#endif /* __SHORE_BULK_LOADER_H */
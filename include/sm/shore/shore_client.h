@@ -42,7 +42,8 @@ ENTER_NAMESPACE(shore);
 
 
 // enumuration of different binding types
-enum eBindingType { BT_NONE=0, BT_NEXT=1, BT_SPREAD=2 };
+// BT_TOPOLOGY - places each client on the NUMA node that owns its key range
+enum eBindingType { BT_NONE=0, BT_NEXT=1, BT_SPREAD=2, BT_TOPOLOGY=3 };
 
 
 //// Default values for the environment ////
@@ -92,6 +93,9 @@ const int BATCH_SIZE = 10;
 // default think time
 const int THINK_TIME = 0;
 
+// default number of batches a client keeps in flight
+const int IN_FLIGHT_BATCHES = 2;
+
 
 // Instanciate and close the Shore environment
 int inst_test_env(int argc, char* argv[]);
@@ -140,8 +144,15 @@ protected:
 
     int _think_time; // in microseconds
 
-    // used for submitting batches
-    guard<condex_pair> _cp;
+    // used for submitting batches, the workers push the completions here
+    guard<completion_queue_t> _cq;
+
+    // submission time of the batches in flight, by notifying trx id
+    std::vector< std::pair<int,long long> > _sent;
+    stopwatch_t _timer;
+
+    w_rc_t _submit_timed_batch(int xct_type, int& trx_cnt, const int batch_sz);
+    void _batch_done(const completion_t& rec);
 
     // for processor binding
     bool          _is_bound;
@@ -170,7 +181,8 @@ public:
         assert (_env);
         assert (_measure_type != MT_UNDEF);
         assert (_notrxs || (_measure_type == MT_TIME_DUR));
-        _cp = new condex_pair();
+        int inflight = envVar::instance()->getVarInt("db-cl-inflight",IN_FLIGHT_BATCHES);
+        _cq = new completion_queue_t(inflight > IN_FLIGHT_BATCHES ? inflight : IN_FLIGHT_BATCHES);
     }
 
     virtual ~base_client_t() { }
@@ -225,6 +237,21 @@ public:
     virtual w_rc_t submit_one(int xct_type, int num_xct)=0;
 
 
+    // --- driven by the trx server, without forking the client --- //
+
+    // the ring may hold up to cnt completions
+    void set_max_inflight(const uint cnt) { 
+        _cq = new completion_queue_t(cnt); 
+    }
+    completion_queue_t* completions() { return (_cq.get()); }
+
+    // submits one xct whose completion is pushed to the ring
+    w_rc_t submit_notified(int xct_type, int xctid) {
+        _cq->please_take_one();
+        return (submit_one(xct_type, xctid));
+    }
+
+
     // debugging 
 
     void print_tables() { assert (_env); _env->dump(); }
@@ -0,0 +1,498 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   shore_column_store.h
+ *
+ *  @brief:  Read-optimized, compressed, in-memory columnar copy of
+ *           large read-mostly (DSS fact) tables
+ *
+ *  @note:   column_replica_t - the columns of a table, in blocks of
+ *                              COLUMN_BLOCK_ROWS rows
+ *           column_pred_t    - a range predicate on one column
+ *           column_scan_t    - scans the blocks of a replica, skipping
+ *                              blocks by their zone maps and evaluating
+ *                              the predicates on the encoded values
+ *
+ *  Each block of a column is encoded on its own:
+ *  - integers (and floats whose values in the block are all integral)
+ *    with frame-of-reference: the block minimum plus bit-packed offsets
+ *  - strings with an order-preserving dictionary per column (codes are
+ *    bit-packed), unless the column has too many distinct values, in
+ *    which case they are stored as they are
+ *  - other floats as they are
+ *  Every block keeps the min and max of each column (zone map), in the
+ *  encoded domain, so that range predicates skip whole blocks and are
+ *  evaluated on the packed offsets/codes without decoding them.
+ *
+ *  Like the table cache, the replica is an immutable snapshot: a write
+ *  to the table invalidates it and scans fall back to the heap file
+ *  until it is refreshed. Each scan pins the snapshot it reads, and a
+ *  replaced snapshot is freed when its last scan finishes.
+ *
+ *  @note:   The replica is read without locks. NULL values and the
+ *           NUMERIC and TIME types are not supported.
+ *
+ */
+
+#ifndef __SHORE_COLUMN_STORE_H
+#define __SHORE_COLUMN_STORE_H
+
+#include "sm_vas.h"
+#include "util.h"
+
+#include "shore_field.h"
+#include "shore_row.h"
+#include "shore_snapshot.h"
+
+#include <vector>
+#include <string>
+
+using std::vector;
+using std::string;
+
+
+ENTER_NAMESPACE(shore);
+
+
+class table_man_t;
+
+// rows per block of a column
+const uint_t COLUMN_BLOCK_ROWS = 8192;
+
+// distinct values of a string column that is dictionary-encoded
+const uint_t COLUMN_MAX_DICT_SIZE = 65536;
+
+
+
+/* ---------------------------------------------------------------
+ *
+ * @class: bitpack_t
+ *
+ * @brief: A vector of unsigned values, each stored in _bits bits.
+ *         With zero bits all the values are zero.
+ *
+ * --------------------------------------------------------------- */
+
+class bitpack_t
+{
+private:
+    uint_t           _bits;
+    uint64_t         _mask;
+    vector<uint64_t> _words;
+
+public:
+
+    bitpack_t() : _bits(0), _mask(0) { }
+
+    void init(const uint_t bits, const uint_t count);
+
+    inline uint_t bits() const { return (_bits); }
+    inline size_t bytes() const { return (_words.size()*sizeof(uint64_t)); }
+
+    inline void set(const uint_t i, const uint64_t v) {
+        if (!_bits) return;
+        uint64_t pos = (uint64_t)i*_bits;
+        uint_t w = (uint_t)(pos >> 6);
+        uint_t off = (uint_t)(pos & 63);
+        _words[w] |= (v & _mask) << off;
+        if (off + _bits > 64) _words[w+1] |= (v & _mask) >> (64 - off);
+    }
+
+    inline uint64_t get(const uint_t i) const {
+        if (!_bits) return (0);
+        uint64_t pos = (uint64_t)i*_bits;
+        uint_t w = (uint_t)(pos >> 6);
+        uint_t off = (uint_t)(pos & 63);
+        uint64_t v = _words[w] >> off;
+        if (off + _bits > 64) v |= _words[w+1] << (64 - off);
+        return (v & _mask);
+    }
+
+    // bits needed for values up to maxv
+    static uint_t width(uint64_t maxv);
+
+}; // EOF: bitpack_t
+
+
+
+/* ---------------------------------------------------------------
+ *
+ * @enum:  column_enc_t
+ *
+ * @brief: The encoding of a column block
+ *
+ * --------------------------------------------------------------- */
+
+enum column_enc_t {
+    CE_FOR      = 0,   // frame-of-reference, bit-packed offsets from _min
+    CE_DOUBLE   = 1,   // raw doubles
+    CE_DICT     = 2,   // codes of the column dictionary, as CE_FOR
+    CE_STRING   = 3    // raw strings
+};
+
+
+
+/* ---------------------------------------------------------------
+ *
+ * @struct: column_block_t
+ *
+ * @brief:  COLUMN_BLOCK_ROWS (or less, for the last block) values of
+ *          a column, and their zone map
+ *
+ * --------------------------------------------------------------- */
+
+struct column_block_t
+{
+    column_enc_t     _enc;
+
+    // zone map, in the integer domain (values for CE_FOR, codes for
+    // CE_DICT) and as doubles (for CE_FOR and CE_DOUBLE)
+    long long        _min;
+    long long        _max;
+    double           _dmin;
+    double           _dmax;
+
+    bitpack_t        _packed;     // CE_FOR offsets or CE_DICT codes
+    vector<double>   _doubles;    // CE_DOUBLE
+    vector<char>     _chars;      // CE_STRING, NUL-terminated
+    vector<uint_t>   _offsets;    // CE_STRING, start of each string
+
+    column_block_t()
+        : _enc(CE_FOR), _min(0), _max(0), _dmin(0), _dmax(0) { }
+
+    size_t bytes() const;
+
+}; // EOF: column_block_t
+
+
+
+/* ---------------------------------------------------------------
+ *
+ * @struct: column_t
+ *
+ * @brief:  All the blocks of one column
+ *
+ * --------------------------------------------------------------- */
+
+struct column_t
+{
+    sqltype_t               _type;
+    vector<string>          _dict;     // sorted, if dictionary-encoded
+    vector<column_block_t*> _blocks;
+
+    column_t(const sqltype_t type) : _type(type) { }
+    ~column_t();
+
+    inline bool is_string() const {
+        return ((_type == SQL_FIXCHAR) || (_type == SQL_VARCHAR));
+    }
+
+    inline long long get_int(const uint_t blk, const uint_t row) const {
+        const column_block_t* pb = _blocks[blk];
+        assert (pb->_enc == CE_FOR);
+        return (pb->_min + (long long)pb->_packed.get(row));
+    }
+
+    inline double get_double(const uint_t blk, const uint_t row) const {
+        const column_block_t* pb = _blocks[blk];
+        if (pb->_enc == CE_DOUBLE) return (pb->_doubles[row]);
+        return ((double)get_int(blk, row));
+    }
+
+    inline const char* get_str(const uint_t blk, const uint_t row) const {
+        const column_block_t* pb = _blocks[blk];
+        if (pb->_enc == CE_DICT)
+            return (_dict[pb->_min + pb->_packed.get(row)].c_str());
+        assert (pb->_enc == CE_STRING);
+        return (&pb->_chars[pb->_offsets[row]]);
+    }
+
+    size_t bytes() const;
+
+}; // EOF: column_t
+
+
+
+/* ---------------------------------------------------------------
+ *
+ * @struct: column_pred_t
+ *
+ * @brief:  A (possibly open) range on the values of one column, e.g.
+ *
+ *          column_pred_t(10).ge("1994-01-01").lt("1995-01-01")
+ *
+ *          The bounds are either integers, doubles or strings. Integer
+ *          bounds can be used with float columns too.
+ *
+ * --------------------------------------------------------------- */
+
+struct column_pred_t
+{
+    enum bound_type_t { CPB_NONE, CPB_INT, CPB_DOUBLE, CPB_STR };
+
+    uint_t       _col;
+    bound_type_t _btype;
+
+    bool         _has_lo;
+    bool         _lo_incl;
+    bool         _has_hi;
+    bool         _hi_incl;
+
+    long long    _ilo;
+    long long    _ihi;
+    double       _dlo;
+    double       _dhi;
+    string       _slo;
+    string       _shi;
+
+    column_pred_t(const uint_t col)
+        : _col(col), _btype(CPB_NONE),
+          _has_lo(false), _lo_incl(false), _has_hi(false), _hi_incl(false),
+          _ilo(0), _ihi(0), _dlo(0), _dhi(0)
+    { }
+
+    column_pred_t& ge(const long long v) { return (_set_int(true, v, true)); }
+    column_pred_t& gt(const long long v) { return (_set_int(true, v, false)); }
+    column_pred_t& le(const long long v) { return (_set_int(false, v, true)); }
+    column_pred_t& lt(const long long v) { return (_set_int(false, v, false)); }
+
+    column_pred_t& ge(const int v) { return (ge((long long)v)); }
+    column_pred_t& gt(const int v) { return (gt((long long)v)); }
+    column_pred_t& le(const int v) { return (le((long long)v)); }
+    column_pred_t& lt(const int v) { return (lt((long long)v)); }
+
+    column_pred_t& ge(const double v) { return (_set_double(true, v, true)); }
+    column_pred_t& gt(const double v) { return (_set_double(true, v, false)); }
+    column_pred_t& le(const double v) { return (_set_double(false, v, true)); }
+    column_pred_t& lt(const double v) { return (_set_double(false, v, false)); }
+
+    column_pred_t& ge(const char* v) { return (_set_str(true, v, true)); }
+    column_pred_t& gt(const char* v) { return (_set_str(true, v, false)); }
+    column_pred_t& le(const char* v) { return (_set_str(false, v, true)); }
+    column_pred_t& lt(const char* v) { return (_set_str(false, v, false)); }
+
+    column_pred_t& eq(const long long v) { return (ge(v).le(v)); }
+    column_pred_t& eq(const int v) { return (ge(v).le(v)); }
+    column_pred_t& eq(const char* v) { return (ge(v).le(v)); }
+
+    // The inclusive integer range [lo,hi] of a numeric predicate.
+    // Returns false if it is empty.
+    bool int_bounds(long long& lo, long long& hi) const;
+
+    // Whether some value in [vmin,vmax] may satisfy the predicate.
+    // Bounds of another kind than the values never rule them out.
+    bool overlaps(const long long vmin, const long long vmax) const;
+    bool overlaps(const double vmin, const double vmax) const;
+    bool overlaps(const char* vmin, const char* vmax) const;
+
+    // used in the QPipe plans, so that only scans with the same
+    // predicates are merged
+    c_str to_string() const;
+
+private:
+
+    column_pred_t& _set_int(const bool bLo, const long long v, const bool bIncl);
+    column_pred_t& _set_double(const bool bLo, const double v, const bool bIncl);
+    column_pred_t& _set_str(const bool bLo, const char* v, const bool bIncl);
+
+}; // EOF: column_pred_t
+
+
+
+/* ---------------------------------------------------------------
+ *
+ * @class: column_replica_t
+ *
+ * @brief: The columnar copy of a table
+ *
+ * --------------------------------------------------------------- */
+
+class column_replica_t
+{
+public:
+
+    struct snapshot_t {
+        uint_t            _rows;
+        uint_t            _blocks;
+        vector<column_t*> _cols;
+
+        snapshot_t() : _rows(0), _blocks(0) { }
+        ~snapshot_t();
+
+        inline uint_t block_rows(const uint_t blk) const {
+            assert (blk < _blocks);
+            return ((blk+1 < _blocks) ? COLUMN_BLOCK_ROWS
+                    : (_rows - blk*COLUMN_BLOCK_ROWS));
+        }
+    };
+
+private:
+
+    table_man_t*            _pmanager;
+    table_desc_t*           _ptable;
+
+    mutable snapshot_set_t<snapshot_t> _snapshots;
+    volatile bool           _valid;
+    volatile uint_t         _version;    // bumped by each invalidation
+
+    mcs_lock                _refresh_lock;
+
+    uint_t                  _refreshes;
+
+    w_rc_t _build(ss_m* db, snapshot_t* psnap);
+
+public:
+
+    column_replica_t(table_man_t* pmanager);
+    ~column_replica_t();
+
+    // (Re)builds the snapshot, if the replica is not valid.
+    // It runs its own transaction, so the caller should not have one attached.
+    w_rc_t refresh(ss_m* db);
+
+    // Drops the current snapshot. Called on every write to the table.
+    void invalidate();
+
+    bool is_valid() const { return (_valid); }
+
+    // the current snapshot, pinned, or NULL if the replica is not valid.
+    // Each pinned snapshot has to be unpinned.
+    inline snapshot_t* pin() const {
+        if (!_valid) return (NULL);
+        return (_snapshots.pin());
+    }
+    inline void unpin(snapshot_t* psnap) const { _snapshots.unpin(psnap); }
+
+    table_man_t* manager() const { return (_pmanager); }
+    table_desc_t* table() const { return (_ptable); }
+
+    void print_stats() const;
+
+}; // EOF: column_replica_t
+
+
+
+/* ---------------------------------------------------------------
+ *
+ * @class: column_scan_t
+ *
+ * @brief: Block-at-a-time scan of a replica. After the predicates are
+ *         added, each call of next_block() moves to the next block
+ *         with qualifying rows. Only the values of those rows are
+ *         decoded, by get_XXX() or materialize().
+ *
+ *         column_scan_t cs(preplica);
+ *         if (cs.opened()) {
+ *             cs.where(column_pred_t(4).lt(24));
+ *             while (cs.next_block())
+ *                 for (uint_t i=0; i<cs.count(); i++)
+ *                     sum += cs.get_double(5,i);
+ *         }
+ *
+ * --------------------------------------------------------------- */
+
+class column_scan_t
+{
+private:
+
+    // a predicate, with its bounds in the domain of its column
+    struct bound_pred_t {
+        uint_t     _col;
+        bool       _empty;      // nothing qualifies
+        bool       _by_double;  // compare doubles (float columns)
+        bool       _by_string;  // compare strings (raw string columns)
+        long long  _lo;         // inclusive, in the integer domain
+        long long  _hi;
+        column_pred_t _pred;    // the original, for doubles and strings
+
+        bound_pred_t(const column_pred_t& pred)
+            : _col(pred._col), _empty(false),
+              _by_double(false), _by_string(false),
+              _lo(0), _hi(0), _pred(pred) { }
+    };
+
+    column_replica_t*             _prep;
+    column_replica_t::snapshot_t* _psnap;
+
+    vector<column_pred_t>  _preds;
+    vector<bound_pred_t>   _bound;
+    bool                   _is_bound;
+    bool                   _empty;
+
+    int                    _blk;        // current block
+    vector<uint_t>         _sel;        // qualifying rows of the block
+    vector<uint_t>         _tmp;
+
+    uint_t                 _blocks_read;
+    uint_t                 _blocks_skipped;
+
+    // not copyable, it holds a pin
+    column_scan_t(const column_scan_t&);
+    column_scan_t& operator=(const column_scan_t&);
+
+    void _bind();
+    bool _block_bounds(const bound_pred_t& bp, const column_block_t* pb,
+                       long long& lo, long long& hi, bool& bAll) const;
+    bool _qualifies(const bound_pred_t& bp, const column_t* pcol,
+                    const column_block_t* pb, const uint_t row,
+                    const long long lo, const long long hi) const;
+
+public:
+
+    column_scan_t(column_replica_t* prep);
+    ~column_scan_t() { if (_psnap) _prep->unpin(_psnap); }
+
+    // false if the replica is not valid, then the heap file should be used
+    bool opened() const { return (_psnap != NULL); }
+
+    // adds a conjunctive predicate, before the first next_block()
+    void where(const column_pred_t& pred);
+    void where(const vector<column_pred_t>& preds);
+
+    bool next_block();
+
+    // the qualifying rows of the current block
+    inline uint_t count() const { return (_sel.size()); }
+
+    inline long long get_int(const uint_t col, const uint_t i) const {
+        return (_psnap->_cols[col]->get_int(_blk, _sel[i]));
+    }
+    inline double get_double(const uint_t col, const uint_t i) const {
+        return (_psnap->_cols[col]->get_double(_blk, _sel[i]));
+    }
+    inline const char* get_str(const uint_t col, const uint_t i) const {
+        return (_psnap->_cols[col]->get_str(_blk, _sel[i]));
+    }
+
+    // sets all the values of the i-th qualifying row to prow
+    void materialize(const uint_t i, table_row_t* prow) const;
+
+    uint_t blocks_read() const { return (_blocks_read); }
+    uint_t blocks_skipped() const { return (_blocks_skipped); }
+
+}; // EOF: column_scan_t
+
+
+EXIT_NAMESPACE(shore);
+
+#endif /* __SHORE_COLUMN_STORE_H */
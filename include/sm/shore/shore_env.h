@@ -40,6 +40,7 @@
 
 #include "shore_reqs.h"
 #include "shore_file_desc.h"
+#include "shore_skew_plan.h"
 
 
 ENTER_NAMESPACE(shore);
@@ -160,6 +161,7 @@ const int    SHORE_NUM_DB_OPTIONS  = 5;
 
 #define DEFINE_RUN_WITH_INPUT_TRX_WRAPPER(cname,trxlid,trximpl)         \
     w_rc_t cname::run_##trximpl(Request* prequest, trxlid##_input_t& in) { \
+        PERFCTR_REGION(_pc_xct,#trximpl);                               \
         int xct_id = prequest->xct_id();                                \
         TRACE( TRACE_TRX_FLOW, "%d. %s ...\n", xct_id, #trximpl);       \
         _inc_##trxlid##_att();                                          \
@@ -175,6 +177,7 @@ const int    SHORE_NUM_DB_OPTIONS  = 5;
             TRACE( TRACE_TRX_FLOW, "Xct (%d) aborted [0x%x]\n", xct_id, e.err_num()); \
             w_rc_t e2 = _pssm->abort_xct();                             \
             if(e2.is_error()) TRACE( TRACE_ALWAYS, "Xct (%d) abort failed [0x%x]\n", xct_id, e2.err_num()); \
+            prequest->_result.set_state(ROLLBACKED);                    \
             prequest->notify_client();                                  \
             _request_pool.destroy(prequest);				\
             if ((*&_measure)!=MST_MEASURE) return (e);                  \
@@ -188,6 +191,7 @@ const int    SHORE_NUM_DB_OPTIONS  = 5;
 
 #define DEFINE_RUN_WITH_INPUT_TRX_WRAPPER(cname,trxlid,trximpl)         \
     w_rc_t cname::run_##trximpl(Request* prequest, trxlid##_input_t& in) { \
+        PERFCTR_REGION(_pc_xct,#trximpl);                               \
         int xct_id = prequest->xct_id();                                \
         TRACE( TRACE_TRX_FLOW, "%d. %s ...\n", xct_id, #trximpl);       \
         _inc_##trxlid##_att();                                          \
@@ -202,6 +206,7 @@ const int    SHORE_NUM_DB_OPTIONS  = 5;
             TRACE( TRACE_TRX_FLOW, "Xct (%d) aborted [0x%x]\n", xct_id, e.err_num()); \
             w_rc_t e2 = _pssm->abort_xct();                             \
             if(e2.is_error()) TRACE( TRACE_ALWAYS, "Xct (%d) abort failed [0x%x]\n", xct_id, e2.err_num()); \
+            prequest->_result.set_state(ROLLBACKED);                    \
             prequest->notify_client();                                  \
             if ((*&_measure)!=MST_MEASURE) return (e);                  \
             _env_stats.inc_trx_att();                                   \
@@ -294,22 +299,46 @@ const int    SHORE_NUM_DB_OPTIONS  = 5;
 
 struct env_stats_t 
 {
-    volatile uint_t _ntrx_att;
-    volatile uint_t _ntrx_com;
+    // per-thread stat counters, the samplers sum them
+    int _ntrx_att;
+    int _ntrx_com;
+
+    // latency of the completed batches, as seen by the clients (usecs)
+    // recorded only while someone samples it (_lat_users), who reads
+    // the differences of the sums. They are per-thread stat counters.
+    volatile uint_t   _lat_users;
+    int               _lat_sum;
+    int               _lat_cnt;
 
     env_stats_t() 
-        : _ntrx_att(0), _ntrx_com(0)
+        : _ntrx_att(stat_counter("env-xct-attempted")), 
+          _ntrx_com(stat_counter("env-xct-committed")),
+          _lat_users(0), 
+          _lat_sum(stat_counter("env-latency-usecs")), 
+          _lat_cnt(stat_counter("env-latency-count"))
     { }
 
     ~env_stats_t() { }
 
     void print_env_stats() const;
 
-    inline uint_t inc_trx_att() { return (atomic_inc_uint_nv(&_ntrx_att)); }
-    inline uint_t inc_trx_com() {
-        atomic_inc_uint(&_ntrx_att);
-        return (atomic_inc_uint_nv(&_ntrx_com)); 
+    inline void inc_trx_att() { stat_inc(_ntrx_att); }
+    inline void inc_trx_com() {
+        stat_inc(_ntrx_att);
+        stat_inc(_ntrx_com);
+    }
+    uint_t trx_att() const { return ((uint_t)stat_sum(_ntrx_att)); }
+    uint_t trx_com() const { return ((uint_t)stat_sum(_ntrx_com)); }
+
+    inline void record_latency(const uint_t us) {
+        stat_add(_lat_sum, us);
+        stat_inc(_lat_cnt);
     }
+    uint64_t lat_sum() const { return (stat_sum(_lat_sum)); }
+    uint64_t lat_cnt() const { return (stat_sum(_lat_cnt)); }
+    inline bool lat_on() const { return (*&_lat_users > 0); }
+    inline void lat_attach() { atomic_inc_uint(&_lat_users); }
+    inline void lat_detach() { atomic_dec_uint(&_lat_users); }
 
 }; // EOF env_stats_t
 
@@ -396,6 +425,8 @@ class base_worker_t;
 class trx_worker_t;
 class flusher_t;
 class ShoreEnv;
+struct worker_stats_t;
+struct flusher_stats_t;
 
 
 /******** Exported variables ********/
@@ -479,6 +510,9 @@ protected:
     uint _max_cpu_count;    // hard limit
     uint _active_cpu_count; // soft limit
 
+    // topology-aware placement of the clients (BT_TOPOLOGY)
+    guard<cpu_placement_t> _client_placement;
+
 
     // List of worker threads
     WorkerPool      _workers;    
@@ -516,6 +550,7 @@ protected:
     // physical design characteristics
     uint4_t _pd;
     bool _enable_hacks;
+    int _heap_parts;    // sub-files of the append-heavy tables (PD_HEAP_PART)
     
     
     // Helper functions
@@ -535,11 +570,16 @@ protected:
     int  start_sm();
     int  close_sm();
 
+    // Used by snapshot/restore around the copies
+    int  _shutdown_for_copy();
+    int  _reopen_after_copy();
+
     // load balancing settings
     volatile bool _bAlarmSet;
     tatas_lock _alarm_lock;
     int _start_imbalance;
     skew_type_t _skew_type;
+    skew_plan_t _skew_plan;
     
 public:
 
@@ -608,6 +648,11 @@ public:
     void set_max_cpu_count(const uint cpucnt);
     uint get_active_cpu_count() const;
     void set_active_cpu_count(const uint actcpucnt);
+
+    // Topology-aware client placement
+    processorid_t client_cpu(const uint apos, const uint atotal, const char* aname);
+    void reset_client_placement();
+    void print_client_placement() const;
     // disabled - max_count can be set only on conf
     //    void set_max_cpu_count(const int maxcpucnt); 
 
@@ -625,6 +670,7 @@ public:
     uint4_t add_pd(const physical_design_t& apd);
     bool check_hacks_enabled();
     bool is_hacks_enabled() const;
+    int heap_parts() const { return (_heap_parts); }
     virtual w_rc_t update_partitioning() { return (RCOK); }
 
     // -- insert/delete/probe frequencies for microbenchmarks -- //
@@ -635,6 +681,13 @@ public:
     virtual void reset_skew();
     virtual void start_load_imbalance();
 
+    // scripted skew scenarios (see shore_skew_plan.h). The hot spot is
+    // (load)% of the inputs going to (area)% of the key space, starting
+    // at (pos)%; an area of 0 is a single key
+    virtual void set_hot_spot(double pos, double area, int load);
+    virtual void clear_hot_spot();
+    skew_plan_t* get_skew_plan() { return (&_skew_plan); }
+
     // print the current db to files
     virtual void db_print_init(int num_lines);
     virtual w_rc_t db_print(int num_lines) { return(RCOK); }
@@ -642,6 +695,13 @@ public:
     // fetch the current db to buffer pool
     virtual void db_fetch_init();
     virtual w_rc_t db_fetch() { return(RCOK); }
+
+    // build the columnar replicas of the (DSS fact) tables
+    virtual void db_columns_init();
+    virtual w_rc_t db_columns() { return(RCOK); }
+
+    // print the memory the QPipe packets hold
+    virtual int mem_grants() { return (0); }
     
     // Environment workers
     uint upd_worker_cnt();
@@ -664,10 +724,30 @@ public:
     // Takes a checkpoint (forces dirty pages)
     int checkpoint();
 
+    // Snapshots of the database, for resetting it between runs. Both stop
+    // the workers, shut down the sm cleanly, copy the device and the log
+    // to (or from) dir, and bring everything back up. They should be
+    // called in a Shore context (see db_snapshot_smt_t).
+    int snapshot(const string& dir);
+    int restore(const string& dir);
+
+    // Bulk index loading during population (db-bulkload). The loaddata()
+    // of each workload switches the registered tables to bulk-load mode
+    // before firing up the loaders, and builds the indexes once they
+    // have finished.
+    bool start_bulkload();
+    w_rc_t finish_bulkload(const int builders);
+
     string sysname() { return (_sysname); }
 
     env_stats_t* get_env_stats() { return (&_env_stats); }
 
+    // Add up the stats of the workers (and flushers) without resetting 
+    // them, for the metrics sampler. Each worker writes only its own 
+    // stats, so they are read without locks.
+    virtual void gather_worker_stats(worker_stats_t& agg);
+    virtual void gather_flusher_stats(flusher_stats_t& agg);
+
     // For temp throughput calculation
     uint_t get_trx_att() const;
     uint_t get_trx_com() const;
@@ -103,6 +103,9 @@ enum file_type_t  { FT_HEAP         = 0x1,
  *                          to one leaf MRBTree index page
  *         PD_NOLOCK      - have indexes without CC
  *         PD_NOLATCH     - have indexes without even latching
+ *         PD_HEAP_PART   - spread the records of the (append-heavy)
+ *                          tables over a few heap files, one per group
+ *                          of inserting threads
  *
  * --------------------------------------------------------------- */
 
@@ -112,9 +115,12 @@ enum physical_design_t { PD_NORMAL      = 0x1,
                          PD_MRBT_PART   = 0x8,
                          PD_MRBT_LEAF   = 0x10,
                          PD_NOLOCK      = 0x20,
-                         PD_NOLATCH     = 0x40
+                         PD_NOLATCH     = 0x40,
+                         PD_HEAP_PART   = 0x80
 };
 
+const int MAX_HEAP_PARTS = 64;
+
 
 
 /*  --------------------------------------------------------------
@@ -140,6 +146,9 @@ protected:
 
     uint4_t           _pd;                   // info about the physical design
 
+    int               _heap_parts;           // # of heap sub-files (PD_HEAP_PART)
+    stid_t*           _heap_fids;            // their ids, [0] is the _fid
+
 
 public:
 
@@ -176,6 +185,27 @@ public:
     w_rc_t        find_fid(ss_m* db);
     w_rc_t        find_root_iid(ss_m* db);
 
+
+    /* ---------------------------------------- */
+    /* --- heap partitioning (PD_HEAP_PART) --- */
+    /* ---------------------------------------- */
+
+    // The records of a partitioned heap are spread over parts sub-files.
+    // The first is the file itself, the others are named <name>_h<i>.
+    // Each inserting thread appends to one of them, the scans visit all.
+    // Should be called before the file is created or found.
+    void          set_heap_parts(const int parts);
+    int           heap_parts() const { return (_heap_parts); }
+    bool          is_heap_partitioned() const { return (_heap_parts > 1); }
+
+    inline stid_t& heap_fid(const int part) {
+        assert ((part >= 0) && (part < _heap_parts));
+        return (part ? _heap_fids[part] : _fid);
+    }
+
+    // the sub-file the calling thread appends to
+    int           my_heap_part() const;
+
     inline w_rc_t check_fid(ss_m* db) {
         if (!is_fid_valid()) {
             if (!is_root_valid())
@@ -105,6 +105,8 @@ struct flusher_stats_t
     void print() const;
     void reset();
 
+    flusher_stats_t& operator+=(flusher_stats_t const& rhs);
+
 
     // Helper functions used by both the mainstream and the DORA flusher
     // They are here in order to be accessed by both 
@@ -177,6 +179,7 @@ public:
     }
 
     int statistics();  
+    flusher_stats_t get_stats() const { return (*&_stats); }
 
 }; // EOF: flusher_t
 
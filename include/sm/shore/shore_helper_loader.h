@@ -101,6 +101,42 @@ public:
 }; // EOF: db_init_smt_t
 
 
+
+/****************************************************************** 
+ *
+ *  @class: db_snapshot_smt_t
+ *
+ *  @brief: An smthread inherited class that it is used for taking
+ *          or restoring a snapshot of the database
+ *
+ ******************************************************************/
+
+class db_snapshot_smt_t : public thread_t 
+{
+private:
+    ShoreEnv* _env;
+    string    _dir;
+    bool      _bRestore;
+    int       _rv;
+
+public:
+    
+    db_snapshot_smt_t(c_str tname, ShoreEnv* db, 
+                      const string& dir, const bool bRestore) 
+	: thread_t(tname), _env(db), _dir(dir), _bRestore(bRestore), _rv(0)
+    {
+        assert (_env);
+    }
+
+    ~db_snapshot_smt_t() { }
+
+    // thread entrance
+    void work();
+    inline int rv() { return (_rv); }
+
+}; // EOF: db_snapshot_smt_t
+
+
     
 /****************************************************************** 
  *
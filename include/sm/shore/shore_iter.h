@@ -39,6 +39,7 @@
 #include "sm/shore/shore_error.h"
 #include "sm/shore/shore_file_desc.h"
 #include "sm/shore/shore_index.h"
+#include "sm/shore/shore_zone_map.h"
 
 
 ENTER_NAMESPACE(shore);
@@ -59,8 +60,10 @@ protected:
     bool          _opened;  // whether the init is successful
     file_desc_t*  _file;
     lock_mode_t   _lm;
+    int           _part;    // the heap sub-file being scanned
 
     guard<scan_file_i>  _scanner;
+    guard<zone_cursor_t> _pzone;  // if the scan skips pages by the zone maps
     
 public:
 
@@ -69,6 +72,11 @@ public:
 
     bool opened() const { return (_opened); }
 
+    // Before the first next(). Only the pages that may hold rows
+    // satisfying all the predicates are read, if the zone maps are
+    // valid. Returns false if the whole file will be scanned.
+    bool use_zones(zone_map_t* pzones, const vector<column_pred_t>& preds);
+
     w_rc_t open_scan(); 
 
     w_rc_t next(bool& eof, pin_i*& handle);
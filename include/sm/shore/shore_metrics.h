@@ -0,0 +1,122 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   shore_metrics.h
+ *
+ *  @brief:  Time-series metrics of the measurement runs
+ *
+ *  @note:   A sampler thread snapshots the env, worker and flusher
+ *           stats, the CPU usage and, optionally, the sm stats every
+ *           interval, and appends their differences as one CSV or JSON
+ *           line to a file. The worker and flusher stats are written
+ *           only by their own threads and are read without locks. The
+ *           env counters are per-thread stat counters, summed by the
+ *           sampler; the threads that update them never lock. It is 
+ *           configured by:
+ *
+ *           metrics-file     - the output file, appended to ("none" is off)
+ *           metrics-format   - csv or json
+ *           metrics-interval - msecs between two samples
+ *           metrics-sm       - 1 adds the sm stats to every sample
+ */
+
+#ifndef __SHORE_METRICS_H
+#define __SHORE_METRICS_H
+
+#include "sm/shore/shore_env.h"
+#include "sm/shore/shore_worker.h"
+#include "sm/shore/shore_flusher.h"
+
+#include <vector>
+
+
+ENTER_NAMESPACE(shore);
+
+
+const int DF_METRICS_INTERVAL = 1000; // msecs
+const int METRICS_TICK_US     = 10000;
+
+
+/******************************************************************** 
+ *
+ * @class: metrics_sampler_t
+ *
+ * @brief: Samples the stats during a measurement
+ *
+ ********************************************************************/
+
+class metrics_sampler_t : public thread_t
+{
+private:
+
+    typedef std::pair<string,double> metric_t;
+    typedef std::vector<metric_t>    sample_t;
+
+    ShoreEnv*        _env;
+    string           _fname;
+    bool             _json;
+    int              _interval_ms;
+    bool             _with_sm;
+    int              _run;
+    volatile bool    _stop;
+
+    FILE*            _fout;
+    bool             _header;   // the CSV header is in the file
+    uint             _columns;  // and fixes the number of columns
+
+    // the previous readings
+    uint_t           _last_att;
+    uint_t           _last_com;
+    uint64_t         _last_lsum;
+    uint64_t         _last_lcnt;
+    uint64_t         _last_cpu_us;
+    worker_stats_t   _last_ws;
+    flusher_stats_t  _last_fs;
+    sm_stats_info_t  _last_sm;
+
+    void _sample(sample_t& asample, const double secs);
+    void _sample_sm(sample_t& asample);
+    void _write(const double t, const sample_t& asample);
+
+public:
+
+    metrics_sampler_t(c_str tname, ShoreEnv* env, const string& fname,
+                      const bool json, const int interval_ms, 
+                      const bool with_sm, const int run);
+    ~metrics_sampler_t();
+
+    void work();
+    void stop() { _stop = true; }
+
+    // forks a sampler if metrics-file is set, returns NULL otherwise
+    static metrics_sampler_t* start(ShoreEnv* env);
+
+    // stops, joins and deletes it (if any)
+    static void finish(metrics_sampler_t* psampler);
+
+}; // EOF: metrics_sampler_t
+
+
+EXIT_NAMESPACE(shore);
+
+#endif /* __SHORE_METRICS_H */
@@ -73,13 +73,13 @@ private:
 
     TrxState R_STATE;
     int R_ID;
-    condex* _notify;
+    completion_queue_t* _notify; // the ring of the client, if it waits
    
 public:
 
     trx_result_tuple_t() { reset(UNDEF, -1, NULL); }
 
-    trx_result_tuple_t(TrxState aTrxState, int anID, condex* apcx = NULL) { 
+    trx_result_tuple_t(TrxState aTrxState, int anID, completion_queue_t* apcx = NULL) { 
         reset(aTrxState, anID, apcx);
     }
 
@@ -105,8 +105,8 @@ public:
 
 
     // Access methods
-    condex* get_notify() const { return (_notify); }
-    void set_notify(condex* notify) { _notify = notify; }
+    completion_queue_t* get_notify() const { return (_notify); }
+    void set_notify(completion_queue_t* notify) { _notify = notify; }
     
     int get_id() const { return (R_ID); }
     void set_id(const int aID) { R_ID = aID; }
@@ -117,7 +117,7 @@ public:
        R_STATE = aState;
     }
 
-    void reset(TrxState aTrxState, int anID, condex* notify) {
+    void reset(TrxState aTrxState, int anID, completion_queue_t* notify) {
         // check for validity of inputs
         assert ((aTrxState >= UNDEF) && (aTrxState <= ROLLBACKED));
         assert (anID >= NO_VALID_TRX_ID);
@@ -168,6 +168,11 @@ struct table_row_t
     rep_row_t*     _rep;          /* a pointer to a row representation struct */
     rep_row_t*     _rep_key;      /* a pointer to a row-key representation struct */
 
+    // dirty-field tracking, for updating only the modified bytes
+    bool*          _pdirty;       /* fields set since the row was loaded */
+    uint           _dirty_cnt;    /* number of dirty fields */
+    bool           _image_valid;  /* the values not dirty are the ones on disk */
+
 
     /* -------------------- */
     /* --- construction --- */
@@ -179,7 +184,8 @@ struct table_row_t
 	  _field_cnt(0), _is_setup(false), 
 	  _rid(rid_t::null), _pvalues(NULL), 
 	  _fixed_offset(0),_var_slot_offset(0),_var_offset(0),_null_count(0),
-	  _rep(NULL), _rep_key(NULL)
+	  _rep(NULL), _rep_key(NULL),
+	  _pdirty(NULL), _dirty_cnt(0), _image_valid(false)
     {
         assert (ptd);
         setup(ptd);
@@ -214,6 +220,31 @@ struct table_row_t
     uint size() const;
 
 
+    /* ---------------------------- */
+    /* --- dirty-field tracking --- */
+    /* ---------------------------- */
+
+    // Every set_value() marks the field as dirty. After the row is loaded
+    // from (or written to) disk the dirty set is cleared and the image is
+    // valid, so that update_tuple() writes only the dirty fields. Whenever
+    // the values may differ from the record without being marked dirty
+    // (reset, loading only the key, copying from a cache) the image is
+    // invalid, and update_tuple() rewrites the whole record.
+
+    inline void mark_dirty(const uint idx) {
+        assert (idx < _field_cnt);
+        if (!_pdirty[idx]) {
+            _pdirty[idx] = true;
+            _dirty_cnt++;
+        }
+    }
+    inline bool is_dirty(const uint idx) const { return (_pdirty[idx]); }
+    inline uint dirty_count() const { return (_dirty_cnt); }
+    inline bool is_image_valid() const { return (_image_valid); }
+
+    void reset_dirty(const bool bImageValid);
+
+
     /* ------------------------ */
     /* --- set field values --- */
     /* ------------------------ */
@@ -267,6 +298,7 @@ struct table_row_t
         assert (_is_setup);
         for (uint_t i=0; i<_field_cnt; i++)
             _pvalues[i].reset();
+        reset_dirty(false);
     }        
 
     void freevalues()
@@ -275,6 +307,10 @@ struct table_row_t
             delete [] _pvalues;
             _pvalues = NULL;
         }
+        if (_pdirty) {
+            delete [] _pdirty;
+            _pdirty = NULL;
+        }
     }
 
 }; // EOF: table_row_t
@@ -304,6 +340,40 @@ private:
 };
 
 
+/******************************************************************
+ *
+ * class tuple_batch_guard
+ *
+ * @brief: guard object for a group of table_row_t from the same
+ *         manager, e.g. the arguments of table_man_t::index_probe_batch()
+ *
+ ******************************************************************/
+template<class M, class T=table_row_t>
+struct tuple_batch_guard {
+    T**  ptrs;
+    uint count;
+    M*   manager;
+    tuple_batch_guard(M* m, const uint cnt)
+	: ptrs(new T*[cnt]), count(cnt), manager(m) 
+    {
+        for (uint i=0; i<count; i++) { ptrs[i] = m->get_tuple(); assert(ptrs[i]); }
+    }
+    ~tuple_batch_guard() {
+        for (uint i=0; i<count; i++) manager->give_tuple(ptrs[i]);
+        delete [] ptrs;
+    }
+    T* operator[](const uint i) { assert (i<count); return ptrs[i]; }
+    operator T**() { return ptrs; }
+    void set_rep(rep_row_t* prep) {
+        for (uint i=0; i<count; i++) ptrs[i]->_rep = prep;
+    }
+private:
+    // no you copy!
+    tuple_batch_guard(tuple_batch_guard&);
+    void operator=(tuple_batch_guard&);
+};
+
+
 /******************************************************************
  * 
  * class table_row_t methods 
@@ -325,6 +395,7 @@ inline void table_row_t::set_null(const uint idx)
     assert (_is_setup);
     assert (idx < _field_cnt);
     assert (_pvalues[idx].is_setup());
+    mark_dirty(idx);
     _pvalues[idx].set_null();
 }
 
@@ -333,6 +404,7 @@ inline void table_row_t::set_value(const uint idx, const int v)
     assert (_is_setup);
     assert (idx < _field_cnt);
     assert (_pvalues[idx].is_setup());
+    mark_dirty(idx);
     _pvalues[idx].set_int_value(v);
 }
 
@@ -341,6 +413,7 @@ inline void table_row_t::set_value(const uint idx, const bool v)
     assert (_is_setup);
     assert (idx < _field_cnt);
     assert (_pvalues[idx].is_setup());
+    mark_dirty(idx);
     _pvalues[idx].set_bit_value(v);
 }
 
@@ -349,6 +422,7 @@ inline void table_row_t::set_value(const uint idx, const short v)
     assert (_is_setup);
     assert (idx < _field_cnt);
     assert (_pvalues[idx].is_setup());
+    mark_dirty(idx);
     _pvalues[idx].set_smallint_value(v);
 }
 
@@ -357,6 +431,7 @@ inline void table_row_t::set_value(const uint idx, const double v)
     assert (_is_setup);
     assert (idx < _field_cnt);
     assert (_pvalues[idx].is_setup());
+    mark_dirty(idx);
     _pvalues[idx].set_float_value(v);
 }
 
@@ -365,6 +440,7 @@ inline void table_row_t::set_value(const uint idx, const long long v)
     assert (_is_setup);
     assert (idx < _field_cnt);
     assert (_pvalues[idx].is_setup());
+    mark_dirty(idx);
     _pvalues[idx].set_long_value(v);
 }
 
@@ -373,6 +449,7 @@ inline void table_row_t::set_value(const uint idx, const decimal v)
     assert (_is_setup);
     assert (idx < _field_cnt);
     assert (_pvalues[idx].is_setup());
+    mark_dirty(idx);
     _pvalues[idx].set_decimal_value(v);
 }
 
@@ -381,6 +458,7 @@ inline void table_row_t::set_value(const uint idx, const time_t v)
     assert (_is_setup);
     assert (idx < _field_cnt);
     assert (_pvalues[idx].is_setup());
+    mark_dirty(idx);
     _pvalues[idx].set_time_value(v);
 }
 
@@ -389,6 +467,7 @@ inline void table_row_t::set_value(const uint idx, const char v)
     assert (_is_setup);
     assert (idx < _field_cnt);
     assert (_pvalues[idx].is_setup());
+    mark_dirty(idx);
     _pvalues[idx].set_char_value(v);
 }
 
@@ -397,6 +476,7 @@ inline void table_row_t::set_value(const uint idx, const char* string)
     assert (_is_setup);
     assert (idx < _field_cnt);
     assert (_pvalues[idx].is_setup());
+    mark_dirty(idx);
 
     sqltype_t sqlt = _pvalues[idx].field_desc()->type();
     assert (sqlt == SQL_VARCHAR || sqlt == SQL_FIXCHAR );
@@ -417,6 +497,7 @@ inline void table_row_t::set_value(const uint idx, const timestamp_t& time)
     assert (_is_setup);
     assert (idx < _field_cnt);
     assert (_pvalues[idx].is_setup());
+    mark_dirty(idx);
     _pvalues[idx].set_value(&time, 0);
 }
 
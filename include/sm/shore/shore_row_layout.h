@@ -0,0 +1,330 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   shore_row_layout.h
+ *
+ *  @brief:  Compile-time typed row layouts
+ *
+ *  @note:   row_codec_t        - straight-line format/load of a table
+ *           row_layout_codec_t - the codec generated from a layout
+ *
+ *  The fields of a table are listed once, in a macro:
+ *
+ *    #define SUBSCRIBER_FIELDS(F)              \
+ *        F(S_ID,    INT,     0)                \
+ *        F(SUB_NBR, FIXCHAR, TM1_SUB_NBR_SZ)   \
+ *        F(BIT_1,   BIT,     0)                \
+ *        ...
+ *
+ *    DECLARE_ROW_LAYOUT(subscriber_row_t, SUBSCRIBER_FIELDS);
+ *
+ *  The layout struct that is generated has:
+ *
+ *  - One member per field (strings are '\0'-terminated, i.e. N+1 chars),
+ *    so it can be used as a plain C struct of the row, with fetch() and
+ *    store() to copy a whole table_row_t in or out of it.
+ *
+ *  - IDX_<field> constants and typed get_<field>()/set_<field>() that
+ *    go straight to the value of the field in a table_row_t, without the
+ *    index/type checks of table_row_t::get_value(). Like set_value(), the
+ *    setters mark the field dirty.
+ *
+ *  - disk_t, a packed struct with the disk image of the row, and the
+ *    format_row()/load_row() functions that (de)serialize a table_row_t
+ *    with a memcpy per field at compile-time offsets.
+ *
+ *  - setup_desc(), which sets up the field descriptors of the table,
+ *    so that the schema and the layout cannot go out of sync.
+ *
+ *  A table uses it with table_desc_t::setup_layout<Layout>() in its
+ *  constructor, after which table_man_t::format() and load() go through
+ *  the generated code. Tables without a layout keep the generic path.
+ *
+ *  @note:   Layouts support only fixed-size, non-null fields (everything
+ *           except VARCHAR and TIME), for which the disk format is just
+ *           the fields one after the other. This is the case for all the
+ *           TPC-C and TM1 tables.
+ *
+ */
+
+#ifndef __SHORE_ROW_LAYOUT_H
+#define __SHORE_ROW_LAYOUT_H
+
+#include "shore_row.h"
+
+#include <cstddef>
+
+
+ENTER_NAMESPACE(shore);
+
+
+
+/* ---------------------------------------------------------------
+ *
+ * @abstract class: row_codec_t
+ *
+ * @brief: Converts the rows of a table between the table_row_t and
+ *         the disk format. Must produce the same format as the generic
+ *         table_man_t::format()/load().
+ *
+ * --------------------------------------------------------------- */
+
+class row_codec_t
+{
+public:
+    virtual ~row_codec_t() { }
+
+    // size of the disk format
+    virtual uint_t size() const=0;
+
+    // writes the disk format of the row to dest (size() bytes, zeroed)
+    virtual int  format(const table_row_t* prow, char* dest) const=0;
+
+    // reads the row back from its disk format
+    virtual void load(table_row_t* prow, const char* src) const=0;
+
+}; // EOF: row_codec_t
+
+
+template <class Layout>
+class row_layout_codec_t : public row_codec_t
+{
+public:
+    uint_t size() const { return (sizeof(typename Layout::disk_t)); }
+
+    int format(const table_row_t* prow, char* dest) const {
+        return (Layout::format_row(prow, dest));
+    }
+
+    void load(table_row_t* prow, const char* src) const {
+        Layout::load_row(prow, src);
+    }
+
+}; // EOF: row_layout_codec_t
+
+
+
+/* ---------------------------------------------------------------
+ *
+ * Per-kind expansions of a field F(name, KIND, size). KIND is one of
+ * INT, SMALLINT, BIT, CHAR, FLOAT, LONG, FIXCHAR. The size is used only
+ * by FIXCHAR.
+ *
+ * --------------------------------------------------------------- */
+
+// the C type and the field_value_t union member of each kind
+#define ROW_CTYPE_INT      int
+#define ROW_CTYPE_SMALLINT short
+#define ROW_CTYPE_BIT      bool
+#define ROW_CTYPE_CHAR     char
+#define ROW_CTYPE_FLOAT    double
+#define ROW_CTYPE_LONG     long long
+
+#define ROW_UFIELD_INT      _int
+#define ROW_UFIELD_SMALLINT _smallint
+#define ROW_UFIELD_BIT      _bit
+#define ROW_UFIELD_CHAR     _char
+#define ROW_UFIELD_FLOAT    _float
+#define ROW_UFIELD_LONG     _long
+
+#define ROW_SQLTYPE_INT      SQL_INT
+#define ROW_SQLTYPE_SMALLINT SQL_SMALLINT
+#define ROW_SQLTYPE_BIT      SQL_BIT
+#define ROW_SQLTYPE_CHAR     SQL_CHAR
+#define ROW_SQLTYPE_FLOAT    SQL_FLOAT
+#define ROW_SQLTYPE_LONG     SQL_LONG
+#define ROW_SQLTYPE_FIXCHAR  SQL_FIXCHAR
+
+
+// field positions
+#define ROW_LAYOUT_IDX(name, kind, sz)  IDX_##name,
+
+// schema
+#define ROW_LAYOUT_DESC(name, kind, sz) \
+    pdesc[IDX_##name].setup(ROW_SQLTYPE_##kind, #name, (sz));
+
+
+// members of the row struct and of the disk image
+#define ROW_MEMBER_SCALAR(name, kind) ROW_CTYPE_##kind name;
+#define ROW_MEMBER_INT(name, sz)      ROW_MEMBER_SCALAR(name, INT)
+#define ROW_MEMBER_SMALLINT(name, sz) ROW_MEMBER_SCALAR(name, SMALLINT)
+#define ROW_MEMBER_BIT(name, sz)      ROW_MEMBER_SCALAR(name, BIT)
+#define ROW_MEMBER_CHAR(name, sz)     ROW_MEMBER_SCALAR(name, CHAR)
+#define ROW_MEMBER_FLOAT(name, sz)    ROW_MEMBER_SCALAR(name, FLOAT)
+#define ROW_MEMBER_LONG(name, sz)     ROW_MEMBER_SCALAR(name, LONG)
+#define ROW_MEMBER_FIXCHAR(name, sz)  char name[(sz)+1];
+#define ROW_LAYOUT_MEMBER(name, kind, sz) ROW_MEMBER_##kind(name, sz)
+
+#define ROW_DISK_FIXCHAR(name, sz)    char name[(sz)];
+#define ROW_DISK_INT(name, sz)        ROW_MEMBER_INT(name, sz)
+#define ROW_DISK_SMALLINT(name, sz)   ROW_MEMBER_SMALLINT(name, sz)
+#define ROW_DISK_BIT(name, sz)        ROW_MEMBER_BIT(name, sz)
+#define ROW_DISK_CHAR(name, sz)       ROW_MEMBER_CHAR(name, sz)
+#define ROW_DISK_FLOAT(name, sz)      ROW_MEMBER_FLOAT(name, sz)
+#define ROW_DISK_LONG(name, sz)       ROW_MEMBER_LONG(name, sz)
+#define ROW_LAYOUT_DISK(name, kind, sz) ROW_DISK_##kind(name, sz)
+
+
+// typed accessors on a table_row_t
+#define ROW_ACCESS_SCALAR(name, kind)                                   \
+    static inline ROW_CTYPE_##kind get_##name(const table_row_t* prow) { \
+        assert (prow->_field_cnt == FIELD_COUNT);                       \
+        return (prow->_pvalues[IDX_##name]._value.ROW_UFIELD_##kind);   \
+    }                                                                   \
+    static inline void set_##name(table_row_t* prow,                    \
+                                  const ROW_CTYPE_##kind v) {           \
+        assert (prow->_field_cnt == FIELD_COUNT);                       \
+        field_value_t& fv = prow->_pvalues[IDX_##name];                 \
+        fv._value.ROW_UFIELD_##kind = v;                                \
+        fv._null_flag = false;                                          \
+        prow->mark_dirty(IDX_##name);                                   \
+    }
+#define ROW_ACCESS_INT(name, sz)      ROW_ACCESS_SCALAR(name, INT)
+#define ROW_ACCESS_SMALLINT(name, sz) ROW_ACCESS_SCALAR(name, SMALLINT)
+#define ROW_ACCESS_BIT(name, sz)      ROW_ACCESS_SCALAR(name, BIT)
+#define ROW_ACCESS_CHAR(name, sz)     ROW_ACCESS_SCALAR(name, CHAR)
+#define ROW_ACCESS_FLOAT(name, sz)                                      \
+    ROW_ACCESS_SCALAR(name, FLOAT)                                      \
+    static inline void set_##name(table_row_t* prow, const decimal v) { \
+        set_##name(prow, v.to_double());                                \
+    }
+#define ROW_ACCESS_LONG(name, sz)     ROW_ACCESS_SCALAR(name, LONG)
+#define ROW_ACCESS_FIXCHAR(name, sz)                                    \
+    /* copies the value to buf, which should have sz+1 chars */         \
+    static inline char* get_##name(const table_row_t* prow, char* buf) { \
+        assert (prow->_field_cnt == FIELD_COUNT);                       \
+        const field_value_t& fv = prow->_pvalues[IDX_##name];           \
+        memcpy(buf, fv._value._string, fv._real_size);                  \
+        memset(buf + fv._real_size, 0, (sz) + 1 - fv._real_size);       \
+        return (buf);                                                   \
+    }                                                                   \
+    static inline void set_##name(table_row_t* prow, const char* s) {   \
+        assert (prow->_field_cnt == FIELD_COUNT);                       \
+        field_value_t& fv = prow->_pvalues[IDX_##name];                 \
+        uint_t len = strlen(s);                                         \
+        if (len > (sz)) len = (sz);                                     \
+        memcpy(fv._value._string, s, len);                              \
+        fv._real_size = len;                                            \
+        fv._null_flag = false;                                          \
+        prow->mark_dirty(IDX_##name);                                   \
+    }
+#define ROW_LAYOUT_ACCESS(name, kind, sz) ROW_ACCESS_##kind(name, sz)
+
+
+// whole-row copies between a table_row_t and the row struct
+#define ROW_FETCH_SCALAR(name)        name = get_##name(prow);
+#define ROW_FETCH_INT(name, sz)       ROW_FETCH_SCALAR(name)
+#define ROW_FETCH_SMALLINT(name, sz)  ROW_FETCH_SCALAR(name)
+#define ROW_FETCH_BIT(name, sz)       ROW_FETCH_SCALAR(name)
+#define ROW_FETCH_CHAR(name, sz)      ROW_FETCH_SCALAR(name)
+#define ROW_FETCH_FLOAT(name, sz)     ROW_FETCH_SCALAR(name)
+#define ROW_FETCH_LONG(name, sz)      ROW_FETCH_SCALAR(name)
+#define ROW_FETCH_FIXCHAR(name, sz)   get_##name(prow, name);
+#define ROW_LAYOUT_FETCH(name, kind, sz) ROW_FETCH_##kind(name, sz)
+
+#define ROW_LAYOUT_STORE(name, kind, sz) set_##name(prow, name);
+
+
+// disk format of a table_row_t, one memcpy per field
+#define ROW_FORMAT_SCALAR(name, kind)                                   \
+    memcpy(dest + offsetof(disk_t, name),                               \
+           &prow->_pvalues[IDX_##name]._value.ROW_UFIELD_##kind,        \
+           sizeof(ROW_CTYPE_##kind));
+#define ROW_FORMAT_INT(name, sz)      ROW_FORMAT_SCALAR(name, INT)
+#define ROW_FORMAT_SMALLINT(name, sz) ROW_FORMAT_SCALAR(name, SMALLINT)
+#define ROW_FORMAT_BIT(name, sz)      ROW_FORMAT_SCALAR(name, BIT)
+#define ROW_FORMAT_CHAR(name, sz)     ROW_FORMAT_SCALAR(name, CHAR)
+#define ROW_FORMAT_FLOAT(name, sz)    ROW_FORMAT_SCALAR(name, FLOAT)
+#define ROW_FORMAT_LONG(name, sz)     ROW_FORMAT_SCALAR(name, LONG)
+#define ROW_FORMAT_FIXCHAR(name, sz)                                    \
+    memcpy(dest + offsetof(disk_t, name),                               \
+           prow->_pvalues[IDX_##name]._value._string,                   \
+           prow->_pvalues[IDX_##name]._real_size);
+#define ROW_LAYOUT_FORMAT(name, kind, sz) ROW_FORMAT_##kind(name, sz)
+
+#define ROW_LOAD_SCALAR(name, kind)                                     \
+    {                                                                   \
+        field_value_t& fv = prow->_pvalues[IDX_##name];                 \
+        memcpy(&fv._value.ROW_UFIELD_##kind,                            \
+               src + offsetof(disk_t, name),                            \
+               sizeof(ROW_CTYPE_##kind));                               \
+        fv._null_flag = false;                                          \
+    }
+#define ROW_LOAD_INT(name, sz)        ROW_LOAD_SCALAR(name, INT)
+#define ROW_LOAD_SMALLINT(name, sz)   ROW_LOAD_SCALAR(name, SMALLINT)
+#define ROW_LOAD_BIT(name, sz)        ROW_LOAD_SCALAR(name, BIT)
+#define ROW_LOAD_CHAR(name, sz)       ROW_LOAD_SCALAR(name, CHAR)
+#define ROW_LOAD_FLOAT(name, sz)      ROW_LOAD_SCALAR(name, FLOAT)
+#define ROW_LOAD_LONG(name, sz)       ROW_LOAD_SCALAR(name, LONG)
+#define ROW_LOAD_FIXCHAR(name, sz)                                      \
+    {                                                                   \
+        field_value_t& fv = prow->_pvalues[IDX_##name];                 \
+        memcpy(fv._value._string, src + offsetof(disk_t, name), (sz));  \
+        fv._real_size = (sz);                                           \
+        fv._null_flag = false;                                          \
+    }
+#define ROW_LAYOUT_LOAD(name, kind, sz) ROW_LOAD_##kind(name, sz)
+
+
+
+/* ---------------------------------------------------------------
+ *
+ * @macro: DECLARE_ROW_LAYOUT
+ *
+ * @brief: Generates the layout struct of a table from the list of its
+ *         fields (see the top of the file)
+ *
+ * --------------------------------------------------------------- */
+
+#define DECLARE_ROW_LAYOUT(layout, FIELDS)                              \
+    struct layout {                                                     \
+        enum { FIELDS(ROW_LAYOUT_IDX) FIELD_COUNT };                    \
+                                                                        \
+        struct disk_t { FIELDS(ROW_LAYOUT_DISK) } ATTRIBUTE(packed);    \
+                                                                        \
+        FIELDS(ROW_LAYOUT_MEMBER)                                       \
+                                                                        \
+        FIELDS(ROW_LAYOUT_ACCESS)                                       \
+                                                                        \
+        void fetch(const table_row_t* prow) { FIELDS(ROW_LAYOUT_FETCH) } \
+        void store(table_row_t* prow) const { FIELDS(ROW_LAYOUT_STORE) } \
+                                                                        \
+        static int format_row(const table_row_t* prow, char* dest) {    \
+            assert (prow->_field_cnt == FIELD_COUNT);                   \
+            FIELDS(ROW_LAYOUT_FORMAT)                                   \
+            return (sizeof(disk_t));                                    \
+        }                                                               \
+        static void load_row(table_row_t* prow, const char* src) {      \
+            assert (prow->_field_cnt == FIELD_COUNT);                   \
+            FIELDS(ROW_LAYOUT_LOAD)                                     \
+        }                                                               \
+                                                                        \
+        static void setup_desc(field_desc_t* pdesc) {                   \
+            FIELDS(ROW_LAYOUT_DESC)                                     \
+        }                                                               \
+    }
+
+
+EXIT_NAMESPACE(shore);
+
+#endif /* __SHORE_ROW_LAYOUT_H */
@@ -38,6 +38,8 @@
 #include "sm/shore/shore_env.h"
 #include "sm/shore/shore_helper_loader.h"
 #include "sm/shore/shore_client.h"
+#include "sm/shore/shore_trx_server.h"
+#include "sm/shore/shore_metrics.h"
 
 
 ENTER_NAMESPACE(shore);
@@ -90,10 +92,15 @@ DECLARE_ENV_CMD(dump);
 DECLARE_ENV_CMD(fake_iodelay);
 DECLARE_ENV_CMD(freq);
 DECLARE_ENV_CMD(skew);
+DECLARE_ENV_CMD(skewplan);
 DECLARE_ENV_CMD(db_print);
 DECLARE_ENV_CMD(db_fetch);
+DECLARE_ENV_CMD(db_columns);
+DECLARE_ENV_CMD(mem_grants);
 DECLARE_ENV_CMD(stats_verbose);
 DECLARE_ENV_CMD(log);
+DECLARE_ENV_CMD(snapshot);
+DECLARE_ENV_CMD(restore);
 
 
 
@@ -158,6 +165,7 @@ DECLARE_KIT_CMD(test);
 DECLARE_KIT_CMD(warmup);
 DECLARE_KIT_CMD(load);
 DECLARE_KIT_CMD(trxs);
+DECLARE_KIT_CMD(serve);
 
 
 
@@ -210,12 +218,17 @@ protected:
     guard<fake_iodelay_cmd_t>   _fakeioer;   
     guard<freq_cmd_t>           _freqer;
     guard<skew_cmd_t>           _skewer;
+    guard<skewplan_cmd_t>       _skewplanner;
     guard<stats_verbose_cmd_t>  _stats_verboser;
     guard<db_print_cmd_t>       _db_printer;
     guard<db_fetch_cmd_t>       _db_fetch;
+    guard<db_columns_cmd_t>     _db_columns;
+    guard<mem_grants_cmd_t>     _mem_granter;
     
     guard<log_cmd_t>            _logger;
     guard<asynch_cmd_t>         _asyncher;
+    guard<snapshot_cmd_t>       _snapshoter;
+    guard<restore_cmd_t>        _restorer;
 
     guard<sli_cmd_t>            _slier;
     guard<elr_cmd_t>            _elrer;
@@ -229,6 +242,7 @@ protected:
     guard<warmup_cmd_t>         _warmuper;
     guard<load_cmd_t>           _loader;
     guard<trxs_cmd_t>           _trxser;
+    guard<serve_cmd_t>          _server;
 
 public:
 
@@ -268,6 +282,7 @@ public:
     virtual int process_cmd_TEST(const char* command);
     virtual int process_cmd_WARMUP(const char* command);    
     virtual int process_cmd_LOAD(const char* command);        
+    virtual int process_cmd_SERVE(const char* command);
 
 
     // virtual implementation of the {WARMUP/TEST/MEASURE} 
@@ -276,6 +291,8 @@ public:
     virtual int _cmd_WARMUP_impl(const double iQueriedSF, const int iTrxs, 
                                  const int iDuration, const int iIterations);
     virtual int _cmd_LOAD_impl(void);
+    virtual int _cmd_SERVE_impl(const double iQueriedSF, const int iDuration,
+                                const int iPort);
 
     virtual int _cmd_TEST_impl(const double iQueriedSF, const int iSpread,
                                const int iNumOfThreads, const int iNumOfTrxs,
@@ -292,6 +309,10 @@ public:
     virtual processorid_t next_cpu(const eBindingType abt,
                                    const processorid_t aprd);
 
+    // cpu of a client under the BT_TOPOLOGY binding policy
+    processorid_t topology_cpu(const int aclient, const int awh,
+                               const double aqf, const int aclients);
+
 
 protected:
     
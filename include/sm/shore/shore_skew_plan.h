@@ -0,0 +1,194 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   shore_skew_plan.h
+ *
+ *  @brief:  Scripted skew scenarios, for measuring how fast a system
+ *           adapts when the load moves
+ *
+ *  @note:   A plan is a list of timed steps. During a measurement, the
+ *           skew scheduler applies each step to the environment at its
+ *           offset from the beginning of the measurement:
+ *
+ *           HOT  <POS> <AREA> <LOAD> - (LOAD)% of the inputs go to a hot
+ *                area of (AREA)% of the key space, starting at (POS)%.
+ *                An area of 0 is a single key (flash crowd).
+ *           COOL - removes the hot area
+ *           ZIPF <S> - sets the zipf s of the inputs, 0 for uniform and
+ *                a negative s for the setting of the "zipf" command
+ *
+ *           The hot areas are placed at fixed positions and the steps
+ *           at fixed times, so a plan gives the same scenario in every
+ *           run. The scheduler also records the throughput and the
+ *           client-side latency of every second.
+ */
+
+#ifndef __SHORE_SKEW_PLAN_H
+#define __SHORE_SKEW_PLAN_H
+
+#include "util.h"
+
+#include <vector>
+
+
+ENTER_NAMESPACE(shore);
+
+
+class ShoreEnv;
+
+
+// scheduler tick (usecs)
+const int SKEW_TICK_US = 10000;
+
+
+/******************************************************************** 
+ *
+ * @enum:  skew_step_type_t
+ *
+ ********************************************************************/
+
+enum skew_step_type_t {
+    SKS_HOT  = 0x1,
+    SKS_COOL = 0x2,
+    SKS_ZIPF = 0x4
+};
+
+
+/******************************************************************** 
+ *
+ * @struct: skew_step_t
+ *
+ ********************************************************************/
+
+struct skew_step_t
+{
+    double           _at;    // secs from the beginning of the measurement
+    skew_step_type_t _type;
+    double           _pos;   // HOT: start of the hot area (% of the keys)
+    double           _area;  // HOT: size of the hot area (% of the keys)
+    int              _load;  // HOT: % of the inputs in the hot area
+    double           _s;     // ZIPF: the s of the distribution
+
+    skew_step_t(const double at, const skew_step_type_t atype)
+        : _at(at), _type(atype), _pos(0), _area(0), _load(0), _s(0)
+    { }
+
+    string str() const;
+
+}; // EOF: skew_step_t
+
+
+
+/******************************************************************** 
+ *
+ * @class: skew_plan_t
+ *
+ * @brief: The steps of a scenario, sorted by time
+ *
+ ********************************************************************/
+
+class skew_plan_t
+{
+private:
+
+    std::vector<skew_step_t> _steps;
+
+    // where the per-second series goes (CSV), the trace if empty
+    string _outfile;
+
+public:
+
+    skew_plan_t() { }
+    ~skew_plan_t() { }
+
+    void clear() { _steps.clear(); }
+    bool empty() const { return (_steps.empty()); }
+    uint size() const { return (_steps.size()); }
+    const skew_step_t& step(const uint idx) const { return (_steps[idx]); }
+
+    void set_outfile(const string& fname) { _outfile = fname; }
+    const string& outfile() const { return (_outfile); }
+
+    // a step goes after the ones with the same time
+    void add(const skew_step_t& astep);
+
+    // reads the steps from a file, one per line: 
+    // <AT> hot <POS> <AREA> <LOAD> | <AT> cool | <AT> zipf <S>
+    int load(const char* fname);
+
+    // a hot area of (area)% that moves by its size every (period) 
+    // secs, until (duration)
+    void add_moving(const double area, const int load, 
+                    const double period, const double duration);
+
+    // the zipf s goes through the (svals) every (period) secs, until
+    // (duration)
+    void add_zipf(const std::vector<double>& svals, 
+                  const double period, const double duration);
+
+    // (load)% of the inputs go to the single key at (pos)% from (at) 
+    // to (at+length)
+    void add_flash(const double pos, const int load,
+                   const double at, const double length);
+
+    void print() const;
+
+}; // EOF: skew_plan_t
+
+
+
+/******************************************************************** 
+ *
+ * @class: skew_scheduler_t
+ *
+ * @brief: Applies a plan during one measurement and records the
+ *         throughput and latency of every second
+ *
+ ********************************************************************/
+
+class skew_scheduler_t : public thread_t
+{
+private:
+
+    ShoreEnv*           _env;
+    const skew_plan_t&  _plan;
+
+    // the "zipf" command setting, restored at the end
+    bool                _zipf_enabled;
+    double              _zipf_s;
+
+    void _apply(const skew_step_t& astep);
+
+public:
+
+    skew_scheduler_t(c_str tname, ShoreEnv* env, const skew_plan_t& plan);
+    ~skew_scheduler_t() { }
+
+    void work();
+
+}; // EOF: skew_scheduler_t
+
+
+EXIT_NAMESPACE(shore);
+
+#endif /* __SHORE_SKEW_PLAN_H */
@@ -0,0 +1,220 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   shore_snapshot.h
+ *
+ *  @brief:  The snapshots of an in-memory copy of a table (the table
+ *           cache and the columnar replica)
+ *
+ *  @note:   snapshot_epoch_t  - the read epochs of the threads
+ *           snapshot_set_t<S> - the published snapshot and the replaced
+ *                               ones that readers may still read
+ *
+ *  A reader pins the published snapshot, reads it without locks, and
+ *  unpins it. Pinning only writes the epoch the reader started in to a
+ *  slot of the calling thread, so the probes of different threads do
+ *  not share any written cache line. A refresh publishes a new snapshot
+ *  and ends the epoch. The one it replaces is retired and freed once
+ *  none of the readers that started in an earlier epoch still reads,
+ *  either by the refresh or by the last of those readers when it
+ *  unpins. Locks are taken only by refreshes and by those readers.
+ *
+ *  The slots are per thread: a pin is released by the thread that took
+ *  it, and never held across a coroutine park (the sm threads do not
+ *  run as coroutines).
+ *
+ */
+
+#ifndef __SHORE_SNAPSHOT_H
+#define __SHORE_SNAPSHOT_H
+
+#include "sm_vas.h"
+#include "util.h"
+
+#include <vector>
+#include <utility>
+
+using std::vector;
+
+
+ENTER_NAMESPACE(shore);
+
+
+/* the threads that may read snapshots at the same time */
+const uint_t SNAPSHOT_MAX_READERS = 1024;
+
+
+
+/* ---------------------------------------------------------------
+ *
+ * @class: snapshot_retirer_t
+ *
+ * @brief: A set of snapshots with retired ones, to be reclaimed when
+ *         their readers are gone
+ *
+ * --------------------------------------------------------------- */
+
+class snapshot_retirer_t
+{
+public:
+    virtual ~snapshot_retirer_t() { }
+
+    // frees the retired snapshots no reader can see, returns the
+    // latest epoch of the ones left, or 0
+    virtual uint_t reclaim()=0;
+};
+
+
+
+/* ---------------------------------------------------------------
+ *
+ * @class: snapshot_epoch_t
+ *
+ * @brief: The global epoch, the epoch each reading thread started in,
+ *         and the sets with retired snapshots. Nested read sections,
+ *         also on different sets, keep the epoch of the outermost.
+ *
+ * --------------------------------------------------------------- */
+
+class snapshot_epoch_t
+{
+public:
+
+    // enters a read section of the calling thread, before the
+    // published snapshot is read
+    static void enter();
+
+    // leaves it; the thread that leaves the last read section of an
+    // epoch in which a snapshot was retired reclaims it
+    static void leave();
+
+    // ends the current epoch, after a snapshot is replaced; returns it
+    static uint_t advance();
+
+    // the oldest epoch a thread still reads in, or the current one
+    static uint_t oldest();
+
+    // (pset) retired a snapshot in (epoch): registers it and reclaims
+    static void retired(snapshot_retirer_t* pset, const uint_t epoch);
+
+    // (pset) is destroyed
+    static void forget(snapshot_retirer_t* pset);
+
+}; // EOF: snapshot_epoch_t
+
+
+
+/* ---------------------------------------------------------------
+ *
+ * @class: snapshot_set_t
+ *
+ * @brief: The published snapshot and the retired ones
+ *
+ * --------------------------------------------------------------- */
+
+template <class S>
+class snapshot_set_t : public snapshot_retirer_t
+{
+private:
+
+    // a replaced snapshot and the epoch it was replaced in
+    typedef std::pair<S*,uint_t> retired_t;
+
+    S* volatile        _current;  // the published one, or NULL
+    mcs_lock           _lock;     // publish and reclaim
+    vector<retired_t>  _retired;
+
+    // not copyable
+    snapshot_set_t(const snapshot_set_t&);
+    snapshot_set_t& operator=(const snapshot_set_t&);
+
+public:
+
+    snapshot_set_t() : _current(NULL) { }
+
+    ~snapshot_set_t() {
+        // all the readers should be gone
+        snapshot_epoch_t::forget(this);
+        if (_current) delete (_current);
+        for (uint_t i=0; i<_retired.size(); i++) delete (_retired[i].first);
+    }
+
+    // the published snapshot, pinned, or NULL
+    S* pin() {
+        snapshot_epoch_t::enter();
+        S* psnap = _current;
+        if (!psnap) snapshot_epoch_t::leave();
+        return (psnap);
+    }
+
+    void unpin(S* psnap) {
+        assert (psnap);
+        snapshot_epoch_t::leave();
+    }
+
+    // Replaces the published snapshot. The previous one is freed now if
+    // no reader can see it, otherwise when its last reader unpins.
+    void publish(S* psnap) {
+        uint_t epoch = 0;
+        {
+            CRITICAL_SECTION(publish_cs, _lock);
+            S* pold = _current;
+            membar_producer(); // the snapshot is built before it is seen
+            _current = psnap;
+            if (pold) {
+                epoch = snapshot_epoch_t::advance();
+                _retired.push_back(retired_t(pold, epoch));
+            }
+        }
+        if (epoch) snapshot_epoch_t::retired(this, epoch);
+    }
+
+    uint_t reclaim() {
+        vector<S*> pfree;
+        uint_t last = 0;
+        {
+            CRITICAL_SECTION(reclaim_cs, _lock);
+            uint_t oldest = snapshot_epoch_t::oldest();
+            uint_t i = 0;
+            while (i < _retired.size()) {
+                if (_retired[i].second < oldest) {
+                    pfree.push_back(_retired[i].first);
+                    _retired[i] = _retired.back();
+                    _retired.pop_back();
+                }
+                else {
+                    if (_retired[i].second > last) last = _retired[i].second;
+                    i++;
+                }
+            }
+        }
+        for (uint_t i=0; i<pfree.size(); i++) delete (pfree[i]);
+        return (last);
+    }
+
+}; // EOF: snapshot_set_t
+
+
+EXIT_NAMESPACE(shore);
+
+#endif /* __SHORE_SNAPSHOT_H */
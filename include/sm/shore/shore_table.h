@@ -102,6 +102,11 @@
 #include "shore_field.h"
 #include "shore_index.h"
 #include "shore_row.h"
+#include "shore_row_layout.h"
+#include "shore_bulk_loader.h"
+#include "shore_table_cache.h"
+#include "shore_column_store.h"
+#include "shore_zone_map.h"
 
 
 ENTER_NAMESPACE(shore);
@@ -133,6 +138,11 @@ protected:
     index_desc_t*   _primary_idx;        // pointer to primary idx
   
     volatile uint_t _maxsize;            // max tuple size for this table, shortcut
+
+    guard<row_codec_t> _pcodec;          // generated format/load, if the table has a layout
+
+    volatile uint_t _version;            // bumped by every write to the table
+    volatile bool   _versioned;          // once results of the table are kept
     
     // Partitioning info (for MRBTrees)
     char*  _sMinKey;
@@ -241,6 +251,34 @@ public:
 
     uint_t maxsize(); /* maximum requirement for disk format */
 
+    /* offset of a fixed-size field in the disk format */
+    uint_t disk_offset(const uint_t descidx);
+
+    /* sets up the fields from a compile-time layout (see shore_row_layout.h),
+     * whose format/load are then used instead of the generic ones */
+    template <class Layout>
+    void setup_layout();
+
+    row_codec_t* codec() { return (_pcodec); }
+
+
+    /* --------------- */
+    /* --- version --- */
+    /* --------------- */
+
+    // Every insert, delete or update of the table bumps the version,
+    // so that results computed from it can tell they are stale. Until
+    // something asks for the counter (the QPipe result cache) nobody
+    // reads it, and the writes leave it alone.
+    void bump_version() { if (_versioned) atomic_inc_uint(&_version); }
+    volatile uint_t const* version_counter() {
+        if (!_versioned) {
+            _versioned = true;
+            membar_enter(); // the writers see the flag before we read the version
+        }
+        return (&_version);
+    }
+
     inline field_desc_t* desc(const uint_t descidx) {
         assert (descidx<_field_count);
         assert (_desc);
@@ -266,6 +304,18 @@ typedef std::list<table_desc_t*> table_list_t;
 
 
 
+/* A byte range of a record rewritten by update_tuple(). Ranges closer
+ * than UPDATE_RANGE_GAP bytes are merged, since each costs a log record. */
+struct update_range_t
+{
+    offset_t _start;
+    offset_t _len;
+};
+
+const int MAX_UPDATE_RANGES = 8;
+
+
+
 /* ---------------------------------------------------------------
  *
  * @class: table_man_t
@@ -282,6 +332,17 @@ protected:
 
     guard<ats_char_t> _pts;   /* trash stack */
 
+    guard<bulk_loader_t> _pbulk; /* index buffers, if in bulk-load mode */
+
+    guard<table_cache_t> _pcache; /* in-memory copy, for read-mostly tables */
+
+    guard<column_replica_t> _pcolumns; /* columnar copy, for DSS fact tables */
+
+    guard<zone_map_t> _pzones;  /* min/max per range of heap pages */
+
+    int _partial_updates;  /* stat counter: updates of the dirty ranges only */
+    int _full_updates;     /* stat counter: updates that rewrote the record */
+
 public:
 
     typedef table_row_t table_tuple; 
@@ -290,6 +351,13 @@ public:
 		bool construct_cache=true) 
         : _ptable(aTableDesc)
     {
+        // per-thread counts, the same table name gets the same counters
+        char name[MAX_FNAME_LEN+32];
+        snprintf(name, sizeof(name), "%s-partial-updates", _ptable->name());
+        _partial_updates = stat_counter(name);
+        snprintf(name, sizeof(name), "%s-full-updates", _ptable->name());
+        _full_updates = stat_counter(name);
+
 	// init tuple cache
         if (construct_cache) {
             // init trash stack            
@@ -317,6 +385,86 @@ public:
     ats_char_t* ts() { assert (_pts); return (_pts); }
 
 
+    /* ------------------------------ */
+    /* --- bulk index loading     --- */
+    /* ------------------------------ */
+
+    // While in bulk-load mode add_tuple() does not touch the indexes,
+    // it only collects their entries. Returns false if the table has
+    // indexes that cannot be bulk-loaded.
+    bool start_bulkload();
+    bool is_bulkloading() const { return (_pbulk.get() != NULL); }
+    bulk_loader_t* bulkloader() { return (_pbulk); }
+    void end_bulkload() { _pbulk.done(); }
+
+
+    /* ------------------------------ */
+    /* --- in-memory row cache    --- */
+    /* ------------------------------ */
+
+    // Non-EX index probes are answered from the cache while it is valid.
+    // Every insert, delete or update of the table invalidates it.
+    void enable_cache() { if (!_pcache) _pcache = new table_cache_t(this); }
+    table_cache_t* cache() { return (_pcache); }
+
+    // rebuilds the cache if it is enabled and not valid (needs no xct attached)
+    w_rc_t refresh_cache(ss_m* db) {
+        return (_pcache ? _pcache->refresh(db) : RCOK);
+    }
+
+    // (invalidates the columnar replica and the version as well)
+    inline void invalidate_cache() {
+        if (_pcache) _pcache->invalidate();
+        if (_pcolumns) _pcolumns->invalidate();
+        _ptable->bump_version();
+    }
+
+
+    /* ------------------------------ */
+    /* --- columnar replica       --- */
+    /* ------------------------------ */
+
+    // Scans that can use the replica read it while it is valid.
+    // Like the cache, any write to the table invalidates it.
+    void enable_columns() { if (!_pcolumns) _pcolumns = new column_replica_t(this); }
+    column_replica_t* columns() { return (_pcolumns); }
+
+    // rebuilds the replica if it is enabled and not valid (needs no xct attached)
+    w_rc_t refresh_columns(ss_m* db) {
+        return (_pcolumns ? _pcolumns->refresh(db) : RCOK);
+    }
+
+
+    /* ------------------------------ */
+    /* --- zone maps              --- */
+    /* ------------------------------ */
+
+    // The min and max of the given columns for every range_pages heap
+    // pages, so that scans with range predicates skip pages. Inserts and
+    // updates keep them up to date, deletes invalidate them. Not used
+    // with the PLP designs, whose inserts do not go through add_tuple().
+    void enable_zonemaps(const vector<uint_t>& cols, const uint_t range_pages) {
+        if (_pzones || !range_pages) return;
+        if (_ptable->get_pd() & (PD_MRBT_PART | PD_MRBT_LEAF)) return;
+        _pzones = new zone_map_t(this, cols, range_pages);
+    }
+    zone_map_t* zonemaps() { return (_pzones); }
+
+    // rebuilds the zone maps if they are enabled and not valid (needs no xct attached)
+    w_rc_t refresh_zonemaps(ss_m* db) {
+        return (_pzones ? _pzones->refresh(db) : RCOK);
+    }
+
+
+    /* ------------------------------ */
+    /* --- update statistics      --- */
+    /* ------------------------------ */
+
+    uint64_t partial_updates() const { return (stat_sum(_partial_updates)); }
+    uint64_t full_updates() const { return (stat_sum(_full_updates)); }
+    void print_update_stats() const;
+
+
     /* ---------------------------- */
     /* --- access through index --- */
     /* ---------------------------- */
@@ -392,6 +540,30 @@ public:
     }
 
 
+    // Probes the index for the keys set in count tuples, loading each of
+    // them. The probes are issued in key order: concurrent batches take
+    // their locks in the same order and do not deadlock on each other,
+    // and each descent finds the path of the previous one (often the
+    // same leaf) hot in the buffer pool. The tuples keep their positions.
+    w_rc_t index_probe_batch(ss_m* db,
+                             index_desc_t* pidx,
+                             table_tuple** ptuples,
+                             const uint_t count,
+                             const lock_mode_t lock_mode = SH,
+                             const lpid_t& root = lpid_t::null);
+
+    inline w_rc_t   index_probe_batch_by_name(ss_m* db,
+                                              const char* idx_name,
+                                              table_tuple** ptuples,
+                                              const uint_t count,
+                                              const lock_mode_t lock_mode = SH,
+                                              const lpid_t& root = lpid_t::null)
+    {
+	index_desc_t* pindex = _ptable->find_index(idx_name);
+	return (index_probe_batch(db, pindex, ptuples, count, lock_mode, root));
+    }
+
+
     /* -------------------------- */
     /* --- tuple manipulation --- */
     /* -------------------------- */
@@ -686,6 +858,64 @@ inline uint_t table_desc_t::maxsize()
 
 
 
+/****************************************************************** 
+ *
+ *  @fn:    disk_offset()
+ *
+ *  @brief: Return the offset of a fixed-size field in the disk format
+ *          of the rows, which is the bitmap of the null-able fields
+ *          followed by the fixed-size fields (see table_man_t::format()).
+ *          Lets the scan filters read fields straight off the records.
+ *
+ ******************************************************************/
+
+inline uint_t table_desc_t::disk_offset(const uint_t descidx)
+{
+    assert (descidx<_field_count);
+    assert (!_desc[descidx].is_variable_length());
+
+    uint_t offset = 0;
+    uint_t null_count = 0;
+    for (uint_t i=0; i<_field_count; i++) {
+        if (_desc[i].allow_null()) null_count++;
+        if ((i < descidx) && !_desc[i].is_variable_length())
+            offset += _desc[i].fieldmaxsize();
+    }
+    if (null_count) offset += ((null_count-1) >> 3) + 1;
+    return (offset);
+}
+
+
+/****************************************************************** 
+ *
+ *  @fn:    setup_layout
+ *
+ *  @brief: Sets up the field descriptors from the layout, and uses its
+ *          generated code for the conversions to the disk format.
+ *
+ *  @note:  The layout produces exactly the format of the generic code,
+ *          which for tables of fixed-size, non-null fields is the values
+ *          one after the other (and the +1 of maxsize for the bitmap).
+ *
+ ******************************************************************/
+
+template <class Layout>
+inline void table_desc_t::setup_layout()
+{
+    assert (Layout::FIELD_COUNT == _field_count);
+    Layout::setup_desc(_desc);
+#ifndef NDEBUG
+    for (uint_t i=0; i<_field_count; i++) {
+        assert (!_desc[i].allow_null());
+        assert (!_desc[i].is_variable_length());
+    }
+#endif
+    _pcodec = new row_layout_codec_t<Layout>();
+    assert (_pcodec->size() + 1 == maxsize());
+}
+
+
+
 
 
 
@@ -742,6 +972,30 @@ public:
 }; // EOF: table_fetcher_t
 
 
+
+/* ---------------------------------------------------------------
+ *
+ * @class: column_builder_t
+ *
+ * @brief: Thread to build the columnar replicas of the tables
+ *
+ * --------------------------------------------------------------- */
+
+class column_builder_t : public thread_t
+{
+private:
+    
+    ShoreEnv* _env;
+
+public:
+
+    column_builder_t(ShoreEnv* _env);
+    ~column_builder_t();
+    void work();
+    
+}; // EOF: column_builder_t
+
+
 EXIT_NAMESPACE(shore);
 
 #endif /* __SHORE_TABLE_H */
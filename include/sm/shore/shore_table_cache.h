@@ -0,0 +1,190 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   shore_table_cache.h
+ *
+ *  @brief:  In-memory copy of small, read-mostly tables
+ *
+ *  @note:   table_cache_t - the decoded rows of a table, and for each
+ *                           index the rows sorted by their key
+ *
+ *  A table with a cache answers the (non-EX) probes of its indexes from
+ *  memory, without touching the B+tree, the buffer pool, or the lock
+ *  manager. Any write to the table invalidates the cache, and probes go
+ *  back to the indexes until the cache is refreshed.
+ *
+ *  The rows are kept in immutable snapshots. A refresh builds a new
+ *  snapshot and publishes it, readers never wait for it. Each reader pins
+ *  the snapshot it copies from, and a replaced snapshot is freed when its
+ *  last reader unpins it.
+ *
+ *  @note:   The cached rows are read without locks. Probes that run
+ *           concurrently with the transaction that invalidates the cache
+ *           may see the old values, as if they were serialized before it.
+ *
+ */
+
+#ifndef __SHORE_TABLE_CACHE_H
+#define __SHORE_TABLE_CACHE_H
+
+#include "sm_vas.h"
+#include "util.h"
+
+#include "shore_index.h"
+#include "shore_row.h"
+#include "shore_bulk_loader.h"
+#include "shore_snapshot.h"
+
+#include <vector>
+
+using std::vector;
+
+
+ENTER_NAMESPACE(shore);
+
+
+class table_man_t;
+
+
+
+/* ---------------------------------------------------------------
+ *
+ * @class: table_cache_t
+ *
+ * @brief: Decoded copy of all the rows of a table, searchable by the
+ *         keys of each of its indexes
+ *
+ * --------------------------------------------------------------- */
+
+class table_cache_t
+{
+private:
+
+    // One cached index: the formatted keys of all the rows, sorted
+    struct index_entries_t {
+        index_desc_t*         _pindex;
+        uint_t                _ksz;
+        bulk_key_cmp_t        _cmp;
+        char*                 _keys;     // _ksz bytes per row
+        vector<uint_t>        _sorted;   // row of each key, in key order
+
+        index_entries_t() : _pindex(NULL), _ksz(0), _keys(NULL) { }
+        ~index_entries_t() { if (_keys) delete [] _keys; }
+
+        inline const char* key(const uint_t pos) const {
+            return (_keys + (_sorted[pos]*_ksz));
+        }
+
+        // first position with key >= (or > if bUpper) the given one
+        uint_t bound(const char* key, const bool bUpper) const;
+    };
+
+    struct snapshot_t {
+        vector<table_row_t*>     _rows;
+        vector<index_entries_t*> _indexes;
+        ~snapshot_t();
+    };
+
+    table_man_t*            _pmanager;
+    table_desc_t*           _ptable;
+
+    mutable snapshot_set_t<snapshot_t> _snapshots;
+    volatile bool           _valid;
+    volatile uint_t         _version;    // bumped by each invalidation
+
+    mcs_lock                _refresh_lock;
+
+    uint_t                  _refreshes;
+
+    w_rc_t _build(ss_m* db, snapshot_t* psnap);
+
+    // the current snapshot, pinned, or NULL if the cache is not valid
+    inline snapshot_t* _pin() const {
+        if (!_valid) return (NULL);
+        return (_snapshots.pin());
+    }
+
+    index_entries_t* _entries(snapshot_t* psnap, index_desc_t* pindex) const;
+
+public:
+
+    // Keeps the snapshot of the rows returned by range() until it is
+    // released or goes out of scope, by the thread that called range()
+    class pin_t
+    {
+    private:
+        const table_cache_t* _pcache;
+        snapshot_t*          _psnap;
+        friend class table_cache_t;
+
+        // not copyable
+        pin_t(const pin_t&);
+        pin_t& operator=(const pin_t&);
+
+    public:
+        pin_t() : _pcache(NULL), _psnap(NULL) { }
+        ~pin_t() { release(); }
+
+        void release() {
+            if (_psnap) _pcache->_snapshots.unpin(_psnap);
+            _psnap = NULL;
+        }
+    };
+
+    table_cache_t(table_man_t* pmanager);
+    ~table_cache_t();
+
+    // (Re)builds the snapshot, if the cache is not valid.
+    // It runs its own transaction, so the caller should not have one attached.
+    w_rc_t refresh(ss_m* db);
+
+    // Drops the current snapshot. Called on every write to the table.
+    void invalidate();
+
+    bool is_valid() const { return (_valid); }
+
+
+    // Looks up the row with the given (formatted) key and copies its values
+    // and rid to ptuple. Returns false if the cache is not valid, otherwise
+    // sets found.
+    bool probe(index_desc_t* pindex, const char* key,
+               table_row_t* ptuple, bool& found);
+
+    // Collects the rows with low <= key <= high, in key order. Returns false
+    // if the cache is not valid. The rows are read-only and are valid only 
+    // as long as the pin holds their snapshot.
+    bool range(index_desc_t* pindex, const char* low, const char* high,
+               vector<const table_row_t*>& rows, pin_t& pin);
+
+
+    // copies all the values (and the rid) of a row to another of the same table
+    static void copy_row(table_row_t* pdest, const table_row_t* psrc);
+
+    void print_stats() const;
+
+}; // EOF: table_cache_t
+
+
+EXIT_NAMESPACE(shore);
+
+#endif /* __SHORE_TABLE_CACHE_H */
@@ -149,6 +149,14 @@ public:
 				  table_iter* &iter,
                                   lock_mode_t alm = SH);
 
+    // Skips the heap pages that cannot hold rows satisfying all the
+    // predicates, if the table has valid zone maps. The caller should
+    // still check the predicates on every row returned.
+    w_rc_t get_iter_for_file_scan(ss_m* db,
+				  table_iter* &iter,
+                                  const vector<column_pred_t>& preds,
+                                  lock_mode_t alm = SH);
+
     w_rc_t get_iter_for_index_scan(ss_m* db,
 				   index_desc_t* pindex,
 				   index_iter* &iter,
@@ -222,6 +230,9 @@ public:
 private:
 
     table_manager* _pmanager;
+    int            _part;       /* the heap sub-file being scanned */
+
+    guard<zone_cursor_t> _pzone; /* if the scan skips pages by the zone maps */
 
 public:
 
@@ -233,13 +244,35 @@ public:
                          TableDesc* ptable,
                          table_manager* pmanager,
                          lock_mode_t alm) 
-        : table_iter(db, ptable, alm, true), _pmanager(pmanager)
+        : table_iter(db, ptable, alm, true), _pmanager(pmanager), _part(0)
+    { 
+        assert (_pmanager);
+        W_COERCE(open_scan(db));
+    }
+
+    table_scan_iter_impl(ss_m* db, 
+                         TableDesc* ptable,
+                         table_manager* pmanager,
+                         const vector<column_pred_t>& preds,
+                         lock_mode_t alm) 
+        : table_iter(db, ptable, alm, true), _pmanager(pmanager), _part(0)
     { 
         assert (_pmanager);
+        zone_map_t* pzones = _pmanager->zonemaps();
+        if (pzones && !preds.empty()) {
+            _pzone = new zone_cursor_t(pzones, preds, alm);
+            if (_pzone->opened()) {
+                table_iter::_opened = true;
+                return;
+            }
+            _pzone.done();
+        }
         W_COERCE(open_scan(db));
     }
         
     ~table_scan_iter_impl() { 
+        // the zone cursor owns its file scans
+        if (_pzone) table_iter::_opened = false;
         tuple_iter_t<TableDesc, scan_file_i, table_row_t >::close_scan(); 
     }
 
@@ -252,7 +285,7 @@ public:
         if (!table_iter::_opened) {
             assert (db);
             bool bIgnoreLatches = (table_iter::_file->get_pd() & (PD_MRBT_LEAF | PD_MRBT_PART) ? true : false);
-            table_iter::_scan = new scan_file_i(table_iter::_file->fid(), 
+            table_iter::_scan = new scan_file_i(table_iter::_file->heap_fid(_part), 
                                                 ss_m::t_cc_record, 
                                                 false, 
                                                 table_iter::_lm,
@@ -264,6 +297,7 @@ public:
 
 
     pin_i* cursor() {
+        if (_pzone) return (_pzone->cursor());
         pin_i *rval;
         bool eof;
         table_iter::_scan->cursor(rval, eof);
@@ -273,9 +307,23 @@ public:
 
     w_rc_t next(ss_m* db, bool& eof, table_tuple& tuple) {
         assert (_pmanager);
-        if (!table_iter::_opened) open_scan(db);
         pin_i* handle;
-        W_DO(table_iter::_scan->next(handle, 0, eof));
+        if (_pzone) {
+            W_DO(_pzone->next(handle, eof));
+        }
+        else {
+            if (!table_iter::_opened) open_scan(db);
+            W_DO(table_iter::_scan->next(handle, 0, eof));
+
+            // a partitioned heap continues with its next sub-file
+            while (eof && (_part+1 < table_iter::_file->heap_parts())) {
+                table_iter::close_scan();
+                _part++;
+                W_DO(open_scan(db));
+                W_DO(table_iter::_scan->next(handle, 0, eof));
+            }
+        }
+
         if (!eof) {
             if (!_pmanager->load(&tuple, handle->body()))
                 return RC(se_WRONG_DISK_DATA);
@@ -438,6 +486,19 @@ w_rc_t table_man_impl<TableDesc>::get_iter_for_file_scan(ss_m* db,
 }
 
 
+template <class TableDesc>
+w_rc_t table_man_impl<TableDesc>::get_iter_for_file_scan(ss_m* db,
+                                                         table_iter* &iter,
+                                                         const vector<column_pred_t>& preds,
+                                                         lock_mode_t alm)
+{
+    assert (_ptable);
+    iter = new table_scan_iter_impl<TableDesc>(db, _pspecifictable, this, preds, alm);
+    if (iter->opened()) return (RCOK);
+    return RC(se_OPEN_SCAN_ERROR);
+}
+
+
 template <class TableDesc>
 w_rc_t table_man_impl<TableDesc>::get_iter_for_index_scan(ss_m* db,
                                                           index_desc_t* index,
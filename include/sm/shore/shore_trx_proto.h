@@ -0,0 +1,79 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   shore_trx_proto.h
+ *
+ *  @brief:  The binary transaction-submission protocol of the trx
+ *           server ("serve" at the shell) and its load driver
+ *
+ *  @note:   Fixed-size frames in host byte order (the server is meant to
+ *           be driven over loopback). A client may pipeline any number of
+ *           requests on a connection. Responses carry the tag of their
+ *           request and may arrive out of order.
+ *
+ *           The request names the transaction type (the TRX_ID of the
+ *           kit, as listed by "trxs") and the selected id (warehouse,
+ *           subscriber, ...) the kit seeds its input generator with,
+ *           0 for a random one in the queried factor. The inputs are
+ *           generated at the server by the same code the kit clients
+ *           use. This file must not depend on Shore, the load driver
+ *           includes it too.
+ */
+
+#ifndef __SHORE_TRX_PROTO_H
+#define __SHORE_TRX_PROTO_H
+
+#include <stdint.h>
+
+
+// "SKTX", sent once by the client after it connects
+const uint32_t TRX_PROTO_MAGIC   = 0x534b5458;
+const uint32_t TRX_PROTO_VERSION = 1;
+
+// the states of the responses (the same values as shore::TrxState)
+const int32_t TRX_PROTO_COMMITTED  = 0x8;
+const int32_t TRX_PROTO_ROLLBACKED = 0x10;
+const int32_t TRX_PROTO_REJECTED   = 0x20; // unsupported trx type
+
+
+struct trx_proto_hello_t
+{
+    uint32_t _magic;
+    uint32_t _version;
+};
+
+struct trx_proto_req_t
+{
+    uint32_t _tag;      // chosen by the client, echoed in the response
+    int32_t  _xct_type;
+    int32_t  _sel_id;
+};
+
+struct trx_proto_resp_t
+{
+    uint32_t _tag;
+    int32_t  _state;
+};
+
+
+#endif /* __SHORE_TRX_PROTO_H */
@@ -0,0 +1,169 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   shore_trx_server.h
+ *
+ *  @brief:  Transaction server. Accepts many connections that speak the
+ *           binary protocol of shore_trx_proto.h, and feeds the requests
+ *           to the trx workers (or the DORA partitions) of the kit.
+ *
+ *  @note:   A single thread runs an epoll loop. Requests are submitted
+ *           through client stubs of the kit (base_client_t::submit_one,
+ *           the client thread is never forked), one stub per selected
+ *           id. The completions come back through the rings of the
+ *           stubs, and the responses are written back pipelined.
+ */
+
+#ifndef __SHORE_TRX_SERVER_H
+#define __SHORE_TRX_SERVER_H
+
+#include "sm/shore/shore_client.h"
+#include "sm/shore/shore_trx_proto.h"
+
+#include <vector>
+#include <map>
+
+
+ENTER_NAMESPACE(shore);
+
+
+// default port of the trx server
+const int DF_SRV_PORT          = 4040;
+
+// default maximum number of requests in flight at the server
+const int DF_SRV_MAX_INFLIGHT  = 4096;
+
+
+/******************************************************************** 
+ *
+ * @class: trx_server_t
+ *
+ * @brief: The epoll-based listener of the "serve" command
+ *
+ ********************************************************************/
+
+class trx_server_t : public thread_t
+{
+public:
+
+    typedef std::map<int,string> mapSupTrxs;
+
+private:
+
+    struct conn_t {
+        int          _fd;
+        bool         _hello;   // handshake received
+        bool         _closed;  // peer gone, wait for the in-flight
+        bool         _writing; // registered for EPOLLOUT
+        bool         _dirty;   // has responses to flush
+        bool         _stalled; // stopped parsing, at max in-flight
+        uint         _inflight;
+        std::vector<char> _rbuf;
+        uint         _roff;
+        std::vector<char> _wbuf;
+        uint         _woff;
+
+        conn_t(const int fd) 
+            : _fd(fd), _hello(false), _closed(false), _writing(false),
+              _dirty(false), _stalled(false),
+              _inflight(0), _roff(0), _woff(0) { }
+    };
+
+    struct slot_t {
+        conn_t*  _conn;
+        uint32_t _tag;
+    };
+
+    ShoreEnv*    _env;
+    int          _port;
+    int          _duration;
+    uint         _max_inflight;
+
+    // the stubs, by selected id (0=any), not owned
+    std::vector<base_client_t*> _stubs;
+    mapSupTrxs   _sup_trxs;
+
+    int          _listen_fd;
+    int          _epoll_fd;
+
+    // in-flight requests, the index is the xct id given to the stub
+    std::vector<slot_t> _slots;
+    std::vector<int>    _free_slots;
+    uint         _inflight;
+
+    std::vector<conn_t*> _conns;
+    std::vector<conn_t*> _dirty;
+    std::vector<conn_t*> _stalled;
+    bool         _reap;
+
+    // stats
+    long         _accepted;
+    long         _requests;
+    long         _committed;
+    long         _aborted;
+    long         _rejected;
+
+    int          _rv;
+
+public:
+
+    trx_server_t(c_str tname, ShoreEnv* env, 
+                 const int port, const int duration,
+                 const uint max_inflight,
+                 const std::vector<base_client_t*>& stubs,
+                 const mapSupTrxs& sup_trxs);
+    ~trx_server_t();
+
+    // thread entrance
+    void work();
+
+    inline int rv() const { return (_rv); }
+    inline long accepted() const { return (_accepted); }
+
+    void print_stats() const;
+
+private:
+
+    int  _open();
+    void _close();
+
+    void _accept();
+    void _read(conn_t* pconn);
+    void _parse(conn_t* pconn);
+    void _submit(conn_t* pconn, const trx_proto_req_t& req);
+    void _reply(conn_t* pconn, const uint32_t tag, const int32_t state);
+    void _flush(conn_t* pconn);
+    int  _drain();
+    void _drop(conn_t* pconn);
+    void _reap_closed();
+
+    // copying not allowed
+    trx_server_t(trx_server_t const &);
+    void operator=(trx_server_t const &);
+
+}; // EOF: trx_server_t
+
+
+EXIT_NAMESPACE(shore);
+
+#endif /* __SHORE_TRX_SERVER_H */
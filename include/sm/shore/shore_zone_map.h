@@ -0,0 +1,306 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   shore_zone_map.h
+ *
+ *  @brief:  Min/max synopses of ranges of heap pages, so that scans with
+ *           range predicates skip the pages that cannot qualify
+ *
+ *  @note:   zone_map_t    - for every range of N pages of the heap file
+ *                           of a table, the min and max of some columns
+ *           zone_cursor_t - scans only the pages of the ranges that may
+ *                           satisfy a set of predicates
+ *
+ *  The map is maintained by table_man_t: inserts and updates widen the
+ *  zones of the page they write, so that it is always a superset of the
+ *  values in the file. A delete invalidates it, since it may empty a
+ *  page or remove the record a scan of a range starts from. While the
+ *  map is not valid the scans read the whole file, until it is rebuilt
+ *  by refresh().
+ *
+ *  Pruning pays off only if the values of the column follow the load
+ *  order (e.g. dates of an append-mostly fact table). Otherwise every
+ *  range overlaps the predicates and the scan reads the whole file.
+ *
+ */
+
+#ifndef __SHORE_ZONE_MAP_H
+#define __SHORE_ZONE_MAP_H
+
+#include "sm_vas.h"
+#include "util.h"
+
+#include "shore_row.h"
+#include "shore_column_store.h"
+
+#include <vector>
+#include <string>
+#include <set>
+#include <map>
+
+using std::vector;
+using std::string;
+
+
+ENTER_NAMESPACE(shore);
+
+
+class table_man_t;
+
+
+
+/* ---------------------------------------------------------------
+ *
+ * @struct: zone_t
+ *
+ * @brief:  The min and max of one column in a range of pages. Integer
+ *          columns use the _i, float columns the _d, and string columns
+ *          the _s members. NULL values are not counted.
+ *
+ * --------------------------------------------------------------- */
+
+struct zone_t
+{
+    bool       _empty;      // no (non-NULL) values yet
+    long long  _imin;
+    long long  _imax;
+    double     _dmin;
+    double     _dmax;
+    string     _smin;
+    string     _smax;
+
+    zone_t() : _empty(true), _imin(0), _imax(0), _dmin(0), _dmax(0) { }
+
+}; // EOF: zone_t
+
+
+
+/* ---------------------------------------------------------------
+ *
+ * @struct: zone_range_t
+ *
+ * @brief:  A range of pages of one heap sub-file
+ *
+ * --------------------------------------------------------------- */
+
+struct zone_range_t
+{
+    int               _part;     // heap sub-file
+    shpid_t           _key;      // page number / pages per range
+    rid_t             _first;    // the smallest rid in the range
+    std::set<shpid_t> _pages;    // the pages with records
+    vector<zone_t>    _zones;    // one per column of the map
+
+    zone_range_t(const int part, const shpid_t key, const uint_t ncols)
+        : _part(part), _key(key), _first(rid_t::null), _zones(ncols) { }
+
+}; // EOF: zone_range_t
+
+
+
+/* ---------------------------------------------------------------
+ *
+ * @struct: zone_span_t
+ *
+ * @brief:  A copy of the position of a qualifying range, given to a
+ *          scan so that it does not hold the lock of the map
+ *
+ * --------------------------------------------------------------- */
+
+struct zone_span_t
+{
+    int               _part;
+    shpid_t           _key;
+    rid_t             _first;
+    vector<shpid_t>   _pages;
+
+}; // EOF: zone_span_t
+
+
+
+/* ---------------------------------------------------------------
+ *
+ * @class: zone_map_t
+ *
+ * @brief: The zones of the registered columns of a table
+ *
+ * --------------------------------------------------------------- */
+
+class zone_map_t
+{
+public:
+
+    typedef std::map<uint64_t, zone_range_t*> range_map;
+
+private:
+
+    table_man_t*            _pmanager;
+    table_desc_t*           _ptable;
+
+    vector<uint_t>          _cols;         // registered columns
+    vector<sqltype_t>       _types;
+    uint_t                  _range_pages;  // N
+
+    range_map               _ranges;
+    volatile bool           _valid;
+    volatile uint_t         _version;      // bumped by each invalidation
+
+    mcs_lock                _lock;         // of the ranges
+    mcs_lock                _refresh_lock;
+
+    uint_t                  _refreshes;
+    uint_t                  _scans;          // updated under _lock
+    uint_t                  _ranges_read;
+    uint_t                  _ranges_skipped;
+
+    int  _part_of(const rid_t& rid);
+    void _values(const table_row_t* prow, vector<zone_t>& vals) const;
+    void _add(range_map& ranges, const rid_t& rid, const int part,
+              const vector<zone_t>& vals);
+    bool _overlaps(const zone_range_t* pr,
+                   const vector<column_pred_t>& preds) const;
+    static void _clear(range_map& ranges);
+
+    w_rc_t _build(ss_m* db, range_map& ranges);
+
+public:
+
+    zone_map_t(table_man_t* pmanager, const vector<uint_t>& cols,
+               const uint_t range_pages);
+    ~zone_map_t();
+
+    // Marks the map valid and empty. Only for a table that has no
+    // records yet, i.e. before it is loaded.
+    void reset();
+
+    // Widens the zones of the range of the row, which should have been
+    // just written at its rid. Called by every insert and update.
+    void add(const table_row_t* prow);
+
+    // Called by every delete.
+    void invalidate();
+
+    // Rebuilds the map from the heap file, if it is not valid.
+    // It runs its own transaction, so the caller should not have one attached.
+    w_rc_t refresh(ss_m* db);
+
+    bool is_valid() const { return (_valid); }
+
+    uint_t range_pages() const { return (_range_pages); }
+
+    inline uint64_t key(const int part, const shpid_t page) const {
+        return (((uint64_t)part << 32) | (page / _range_pages));
+    }
+
+    // Copies the ranges that may hold rows satisfying all the
+    // predicates, in (sub-file, page) order. Predicates on columns that
+    // are not registered are ignored. Returns false if the map is not
+    // valid.
+    bool qualifying(const vector<column_pred_t>& preds,
+                    vector<zone_span_t>& spans);
+
+    table_man_t* manager() const { return (_pmanager); }
+    table_desc_t* table() const { return (_ptable); }
+
+    void print_stats();
+
+}; // EOF: zone_map_t
+
+
+
+/* ---------------------------------------------------------------
+ *
+ * @class: zone_cursor_t
+ *
+ * @brief: Heap scan that visits only the pages of the qualifying
+ *         ranges. For each range it positions a file scan at the
+ *         first record of the range, and keeps on scanning while the
+ *         pages belong to qualifying ranges. Pages are returned whole
+ *         and at most once. If the file order of the pages did not
+ *         let it reach some of them, a last pass over the sub-file
+ *         returns those.
+ *
+ *         zone_cursor_t zc(pzones, preds, SH);
+ *         if (zc.opened()) {
+ *             W_DO(zc.next(handle, eof));
+ *             while (!eof) {
+ *                 ...
+ *                 W_DO(zc.next(handle, eof));
+ *             }
+ *         }
+ *
+ * --------------------------------------------------------------- */
+
+class zone_cursor_t
+{
+private:
+
+    zone_map_t*                _pzones;
+    table_desc_t*              _ptable;
+    lock_mode_t                _lm;
+    bool                       _opened;
+
+    vector<zone_span_t>        _spans;
+    std::map<uint64_t,uint_t>  _span_of;    // range key -> span
+    vector< std::set<shpid_t> > _visited;   // returned pages, per span
+    uint_t                     _next_span;  // the next one to seek to
+
+    bool                       _fixup;      // in the last pass
+    vector<int>                _fixup_parts;
+    uint_t                     _next_fixup;
+
+    guard<scan_file_i>         _scan;
+    int                        _part;       // of the open scan
+    bool                       _seeked;     // no record read since the seek
+    bool                       _on_page;    // returning the records of _page
+    shpid_t                    _page;
+
+    uint_t                     _pages_read;
+    uint_t                     _seeks;
+
+    bool _missed(const uint_t span) const;
+    bool _open_next();
+
+public:
+
+    zone_cursor_t(zone_map_t* pzones, const vector<column_pred_t>& preds,
+                  const lock_mode_t lm);
+    ~zone_cursor_t() { }
+
+    // false if the map is not valid, then the whole file should be scanned
+    bool opened() const { return (_opened); }
+
+    w_rc_t next(pin_i*& handle, bool& eof);
+
+    pin_i* cursor();
+
+    uint_t ranges() const { return (_spans.size()); }
+    uint_t pages_read() const { return (_pages_read); }
+    uint_t seeks() const { return (_seeks); }
+
+}; // EOF: zone_cursor_t
+
+
+EXIT_NAMESPACE(shore);
+
+#endif /* __SHORE_ZONE_MAP_H */
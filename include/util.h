@@ -48,6 +48,7 @@
 #include "util/confparser.h"
 #include "util/envvar.h"
 #include "util/condex.h"
+#include "util/completion_queue.h"
 #include "util/stl_pooled_alloc.h"
 #include "util/stl_pool.h"
 #include "util/cache.h"
@@ -56,6 +57,10 @@
 #include "util/w_strlcpy.h"
 #include "util/procstat.h"
 #include "util/skewer.h"
+#include "util/topology.h"
+#include "util/fileclone.h"
+#include "util/perfctr.h"
+#include "util/stat_counter.h"
 
 #ifdef HAVE_CPUMON
 #ifdef HAVE_GLIBTOP
@@ -0,0 +1,149 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   btrace.h
+ *
+ *  @brief:  Binary tracing backend. When enabled, TRACE() does not
+ *           format anything. Each thread appends a fixed-size record
+ *           (TSC timestamp, call-site id, up to 4 integer arguments) to
+ *           its own ring buffer. The rings are written to a file with
+ *           btrace_dump() and decoded offline (btrace_decode) to text or
+ *           to the Chrome trace-event JSON format.
+ *
+ *  @note:   Each ring has a single writer (its thread) and no locks. The
+ *           only synchronization is when a thread creates its ring, and
+ *           when a call site is seen for the first time.
+ *
+ *  @note:   This header is also used by the offline decoder, so it should
+ *           not depend on anything else in the tree.
+ */
+
+#ifndef __UTIL_BTRACE_H
+#define __UTIL_BTRACE_H
+
+#include <stdint.h>
+#include <cstdarg>
+
+
+/* ---------------------------------------------------------------
+ *
+ * On-disk format of a dump:
+ *
+ *   btrace_file_hdr_t
+ *   _site_count times:   btrace_site_hdr_t, file, function, format
+ *   _thread_count times: btrace_thread_hdr_t, name, btrace_rec_t[_rec_count]
+ *
+ *  The strings follow their header without terminating '\0'.
+ *
+ * --------------------------------------------------------------- */
+
+const uint32_t BTRACE_MAGIC   = 0x4b545243; // "KTRC"
+const uint32_t BTRACE_VERSION = 1;
+const int      BTRACE_ARGS    = 4;
+
+// How an argument of a call site was passed (decided once per site
+// by looking at the format string)
+enum btrace_arg_t { BTA_NONE   = 0,
+                    BTA_INT    = 1,   // int, char, short
+                    BTA_LONG   = 2,   // long
+                    BTA_LLONG  = 3,   // long long
+                    BTA_DOUBLE = 4,   // float, double (stored as bits)
+                    BTA_PTR    = 5    // pointers, strings (address only)
+};
+
+struct btrace_rec_t
+{
+    uint64_t _tsc;
+    uint32_t _site;
+    uint32_t _type;                  // trace type of the call
+    int64_t  _arg[BTRACE_ARGS];
+};
+
+struct btrace_file_hdr_t
+{
+    uint32_t _magic;
+    uint32_t _version;
+    double   _tsc_per_usec;
+    uint64_t _tsc_start;             // tsc when the tracing was enabled
+    uint32_t _site_count;
+    uint32_t _thread_count;
+};
+
+struct btrace_site_hdr_t
+{
+    uint32_t _id;
+    uint32_t _line;
+    uint8_t  _arg_kind[BTRACE_ARGS];
+    uint16_t _file_len;
+    uint16_t _function_len;
+    uint16_t _format_len;
+    uint16_t _pad;
+};
+
+struct btrace_thread_hdr_t
+{
+    uint32_t _tid;
+    uint16_t _name_len;
+    uint16_t _pad;
+    uint64_t _rec_count;
+    uint64_t _lost;                  // records overwritten in the ring
+};
+
+
+
+/* ---------------------------------------------------------------
+ *
+ * Runtime interface (src/util/btrace.cpp)
+ *
+ * --------------------------------------------------------------- */
+
+#ifndef BTRACE_DECODER
+
+// Default number of records of each thread's ring (power of two)
+const uint32_t BTRACE_DEFAULT_RING_RECS = 1 << 16;
+
+// Switches TRACE() between the text and the binary backend. The ring
+// size applies to the rings created after the call.
+void btrace_enable(const uint32_t ring_recs = BTRACE_DEFAULT_RING_RECS);
+void btrace_disable();
+
+extern volatile bool _g_btrace_enabled;
+inline bool btrace_enabled() { return (_g_btrace_enabled); }
+
+// Appends a record for the TRACE() at (file,line). The arguments are
+// taken from ap as the format string says.
+void btrace_log(unsigned int type,
+                const char* file, int line, const char* function,
+                const char* format, va_list ap);
+
+// Writes all the rings to a file, returns 0 on success
+int btrace_dump(const char* path);
+
+// Drops all the recorded records (the rings stay allocated)
+void btrace_clear();
+
+void btrace_print_stats();
+
+#endif
+
+#endif /** __UTIL_BTRACE_H */
@@ -56,6 +56,7 @@ private:
     void disable(const char* type);
     void print_enabled_types();
     void print_known_types();
+    void binary(const char* cmd);
 
 }; // EOF: trace_cmd_t
 
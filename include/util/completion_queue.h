@@ -0,0 +1,168 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   completion_queue.h
+ *
+ *  @brief:  Per-client completion ring. The threads that finish a
+ *           request (workers, RVPs, flushers) push a completion record
+ *           into the ring of the client that submitted it. The client
+ *           polls the ring, and parks on a cond var only after an
+ *           (adaptive) spin found nothing.
+ *
+ *  @note:   Multiple producers, single consumer (the owning client).
+ *           The ring is a bounded array of slots with a sequence number
+ *           each. A producer claims a slot with a CAS on the tail, and
+ *           publishes it by bumping the slot's sequence number. The
+ *           producers take the lock only if the client is parked.
+ */
+
+#ifndef __UTIL_COMPLETION_QUEUE_H
+#define __UTIL_COMPLETION_QUEUE_H
+
+#include <pthread.h>
+
+#include "sm_vas.h"
+
+
+// default number of records the ring can hold
+const uint DF_CQ_CAPACITY = 64;
+
+// bounds of the adaptive spin (in polls of the ring)
+const uint CQ_MIN_SPIN = 64;
+const uint CQ_MAX_SPIN = 65536;
+
+
+/******************************************************************** 
+ *
+ * @struct: completion_t
+ *
+ * @brief:  The record pushed to the client about a finished request
+ *
+ ********************************************************************/
+
+struct completion_t
+{
+    int _xct_id; // the id the client gave to the request
+    int _state;  // COMMITTED or ROLLBACKED
+
+    completion_t() : _xct_id(-1), _state(0) { }
+
+}; // EOF: completion_t
+
+
+
+/******************************************************************** 
+ *
+ * @class: completion_queue_t
+ *
+ * @brief: Lock-free completion ring, owned by one client
+ *
+ * @note:  Besides the ring, it keeps the batch bookkeeping that the
+ *         client used to do with a condex_pair: the client asks for
+ *         a notification on the last request of each batch
+ *         (please_take_one), the submitter attaches the queue to that
+ *         request (take_one), and the client waits for one record per
+ *         batch (wait).
+ *
+ ********************************************************************/
+
+class completion_queue_t
+{
+private:
+
+    struct slot_t {
+        uint64_t volatile _seq;
+        completion_t      _rec;
+    };
+
+    slot_t*            _slots;
+    uint64_t           _mask;
+
+    // producers claim at the tail, the owner consumes from the head
+    uint64_t volatile  _tail;
+    uint64_t           _head;
+
+    // parking
+    pthread_mutex_t    _lock;
+    pthread_cond_t     _cond;
+    int volatile       _parked;
+
+    // polls to try before parking
+    uint               _spin;
+
+    // batch bookkeeping (accessed only by the owner)
+    long               _requested;
+    long               _wanted;
+    long               _waited;
+
+    // stats
+    long               _spin_hits;
+    long               _parks;
+
+public:
+
+    completion_queue_t(const uint capacity = DF_CQ_CAPACITY);
+    ~completion_queue_t();
+
+    // --- producers --- //
+    void push(const int xct_id, const int state);
+
+    // --- owner --- //
+    bool try_pop(completion_t& rec);
+    void pop(completion_t& rec);
+
+    void please_take_one() { 
+        ++_wanted; 
+    }
+    completion_queue_t* take_one() {
+        if (_wanted > _requested) {
+            ++_requested;
+            return (this);
+        }
+        return (NULL);
+    }
+    completion_t wait() {
+        w_assert1(_waited < _requested);
+        ++_waited;
+        completion_t rec;
+        pop(rec);
+        return (rec);
+    }
+
+    // number of notifications asked for and not waited yet
+    long in_flight() const { return (_requested - _waited); }
+
+    uint capacity() const { return (_mask + 1); }
+    long spin_hits() const { return (_spin_hits); }
+    long parks() const { return (_parks); }
+
+private:
+
+    // copying not allowed
+    completion_queue_t(completion_queue_t const &);
+    void operator=(completion_queue_t const &);
+
+}; // EOF: completion_queue_t
+
+
+#endif /** __UTIL_COMPLETION_QUEUE_H */
@@ -0,0 +1,66 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   fileclone.h
+ *
+ *  @brief:  Fast copies of (large) files, used for snapshotting the
+ *           database device and the log
+ *
+ *  @note:   If the filesystem supports it (btrfs, xfs) the file is
+ *           reflinked, which shares the extents copy-on-write and takes
+ *           no time. Otherwise the allocated regions of the file are
+ *           copied by a few threads in parallel, skipping the holes,
+ *           so the copy stays sparse.
+ */
+
+#ifndef __UTIL_FILECLONE_H
+#define __UTIL_FILECLONE_H
+
+#include <sys/types.h>
+#include <cstddef>
+
+
+enum fclone_method_t { FCLONE_REFLINK = 0,
+                       FCLONE_SPARSE_COPY = 1
+};
+
+
+// Copies src to dst (created, or truncated if it exists) using up to
+// threads copying threads. Returns 0 on success, an errno otherwise.
+// If not NULL, pmethod is set to how the file was copied and pbytes to
+// the number of bytes actually copied.
+int fclone_file(const char* src, const char* dst, const int threads,
+                fclone_method_t* pmethod = NULL, off_t* pbytes = NULL);
+
+// Clones all the regular files of srcdir into dstdir, which is created
+// if needed. Returns 0 on success, an errno otherwise.
+int fclone_dir(const char* srcdir, const char* dstdir, const int threads);
+
+// Removes all the regular files of a directory
+int fclean_dir(const char* dir);
+
+// Creates a directory (and its parents) if it does not exist
+int fmake_dir(const char* dir);
+
+
+#endif /** __UTIL_FILECLONE_H */
@@ -0,0 +1,143 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   perfctr.h
+ *
+ *  @brief:  Hardware performance counters per code region. Each thread
+ *           opens one group of counters (perf_event_open) the first 
+ *           time it enters a region, and reads the group when it enters
+ *           and leaves it. The differences are added to the region's 
+ *           slot in the thread's own table, so there are no shared 
+ *           writes. perfctr_print() sums the tables of all the threads.
+ *
+ *  @note:   A region is a name (e.g., a transaction type, or "probe"),
+ *           registered once per call site. The regions nest, so those
+ *           inside a transaction are also counted in the transaction.
+ *
+ *  @note:   Compiled in with --enable-perfctrs (CFG_PERFCTRS). Without 
+ *           it PERFCTR_REGION() is empty and the counters are not 
+ *           opened, but the regions are still registered.
+ */
+
+#ifndef __UTIL_PERFCTR_H
+#define __UTIL_PERFCTR_H
+
+#include "kits-config.h"
+
+#include <stdint.h>
+
+
+// The events of a group. The LLC references are (mostly) the L2 misses.
+enum perfctr_event_t { PCE_CYCLES       = 0,
+                       PCE_INSTRUCTIONS = 1,
+                       PCE_LLC_REFS     = 2,
+                       PCE_LLC_MISSES   = 3,
+                       PCE_BR_MISSES    = 4,
+                       PCE_EVENTS       = 5
+};
+
+const int PERFCTR_MAX_REGIONS = 64;
+const int PERFCTR_NO_REGION   = -1;
+
+
+struct perfctr_values_t 
+{
+    uint64_t _v[PCE_EVENTS];
+
+    // nsecs the group was enabled and counting, from its opening
+    uint64_t _enabled;
+    uint64_t _running;
+
+    perfctr_values_t() { reset(); }
+    void reset() { 
+        for (int i=0; i<PCE_EVENTS; i++) _v[i] = 0; 
+        _enabled = _running = 0;
+    }
+
+    perfctr_values_t& operator+=(const perfctr_values_t& rhs) {
+        for (int i=0; i<PCE_EVENTS; i++) _v[i] += rhs._v[i];
+        return (*this);
+    }
+
+}; // EOF: perfctr_values_t
+
+
+// Returns the id of a region, registering it the first time. Returns
+// PERFCTR_NO_REGION if there are already too many.
+int perfctr_region(const char* name);
+
+// Reads the counters of the calling thread, opening them if needed.
+// Returns false if they are not available.
+bool perfctr_read(perfctr_values_t& vals);
+
+// Adds a reading of a region to the calling thread's table
+void perfctr_add(const int region, const perfctr_values_t& from, 
+                 const perfctr_values_t& to);
+
+// Prints the sums per region, and zeroes them
+void perfctr_print();
+void perfctr_reset();
+
+
+/******************************************************************** 
+ *
+ * @class: perfctr_scope_t
+ *
+ * @brief: Counts the events from its construction to its destruction
+ *         to a region
+ *
+ ********************************************************************/
+
+class perfctr_scope_t
+{
+private:
+    int              _region;
+    bool             _ok;
+    perfctr_values_t _from;
+
+public:
+    perfctr_scope_t(const int region) 
+        : _region(region), _ok(false)
+    {
+        if (_region != PERFCTR_NO_REGION) _ok = perfctr_read(_from);
+    }
+
+    ~perfctr_scope_t() {
+        if (!_ok) return;
+        perfctr_values_t to;
+        if (perfctr_read(to)) perfctr_add(_region, _from, to);
+    }
+
+}; // EOF: perfctr_scope_t
+
+
+#ifdef CFG_PERFCTRS
+#define PERFCTR_REGION(var,name)                                        \
+    static const int var##_region = perfctr_region(name);               \
+    perfctr_scope_t var(var##_region)
+#else
+#define PERFCTR_REGION(var,name)
+#endif
+
+
+#endif /** __UTIL_PERFCTR_H */
@@ -55,6 +55,9 @@ enum skew_type_t {
 
 using namespace std;
 
+// at most two hot spots, each split in two if it wraps around
+const int SKEW_MAX_INTERVALS = 4;
+
 /*********************************************************************
  * 
  * @class skewer_t
@@ -77,16 +80,34 @@ private:
     // the boundaries of the whole area
     int _lower;
     int _upper;
-    
-    // the boundaries of the area that the load will be applied to
-    // this area doesn't have to be continuous 
-    vector<int> _interval_l;
-    vector<int> _interval_u;
-
-    // the boundaries of the area that the remaining load will be applied to
-    // this area doesn't have to be continuous 
-    vector<int> _non_interval_l;
-    vector<int> _non_interval_u;
+
+    // the intervals the inputs are drawn from, in fixed arrays so that
+    // an input creator never reads freed memory, see _publish()
+    struct spots_t {
+        // the % of the load that goes to the intervals
+        int _load;
+
+        // the boundaries of the area that the load will be applied to
+        // this area doesn't have to be continuous 
+        int _intervals;
+        int _interval_l[SKEW_MAX_INTERVALS];
+        int _interval_u[SKEW_MAX_INTERVALS];
+
+        // the boundaries of the area that the remaining load will be applied to
+        // this area doesn't have to be continuous 
+        int _non_intervals;
+        int _non_interval_l[SKEW_MAX_INTERVALS+1];
+        int _non_interval_u[SKEW_MAX_INTERVALS+1];
+
+        void clear();
+        void insert_interval(int at, int lower, int upper);
+        void add_non_interval(int lower, int upper);
+    };
+
+    // the input creators read the active spots while the new ones
+    // are being built in the other, see _publish()
+    spots_t _spots[2];
+    int volatile _active;
     
     // indicates whether the set intervals was used once
     bool _is_used;
@@ -94,11 +115,24 @@ private:
 public:
 
     // empty constructor, things should be set later
-    skewer_t() { _is_used = false; }
+    skewer_t() : _area(0), _load(0), _lower(0), _upper(0), 
+                 _active(0), _is_used(false) { 
+        _spots[0].clear();
+        _spots[1].clear();
+    }
 
     // initialization
     void set(int area, int lower, int upper, int load);
 
+    // places the hot spot at a given spot, instead of a random one:
+    // (load)% of the inputs fall in the (count) values starting at
+    // (first), wrapping around at the upper boundary
+    void place(int lower, int upper, int first, int count, int load);
+
+    // same, with the start (pos) and the size (area) of the hot spot
+    // in % of the whole area, an area of 0 is a single value
+    void place_pct(int lower, int upper, double pos, double area, int load);
+
     // cleans the intervals
     void clear();
 
@@ -119,6 +153,11 @@ private:
     void _set_intervals();
     
     void _add_interval(int interval_lower, int interval_upper);
+
+    void _set_non_intervals();
+
+    spots_t& _standby() { return (_spots[1 - _active]); }
+    void _publish();
     
 };
 
@@ -0,0 +1,62 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   stat_counter.h
+ *
+ *  @brief:  Statistics counters that are updated on hot paths. Each 
+ *           thread adds to its own table, so an update is a plain 
+ *           addition with no shared writes. stat_sum() adds up the 
+ *           tables of all the threads.
+ *
+ *  @note:   A counter is a name (e.g., "customer-full-updates"),
+ *           registered once. The same name gets the same counter.
+ *
+ *  @note:   The sums are read while the threads update their tables, so
+ *           they are a (very recent) snapshot, and a stat_reset() that 
+ *           races with an update may lose that update.
+ */
+
+#ifndef __UTIL_STAT_COUNTER_H
+#define __UTIL_STAT_COUNTER_H
+
+#include <stdint.h>
+
+
+const int STAT_MAX_COUNTERS = 256;
+const int STAT_NO_COUNTER   = -1;
+
+
+// Returns the id of a counter, registering it the first time. Returns
+// STAT_NO_COUNTER if there are already too many.
+int stat_counter(const char* name);
+
+// Adds to the calling thread's count of a counter
+void stat_add(const int counter, const uint64_t value);
+inline void stat_inc(const int counter) { stat_add(counter, 1); }
+
+// The sum of the counts of all the threads, and its zeroing
+uint64_t stat_sum(const int counter);
+void stat_reset(const int counter);
+
+
+#endif /** __UTIL_STAT_COUNTER_H */
@@ -56,6 +56,23 @@ DEFINE_EXCEPTION(ThreadException);
     TRACE( TRACE_CPU_BINDING, "Binded to processor (%d)\n", cpu);       \
     boundflag = true; }
 
+#elif defined(__linux__)
+
+#include <sched.h>
+
+// Macro that tries to bind a thread to a specific CPU (Linux affinity)
+#define TRY_TO_BIND(cpu,boundflag)                                      \
+    if ((cpu) != PBIND_NONE) {                                          \
+        cpu_set_t bind_set;                                             \
+        CPU_ZERO(&bind_set);                                            \
+        CPU_SET((cpu), &bind_set);                                      \
+        if (sched_setaffinity(0, sizeof(bind_set), &bind_set)) {        \
+            TRACE( TRACE_CPU_BINDING, "Cannot bind to processor (%d)\n", cpu); \
+            boundflag = false; }                                        \
+        else {                                                          \
+            TRACE( TRACE_CPU_BINDING, "Binded to processor (%d)\n", cpu); \
+            boundflag = true; } }
+
 #else
 
 // No-op
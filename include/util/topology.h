@@ -0,0 +1,198 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   topology.h
+ *
+ *  @brief:  Machine topology (sockets, cores, SMT siblings, NUMA nodes)
+ *           as exported by Linux in sysfs, and a placement helper that
+ *           hands out cpus of a node
+ *
+ *  @note:   On systems without sysfs (or if it cannot be parsed) the
+ *           topology degrades to a single node with all the online cpus
+ */
+
+#ifndef __UTIL_TOPOLOGY_H
+#define __UTIL_TOPOLOGY_H
+
+#include "k_defines.h"
+
+#include <vector>
+#include <map>
+#include <string>
+
+#include <pthread.h>
+
+using std::vector;
+using std::map;
+using std::string;
+
+
+/*********************************************************************
+ *
+ *  @struct: cpu_desc_t
+ *
+ *  @brief:  Where a single (logical) cpu sits in the machine
+ *
+ *********************************************************************/
+
+struct cpu_desc_t
+{
+    processorid_t _id;
+    int _node;      // NUMA node
+    int _socket;    // physical package
+    int _core;      // core id inside the package
+    int _llc;       // id of the last-level cache (first cpu sharing it)
+    int _smt;       // index among the SMT siblings of the core (0 = first)
+
+    cpu_desc_t()
+        : _id(PBIND_NONE), _node(0), _socket(0), _core(0), _llc(0), _smt(0)
+    { }
+
+}; // EOF: cpu_desc_t
+
+
+
+/*********************************************************************
+ *
+ *  @class: cpu_topology_t
+ *
+ *  @brief: Reads /sys/devices/system/{cpu,node} once and answers
+ *          questions about which cpus are close to each other
+ *
+ *  @note:  Singleton. The cpus of each node are ordered so that the
+ *          first thread of every physical core comes before any SMT
+ *          sibling. That way filling a node in order spreads work to
+ *          distinct cores first.
+ *
+ *********************************************************************/
+
+class cpu_topology_t
+{
+private:
+
+    vector<cpu_desc_t>               _cpus;      // indexed by cpu id
+    vector< vector<processorid_t> >  _node_cpus; // per node, cores first
+    int                              _sockets;
+    bool                             _from_sysfs;
+
+    cpu_topology_t();
+    ~cpu_topology_t() { }
+
+    void _load();
+    void _load_flat(const int cpus);
+    void _order_nodes();
+
+public:
+
+    static cpu_topology_t* instance() {
+        static cpu_topology_t _instance; return (&_instance);
+    }
+
+    int cpu_count() const { return (_cpus.size()); }
+    int node_count() const { return (_node_cpus.size()); }
+    int socket_count() const { return (_sockets); }
+    bool from_sysfs() const { return (_from_sysfs); }
+
+    const cpu_desc_t& cpu(const processorid_t acpu) const;
+    int node_of(const processorid_t acpu) const;
+    const vector<processorid_t>& node_cpus(const int anode) const;
+
+    // The node responsible for slot apos out of atotal equal slots of a
+    // key space. Partitions covering the same fraction of the key space
+    // land on the same node, regardless of how many partitions each
+    // table has.
+    int node_for_range(const uint apos, const uint atotal) const;
+
+    // Whether two cpus share a core, or the last-level cache
+    bool are_siblings(const processorid_t a, const processorid_t b) const;
+    bool share_llc(const processorid_t a, const processorid_t b) const;
+
+    void print() const;
+
+    // Parses a sysfs cpu-list ("0-3,8,10-11")
+    static void parse_cpulist(const string& alist, vector<int>& out);
+
+}; // EOF: cpu_topology_t
+
+
+
+/*********************************************************************
+ *
+ *  @class: cpu_placement_t
+ *
+ *  @brief: Hands out cpus node by node and remembers which thread
+ *          ("owner") was placed where, so that the map can be printed
+ *
+ *  @note:  Only cpus with id smaller than the active cpu limit are
+ *          used. If a node has no usable cpus the request falls to the
+ *          next node that has.
+ *
+ *********************************************************************/
+
+class cpu_placement_t
+{
+public:
+
+    typedef map<string,processorid_t>  PlacementMap;
+    typedef PlacementMap::const_iterator PlacementMapCIt;
+
+private:
+
+    string                         _name;
+    int                            _max_cpus;
+    vector< vector<processorid_t> > _usable;  // per node
+    vector<uint>                   _cursor;   // per node, round-robin
+    PlacementMap                   _map;
+    pthread_mutex_t                _lock;
+
+    int _usable_node(const int anode) const;
+    void _record(const string& aowner, const processorid_t acpu);
+
+public:
+
+    cpu_placement_t(const char* aname, const int max_cpus);
+    ~cpu_placement_t();
+
+    // forgets the cursors and the recorded map
+    void reset();
+
+    // Next cpu of the node (cores before SMT siblings, round-robin)
+    processorid_t next(const int anode, const string& aowner);
+
+    // Next cpu of the node responsible for slot apos/atotal of a key space
+    processorid_t next_for_range(const uint apos, const uint atotal,
+                                 const string& aowner);
+
+    // The n-th cpu counting from the end of the node list. Used for
+    // helper threads (flushers, notifiers) that should sit close to the
+    // workers they serve without taking their primary cores.
+    processorid_t tail(const int anode, const uint nth, const string& aowner);
+
+    int node_count() const { return (_usable.size()); }
+
+    void print() const;
+
+}; // EOF: cpu_placement_t
+
+
+#endif /** __UTIL_TOPOLOGY_H */
@@ -0,0 +1,123 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   ch_const.h
+ *
+ *  @brief:  Constants needed by the CH-benCHmark kit
+ *
+ *  @note:   CH-benCHmark runs the TPC-C transactions together with 22
+ *           analytical queries, adapted from TPC-H, over the TPC-C
+ *           schema. The three extra tables of the benchmark (SUPPLIER,
+ *           NATION, REGION) are tiny and read-only, so they are not
+ *           stored; their rows are generated on the fly (see ch_input.cpp).
+ */
+
+#ifndef __CH_CONST_H
+#define __CH_CONST_H
+
+
+#include "util/namespace.h"
+
+
+ENTER_NAMESPACE(ch);
+
+
+// --- the generated dimensions --- //
+
+const int CH_SUPPLIERS = 10000;
+const int CH_NATIONS   = 62;
+const int CH_REGIONS   = 5;
+
+const int CH_QUERIES   = 22;
+
+
+
+/* ---------------------------------- */
+/* --- CH-benCHmark TRANSACTIONS  --- */
+/* ---------------------------------- */
+
+// The TPC-C transactions keep their ids (see tpcc_const.h)
+
+// Each client is either a TPC-C or an analytical one (see ch-olap-ratio)
+const int XCT_CH_HTAP      = 100;
+
+// Every client runs the analytical queries, in sequence
+const int XCT_CH_QUERY_MIX = 101;
+
+const int XCT_CH_Q1        = 102;
+const int XCT_CH_Q2        = 103;
+const int XCT_CH_Q3        = 104;
+const int XCT_CH_Q4        = 105;
+const int XCT_CH_Q5        = 106;
+const int XCT_CH_Q6        = 107;
+const int XCT_CH_Q7        = 108;
+const int XCT_CH_Q8        = 109;
+const int XCT_CH_Q9        = 110;
+const int XCT_CH_Q10       = 111;
+const int XCT_CH_Q11       = 112;
+const int XCT_CH_Q12       = 113;
+const int XCT_CH_Q13       = 114;
+const int XCT_CH_Q14       = 115;
+const int XCT_CH_Q15       = 116;
+const int XCT_CH_Q16       = 117;
+const int XCT_CH_Q17       = 118;
+const int XCT_CH_Q18       = 119;
+const int XCT_CH_Q19       = 120;
+const int XCT_CH_Q20       = 121;
+const int XCT_CH_Q21       = 122;
+const int XCT_CH_Q22       = 123;
+
+
+inline bool is_ch_query(const int xct_type) {
+    return ((xct_type >= XCT_CH_Q1) && (xct_type <= XCT_CH_Q22));
+}
+
+
+// --- the generated SUPPLIER, NATION and REGION --- //
+
+// The nation keys are the ascii codes of [0-9A-Za-z]. A customer belongs
+// to the nation of the first letter of its C_STATE.
+int         ch_nation_key(const int nation);
+int         ch_nation_of_key(const int nationkey);
+const char* ch_nation_name(const int nation);
+int         ch_nation_region(const int nation);
+const char* ch_region_name(const int region);
+
+// The supplier of a STOCK row is mod(s_w_id * s_i_id, 10000)
+inline int  ch_supplier_of(const int s_w_id, const int s_i_id) {
+    return ((s_w_id * s_i_id) % CH_SUPPLIERS);
+}
+int         ch_supplier_nation(const int suppkey);
+bool        ch_supplier_is_bad(const int suppkey);
+
+// The nation of a customer (-1 if the state does not map to any)
+int         ch_customer_nation(const char* c_state);
+
+// Looks up a nation or region by name (-1 if not found)
+int         ch_find_nation(const char* name);
+int         ch_find_region(const char* name);
+
+
+EXIT_NAMESPACE(ch);
+
+#endif /* __CH_CONST_H */
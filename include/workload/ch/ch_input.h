@@ -0,0 +1,97 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   ch_input.h
+ *
+ *  @brief:  Declaration of the (common) input of the CH-benCHmark
+ *           analytical queries
+ *
+ *  @note:   The CH queries have no substitution parameters, all of them
+ *           use the same few constants (dates, quantity bounds). They
+ *           share one input struct.
+ */
+
+#ifndef __CH_INPUT_H
+#define __CH_INPUT_H
+
+#include "util.h"
+#include "workload/ch/ch_const.h"
+
+
+ENTER_NAMESPACE(ch);
+
+
+struct ch_query_input_t
+{
+    int    _wh_cnt;     /* number of queried warehouses */
+
+    time_t _d1999;      /* 1999-01-01 */
+    time_t _d2007;      /* 2007-01-02 */
+    time_t _d2010;      /* 2010-05-23 12:00:00 */
+    time_t _d2012;      /* 2012-01-02 */
+    time_t _d2020;      /* 2020-01-01 */
+
+    int    _min_qty;    /* 1 */
+    int    _max_qty;    /* 100000 */
+
+    ch_query_input_t& operator=(const ch_query_input_t& rhs);
+};
+
+ch_query_input_t create_ch_query_input(const double sf,
+                                       const int specificWH = 0);
+
+
+// Every query gets the common input, under the name DECLARE_TRX expects
+#define DECLARE_CH_QUERY_INPUT(q)                                       \
+    typedef ch_query_input_t ch_##q##_input_t;                          \
+    inline ch_query_input_t create_ch_##q##_input(const double sf,      \
+                                                  const int specificWH = 0) { \
+        return (create_ch_query_input(sf, specificWH)); }
+
+DECLARE_CH_QUERY_INPUT(q1);
+DECLARE_CH_QUERY_INPUT(q2);
+DECLARE_CH_QUERY_INPUT(q3);
+DECLARE_CH_QUERY_INPUT(q4);
+DECLARE_CH_QUERY_INPUT(q5);
+DECLARE_CH_QUERY_INPUT(q6);
+DECLARE_CH_QUERY_INPUT(q7);
+DECLARE_CH_QUERY_INPUT(q8);
+DECLARE_CH_QUERY_INPUT(q9);
+DECLARE_CH_QUERY_INPUT(q10);
+DECLARE_CH_QUERY_INPUT(q11);
+DECLARE_CH_QUERY_INPUT(q12);
+DECLARE_CH_QUERY_INPUT(q13);
+DECLARE_CH_QUERY_INPUT(q14);
+DECLARE_CH_QUERY_INPUT(q15);
+DECLARE_CH_QUERY_INPUT(q16);
+DECLARE_CH_QUERY_INPUT(q17);
+DECLARE_CH_QUERY_INPUT(q18);
+DECLARE_CH_QUERY_INPUT(q19);
+DECLARE_CH_QUERY_INPUT(q20);
+DECLARE_CH_QUERY_INPUT(q21);
+DECLARE_CH_QUERY_INPUT(q22);
+
+
+EXIT_NAMESPACE(ch);
+
+#endif /* __CH_INPUT_H */
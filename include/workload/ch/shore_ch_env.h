@@ -0,0 +1,274 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   shore_ch_env.h
+ *
+ *  @brief:  Definition of the Shore CH-benCHmark environment
+ *
+ *  @note:   The CH environment is the TPC-C one (same tables, loader and
+ *           transactions) plus the 22 analytical queries. The queries run
+ *           on their own pool of workers (ch-olap-workers), so that the
+ *           TPC-C workers (db-workers) are never stuck behind a long scan,
+ *           and the two sides contend only in the storage manager: locks,
+ *           latches, and the buffer pool.
+ */
+
+#ifndef __SHORE_CH_ENV_H
+#define __SHORE_CH_ENV_H
+
+
+#include "workload/tpcc/shore_tpcc_env.h"
+
+#include "workload/ch/ch_const.h"
+#include "workload/ch/ch_input.h"
+
+#include <map>
+
+using std::map;
+using namespace shore;
+using namespace tpcc;
+
+
+ENTER_NAMESPACE(ch);
+
+
+
+/****************************************************************** 
+ *
+ *  @struct: ShoreCHEnv Stats
+ *
+ *  @brief:  The analytical queries statistics. The TPC-C transactions
+ *           are counted by the TPC-C environment.
+ *
+ ******************************************************************/
+
+struct ShoreCHTrxCount 
+{
+    uint ch_q1;
+    uint ch_q2;
+    uint ch_q3;
+    uint ch_q4;
+    uint ch_q5;
+    uint ch_q6;
+    uint ch_q7;
+    uint ch_q8;
+    uint ch_q9;
+    uint ch_q10;
+    uint ch_q11;
+    uint ch_q12;
+    uint ch_q13;
+    uint ch_q14;
+    uint ch_q15;
+    uint ch_q16;
+    uint ch_q17;
+    uint ch_q18;
+    uint ch_q19;
+    uint ch_q20;
+    uint ch_q21;
+    uint ch_q22;
+
+    ShoreCHTrxCount& operator+=(ShoreCHTrxCount const& rhs) {
+        ch_q1  += rhs.ch_q1;
+        ch_q2  += rhs.ch_q2;
+        ch_q3  += rhs.ch_q3;
+        ch_q4  += rhs.ch_q4;
+        ch_q5  += rhs.ch_q5;
+        ch_q6  += rhs.ch_q6;
+        ch_q7  += rhs.ch_q7;
+        ch_q8  += rhs.ch_q8;
+        ch_q9  += rhs.ch_q9;
+        ch_q10 += rhs.ch_q10;
+        ch_q11 += rhs.ch_q11;
+        ch_q12 += rhs.ch_q12;
+        ch_q13 += rhs.ch_q13;
+        ch_q14 += rhs.ch_q14;
+        ch_q15 += rhs.ch_q15;
+        ch_q16 += rhs.ch_q16;
+        ch_q17 += rhs.ch_q17;
+        ch_q18 += rhs.ch_q18;
+        ch_q19 += rhs.ch_q19;
+        ch_q20 += rhs.ch_q20;
+        ch_q21 += rhs.ch_q21;
+        ch_q22 += rhs.ch_q22;
+	return (*this);
+    }
+
+    ShoreCHTrxCount& operator-=(ShoreCHTrxCount const& rhs) {
+        ch_q1  -= rhs.ch_q1;
+        ch_q2  -= rhs.ch_q2;
+        ch_q3  -= rhs.ch_q3;
+        ch_q4  -= rhs.ch_q4;
+        ch_q5  -= rhs.ch_q5;
+        ch_q6  -= rhs.ch_q6;
+        ch_q7  -= rhs.ch_q7;
+        ch_q8  -= rhs.ch_q8;
+        ch_q9  -= rhs.ch_q9;
+        ch_q10 -= rhs.ch_q10;
+        ch_q11 -= rhs.ch_q11;
+        ch_q12 -= rhs.ch_q12;
+        ch_q13 -= rhs.ch_q13;
+        ch_q14 -= rhs.ch_q14;
+        ch_q15 -= rhs.ch_q15;
+        ch_q16 -= rhs.ch_q16;
+        ch_q17 -= rhs.ch_q17;
+        ch_q18 -= rhs.ch_q18;
+        ch_q19 -= rhs.ch_q19;
+        ch_q20 -= rhs.ch_q20;
+        ch_q21 -= rhs.ch_q21;
+        ch_q22 -= rhs.ch_q22;
+	return (*this);
+    }
+
+    uint total() const {
+        return (ch_q1 + ch_q2 + ch_q3 + ch_q4 + ch_q5 + ch_q6 +
+                ch_q7 + ch_q8 + ch_q9 + ch_q10 + ch_q11 + ch_q12 +
+                ch_q13 + ch_q14 + ch_q15 + ch_q16 + ch_q17 + ch_q18 +
+                ch_q19 + ch_q20 + ch_q21 + ch_q22);
+    }
+
+}; // EOF: ShoreCHTrxCount
+
+
+
+struct ShoreCHTrxStats
+{
+    ShoreCHTrxCount attempted;
+    ShoreCHTrxCount failed;
+    ShoreCHTrxCount deadlocked;
+
+    ShoreCHTrxStats& operator+=(ShoreCHTrxStats const& other) {
+        attempted  += other.attempted;
+        failed     += other.failed;
+        deadlocked += other.deadlocked;
+        return (*this);
+    }
+
+    ShoreCHTrxStats& operator-=(ShoreCHTrxStats const& other) {
+        attempted  -= other.attempted;
+        failed     -= other.failed;
+        deadlocked -= other.deadlocked;
+        return (*this);
+    }
+
+}; // EOF: ShoreCHTrxStats
+
+
+
+/******************************************************************** 
+ * 
+ *  ShoreCHEnv
+ *  
+ *  Shore CH-benCHmark Database.
+ *
+ ********************************************************************/
+
+class ShoreCHEnv : public ShoreTPCCEnv
+{
+public:
+
+    typedef std::map<pthread_t, ShoreCHTrxStats*> ch_statmap_t;
+
+private:
+
+    // The workers of the analytical queries
+    WorkerPool      _olap_workers;
+    uint            _olap_worker_cnt;
+
+    // Percentage of the clients that run analytical queries
+    int             _olap_ratio;
+
+public:    
+
+    ShoreCHEnv();
+    virtual ~ShoreCHEnv();
+
+    virtual int conf();
+    virtual int start();
+    virtual int stop();
+    virtual int info() const;
+    virtual int statistics();    
+
+    virtual void print_throughput(const double iQueriedSF, 
+                                  const int iSpread, 
+                                  const int iNumOfThreads,
+                                  const double delay,
+                                  const ulong_t mioch,
+                                  const double avgcpuusage);
+
+
+    // --- the analytical workers and clients --- //
+
+    uint upd_olap_worker_cnt();
+    trx_worker_t* olap_worker(const uint idx);
+
+    // Whether client id runs analytical queries, in the HTAP mix
+    bool is_olap_client(const int id) const;
+
+
+    // --- kit trxs --- //
+
+    w_rc_t run_one_xct(Request* prequest);
+
+    DECLARE_TRX(ch_q1);
+    DECLARE_TRX(ch_q2);
+    DECLARE_TRX(ch_q3);
+    DECLARE_TRX(ch_q4);
+    DECLARE_TRX(ch_q5);
+    DECLARE_TRX(ch_q6);
+    DECLARE_TRX(ch_q7);
+    DECLARE_TRX(ch_q8);
+    DECLARE_TRX(ch_q9);
+    DECLARE_TRX(ch_q10);
+    DECLARE_TRX(ch_q11);
+    DECLARE_TRX(ch_q12);
+    DECLARE_TRX(ch_q13);
+    DECLARE_TRX(ch_q14);
+    DECLARE_TRX(ch_q15);
+    DECLARE_TRX(ch_q16);
+    DECLARE_TRX(ch_q17);
+    DECLARE_TRX(ch_q18);
+    DECLARE_TRX(ch_q19);
+    DECLARE_TRX(ch_q20);
+    DECLARE_TRX(ch_q21);
+    DECLARE_TRX(ch_q22);
+
+    // for thread-local stats
+    virtual void env_thread_init();
+    virtual void env_thread_fini();   
+
+    // stat map
+    ch_statmap_t _ch_statmap;
+
+    // snapshot taken at the beginning of each experiment    
+    ShoreCHTrxStats _last_ch_stats;
+    virtual void reset_stats();
+    ShoreCHTrxStats _get_ch_stats();
+
+}; // EOF ShoreCHEnv
+   
+
+
+EXIT_NAMESPACE(ch);
+
+
+#endif /* __SHORE_CH_ENV_H */
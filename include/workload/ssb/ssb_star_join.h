@@ -0,0 +1,241 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   ssb_star_join.h
+ *
+ *  @brief:  Single-pass star-join executor for the baseline SSB queries
+ *
+ *  @note:   The SSB dimension keys are dense integers (the date key is
+ *           a yyyymmdd that is densified by star_dim_t). Each dimension
+ *           is scanned and filtered once into a direct-indexed array
+ *           from key to group code; then a single pass over LINEORDER
+ *           probes those arrays and aggregates into a dense group
+ *           table whose index is the mixed-radix number of the codes.
+ */
+
+#ifndef __SSB_STAR_JOIN_H
+#define __SSB_STAR_JOIN_H
+
+#include "sm/shore/shore_row.h"
+#include "sm/shore/shore_column_store.h"
+
+#include <vector>
+#include <map>
+#include <string>
+
+
+ENTER_NAMESPACE(ssb);
+
+using namespace shore;
+using std::vector;
+using std::map;
+using std::string;
+
+
+/******************************************************************** 
+ *
+ *  @struct: star_cond_t
+ *
+ *  @brief:  A predicate on one column of a dimension row
+ *
+ ********************************************************************/
+
+struct star_cond_t
+{
+    enum op_t { STR_IN, STR_BETWEEN, INT_IN, INT_BETWEEN };
+
+    op_t   _op;
+    uint   _field;
+    string _s1;
+    string _s2;
+    int    _i1;
+    int    _i2;
+
+    bool test(const table_row_t* prow) const;
+};
+
+
+/******************************************************************** 
+ *
+ *  @class: star_dim_t
+ *
+ *  @brief: A filtered dimension: maps a (dense) dimension key to the
+ *          code of its group, or NOT_SELECTED. A dimension that is
+ *          joined only to filter has a single, unnamed group.
+ *
+ ********************************************************************/
+
+class star_dim_t
+{
+public:
+
+    enum { NOT_SELECTED = -1 };
+
+    star_dim_t(const uint key_field, const bool date_key=false);
+
+    // filters, all of which must hold
+    star_dim_t& where_str(const uint field, const char* value);
+    star_dim_t& where_str_in(const uint field, const char* v1, const char* v2);
+    star_dim_t& where_str_between(const uint field, const char* lo, const char* hi);
+    star_dim_t& where_int(const uint field, const int value);
+    star_dim_t& where_int_in(const uint field, const int v1, const int v2);
+    star_dim_t& where_int_between(const uint field, const int lo, const int hi);
+
+    // the column the selected rows are grouped by
+    star_dim_t& group_by_str(const uint field);
+    star_dim_t& group_by_int(const uint field);
+
+    // build: called once per row of the dimension table
+    void add_row(const table_row_t* prow);
+
+    // the dense form of a yyyymmdd date key
+    static int date_slot(const int datekey) {
+        return (((datekey/10000 - 1992)*13 + (datekey/100)%100)*32 + datekey%100);
+    }
+
+    int probe(const int key) const {
+        uint slot = (_date_key ? date_slot(key) : key);
+        return ((slot < _code.size()) ? _code[slot] : NOT_SELECTED);
+    }
+
+    uint groups() const { return (_labels.size()); }
+    uint selected() const { return (_selected); }
+    int min_key() const { return (_min_key); }   // of the selected rows
+    int max_key() const { return (_max_key); }
+    double selectivity() const { return (_rows ? (double)_selected/_rows : 1.0); }
+    bool grouped() const { return (_group_field >= 0); }
+    const string& label(const int code) const { return (_labels[code]); }
+
+private:
+
+    uint   _key_field;
+    bool   _date_key;
+    vector<star_cond_t> _conds;
+    int    _group_field;
+    bool   _group_int;
+
+    vector<int>      _code;    // dense key -> group code
+    vector<string>   _labels;  // group code -> group value
+    map<string,int>  _dict;    // group value -> group code (build only)
+    uint             _selected;
+    uint             _rows;
+    int              _min_key;
+    int              _max_key;
+
+    star_dim_t& _add(const star_cond_t& cond);
+
+}; // EOF: star_dim_t
+
+
+
+/******************************************************************** 
+ *
+ *  @class: star_query_t
+ *
+ *  @brief: The LINEORDER side of a star join: the dimensions to
+ *          probe (in the group-by order), the LINEORDER predicates,
+ *          the measure and the dense group table.
+ *
+ ********************************************************************/
+
+class star_query_t
+{
+public:
+
+    enum measure_t {
+        SUM_EXTPRICE_X_DISCOUNT,   // Q1.x
+        SUM_REVENUE,               // Q2.x, Q3.x
+        SUM_PROFIT                 // Q4.x: revenue - supplycost
+    };
+
+    // the LINEORDER columns the executor reads
+    enum {
+        LO_CUSTKEY       = 2,
+        LO_PARTKEY       = 3,
+        LO_SUPPKEY       = 4,
+        LO_ORDERDATE     = 5,
+        LO_QUANTITY      = 8,
+        LO_EXTENDEDPRICE = 9,
+        LO_DISCOUNT      = 11,
+        LO_REVENUE       = 12,
+        LO_SUPPLYCOST    = 13
+    };
+
+    star_query_t(const char* name, const measure_t measure);
+
+    // joins LINEORDER.(lo_field) with (dim); the joins are listed in
+    // the group-by order
+    star_query_t& join(const uint lo_field, const star_dim_t* dim);
+
+    star_query_t& where_discount(const int lo, const int hi);
+    star_query_t& where_quantity(const int lo, const int hi);
+
+    // ORDER BY the first group column, then the measure descending
+    // (Q3.x); by default the groups are ordered by their columns
+    star_query_t& order_by_value_desc();
+
+    // sizes the group table and orders the probes by selectivity,
+    // once the dimensions are built
+    void prepare();
+
+    // The ranges of the LINEORDER columns that joined rows may have:
+    // the keys of each dimension between its smallest and largest
+    // selected one, and the discount and quantity predicates. For the
+    // zone maps of LINEORDER.
+    void scan_preds(vector<column_pred_t>& preds) const;
+
+    // probes and aggregates one LINEORDER row
+    void add_row(const table_row_t* prow);
+
+    // prints the result groups and returns their number
+    uint report() const;
+
+    struct join_t {
+        uint _lo_field;
+        const star_dim_t* _dim;
+        uint _stride;
+    };
+
+private:
+
+    const char*       _name;
+    measure_t         _measure;
+    vector<join_t>    _joins;
+    vector<uint>      _probe;  // _joins indexes, most selective first
+    bool              _has_disc;
+    int               _disc_lo, _disc_hi;
+    bool              _has_qty;
+    int               _qty_lo, _qty_hi;
+    bool              _value_desc;
+
+    vector<long long> _sums;   // group index -> sum of the measure
+    vector<uint>      _hits;   // group index -> rows aggregated
+    long long         _scanned;
+    long long         _joined;
+
+}; // EOF: star_query_t
+
+
+EXIT_NAMESPACE(ssb);
+
+#endif /* __SSB_STAR_JOIN_H */
@@ -55,6 +55,102 @@ ENTER_NAMESPACE(tm1);
 /* ------------------------------------------------- */
 
 
+/* ------------------------------------------------- */
+/* --- Row layouts (see sm/shore/shore_row_layout.h) */
+/* ------------------------------------------------- */
+
+#ifdef CFG_HACK
+const int TM1_SUB_PADDING_SZ = 100-10*sizeof(bool)-20*sizeof(short)-3*sizeof(int)
+    -TM1_SUB_NBR_SZ*sizeof(char);
+const int TM1_AI_PADDING_SZ = 50-3*sizeof(short)-1*sizeof(int)
+    -(TM1_AI_DATA3_SZ+TM1_AI_DATA4_SZ)*sizeof(char);
+const int TM1_SF_PADDING_SZ = 50-1*sizeof(bool)-3*sizeof(short)-1*sizeof(int)
+    -TM1_SF_DATA_B_SZ*sizeof(char);
+const int TM1_CF_PADDING_SZ = 50-3*sizeof(short)-1*sizeof(int)
+    -TM1_CF_NUMBERX_SZ*sizeof(char);
+
+#define TM1_SUB_PADDING(F) F(S_PADDING,  FIXCHAR, TM1_SUB_PADDING_SZ)
+#define TM1_AI_PADDING(F)  F(AI_PADDING, FIXCHAR, TM1_AI_PADDING_SZ)
+#define TM1_SF_PADDING(F)  F(SF_PADDING, FIXCHAR, TM1_SF_PADDING_SZ)
+#define TM1_CF_PADDING(F)  F(CF_PADDING, FIXCHAR, TM1_CF_PADDING_SZ)
+#else
+#define TM1_SUB_PADDING(F)
+#define TM1_AI_PADDING(F)
+#define TM1_SF_PADDING(F)
+#define TM1_CF_PADDING(F)
+#endif
+
+
+#define TM1_SUB_FIELDS(F)                               \
+    F(S_ID,         INT,      0)                        \
+    F(SUB_NBR,      FIXCHAR,  TM1_SUB_NBR_SZ)           \
+    F(BIT_1,        BIT,      0)                        \
+    F(BIT_2,        BIT,      0)                        \
+    F(BIT_3,        BIT,      0)                        \
+    F(BIT_4,        BIT,      0)                        \
+    F(BIT_5,        BIT,      0)                        \
+    F(BIT_6,        BIT,      0)                        \
+    F(BIT_7,        BIT,      0)                        \
+    F(BIT_8,        BIT,      0)                        \
+    F(BIT_9,        BIT,      0)                        \
+    F(BIT_10,       BIT,      0)                        \
+    F(HEX_1,        SMALLINT, 0)                        \
+    F(HEX_2,        SMALLINT, 0)                        \
+    F(HEX_3,        SMALLINT, 0)                        \
+    F(HEX_4,        SMALLINT, 0)                        \
+    F(HEX_5,        SMALLINT, 0)                        \
+    F(HEX_6,        SMALLINT, 0)                        \
+    F(HEX_7,        SMALLINT, 0)                        \
+    F(HEX_8,        SMALLINT, 0)                        \
+    F(HEX_9,        SMALLINT, 0)                        \
+    F(HEX_10,       SMALLINT, 0)                        \
+    F(BYTE2_1,      SMALLINT, 0)                        \
+    F(BYTE2_2,      SMALLINT, 0)                        \
+    F(BYTE2_3,      SMALLINT, 0)                        \
+    F(BYTE2_4,      SMALLINT, 0)                        \
+    F(BYTE2_5,      SMALLINT, 0)                        \
+    F(BYTE2_6,      SMALLINT, 0)                        \
+    F(BYTE2_7,      SMALLINT, 0)                        \
+    F(BYTE2_8,      SMALLINT, 0)                        \
+    F(BYTE2_9,      SMALLINT, 0)                        \
+    F(BYTE2_10,     SMALLINT, 0)                        \
+    F(MSC_LOCATION, INT,      0)                        \
+    F(VLR_LOCATION, INT,      0)                        \
+    TM1_SUB_PADDING(F)
+
+#define TM1_AI_FIELDS(F)                                \
+    F(S_ID,         INT,      0)                        \
+    F(AI_TYPE,      SMALLINT, 0)                        \
+    F(DATA1,        SMALLINT, 0)                        \
+    F(DATA2,        SMALLINT, 0)                        \
+    F(DATA3,        FIXCHAR,  TM1_AI_DATA3_SZ)          \
+    F(DATA4,        FIXCHAR,  TM1_AI_DATA4_SZ)          \
+    TM1_AI_PADDING(F)
+
+#define TM1_SF_FIELDS(F)                                \
+    F(S_ID,         INT,      0)                        \
+    F(SF_TYPE,      SMALLINT, 0)                        \
+    F(IS_ACTIVE,    BIT,      0)                        \
+    F(ERROR_CNTRL,  SMALLINT, 0)                        \
+    F(DATA_A,       SMALLINT, 0)                        \
+    F(DATA_B,       FIXCHAR,  TM1_SF_DATA_B_SZ)         \
+    TM1_SF_PADDING(F)
+
+#define TM1_CF_FIELDS(F)                                \
+    F(S_ID,         INT,      0)                        \
+    F(SF_TYPE,      SMALLINT, 0)                        \
+    F(START_TIME,   SMALLINT, 0)                        \
+    F(END_TIME,     SMALLINT, 0)                        \
+    F(NUMBERX,      FIXCHAR,  TM1_CF_NUMBERX_SZ)        \
+    TM1_CF_PADDING(F)
+
+DECLARE_ROW_LAYOUT(subscriber_row_t,       TM1_SUB_FIELDS);
+DECLARE_ROW_LAYOUT(access_info_row_t,      TM1_AI_FIELDS);
+DECLARE_ROW_LAYOUT(special_facility_row_t, TM1_SF_FIELDS);
+DECLARE_ROW_LAYOUT(call_forwarding_row_t,  TM1_CF_FIELDS);
+
+
+
 DECLARE_TABLE_SCHEMA_PD(subscriber_t);
 DECLARE_TABLE_SCHEMA_PD(access_info_t);
 DECLARE_TABLE_SCHEMA_PD(special_facility_t);
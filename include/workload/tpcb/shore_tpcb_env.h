@@ -253,6 +253,8 @@ public:
     void set_skew(int area, int load, int start_imbalance);
     void start_load_imbalance();
     void reset_skew();
+    void set_hot_spot(double pos, double area, int load);
+    void clear_hot_spot();
 
     //print the current tables into files
     w_rc_t db_print(int lines);
@@ -56,6 +56,132 @@ ENTER_NAMESPACE(tpcc);
 /* -------------------------------------------------- */
 
 
+/* ------------------------------------------------------ */
+/* --- Row layouts (see sm/shore/shore_row_layout.h)  --- */
+/* ------------------------------------------------------ */
+
+#define TPCC_WAREHOUSE_FIELDS(F)                            \
+    F(W_ID,           INT,     0)                           \
+    F(W_NAME,         FIXCHAR, 10)                          \
+    F(W_STREET1,      FIXCHAR, 20)                          \
+    F(W_STREET2,      FIXCHAR, 20)                          \
+    F(W_CITY,         FIXCHAR, 20)                          \
+    F(W_STATE,        FIXCHAR, 2)                           \
+    F(W_ZIP,          FIXCHAR, 9)                           \
+    F(W_TAX,          FLOAT,   0)                           \
+    F(W_YTD,          FLOAT,   0)
+
+#define TPCC_DISTRICT_FIELDS(F)                             \
+    F(D_ID,           INT,     0)                           \
+    F(D_W_ID,         INT,     0)                           \
+    F(D_NAME,         FIXCHAR, 10)                          \
+    F(D_STREET1,      FIXCHAR, 20)                          \
+    F(D_STREET2,      FIXCHAR, 20)                          \
+    F(D_CITY,         FIXCHAR, 20)                          \
+    F(D_STATE,        FIXCHAR, 2)                           \
+    F(D_ZIP,          FIXCHAR, 9)                           \
+    F(D_TAX,          FLOAT,   0)                           \
+    F(D_YTD,          FLOAT,   0)                           \
+    F(D_NEXT_O_ID,    INT,     0)
+
+#define TPCC_CUSTOMER_FIELDS(F)                             \
+    F(C_ID,           INT,     0)                           \
+    F(C_D_ID,         INT,     0)                           \
+    F(C_W_ID,         INT,     0)                           \
+    F(C_FIRST,        FIXCHAR, 16)                          \
+    F(C_MIDDLE,       FIXCHAR, 2)                           \
+    F(C_LAST,         FIXCHAR, 16)                          \
+    F(C_STREET1,      FIXCHAR, 20)                          \
+    F(C_STREET2,      FIXCHAR, 20)                          \
+    F(C_CITY,         FIXCHAR, 20)                          \
+    F(C_STATE,        FIXCHAR, 2)                           \
+    F(C_ZIP,          FIXCHAR, 9)                           \
+    F(C_PHONE,        FIXCHAR, 16)                          \
+    F(C_SINCE,        FLOAT,   0)                           \
+    F(C_CREDIT,       FIXCHAR, 2)                           \
+    F(C_CREDIT_LIM,   FLOAT,   0)                           \
+    F(C_DISCOUNT,     FLOAT,   0)                           \
+    F(C_BALANCE,      FLOAT,   0)                           \
+    F(C_YTD_PAYMENT,  FLOAT,   0)                           \
+    F(C_LAST_PAYMENT, FLOAT,   0)                           \
+    F(C_PAYMENT_CNT,  INT,     0)                           \
+    F(C_DATA_1,       FIXCHAR, 250)                         \
+    F(C_DATA_2,       FIXCHAR, 250)
+
+#define TPCC_HISTORY_FIELDS(F)                              \
+    F(H_C_ID,         INT,     0)                           \
+    F(H_C_D_ID,       INT,     0)                           \
+    F(H_C_W_ID,       INT,     0)                           \
+    F(H_D_ID,         INT,     0)                           \
+    F(H_W_ID,         INT,     0)                           \
+    F(H_DATE,         FLOAT,   0)                           \
+    F(H_AMOUNT,       FLOAT,   0)                           \
+    F(H_DATA,         FIXCHAR, 25)
+
+#define TPCC_NEW_ORDER_FIELDS(F)                            \
+    F(NO_O_ID,        INT,     0)                           \
+    F(NO_D_ID,        INT,     0)                           \
+    F(NO_W_ID,        INT,     0)
+
+#define TPCC_ORDER_FIELDS(F)                                \
+    F(O_ID,           INT,     0)                           \
+    F(O_C_ID,         INT,     0)                           \
+    F(O_D_ID,         INT,     0)                           \
+    F(O_W_ID,         INT,     0)                           \
+    F(O_ENTRY_D,      FLOAT,   0)                           \
+    F(O_CARRIER_ID,   INT,     0)                           \
+    F(O_OL_CNT,       INT,     0)                           \
+    F(O_ALL_LOCAL,    INT,     0)
+
+#define TPCC_ORDER_LINE_FIELDS(F)                           \
+    F(OL_O_ID,        INT,     0)                           \
+    F(OL_D_ID,        INT,     0)                           \
+    F(OL_W_ID,        INT,     0)                           \
+    F(OL_NUMBER,      INT,     0)                           \
+    F(OL_I_ID,        INT,     0)                           \
+    F(OL_SUPPLY_W_ID, INT,     0)                           \
+    F(OL_DELIVERY_D,  FLOAT,   0)                           \
+    F(OL_QUANTITY,    INT,     0)                           \
+    F(OL_AMOUNT,      INT,     0)                           \
+    F(OL_DIST_INFO,   FIXCHAR, 25)
+
+#define TPCC_ITEM_FIELDS(F)                                 \
+    F(I_ID,           INT,     0)                           \
+    F(I_IM_ID,        INT,     0)                           \
+    F(I_NAME,         FIXCHAR, 24)                          \
+    F(I_PRICE,        INT,     0)                           \
+    F(I_DATA,         FIXCHAR, 50)
+
+#define TPCC_STOCK_FIELDS(F)                                \
+    F(S_I_ID,         INT,     0)                           \
+    F(S_W_ID,         INT,     0)                           \
+    F(S_REMOTE_CNT,   INT,     0)                           \
+    F(S_QUANTITY,     INT,     0)                           \
+    F(S_ORDER_CNT,    INT,     0)                           \
+    F(S_YTD,          INT,     0)                           \
+    F(S_DIST0,        FIXCHAR, 24)                          \
+    F(S_DIST1,        FIXCHAR, 24)                          \
+    F(S_DIST2,        FIXCHAR, 24)                          \
+    F(S_DIST3,        FIXCHAR, 24)                          \
+    F(S_DIST4,        FIXCHAR, 24)                          \
+    F(S_DIST5,        FIXCHAR, 24)                          \
+    F(S_DIST6,        FIXCHAR, 24)                          \
+    F(S_DIST7,        FIXCHAR, 24)                          \
+    F(S_DIST8,        FIXCHAR, 24)                          \
+    F(S_DIST9,        FIXCHAR, 24)                          \
+    F(S_DATA,         FIXCHAR, 50)
+
+DECLARE_ROW_LAYOUT(warehouse_row_t, TPCC_WAREHOUSE_FIELDS);
+DECLARE_ROW_LAYOUT(district_row_t, TPCC_DISTRICT_FIELDS);
+DECLARE_ROW_LAYOUT(customer_row_t, TPCC_CUSTOMER_FIELDS);
+DECLARE_ROW_LAYOUT(history_row_t, TPCC_HISTORY_FIELDS);
+DECLARE_ROW_LAYOUT(new_order_row_t, TPCC_NEW_ORDER_FIELDS);
+DECLARE_ROW_LAYOUT(order_row_t, TPCC_ORDER_FIELDS);
+DECLARE_ROW_LAYOUT(order_line_row_t, TPCC_ORDER_LINE_FIELDS);
+DECLARE_ROW_LAYOUT(item_row_t, TPCC_ITEM_FIELDS);
+DECLARE_ROW_LAYOUT(stock_row_t, TPCC_STOCK_FIELDS);
+
+
 DECLARE_TABLE_SCHEMA_PD(warehouse_t);
 DECLARE_TABLE_SCHEMA_PD(district_t);
 DECLARE_TABLE_SCHEMA_PD(stock_t);
@@ -450,6 +450,12 @@ public:
                              item_tuple* ptuple,
                              const int i_id);
 
+    // probes for count items at once, in key order
+    w_rc_t it_index_probe_batch(ss_m* db, 
+                                item_tuple** ptuples,
+                                const int* i_ids,
+                                const int count);
+
 }; // EOF: item_man_impl
 
 
@@ -487,6 +493,14 @@ public:
                              const int w_id,
                              const int i_id);
 
+    // probes for count stock rows at once, locking them in key order
+    w_rc_t st_index_probe_batch(ss_m* db,
+                                stock_tuple** ptuples,
+                                const int* w_ids,
+                                const int* i_ids,
+                                const int count,
+                                lock_mode_t lm = SH);
+
     /* --- update a retrieved tuple --- */
     w_rc_t st_update_tuple(ss_m* db,
                            stock_tuple* ptuple,
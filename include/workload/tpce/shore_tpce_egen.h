@@ -63,6 +63,7 @@ public:
       moreToRead=true;
       cnt = 0;
     }
+    ~EgenTupleContainer() { delete [] buffer; }
     T* get(int i){cnt++; return &buffer[i]; }
     void append(T* row) {memcpy(&buffer[size++],row, sizeof(T)); }
     bool hasSpace(){return (size<capacity-2);}
@@ -216,6 +217,67 @@ class ZipCodeBuffer: public EgenTupleContainer<ZIP_CODE_ROW>{
 };
 
 
+/******************************************************************** 
+ *
+ * @struct: egen_load_ctx_t
+ *
+ * @brief:  The EGen generator and the tuple buffers of one loader.
+ *          Each loader generates the customers [start, start+count),
+ *          so loaders with disjoint ranges can run concurrently.
+ *
+ ********************************************************************/
+
+struct egen_load_ctx_t
+{
+    CGenerateAndLoad* gen;
+    TIdent start;
+    TIdent count;
+    unsigned long progress;
+
+    AccountPermissionBuffer accountPermissionBuffer;
+    CustomerBuffer customerBuffer;
+    CustomerAccountBuffer customerAccountBuffer;
+    CustomerTaxrateBuffer customerTaxrateBuffer;
+    HoldingBuffer holdingBuffer;
+    HoldingHistoryBuffer holdingHistoryBuffer;
+    HoldingSummaryBuffer holdingSummaryBuffer;
+    WatchItemBuffer watchItemBuffer;
+    WatchListBuffer watchListBuffer;
+
+    BrokerBuffer brokerBuffer;
+    CashTransactionBuffer cashTransactionBuffer;
+    ChargeBuffer chargeBuffer;
+    CommissionRateBuffer commissionRateBuffer;
+    SettlementBuffer settlementBuffer;
+    TradeBuffer tradeBuffer;
+    TradeHistoryBuffer tradeHistoryBuffer;
+    TradeTypeBuffer tradeTypeBuffer;
+
+    CompanyBuffer companyBuffer;
+    CompanyCompetitorBuffer companyCompetitorBuffer;
+    DailyMarketBuffer dailyMarketBuffer;
+    ExchangeBuffer exchangeBuffer;
+    FinancialBuffer financialBuffer;
+    IndustryBuffer industryBuffer;
+    LastTradeBuffer lastTradeBuffer;
+    NewsItemBuffer newsItemBuffer;
+    NewsXRefBuffer newsXRefBuffer;
+    SectorBuffer sectorBuffer;
+    SecurityBuffer securityBuffer;
+
+    AddressBuffer addressBuffer;
+    StatusTypeBuffer statusTypeBuffer;
+    TaxrateBuffer taxrateBuffer;
+    ZipCodeBuffer zipCodeBuffer;
+
+    egen_load_ctx_t(CGenerateAndLoad* agen, TIdent astart, TIdent acount);
+
+private:
+    egen_load_ctx_t(const egen_load_ctx_t&);
+    egen_load_ctx_t& operator=(const egen_load_ctx_t&);
+};
+
+
 EXIT_NAMESPACE(tpce);
 
 #endif
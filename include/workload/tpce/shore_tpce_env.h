@@ -62,49 +62,15 @@ using namespace TPCE;
 
 int egen_init(int argc, char* argv[]);
 void egen_release();
+CGenerateAndLoad* egen_range_init(TIdent iStart, TIdent iCount);
 extern CGenerateAndLoad*  pGenerateAndLoad;
 
 ENTER_NAMESPACE(tpce);
 
 using std::map;
 
-extern AccountPermissionBuffer accountPermissionBuffer;
-extern CustomerBuffer customerBuffer ;
-extern CustomerAccountBuffer customerAccountBuffer ;
-extern CustomerTaxrateBuffer  customerTaxrateBuffer ;
-extern HoldingBuffer holdingBuffer;
-extern HoldingHistoryBuffer holdingHistoryBuffer;
-extern HoldingSummaryBuffer holdingSummaryBuffer;
-extern WatchItemBuffer watchItemBuffer ;
-extern WatchListBuffer watchListBuffer;
-
-extern BrokerBuffer brokerBuffer;
-extern CashTransactionBuffer cashTransactionBuffer;
-extern ChargeBuffer chargeBuffer;
-extern CommissionRateBuffer commissionRateBuffer;
-extern SettlementBuffer settlementBuffer;
-extern TradeBuffer tradeBuffer;
-extern TradeHistoryBuffer tradeHistoryBuffer;
-extern TradeTypeBuffer tradeTypeBuffer;
-
-
-extern CompanyBuffer companyBuffer ;
-extern CompanyCompetitorBuffer companyCompetitorBuffer;
-extern DailyMarketBuffer dailyMarketBuffer;
-extern ExchangeBuffer exchangeBuffer;
-extern FinancialBuffer financialBuffer;
-extern IndustryBuffer industryBuffer;
-extern LastTradeBuffer lastTradeBuffer;
-extern NewsItemBuffer newsItemBuffer;
-extern NewsXRefBuffer newsXRefBuffer;//big
-extern SectorBuffer sectorBuffer;
-extern SecurityBuffer securityBuffer;
-
-
-extern AddressBuffer addressBuffer;
-extern StatusTypeBuffer statusTypeBuffer;
-extern TaxrateBuffer taxrateBuffer ;
-extern ZipCodeBuffer zipCodeBuffer ;
+// The EGen generator and buffers of the loader on the calling thread
+extern __thread egen_load_ctx_t* my_egen;
 
 
 #ifdef TESTING_TPCE
@@ -361,36 +327,36 @@ public:
                                   const double avgcpuusage);
 
     void read_small(){
-        pGenerateAndLoad->InitCharge();
+        my_egen->gen->InitCharge();
         _read_charge();
-        pGenerateAndLoad->InitCommissionRate();
+        my_egen->gen->InitCommissionRate();
         _read_commission_rate();
-        pGenerateAndLoad->InitExchange();
+        my_egen->gen->InitExchange();
         _read_exchange();
-        pGenerateAndLoad->InitIndustry();
+        my_egen->gen->InitIndustry();
         _read_industry();
-        pGenerateAndLoad->InitSector();
+        my_egen->gen->InitSector();
         _read_sector();
-        pGenerateAndLoad->InitStatusType();  
+        my_egen->gen->InitStatusType();  
         _read_status_type();
-        pGenerateAndLoad->InitTaxrate();
+        my_egen->gen->InitTaxrate();
         _read_taxrate();
-        pGenerateAndLoad->InitTradeType();
+        my_egen->gen->InitTradeType();
         _read_trade_type();
-        pGenerateAndLoad->InitZipCode();
+        my_egen->gen->InitZipCode();
         _read_zip_code();
     }
 
     void release_small(){
-        chargeBuffer.release();
-        commissionRateBuffer.release();
-        exchangeBuffer.release();
-        industryBuffer.release();
-        sectorBuffer.release();
-        statusTypeBuffer.release();
-        taxrateBuffer.release();
-        tradeTypeBuffer.release();
-        zipCodeBuffer.release();
+        my_egen->chargeBuffer.release();
+        my_egen->commissionRateBuffer.release();
+        my_egen->exchangeBuffer.release();
+        my_egen->industryBuffer.release();
+        my_egen->sectorBuffer.release();
+        my_egen->statusTypeBuffer.release();
+        my_egen->taxrateBuffer.release();
+        my_egen->tradeTypeBuffer.release();
+        my_egen->zipCodeBuffer.release();
     }
     
     void populate_customer();
@@ -411,6 +377,14 @@ public:
     void populate_unit_trade();
     void populate_growing();
     void find_maxtrade_id();
+
+    // In-memory copies of the fixed tables (db-ref-cache). Built once the
+    // database is loaded, and refreshed after each Data-Maintenance, the
+    // only transaction that updates them.
+    void build_ref_caches();
+    w_rc_t refresh_ref_caches();
+    bool _use_ref_caches;
+
     // Public methods //    
 
     // --- operations over tables --- //
@@ -194,6 +194,18 @@ public:
 				lock_mode_t alm = SH,
                                 bool need_tuple = true);
 
+    // CR_RATE of the row with from_qty <= trade_qty <= to_qty, from the
+    // cache if it is valid, otherwise through cr_get_iter_by_index()
+    w_rc_t cr_get_rate(ss_m* db,
+		       commission_rate_tuple* ptuple,
+		       rep_row_t &replow,
+		       rep_row_t &rephigh,
+		       const short c_tier, 
+		       const char* type_id, 
+		       const char* s_ex_id,
+		       const int trade_qty,
+		       double& rate);
+
 }; 
 
 
@@ -536,6 +548,8 @@ public:
     
     w_rc_t se_index_probe_forupdate(ss_m* db, settlement_tuple* ptuple, const TIdent tr_id);
     
+    w_rc_t se_index_probe_batch(ss_m* db, settlement_tuple** ptuples, const TIdent* tr_ids, const int count);
+    
     w_rc_t se_update_name(ss_m* db, settlement_tuple* ptuple, const char* cash_type, lock_mode_t lm = EX);
     
 }; 
@@ -583,6 +597,8 @@ public:
 
     w_rc_t t_index_probe(ss_m* db, trade_tuple* ptuple, const TIdent trade_id);
 
+    w_rc_t t_index_probe_batch(ss_m* db, trade_tuple** ptuples, const TIdent* trade_ids, const int count);
+
     w_rc_t t_update_tax_by_index(ss_m* db, trade_tuple* ptuple, const TIdent t_id,
 				 const double tax_amount, lock_mode_t lm = EX);
     
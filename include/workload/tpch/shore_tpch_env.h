@@ -285,9 +285,11 @@ public:
     virtual int stop();
     virtual int info() const;
     virtual int statistics();    
+    virtual int mem_grants();
 
     w_rc_t warmup();
     w_rc_t check_consistency();
+    w_rc_t db_columns();
 
     int dump();
 
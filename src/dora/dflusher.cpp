@@ -43,7 +43,8 @@ ENTER_NAMESPACE(dora);
 dora_flusher_t::dora_flusher_t(ShoreEnv* penv, 
                                c_str tname,
                                processorid_t aprsid, 
-                               const int use_sli) 
+                               const int use_sli,
+                               processorid_t anotifierprsid) 
     : flusher_t(penv, tname, aprsid, use_sli)
 { 
     _dora_toflush = new DoraQueue(_pxct_toflush_pool.get());
@@ -56,7 +57,7 @@ dora_flusher_t::dora_flusher_t(ShoreEnv* penv,
 
     // Create and start the notifier
     fprintf(stdout, "Starting dora-notifier...\n");
-    _notifier = new dora_notifier_t(_env, c_str("DNotifier"));
+    _notifier = new dora_notifier_t(_env, c_str("DNotifier"), anotifierprsid);
     assert(_notifier.get());
     _notifier->fork();
     _notifier->start();
@@ -135,6 +135,33 @@ int DoraEnv::_statistics(ShoreEnv* /* penv */)
 
 
 
+/******************************************************************** 
+ *
+ *  @fn:    _gather_{worker,flusher}_stats
+ *
+ *  @brief: The worker stats of all the partitions and the stats of the
+ *          dora-flushers, for the metrics sampler. They are not reset.
+ *
+ ********************************************************************/
+
+void DoraEnv::_gather_worker_stats(worker_stats_t& agg)
+{
+    for (uint i=0; i<_irptp_vec.size(); ++i) {
+        _irptp_vec[i]->gather_stats(agg);
+    }
+}
+
+void DoraEnv::_gather_flusher_stats(flusher_stats_t& agg)
+{
+#ifdef CFG_FLUSHER
+    for (uint_t i=0; i<_num_flushers; i++) {
+        agg += _vec_flusher[i]->get_stats();
+    }
+#endif
+}
+
+
+
 /****************************************************************** 
  *
  * @fn:    _check_type()
@@ -176,6 +203,9 @@ uint DoraEnv::_check_type()
 
 int DoraEnv::_post_start(ShoreEnv* penv)
 {
+    // Decide about the placement before any thread is (re-)started
+    cpu_placement_t* placement = _init_placement(penv);
+
 #ifdef CFG_FLUSHER
     // Start the flusher
     TRACE( TRACE_ALWAYS, "Creating dora-flusher...\n");
@@ -188,7 +218,18 @@ int DoraEnv::_post_start(ShoreEnv* penv)
     // start them
     for (uint_t i=0; i<_num_flushers; i++)
     {
-        dora_flusher_t* aFlusher = new dora_flusher_t(penv, c_str("DFlusher-%d",i)); 
+        // With placement, each flusher and its notifier go to the last
+        // cpus of one node, away from the cores the partitions take first
+        processorid_t flusherprs = PBIND_NONE;
+        processorid_t notifierprs = PBIND_NONE;
+        if (placement) {
+            int node = i % placement->node_count();
+            flusherprs = placement->tail(node, 0, c_str("DFlusher-%d",i).data());
+            notifierprs = placement->tail(node, 1, c_str("DNotifier-%d",i).data());
+        }
+
+        dora_flusher_t* aFlusher = new dora_flusher_t(penv, c_str("DFlusher-%d",i),
+                                                      flusherprs, 0, notifierprs); 
         w_assert0(aFlusher);
 
         _vec_flusher[i] = aFlusher;
@@ -201,6 +242,7 @@ int DoraEnv::_post_start(ShoreEnv* penv)
 
     // Reset the tables
     for (uint_t i=0; i<_irptp_vec.size(); i++) {
+        _irptp_vec[i]->set_placement(placement);
         _irptp_vec[i]->reset();
     }
 
@@ -315,11 +357,51 @@ int DoraEnv::_info(const ShoreEnv* penv) const
     for (uint i=0;i<sz;++i) {
         _irptp_vec[i]->info();
     }
+
+    if (_placement) {
+        cpu_topology_t::instance()->print();
+        _placement->print();
+    }
     return (0);
 }
 
 
 
+/****************************************************************** 
+ *
+ * @fn:    _init_placement()
+ *
+ * @brief: If "dora-cpu-placement" is "topology" (and binding is on),
+ *         creates the placement that uses the sysfs topology to put
+ *         the partitions of the same key range on the same NUMA node.
+ *         Otherwise, the arithmetic cpu steps are used.
+ *
+ * @note:  Only the first "active-cpu-count" cpus are used.
+ *
+ ******************************************************************/
+
+cpu_placement_t* DoraEnv::_init_placement(ShoreEnv* penv)
+{
+    envVar* ev = envVar::instance();
+    string policy = ev->getVar("dora-cpu-placement","arith");
+    if ((ev->getVarInt("dora-cpu-binding",0)==0) || 
+        (policy.compare("topology")!=0)) {
+        _placement.done();
+        return (NULL);
+    }
+
+    if (!_placement) {
+        _placement = new cpu_placement_t("dora", penv->get_active_cpu_count());
+    }
+    _placement->reset();
+
+    TRACE( TRACE_STATISTICS, "Topology-aware placement over (%d) nodes\n",
+           _placement->node_count());
+    return (_placement.get());
+}
+
+
+
 /****************************************************************** 
  *
  * @fn:    _next_cpu()
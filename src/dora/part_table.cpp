@@ -52,7 +52,7 @@ part_table_t::part_table_t(ShoreEnv* env, table_desc_t* ptable,
                            const uint keyEstimation) 
     : _env(env), _table(ptable), 
       _start_prs_id(aprs), _next_prs_id(aprs), _prs_range(acpurange), 
-      _key_estimation(keyEstimation)
+      _key_estimation(keyEstimation), _placement(NULL)
 {
     assert (_env);
     assert (_table);
@@ -135,7 +135,13 @@ w_rc_t part_table_t::reset()
     TRACE( TRACE_DEBUG, "Reseting (%s)...\n", _table->name());
     _next_prs_id = _start_prs_id;
 
-    for (BPPMapIt it=_bppmap.begin(); it != _bppmap.end(); it++) {
+    // The map is ordered by the partition ids, which follow the order
+    // of the key ranges. Hence, the position of a partition in the map
+    // is also its position in the key space.
+    uint pos = 0;
+    uint total = _bppmap.size();
+    for (BPPMapIt it=_bppmap.begin(); it != _bppmap.end(); it++, pos++) {
+        _next_prs_id = placed_cpu(pos, total, _next_prs_id);
         (*it).second->reset(_next_prs_id);
         _next_prs_id = next_cpu(_next_prs_id);
     }    
@@ -200,6 +206,38 @@ processorid_t part_table_t::next_cpu(const processorid_t& aprd)
 
 
 
+/****************************************************************** 
+ *
+ * @fn:    set_placement()
+ *
+ * @brief: Switches the table to the topology-aware placement. 
+ *
+ * @note:  With a placement set, the partition that covers the apos-th
+ *         out of atotal slices of the key space is placed on the NUMA 
+ *         node that is responsible for that slice. Since all the tables
+ *         that are partitioned on the same key (e.g. W_ID in TPC-C) 
+ *         map the same slice to the same node, partitions that exchange
+ *         RVPs end up on the same node.
+ *
+ ******************************************************************/
+
+void part_table_t::set_placement(cpu_placement_t* aplacement)
+{
+    CRITICAL_SECTION(ptcs, _lock);
+    _placement = aplacement;
+}
+
+
+processorid_t part_table_t::placed_cpu(const uint apos, const uint atotal,
+                                       const processorid_t& adefault)
+{
+    if (!_placement) return (adefault);
+    return (_placement->next_for_range(apos, atotal,
+                                       c_str("%s-%d", _table->name(), apos).data()));
+}
+
+
+
 /****************************************************************** 
  *
  * Debugging
@@ -233,6 +271,14 @@ void part_table_t::statistics() const
 }        
 
 
+void part_table_t::gather_stats(worker_stats_t& agg) const 
+{
+    for (BPPMapCIt it=_bppmap.begin(); it != _bppmap.end(); it++) {
+        (*it).second->peek_stats(agg);
+    }
+}
+
+
 void part_table_t::info() const 
 {
     TRACE( TRACE_STATISTICS, "Table (%s)\n", _table->name());
@@ -148,6 +148,12 @@ w_rc_t range_table_t::repartition()
     while (pidIt != pidVec.end()) {
         // There are some partitions that need to be created
 
+        // If topology-aware placement is used, place the new partition
+        // according to its position in the key space
+        PartTable::_next_prs_id = placed_cpu((pidIt - pidVec.begin()), 
+                                             pidVec.size(),
+                                             PartTable::_next_prs_id);
+
         // The create_one_part() will create one partition and will put the
         // pointer to the corresponding place of the map
         base_partition_t* abp = NULL;
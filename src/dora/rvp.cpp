@@ -250,6 +250,7 @@ w_rc_t terminal_rvp_t::_run()
         // We cannot abort lazily because log rollback works on 
         // disk-resident records
         rcdec = _db->abort_xct();
+        _result.set_state(ROLLBACKED);
 
         if (rcdec.is_error()) 
         {
@@ -282,6 +283,7 @@ w_rc_t terminal_rvp_t::_run()
                    _tid.get_lo(), rcdec.err_num());
             upd_aborted_stats();
             w_rc_t eabort = _db->abort_xct();
+            _result.set_state(ROLLBACKED);
 
             if (eabort.is_error()) {
                 TRACE( TRACE_ALWAYS, "Xct (%d) abort failed [0x%x]\n",
@@ -126,7 +126,7 @@ w_rc_t dora_tm1_client_t::submit_one(int xct_type, int xctid)
     int selid = (selsf-1)*TM1_SUBS_PER_SF + URand(1,TM1_SUBS_PER_SF);
 
     trx_result_tuple_t atrt;
-    if (condex* c = _cp->take_one()) {
+    if (completion_queue_t* c = _cq->take_one()) {
         atrt.set_notify(c);
         bWake = true;
     }
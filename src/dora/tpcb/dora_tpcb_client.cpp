@@ -79,7 +79,7 @@ w_rc_t dora_tpcb_client_t::submit_one(int xct_type, int xctid)
 //         selid = URand(1,_qf);
 
     trx_result_tuple_t atrt;
-    if (condex* c = _cp->take_one()) {
+    if (completion_queue_t* c = _cq->take_one()) {
         atrt.set_notify(c);
         bWake = true;
     }
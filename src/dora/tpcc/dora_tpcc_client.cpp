@@ -104,7 +104,7 @@ w_rc_t dora_tpcc_client_t::submit_one(int xct_type, int xctid)
     }
 
     trx_result_tuple_t atrt;
-    if (condex* c = _cp->take_one()) {
+    if (completion_queue_t* c = _cq->take_one()) {
         atrt.set_notify(c);
         bWake = true;
     }
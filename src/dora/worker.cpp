@@ -229,7 +229,12 @@ int dora_worker_t::_serve_action(base_action_t* paction)
 #endif
             
         // 4. serve action
-        e = paction->trx_exec();
+        {
+#ifdef CFG_PERFCTRS
+            perfctr_scope_t pcs(paction->perfctr_region());
+#endif
+            e = paction->trx_exec();
+        }
 
 #ifdef WORKER_VERBOSE_STATS
         _stats.update_served(serving_time.time_ms());
@@ -0,0 +1,361 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+#include "qpipe/core/coro_sched.h"
+
+#include <unistd.h>
+#include <sys/time.h>
+
+
+ENTER_NAMESPACE(qpipe);
+
+
+coro_pool_t* coro_pool_t::_instance = NULL;
+pthread_mutex_t coro_pool_t::_instance_lock = thread_mutex_create();
+
+/* the coroutine on this thread. Read only through coro_t::self(), a
+   coroutine may continue on another thread after a switch and the
+   compiler must not reuse the address of the old thread's copy. */
+static __thread coro_t* _my_coro = NULL;
+
+static const int CORO_IDLE_WAIT_MS = 100;
+
+
+
+/* coroutine methods */
+
+coro_t::coro_t(coro_func_t func, void* arg, size_t stack_size)
+    : _stack(new char[stack_size]), _stack_size(stack_size),
+      _func(func), _arg(arg),
+      _state(CS_READY), _sched(NULL), _release(NULL)
+{
+    if (getcontext(&_ctx))
+        THROW1(ThreadException, "getcontext");
+    _ctx.uc_stack.ss_sp = _stack;
+    _ctx.uc_stack.ss_size = _stack_size;
+    _ctx.uc_link = NULL;
+    makecontext(&_ctx, &coro_t::_trampoline, 0);
+}
+
+
+coro_t::~coro_t()
+{
+    delete [] _stack;
+}
+
+
+__attribute__((noinline))
+coro_t* coro_t::self()
+{
+    return _my_coro;
+}
+
+
+/**
+ *  @brief Entry point of every coroutine. It must not return, there is
+ *  no context to return to. It switches back to the scheduler which
+ *  deletes the coroutine.
+ */
+void coro_t::_trampoline()
+{
+    coro_t* me = self();
+    assert(me != NULL);
+
+    try {
+        me->_func(me->_arg);
+    } catch (...) {
+        TRACE(TRACE_ALWAYS, "Caught unrecognized exception in a coroutine\n");
+        assert(false);
+    }
+
+    me->_state = CS_DONE;
+    setcontext(&me->_sched->_main);
+    unreachable();
+}
+
+
+void coro_t::park(pthread_mutex_t &mutex)
+{
+    coro_t* me = self();
+    assert(me != NULL);
+    assert(me->_state == CS_RUNNING);
+
+    me->_release = &mutex;
+    me->_state = CS_PARKING;
+    swapcontext(&me->_ctx, &me->_sched->_main);
+
+    // woken up, maybe on another scheduler
+    thread_mutex_lock(mutex);
+}
+
+
+void coro_t::yield()
+{
+    coro_t* me = self();
+    assert(me != NULL);
+    assert(me->_state == CS_RUNNING);
+
+    me->_state = CS_YIELDING;
+    swapcontext(&me->_ctx, &me->_sched->_main);
+}
+
+
+void coro_t::wake(coro_t* coro)
+{
+    assert(coro != NULL);
+    assert(coro->_state == CS_WAITING);
+    coro_pool_t::_instance->_ready(coro->_sched, coro);
+}
+
+
+
+/* scheduler methods */
+
+coro_sched_t::coro_sched_t(const c_str &name, coro_pool_t* pool, int id)
+    : thread_t(name), _pool(pool), _id(id),
+      _lock(thread_mutex_create()),
+      _switches(0), _steals(0)
+{
+}
+
+
+coro_sched_t::~coro_sched_t()
+{
+    thread_mutex_destroy(_lock);
+}
+
+
+void coro_sched_t::_push(coro_t* coro)
+{
+    critical_section_t cs(_lock);
+    _runq.push_back(coro);
+}
+
+
+coro_t* coro_sched_t::_pop()
+{
+    critical_section_t cs(_lock);
+    if (_runq.empty())
+        return NULL;
+    coro_t* coro = _runq.front();
+    _runq.pop_front();
+    atomic_dec_uint(&_pool->_runnable);
+    return coro;
+}
+
+
+/**
+ *  @brief Takes the most recently queued coroutine of the first other
+ *  scheduler that has any. The oldest ones are left to their owner,
+ *  their stacks are more likely to still be in its cache.
+ */
+coro_t* coro_sched_t::_steal()
+{
+    int n = _pool->_scheds.size();
+    for (int i = 1; i < n; i++) {
+        coro_sched_t* victim = _pool->_scheds[(_id + i) % n];
+        critical_section_t cs(victim->_lock);
+        if (victim->_runq.empty())
+            continue;
+        coro_t* coro = victim->_runq.back();
+        victim->_runq.pop_back();
+        atomic_dec_uint(&_pool->_runnable);
+        _steals++;
+        return coro;
+    }
+    return NULL;
+}
+
+
+/**
+ *  @brief Runs a coroutine until it switches out, and then finishes
+ *  what it asked for: a parked coroutine releases its mutex only now,
+ *  when its context is saved and another thread may resume it.
+ */
+void coro_sched_t::_run(coro_t* coro)
+{
+    assert(coro->_state == coro_t::CS_READY);
+    coro->_sched = this;
+    coro->_state = coro_t::CS_RUNNING;
+    _my_coro = coro;
+    _switches++;
+
+    swapcontext(&_main, &coro->_ctx);
+
+    _my_coro = NULL;
+    switch (coro->_state) {
+    case coro_t::CS_DONE:
+        delete coro;
+        break;
+    case coro_t::CS_PARKING: {
+        pthread_mutex_t* release = coro->_release;
+        coro->_release = NULL;
+        coro->_state = coro_t::CS_WAITING;
+        thread_mutex_unlock(*release);
+        break;
+    }
+    case coro_t::CS_YIELDING:
+        _pool->_ready(this, coro);
+        break;
+    default:
+        unreachable();
+    }
+}
+
+
+void coro_sched_t::work()
+{
+    while (1) {
+        coro_t* coro = _pop();
+        if (coro == NULL)
+            coro = _steal();
+        if (coro == NULL) {
+            _pool->_idle_wait();
+            continue;
+        }
+        _run(coro);
+    }
+}
+
+
+
+/* pool methods */
+
+coro_pool_t::coro_pool_t(int schedulers, size_t stack_size)
+    : _stack_size(stack_size),
+      _idle_lock(thread_mutex_create()),
+      _idle_cond(thread_cond_create()),
+      _sleeping(0), _runnable(0), _next(0)
+{
+    if (schedulers < 0)
+        schedulers = sysconf(_SC_NPROCESSORS_ONLN);
+    if (schedulers < 1)
+        schedulers = 1;
+
+    // all of them exist before any of them looks for work to steal
+    for (int i = 0; i < schedulers; i++)
+        _scheds.push_back(new coro_sched_t(c_str("CORO_SCHED_%d", i), this, i));
+
+    for (int i = 0; i < schedulers; i++) {
+#ifdef USE_SMTHREAD_AS_BASE
+        _scheds[i]->fork();
+#else
+        thread_create(_scheds[i]);
+#endif
+    }
+
+    TRACE(TRACE_ALWAYS, "Started (%d) coroutine schedulers, (%d)KB stacks\n",
+          schedulers, (int)(stack_size/1024));
+}
+
+
+bool coro_pool_t::enabled()
+{
+    static int schedulers = 
+        envVar::instance()->getVarInt("qpipe-coro-schedulers",
+                                      CORO_DEFAULT_SCHEDULERS);
+    return (schedulers != 0);
+}
+
+
+coro_pool_t* coro_pool_t::instance()
+{
+    critical_section_t cs(_instance_lock);
+    if (_instance == NULL) {
+        envVar* ev = envVar::instance();
+        int schedulers = ev->getVarInt("qpipe-coro-schedulers",
+                                       CORO_DEFAULT_SCHEDULERS);
+        int stack_kb = ev->getVarInt("qpipe-coro-stack-kb",
+                                     CORO_DEFAULT_STACK_KB);
+        if (stack_kb < 64)
+            stack_kb = CORO_DEFAULT_STACK_KB;
+        _instance = new coro_pool_t(schedulers, stack_kb * 1024);
+    }
+    return _instance;
+}
+
+
+void coro_pool_t::spawn(coro_func_t func, void* arg)
+{
+    coro_t* coro = new coro_t(func, arg, _stack_size);
+    uint_t next = atomic_inc_uint_nv(&_next);
+    _ready(_scheds[next % _scheds.size()], coro);
+}
+
+
+/**
+ *  @brief Queues a coroutine on a scheduler and wakes up a sleeping
+ *  one, if any. The counter goes up before we look for sleepers, and
+ *  they check it under _idle_lock, so none sleeps past this.
+ */
+void coro_pool_t::_ready(coro_sched_t* sched, coro_t* coro)
+{
+    coro->_state = coro_t::CS_READY;
+    sched->_push(coro);
+    atomic_inc_uint(&_runnable);
+
+    critical_section_t cs(_idle_lock);
+    if (_sleeping > 0)
+        thread_cond_signal(_idle_cond);
+}
+
+
+/**
+ *  @brief Sleeps until something is queued. The wait is bounded, the
+ *  scheduler looks for work to steal again at least that often.
+ */
+bool coro_pool_t::_idle_wait()
+{
+    critical_section_t cs(_idle_lock);
+    if (*&_runnable > 0)
+        return true;
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    long usec = now.tv_usec + CORO_IDLE_WAIT_MS*1000;
+    struct timespec until;
+    until.tv_sec = now.tv_sec + usec/1000000;
+    until.tv_nsec = (usec%1000000)*1000;
+
+    _sleeping++;
+    bool woken = thread_cond_wait(_idle_cond, _idle_lock, until);
+    _sleeping--;
+    return woken;
+}
+
+
+void coro_pool_t::print_stats()
+{
+    uint64_t switches = 0;
+    uint64_t steals = 0;
+    for (size_t i = 0; i < _scheds.size(); i++) {
+        switches += _scheds[i]->_switches;
+        steals += _scheds[i]->_steals;
+    }
+    TRACE(TRACE_STATISTICS, 
+          "Coroutines: (%d) schedulers, (%lld) switches, (%lld) steals\n",
+          (int)_scheds.size(), (long long)switches, (long long)steals);
+}
+
+
+
+EXIT_NAMESPACE(qpipe);
@@ -0,0 +1,345 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+   
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+   
+                         All Rights Reserved.
+   
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+   
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+#include "qpipe/core/mem_broker.h"
+
+#include <sys/time.h>
+
+
+ENTER_NAMESPACE(qpipe);
+
+
+mem_broker_t* mem_broker_t::_instance = NULL;
+pthread_mutex_t mem_broker_t::_instance_lock = thread_mutex_create();
+
+
+static long long now_ms() {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (tv.tv_sec*1000ll + tv.tv_usec/1000);
+}
+
+
+
+/**
+ *  @brief The thread that expires the waiters of the broker.
+ */
+class mem_broker_timer_t : public thread_t {
+
+    mem_broker_t* _broker;
+
+public:
+
+    mem_broker_timer_t(mem_broker_t* broker)
+        : thread_t(c_str("MEM_BROKER_TIMER")), _broker(broker)
+    {
+    }
+
+    virtual void work() {
+        _broker->expire_waiters();
+    }
+};
+
+
+
+/* broker methods */
+
+mem_broker_t::mem_broker_t(int total)
+    : _lock(thread_mutex_create()),
+      _total(total), _granted(0), _reserved(0), _waiting(0), _next_id(0),
+      _timer(NULL), _timer_cond(thread_cond_create()),
+      _requests(0), _downgrades(0), _waits(0),
+      _overcommits(0), _growths(0), _refusals(0)
+{
+}
+
+
+mem_broker_t* mem_broker_t::instance()
+{
+    critical_section_t cs(_instance_lock);
+    if (_instance == NULL) {
+        int pages = envVar::instance()->getVarInt("qpipe-mem-pages",
+                                                  MEM_BROKER_DEFAULT_PAGES);
+        if (pages < 0)
+            pages = MEM_BROKER_DEFAULT_PAGES;
+        _instance = new mem_broker_t(pages);
+        if (pages > 0)
+            TRACE(TRACE_ALWAYS, "QPipe memory budget (%d) pages\n", pages);
+    }
+    return _instance;
+}
+
+
+/* The pages not granted, nor kept for the admitted waiters. Negative
+   after a packet got its minimum over the budget. */
+int mem_broker_t::_free() const
+{
+    return (_total - _granted - _reserved);
+}
+
+
+/* What each packet would get if the budget was split evenly among the
+   packets that hold or wait for a grant. */
+int mem_broker_t::_fair_share() const
+{
+    int holders = _grants.size() + _waiting;
+    if (holders == 0)
+        return (_total);
+    int share = _total / holders;
+    return (share > MEM_BROKER_MIN_GRANT ? share : MEM_BROKER_MIN_GRANT);
+}
+
+
+/* Called with _lock held. Queues the caller and blocks it (a thread
+   on its condition variable, a coroutine parks) until _admit() keeps
+   'min' pages for it or the timer expires it. Returns true if it
+   expired. */
+bool mem_broker_t::_wait(int min)
+{
+    waiter_t waiter;
+    waiter._min = min;
+    waiter._deadline = now_ms() + MEM_BROKER_MAX_WAIT_MS;
+    waiter._coro = coro_t::self();
+    waiter._state = WS_WAITING;
+    if (waiter._coro == NULL)
+        waiter._cond = thread_cond_create();
+
+    if (_timer == NULL) {
+        _timer = new mem_broker_timer_t(this);
+        _timer->fork();
+    }
+    _waiters.push_back(&waiter);
+    _waiting++;
+    thread_cond_signal(_timer_cond);
+
+    while (waiter._state == WS_WAITING) {
+        if (waiter._coro == NULL)
+            thread_cond_wait(waiter._cond, _lock);
+        else
+            coro_t::park(_lock);
+    }
+
+    _waiting--;
+    if (waiter._coro == NULL)
+        pthread_cond_destroy(&waiter._cond);
+    if (waiter._state == WS_ADMITTED)
+        _reserved -= min;
+    return (waiter._state == WS_EXPIRED);
+}
+
+
+/* Called with _lock held, the waiter is off the queue. */
+void mem_broker_t::_wake(waiter_t* waiter, waiter_state_t state)
+{
+    waiter->_state = state;
+    if (waiter->_coro == NULL)
+        thread_cond_signal(waiter->_cond);
+    else
+        coro_t::wake(waiter->_coro);
+}
+
+
+/* Called with _lock held. Admits the waiters in arrival order, as long
+   as the minimum of the next one is free, and keeps that minimum for
+   it until it runs. */
+void mem_broker_t::_admit()
+{
+    while (!_waiters.empty() && (_free() >= _waiters.front()->_min)) {
+        waiter_t* waiter = _waiters.front();
+        _waiters.pop_front();
+        _reserved += waiter->_min;
+        _wake(waiter, WS_ADMITTED);
+    }
+}
+
+
+void mem_broker_t::expire_waiters()
+{
+    critical_section_t cs(_lock);
+    while (true) {
+        if (_waiters.empty()) {
+            thread_cond_wait(_timer_cond, _lock);
+            continue;
+        }
+
+        // the oldest waiter is the first to expire
+        long long left = _waiters.front()->_deadline - now_ms();
+        if (left > 0) {
+            thread_cond_wait(_timer_cond, _lock, (int)left);
+            continue;
+        }
+
+        waiter_t* waiter = _waiters.front();
+        _waiters.pop_front();
+        _wake(waiter, WS_EXPIRED);
+
+        // it held back the ones behind it
+        _admit();
+    }
+}
+
+
+int mem_broker_t::_acquire(const c_str &owner, int want, int min, int &id)
+{
+    if (min > want)
+        min = want;
+
+    critical_section_t cs(_lock);
+    _requests++;
+
+    int pages = want;
+    if (enabled()) {
+
+        // admission: wait, behind the earlier waiters, until at
+        // least the minimum is free
+        if (!_waiters.empty() || (_free() < min)) {
+            _waits++;
+            if (_wait(min)) {
+                TRACE(TRACE_DEBUG,
+                      "%s over the memory budget after (%d) ms\n",
+                      owner.data(), MEM_BROKER_MAX_WAIT_MS);
+                _overcommits++;
+            }
+        }
+
+        // downgrade to what is left
+        int avail = _free();
+        if (pages > avail)
+            pages = (avail > min ? avail : min);
+        if (pages < want)
+            _downgrades++;
+    }
+
+    id = ++_next_id;
+    grant_info_t &grant = _grants[id];
+    grant._owner = owner;
+    grant._wanted = want;
+    grant._pages = pages;
+    grant._downgraded = (pages < want);
+    _granted += pages;
+    return (pages);
+}
+
+
+int mem_broker_t::_grow(int id, int extra, bool force)
+{
+    critical_section_t cs(_lock);
+    grant_map_t::iterator it = _grants.find(id);
+    assert(it != _grants.end());
+    grant_info_t &grant = it->second;
+
+    // leave the free pages to the waiting packets, once we have our share
+    if (enabled() && !force) {
+        if ((_free() < extra) ||
+            ((_waiting > 0) && (grant._pages + extra > _fair_share())))
+        {
+            _refusals++;
+            return (0);
+        }
+    }
+
+    grant._pages += extra;
+    _granted += extra;
+    _growths++;
+    return (extra);
+}
+
+
+void mem_broker_t::_release(int id)
+{
+    critical_section_t cs(_lock);
+    grant_map_t::iterator it = _grants.find(id);
+    assert(it != _grants.end());
+    _granted -= it->second._pages;
+    _grants.erase(it);
+
+    // the waiters (if any) take what they need, the rest is there
+    // for the running packets to grow
+    _admit();
+}
+
+
+void mem_broker_t::print_grants()
+{
+    critical_section_t cs(_lock);
+    if (enabled())
+        TRACE(TRACE_ALWAYS, "Memory: (%d) of (%d) pages granted, (%d) waiting\n",
+              _granted, _total, _waiting);
+    else
+        TRACE(TRACE_ALWAYS, "Memory: (%d) pages granted, no budget\n",
+              _granted);
+
+    for (grant_map_t::iterator it = _grants.begin(); it != _grants.end(); ++it) {
+        grant_info_t &grant = it->second;
+        TRACE(TRACE_ALWAYS, "  (%d) %s: (%d) pages, (%d) wanted%s\n",
+              it->first, grant._owner.data(), grant._pages, grant._wanted,
+              (grant._downgraded ? ", downgraded" : ""));
+    }
+}
+
+
+void mem_broker_t::print_stats()
+{
+    critical_section_t cs(_lock);
+    TRACE(TRACE_STATISTICS,
+          "Memory broker: (%lld) requests, (%lld) downgraded, (%lld) waited, (%lld) over budget\n",
+          (long long)_requests, (long long)_downgrades,
+          (long long)_waits, (long long)_overcommits);
+    TRACE(TRACE_STATISTICS,
+          "Memory broker: (%lld) growths, (%lld) refused\n",
+          (long long)_growths, (long long)_refusals);
+}
+
+
+
+/* grant methods */
+
+int mem_grant_t::acquire(const c_str &owner, int want, int min)
+{
+    release();
+    _pages = mem_broker_t::instance()->_acquire(owner, want, min, _id);
+    return (_pages);
+}
+
+
+int mem_grant_t::grow(int extra, bool force)
+{
+    assert(_id);
+    int added = mem_broker_t::instance()->_grow(_id, extra, force);
+    _pages += added;
+    return (added);
+}
+
+
+void mem_grant_t::release()
+{
+    if (_id == 0)
+        return;
+    mem_broker_t::instance()->_release(_id);
+    _id = 0;
+    _pages = 0;
+}
+
+
+
+EXIT_NAMESPACE(qpipe);
@@ -105,4 +105,25 @@ packet_t::~packet_t(void) {
 
 
 
+/**
+ *  @brief The packets without producers have to report the versions
+ *  of what they read themselves.
+ */
+
+bool packet_t::get_versions(data_version_list_t &versions) {
+
+    std::vector<packet_t*> producers;
+    get_producers(producers);
+    if (producers.empty())
+        return false;
+
+    for (size_t i=0; i < producers.size(); i++) {
+        if (!producers[i]->get_versions(versions))
+            return false;
+    }
+    return true;
+}
+
+
+
 EXIT_NAMESPACE(qpipe);
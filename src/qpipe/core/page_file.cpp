@@ -0,0 +1,566 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+   
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+   
+                         All Rights Reserved.
+   
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+   
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+#include "qpipe/core/page_file.h"
+#include "util/tmpfile.h"
+
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+
+ENTER_NAMESPACE(qpipe);
+
+
+page_io_pool_t* page_io_pool_t::_instance = NULL;
+bool page_io_pool_t::_initialized = false;
+pthread_mutex_t page_io_pool_t::_instance_lock = thread_mutex_create();
+
+
+/* pread() and pwrite() may return short counts */
+
+static int pread_all(int fd, char* buf, size_t size, off_t offset)
+{
+    while (size > 0) {
+        ssize_t n = ::pread(fd, buf, size, offset);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return (errno);
+        }
+        if (n == 0)
+            return (EIO);       /* the pages were written */
+        buf += n;
+        size -= n;
+        offset += n;
+    }
+    return (0);
+}
+
+
+static int pwrite_all(int fd, const char* buf, size_t size, off_t offset)
+{
+    while (size > 0) {
+        ssize_t n = ::pwrite(fd, buf, size, offset);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return (errno);
+        }
+        buf += n;
+        size -= n;
+        offset += n;
+    }
+    return (0);
+}
+
+
+
+/* page file methods */
+
+page_file_t::page_file_t(const c_str &name, bool create)
+    : _name(name), _fd(-1), _page_size(get_default_page_size()),
+      _io(page_io_pool_t::instance()),
+      _buffer(NULL), _base(NULL),
+      _lock(thread_mutex_create()), _cond(thread_cond_create()),
+      _pages(0), _written(0),
+      _next_read(0), _read_ahead(false),
+      _busy(false), _error(0), _direct(false)
+{
+    int flags = (create ? (O_RDWR | O_CREAT | O_TRUNC) : O_RDONLY);
+#ifdef O_DIRECT
+    // not every file system supports it (tmpfs does not)
+    if (page_io_pool_t::direct()) {
+        _fd = ::open(name.data(), flags | O_DIRECT, 0600);
+        _direct = (_fd >= 0);
+    }
+#endif
+    if (_fd < 0)
+        _fd = ::open(name.data(), flags, 0600);
+    if (_fd < 0)
+        THROW3(FileException, "Caught %s while opening %s",
+               errno_to_str().data(), name.data());
+
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    if (!create) {
+        struct stat st;
+        if (fstat(_fd, &st) != 0)
+            THROW3(FileException, "Caught %s while reading the size of %s",
+                   errno_to_str().data(), name.data());
+        _pages = _written = st.st_size / _page_size;
+    }
+
+    int batch = std::max(PAGE_FILE_WRITE_BEHIND, PAGE_FILE_READ_AHEAD);
+    _buffer = (char*)aligned_alloc(batch * _page_size, PAGE_IO_ALIGN, &_base);
+    assert(_buffer != NULL);
+}
+
+
+page_file_t::~page_file_t()
+{
+    critical_section_t cs(_lock);
+    _read_ahead = false;
+    while (_busy)
+        _wait();
+    cs.exit();
+
+    // the writes that failed were not written
+    for (size_t i=0; i < _writes.size(); i++)
+        _writes[i]->free();
+    for (size_t i=0; i < _ready.size(); i++)
+        _ready[i]->free();
+    for (size_t i=0; i < _spares.size(); i++)
+        _spares[i]->free();
+
+    ::close(_fd);
+    free(_buffer);
+}
+
+
+page_file_t* page_file_t::create_tmp(c_str &name, const c_str &prefix)
+{
+    fclose(create_tmp_file(name, prefix));
+    return (new page_file_t(name, true));
+}
+
+
+/* Called with _lock held. The waits only depend on the I/O threads,
+   so a coroutine blocks its scheduler thread here, like it did on
+   the fread() of the tuple_fifo (whose lock it may be holding). */
+void page_file_t::_wait()
+{
+    thread_cond_wait(_cond, _lock);
+}
+
+
+/* Called with _lock held. */
+void page_file_t::_check_error()
+{
+    if (_error)
+        THROW3(FileException, "Caught %s doing I/O on %s",
+               errno_to_str(_error).data(), _name.data());
+}
+
+
+/* Called with _lock held. Only the pages already written are read. */
+bool page_file_t::_can_read_ahead() const
+{
+    return (_read_ahead && !_error
+            && (_ready.size() < (size_t)PAGE_FILE_READ_AHEAD)
+            && (_next_read + _ready.size() < _written));
+}
+
+
+/* Called with _lock held. */
+bool page_file_t::_has_work() const
+{
+    return (!_writes.empty() || _can_read_ahead());
+}
+
+
+/* Called with _lock held. Queues the file on the I/O threads, if it
+   has I/O to do and is not already queued. */
+void page_file_t::_schedule()
+{
+    if (_busy || !_has_work())
+        return;
+    _busy = true;
+    _io->submit(this);
+}
+
+
+/* Called with _lock held. Keeps a few written pages, so that the
+   writer does not allocate a new one for every page it writes. A
+   page may have been written as part of a list, write_swap() must
+   not hand back its stale link. */
+void page_file_t::_recycle(page* p)
+{
+    p->next = NULL;
+    if (_spares.size() < (size_t)PAGE_FILE_SPARES)
+        _spares.push_back(p);
+    else
+        p->free();
+}
+
+
+/* Some file systems accept O_DIRECT at open() but reject the I/O
+   with EINVAL. Drops O_DIRECT from the file, returns true if the I/O
+   should be retried buffered. Called without _lock, by the only
+   thread doing I/O on the file. */
+bool page_file_t::_drop_direct()
+{
+#ifdef O_DIRECT
+    if (!_direct)
+        return (false);
+    _direct = false;
+
+    int flags = fcntl(_fd, F_GETFL);
+    if ((flags < 0) || (fcntl(_fd, F_SETFL, flags & ~O_DIRECT) < 0))
+        return (false);
+    TRACE(TRACE_ALWAYS, "O_DIRECT I/O failed on %s, using buffered I/O\n",
+          _name.data());
+    return (true);
+#else
+    return (false);
+#endif
+}
+
+
+/* The batch is in the aligned buffer. Called without _lock. */
+int page_file_t::_write_pages(size_t first, size_t count)
+{
+    int err = pwrite_all(_fd, (const char*)_base, count * _page_size,
+                         (off_t)first * _page_size);
+    if ((err == EINVAL) && _drop_direct())
+        err = pwrite_all(_fd, (const char*)_base, count * _page_size,
+                         (off_t)first * _page_size);
+    return (err);
+}
+
+
+int page_file_t::_read_pages(size_t first, size_t count)
+{
+    int err = pread_all(_fd, (char*)_base, count * _page_size,
+                        (off_t)first * _page_size);
+    if ((err == EINVAL) && _drop_direct())
+        err = pread_all(_fd, (char*)_base, count * _page_size,
+                        (off_t)first * _page_size);
+    return (err);
+}
+
+
+/* Called with _lock held, by an I/O thread. Writes the queued pages
+   (up to PAGE_FILE_WRITE_BEHIND of them) with one call. */
+void page_file_t::_write_batch()
+{
+    size_t first = _written;
+    size_t count = std::min(_writes.size(), (size_t)PAGE_FILE_WRITE_BEHIND);
+
+    // The pages stay queued and nobody else touches them, but the
+    // writer may push more pages on the deque once we unlock.
+    std::vector<page*> pages(_writes.begin(), _writes.begin() + count);
+    thread_mutex_unlock(_lock);
+    for (size_t i=0; i < count; i++)
+        memcpy((char*)_base + i * _page_size, pages[i], _page_size);
+    int err = _write_pages(first, count);
+    thread_mutex_lock(_lock);
+
+    for (size_t i=0; i < count; i++) {
+        _recycle(_writes.front());
+        _writes.pop_front();
+    }
+    _written += count;
+    if (err && !_error)
+        _error = err;
+
+    _io->count_batch(true, count);
+}
+
+
+/* Called with _lock held, by an I/O thread. Reads the next written
+   pages (up to the read ahead window) with one call. */
+void page_file_t::_read_batch()
+{
+    size_t first = _next_read + _ready.size();
+    size_t count = std::min((size_t)PAGE_FILE_READ_AHEAD - _ready.size(),
+                            _written - first);
+
+    // The reader only removes pages from the front of _ready, so the
+    // pages we read still come right after the ones in it.
+    thread_mutex_unlock(_lock);
+    std::vector<page*> pages;
+    int err = _read_pages(first, count);
+    if (!err) {
+        page_pool* pool = malloc_page_pool::instance();
+        for (size_t i=0; i < count; i++) {
+            page* p = (page*)pool->alloc();
+            memcpy(p, (char*)_base + i * _page_size, _page_size);
+            p->_pool = pool;
+            p->next = NULL;
+            pages.push_back(p);
+        }
+    }
+    thread_mutex_lock(_lock);
+
+    _ready.insert(_ready.end(), pages.begin(), pages.end());
+    if (err && !_error)
+        _error = err;
+
+    _io->count_batch(false, count);
+}
+
+
+/* Called by an I/O thread. Does one batch, the writes first, since
+   the reader may be waiting for them. */
+void page_file_t::_serve()
+{
+    thread_mutex_lock(_lock);
+    if (!_writes.empty())
+        _write_batch();
+    else if (_can_read_ahead())
+        _read_batch();
+    thread_cond_broadcast(_cond);
+
+    if (_has_work()) {
+        // still _busy, the file cannot go away
+        thread_mutex_unlock(_lock);
+        _io->submit(this);
+        return;
+    }
+    _busy = false;
+    thread_mutex_unlock(_lock);
+}
+
+
+void page_file_t::write(page* p)
+{
+    assert(p->page_size() == _page_size);
+    critical_section_t cs(_lock);
+    _check_error();
+
+    if (_io == NULL) {
+        memcpy(_base, p, _page_size);
+        int err = _write_pages(_pages, 1);
+        if (err) {
+            p->free();
+            _error = err;
+            _check_error();
+        }
+        _recycle(p);
+        _pages++;
+        _written++;
+        return;
+    }
+
+    // write-behind, unless too many pages are queued already
+    if (_writes.size() >= (size_t)PAGE_FILE_WRITE_BEHIND) {
+        _io->count_stall();
+        while (_writes.size() >= (size_t)PAGE_FILE_WRITE_BEHIND) {
+            _schedule();
+            _wait();
+            _check_error();
+        }
+    }
+    _writes.push_back(p);
+    _pages++;
+    _schedule();
+}
+
+
+page* page_file_t::write_swap(page* p)
+{
+    size_t tuple_size = p->tuple_size();
+    write(p);
+
+    critical_section_t cs(_lock);
+    while (!_spares.empty()) {
+        page* spare = _spares.back();
+        _spares.pop_back();
+        if (spare->tuple_size() == tuple_size) {
+            spare->clear();
+            return (spare);
+        }
+        spare->free();
+    }
+    cs.exit();
+    return (page::alloc(tuple_size));
+}
+
+
+void page_file_t::flush()
+{
+    critical_section_t cs(_lock);
+    while (!_writes.empty() && !_error) {
+        _schedule();
+        _wait();
+    }
+    _check_error();
+}
+
+
+page* page_file_t::read()
+{
+    critical_section_t cs(_lock);
+    _check_error();
+    if (_next_read == _pages)
+        return (NULL);
+
+    if (_io == NULL) {
+        int err = _read_pages(_next_read, 1);
+        if (err) {
+            _error = err;
+            _check_error();
+        }
+        page_pool* pool = malloc_page_pool::instance();
+        page* p = (page*)pool->alloc();
+        memcpy(p, _base, _page_size);
+        p->_pool = pool;
+        p->next = NULL;
+        _next_read++;
+        return (p);
+    }
+
+    // from now on the file reads ahead of us
+    _read_ahead = true;
+    if (_ready.empty()) {
+        _io->count_stall();
+        while (_ready.empty()) {
+            _schedule();
+            _wait();
+            _check_error();
+        }
+    }
+
+    page* p = _ready.front();
+    _ready.pop_front();
+    _next_read++;
+    _schedule();
+    return (p);
+}
+
+
+
+/* I/O pool methods */
+
+page_io_pool_t::page_io_pool_t(int threads)
+    : _lock(thread_mutex_create()), _cond(thread_cond_create()),
+      _threads(threads),
+      _write_batches(0), _pages_written(0),
+      _read_batches(0), _pages_read(0), _stalls(0)
+{
+    for (int i = 0; i < threads; i++) {
+        thread_t* thread = member_func_thread(this, &page_io_pool_t::work,
+                                              c_str("PAGE_IO_%d", i));
+#ifdef USE_SMTHREAD_AS_BASE
+        thread->fork();
+#else
+        thread_create(thread);
+#endif
+    }
+}
+
+
+page_io_pool_t* page_io_pool_t::instance()
+{
+    critical_section_t cs(_instance_lock);
+    if (!_initialized) {
+        _initialized = true;
+        direct();   // checks the page size once, at startup
+        int threads = envVar::instance()->getVarInt("qpipe-io-threads",
+                                                    PAGE_IO_DEFAULT_THREADS);
+        if (threads > 0) {
+            _instance = new page_io_pool_t(threads);
+            TRACE(TRACE_ALWAYS, "Started (%d) page I/O threads%s\n", threads,
+                  (direct() ? ", O_DIRECT" : ""));
+        }
+    }
+    return _instance;
+}
+
+
+/* O_DIRECT needs the sizes and offsets of the I/O aligned, and they
+   are multiples of the page size */
+static bool direct_enabled()
+{
+    if (!envVar::instance()->getVarInt("qpipe-io-direct", 0))
+        return (false);
+    size_t page_size = get_default_page_size();
+    if (page_size % PAGE_IO_ALIGN) {
+        TRACE(TRACE_ALWAYS,
+              "The page size (%lu) is not a multiple of (%d), no O_DIRECT\n",
+              (unsigned long)page_size, PAGE_IO_ALIGN);
+        return (false);
+    }
+    return (true);
+}
+
+
+bool page_io_pool_t::direct()
+{
+    static bool direct = direct_enabled();
+    return (direct);
+}
+
+
+void page_io_pool_t::submit(page_file_t* file)
+{
+    critical_section_t cs(_lock);
+    _queue.push_back(file);
+    thread_cond_signal(_cond);
+}
+
+
+void page_io_pool_t::work()
+{
+    while (1) {
+        critical_section_t cs(_lock);
+        while (_queue.empty())
+            thread_cond_wait(_cond, _lock);
+        page_file_t* file = _queue.front();
+        _queue.pop_front();
+        cs.exit();
+
+        file->_serve();
+    }
+}
+
+
+void page_io_pool_t::count_batch(bool write, size_t pages)
+{
+    critical_section_t cs(_lock);
+    if (write) {
+        _write_batches++;
+        _pages_written += pages;
+    }
+    else {
+        _read_batches++;
+        _pages_read += pages;
+    }
+}
+
+
+void page_io_pool_t::count_stall()
+{
+    critical_section_t cs(_lock);
+    _stalls++;
+}
+
+
+void page_io_pool_t::print_stats()
+{
+    critical_section_t cs(_lock);
+    TRACE(TRACE_STATISTICS,
+          "Page I/O: (%lld) pages written in (%lld) batches, (%lld) pages read in (%lld) batches\n",
+          (long long)_pages_written, (long long)_write_batches,
+          (long long)_pages_read, (long long)_read_batches);
+    TRACE(TRACE_STATISTICS, "Page I/O: (%lld) stalls\n",
+          (long long)_stalls);
+}
+
+
+
+EXIT_NAMESPACE(qpipe);
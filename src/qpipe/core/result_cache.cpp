@@ -0,0 +1,269 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+   
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+   
+                         All Rights Reserved.
+   
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+   
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+#include "qpipe/core/result_cache.h"
+
+#include <string>
+
+
+ENTER_NAMESPACE(qpipe);
+
+
+result_cache_t* result_cache_t::_instance = NULL;
+pthread_mutex_t result_cache_t::_instance_lock = thread_mutex_create();
+
+
+static void free_pages(std::vector<page*> &pages)
+{
+    for (size_t i=0; i < pages.size(); i++)
+        pages[i]->free();
+    pages.clear();
+}
+
+
+/* The action of the plan followed by the filters and the plans of its
+   children, the same fields is_compatible() compares. */
+static bool append_plan(std::string &key, query_plan const* plan)
+{
+    key += plan->action.data();
+    key += "(";
+    for (int i=0; i < plan->child_count; i++) {
+        query_plan const* child = plan->child_plans[i];
+        if (child == NULL)
+            return (false);
+        key += child->filter.data();
+        key += ":";
+        if (!append_plan(key, child))
+            return (false);
+        key += ";";
+    }
+    key += ")";
+    return (true);
+}
+
+
+
+/* cache methods */
+
+result_cache_t::result_cache_t(size_t capacity)
+    : _lock(thread_mutex_create()),
+      _capacity(capacity), _used(0),
+      _lookups(0), _hits(0), _stale(0), _inserts(0), _evictions(0)
+{
+}
+
+
+result_cache_t* result_cache_t::instance()
+{
+    critical_section_t cs(_instance_lock);
+    if (_instance == NULL) {
+        int mb = envVar::instance()->getVarInt("qpipe-result-cache-mb",
+                                               RESULT_CACHE_DEFAULT_MB);
+        if (mb < 0)
+            mb = RESULT_CACHE_DEFAULT_MB;
+        _instance = new result_cache_t((size_t)mb << 20);
+        if (mb > 0)
+            TRACE(TRACE_ALWAYS, "QPipe result cache (%d) MB\n", mb);
+    }
+    return _instance;
+}
+
+
+bool result_cache_t::signature(packet_t* packet, c_str &key,
+                               data_version_list_t &versions)
+{
+    query_plan const* plan = packet->plan();
+    if (plan == NULL)
+        return (false);
+
+    // The table scans read the buffer pool (or an in-memory copy of
+    // the table) anyway, only the work done over them is worth saving
+    std::vector<packet_t*> producers;
+    packet->get_producers(producers);
+    if (producers.empty())
+        return (false);
+
+    std::string str(packet->_packet_type.data());
+    str += ":";
+    if (!append_plan(str, plan))
+        return (false);
+
+    versions.clear();
+    if (!packet->get_versions(versions))
+        return (false);
+
+    key = c_str("%s", str.c_str());
+    return (true);
+}
+
+
+/* Called with _lock held. Drops the cache's reference to the entry,
+   the readers may still hold theirs. */
+void result_cache_t::_remove(entry_map_t::iterator it)
+{
+    entry_t* entry = *(it->second);
+    _lru.erase(it->second);
+    _entries.erase(it);
+    _used -= entry->_bytes;
+    _unref(entry);
+}
+
+
+/* Called with _lock held. */
+void result_cache_t::_unref(entry_t* entry)
+{
+    if (--entry->_refs > 0)
+        return;
+    free_pages(entry->_pages);
+    delete entry;
+}
+
+
+result_cache_t::entry_t* result_cache_t::acquire(const c_str &key,
+                                                 const data_version_list_t &versions)
+{
+    critical_section_t cs(_lock);
+    _lookups++;
+
+    entry_map_t::iterator it = _entries.find(key);
+    if (it == _entries.end())
+        return (NULL);
+
+    // Same plan, so the same tables. Some of them was written since?
+    entry_t* entry = *(it->second);
+    assert(entry->_versions.size() == versions.size());
+    for (size_t i=0; i < versions.size(); i++) {
+        if (entry->_versions[i].version != versions[i].version) {
+            _stale++;
+            _remove(it);
+            return (NULL);
+        }
+    }
+
+    // move it to the front of the LRU list
+    _lru.splice(_lru.begin(), _lru, it->second);
+    entry->_refs++;
+    _hits++;
+    return (entry);
+}
+
+
+void result_cache_t::release(entry_t* entry)
+{
+    critical_section_t cs(_lock);
+    _unref(entry);
+}
+
+
+void result_cache_t::insert(const c_str &key, const data_version_list_t &versions,
+                            result_capture_t &capture)
+{
+    assert(capture.active());
+
+    // The output may mix rows from before and after a write
+    for (size_t i=0; i < versions.size(); i++) {
+        if (!versions[i].current()) {
+            capture.abandon();
+            return;
+        }
+    }
+
+    entry_t* entry = new entry_t;
+    entry->_key = key;
+    entry->_versions = versions;
+    entry->_pages.swap(capture._pages);
+    entry->_bytes = capture._bytes;
+    entry->_refs = 1;
+    capture.abandon();
+
+    critical_section_t cs(_lock);
+
+    // an identical packet may have completed first
+    entry_map_t::iterator it = _entries.find(key);
+    if (it != _entries.end())
+        _remove(it);
+
+    // evict the least recently used entries to make room
+    while (!_lru.empty() && (_used + entry->_bytes > _capacity)) {
+        _evictions++;
+        _remove(_entries.find(_lru.back()->_key));
+    }
+
+    _lru.push_front(entry);
+    _entries[key] = _lru.begin();
+    _used += entry->_bytes;
+    _inserts++;
+}
+
+
+void result_cache_t::print_stats()
+{
+    critical_section_t cs(_lock);
+    TRACE(TRACE_STATISTICS,
+          "Result cache: (%lld) lookups, (%lld) hits, (%lld) stale, (%lld) inserts, (%lld) evictions\n",
+          (long long)_lookups, (long long)_hits, (long long)_stale,
+          (long long)_inserts, (long long)_evictions);
+    TRACE(TRACE_STATISTICS,
+          "Result cache: (%d) entries, (%lld) of (%lld) KB used\n",
+          (int)_entries.size(), (long long)(_used >> 10),
+          (long long)(_capacity >> 10));
+}
+
+
+
+/* capture methods */
+
+void result_capture_t::append(page* p)
+{
+    if (!_active || p->empty())
+        return;
+
+    if (_bytes + p->page_size() > _limit) {
+        // too big to be worth the space
+        abandon();
+        return;
+    }
+
+    // The page may be of another pool, with a different size
+    page* copy = NULL;
+    for (size_t i=0; i < p->tuple_count(); i++) {
+        if ((copy == NULL) || copy->full()) {
+            copy = page::alloc(p->tuple_size());
+            _pages.push_back(copy);
+            _bytes += copy->page_size();
+        }
+        copy->append_tuple(p->get_tuple(i));
+    }
+}
+
+
+void result_capture_t::abandon()
+{
+    free_pages(_pages);
+    _bytes = 0;
+    _active = false;
+}
+
+
+
+EXIT_NAMESPACE(qpipe);
@@ -23,6 +23,7 @@
 
 #include "qpipe/core/stage_container.h"
 #include "qpipe/core/dispatcher.h"
+#include "qpipe/core/coro_sched.h"
 #include "util.h"
 
 #include <cstdio>
@@ -81,15 +82,22 @@ void* stage_container_t::static_run_stage_wrapper(stage_t* stage,
  *  this string, so the caller should deallocate it if necessary.
  */
 stage_container_t::stage_container_t(const c_str &container_name,
-				     stage_factory_t* stage_maker, int active_count, int max_count)
+				     stage_factory_t* stage_maker, int active_count, int max_count,
+                                     bool coro)
     : _container_lock(thread_mutex_create()),
       _container_queue_nonempty(thread_cond_create()),
       _container_name(container_name), _stage_maker(stage_maker),
       _pool(active_count),
       _max_threads((max_count > active_count)? max_count : std::max(10, active_count * 4)),
       _next_thread(0),
+      _coro(coro),
       _rp(&_container_lock._lock, 0, container_name)
 {
+    if (_coro) {
+        // coroutines are cheap, the limit is only a sanity check
+        _max_threads = std::max(_max_threads, 1 << 16);
+        coro_pool_t::instance();
+    }
 }
 
 
@@ -138,7 +146,10 @@ struct stage_thread : public thread_t
  */
 void stage_container_t::container_queue_enqueue_no_merge(packet_list_t* packets) {
     _container_queue.push_back(packets);
-    thread_cond_signal(_container_queue_nonempty);
+    if (_coro)
+        coro_pool_t::instance()->spawn(&stage_container_t::_run_coro, this);
+    else
+        thread_cond_signal(_container_queue_nonempty);
 }
 
 
@@ -190,6 +201,12 @@ packet_list_t* stage_container_t::container_queue_dequeue() {
 
 void stage_container_t::create_worker() 
 {    
+    if (_coro) {
+        // the coroutine is spawned with its packet list
+        _rp.notify_capacity_increase(1);
+        return;
+    }
+
     // create another worker thread
     _next_thread++;
     c_str thread_name("%s_THREAD_%d", _container_name.data(), _next_thread);
@@ -454,57 +471,94 @@ void stage_container_t::run() {
         // * * * BEGIN CRITICAL SECTION * * *
 
 	packet_list_t* packets = container_queue_dequeue();
+        _run_packets(packets, cs);
+        
+	// TODO: check for container shutdown
+    }
+}
 
-	// error checking
-	assert( packets != NULL );
-	assert( !packets->empty() );
-        if (TRACE_DEQUEUE) {
-            packet_t* head_packet = *(packets->begin());
-            TRACE(TRACE_ALWAYS, "Processing %s\n",
-                  head_packet->_packet_id.data());
-        }
 
 
-        // Construct an adaptor to work with. If this is expensive, we
-        // can construct the adaptor before the dequeue and invoke
-        // some init() function to initialize the adaptor with the
-        // packet list.
-	stage_adaptor_t
-            adaptor(this,
-                    packets,
-                    packets->front()->_output_filter->input_tuple_size());
+/**
+ *  @brief The body of a worker coroutine. It processes the packet list
+ *  it was spawned for and returns.
+ *
+ *  THE CALLER MUST NOT BE HOLDING THE _container_lock MUTEX.
+ */
+void stage_container_t::run_one() {
+
+    critical_section_t cs(_container_lock);
+    // * * * BEGIN CRITICAL SECTION * * *
+
+    // Every enqueue spawns one coroutine, so there is a list for us
+    // (not necessarily the same one).
+    assert( !_container_queue.empty() );
+    packet_list_t* packets = container_queue_dequeue();
+    _run_packets(packets, cs);
+}
+
+
+void stage_container_t::_run_coro(void* container) {
+    ((stage_container_t*)container)->run_one();
+}
+
+
+
+/**
+ *  @brief Runs a stage for a packet list dequeued by the caller.
+ *
+ *  THE CALLER MUST BE HOLDING THE _container_lock MUTEX, THROUGH
+ *  'cs'. IT IS RELEASED WHILE THE STAGE RUNS.
+ */
+void stage_container_t::_run_packets(packet_list_t* packets,
+                                     critical_section_t &cs) {
+
+    // error checking
+    assert( packets != NULL );
+    assert( !packets->empty() );
+    if (TRACE_DEQUEUE) {
+        packet_t* head_packet = *(packets->begin());
+        TRACE(TRACE_ALWAYS, "Processing %s\n",
+              head_packet->_packet_id.data());
+    }
+
+
+    // Construct an adaptor to work with. If this is expensive, we
+    // can construct the adaptor before the dequeue and invoke
+    // some init() function to initialize the adaptor with the
+    // packet list.
+    stage_adaptor_t
+        adaptor(this,
+                packets,
+                packets->front()->_output_filter->input_tuple_size());
 
         
-	// Add new stage to the container's list of active stages. It
-	// is better to release the container lock and reacquire it
-	// here since stage construction can take a long time.
-        _container_current_stages.push_back(&adaptor);
+    // Add new stage to the container's list of active stages. It
+    // is better to release the container lock and reacquire it
+    // here since stage construction can take a long time.
+    _container_current_stages.push_back(&adaptor);
 
-        /* Becomes non-idle. Note that we don't become non-idle in
-           this method. We do it in cleanup() since we must do it
-           before deciding whether to unreserve ourselves. */
-        _rp.notify_non_idle();
+    /* Becomes non-idle. Note that we don't become non-idle in
+       this method. We do it in cleanup() since we must do it
+       before deciding whether to unreserve ourselves. */
+    _rp.notify_non_idle();
 
-        // * * * END CRITICAL SECTION * * *
-	cs.exit();
+    // * * * END CRITICAL SECTION * * *
+    cs.exit();
 
         
-        // create stage
-        guard<stage_t> stage = _stage_maker->create_stage();
-        adaptor.run_stage(stage);
+    // create stage
+    guard<stage_t> stage = _stage_maker->create_stage();
+    adaptor.run_stage(stage);
 
 	
-        // remove active stage
-	critical_section_t cs_remove_active_stage(_container_lock);
-        // * * * BEGIN CRITICAL SECTION * * *
-        _container_current_stages.remove(&adaptor);
-        /* should have marked ourselves non-idle in cleanup */
-        // * * * END CRITICAL SECTION * * *
-	cs_remove_active_stage.exit();
-        
-        
-	// TODO: check for container shutdown
-    }
+    // remove active stage
+    critical_section_t cs_remove_active_stage(_container_lock);
+    // * * * BEGIN CRITICAL SECTION * * *
+    _container_current_stages.remove(&adaptor);
+    /* should have marked ourselves non-idle in cleanup */
+    // * * * END CRITICAL SECTION * * *
+    cs_remove_active_stage.exit();
 }
 
 
@@ -671,6 +725,8 @@ void stage_container_t::stage_adaptor_t::output_page(page* p) {
     // Any new packets which merge after this point will not 
     // receive this page.
     
+    if (_capture.active())
+        _capture.append(p);
 
     page::iterator pend = p->end();
     bool packets_remaining = false;
@@ -685,20 +741,32 @@ void stage_container_t::stage_adaptor_t::output_page(page* p) {
             
             // Drain all tuples in output page into the current packet's
             // output buffer.
-            page::iterator page_it = p->begin();
-            while(page_it != pend) {
-
-                // apply current packet's filter to this tuple
-                tuple_t in_tup = page_it.advance();
-                if(output_filter->select(in_tup)) {
+            if(output_filter->batch_select()) {
 
-                    // this tuple selected by filter!
-
-                    // allocate space in the output buffer and project into it
+                // select the whole page, then project the survivors
+                size_t count = output_filter->select_page(p, _selection);
+                for(size_t i=0; i < count; i++) {
+                    tuple_t in_tup = p->get_tuple(_selection[i]);
                     tuple_t out_tup = output_buffer->allocate();
                     output_filter->project(out_tup, in_tup);
                 }
             }
+            else {
+                page::iterator page_it = p->begin();
+                while(page_it != pend) {
+
+                    // apply current packet's filter to this tuple
+                    tuple_t in_tup = page_it.advance();
+                    if(output_filter->select(in_tup)) {
+
+                        // this tuple selected by filter!
+
+                        // allocate space in the output buffer and project into it
+                        tuple_t out_tup = output_buffer->allocate();
+                        output_filter->project(out_tup, in_tup);
+                    }
+                }
+            }
             
 
             // If this packet has run more than once, it may have received
@@ -775,6 +843,26 @@ void stage_container_t::stage_adaptor_t::finish_packet(packet_t* packet) {
 
 
 
+/**
+ *  @brief The producers of a packet that is answered from the result
+ *  cache are never dispatched. Unreserve the workers reserved for
+ *  them, as enqueue() does for the packets that merge.
+ */
+static void release_producers(packet_t* packet) {
+
+    std::vector<packet_t*> producers;
+    packet->get_producers(producers);
+    for (size_t i=0; i < producers.size(); i++) {
+        if (!producers[i]->unreserve_worker_on_completion())
+            continue;
+        guard<dispatcher_t::worker_releaser_t> wr = dispatcher_t::releaser_acquire();
+        producers[i]->declare_worker_needs(wr);
+        wr->release_resources();
+    }
+}
+
+
+
 /**
  *  @brief When a worker thread dequeues a new packet list from the
  *  container queue, it should create a stage_adaptor_t around that
@@ -795,13 +883,37 @@ void stage_container_t::stage_adaptor_t::run_stage(stage_t* stage) {
     // error checking
     assert( stage != NULL );
 
+
+    // Check whether the result of an identical plan is cached. If
+    // not, copy our output in case we get to complete it.
+    result_cache_t* rc = result_cache_t::instance();
+    result_cache_t::entry_t* cached = NULL;
+    c_str key;
+    data_version_list_t versions;
+    if (rc->enabled() && result_cache_t::signature(_packet, key, versions)) {
+        cached = rc->acquire(key, versions);
+        if (cached == NULL)
+            _capture.start(rc->max_entry_bytes());
+    }
+
     
     // run stage-specific processing function
     bool error = false;
+    bool completed = false;
     try {
-        stage->init(this);
-        stage->process();
-        flush();
+        if (cached != NULL) {
+            TRACE(TRACE_WORK_SHARING, "%s answered from the result cache\n",
+                  _packet->_packet_id.data());
+            release_producers(_packet);
+            for (size_t i=0; i < cached->_pages.size(); i++)
+                output_page(cached->_pages[i]);
+        }
+        else {
+            stage->init(this);
+            stage->process();
+            flush();
+        }
+        completed = true;
     } catch(stop_exception &) {
         // no error
         TRACE(TRACE_DEBUG, "process() ended early\n");
@@ -814,6 +926,16 @@ void stage_container_t::stage_adaptor_t::run_stage(stage_t* stage) {
         assert(false);
     }
 
+    if (cached != NULL)
+        rc->release(cached);
+    else if (_capture.active()) {
+        // only the complete output is reused
+        if (completed)
+            rc->insert(key, versions, _capture);
+        else
+            _capture.abandon();
+    }
+
     // if we are still accepting packets, stop now
     stop_accepting_packets();
     if(error)
@@ -23,6 +23,7 @@
 
 #include "qpipe/core/tuple_fifo.h"
 #include "qpipe/core/tuple_fifo_directory.h"
+#include "qpipe/core/page_file.h"
 #include "util/trace.h"
 #include "util/acounter.h"
 #include <algorithm>
@@ -198,6 +199,12 @@ void tuple_fifo::destroy() {
 
     std::for_each(_pages.begin(), _pages.end(), free_page());
     std::for_each(_free_pages.begin(), _free_pages.end(), free_page());
+    if (_page_file != NULL) {
+        c_str filepath = _page_file->name();
+        delete _page_file;
+        _page_file = NULL;
+        ::remove(filepath.data());
+    }
 	
     /* update stats */
     critical_section_t cs(tuple_fifo_stats_mutex);
@@ -314,8 +321,8 @@ bool tuple_fifo::terminate() {
     // make sure nobody is sleeping (either the reader or writer could
     // be calling this)
     _state.transition(tuple_fifo_state_t::TERMINATED);
-    thread_cond_signal(_reader_notify);
-    thread_cond_signal(_writer_notify);
+    ensure_reader_running();
+    ensure_writer_running();
     
     // * * * END CRITICAL SECTION * * *
     return true;
@@ -325,22 +332,56 @@ bool tuple_fifo::terminate() {
 
 /* definitions of helper methods */
 
+/* A coroutine parks instead of blocking its scheduler thread. The
+   wake-ups are under _lock, like the signals, so neither is lost. */
+
 inline void tuple_fifo::wait_for_reader() {
     _num_waits_on_insert++;
-    thread_cond_wait(_writer_notify, _lock);
+    coro_t* self = coro_t::self();
+    if (self == NULL) {
+        thread_cond_wait(_writer_notify, _lock);
+        return;
+    }
+    _writer_coro = self;
+    coro_t::park(_lock);
 }
 
 inline void tuple_fifo::ensure_reader_running() {
     thread_cond_signal(_reader_notify);
+    if (_reader_coro != NULL) {
+        coro_t* reader = _reader_coro;
+        _reader_coro = NULL;
+        coro_t::wake(reader);
+    }
 }
 
 inline bool tuple_fifo::wait_for_writer(int timeout_ms) {
     _num_waits_on_remove++;
-    return thread_cond_wait(_reader_notify, _lock, timeout_ms);
+    coro_t* self = coro_t::self();
+    if (self == NULL)
+        return thread_cond_wait(_reader_notify, _lock, timeout_ms);
+
+    if (timeout_ms == 0) {
+        _reader_coro = self;
+        coro_t::park(_lock);
+        return true;
+    }
+
+    /* There are no timers. A timed wait lets the other coroutines run
+       once and then reports a timeout. */
+    thread_mutex_unlock(_lock);
+    coro_t::yield();
+    thread_mutex_lock(_lock);
+    return false;
 }
 
 inline void tuple_fifo::ensure_writer_running() {
     thread_cond_signal(_writer_notify);
+    if (_writer_coro != NULL) {
+        coro_t* writer = _writer_coro;
+        _writer_coro = NULL;
+        coro_t::wake(writer);
+    }
 }
 
 
@@ -416,16 +457,13 @@ void tuple_fifo::_flush_write_page(bool done_writing) {
         /* If we are here, we need to flush to disk. */
         /* Create on disk file. */
         c_str filepath = tuple_fifo_directory_t::generate_filepath(_fifo_id);
-        _page_file = fopen(filepath.data(), "w+");
-        assert(_page_file != NULL);
-        if (_page_file == NULL)
-            THROW2(FileException,
-                   "fopen(%s) failed", filepath.data());
+        _page_file = new page_file_t(filepath, true);
         TRACE(TRACE_ALWAYS, "Created tuple_fifo file %s\n",
               filepath.data());
         
         /* Append this page to _pages and flush the entire
-           page_list to disk. */
+           page_list to disk. The page file writes them behind us
+           and frees them. */
         if(!_write_page->empty()) {
             _pages.push_back(_write_page.release());
             _pages_in_memory++;
@@ -433,17 +471,12 @@ void tuple_fifo::_flush_write_page(bool done_writing) {
         }
         for (page_list::iterator it = _pages.begin(); it != _pages.end(); ) {
             qpipe::page* p = *it;
-            p->fwrite_full_page(_page_file);
-
-            /* done with page */
-            p->clear();
-            _free_pages.push_back(p);
             it = _pages.erase(it);
+            _page_file->write(p);
 
             assert(_pages_in_memory > 0);
             _pages_in_memory--;
         }
-        fflush(_page_file);
         
         /* update _file_head_page */
         assert(_file_head_page == 0);
@@ -455,25 +488,9 @@ void tuple_fifo::_flush_write_page(bool done_writing) {
             _state.transition(tuple_fifo_state_t::ON_DISK_DONE_WRITING);
             _write_page.done();
         }
-        else {
-            /* allocate from free list */
-            assert(!_free_pages.empty());
+        else
             _write_page = _alloc_page();
 
-            /* TODO It's clear whether we want to replace the
-               SENTINAL_PAGE here. On the one hand, if we can replace
-               it, we can free the rest of the pages in the free
-               list. On the other, we still need to check for the
-               SENTINAL_PAGE in _get_read_page since pages may be
-               removed using get_page (instead of tuples removed with
-               get_tuple). */
-            if (_read_page == SENTINEL_PAGE) {
-                _set_read_page(_alloc_page());
-                /* After this point, we should not release either of
-                   these pages. */
-            }
-        }
-
         /* wake the reader if necessary */
         if(_available_fifo_reads() >= _threshold || is_done_writing())
             ensure_reader_running();
@@ -484,21 +501,15 @@ void tuple_fifo::_flush_write_page(bool done_writing) {
         
     case tuple_fifo_state_t::ON_DISK: {
 
-        int fseek_ret = fseek(_page_file, 0, SEEK_END);
-        assert(!fseek_ret);
-        if (fseek_ret)
-            THROW1(FileException, "fseek to EOF");
-        _write_page->fwrite_full_page(_page_file);
-        fflush(_page_file);
         _pages_in_fifo++;
 
         if (done_writing) {
+            _page_file->write(_write_page.release());
             _state.transition(tuple_fifo_state_t::ON_DISK_DONE_WRITING);
-            _write_page.done();
         }
         else {
-            /* simply reuse write page */
-            _write_page->clear();
+            /* the page file hands back a written page to reuse */
+            _write_page = _page_file->write_swap(_write_page.release());
         }
         
         /* wake the reader if necessary */
@@ -596,40 +607,15 @@ int tuple_fifo::_get_read_page(int timeout_ms) {
     case tuple_fifo_state_t::ON_DISK:
     case tuple_fifo_state_t::ON_DISK_DONE_WRITING: {
 
-        /* We are on disk. We should not be releasing _read_page after
-           iterating over its entries. However, we still need to be
-           prepared against code which extracts pages from the
-           tuple_fifo using get_page(). get_page() sets _read_page to
-           the SENTINEL_PAGE. */
-        if (_read_page == SENTINEL_PAGE)
-            _set_read_page(_alloc_page());
-        else {
-            /* We are reusing the same read page... do a reset */
-            _read_page->clear();
-            _set_read_page(_read_page.release());
-        }
-
-
-        /* Make sure that at this point, we are not dealing with the
-           SENTINAL_PAGE. */
-        assert(_read_page != SENTINEL_PAGE);
-        assert(_read_page->page_size() == malloc_page_pool::instance()->page_size());
-
-
-        /* read page from disk file */
-        _read_page->clear();
+        /* We are on disk. The page file reads ahead of us and
+           hands us a new page, setting it frees the previous one (or
+           drops the SENTINEL_PAGE left by get_page()). */
         TRACE(TRACE_ALWAYS&TRACE_MASK_DISK, "_next_page = %d\n", (int)_next_page);
         TRACE(TRACE_ALWAYS&TRACE_MASK_DISK, "_file_head_page = %d\n", (int)_file_head_page);
-        unsigned long seek_pos =
-            (_next_page - _file_head_page) * get_default_page_size();
-        TRACE(TRACE_ALWAYS&TRACE_MASK_DISK, "fseek to %lu\n", seek_pos);
-        int fseek_ret = fseek(_page_file, seek_pos, SEEK_SET);
-        assert(!fseek_ret);
-        if (fseek_ret)
-            THROW2(FileException, "fseek to %lu", seek_pos);
-        int fread_ret = _read_page->fread_full_page(_page_file);
-        assert(fread_ret);
-        _set_read_page(_read_page.release());
+        page* disk_page = _page_file->read();
+        assert(disk_page != NULL);
+        _set_read_page(disk_page);
+        assert(_read_page->page_size() == malloc_page_pool::instance()->page_size());
 
 
         size_t page_size = _read_page->page_size();
@@ -30,8 +30,10 @@
 #include <cstring>
 #include <unistd.h>
 #include <cerrno>
+#include <algorithm>
 
 #include "util.h"
+#include "util/topology.h"
 #include "qpipe/scheduler/cpu_set.h"
 #include "qpipe/scheduler/cpu_set_struct.h"
 #include "qpipe/scheduler/os_support.h"
@@ -45,6 +47,7 @@ ENTER_NAMESPACE(qpipe);
 
 static void cpu_set_copy( os_cpu_set_t* dst, os_cpu_set_t* src );
 static void cpu_set_init_Linux(cpu_set_p cpu_set);
+static int  cpu_set_sort_by_topology_Linux(cpu_set_p cpu_set);
 
 #else
 /* Sun Solaris */
@@ -142,6 +145,34 @@ cpu_t cpu_set_get_cpu(cpu_set_p cpu_set, int index)
 
 
 
+/**
+ *  @brief Reorder the CPUs of the set so that the SMT siblings of a
+ *  core are next to each other, then the cores that share a
+ *  last-level cache, then the NUMA nodes. Consecutive indices are
+ *  then as close as the machine allows.
+ *
+ *  @param cpu_set The CPU set.
+ *
+ *  @return The number of CPUs that share a last-level cache (the
+ *  smallest such group). 1 if the topology is not known, in which
+ *  case the order is not changed.
+ */
+int cpu_set_sort_by_topology(cpu_set_p cpu_set)
+{
+  /* error checks */
+  if ( cpu_set == NULL )
+    THROW1(QPipeException, "Called with NULL cpu_set_t");
+
+#ifdef FOUND_LINUX
+  return cpu_set_sort_by_topology_Linux( cpu_set );
+#else
+  return 1;
+#endif
+}
+
+
+
+
 /**
  *  @brief Destroy all resources allocated for this CPU set. Should be
  *  called on a CPU set when it is no longer needed.
@@ -185,6 +216,92 @@ static void cpu_set_copy( os_cpu_set_t* dst, os_cpu_set_t* src )
 }
 
 
+/**
+ *  @brief Where a CPU of the set sits in the machine, for sorting.
+ */
+struct cpu_place_s
+{
+  const cpu_desc_t* desc;
+  int index;     /* in the cpu set */
+
+  bool operator<(const cpu_place_s &other) const {
+    const cpu_desc_t &a = *desc;
+    const cpu_desc_t &b = *other.desc;
+    if ( a._node   != b._node   ) return a._node   < b._node;
+    if ( a._llc    != b._llc    ) return a._llc    < b._llc;
+    if ( a._socket != b._socket ) return a._socket < b._socket;
+    if ( a._core   != b._core   ) return a._core   < b._core;
+    return a._id < b._id;
+  }
+};
+
+
+/**
+ *  @brief Linux-specific version of cpu_set_sort_by_topology(). The
+ *  topology is the one read from sysfs by cpu_topology_t.
+ *
+ *  @param cpu_set The CPU set.
+ *
+ *  @return The smallest number of CPUs that share a last-level cache.
+ */
+static int cpu_set_sort_by_topology_Linux(cpu_set_p cpu_set)
+{
+  int i;
+  int num_cpus = cpu_set->cpuset_num_cpus;
+  if ( num_cpus == 0 )
+    return 1;
+
+  cpu_topology_t* topology = cpu_topology_t::instance();
+  if ( !topology->from_sysfs() )
+  {
+    TRACE( TRACE_ALWAYS, "No sysfs topology, keeping the CPU order\n" );
+    return 1;
+  }
+
+  array_guard_t<struct cpu_place_s> place = new cpu_place_s[num_cpus];
+  for (i = 0; i < num_cpus; i++)
+  {
+    int id = cpu_set->cpuset_cpus[i].cpu_unique_id;
+    if ( (id >= topology->cpu_count()) || (topology->cpu(id)._id != id) )
+    {
+      TRACE( TRACE_ALWAYS, "No sysfs topology for CPU %d, keeping the CPU order\n",
+             id );
+      return 1;
+    }
+    place[i].desc = &topology->cpu(id);
+    place[i].index = i;
+  }
+
+  std::sort( &place[0], &place[0] + num_cpus );
+
+  /* reorder the cpus */
+  array_guard_t<struct cpu_s> cpus = new cpu_s[num_cpus];
+  for (i = 0; i < num_cpus; i++)
+    cpus[i] = cpu_set->cpuset_cpus[ place[i].index ];
+  for (i = 0; i < num_cpus; i++)
+    cpu_set->cpuset_cpus[i] = cpus[i];
+
+  /* the smallest group that shares a last-level cache */
+  int llc_size = num_cpus;
+  int run = 1;
+  for (i = 1; i <= num_cpus; i++)
+  {
+    if ( (i < num_cpus) &&
+         (place[i].desc->_node == place[i-1].desc->_node) &&
+         topology->share_llc( place[i].desc->_id, place[i-1].desc->_id ) )
+    {
+      run++;
+      continue;
+    }
+    if ( run < llc_size )
+      llc_size = run;
+    run = 1;
+  }
+  
+  return llc_size;
+}
+
+
 /**
  *  @brief Linux-specific version of do_cpu_set_init().
  *
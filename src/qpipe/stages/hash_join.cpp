@@ -73,6 +73,16 @@ void hash_join_stage_t::process_packet() {
         /* TODO Handle outer join here. */
         return;
     }
+
+
+    /* Ask the memory broker for the in-memory partitions. A smaller
+       grant than the quota means we spill to disk earlier. Every
+       partition needs at least one page. */
+    mem_grant_t grant;
+    _grant = &grant;
+    clear_partitions();
+    page_quota = grant.acquire(packet->_packet_id, HASH_JOIN_PAGE_QUOTA,
+                               2 * partitions.size());
     
     
     hash_join_stage_t::extractkey_t extract_left (_join, false);
@@ -110,11 +120,11 @@ void hash_join_stage_t::process_packet() {
         p->append_tuple(right);
     }
 
-    /* TODO Flush all partitions to disk and free the partition
-       memory. */
-
-    /* We now have the right relation sitting on disk in partition
-       files. */
+    /* Flush the last page of the disk partitions, each of them gets
+       a file for its left side tuples. */
+    right_action_t right_action(_join->left_tuple_size());
+    for(partition_list_t::iterator it=partitions.begin(); it != partitions.end(); ++it)
+        close_file(it, right_action);
 
     /* Create and fill the in-memory hash table. */
     size_t page_capacity =
@@ -132,8 +142,7 @@ void hash_join_stage_t::process_packet() {
                        equal_rtup,
                        hasher);
     
-    /* Flush any partitions that went to disk */
-    right_action_t right_action(_join->left_tuple_size());
+    /* Build the hash table out of the in-memory partitions */
     for(partition_list_t::iterator it=partitions.begin(); it != partitions.end(); ++it) {
 
         qpipe::page* p = it->_page;
@@ -141,12 +150,7 @@ void hash_join_stage_t::process_packet() {
             // empty partition
             continue;
 
-        // file partition? (make sure the file gets closed)
-        if(it->file) 
-            close_file(it, right_action);
-        
-        // build hash table out of in-memory partition
-        else {
+        if(!it->file) {
             while(p) {
                 for(qpipe::page::iterator it=p->begin(); it != p->end(); ++it) {
                     // Distinguish between DISTINCT join and
@@ -191,16 +195,13 @@ void hash_join_stage_t::process_packet() {
 
         // add to file partition?
         if(p.file) {
-            qpipe::page* pg = p._page;
 
             // flush to disk?
-            if(pg->full()) {
-                pg->fwrite_full_page(p.file);
-                pg->clear();
-            }
+            if(p._page->full())
+                p._page = p.file->write_swap(p._page);
 
             // add the tuple to the page
-            pg->append_tuple(left);
+            p._page->append_tuple(left);
         }
 
         // check in-memory hash table
@@ -226,14 +227,116 @@ void hash_join_stage_t::process_packet() {
     // close all the files and release in-memory pages
     table.clear();
     for(partition_list_t::iterator it=partitions.begin(); it != partitions.end(); ++it) {
-        // delete the page list
+        close_file(it, left_action_t());
         for(guard<qpipe::page> pg = it->_page; pg; pg = pg->next);
-        if(it->file) 
-            close_file(it, left_action_t());
+        it->_page = NULL;
     }
+    page_count = 0;
 
-    // TODO: handle the file partitions now...
+    // now join the disk partitions, one at a time, in the memory
+    // the in-memory ones just gave back
+    for(partition_list_t::iterator it=partitions.begin(); it != partitions.end(); ++it) {
+        if(!(it->file_name2 == c_str::EMPTY_STRING))
+            join_disk_partition(*it, outer_join, distinct);
+    }
 
+    clear_partitions();
+    _grant = NULL;
+}
+
+
+
+/* Joins a partition that went to disk: reads its right side back
+   into a hash table and probes it with its left side. */
+void hash_join_stage_t::join_disk_partition(partition_t &p,
+                                            bool outer_join, bool distinct)
+{
+    guard<page_file_t> right_file = new page_file_t(p.file_name1, false);
+
+    // read the pages into a list, like an in-memory partition
+    qpipe::page* head = NULL;
+    qpipe::page* pg;
+    int pages = 0;
+    while((pg = right_file->read()) != NULL) {
+        pg->next = head;
+        head = pg;
+        pages++;
+    }
+    
+    size_t page_capacity =
+        qpipe::page::capacity(get_default_page_size(),
+                              _join->right_tuple_size());
+
+    extractkey_t right_key_extractor(_join, true);
+    equalbytes_t equal_key (_join->key_size());
+    equalbytes_t equal_rtup(_join->right_tuple_size());
+    hashfcn_t    hasher(_join->key_size());
+    
+    tuple_hash_t table(pages * page_capacity,
+                       right_key_extractor,
+                       equal_key,
+                       equal_rtup,
+                       hasher);
+
+    for(qpipe::page* pg = head; pg; pg = pg->next) {
+        for(qpipe::page::iterator it=pg->begin(); it != pg->end(); ++it) {
+            if(distinct)
+                table.insert_unique_noresize(it->data);
+            else
+                table.insert_noresize(it->data);
+        }
+    }
+
+    // probe with the left side
+    guard<page_file_t> left_file = new page_file_t(p.file_name2, false);
+
+    array_guard_t<char> data = new char[_join->output_tuple_size()];
+    tuple_t right(NULL, _join->right_tuple_size());
+    extractkey_t left_key_extractor(_join, false);
+    while((pg = left_file->read()) != NULL) {
+        guard<qpipe::page> left_page = pg;
+        for(qpipe::page::iterator lit=left_page->begin(); lit != left_page->end(); ++lit) {
+            tuple_t left = *lit;
+            const char* left_key = left_key_extractor(left.data);
+            std::pair<tuple_hash_t::iterator, tuple_hash_t::iterator> range;
+            range = table.equal_range(left_key);
+
+            tuple_t out(data, _join->output_tuple_size());
+            if(outer_join && range.first == range.second) {
+                _join->left_outer_join(out, left);
+                _adaptor->output(out);
+            }
+            else {
+                for(tuple_hash_t::iterator it = range.first; it != range.second; ++it) {
+                    right.data = *it;
+                    _join->join(out, left, right);
+                    _adaptor->output(out);
+                }
+            }
+        }
+    }
+
+    table.clear();
+    for(guard<qpipe::page> pg = head; pg; pg = pg->next);
+}
+
+
+
+/* Frees the in-memory pages and removes the files of the partitions
+   of the last packet. */
+void hash_join_stage_t::clear_partitions() {
+
+    for(partition_list_t::iterator it=partitions.begin(); it != partitions.end(); ++it) {
+        for(guard<qpipe::page> pg = it->_page; pg; pg = pg->next);
+        if(it->file)
+            delete it->file;
+        if(!(it->file_name1 == c_str::EMPTY_STRING))
+            remove(it->file_name1.data());
+        if(!(it->file_name2 == c_str::EMPTY_STRING))
+            remove(it->file_name2.data());
+        *it = partition_t();
+    }
+    page_count = 0;
 }
 
 
@@ -246,7 +349,13 @@ void hash_join_stage_t::test_overflow(int partition) {
     if(p._page && !p._page->full())
         return ;
     
-    
+    /* A disk partition has a single page, write it out. */
+    if(p.file) {
+        p._page = p.file->write_swap(p._page);
+        p.size++;
+        return;
+    }
+
     /* A partition is either a list of in-memory pages strung together
        or a file on disk with one in-memory page. 'page_count' is the
        total number of in-memory pages used by all partitions.
@@ -255,7 +364,12 @@ void hash_join_stage_t::test_overflow(int partition) {
        in-memory partitions by simply tacking other pages onto the end
        their lists. When 'page_count' reaches 'page_quota', we pick
        the largest in-memory partition and turn it into a disk
-       partition. */
+       partition, unless the memory broker lets us grow the quota
+       (up to HASH_JOIN_PAGE_QUOTA). */
+    if((page_count == page_quota) && (page_quota < HASH_JOIN_PAGE_QUOTA))
+        page_quota += _grant->grow(std::min(HASH_JOIN_GROW_PAGES,
+                                            HASH_JOIN_PAGE_QUOTA - page_quota));
+
     if(page_count == page_quota) {
         
         /* We need to flush to disk. We will flush the biggest
@@ -265,37 +379,44 @@ void hash_join_stage_t::test_overflow(int partition) {
         int max = -1;
         for(unsigned i=0; i < partitions.size(); i++) {
             partition_t &p = partitions[i];
-            if(!p.file && (max < 0 || p.size > partitions[max].size))
+            if(!p.file && p._page &&
+               (max < 0 || p.size > partitions[max].size))
                 max = i;
         }
 
         /* Create a file on disk. */
-        partition_t &p = partitions[max];
-        p.file = create_tmp_file(p.file_name1, "hash-join-right");
-
-        /* Send the partition to the file. */
-        guard<qpipe::page> head;
-        for(head = p._page; head->next; head=head->next) {
-            head->fwrite_full_page(p.file);
+        partition_t &victim = partitions[max];
+        victim.file = page_file_t::create_tmp(victim.file_name1, "hash-join-right");
+
+        /* Send the partition to the file, which frees the pages once
+           it has written them. */
+        qpipe::page* head = victim._page;
+        while(head->next) {
+            qpipe::page* next = head->next;
+            head->next = NULL;
+            victim.file->write(head);
+            head = next;
             page_count--;
         }
         
-        /* Write the last page, but don't free it. */
-        head->fwrite_full_page(p.file);
-        head->clear();
-        p._page = head.release();
-    }
-    else {
-        
-        /* No need to flush to disk. Simply add a page to the full
-           in-memory partition. */
-        qpipe::page* pg =
-            qpipe::page::alloc(_join->right_tuple_size());
-        pg->next = p._page;
-        p._page = pg;
-        page_count++;
+        /* Write the last page, and keep an empty one in its place. */
+        victim._page = victim.file->write_swap(head);
+
+        /* If we flushed our own partition it has an empty page now,
+           otherwise it still needs one. */
+        if(max == partition) {
+            p.size++;
+            return;
+        }
     }
 
+    /* Add a page to the full in-memory partition. */
+    qpipe::page* pg =
+        qpipe::page::alloc(_join->right_tuple_size());
+    pg->next = p._page;
+    p._page = pg;
+    page_count++;
+
     // done!
     p.size++;
 }
@@ -305,18 +426,16 @@ void hash_join_stage_t::test_overflow(int partition) {
 template <class Action>
 void hash_join_stage_t::close_file(partition_list_t::iterator it, Action action) {
 
-    /* I think this function is supposed to have no effect if called
-       on an in-memory partition. If it is called on a file partition,
-       it is supposed to flush the partition to disk. */
-    qpipe::page *p = it->_page;
-    
-    /* File partition? */
-    /* Write remaining tuples to disk and apply 'action' to it. */
-    file_guard_t file = it->file;
-    if(!p || p->empty())
+    /* No effect on an in-memory partition. A file partition flushes
+       its page to disk, closes the file and applies 'action' to it. */
+    if(!it->file)
         return;
-    
-    p->fwrite_full_page(file);
+
+    guard<page_file_t> file = it->file;
+    it->file = NULL;
+    if(!it->_page->empty())
+        it->_page = file->write_swap(it->_page);
+    file->flush();
     action(it);
 }
 
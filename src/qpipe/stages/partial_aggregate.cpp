@@ -47,6 +47,11 @@ int partial_aggregate_stage_t::alloc_agg(hint_tuple_pair_t &agg, const char* key
         _agg_page = qpipe::page::alloc(_aggregate->tuple_size());
         _page_list.add(_agg_page);
         _page_count++;
+
+        // we cannot spill, so the pages are only accounted with the
+        // memory broker (forced growth)
+        if(_page_count > (size_t)_grant->pages())
+            _grant->grow(MEM_BROKER_MIN_GRANT, true);
     }
 
     // allocate the tuple
@@ -77,6 +82,10 @@ void partial_aggregate_stage_t::process_packet() {
     tuple_less_t less(agg_key, compare);
     tuple_set_t run(less);
 
+    mem_grant_t grant;
+    _grant = &grant;
+    grant.acquire(packet->_packet_id, MEM_BROKER_MIN_GRANT);
+
     // read in the tuples and aggregate them in the set
     while(!input_buffer->eof()) {
         _page_list.clear();
@@ -152,6 +152,12 @@ void pipe_hash_join_stage_t::process_packet() {
     page_trash_stack left_pages;
     page_trash_stack right_pages;
 
+    // both relations stay in memory, so the pages are only accounted
+    // with the memory broker (forced growth, we cannot spill)
+    mem_grant_t grant;
+    grant.acquire(packet->_packet_id, MEM_BROKER_MIN_GRANT);
+    int page_count = 0;
+
     int out_size = packet->_output_filter->input_tuple_size();
     array_guard_t<char> out_data = new char[out_size];
     tuple_t out(out_data, out_size);
@@ -172,6 +178,8 @@ void pipe_hash_join_stage_t::process_packet() {
         qpipe::page* p = qpipe::page::alloc(left_buffer->tuple_size());
 	left_buffer->copy_page(p);
 	left_pages.add(p);
+	if(++page_count > grant.pages())
+	    grant.grow(MEM_BROKER_MIN_GRANT, true);
 	pit it = p->begin();
 	pit end = p->end();
 	while(it != end) {
@@ -196,6 +204,8 @@ void pipe_hash_join_stage_t::process_packet() {
         qpipe::page* p = qpipe::page::alloc(right_buffer->tuple_size());
         right_buffer->copy_page(p);
 	right_pages.add(p);
+	if(++page_count > grant.pages())
+	    grant.grow(MEM_BROKER_MIN_GRANT, true);
 	pit it = p->begin();
 	pit end = p->end();
 	while(it != end) {
@@ -49,7 +49,7 @@ void register_stage_containers()
 {
     TRACE( TRACE_ALWAYS, "Registering stage containers\n");
 
-    register_stage<tscan_stage_t>(MAX_NUM_TSCAN_THREADS, true);
+    register_stage<tscan_stage_t>(MAX_NUM_TSCAN_THREADS, true, true);
     register_stage<aggregate_stage_t>(MAX_NUM_AGGREGATE_THREADS, true);
     register_stage<partial_aggregate_stage_t>(MAX_NUM_PARTIAL_AGGREGATE_THREADS, true);
     register_stage<hash_aggregate_stage_t>(MAX_NUM_AGGREGATE_THREADS, true);
@@ -401,11 +401,17 @@ void sort_stage_t::process_packet() {
     
     // create a buffer page for writing to file
     guard<qpipe::page> out_page = qpipe::page::alloc(_tuple_size);
+
+    // ask the memory broker for the pages of a run; with fewer pages
+    // we make shorter runs and merge more
+    mem_grant_t grant;
+    unsigned int run_pages =
+        grant.acquire(packet->_packet_id, PAGES_PER_INITIAL_SORTED_RUN);
     
     // create a key array 
     int capacity =
         qpipe::page::capacity(_input_buffer->page_size(), _tuple_size);
-    int tuple_count = PAGES_PER_INITIAL_SORTED_RUN * capacity;
+    int tuple_count = run_pages * capacity;
     hint_vector_t array;
     array.reserve(tuple_count);
 
@@ -426,7 +432,7 @@ void sort_stage_t::process_packet() {
         
         page_trash_stack pages;
         array.clear();
-        for(unsigned int i=0; i < PAGES_PER_INITIAL_SORTED_RUN; i++) {
+        for(unsigned int i=0; i < run_pages; i++) {
 
             // read in a run of pages
             qpipe::page* p = qpipe::page::alloc(_input_buffer->tuple_size());
@@ -64,7 +64,8 @@ tscan_packet_t::tscan_packet_t(const c_str&    packet_id,
                true, /* merging allowed */
                true  /* unreserve worker on completion */
                ),
-      _db(db), _table(table), _xct(pxct), _lm(lm)
+      _db(db), _table(table), _xct(pxct), _lm(lm),
+      _pcolumns(NULL), _pzones(NULL)
 {
     assert(_db);
     assert(_table);
@@ -85,6 +86,42 @@ void tscan_packet_t::declare_worker_needs(resource_declare_t* declare)
     /* no inputs */
 }
 
+bool tscan_packet_t::get_versions(data_version_list_t &versions)
+{
+    versions.push_back(data_version_t(_table->version_counter()));
+    return (true);
+}
+
+
+/** 
+ *  @brief The pushed-down predicates become part of the action of the
+ *  plan. Merged packets share the produced tuples, so only the scans
+ *  with the same predicates can be merged.
+ */
+
+void tscan_packet_t::where(const vector<column_pred_t>& preds)
+{
+    _col_preds = preds;
+
+    c_str action("%s:WHERE", _plan->action.data());
+    for (uint i=0; i<_col_preds.size(); i++) {
+        action = c_str("%s:%s", action.data(), _col_preds[i].to_string().data());
+    }
+    _plan->action = action;
+}
+
+void tscan_packet_t::use_columns(column_replica_t* pcolumns)
+{
+    assert (!pcolumns || (pcolumns->table() == _table));
+    _pcolumns = pcolumns;
+}
+
+void tscan_packet_t::use_zones(zone_map_t* pzones)
+{
+    assert (!pzones || (pzones->table() == _table));
+    _pzones = pzones;
+}
+
 
 // Ideally, we would like to allocate a large blob and do bulk reading. 
 // The blob must be aligned for int accesses and a multiple of 1024 bytes long.
@@ -117,9 +154,23 @@ void tscan_stage_t::process_packet()
     adaptor_t* adaptor = _adaptor;
     tscan_packet_t* packet = (tscan_packet_t*)adaptor->get_packet();
     smthread_t::me()->attach_xct(packet->_xct);
+
+    // Read the columnar replica, if there is a valid one
+    if (packet->_pcolumns) {
+        column_scan_t cscan(packet->_pcolumns);
+        if (cscan.opened()) {
+            cscan.where(packet->_col_preds);
+            process_columns(cscan, packet);
+            smthread_t::me()->detach_xct(packet->_xct);
+            return;
+        }
+    }
     
-    // Create and open scan
+    // Create and open scan, skipping pages by the zone maps if possible
     simple_table_iter_t tscanner(packet->_db, packet->_table, packet->_lm);
+    if (packet->_pzones) {
+        tscanner.use_zones(packet->_pzones, packet->_col_preds);
+    }
     bool eof(false);
     pin_i* handle(NULL);
     uint pcnt=0;
@@ -150,4 +201,38 @@ void tscan_stage_t::process_packet()
 }
 
 
+
+/******************************************************************
+ * 
+ * @fn:     process_columns
+ *
+ * @brief:  Produce the qualifying rows of the columnar replica, in
+ *          the disk format of the table, like the heap scan.
+ *
+ ******************************************************************/
+
+void tscan_stage_t::process_columns(column_scan_t& cscan, 
+                                    tscan_packet_t* packet)
+{
+    table_man_t* pmanager = packet->_pcolumns->manager();
+    uint tsz(packet->_table->maxsize());
+
+    table_row_t arow(packet->_table);
+    rep_row_t arep(pmanager->ts());
+    arep.set(tsz);
+
+    while (cscan.next_block()) {
+        for (uint i=0; i<cscan.count(); i++) {
+            cscan.materialize(i, &arow);
+            pmanager->format(&arow, arep);
+            tuple_t at(arep._dest,tsz);
+            _adaptor->output(at);
+        }
+    }
+
+    TRACE( TRACE_DEBUG, "(%s) columns: (%d) blocks read, (%d) skipped\n",
+           packet->_table->name(), cscan.blocks_read(), cscan.blocks_skipped());
+}
+
+
 EXIT_NAMESPACE(qpipe);
@@ -0,0 +1,435 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   shore_bulk_loader.cpp
+ *
+ *  @brief:  Implementation of the bulk index construction
+ *
+ */
+
+#include "sm/shore/shore_bulk_loader.h"
+#include "sm/shore/shore_table.h"
+
+#include <algorithm>
+
+
+ENTER_NAMESPACE(shore);
+
+
+
+/*********************************************************************
+ *
+ *  @fn:    bulk_key_cmp_t::setup
+ *
+ *  @brief: Records the offset and the kind of comparison of each field
+ *          of the key. The kind comes from the key description that the
+ *          index was created with, so that the sort order is the one the
+ *          B+tree expects.
+ *
+ *********************************************************************/
+
+void bulk_key_cmp_t::setup(table_desc_t* ptable, index_desc_t* pindex)
+{
+    assert (ptable);
+    assert (pindex);
+
+    _parts.clear();
+    uint_t offset = 0;
+    for (uint_t i=0; i<pindex->field_count(); i++) {
+        field_desc_t* pfd = ptable->desc(pindex->key_index(i));
+        part_t part;
+        part._offset = offset;
+        part._size   = pfd->fieldmaxsize();
+        switch (pfd->keydesc()[0]) {
+        case 'i': part._kind = KC_INT; break;
+        case 'f': part._kind = KC_FLOAT; break;
+        default:  part._kind = KC_BYTES; break;
+        }
+        _parts.push_back(part);
+        offset += part._size;
+    }
+}
+
+
+
+/*********************************************************************
+ *
+ *  @fn:    bulk_key_cmp_t::compare
+ *
+ *  @brief: Returns <0, 0, >0 if key a is smaller, equal, or larger than b
+ *
+ *********************************************************************/
+
+int bulk_key_cmp_t::compare(const char* a, const char* b) const
+{
+    for (uint_t i=0; i<_parts.size(); i++) {
+        const part_t& p = _parts[i];
+        const char* pa = a + p._offset;
+        const char* pb = b + p._offset;
+        int r = 0;
+
+        switch (p._kind) {
+        case KC_INT:
+            switch (p._size) {
+            case 1: r = (int)*(int1_t*)pa - (int)*(int1_t*)pb; break;
+            case 2: r = (int)*(int2_t*)pa - (int)*(int2_t*)pb; break;
+            case 4: {
+                int4_t va = *(int4_t*)pa, vb = *(int4_t*)pb;
+                r = (va < vb ? -1 : (va > vb ? 1 : 0));
+                break; }
+            default: {
+                int8_t va = *(int8_t*)pa, vb = *(int8_t*)pb;
+                r = (va < vb ? -1 : (va > vb ? 1 : 0));
+                break; }
+            }
+            break;
+
+        case KC_FLOAT:
+            if (p._size == sizeof(float)) {
+                float va = *(float*)pa, vb = *(float*)pb;
+                r = (va < vb ? -1 : (va > vb ? 1 : 0));
+            }
+            else {
+                double va = *(double*)pa, vb = *(double*)pb;
+                r = (va < vb ? -1 : (va > vb ? 1 : 0));
+            }
+            break;
+
+        case KC_BYTES:
+            r = memcmp(pa, pb, p._size);
+            break;
+        }
+
+        if (r) return (r);
+    }
+    return (0);
+}
+
+
+
+
+/********************************************************************
+ *
+ *  class index_bulk_buf_t
+ *
+ ********************************************************************/
+
+index_bulk_buf_t::index_bulk_buf_t(table_desc_t* ptable,
+                                   index_desc_t* pindex,
+                                   const int pnum,
+                                   const uint_t ksz)
+    : _ptable(ptable), _pindex(pindex), _pnum(pnum),
+      _ksz(ksz), _esz(ksz + sizeof(rid_t)),
+      _used(BULK_ENTRIES_PER_CHUNK), _full(false)
+{
+    assert (_ptable);
+    assert (_pindex);
+    assert (_ksz);
+    _cmp.setup(_ptable, _pindex);
+}
+
+index_bulk_buf_t::~index_bulk_buf_t()
+{
+    for (uint_t i=0; i<_chunks.size(); i++) {
+        delete [] _chunks[i];
+    }
+    atomic_add_64(&_mem_used, -(int64_t)(_chunks.size()*BULK_ENTRIES_PER_CHUNK*_esz));
+    _chunks.clear();
+}
+
+
+volatile uint64_t index_bulk_buf_t::_mem_used = 0;
+uint64_t          index_bulk_buf_t::_mem_cap = 0;
+
+void index_bulk_buf_t::set_mem_cap(const uint_t mb)
+{
+    _mem_cap = (uint64_t)mb*1024*1024;
+}
+
+
+/********************************************************************
+ *
+ *  @fn:    add
+ *
+ *  @brief: Copies the key and the rid to the next free entry
+ *
+ *  @note:  If a new chunk would take the buffers over the memory cap
+ *          the buffer stops collecting, and returns false from then on.
+ *          The index is then not empty when it is built, so build()
+ *          inserts the collected entries in key order.
+ *
+ ********************************************************************/
+
+bool index_bulk_buf_t::add(const char* key, const uint_t ksz, const rid_t& rid)
+{
+    assert (key);
+    assert (ksz == _ksz);
+
+    CRITICAL_SECTION(add_cs, _lock);
+    if (_full) return (false);
+    if (_used == BULK_ENTRIES_PER_CHUNK) {
+        int64_t csz = BULK_ENTRIES_PER_CHUNK*_esz;
+        uint64_t used = atomic_add_64_nv(&_mem_used, csz);
+        if (_mem_cap && (used > _mem_cap)) {
+            atomic_add_64(&_mem_used, -csz);
+            _full = true;
+            TRACE( TRACE_ALWAYS, 
+                   "%s_%d: bulk-load memory cap (%lld MB) reached, (%d) entries collected\n",
+                   _pindex->name(), _pnum, (long long)(_mem_cap/(1024*1024)),
+                   _entries.size());
+            return (false);
+        }
+        _chunks.push_back(new char[csz]);
+        _used = 0;
+    }
+    char* pentry = _chunks.back() + (_used*_esz);
+    memcpy(pentry, key, _ksz);
+    memcpy(pentry + _ksz, &rid, sizeof(rid_t));
+    _entries.push_back(pentry);
+    _used++;
+    return (true);
+}
+
+
+
+/********************************************************************
+ *
+ *  @fn:    build
+ *
+ *  @brief: Sorts the entries and loads them to the index
+ *
+ *  @note:  The storage manager can bulk-load only an empty index. If
+ *          some entries were inserted before the table switched to
+ *          bulk-load mode (for example the rows added by the table
+ *          creators) the sorted entries are inserted one by one.
+ *          Sorted insertions still touch each leaf only once.
+ *
+ ********************************************************************/
+
+w_rc_t index_bulk_buf_t::build(ss_m* db)
+{
+    assert (db);
+
+    time_t tstart = time(NULL);
+    std::sort(_entries.begin(), _entries.end(), _cmp);
+    time_t tsorted = time(NULL);
+
+    bool empty = false;
+    W_DO(_is_empty(db, empty));
+    if (empty) {
+        W_DO(_bulkld(db));
+    }
+    else {
+        W_DO(_insert_sorted(db));
+    }
+
+    TRACE( TRACE_STATISTICS,
+           "%s_%d: (%d) entries. Sort (%d) Build (%d) secs (%s)\n",
+           _pindex->name(), _pnum, _entries.size(),
+           (tsorted - tstart), (time(NULL) - tsorted),
+           (empty ? "bulk" : "sorted inserts"));
+    return (RCOK);
+}
+
+
+w_rc_t index_bulk_buf_t::_is_empty(ss_m* db, bool& empty)
+{
+    W_DO(db->begin_xct());
+    {
+        scan_index_i scan(_pindex->fid(_pnum),
+                          scan_index_i::ge, vec_t::neg_inf,
+                          scan_index_i::le, vec_t::pos_inf,
+                          false, ss_m::t_cc_none);
+        bool eof = false;
+        W_DO(scan.next(eof));
+        empty = eof;
+    }
+    W_DO(db->commit_xct());
+    return (RCOK);
+}
+
+
+
+/********************************************************************
+ *
+ *  @fn:    _bulkld
+ *
+ *  @brief: Writes the sorted entries to a temporary file, with the key
+ *          as header and the rid as body of each record, and asks the
+ *          storage manager to build the index out of it
+ *
+ ********************************************************************/
+
+w_rc_t index_bulk_buf_t::_bulkld(ss_m* db)
+{
+    stid_t srcfid;
+    rid_t  srcrid;
+    uint_t count = 0;
+
+    W_DO(db->begin_xct());
+    W_DO(db->create_file(_ptable->vid(), srcfid, smlevel_3::t_temporary));
+    for (uint_t i=0; i<_entries.size(); i++) {
+        W_DO(db->create_rec(srcfid,
+                            vec_t(_entries[i], _ksz),
+                            sizeof(rid_t),
+                            vec_t(_entries[i]+_ksz, sizeof(rid_t)),
+                            srcrid));
+        if (++count >= COMMIT_ACTION_COUNT) {
+            W_DO(db->commit_xct());
+            W_DO(db->begin_xct());
+            count = 0;
+        }
+    }
+    W_DO(db->commit_xct());
+
+    // Keys are passed in their memory format, the storage manager
+    // lexifies them according to the key description of the index
+    sm_du_stats_t stats;
+    W_DO(db->begin_xct());
+    W_DO(db->bulkld_index(_pindex->fid(_pnum), 1, &srcfid, stats,
+                          !_pindex->is_unique(), true));
+    W_DO(db->destroy_file(srcfid));
+    W_DO(db->commit_xct());
+    return (RCOK);
+}
+
+
+
+w_rc_t index_bulk_buf_t::_insert_sorted(ss_m* db)
+{
+    uint_t count = 0;
+
+    W_DO(db->begin_xct());
+    for (uint_t i=0; i<_entries.size(); i++) {
+        W_DO(db->create_assoc(_pindex->fid(_pnum),
+                              vec_t(_entries[i], _ksz),
+                              vec_t(_entries[i]+_ksz, sizeof(rid_t)),
+                              true));
+        if (++count >= COMMIT_ACTION_COUNT) {
+            W_DO(db->commit_xct());
+            W_DO(db->begin_xct());
+            count = 0;
+        }
+    }
+    W_DO(db->commit_xct());
+    return (RCOK);
+}
+
+
+
+
+/********************************************************************
+ *
+ *  class bulk_loader_t
+ *
+ ********************************************************************/
+
+bulk_loader_t::bulk_loader_t(table_desc_t* ptable)
+    : _ptable(ptable)
+{
+    assert (_ptable);
+
+    index_desc_t* pindex = _ptable->indexes();
+    while (pindex) {
+        uint_t ksz = 0;
+        for (uint_t i=0; i<pindex->field_count(); i++) {
+            ksz += _ptable->desc(pindex->key_index(i))->fieldmaxsize();
+        }
+        for (int p=0; p<pindex->get_partition_count(); p++) {
+            _bufs.push_back(new index_bulk_buf_t(_ptable, pindex, p, ksz));
+        }
+        pindex = pindex->next();
+    }
+}
+
+bulk_loader_t::~bulk_loader_t()
+{
+    for (uint_t i=0; i<_bufs.size(); i++) {
+        delete (_bufs[i]);
+    }
+    _bufs.clear();
+}
+
+
+index_bulk_buf_t* bulk_loader_t::buf(index_desc_t* pindex, const int pnum)
+{
+    // Tables have a handful of indexes, a linear search is enough
+    for (uint_t i=0; i<_bufs.size(); i++) {
+        if ((_bufs[i]->index() == pindex) && (_bufs[i]->pnum() == pnum))
+            return (_bufs[i]);
+    }
+    assert (0); // unknown index
+    return (NULL);
+}
+
+
+bool bulk_loader_t::supports(table_desc_t* ptable)
+{
+    assert (ptable);
+    if (ptable->get_pd() & (PD_MRBT_NORMAL | PD_MRBT_PART | PD_MRBT_LEAF))
+        return (false);
+
+    index_desc_t* pindex = ptable->indexes();
+    while (pindex) {
+        if (pindex->is_mr()) return (false);
+        pindex = pindex->next();
+    }
+    return (true);
+}
+
+
+
+
+/********************************************************************
+ *
+ *  @fn:    index_builder_smt_t::work
+ *
+ *  @brief: Pops index buffers from the shared list and builds them
+ *
+ ********************************************************************/
+
+void index_builder_smt_t::work()
+{
+    while (true) {
+        index_bulk_buf_t* pbuf = NULL;
+        {
+            CRITICAL_SECTION(work_cs, *_pwork_lock);
+            if (_pwork->empty()) break;
+            pbuf = _pwork->back();
+            _pwork->pop_back();
+        }
+
+        w_rc_t e = pbuf->build(_pssm);
+        if (e.is_error()) {
+            TRACE( TRACE_ALWAYS, "Index (%s_%d) building aborted [0x%x]\n",
+                   pbuf->index()->name(), pbuf->pnum(), e.err_num());
+            W_IGNORE(_pssm->abort_xct());
+            _rv = 1;
+            return;
+        }
+    }
+    _rv = 0;
+}
+
+
+EXIT_NAMESPACE(shore);
@@ -68,19 +68,56 @@ bool base_client_t::is_test_aborted()
 w_rc_t base_client_t::submit_batch(int xct_type, int& trx_cnt, const int batch_sz) 
 {       
     assert (batch_sz);
-    assert (_cp);
+    assert (_cq);
     for(int j=1; j <= batch_sz; j++) {
 
         // adding think time
         //usleep(int(_think_time*(sthread_t::drand())));
 
         if (j == batch_sz) 
-	    _cp->please_take_one();
+	    _cq->please_take_one();
         W_COERCE(submit_one(xct_type, trx_cnt++));
     }
     return (RCOK);
 }
 
+
+
+/********************************************************************* 
+ *
+ *  @fn:    _submit_timed_batch/_batch_done
+ *
+ *  @brief: Keep the submission time of each batch in flight, by the
+ *          id of the trx that notifies the client, and record the 
+ *          latency of the batch when it is notified, if the latency
+ *          is sampled (skew scenarios)
+ *
+ *********************************************************************/
+
+w_rc_t base_client_t::_submit_timed_batch(int xct_type, int& trx_cnt, 
+                                          const int batch_sz)
+{
+    long long tstart = _timer.now();
+    W_DO(submit_batch(xct_type, trx_cnt, batch_sz));
+    _sent.push_back(std::make_pair(trx_cnt-1, tstart));
+    return (RCOK);
+}
+
+void base_client_t::_batch_done(const completion_t& rec)
+{
+    for (uint j=0; j<_sent.size(); j++) {
+        if (_sent[j].first == rec._xct_id) {
+            env_stats_t* pstats = _env->get_env_stats();
+            if (pstats->lat_on()) {
+                pstats->record_latency(_timer.now() - _sent[j].second);
+            }
+            _sent[j] = _sent.back();
+            _sent.pop_back();
+            return;
+        }
+    }
+}
+
 static pthread_mutex_t client_mutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_cond_t client_cond = PTHREAD_COND_INITIALIZER;
 static int client_needed_count;
@@ -110,6 +147,7 @@ w_rc_t base_client_t::run_xcts(int xct_type, int num_xct)
 {
     int i=0;
     int batchsz=1;
+    int inflight=IN_FLIGHT_BATCHES;
 
     client_ready();
     
@@ -117,6 +155,9 @@ w_rc_t base_client_t::run_xcts(int xct_type, int num_xct)
     envVar* ev = envVar::instance();
     batchsz = ev->getVarInt("db-cl-batchsz",BATCH_SIZE);
     _think_time = ev->getVarInt("db-cl-thinktime",THINK_TIME);
+    inflight = ev->getVarInt("db-cl-inflight",IN_FLIGHT_BATCHES);
+    if (inflight < 1) inflight = 1;
+    if (inflight > (int)_cq->capacity()) inflight = _cq->capacity();
 
     if ((_think_time>0) && (batchsz>1)) {
         TRACE( TRACE_ALWAYS, "error: Batchsz=%d && ThinkTime=%d\n", 
@@ -141,31 +182,35 @@ w_rc_t base_client_t::run_xcts(int xct_type, int num_xct)
         // submit a batch of num_xct trxs
         W_COERCE(submit_batch(xct_type, i, num_xct));
         // wait for the batch to complete
-        _cp->wait();
+        _cq->wait();
         break;
 
         // case of duration-based measurement
     case (MT_TIME_DUR):
 	
-	// submit the first two batches...
-	W_COERCE(submit_batch(xct_type, i, batchsz));
-	W_COERCE(submit_batch(xct_type, i, batchsz));
+	// submit the first batches...
+        for (int b=0; b<inflight; b++) {
+            W_COERCE(_submit_timed_batch(xct_type, i, batchsz));
+        }
 
 	// main loop
         while (true) {
-	    // wait for the first to complete
-	    _cp->wait();
+	    // wait for one to complete
+	    _batch_done(_cq->wait());
 
 	    // check for exit...
 	    if(_abort_test || _env->get_measure() == MST_DONE)
 		break;
 
 	    // submit a replacement batch...
-	    W_COERCE(submit_batch(xct_type, i, batchsz));
+	    W_COERCE(_submit_timed_batch(xct_type, i, batchsz));
         }
 	
-	// wait for the last batch to complete...
-	_cp->wait();	
+	// wait for the remaining batches to complete...
+        while (_cq->in_flight() > 0) {
+            _batch_done(_cq->wait());
+        }
+        _sent.clear();
         break;
 
     default:
@@ -0,0 +1,941 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   shore_column_store.cpp
+ *
+ *  @brief:  Implementation of the compressed columnar replica of
+ *           read-mostly tables
+ *
+ */
+
+#include "sm/shore/shore_column_store.h"
+#include "sm/shore/shore_table.h"
+
+#include <algorithm>
+#include <map>
+#include <cmath>
+#include <climits>
+
+
+ENTER_NAMESPACE(shore);
+
+
+
+/********************************************************************
+ *
+ *  class bitpack_t
+ *
+ ********************************************************************/
+
+void bitpack_t::init(const uint_t bits, const uint_t count)
+{
+    assert (bits <= 64);
+    _bits = bits;
+    _mask = (bits == 64) ? ~((uint64_t)0) : ((((uint64_t)1) << bits) - 1);
+    // one spare word, so that set()/get() can always touch w+1
+    _words.assign(bits ? ((((uint64_t)count*bits) >> 6) + 2) : 0, 0);
+}
+
+uint_t bitpack_t::width(uint64_t maxv)
+{
+    uint_t bits = 0;
+    while (maxv) {
+        bits++;
+        maxv >>= 1;
+    }
+    return (bits);
+}
+
+
+
+/********************************************************************
+ *
+ *  sizes
+ *
+ ********************************************************************/
+
+size_t column_block_t::bytes() const
+{
+    return (sizeof(column_block_t) + _packed.bytes() +
+            _doubles.size()*sizeof(double) +
+            _chars.size() + _offsets.size()*sizeof(uint_t));
+}
+
+column_t::~column_t()
+{
+    for (uint_t i=0; i<_blocks.size(); i++) delete (_blocks[i]);
+    _blocks.clear();
+}
+
+size_t column_t::bytes() const
+{
+    size_t sz = sizeof(column_t);
+    for (uint_t i=0; i<_dict.size(); i++) sz += _dict[i].size() + 1;
+    for (uint_t i=0; i<_blocks.size(); i++) sz += _blocks[i]->bytes();
+    return (sz);
+}
+
+column_replica_t::snapshot_t::~snapshot_t()
+{
+    for (uint_t i=0; i<_cols.size(); i++) delete (_cols[i]);
+    _cols.clear();
+}
+
+
+
+/********************************************************************
+ *
+ *  class column_pred_t
+ *
+ *  Integer bounds are kept as doubles too, so that they can be used
+ *  with float columns. A predicate with any double bound is a double
+ *  one.
+ *
+ ********************************************************************/
+
+column_pred_t& column_pred_t::_set_int(const bool bLo, const long long v,
+                                       const bool bIncl)
+{
+    assert (_btype != CPB_STR);
+    if (_btype == CPB_NONE) _btype = CPB_INT;
+    if (bLo) {
+        _has_lo = true; _lo_incl = bIncl; _ilo = v; _dlo = (double)v;
+    }
+    else {
+        _has_hi = true; _hi_incl = bIncl; _ihi = v; _dhi = (double)v;
+    }
+    return (*this);
+}
+
+column_pred_t& column_pred_t::_set_double(const bool bLo, const double v,
+                                          const bool bIncl)
+{
+    assert (_btype != CPB_STR);
+    _btype = CPB_DOUBLE;
+    if (bLo) {
+        _has_lo = true; _lo_incl = bIncl; _dlo = v;
+    }
+    else {
+        _has_hi = true; _hi_incl = bIncl; _dhi = v;
+    }
+    return (*this);
+}
+
+column_pred_t& column_pred_t::_set_str(const bool bLo, const char* v,
+                                       const bool bIncl)
+{
+    assert (v);
+    assert ((_btype == CPB_NONE) || (_btype == CPB_STR));
+    _btype = CPB_STR;
+    if (bLo) {
+        _has_lo = true; _lo_incl = bIncl; _slo = v;
+    }
+    else {
+        _has_hi = true; _hi_incl = bIncl; _shi = v;
+    }
+    return (*this);
+}
+
+// a double as a long long, saturated
+static inline long long _clamp_ll(const double v)
+{
+    if (v >= 9.2e18) return (LLONG_MAX);
+    if (v <= -9.2e18) return (LLONG_MIN);
+    return ((long long)v);
+}
+
+bool column_pred_t::int_bounds(long long& lo, long long& hi) const
+{
+    lo = LLONG_MIN;
+    hi = LLONG_MAX;
+    if (_btype == CPB_INT) {
+        if (_has_lo) {
+            if (!_lo_incl && (_ilo == LLONG_MAX)) return (false);
+            lo = _lo_incl ? _ilo : _ilo + 1;
+        }
+        if (_has_hi) {
+            if (!_hi_incl && (_ihi == LLONG_MIN)) return (false);
+            hi = _hi_incl ? _ihi : _ihi - 1;
+        }
+    }
+    else {
+        assert (_btype == CPB_DOUBLE);
+        if (_has_lo) {
+            lo = _clamp_ll(_lo_incl ? ceil(_dlo) : floor(_dlo) + 1);
+        }
+        if (_has_hi) {
+            hi = _clamp_ll(_hi_incl ? floor(_dhi) : ceil(_dhi) - 1);
+        }
+    }
+    return (lo <= hi);
+}
+
+bool column_pred_t::overlaps(const long long vmin, const long long vmax) const
+{
+    if ((_btype != CPB_INT) && (_btype != CPB_DOUBLE)) return (true);
+    long long lo, hi;
+    if (!int_bounds(lo, hi)) return (false);
+    return ((vmax >= lo) && (vmin <= hi));
+}
+
+bool column_pred_t::overlaps(const double vmin, const double vmax) const
+{
+    if ((_btype != CPB_INT) && (_btype != CPB_DOUBLE)) return (true);
+    if (_has_lo && ((vmax < _dlo) || (!_lo_incl && (vmax == _dlo))))
+        return (false);
+    if (_has_hi && ((vmin > _dhi) || (!_hi_incl && (vmin == _dhi))))
+        return (false);
+    return (true);
+}
+
+bool column_pred_t::overlaps(const char* vmin, const char* vmax) const
+{
+    assert (vmin && vmax);
+    if (_btype != CPB_STR) return (true);
+    if (_has_lo) {
+        int r = strcmp(vmax, _slo.c_str());
+        if ((r < 0) || (!_lo_incl && (r == 0))) return (false);
+    }
+    if (_has_hi) {
+        int r = strcmp(vmin, _shi.c_str());
+        if ((r > 0) || (!_hi_incl && (r == 0))) return (false);
+    }
+    return (true);
+}
+
+c_str column_pred_t::to_string() const
+{
+    char lo[64] = "-inf";
+    char hi[64] = "+inf";
+    switch (_btype) {
+    case CPB_INT:
+        if (_has_lo) snprintf(lo, sizeof(lo), "%lld", _ilo);
+        if (_has_hi) snprintf(hi, sizeof(hi), "%lld", _ihi);
+        break;
+    case CPB_DOUBLE:
+        if (_has_lo) snprintf(lo, sizeof(lo), "%lf", _dlo);
+        if (_has_hi) snprintf(hi, sizeof(hi), "%lf", _dhi);
+        break;
+    case CPB_STR:
+        if (_has_lo) snprintf(lo, sizeof(lo), "'%s'", _slo.c_str());
+        if (_has_hi) snprintf(hi, sizeof(hi), "'%s'", _shi.c_str());
+        break;
+    default:
+        break;
+    }
+    return (c_str("%d%c%s,%s%c", _col,
+                  (_has_lo && _lo_incl) ? '[' : '(', lo,
+                  hi, (_has_hi && _hi_incl) ? ']' : ')'));
+}
+
+
+
+/********************************************************************
+ *
+ *  @struct: column_stage_t
+ *
+ *  @brief:  Collects the values of one column while the table is
+ *           scanned. Numeric blocks are sealed as soon as they fill
+ *           up. The codes of a string column are kept until the end,
+ *           since the dictionary is sorted only after all the values
+ *           are known.
+ *
+ ********************************************************************/
+
+struct column_stage_t
+{
+    column_t*                 _pcol;
+    uint_t                    _fsize;
+
+    vector<long long>         _ivals;    // current block
+    vector<double>            _dvals;    // current block
+
+    std::map<string,uint_t>   _codes;    // value -> code, in arrival order
+    vector<uint_t>            _scodes;   // code of every row
+    vector<string>            _svals;    // every row, if not a dictionary
+    bool                      _plain;
+
+    column_stage_t(column_t* pcol, const uint_t fsize)
+        : _pcol(pcol), _fsize(fsize), _plain(false) { }
+
+    bool append(const table_row_t* prow, const uint_t idx, char* buf);
+    void finish();
+
+private:
+
+    void _seal_ints();
+    void _seal_doubles();
+    void _to_plain();
+    void _seal_strings(const vector<uint_t>& remap);
+};
+
+
+bool column_stage_t::append(const table_row_t* prow, const uint_t idx,
+                            char* buf)
+{
+    // get_value() returns false on NULL, which is not supported
+    bool bOk = false;
+    switch (_pcol->_type) {
+    case SQL_BIT:      { bool v;      bOk = prow->get_value(idx, v); _ivals.push_back(v ? 1 : 0); break; }
+    case SQL_SMALLINT: { short v;     bOk = prow->get_value(idx, v); _ivals.push_back(v); break; }
+    case SQL_INT:      { int v;       bOk = prow->get_value(idx, v); _ivals.push_back(v); break; }
+    case SQL_LONG:     { long long v; bOk = prow->get_value(idx, v); _ivals.push_back(v); break; }
+    case SQL_CHAR:     { char v;      bOk = prow->get_value(idx, v); _ivals.push_back(v); break; }
+    case SQL_FLOAT:    { double v;    bOk = prow->get_value(idx, v); _dvals.push_back(v); break; }
+    case SQL_FIXCHAR:
+    case SQL_VARCHAR:
+        {
+            bOk = prow->get_value(idx, buf, _fsize+1);
+            string v(buf);
+            if (_plain) {
+                _svals.push_back(v);
+                break;
+            }
+            std::map<string,uint_t>::iterator it = _codes.find(v);
+            if (it == _codes.end()) {
+                it = _codes.insert(std::make_pair(v, (uint_t)_codes.size())).first;
+            }
+            _scodes.push_back(it->second);
+            if (_codes.size() > COLUMN_MAX_DICT_SIZE) _to_plain();
+            break;
+        }
+    default:
+        assert (0); // checked by the caller
+    }
+
+    if (_ivals.size() == COLUMN_BLOCK_ROWS) _seal_ints();
+    if (_dvals.size() == COLUMN_BLOCK_ROWS) _seal_doubles();
+    return (bOk);
+}
+
+
+void column_stage_t::_seal_ints()
+{
+    if (_ivals.empty()) return;
+    column_block_t* pb = new column_block_t();
+    pb->_enc = CE_FOR;
+    pb->_min = *std::min_element(_ivals.begin(), _ivals.end());
+    pb->_max = *std::max_element(_ivals.begin(), _ivals.end());
+    pb->_dmin = (double)pb->_min;
+    pb->_dmax = (double)pb->_max;
+    pb->_packed.init(bitpack_t::width((uint64_t)(pb->_max - pb->_min)),
+                     _ivals.size());
+    for (uint_t i=0; i<_ivals.size(); i++) {
+        pb->_packed.set(i, (uint64_t)(_ivals[i] - pb->_min));
+    }
+    _pcol->_blocks.push_back(pb);
+    _ivals.clear();
+}
+
+
+// a block of floats is packed as integers if all its values are integral
+// (many "float" columns, e.g. TPC-H prices and discounts, are scaled)
+void column_stage_t::_seal_doubles()
+{
+    if (_dvals.empty()) return;
+    const double LIMIT = 9007199254740992.0; // 2^53
+    bool bIntegral = true;
+    for (uint_t i=0; bIntegral && (i<_dvals.size()); i++) {
+        bIntegral = ((_dvals[i] == floor(_dvals[i])) &&
+                     (fabs(_dvals[i]) < LIMIT));
+    }
+
+    if (bIntegral) {
+        for (uint_t i=0; i<_dvals.size(); i++) {
+            _ivals.push_back((long long)_dvals[i]);
+        }
+        _dvals.clear();
+        _seal_ints();
+        return;
+    }
+
+    column_block_t* pb = new column_block_t();
+    pb->_enc = CE_DOUBLE;
+    pb->_dmin = *std::min_element(_dvals.begin(), _dvals.end());
+    pb->_dmax = *std::max_element(_dvals.begin(), _dvals.end());
+    pb->_doubles.swap(_dvals);
+    _pcol->_blocks.push_back(pb);
+    _dvals.clear();
+}
+
+
+// too many distinct values, give up the dictionary
+void column_stage_t::_to_plain()
+{
+    vector<const string*> values(_codes.size());
+    for (std::map<string,uint_t>::const_iterator it = _codes.begin();
+         it != _codes.end(); ++it) {
+        values[it->second] = &it->first;
+    }
+    _svals.reserve(_scodes.size());
+    for (uint_t i=0; i<_scodes.size(); i++) {
+        _svals.push_back(*values[_scodes[i]]);
+    }
+    _plain = true;
+    vector<uint_t>().swap(_scodes);
+    _codes.clear();
+}
+
+
+void column_stage_t::_seal_strings(const vector<uint_t>& remap)
+{
+    const uint_t nrows = (_plain ? _svals.size() : _scodes.size());
+    for (uint_t first=0; first<nrows; first+=COLUMN_BLOCK_ROWS) {
+        const uint_t cnt = std::min(COLUMN_BLOCK_ROWS, nrows - first);
+        column_block_t* pb = new column_block_t();
+
+        if (_plain) {
+            pb->_enc = CE_STRING;
+            pb->_offsets.resize(cnt);
+            for (uint_t i=0; i<cnt; i++) {
+                const string& s = _svals[first+i];
+                pb->_offsets[i] = pb->_chars.size();
+                pb->_chars.insert(pb->_chars.end(), s.begin(), s.end());
+                pb->_chars.push_back('\0');
+            }
+        }
+        else {
+            pb->_enc = CE_DICT;
+            pb->_min = LLONG_MAX;
+            pb->_max = LLONG_MIN;
+            for (uint_t i=0; i<cnt; i++) {
+                long long code = remap[_scodes[first+i]];
+                pb->_min = std::min(pb->_min, code);
+                pb->_max = std::max(pb->_max, code);
+            }
+            pb->_packed.init(bitpack_t::width((uint64_t)(pb->_max - pb->_min)),
+                             cnt);
+            for (uint_t i=0; i<cnt; i++) {
+                pb->_packed.set(i, (uint64_t)(remap[_scodes[first+i]] - pb->_min));
+            }
+        }
+        _pcol->_blocks.push_back(pb);
+    }
+}
+
+
+void column_stage_t::finish()
+{
+    if (!_pcol->is_string()) {
+        _seal_ints();
+        _seal_doubles();
+        return;
+    }
+
+    // the map is sorted, so the rank of each value is its final code
+    vector<uint_t> remap;
+    if (!_plain) {
+        remap.resize(_codes.size());
+        _pcol->_dict.reserve(_codes.size());
+        for (std::map<string,uint_t>::const_iterator it = _codes.begin();
+             it != _codes.end(); ++it) {
+            remap[it->second] = _pcol->_dict.size();
+            _pcol->_dict.push_back(it->first);
+        }
+    }
+    _seal_strings(remap);
+
+    _codes.clear();
+    vector<uint_t>().swap(_scodes);
+    vector<string>().swap(_svals);
+}
+
+
+
+
+/********************************************************************
+ *
+ *  class column_replica_t
+ *
+ ********************************************************************/
+
+column_replica_t::column_replica_t(table_man_t* pmanager)
+    : _pmanager(pmanager), _ptable(NULL),
+      _valid(false), _version(0), _refreshes(0)
+{
+    assert (_pmanager);
+    _ptable = _pmanager->table();
+    assert (_ptable);
+}
+
+column_replica_t::~column_replica_t()
+{
+    _valid = false;
+}
+
+
+
+/********************************************************************
+ *
+ *  @fn:    invalidate
+ *
+ *  @brief: See table_cache_t::invalidate()
+ *
+ ********************************************************************/
+
+void column_replica_t::invalidate()
+{
+    atomic_inc_uint(&_version);
+    _valid = false;
+}
+
+
+
+/********************************************************************
+ *
+ *  @fn:    refresh
+ *
+ *  @brief: Reads the whole table, with SH locks, in a new transaction.
+ *          The snapshot is published only if nobody wrote to the table
+ *          while it was being built.
+ *
+ ********************************************************************/
+
+w_rc_t column_replica_t::refresh(ss_m* db)
+{
+    assert (db);
+    CRITICAL_SECTION(refresh_cs, _refresh_lock);
+    if (_valid) return (RCOK);
+
+    uint_t version = _version;
+    membar_consumer();
+
+    time_t tstart = time(NULL);
+    snapshot_t* psnap = new snapshot_t();
+    W_DO(db->begin_xct());
+    w_rc_t e = _build(db, psnap);
+    if (e.is_error()) {
+        delete (psnap);
+        W_IGNORE(db->abort_xct());
+        return (e);
+    }
+    W_DO(db->commit_xct());
+
+    if (version != _version) {
+        // written while building, leave it invalid
+        delete (psnap);
+        return (RCOK);
+    }
+
+    // publish, the previous one is freed by its last scan
+    _snapshots.publish(psnap);
+    membar_producer();
+    _valid = true;
+
+    // an invalidation may have slipped in between the check and the set
+    if (atomic_cas_uint(&_version, version, version) != version) {
+        _valid = false;
+        return (RCOK);
+    }
+
+    _refreshes++;
+    TRACE( TRACE_ALWAYS, "(%s) columnar replica built in (%d) secs\n",
+           _ptable->name(), (time(NULL) - tstart));
+    print_stats();
+    return (RCOK);
+}
+
+
+
+/********************************************************************
+ *
+ *  @fn:    _build
+ *
+ *  @brief: Decodes all the records of the heap file and appends their
+ *          values to the columns
+ *
+ ********************************************************************/
+
+w_rc_t column_replica_t::_build(ss_m* db, snapshot_t* psnap)
+{
+    assert (psnap);
+
+    const uint_t ncols = _ptable->field_count();
+    vector<column_stage_t> stages;
+    stages.reserve(ncols);
+    for (uint_t i=0; i<ncols; i++) {
+        field_desc_t* pfd = _ptable->desc(i);
+        switch (pfd->type()) {
+        case SQL_TIME:
+        case SQL_NUMERIC:
+        case SQL_SNUMERIC:
+            TRACE( TRACE_ALWAYS, "(%s) field (%s) of unsupported type\n",
+                   _ptable->name(), pfd->name());
+            return RC(se_INVALID_INPUT);
+        default:
+            break;
+        }
+        psnap->_cols.push_back(new column_t(pfd->type()));
+        stages.push_back(column_stage_t(psnap->_cols[i], pfd->fieldmaxsize()));
+    }
+
+    table_row_t arow(_ptable);
+    array_guard_t<char> sbuf(new char[_ptable->maxsize()+1]);
+
+    for (int part=0; part<_ptable->heap_parts(); part++) {
+        scan_file_i scan(_ptable->heap_fid(part), ss_m::t_cc_record, false, SH);
+        pin_i* handle = NULL;
+        bool eof = false;
+        W_DO(scan.next(handle, 0, eof));
+        while (!eof) {
+            if (!_pmanager->load(&arow, handle->body()))
+                return RC(se_WRONG_DISK_DATA);
+            for (uint_t i=0; i<ncols; i++) {
+                if (!stages[i].append(&arow, i, sbuf)) {
+                    TRACE( TRACE_ALWAYS, "(%s) NULL value in (%s)\n",
+                           _ptable->name(), _ptable->desc(i)->name());
+                    return RC(se_INVALID_INPUT);
+                }
+            }
+            psnap->_rows++;
+            W_DO(scan.next(handle, 0, eof));
+        }
+    }
+
+    for (uint_t i=0; i<ncols; i++) {
+        stages[i].finish();
+        assert (psnap->_cols[i]->_blocks.size() ==
+                (psnap->_rows + COLUMN_BLOCK_ROWS - 1)/COLUMN_BLOCK_ROWS);
+    }
+    psnap->_blocks = (psnap->_rows + COLUMN_BLOCK_ROWS - 1)/COLUMN_BLOCK_ROWS;
+    return (RCOK);
+}
+
+
+
+void column_replica_t::print_stats() const
+{
+    snapshot_t* psnap = pin();
+    if (!psnap) {
+        TRACE( TRACE_STATISTICS, "%s: invalid, (%d) refreshes\n",
+               _ptable->name(), _refreshes);
+        return;
+    }
+
+    size_t sz = sizeof(snapshot_t);
+    for (uint_t i=0; i<psnap->_cols.size(); i++) {
+        const column_t* pcol = psnap->_cols[i];
+        uint_t dict = 0;
+        for (uint_t b=0; b<pcol->_blocks.size(); b++) {
+            if (pcol->_blocks[b]->_enc == CE_DICT) dict++;
+        }
+        TRACE( TRACE_DEBUG, "%s.%s: (%.1f) KB, (%d) dictionary values, (%d/%d) dictionary blocks\n",
+               _ptable->name(), _ptable->desc(i)->name(),
+               pcol->bytes()/1024.0, pcol->_dict.size(),
+               dict, pcol->_blocks.size());
+        sz += pcol->bytes();
+    }
+
+    double raw = (double)psnap->_rows*_ptable->maxsize();
+    TRACE( TRACE_STATISTICS, "%s: (%d) rows in (%d) blocks, (%.1f) MB (%.1f%% of the rows), (%d) refreshes\n",
+           _ptable->name(), psnap->_rows, psnap->_blocks,
+           sz/1048576.0, (raw > 0 ? 100.0*sz/raw : 0.0), _refreshes);
+    unpin(psnap);
+}
+
+
+
+
+/********************************************************************
+ *
+ *  class column_scan_t
+ *
+ ********************************************************************/
+
+column_scan_t::column_scan_t(column_replica_t* prep)
+    : _prep(prep), _psnap(NULL), _is_bound(false), _empty(false),
+      _blk(-1), _blocks_read(0), _blocks_skipped(0)
+{
+    if (_prep) _psnap = _prep->pin();
+    _sel.reserve(COLUMN_BLOCK_ROWS);
+    _tmp.reserve(COLUMN_BLOCK_ROWS);
+}
+
+
+void column_scan_t::where(const column_pred_t& pred)
+{
+    assert (!_is_bound);
+    _preds.push_back(pred);
+}
+
+void column_scan_t::where(const vector<column_pred_t>& preds)
+{
+    for (uint_t i=0; i<preds.size(); i++) where(preds[i]);
+}
+
+
+
+/********************************************************************
+ *
+ *  @fn:    _bind
+ *
+ *  @brief: Translates the bounds of each predicate to the domain of
+ *          its column. String bounds become ranges of dictionary codes.
+ *
+ ********************************************************************/
+
+void column_scan_t::_bind()
+{
+    assert (_psnap);
+    _is_bound = true;
+
+    for (uint_t i=0; i<_preds.size(); i++) {
+        const column_pred_t& p = _preds[i];
+        assert (p._col < _psnap->_cols.size());
+        const column_t* pcol = _psnap->_cols[p._col];
+        bound_pred_t bp(p);
+
+        if (p._btype == column_pred_t::CPB_NONE) {
+            continue; // no bounds
+        }
+        else if (pcol->is_string()) {
+            assert (p._btype == column_pred_t::CPB_STR);
+            if (pcol->_dict.empty()) {
+                bp._by_string = true;
+            }
+            else {
+                const vector<string>& d = pcol->_dict;
+                long long lo = 0;
+                long long hi = (long long)d.size() - 1;
+                if (p._has_lo) {
+                    lo = (p._lo_incl ?
+                          std::lower_bound(d.begin(), d.end(), p._slo) :
+                          std::upper_bound(d.begin(), d.end(), p._slo)) - d.begin();
+                }
+                if (p._has_hi) {
+                    hi = (p._hi_incl ?
+                          std::upper_bound(d.begin(), d.end(), p._shi) :
+                          std::lower_bound(d.begin(), d.end(), p._shi)) - d.begin() - 1;
+                }
+                bp._lo = lo;
+                bp._hi = hi;
+                bp._empty = (lo > hi);
+            }
+        }
+        else if (pcol->_type == SQL_FLOAT) {
+            assert (p._btype != column_pred_t::CPB_STR);
+            bp._by_double = true;
+            bp._empty = (p._has_lo && p._has_hi &&
+                         ((p._dlo > p._dhi) ||
+                          ((p._dlo == p._dhi) && !(p._lo_incl && p._hi_incl))));
+        }
+        else {
+            assert (p._btype != column_pred_t::CPB_STR);
+            bp._empty = !p.int_bounds(bp._lo, bp._hi);
+        }
+
+        if (bp._empty) _empty = true;
+        _bound.push_back(bp);
+    }
+}
+
+
+
+/********************************************************************
+ *
+ *  @fn:    _block_bounds
+ *
+ *  @brief: Checks the zone map of a block. Returns false if no row of
+ *          the block can qualify, sets bAll if all of them do. For
+ *          packed blocks the bounds are returned as offsets from the
+ *          block minimum.
+ *
+ ********************************************************************/
+
+bool column_scan_t::_block_bounds(const bound_pred_t& bp,
+                                  const column_block_t* pb,
+                                  long long& lo, long long& hi,
+                                  bool& bAll) const
+{
+    bAll = false;
+    if (bp._by_string) return (true);
+
+    const column_pred_t& p = bp._pred;
+    if (pb->_enc == CE_DOUBLE) {
+        if (p._has_lo && ((pb->_dmax < p._dlo) ||
+                          (!p._lo_incl && (pb->_dmax == p._dlo))))
+            return (false);
+        if (p._has_hi && ((pb->_dmin > p._dhi) ||
+                          (!p._hi_incl && (pb->_dmin == p._dhi))))
+            return (false);
+        bAll = ((!p._has_lo || (pb->_dmin > p._dlo) ||
+                 (p._lo_incl && (pb->_dmin == p._dlo))) &&
+                (!p._has_hi || (pb->_dmax < p._dhi) ||
+                 (p._hi_incl && (pb->_dmax == p._dhi))));
+        return (true);
+    }
+
+    // packed block (integers, integral floats or codes)
+    if (bp._by_double) {
+        if (!p.int_bounds(lo, hi)) return (false);
+    }
+    else {
+        lo = bp._lo;
+        hi = bp._hi;
+    }
+    if ((pb->_max < lo) || (pb->_min > hi)) return (false);
+    bAll = ((pb->_min >= lo) && (pb->_max <= hi));
+    lo = (lo > pb->_min) ? (lo - pb->_min) : 0;
+    hi = (hi < pb->_max) ? (hi - pb->_min) : (pb->_max - pb->_min);
+    return (true);
+}
+
+
+bool column_scan_t::_qualifies(const bound_pred_t& bp, const column_t* pcol,
+                               const column_block_t* pb, const uint_t row,
+                               const long long lo, const long long hi) const
+{
+    const column_pred_t& p = bp._pred;
+    switch (pb->_enc) {
+    case CE_FOR:
+    case CE_DICT:
+        {
+            uint64_t v = pb->_packed.get(row);
+            return ((v >= (uint64_t)lo) && (v <= (uint64_t)hi));
+        }
+    case CE_DOUBLE:
+        {
+            double v = pb->_doubles[row];
+            if (p._has_lo && ((v < p._dlo) || (!p._lo_incl && (v == p._dlo))))
+                return (false);
+            if (p._has_hi && ((v > p._dhi) || (!p._hi_incl && (v == p._dhi))))
+                return (false);
+            return (true);
+        }
+    case CE_STRING:
+        {
+            const char* v = &pb->_chars[pb->_offsets[row]];
+            if (p._has_lo) {
+                int r = strcmp(v, p._slo.c_str());
+                if ((r < 0) || (!p._lo_incl && (r == 0))) return (false);
+            }
+            if (p._has_hi) {
+                int r = strcmp(v, p._shi.c_str());
+                if ((r > 0) || (!p._hi_incl && (r == 0))) return (false);
+            }
+            return (true);
+        }
+    }
+    return (false);
+}
+
+
+
+/********************************************************************
+ *
+ *  @fn:    next_block
+ *
+ *  @brief: Moves to the next block with qualifying rows. The first
+ *          predicate that cannot be answered by the zone map builds
+ *          the selection of the block, the rest refine it.
+ *
+ ********************************************************************/
+
+bool column_scan_t::next_block()
+{
+    if (!_psnap) return (false);
+    if (!_is_bound) _bind();
+    if (_empty) return (false);
+
+    while (++_blk < (int)_psnap->_blocks) {
+        const uint_t nrows = _psnap->block_rows(_blk);
+        bool bSelected = false;
+        bool bSkip = false;
+        _sel.clear();
+
+        for (uint_t i=0; i<_bound.size(); i++) {
+            const bound_pred_t& bp = _bound[i];
+            const column_t* pcol = _psnap->_cols[bp._col];
+            const column_block_t* pb = pcol->_blocks[_blk];
+            long long lo, hi;
+            bool bAll;
+            if (!_block_bounds(bp, pb, lo, hi, bAll)) {
+                bSkip = true;
+                break;
+            }
+            if (bAll) continue;
+
+            if (!bSelected) {
+                for (uint_t r=0; r<nrows; r++) {
+                    if (_qualifies(bp, pcol, pb, r, lo, hi)) _sel.push_back(r);
+                }
+                bSelected = true;
+            }
+            else {
+                _tmp.clear();
+                for (uint_t k=0; k<_sel.size(); k++) {
+                    if (_qualifies(bp, pcol, pb, _sel[k], lo, hi))
+                        _tmp.push_back(_sel[k]);
+                }
+                _sel.swap(_tmp);
+            }
+            if (_sel.empty()) break;
+        }
+
+        if (bSkip) {
+            _blocks_skipped++;
+            continue;
+        }
+        _blocks_read++;
+        if (!bSelected) {
+            for (uint_t r=0; r<nrows; r++) _sel.push_back(r);
+        }
+        if (!_sel.empty()) return (true);
+    }
+    return (false);
+}
+
+
+
+/********************************************************************
+ *
+ *  @fn:    materialize
+ *
+ *  @brief: Decodes all the columns of a qualifying row
+ *
+ ********************************************************************/
+
+void column_scan_t::materialize(const uint_t i, table_row_t* prow) const
+{
+    assert (prow);
+    assert (i < _sel.size());
+    for (uint_t c=0; c<_psnap->_cols.size(); c++) {
+        const column_t* pcol = _psnap->_cols[c];
+        const uint_t row = _sel[i];
+        switch (pcol->_type) {
+        case SQL_BIT:      prow->set_value(c, (bool)(pcol->get_int(_blk, row) != 0)); break;
+        case SQL_SMALLINT: prow->set_value(c, (short)pcol->get_int(_blk, row)); break;
+        case SQL_INT:      prow->set_value(c, (int)pcol->get_int(_blk, row)); break;
+        case SQL_LONG:     prow->set_value(c, (long long)pcol->get_int(_blk, row)); break;
+        case SQL_CHAR:     prow->set_value(c, (char)pcol->get_int(_blk, row)); break;
+        case SQL_FLOAT:    prow->set_value(c, pcol->get_double(_blk, row)); break;
+        case SQL_FIXCHAR:
+        case SQL_VARCHAR:  prow->set_value(c, pcol->get_str(_blk, row)); break;
+        default:
+            assert (0); // not in a replica
+        }
+    }
+}
+
+
+EXIT_NAMESPACE(shore);
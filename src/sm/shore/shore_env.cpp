@@ -35,6 +35,10 @@
 #include "sm/shore/shore_flusher.h"
 #include "sm/shore/shore_helper_loader.h"
 
+#include <algorithm>
+#include <cerrno>
+#include <ctime>
+
 
 ENTER_NAMESPACE(shore);
 
@@ -65,9 +69,11 @@ void env_stats_t::print_env_stats() const
 {
     TRACE( TRACE_STATISTICS, "===============================\n");
     TRACE( TRACE_STATISTICS, "Database transaction statistics\n");
-    TRACE( TRACE_STATISTICS, "Attempted: %d\n", _ntrx_att);
-    TRACE( TRACE_STATISTICS, "Committed: %d\n", _ntrx_com);
-    TRACE( TRACE_STATISTICS, "Aborted  : %d\n", (_ntrx_att-_ntrx_com));
+    uint_t att = trx_att();
+    uint_t com = trx_com();
+    TRACE( TRACE_STATISTICS, "Attempted: %d\n", att);
+    TRACE( TRACE_STATISTICS, "Committed: %d\n", com);
+    TRACE( TRACE_STATISTICS, "Aborted  : %d\n", (att-com));
     TRACE( TRACE_STATISTICS, "===============================\n");
 }
 
@@ -95,7 +101,7 @@ ShoreEnv::ShoreEnv()
       _active_cpu_count(0),
       _worker_cnt(0),
       _measure(MST_UNDEF),
-      _pd(PD_NORMAL),
+      _pd(PD_NORMAL), _heap_parts(1),
       _insert_freq(0),_delete_freq(0),_probe_freq(100),
       _request_pool(sizeof(trx_request_t)),
       _bUseSLI(false),_bUseELR(false),_bUseFlusher(false),
@@ -131,6 +137,18 @@ ShoreEnv::ShoreEnv()
         _pd |= PD_PADDED;
     }
 
+    // Partitioned heaps for the append-heavy tables (not with MRBTs)
+    _heap_parts = ev->getVarInt("db-heap-parts",1);
+    if ((_heap_parts > 1) && (_pd & (PD_MRBT_PART | PD_MRBT_LEAF))) {
+        TRACE( TRACE_ALWAYS, "Heap partitioning not used with (%s)\n",
+               physical.c_str());
+        _heap_parts = 1;
+    }
+    if (_heap_parts > 1) {
+        _pd |= PD_HEAP_PART;
+        TRACE( TRACE_ALWAYS, "Append-heavy tables in (%d) heap parts\n", _heap_parts);
+    }
+
 
     _bUseSLI = ev->getVarInt("db-worker-sli",0);
     fprintf(stdout, "SLI= %s\n", (_bUseSLI ? "enabled" : "disabled"));
@@ -367,6 +385,23 @@ void ShoreEnv::reset_skew()
 }
 
 
+/******************************************************************** 
+ *
+ *  @fn:    Related to scripted skew scenarios
+ *  @brief: Place and remove the hot spot. The workloads that support
+ *          the scenarios place it on their own skewers.
+ *
+ ********************************************************************/
+void ShoreEnv::set_hot_spot(double /* pos */, double /* area */, int /* load */)
+{
+    TRACE( TRACE_ALWAYS, "Hot spots not supported by this workload\n");
+}
+
+void ShoreEnv::clear_hot_spot()
+{
+}
+
+
 /******************************************************************** 
  *
  *  @fn:    Related to environment workers
@@ -626,6 +661,17 @@ int ShoreEnv::statistics()
     if (_base_flusher) _base_flusher->statistics();
 #endif    
 
+    // the perf counters per xct type and region, if configured
+    perfctr_print();
+
+    {
+        CRITICAL_SECTION(regtablecs, table_man_t::register_table_lock);
+        std::map<stid_t,table_man_t*>::iterator it = table_man_t::stid_to_tableman.begin();
+        for (; it != table_man_t::stid_to_tableman.end(); ++it) {
+            it->second->print_update_stats();
+        }
+    }
+
     // If reached this point the Shore environment is closed
     //gatherstats_sm();
     return (0);
@@ -633,6 +679,30 @@ int ShoreEnv::statistics()
 
 
 
+/******************************************************************** 
+ *
+ *  @fn:    gather_{worker,flusher}_stats
+ *
+ *  @brief: Sums the stats of the base workers and of the flusher
+ *
+ ********************************************************************/
+
+void ShoreEnv::gather_worker_stats(worker_stats_t& agg)
+{
+    for (uint i=0; i<_workers.size(); i++) {
+        agg += _workers[i]->get_stats();
+    }
+}
+
+void ShoreEnv::gather_flusher_stats(flusher_stats_t& agg)
+{
+#ifdef CFG_FLUSHER
+    if (_base_flusher) agg += _base_flusher->get_stats();
+#endif
+}
+
+
+
 /** Storage manager functions */
 
 
@@ -698,6 +768,7 @@ int ShoreEnv::close_sm()
      *  destroying the ss_m instance causes the SSM to shutdown
      */
     delete (_pssm);
+    _pssm = NULL;
 
     // If we reached this point the sm is closed
     return (0);
@@ -943,6 +1014,344 @@ int ShoreEnv::checkpoint()
 
 
 
+/********************************************************************* 
+ *
+ *  Database snapshots
+ *
+ *  A snapshot is a directory with:
+ *  - device   : a copy of the device
+ *  - log/     : a copy of all the files of the log directory
+ *  - MANIFEST : the system that took it
+ *
+ *  The copies are taken while the sm is shut down cleanly, so that the
+ *  restore is just a mount of a consistent device and log. The files are
+ *  reflinked if the filesystem can do it, otherwise copied sparsely by
+ *  db-snapshot-threads threads (see util/fileclone.h).
+ *
+ *********************************************************************/
+
+static const char* SNAPSHOT_DEVICE   = "device";
+static const char* SNAPSHOT_LOG      = "log";
+static const char* SNAPSHOT_MANIFEST = "MANIFEST";
+
+
+static int _write_snapshot_manifest(const string& dir, const string& sysname,
+                                    const string& device)
+{
+    string path = dir + "/" + SNAPSHOT_MANIFEST;
+    FILE* fm = fopen(path.c_str(), "w");
+    if (!fm) return (errno);
+    fprintf(fm, "system %s\n", sysname.c_str());
+    fprintf(fm, "device %s\n", device.c_str());
+    fprintf(fm, "taken %ld\n", (long)time(NULL));
+    if (fclose(fm)) return (errno);
+    return (0);
+}
+
+
+static bool _check_snapshot_manifest(const string& dir, const string& sysname)
+{
+    string path = dir + "/" + SNAPSHOT_MANIFEST;
+    FILE* fm = fopen(path.c_str(), "r");
+    if (!fm) {
+        TRACE( TRACE_ALWAYS, "(%s) is not a snapshot\n", dir.c_str());
+        return (false);
+    }
+    char tag[256];
+    char value[256];
+    bool bOk = false;
+    while (fscanf(fm, "%255s %255s", tag, value) == 2) {
+        if (!strcmp(tag, "system")) {
+            bOk = (sysname == value);
+            if (!bOk) {
+                TRACE( TRACE_ALWAYS, "(%s) is a snapshot of (%s), not of (%s)\n",
+                       dir.c_str(), value, sysname.c_str());
+            }
+            break;
+        }
+    }
+    fclose(fm);
+    return (bOk);
+}
+
+
+
+/********************************************************************* 
+ *
+ *  @fn:      _shutdown_for_copy
+ *
+ *  @brief:   Stops the workers, takes a checkpoint, and closes the sm,
+ *            so that the device and the log on disk are consistent
+ *
+ *********************************************************************/
+
+int ShoreEnv::_shutdown_for_copy()
+{
+    if (!is_initialized()) {
+        TRACE( TRACE_ALWAYS, "Environment not initialized...\n");
+        return (1);
+    }
+
+    stop();
+
+    CRITICAL_SECTION(cs, _init_mutex);
+    w_rc_t e = _pssm->checkpoint();
+    if (e.is_error()) {
+        TRACE( TRACE_ALWAYS, "Checkpoint failed [0x%x]\n", e.err_num());
+    }
+    close_sm();
+    _initialized = false;
+    return (0);
+}
+
+
+
+/********************************************************************* 
+ *
+ *  @fn:      _reopen_after_copy
+ *
+ *  @brief:   Mounts the device again and reloads the catalog, as init()
+ *            does for an existing database, and restarts the workers
+ *
+ *********************************************************************/
+
+int ShoreEnv::_reopen_after_copy()
+{
+    {
+        CRITICAL_SECTION(cs, _init_mutex);
+
+        // whatever db-clobberdev was, the device now has a database
+        _sys_opts[SHORE_SYS_OPTIONS[0][0]] = "0";
+
+        if (start_sm()) {
+            TRACE( TRACE_ALWAYS, "Error starting Shore database\n");
+            return (1);
+        }
+
+        W_COERCE(db()->begin_xct());
+        W_COERCE(load_and_register_fids());
+        W_COERCE(db()->commit_xct());    
+        if (int rval = post_init()) {
+            TRACE( TRACE_ALWAYS, "Error in Shore post-init\n");
+            return (rval);
+        }
+        _initialized = true;
+    }
+    return (start());
+}
+
+
+
+/********************************************************************* 
+ *
+ *  @fn:      snapshot
+ *
+ *  @brief:   Copies the device and the log to dir
+ *
+ *  @return:  0 on success, non-zero otherwise. The environment is
+ *            restarted in any case.
+ *
+ *********************************************************************/
+
+int ShoreEnv::snapshot(const string& dir)
+{
+    string device = _dev_opts[SHORE_DB_OPTIONS[0][0]];
+    string logdir = _sm_opts[SHORE_DB_SM_OPTIONS[1][0]];
+    string snaplog = dir + "/" + SNAPSHOT_LOG;
+    int threads = envVar::instance()->getVarInt("db-snapshot-threads",8);
+
+    TRACE( TRACE_ALWAYS, "Snapshot of (%s) to (%s)\n", 
+           _sysname.c_str(), dir.c_str());
+
+    stopwatch_t timer;
+    if (int rv = _shutdown_for_copy()) return (rv);
+    double tclose = timer.time();
+
+    fclone_method_t method = FCLONE_SPARSE_COPY;
+    off_t copied = 0;
+    int rv = fmake_dir(snaplog.c_str());
+    if (!rv) rv = fclean_dir(snaplog.c_str());
+    if (!rv) rv = fclone_file(device.c_str(), (dir + "/" + SNAPSHOT_DEVICE).c_str(),
+                              threads, &method, &copied);
+    if (!rv) rv = fclone_dir(logdir.c_str(), snaplog.c_str(), threads);
+    if (!rv) rv = _write_snapshot_manifest(dir, _sysname, device);
+    double tcopy = timer.time();
+
+    if (rv) {
+        TRACE( TRACE_ALWAYS, "Snapshot to (%s) failed: %s\n", 
+               dir.c_str(), strerror(rv));
+    }
+    else {
+        TRACE( TRACE_ALWAYS, 
+               "Snapshot taken. Close (%.2f) Copy (%.2f) secs (%s, %.1f MB)\n",
+               tclose, tcopy - tclose, 
+               (method == FCLONE_REFLINK ? "reflink" : "sparse copy"),
+               (double)copied/(1024*1024));
+    }
+
+    if (int rval = _reopen_after_copy()) return (rval);
+    TRACE( TRACE_ALWAYS, "Reopened in (%.2f) secs\n", timer.time());
+    return (rv);
+}
+
+
+
+/********************************************************************* 
+ *
+ *  @fn:      restore
+ *
+ *  @brief:   Replaces the device and the log with the ones of a snapshot
+ *            and remounts
+ *
+ *  @note:    If a copy fails the device is left half-restored, so the
+ *            environment is not reopened
+ *
+ *********************************************************************/
+
+int ShoreEnv::restore(const string& dir)
+{
+    string device = _dev_opts[SHORE_DB_OPTIONS[0][0]];
+    string logdir = _sm_opts[SHORE_DB_SM_OPTIONS[1][0]];
+    string snaplog = dir + "/" + SNAPSHOT_LOG;
+    int threads = envVar::instance()->getVarInt("db-snapshot-threads",8);
+
+    if (!_check_snapshot_manifest(dir, _sysname)) return (1);
+
+    TRACE( TRACE_ALWAYS, "Restoring (%s) from (%s)\n", 
+           _sysname.c_str(), dir.c_str());
+
+    stopwatch_t timer;
+    if (int rv = _shutdown_for_copy()) return (rv);
+    double tclose = timer.time();
+
+    fclone_method_t method = FCLONE_SPARSE_COPY;
+    off_t copied = 0;
+    int rv = fclone_file((dir + "/" + SNAPSHOT_DEVICE).c_str(), device.c_str(),
+                         threads, &method, &copied);
+
+    // the log files of the snapshot replace all the current ones,
+    // otherwise newer partitions would be recovered on top of it
+    if (!rv) rv = fclean_dir(logdir.c_str());
+    if (!rv) rv = fclone_dir(snaplog.c_str(), logdir.c_str(), threads);
+    double tcopy = timer.time();
+
+    if (rv) {
+        TRACE( TRACE_ALWAYS, 
+               "Restore from (%s) failed: %s\n"
+               "The database is left closed\n",
+               dir.c_str(), strerror(rv));
+        return (rv);
+    }
+
+    if (int rval = _reopen_after_copy()) return (rval);
+    TRACE( TRACE_ALWAYS, 
+           "Restored. Close (%.2f) Copy (%.2f) Reopen (%.2f) secs (%s, %.1f MB)\n",
+           tclose, tcopy - tclose, timer.time() - tcopy,
+           (method == FCLONE_REFLINK ? "reflink" : "sparse copy"),
+           (double)copied/(1024*1024));
+    return (0);
+}
+
+
+
+/********************************************************************* 
+ *
+ *  @fn:      start_bulkload()
+ *
+ *  @brief:   If db-bulkload is set, switches all the registered tables
+ *            to bulk-load mode. Returns true if at least one table was
+ *            switched. The index buffers may take up to db-bulkload-mem
+ *            MB.
+ *
+ *  @note:    Should be called after the tables have been created and 
+ *            registered, before the loaders are fired up
+ *
+ *********************************************************************/
+
+bool ShoreEnv::start_bulkload()
+{
+    if (envVar::instance()->getVarInt("db-bulkload",0) == 0) {
+        return (false);
+    }
+    index_bulk_buf_t::set_mem_cap(envVar::instance()->getVarInt("db-bulkload-mem",4096));
+
+    bool bstarted = false;
+    CRITICAL_SECTION(regtablecs, table_man_t::register_table_lock);
+    std::map<stid_t,table_man_t*>::iterator it = table_man_t::stid_to_tableman.begin();
+    for (; it != table_man_t::stid_to_tableman.end(); ++it) {
+        if (it->second->start_bulkload()) bstarted = true;
+    }
+
+    TRACE( TRACE_ALWAYS, "Bulk-loading indexes (%s)\n", 
+           (bstarted ? "enabled" : "no table supports it"));
+    return (bstarted);
+}
+
+
+
+/********************************************************************* 
+ *
+ *  @fn:      finish_bulkload()
+ *
+ *  @brief:   Builds the indexes of all the tables that are in bulk-load
+ *            mode, using up to (builders) threads. Each thread sorts and
+ *            builds one index (partition) at a time.
+ *
+ *  @note:    Should be called in the context of a smthread, after all 
+ *            the loaders have joined
+ *
+ *********************************************************************/
+
+w_rc_t ShoreEnv::finish_bulkload(const int builders)
+{
+    vector<table_man_t*> tables;
+    vector<index_bulk_buf_t*> work;
+    {
+        CRITICAL_SECTION(regtablecs, table_man_t::register_table_lock);
+        std::map<stid_t,table_man_t*>::iterator it = table_man_t::stid_to_tableman.begin();
+        for (; it != table_man_t::stid_to_tableman.end(); ++it) {
+            if (!it->second->is_bulkloading()) continue;
+            tables.push_back(it->second);
+            vector<index_bulk_buf_t*>& bufs = it->second->bulkloader()->bufs();
+            work.insert(work.end(), bufs.begin(), bufs.end());
+        }
+    }
+    if (tables.empty()) return (RCOK);
+
+    // The builders pop from the back, so the largest indexes go first
+    std::sort(work.begin(), work.end(), bulk_buf_smaller);
+
+    time_t tstart = time(NULL);
+    int nbuilders = std::min((int)work.size(), std::max(builders,1));
+    TRACE( TRACE_ALWAYS, "Building (%d) indexes with (%d) threads\n",
+           work.size(), nbuilders);
+
+    mcs_lock work_lock;
+    array_guard_t< guard<index_builder_smt_t> > builder(new guard<index_builder_smt_t>[nbuilders]);
+    for (int i=0; i<nbuilders; i++) {
+        builder[i] = new index_builder_smt_t(c_str("bld-%d",i), _pssm, 
+                                             &work, &work_lock);
+        builder[i]->fork();
+    }
+
+    int rv = 0;
+    for (int i=0; i<nbuilders; i++) {
+        builder[i]->join();
+        rv += builder[i]->rv();
+    }
+
+    // Back to normal mode, release the buffers
+    for (uint i=0; i<tables.size(); i++) {
+        tables[i]->end_bulkload();
+    }
+
+    TRACE( TRACE_ALWAYS, "Indexes built in (%d) secs...\n", (time(NULL) - tstart));
+    if (rv) return (RC(se_ERROR_IN_IDX_LOAD));
+    return (RCOK);
+}
+
+
+
 /****************************************************************** 
  *
  *  @fn:    get_trx_{att,com}()
@@ -951,12 +1360,12 @@ int ShoreEnv::checkpoint()
 
 uint_t ShoreEnv::get_trx_att() const
 {
-    return (*&_env_stats._ntrx_att);
+    return (_env_stats.trx_att());
 }
 
 uint_t ShoreEnv::get_trx_com() const
 {
-    return (*&_env_stats._ntrx_com);
+    return (_env_stats.trx_com());
 }
 
 
@@ -979,6 +1388,37 @@ void ShoreEnv::set_active_cpu_count(const uint_t actcpucnt)
 
 
 
+/******************************************************************** 
+ *
+ *  @fn:    client_cpu()
+ *
+ *  @brief: Returns the cpu for a client that works on the apos-th out
+ *          of atotal slices of the key space (e.g. its warehouse). The
+ *          client lands on the NUMA node that owns that slice.
+ *
+ ********************************************************************/
+
+processorid_t ShoreEnv::client_cpu(const uint apos, const uint atotal, 
+                                   const char* aname)
+{
+    if (!_client_placement) {
+        _client_placement = new cpu_placement_t("clients", _active_cpu_count);
+    }
+    return (_client_placement->next_for_range(apos, atotal, aname));
+}
+
+void ShoreEnv::reset_client_placement()
+{
+    if (_client_placement) _client_placement->reset();
+}
+
+void ShoreEnv::print_client_placement() const
+{
+    if (_client_placement) _client_placement->print();
+}
+
+
+
 /** Helper functions */
 
 
@@ -1316,4 +1756,23 @@ void ShoreEnv::db_fetch_init()
     delete (db_fetcher);
 }
 
+
+
+/****************************************************************** 
+ *
+ *  @fn:    db_columns_init
+ *
+ *  @brief: Starts the thread that builds the columnar replicas and
+ *          then deletes it
+ *
+ ******************************************************************/
+
+void ShoreEnv::db_columns_init()
+{
+    column_builder_t* db_builder = new column_builder_t(this);
+    db_builder->fork();
+    db_builder->join();
+    delete (db_builder);
+}
+
 EXIT_NAMESPACE(shore);
@@ -34,6 +34,8 @@
 #include "sm/shore/shore_file_desc.h"
 #include "sm/shore/shore_index.h"
 
+#include <algorithm>
+
 ENTER_NAMESPACE(shore);
 
 
@@ -50,7 +52,8 @@ file_desc_t::file_desc_t(const char* name,
                          const uint_t fcnt,
                          const uint4_t& apd)
     : _field_count(fcnt), _vid(vid_t::null), 
-      _root_iid(stid_t::null), _pd(apd), _fid(stid_t::null)
+      _root_iid(stid_t::null), _pd(apd & ~PD_HEAP_PART),
+      _heap_parts(1), _heap_fids(NULL), _fid(stid_t::null)
 {
     assert (fcnt>0);
 
@@ -71,6 +74,51 @@ file_desc_t::file_desc_t(const char* name,
 file_desc_t::~file_desc_t() 
 { 
     pthread_mutex_destroy(&_fschema_mutex);
+    if (_heap_fids) {
+        delete [] _heap_fids;
+        _heap_fids = NULL;
+    }
+}
+
+
+
+/*********************************************************************
+ *
+ *  @fn:    set_heap_parts
+ *
+ *  @brief: Splits the heap of the file to parts sub-files. The file
+ *          gets the PD_HEAP_PART flag only if it is really split.
+ *
+ *********************************************************************/
+
+void file_desc_t::set_heap_parts(const int parts)
+{
+    assert (!is_fid_valid());
+    if (_heap_fids) delete [] _heap_fids;
+    _heap_fids = NULL;
+
+    _heap_parts = std::max(1, std::min(parts, (int)MAX_HEAP_PARTS));
+    if (_heap_parts == 1) {
+        _pd &= ~PD_HEAP_PART;
+        return;
+    }
+
+    _pd |= PD_HEAP_PART;
+    _heap_fids = new stid_t[_heap_parts];
+    for (int i=0; i<_heap_parts; i++) _heap_fids[i] = stid_t::null;
+}
+
+
+// Each thread gets a slot the first time it inserts to a partitioned
+// heap. Threads with consecutive slots go to different sub-files.
+static volatile uint_t _heap_slots = 0;
+static __thread int _my_heap_slot = -1;
+
+int file_desc_t::my_heap_part() const
+{
+    if (_heap_parts <= 1) return (0);
+    if (_my_heap_slot < 0) _my_heap_slot = atomic_inc_uint_nv(&_heap_slots) - 1;
+    return (_my_heap_slot % _heap_parts);
 }
 
 
@@ -145,6 +193,21 @@ w_rc_t file_desc_t::find_fid(ss_m* db)
         cerr << "Problem finding table " << _name << endl;
         return RC(se_TABLE_NOT_FOUND);
     }
+
+    // the sub-files of a partitioned heap
+    for (int i=1; i<_heap_parts; i++) {
+        char tmp[100];
+        sprintf(tmp, "%s_h%d", _name, i);
+        W_DO(ss_m::find_assoc(root_iid(),
+                              vec_t(tmp, strlen(tmp)),
+                              &info, infosize,
+                              found));
+        if (!found) {
+            cerr << "Problem finding heap part " << tmp << endl;
+            return RC(se_TABLE_NOT_FOUND);
+        }
+        _heap_fids[i] = info.fid();
+    }
     
     return RCOK;
 }
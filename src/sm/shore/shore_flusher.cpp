@@ -99,6 +99,21 @@ void flusher_stats_t::reset()
     trigByTimeout = 0;
 }
 
+flusher_stats_t& flusher_stats_t::operator+=(flusher_stats_t const& rhs)
+{
+    served += rhs.served;
+    flushes += rhs.flushes;
+
+    logsize += rhs.logsize;
+    alreadyFlushed += rhs.alreadyFlushed;
+    waiting += rhs.waiting;
+
+    trigByXcts += rhs.trigByXcts;
+    trigBySize += rhs.trigBySize;
+    trigByTimeout += rhs.trigByTimeout;
+    return (*this);
+}
+
 
 
 /****************************************************************** 
@@ -96,6 +96,13 @@ void db_log_smt_t::work()
 }
 
 
+void db_snapshot_smt_t::work() 
+{
+    assert (_env);
+    _rv = (_bRestore ? _env->restore(_dir) : _env->snapshot(_dir));
+}
+
+
 void db_load_smt_t::work() 
 {
     _rc = _env->loaddata();
@@ -42,7 +42,7 @@ ENTER_NAMESPACE(shore);
 
 simple_table_iter_t::simple_table_iter_t(ss_m* db, file_desc_t* file, 
                                          lock_mode_t alm)
-    : _db(db), _opened(false), _file(file), _lm(alm)
+    : _db(db), _opened(false), _file(file), _lm(alm), _part(0)
 {
     assert (_db);
 }
@@ -53,11 +53,23 @@ simple_table_iter_t::~simple_table_iter_t()
 }
 
 
+bool simple_table_iter_t::use_zones(zone_map_t* pzones, 
+                                    const vector<column_pred_t>& preds)
+{
+    assert (!_opened);
+    if (!pzones || preds.empty()) return (false);
+    _pzone = new zone_cursor_t(pzones, preds, _lm);
+    if (_pzone->opened()) return (true);
+    _pzone.done();
+    return (false);
+}
+
+
 w_rc_t simple_table_iter_t::open_scan()
 {
     if (!_opened) {
         assert (_db);
-        _scanner = new scan_file_i(_file->fid(), 
+        _scanner = new scan_file_i(_file->heap_fid(_part), 
                                    ss_m::t_cc_record, 
                                    false, _lm);
         _opened = true;
@@ -68,8 +80,18 @@ w_rc_t simple_table_iter_t::open_scan()
 
 w_rc_t simple_table_iter_t::next(bool& eof, pin_i*& handle)
 {
+    if (_pzone) return (_pzone->next(handle, eof));
+
     if (!_opened) open_scan();
     W_DO(_scanner->next(handle, 0, eof));
+
+    // a partitioned heap continues with its next sub-file
+    while (eof && (_part+1 < _file->heap_parts())) {
+        close_scan();
+        _part++;
+        W_DO(open_scan());
+        W_DO(_scanner->next(handle, 0, eof));
+    }
     return (RCOK);
 }
 
@@ -83,6 +105,7 @@ w_rc_t simple_table_iter_t::close_scan()
 
 pin_i* simple_table_iter_t::cursor() 
 {
+    if (_pzone) return (_pzone->cursor());
     pin_i *rval;
     bool eof;
     _scanner->cursor(rval, eof);
@@ -0,0 +1,364 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   shore_metrics.cpp
+ *
+ *  @brief:  Implementation of the metrics sampler
+ */
+
+#include "sm/shore/shore_metrics.h"
+#include "sm/shore/shore_client.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+
+ENTER_NAMESPACE(shore);
+
+
+// the difference of two readings of a counter that may have been reset
+template <typename T>
+static inline double _delta(const T cur, const T last)
+{
+    return ((cur >= last) ? (double)(cur - last) : (double)cur);
+}
+
+// the user+system usecs the process has used on all its cpus so far
+static uint64_t _cpu_usecs()
+{
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru)) return (0);
+    return ((uint64_t)(ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000000 
+            + ru.ru_utime.tv_usec + ru.ru_stime.tv_usec);
+}
+
+static const char* _state_str(const MeasurementState ms)
+{
+    switch (ms) {
+    case (MST_WARMUP):  return ("warmup");
+    case (MST_MEASURE): return ("measure");
+    case (MST_PAUSE):   return ("pause");
+    case (MST_DONE):    return ("done");
+    default:            return ("undef");
+    }
+}
+
+
+/******************************************************************** 
+ *
+ *  @class: metrics_sampler_t
+ *
+ ********************************************************************/
+
+metrics_sampler_t::metrics_sampler_t(c_str tname, ShoreEnv* env, 
+                                     const string& fname,
+                                     const bool json, const int interval_ms, 
+                                     const bool with_sm, const int run)
+    : thread_t(tname), _env(env), _fname(fname), _json(json),
+      _interval_ms(interval_ms), _with_sm(with_sm), _run(run),
+      _stop(false), _fout(NULL), _header(false), _columns(0),
+      _last_att(0), _last_com(0), _last_lsum(0), _last_lcnt(0),
+      _last_cpu_us(0)
+{
+    assert (_env);
+    if (_interval_ms < 1) _interval_ms = DF_METRICS_INTERVAL;
+}
+
+metrics_sampler_t::~metrics_sampler_t()
+{
+    if (_fout) fclose(_fout);
+}
+
+
+/******************************************************************** 
+ *
+ *  @fn:    start
+ *
+ *  @brief: Forks a sampler for a measurement, if there is a metrics 
+ *          file configured. Every start is a new run in the file.
+ *
+ ********************************************************************/
+
+metrics_sampler_t* metrics_sampler_t::start(ShoreEnv* env)
+{
+    static int run = 0;
+
+    envVar* ev = envVar::instance();
+    string fname = ev->getVar("metrics-file","none");
+    if (fname.empty() || (fname == "none")) return (NULL);
+
+    bool json = (ev->getVar("metrics-format","csv") == "json");
+    int interval = ev->getVarInt("metrics-interval",DF_METRICS_INTERVAL);
+    bool with_sm = ev->getVarInt("metrics-sm",0);
+
+    metrics_sampler_t* psampler = 
+        new metrics_sampler_t(c_str("metrics"), env, fname, 
+                              json, interval, with_sm, ++run);
+    assert (psampler);
+    psampler->fork();
+    return (psampler);
+}
+
+void metrics_sampler_t::finish(metrics_sampler_t* psampler)
+{
+    if (!psampler) return;
+    psampler->stop();
+    psampler->join();
+    delete (psampler);
+}
+
+
+/******************************************************************** 
+ *
+ *  @fn:    _sample
+ *
+ *  @brief: Reads all the stats and appends their differences from 
+ *          the previous reading to the sample
+ *
+ ********************************************************************/
+
+void metrics_sampler_t::_sample(sample_t& asample, const double secs)
+{
+    env_stats_t* pstats = _env->get_env_stats();
+    uint_t att = _env->get_trx_att();
+    uint_t com = _env->get_trx_com();
+    uint64_t lsum = pstats->lat_sum();
+    uint64_t lcnt = pstats->lat_cnt();
+
+    double dcom = _delta(com,_last_com);
+    double dlcnt = _delta(lcnt,_last_lcnt);
+    // The cpus busy over this interval, from our own previous reading.
+    // The monitor's average is since its last reset and reading it 
+    // would race with the monitor thread updating it.
+    uint64_t cpu_us = _cpu_usecs();
+    double cpu = (secs > 0 ? _delta(cpu_us,_last_cpu_us)/(secs*1e6) : 0);
+
+    asample.push_back(metric_t("dt", secs));
+    asample.push_back(metric_t("att", _delta(att,_last_att)));
+    asample.push_back(metric_t("com", dcom));
+    asample.push_back(metric_t("tps", (secs > 0 ? dcom/secs : 0)));
+    asample.push_back(metric_t("lat_avg_us", 
+                               (dlcnt > 0 ? _delta(lsum,_last_lsum)/dlcnt : 0)));
+    asample.push_back(metric_t("cpu", cpu));
+
+    _last_att = att;
+    _last_com = com;
+    _last_lsum = lsum;
+    _last_lcnt = lcnt;
+    _last_cpu_us = cpu_us;
+
+    // the workers (or the partition workers, in DORA)
+    worker_stats_t ws;
+    _env->gather_worker_stats(ws);
+    asample.push_back(metric_t("w_processed", 
+                               _delta(ws._processed,_last_ws._processed)));
+    asample.push_back(metric_t("w_problems", 
+                               _delta(ws._problems,_last_ws._problems)));
+    asample.push_back(metric_t("w_served_input", 
+                               _delta(ws._served_input,_last_ws._served_input)));
+    asample.push_back(metric_t("w_served_waiting", 
+                               _delta(ws._served_waiting,_last_ws._served_waiting)));
+    asample.push_back(metric_t("w_condex_sleep", 
+                               _delta(ws._condex_sleep,_last_ws._condex_sleep)));
+    asample.push_back(metric_t("w_failed_sleep", 
+                               _delta(ws._failed_sleep,_last_ws._failed_sleep)));
+    asample.push_back(metric_t("w_early_aborts", 
+                               _delta(ws._early_aborts,_last_ws._early_aborts)));
+    asample.push_back(metric_t("w_mid_aborts", 
+                               _delta(ws._mid_aborts,_last_ws._mid_aborts)));
+    _last_ws = ws;
+
+    // the flushers, zeros if there are none
+    flusher_stats_t fs;
+    _env->gather_flusher_stats(fs);
+    asample.push_back(metric_t("f_served", 
+                               _delta(fs.served,_last_fs.served)));
+    asample.push_back(metric_t("f_flushes", 
+                               _delta(fs.flushes,_last_fs.flushes)));
+    asample.push_back(metric_t("f_log_bytes", 
+                               _delta(fs.logsize,_last_fs.logsize)));
+    asample.push_back(metric_t("f_already", 
+                               _delta(fs.alreadyFlushed,_last_fs.alreadyFlushed)));
+    asample.push_back(metric_t("f_waiting", 
+                               _delta(fs.waiting,_last_fs.waiting)));
+    asample.push_back(metric_t("f_by_xcts", 
+                               _delta(fs.trigByXcts,_last_fs.trigByXcts)));
+    asample.push_back(metric_t("f_by_size", 
+                               _delta(fs.trigBySize,_last_fs.trigBySize)));
+    asample.push_back(metric_t("f_by_timeout", 
+                               _delta(fs.trigByTimeout,_last_fs.trigByTimeout)));
+    _last_fs = fs;
+
+    if (_with_sm) _sample_sm(asample);
+}
+
+
+/******************************************************************** 
+ *
+ *  @fn:    _sample_sm
+ *
+ *  @brief: Appends the differences of the sm stats. They are taken
+ *          from their printout ("name value" lines), in order not to 
+ *          depend on the counters of a specific sm version.
+ *
+ ********************************************************************/
+
+void metrics_sampler_t::_sample_sm(sample_t& asample)
+{
+    sm_stats_info_t stats;
+    ss_m::gather_stats(stats);
+
+    sm_stats_info_t diff = stats;
+    diff -= _last_sm;
+    _last_sm = stats;
+
+    std::ostringstream os;
+    os << diff;
+    std::istringstream is(os.str());
+    string line;
+    while (std::getline(is, line)) {
+        std::istringstream ls(line);
+        string name, value, rest;
+        if (!(ls >> name >> value) || (ls >> rest)) continue;
+        char* end = NULL;
+        double v = strtod(value.c_str(), &end);
+        if ((end == value.c_str()) || (*end != '\0')) continue;
+        asample.push_back(metric_t("sm_" + name, v));
+    }
+}
+
+
+/******************************************************************** 
+ *
+ *  @fn:    _write
+ *
+ *  @brief: One line per sample, a JSON object or a CSV row. The CSV 
+ *          header is written once per file, by the first sample.
+ *
+ ********************************************************************/
+
+void metrics_sampler_t::_write(const double t, const sample_t& asample)
+{
+    const char* state = _state_str(_env->get_measure());
+
+    if (_json) {
+        fprintf(_fout, "{\"t\":%.3f,\"run\":%d,\"state\":\"%s\"", 
+                t, _run, state);
+        for (uint i=0; i<asample.size(); i++) {
+            fprintf(_fout, ",\"%s\":%.15g", 
+                    asample[i].first.c_str(), asample[i].second);
+        }
+        fprintf(_fout, "}\n");
+    }
+    else {
+        if (!_header) {
+            fprintf(_fout, "t,run,state");
+            for (uint i=0; i<asample.size(); i++) {
+                fprintf(_fout, ",%s", asample[i].first.c_str());
+            }
+            fprintf(_fout, "\n");
+            _header = true;
+        }
+        if (!_columns) _columns = asample.size();
+        fprintf(_fout, "%.3f,%d,%s", t, _run, state);
+        for (uint i=0; i<_columns; i++) {
+            if (i < asample.size()) {
+                fprintf(_fout, ",%.15g", asample[i].second);
+            }
+            else {
+                fprintf(_fout, ",");
+            }
+        }
+        fprintf(_fout, "\n");
+    }
+    fflush(_fout);
+}
+
+
+/******************************************************************** 
+ *
+ *  @fn:    work
+ *
+ *  @brief: Samples every interval until it is stopped, and once more
+ *          at the end for the last (partial) interval. The times are 
+ *          from the fork, so they cover the warmup and the pauses
+ *          between iterations, marked by the state column.
+ *
+ ********************************************************************/
+
+void metrics_sampler_t::work()
+{
+    _fout = fopen(_fname.c_str(), "a");
+    if (!_fout) {
+        TRACE( TRACE_ALWAYS, "Could not open (%s), no metrics\n",
+               _fname.c_str());
+        return;
+    }
+
+    // appending to a CSV with a header already
+    fseek(_fout, 0, SEEK_END);
+    _header = (ftell(_fout) > 0);
+    if (_header && !_json) {
+        TRACE( TRACE_ALWAYS, 
+               "Appending to (%s), its columns are kept as they are\n",
+               _fname.c_str());
+    }
+
+    env_stats_t* pstats = _env->get_env_stats();
+    pstats->lat_attach();
+
+    // the first reading, which is not written
+    sample_t asample;
+    _sample(asample, 0);
+
+    stopwatch_t timer;
+    long long start = timer.now();
+    long long last = start;
+    long long interval = (long long)_interval_ms * 1000;
+    int samples = 0;
+
+    bool done = false;
+    while (!done) {
+        done = *&_stop;
+        long long now = timer.now();
+        if ((now - last >= interval) || (done && (now > last))) {
+            asample.clear();
+            _sample(asample, (now - last) / 1e6);
+            _write((now - start) / 1e6, asample);
+            last = now;
+            ++samples;
+        }
+        if (!done) usleep(METRICS_TICK_US);
+    }
+
+    pstats->lat_detach();
+    TRACE( TRACE_ALWAYS, "Metrics: (%d) samples of run (%d) in (%s)\n",
+           samples, _run, _fname.c_str());
+}
+
+
+EXIT_NAMESPACE(shore);
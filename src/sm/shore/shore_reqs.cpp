@@ -39,18 +39,20 @@ ENTER_NAMESPACE(shore);
  *
  * @fn:    notify_client()
  *
- * @brief: If it is time, notifies the client (signals client's cond var) 
+ * @brief: If it is time, notifies the client (pushes a completion record
+ *         to the client's ring). The aborted xcts have been marked
+ *         ROLLBACKED, everything else is reported as COMMITTED.
  *
  ******************************************************************/
 
 void base_request_t::notify_client() 
 {
-    // signal cond var
-    condex* pcondex = _result.get_notify();
-    if (pcondex) {
+    completion_queue_t* pcq = _result.get_notify();
+    if (pcq) {
         TRACE( TRACE_TRX_FLOW, "Xct (%d) notifying client (%x)\n", 
-               _tid.get_lo(), pcondex);
-	pcondex->signal();
+               _tid.get_lo(), pcq);
+        TrxState astate = _result.get_state();
+        pcq->push(_xct_id, (astate == ROLLBACKED ? ROLLBACKED : COMMITTED));
         _result.set_notify(NULL);
     }
     else {
@@ -130,7 +130,8 @@ table_row_t::table_row_t()
       _field_cnt(0), _is_setup(false), 
       _rid(rid_t::null), _pvalues(NULL), 
       _fixed_offset(0),_var_slot_offset(0),_var_offset(0),_null_count(0),
-      _rep(NULL), _rep_key(NULL)
+      _rep(NULL), _rep_key(NULL),
+      _pdirty(NULL), _dirty_cnt(0), _image_valid(false)
 { 
 }
         
@@ -166,6 +167,11 @@ int table_row_t::setup(table_desc_t* ptd)
     _field_cnt = ptd->field_count();
     assert (_field_cnt>0);
     _pvalues = new field_value_t[_field_cnt];
+    if (_pdirty) delete [] _pdirty;
+    _pdirty = new bool[_field_cnt];
+    memset(_pdirty, 0, _field_cnt*sizeof(bool));
+    _dirty_cnt = 0;
+    _image_valid = false;
 
     uint var_count  = 0;
     uint fixed_size = 0;
@@ -198,6 +204,26 @@ int table_row_t::setup(table_desc_t* ptd)
 }
 
 
+/****************************************************************** 
+ *
+ *  @fn:    reset_dirty()
+ *
+ *  @brief: Clears the dirty fields. If bImageValid the values of the
+ *          row are the ones of its record on disk.
+ *
+ ******************************************************************/
+
+void table_row_t::reset_dirty(const bool bImageValid)
+{
+    if (_dirty_cnt) {
+        memset(_pdirty, 0, _field_cnt*sizeof(bool));
+        _dirty_cnt = 0;
+    }
+    _image_valid = bImageValid;
+}
+
+
+
 /****************************************************************** 
  *
  *  @fn:    size()
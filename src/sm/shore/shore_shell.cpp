@@ -172,12 +172,38 @@ processorid_t shore_shell_t::next_cpu(const eBindingType abt,
         static const uint NIAGARA_II_STEP = 8;
         nextprs = ((aprd+NIAGARA_II_STEP) % _env->get_active_cpu_count());
         return (nextprs);
+    case (BT_TOPOLOGY):
+        // The cpu is decided per client by ShoreEnv::client_cpu()
+        return (aprd);
     }
     assert (0); // Should not reach this point
     return (nextprs);
 }
 
 
+/****************************************************************** 
+ *
+ * @fn:    topology_cpu()
+ *
+ * @brief: The cpu of a client under BT_TOPOLOGY binding
+ *
+ * @note:  If the client is bound to a specific warehouse (spread) it
+ *         goes to the node that owns this warehouse. Otherwise the 
+ *         clients are spread evenly over the nodes.
+ *
+ ******************************************************************/
+
+processorid_t shore_shell_t::topology_cpu(const int aclient, const int awh,
+                                          const double aqf, const int aclients)
+{
+    assert (_env);
+    if ((awh > 0) && (aqf >= 1)) {
+        return (_env->client_cpu(awh-1, (uint)aqf, c_str("CL-%d",aclient).data()));
+    }
+    return (_env->client_cpu(aclient, aclients, c_str("CL-%d",aclient).data()));
+}
+
+
 /******************************************************************** 
  *
  *  @fn:    print_CMD_info
@@ -751,6 +777,71 @@ int shore_shell_t::_cmd_LOAD_impl()
 
 
 
+/******************************************************************** 
+ *
+ *  @fn:    process_cmd_SERVE
+ *
+ *  @brief: Parses the SERVE cmd and calls the virtual impl function
+ *
+ ********************************************************************/
+
+int shore_shell_t::process_cmd_SERVE(const char* command)
+{
+    assert (_env);
+    assert (_env->is_initialized());
+
+    w_rc_t rcl = _env->loaddata();
+    if (rcl.is_error()) {
+        return (SHELL_NEXT_QUIT);
+    }
+
+    // 0. Parse Parameters
+    envVar* ev = envVar::instance();
+    double numOfQueriedSF = ev->getVarDouble("measure-num-queried",DF_NUM_OF_QUERIED_SF);
+    int duration          = ev->getVarInt("measure-duration",DF_DURATION);
+    int port              = ev->getVarInt("srv-port",DF_SRV_PORT);
+
+    char command_tag[SERVER_COMMAND_BUFFER_SIZE];
+    if ( sscanf(command, "%s %lf %d %d", command_tag,
+                &numOfQueriedSF, &duration, &port) < 2 ) 
+    {
+        TRACE( TRACE_ALWAYS, "Wrong input. Type (help serve)\n"); 
+        return (SHELL_NEXT_CONTINUE);
+    }
+
+    double tmp_sf = ev->getSysVarDouble("sf");
+    if (tmp_sf>0) {
+        _theSF = tmp_sf;
+    }
+    if ((numOfQueriedSF<=0) || (numOfQueriedSF>_theSF)) {
+        numOfQueriedSF = _theSF;
+    }
+    if (duration<=0) {
+        duration = DF_DURATION;
+    }
+
+    return (_cmd_SERVE_impl(numOfQueriedSF, duration, port));
+}
+
+
+/******************************************************************** 
+ *
+ *  @fn:    _cmd_SERVE_impl
+ *
+ *  @brief: The kits that can build client stubs override it
+ *
+ ********************************************************************/
+
+int shore_shell_t::_cmd_SERVE_impl(const double /* iQueriedSF */, 
+                                   const int /* iDuration */,
+                                   const int /* iPort */)
+{
+    TRACE( TRACE_ALWAYS, "Serving is not supported by this kit\n");
+    return (SHELL_NEXT_CONTINUE);
+}
+
+
+
 //// EOF: shore_shell_t commands ////
 
 
@@ -764,12 +855,17 @@ int shore_shell_t::register_commands()
     REGISTER_CMD_PARAM(fake_iodelay_cmd_t,_fakeioer,_env);
     REGISTER_CMD_PARAM(freq_cmd_t,_freqer,_env);
     REGISTER_CMD_PARAM(skew_cmd_t,_skewer,_env);
+    REGISTER_CMD_PARAM(skewplan_cmd_t,_skewplanner,_env);
     REGISTER_CMD_PARAM(stats_verbose_cmd_t,_stats_verboser,_env);
     REGISTER_CMD_PARAM(db_print_cmd_t,_db_printer,_env);
     REGISTER_CMD_PARAM(db_fetch_cmd_t,_db_fetch,_env);
+    REGISTER_CMD_PARAM(db_columns_cmd_t,_db_columns,_env);
+    REGISTER_CMD_PARAM(mem_grants_cmd_t,_mem_granter,_env);
 
     REGISTER_CMD_PARAM(log_cmd_t,_logger,_env);
     REGISTER_CMD_PARAM(asynch_cmd_t,_asyncher,_env);
+    REGISTER_CMD_PARAM(snapshot_cmd_t,_snapshoter,_env);
+    REGISTER_CMD_PARAM(restore_cmd_t,_restorer,_env);
 
     REGISTER_CMD_PARAM(sli_cmd_t,_slier,_env);
     REGISTER_CMD_PARAM(elr_cmd_t,_elrer,_env);
@@ -783,6 +879,7 @@ int shore_shell_t::register_commands()
     REGISTER_CMD_PARAM(warmup_cmd_t,_warmuper,this);
     REGISTER_CMD_PARAM(load_cmd_t,_loader,this);
     REGISTER_CMD_PARAM(trxs_cmd_t,_trxser,this);
+    REGISTER_CMD_PARAM(serve_cmd_t,_server,this);
 
     return (0);
 }
@@ -842,6 +939,7 @@ int info_cmd_t::handle(const char* /* cmd */)
 { 
     assert (_env); 
     _env->info(); 
+    _env->print_client_placement();
     return (SHELL_NEXT_CONTINUE); 
 }
 
@@ -1132,6 +1230,119 @@ string skew_cmd_t::desc() const
 }
 
 
+/*********************************************************************
+ *
+ *  "skewplan" command
+ *
+ *  Scripted skew scenarios, applied during the next measurements
+ *
+ *********************************************************************/
+
+void skewplan_cmd_t::setaliases() 
+{ 
+    _name = string("skewplan"); 
+    _aliases.push_back("skewplan"); 
+}
+
+int skewplan_cmd_t::handle(const char* cmd)
+{
+    assert (_env);
+    skew_plan_t* pplan = _env->get_skew_plan();
+
+    char cmd_tag[SERVER_COMMAND_BUFFER_SIZE];
+    char sAction[SERVER_COMMAND_BUFFER_SIZE];
+    if ( sscanf(cmd, "%s %s", cmd_tag, sAction) < 2) {
+        usage();
+        pplan->print();
+        return (SHELL_NEXT_CONTINUE);
+    }
+
+    string action(sAction);
+    double a1, a2, a3, a4;
+    int n;
+    bool bOK = true;
+
+    if (action.compare("clear") == 0) {
+        pplan->clear();
+    }
+    else if (action.compare("file") == 0) {
+        char sFile[SERVER_COMMAND_BUFFER_SIZE];
+        bOK = ((sscanf(cmd, "%*s %*s %s", sFile) == 1) &&
+               (pplan->load(sFile) == 0));
+    }
+    else if (action.compare("out") == 0) {
+        char sFile[SERVER_COMMAND_BUFFER_SIZE];
+        if (sscanf(cmd, "%*s %*s %s", sFile) == 1) pplan->set_outfile(sFile);
+        else pplan->set_outfile("");
+    }
+    else if (action.compare("move") == 0) {
+        bOK = ((sscanf(cmd, "%*s %*s %lf %lf %lf %lf", &a1, &a2, &a3, &a4) == 4) &&
+               (a1 > 0) && (a3 > 0));
+        if (bOK) pplan->add_moving(a1, (int)a2, a3, a4);
+    }
+    else if (action.compare("zipf") == 0) {
+        // zipf <PERIOD> <DURATION> <S1> [<S2> ...]
+        std::vector<double> svals;
+        bOK = ((sscanf(cmd, "%*s %*s %lf %lf%n", &a1, &a2, &n) == 2) && (a1 > 0));
+        if (bOK) {
+            const char* p = cmd + n;
+            char* pend;
+            for (double sv = strtod(p, &pend); pend != p; sv = strtod(p, &pend)) {
+                svals.push_back(sv);
+                p = pend;
+            }
+            bOK = !svals.empty();
+        }
+        if (bOK) pplan->add_zipf(svals, a1, a2);
+    }
+    else if (action.compare("flash") == 0) {
+        bOK = (sscanf(cmd, "%*s %*s %lf %lf %lf %lf", &a1, &a2, &a3, &a4) == 4);
+        if (bOK) pplan->add_flash(a1, (int)a2, a3, a4);
+    }
+    else {
+        bOK = false;
+    }
+
+    if (!bOK) {
+        usage();
+        return (SHELL_NEXT_CONTINUE);
+    }
+    pplan->print();
+    return (SHELL_NEXT_CONTINUE);
+}
+
+
+void skewplan_cmd_t::usage(void)
+{
+    TRACE( TRACE_ALWAYS, "SKEWPLAN Usage:\n\n"                          \
+           "*** skewplan clear\n"                                        \
+           "*** skewplan file <FILE>\n"                                  \
+           "*** skewplan move <AREA> <LOAD> <PERIOD> <DURATION>\n"       \
+           "*** skewplan zipf <PERIOD> <DURATION> <S1> [<S2> ...]\n"     \
+           "*** skewplan flash <POS> <LOAD> <AT> <LENGTH>\n"             \
+           "*** skewplan out [<FILE>]\n"                                 \
+           "\nParameters:\n"                                            \
+           "<FILE>     - Steps, one per line: <AT> hot <POS> <AREA> <LOAD>,\n" \
+           "             <AT> cool, or <AT> zipf <S>\n"                 \
+           "<AREA>     - Percentage of the keys in the hot area\n"     \
+           "<LOAD>     - Percentage of the requests to the hot area\n" \
+           "<PERIOD>   - The hot area moves by its size (or the zipf s\n" \
+           "             changes) every that many seconds\n"           \
+           "<DURATION> - Seconds until the scenario ends\n"            \
+           "<POS>      - Position of the key, in % of the keys\n"      \
+           "<AT>       - Seconds from the beginning of the measurement\n" \
+           "out        - Per-second throughput and latency go to the CSV\n" \
+           "             <FILE>, or to the trace without a file\n\n"   \
+           "The steps are applied by the next measurements, in TM1,\n"  \
+           "TPC-B and TPC-C, and override the \"skew\" command.\n\n");
+}
+
+string skewplan_cmd_t::desc() const 
+{ 
+    return (string("Scripts time-varying skew scenarios for the measurements")); 
+}
+
+
 /*********************************************************************
  *
  *  "stats_verbose" command
@@ -1271,6 +1482,74 @@ string db_fetch_cmd_t::desc() const
 }
 
 
+/*********************************************************************
+ *
+ *  "db_columns" command
+ *
+ *  (Re)builds the compressed columnar replicas of the DSS fact tables
+ *
+ *********************************************************************/
+
+void db_columns_cmd_t::setaliases() 
+{ 
+    _name = string("db_columns"); 
+    _aliases.push_back("db_columns"); 
+    _aliases.push_back("columnar"); 
+}
+
+int db_columns_cmd_t::handle(const char* cmd)
+{
+    assert (_env);
+    _env->db_columns_init();
+    return (SHELL_NEXT_CONTINUE);
+}
+
+
+void db_columns_cmd_t::usage(void)
+{
+    TRACE( TRACE_ALWAYS, "DB_COLUMNS Usage:\n\n*** db_columns\n\n");
+}
+
+string db_columns_cmd_t::desc() const 
+{ 
+    return (string("To (re)build the columnar replicas of the fact tables of the current db.")); 
+}
+
+
+/*********************************************************************
+ *
+ *  "mem_grants" command
+ *
+ *  Prints the memory the QPipe packets currently hold
+ *
+ *********************************************************************/
+
+void mem_grants_cmd_t::setaliases() 
+{ 
+    _name = string("mem_grants"); 
+    _aliases.push_back("mem_grants"); 
+    _aliases.push_back("mem"); 
+}
+
+int mem_grants_cmd_t::handle(const char* cmd)
+{
+    assert (_env);
+    _env->mem_grants();
+    return (SHELL_NEXT_CONTINUE);
+}
+
+
+void mem_grants_cmd_t::usage(void)
+{
+    TRACE( TRACE_ALWAYS, "MEM_GRANTS Usage:\n\n*** mem_grants\n\n");
+}
+
+string mem_grants_cmd_t::desc() const 
+{ 
+    return (string("Prints the memory grants of the running QPipe packets.")); 
+}
+
+
 /*********************************************************************
  *
  *  "log" command
@@ -1331,6 +1610,101 @@ string log_cmd_t::desc() const
 }
 
 
+
+/*********************************************************************
+ *
+ *  "snapshot" and "restore" commands
+ *
+ *  @note: They run in a new smthread, since the sm is shut down and
+ *         started again
+ *
+ *********************************************************************/
+
+static int _run_snapshot(ShoreEnv* env, const string& dir, const bool bRestore)
+{
+    db_snapshot_smt_t* snapper = new db_snapshot_smt_t(c_str("snapshot"), env,
+                                                       dir, bRestore);
+    assert (snapper);
+    snapper->fork();
+    snapper->join(); 
+    int rv = snapper->rv();
+    delete (snapper);
+    return (rv);
+}
+
+
+void snapshot_cmd_t::setaliases() 
+{ 
+    _name = string("snapshot"); 
+    _aliases.push_back("snapshot");
+    _aliases.push_back("snap");
+}
+
+int snapshot_cmd_t::handle(const char* cmd)
+{
+    assert (_env);
+    char cmd_tag[SERVER_COMMAND_BUFFER_SIZE];
+    char dir_tag[SERVER_COMMAND_BUFFER_SIZE];
+
+    if ( sscanf(cmd, "%s %s", cmd_tag, dir_tag) < 2) {
+        usage();
+        return (SHELL_NEXT_CONTINUE);
+    }
+
+    if (_run_snapshot(_env, dir_tag, false)) {
+        TRACE( TRACE_ALWAYS, "Could not take the snapshot\n");
+    }
+    return (SHELL_NEXT_CONTINUE);
+}
+
+void snapshot_cmd_t::usage(void)
+{
+    TRACE( TRACE_ALWAYS, "usage: snapshot <dir>\n"
+           "Checkpoints, and copies the device and the log to <dir>\n");
+}
+
+string snapshot_cmd_t::desc() const
+{ 
+    return (string("Takes a snapshot of the database")); 
+}
+
+
+
+void restore_cmd_t::setaliases() 
+{ 
+    _name = string("restore"); 
+    _aliases.push_back("restore");
+}
+
+int restore_cmd_t::handle(const char* cmd)
+{
+    assert (_env);
+    char cmd_tag[SERVER_COMMAND_BUFFER_SIZE];
+    char dir_tag[SERVER_COMMAND_BUFFER_SIZE];
+
+    if ( sscanf(cmd, "%s %s", cmd_tag, dir_tag) < 2) {
+        usage();
+        return (SHELL_NEXT_CONTINUE);
+    }
+
+    if (_run_snapshot(_env, dir_tag, true)) {
+        TRACE( TRACE_ALWAYS, "Could not restore the snapshot\n");
+    }
+    return (SHELL_NEXT_CONTINUE);
+}
+
+void restore_cmd_t::usage(void)
+{
+    TRACE( TRACE_ALWAYS, "usage: restore <dir>\n"
+           "Replaces the device and the log with the snapshot in <dir>\n");
+}
+
+string restore_cmd_t::desc() const
+{ 
+    return (string("Restores a snapshot of the database")); 
+}
+
+
 /*********************************************************************
  *
  *  "asynch" command
@@ -1680,5 +2054,42 @@ string trxs_cmd_t::desc() const
 
 
 
+
+/*********************************************************************
+ *
+ *  "serve" command
+ *
+ *********************************************************************/
+
+void serve_cmd_t::setaliases()
+{
+    _name = string("serve"); 
+    _aliases.push_back("serve");
+}
+
+int serve_cmd_t::handle(const char* cmd) 
+{ 
+    _kit->pre_process_cmd();
+    return (_kit->process_cmd_SERVE(cmd));
+}
+
+void serve_cmd_t::usage() 
+{ 
+    TRACE( TRACE_ALWAYS, "SERVE Usage:\n\n"                             \
+           "*** serve <NUM_QUERIED> [<DURATION> <PORT>]\n"              \
+           "\nParameters:\n"                                            \
+           "<NUM_QUERIED> : The SF queried (queried factor)\n"          \
+           "<DURATION>    : Duration of the run in secs (Default=20) (optional)\n" \
+           "<PORT>        : Port to listen at (Default=srv-port) (optional)\n\n" \
+           "Drive it with trx_load_driver.\n\n");
+}
+
+string serve_cmd_t::desc() const 
+{
+    return string("Duration-based measurement, with the xcts submitted over the network");
+}
+
+
+
 EXIT_NAMESPACE(shore);
 
@@ -0,0 +1,348 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   shore_skew_plan.cpp
+ *
+ *  @brief:  Implementation of the scripted skew scenarios
+ */
+
+#include "sm/shore/shore_skew_plan.h"
+#include "sm/shore/shore_env.h"
+#include "sm/shore/shore_client.h"
+
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <unistd.h>
+
+
+ENTER_NAMESPACE(shore);
+
+
+/******************************************************************** 
+ *
+ *  @fn:    skew_step_t::str
+ *
+ *  @brief: One-line description (no commas, it goes to the CSV)
+ *
+ ********************************************************************/
+
+string skew_step_t::str() const
+{
+    char buf[128];
+    switch (_type) {
+    case (SKS_HOT):
+        snprintf(buf, sizeof(buf), "hot pos=%.1f%% area=%.1f%% load=%d%%",
+                 _pos, _area, _load);
+        break;
+    case (SKS_COOL):
+        snprintf(buf, sizeof(buf), "cool");
+        break;
+    case (SKS_ZIPF):
+        if (_s < 0) snprintf(buf, sizeof(buf), "zipf default");
+        else snprintf(buf, sizeof(buf), "zipf s=%.2f", _s);
+        break;
+    default:
+        snprintf(buf, sizeof(buf), "unknown");
+    }
+    return (string(buf));
+}
+
+
+
+/******************************************************************** 
+ *
+ *  @fn:    add
+ *
+ ********************************************************************/
+
+void skew_plan_t::add(const skew_step_t& astep)
+{
+    std::vector<skew_step_t>::iterator it = _steps.end();
+    while ((it != _steps.begin()) && ((it-1)->_at > astep._at)) --it;
+    _steps.insert(it, astep);
+}
+
+
+/******************************************************************** 
+ *
+ *  @fn:    load
+ *
+ *  @brief: Reads the steps of a plan file. Empty lines and lines that
+ *          start with '#' are skipped.
+ *
+ *  @return: 0 on success
+ *
+ ********************************************************************/
+
+int skew_plan_t::load(const char* fname)
+{
+    assert (fname);
+    FILE* fin = fopen(fname, "r");
+    if (!fin) {
+        TRACE( TRACE_ALWAYS, "Could not open (%s)\n", fname);
+        return (1);
+    }
+
+    char line[256];
+    char action[32];
+    int lineno = 0;
+    int rv = 0;
+    while (fgets(line, sizeof(line), fin)) {
+        ++lineno;
+        char* p = line;
+        while ((*p == ' ') || (*p == '\t')) ++p;
+        if ((*p == '\0') || (*p == '\n') || (*p == '#')) continue;
+
+        double at = 0;
+        if ((sscanf(p, "%lf %31s", &at, action) < 2) || (at < 0)) {
+            rv = 1;
+        }
+        else if (strcmp(action, "hot") == 0) {
+            skew_step_t astep(at, SKS_HOT);
+            if (sscanf(p, "%*f %*s %lf %lf %d", 
+                       &astep._pos, &astep._area, &astep._load) < 3) rv = 1;
+            else add(astep);
+        }
+        else if (strcmp(action, "cool") == 0) {
+            add(skew_step_t(at, SKS_COOL));
+        }
+        else if (strcmp(action, "zipf") == 0) {
+            skew_step_t astep(at, SKS_ZIPF);
+            if (sscanf(p, "%*f %*s %lf", &astep._s) < 1) rv = 1;
+            else add(astep);
+        }
+        else {
+            rv = 1;
+        }
+
+        if (rv) {
+            TRACE( TRACE_ALWAYS, "Bad step at (%s:%d)\n", fname, lineno);
+            break;
+        }
+    }
+    fclose(fin);
+    return (rv);
+}
+
+
+/******************************************************************** 
+ *
+ *  @fn:    add_{moving,zipf,flash}
+ *
+ *  @brief: Generators of the common scenarios
+ *
+ ********************************************************************/
+
+void skew_plan_t::add_moving(const double area, const int load, 
+                             const double period, const double duration)
+{
+    assert (period > 0);
+    int k = 0;
+    for (double t = 0; t < duration; t += period, ++k) {
+        skew_step_t astep(t, SKS_HOT);
+        astep._pos = fmod(k*area, 100.0);
+        astep._area = area;
+        astep._load = load;
+        add(astep);
+    }
+    add(skew_step_t(duration, SKS_COOL));
+}
+
+void skew_plan_t::add_zipf(const std::vector<double>& svals, 
+                           const double period, const double duration)
+{
+    assert (period > 0);
+    assert (!svals.empty());
+    int k = 0;
+    for (double t = 0; t < duration; t += period, ++k) {
+        skew_step_t astep(t, SKS_ZIPF);
+        astep._s = svals[k % svals.size()];
+        add(astep);
+    }
+    skew_step_t alast(duration, SKS_ZIPF);
+    alast._s = -1;
+    add(alast);
+}
+
+void skew_plan_t::add_flash(const double pos, const int load,
+                            const double at, const double length)
+{
+    skew_step_t astep(at, SKS_HOT);
+    astep._pos = pos;
+    astep._area = 0;
+    astep._load = load;
+    add(astep);
+    add(skew_step_t(at + length, SKS_COOL));
+}
+
+
+void skew_plan_t::print() const
+{
+    TRACE( TRACE_ALWAYS, "Skew plan: (%d) steps, series to (%s)\n", 
+           (int)_steps.size(), (_outfile.empty() ? "trace" : _outfile.c_str()));
+    for (uint i=0; i<_steps.size(); i++) {
+        TRACE( TRACE_ALWAYS, "%8.1f: %s\n", 
+               _steps[i]._at, _steps[i].str().c_str());
+    }
+}
+
+
+
+/******************************************************************** 
+ *
+ *  @class: skew_scheduler_t
+ *
+ ********************************************************************/
+
+skew_scheduler_t::skew_scheduler_t(c_str tname, ShoreEnv* env, 
+                                   const skew_plan_t& plan)
+    : thread_t(tname), _env(env), _plan(plan),
+      _zipf_enabled(_g_enableZipf), _zipf_s(_g_ZipfS)
+{
+    assert (_env);
+}
+
+
+void skew_scheduler_t::_apply(const skew_step_t& astep)
+{
+    switch (astep._type) {
+    case (SKS_HOT):
+        _env->set_hot_spot(astep._pos, astep._area, astep._load);
+        break;
+    case (SKS_COOL):
+        _env->clear_hot_spot();
+        break;
+    case (SKS_ZIPF):
+        if (astep._s > 0) setZipf(true, astep._s);
+        else if (astep._s == 0) setZipf(false, 0);
+        else setZipf(_zipf_enabled, _zipf_s);
+        break;
+    default:
+        assert (0);
+    }
+}
+
+
+/******************************************************************** 
+ *
+ *  @fn:    work
+ *
+ *  @brief: Waits for the measurement to begin, and then applies the
+ *          steps and samples the stats until it is done. The times 
+ *          are from the beginning of the first iteration, so the 
+ *          pauses between iterations are part of the timeline.
+ *
+ ********************************************************************/
+
+void skew_scheduler_t::work()
+{
+    while (_env->get_measure() != MST_MEASURE) {
+        if ((_env->get_measure() == MST_DONE) || 
+            base_client_t::is_test_aborted()) return;
+        usleep(SKEW_TICK_US);
+    }
+
+    FILE* fout = NULL;
+    if (!_plan.outfile().empty()) {
+        fout = fopen(_plan.outfile().c_str(), "w");
+        if (fout) {
+            fprintf(fout, "sec,tps,lat_avg_us,step\n");
+        }
+        else {
+            TRACE( TRACE_ALWAYS, "Could not open (%s), tracing instead\n",
+                   _plan.outfile().c_str());
+        }
+    }
+
+    // the plan overrides the "skew" command
+    _env->reset_skew();
+
+    env_stats_t* pstats = _env->get_env_stats();
+    pstats->lat_attach();
+    uint64_t last_lsum = pstats->lat_sum();
+    uint64_t last_lcnt = pstats->lat_cnt();
+
+    stopwatch_t timer;
+    long long start = timer.now();
+    long long last = start;
+    uint_t last_com = _env->get_trx_com();
+    uint next = 0;
+    int sec = 0;
+    string current("none");
+
+    while ((_env->get_measure() != MST_DONE) && 
+           !base_client_t::is_test_aborted()) 
+    {
+        long long now = timer.now();
+
+        // 1. Apply the steps that are due
+        double elapsed = (now - start) / 1e6;
+        while ((next < _plan.size()) && (_plan.step(next)._at <= elapsed)) {
+            _apply(_plan.step(next));
+            current = _plan.step(next).str();
+            TRACE( TRACE_ALWAYS, "Skew step at (%.1f): %s\n", 
+                   elapsed, current.c_str());
+            ++next;
+        }
+
+        // 2. Sample every second
+        if (now - last >= 1000000) {
+            double secs = (now - last) / 1e6;
+            uint_t com = _env->get_trx_com();
+            uint64_t lsum = pstats->lat_sum();
+            uint64_t lcnt = pstats->lat_cnt();
+            double tps = (com - last_com) / secs;
+            double lavg = ((lcnt != last_lcnt) ? 
+                           (double)(lsum - last_lsum)/(lcnt - last_lcnt) : 0);
+            ++sec;
+            if (fout) {
+                fprintf(fout, "%d,%.1f,%.1f,%s\n", 
+                        sec, tps, lavg, current.c_str());
+            }
+            else {
+                TRACE( TRACE_ALWAYS, 
+                       "[%4d] TPS (%.1f) Lat avg (%.1fus) (%s)\n",
+                       sec, tps, lavg, current.c_str());
+            }
+            last = now;
+            last_com = com;
+            last_lsum = lsum;
+            last_lcnt = lcnt;
+        }
+
+        usleep(SKEW_TICK_US);
+    }
+
+    // leave the inputs as they were
+    pstats->lat_detach();
+    _env->clear_hot_spot();
+    setZipf(_zipf_enabled, _zipf_s);
+
+    if (fout) fclose(fout);
+    TRACE( TRACE_ALWAYS, "Skew plan: (%d) of (%d) steps applied in (%d) secs\n",
+           next, _plan.size(), sec);
+}
+
+
+EXIT_NAMESPACE(shore);
@@ -0,0 +1,216 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   shore_snapshot.cpp
+ *
+ *  @brief:  The read epochs of the snapshot readers, and the sets that
+ *           wait for them to reclaim retired snapshots
+ *
+ */
+
+#include "sm/shore/shore_snapshot.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <algorithm>
+
+
+ENTER_NAMESPACE(shore);
+
+
+
+/* the slot of a reading thread, one per cache line */
+const uint_t SNAPSHOT_CACHELINE = 64;
+
+struct snapshot_reader_t
+{
+    volatile uint_t _epoch;   // the epoch of its read section, or 0
+    uint_t          _depth;   // nested read sections
+    volatile uint_t _owned;   // taken by a live thread
+    char            _pad[SNAPSHOT_CACHELINE - 3*sizeof(uint_t)];
+};
+
+static snapshot_reader_t  _readers[SNAPSHOT_MAX_READERS];
+static volatile uint_t    _reader_count = 0;   // the slots ever taken
+static volatile uint_t    _epoch = 1;          // 0 means no read section
+
+static __thread snapshot_reader_t* _my_reader = NULL;
+
+// the sets with retired snapshots, and the latest epoch they retired in
+static vector<snapshot_retirer_t*> _retirers;
+static pthread_mutex_t _retirer_mutex = thread_mutex_create();
+static volatile uint_t _last_retired = 0;
+
+static pthread_key_t  _release_key;
+static pthread_once_t _release_once = PTHREAD_ONCE_INIT;
+
+// gives back the slot of an exiting thread
+static void _release_reader(void* arg)
+{
+    snapshot_reader_t* preader = (snapshot_reader_t*)arg;
+    assert (!preader->_depth);
+    preader->_epoch = 0;
+    membar_exit();
+    preader->_owned = 0;
+}
+
+static void _create_release_key()
+{
+    pthread_key_create(&_release_key, _release_reader);
+}
+
+
+/*********************************************************************
+ *
+ *  @fn:    _take_reader
+ *
+ *  @brief: Takes a free slot for the calling thread. If all the slots
+ *          are taken, it waits for a thread to exit.
+ *
+ *********************************************************************/
+
+static snapshot_reader_t* _take_reader()
+{
+    pthread_once(&_release_once, _create_release_key);
+
+    bool warned = false;
+    while (1) {
+        for (uint_t i=0; i<SNAPSHOT_MAX_READERS; i++) {
+            if (_readers[i]._owned) continue;
+            if (atomic_cas_uint(&_readers[i]._owned, 0, 1) != 0) continue;
+
+            uint_t count = _reader_count;
+            while ((count < i+1) &&
+                   (atomic_cas_uint(&_reader_count, count, i+1) != count))
+                count = _reader_count;
+
+            _my_reader = &_readers[i];
+            pthread_setspecific(_release_key, _my_reader);
+            return (_my_reader);
+        }
+        if (!warned) {
+            warned = true;
+            TRACE( TRACE_ALWAYS, "More than (%d) snapshot readers, waiting\n",
+                   SNAPSHOT_MAX_READERS);
+        }
+        sched_yield();
+    }
+}
+
+
+
+/*********************************************************************
+ *
+ *  @fn:    _reclaim_all
+ *
+ *  @brief: Reclaims the retired snapshots of all the sets, and forgets
+ *          the sets that have none left. Called with _retirer_mutex.
+ *
+ *********************************************************************/
+
+static void _reclaim_all()
+{
+    uint_t last = 0;
+    uint_t i = 0;
+    while (i < _retirers.size()) {
+        uint_t set_last = _retirers[i]->reclaim();
+        if (!set_last) {
+            _retirers[i] = _retirers.back();
+            _retirers.pop_back();
+            continue;
+        }
+        if (set_last > last) last = set_last;
+        i++;
+    }
+    _last_retired = last;
+}
+
+
+
+void snapshot_epoch_t::enter()
+{
+    snapshot_reader_t* preader = (_my_reader ? _my_reader : _take_reader());
+    if (preader->_depth++ == 0) {
+        preader->_epoch = _epoch;
+        membar_enter(); // the slot is seen before the snapshot is read
+    }
+}
+
+void snapshot_epoch_t::leave()
+{
+    snapshot_reader_t* preader = _my_reader;
+    assert (preader && preader->_depth);
+    if (--preader->_depth) return;
+
+    uint_t epoch = preader->_epoch;
+    membar_exit();  // the snapshot is read before the slot is cleared
+    preader->_epoch = 0;
+
+    // retired() either sees the slot cleared or we see its epoch
+    membar_enter();
+    if (epoch <= _last_retired) {
+        critical_section_t cs(_retirer_mutex);
+        _reclaim_all();
+    }
+}
+
+uint_t snapshot_epoch_t::advance()
+{
+    membar_producer(); // the new snapshot is seen before the new epoch
+    uint_t epoch = atomic_inc_uint_nv(&_epoch) - 1;
+    membar_enter();    // and both before the slots are read
+    return (epoch);
+}
+
+uint_t snapshot_epoch_t::oldest()
+{
+    uint_t oldest = _epoch;
+    uint_t count = _reader_count;
+    for (uint_t i=0; i<count; i++) {
+        uint_t epoch = _readers[i]._epoch;
+        if (epoch && (epoch < oldest)) oldest = epoch;
+    }
+    return (oldest);
+}
+
+void snapshot_epoch_t::retired(snapshot_retirer_t* pset, const uint_t epoch)
+{
+    critical_section_t cs(_retirer_mutex);
+    if (std::find(_retirers.begin(), _retirers.end(), pset) == _retirers.end())
+        _retirers.push_back(pset);
+    if (epoch > _last_retired) _last_retired = epoch;
+
+    membar_enter(); // before the slots are read, see leave()
+    _reclaim_all();
+}
+
+void snapshot_epoch_t::forget(snapshot_retirer_t* pset)
+{
+    critical_section_t cs(_retirer_mutex);
+    vector<snapshot_retirer_t*>::iterator it;
+    it = std::find(_retirers.begin(), _retirers.end(), pset);
+    if (it != _retirers.end()) _retirers.erase(it);
+}
+
+
+EXIT_NAMESPACE(shore);
@@ -31,6 +31,8 @@
 
 #include "sm/shore/shore_table.h"
 
+#include <algorithm>
+
 using namespace shore;
 
 
@@ -60,7 +62,7 @@ using namespace shore;
 table_desc_t::table_desc_t(const char* name, int fieldcnt, uint4_t pd)
     : file_desc_t(name, fieldcnt, pd), _db(NULL),
       _indexes(NULL), _primary_idx(NULL),
-      _maxsize(0),
+      _maxsize(0), _version(0), _versioned(false),
       _sMinKey(NULL),_sMinKeyLen(0),
       _sMaxKey(NULL),_sMaxKeyLen(0)
 {
@@ -136,6 +138,21 @@ w_rc_t table_desc_t::create_physical_table(ss_m* db)
 			    vec_t(name(), strlen(name())),
 			    vec_t(&file, sizeof(file_info_t))));
     
+    // The other sub-files of a partitioned heap
+    for (int i=1; i<heap_parts(); i++) {
+        assert (!(index && (index->get_pd() & (PD_MRBT_PART | PD_MRBT_LEAF))));
+        W_DO(db->create_file(vid(), heap_fid(i), smlevel_3::t_regular));
+        file.set_fid(heap_fid(i));
+        char tmp[100];
+        sprintf(tmp, "%s_h%d", name(), i);
+        W_DO(ss_m::create_assoc(root_iid(),
+                                vec_t(tmp, strlen(tmp)),
+                                vec_t(&file, sizeof(file_info_t))));
+    }
+    if (is_heap_partitioned()) {
+        TRACE( TRACE_STATISTICS, "%s heap in (%d) parts\n", name(), heap_parts());
+    }
+
 
     // Create all the indexes of the table    
     while (index) {
@@ -556,6 +573,13 @@ void table_desc_t::print_desc(ostream& os)
 int table_man_t::format(table_tuple* ptuple,
                         rep_row_t &arep)
 {
+    // Tables with a layout have generated, straight-line code
+    row_codec_t* pcodec = _ptable->codec();
+    if (pcodec) {
+        arep.set(pcodec->size());
+        return (pcodec->format(ptuple, arep._dest));
+    }
+
     // Format the data field by field
 
 
@@ -680,6 +704,13 @@ bool table_man_t::load(table_tuple* ptuple,
     assert (ptuple);
     assert (data);
 
+    row_codec_t* pcodec = _ptable->codec();
+    if (pcodec) {
+        pcodec->load(ptuple, data);
+        ptuple->reset_dirty(true);
+        return (true);
+    }
+
     // 1. Get the pre-calculated offsets
 
     // current offset for fixed length field values
@@ -732,6 +763,7 @@ bool table_man_t::load(table_tuple* ptuple,
 	    fixed_offset += ptuple->_pvalues[i].maxsize();
 	}
     }
+    ptuple->reset_dirty(true);
     return (true);
 }
 
@@ -824,6 +856,8 @@ bool table_man_t::load_key(const char* string,
         offset += size;
     }
 
+    // only the key was read
+    ptuple->reset_dirty(false);
     return (true);
 }
 
@@ -847,6 +881,7 @@ int table_man_t::min_key(index_desc_t* pindex,
     for (uint_t i=0; i<pindex->field_count(); i++) {
 	uint_t field_index = pindex->key_index(i);
 	ptuple->_pvalues[field_index].set_min_value();
+	ptuple->mark_dirty(field_index);
     }
     return (format_key(pindex, ptuple, arep));
 }
@@ -860,6 +895,7 @@ int table_man_t::max_key(index_desc_t* pindex,
     for (uint_t i=0; i<pindex->field_count(); i++) {
 	uint_t field_index = pindex->key_index(i);
 	ptuple->_pvalues[field_index].set_max_value();
+	ptuple->mark_dirty(field_index);
     }
     return (format_key(pindex, ptuple, arep));
 }
@@ -909,6 +945,32 @@ int table_man_t::get_pnum(index_desc_t* pindex,
 
 
 
+/*********************************************************************
+ *
+ *  @fn:    start_bulkload
+ *  
+ *  @brief: Switches the table to bulk-load mode. From now on add_tuple()
+ *          collects the index entries, which are built by the 
+ *          index_bulk_buf_t::build() calls at the end of the loading.
+ *
+ *********************************************************************/
+
+bool table_man_t::start_bulkload()
+{
+    assert (_ptable);
+    if (!bulk_loader_t::supports(_ptable)) {
+        TRACE( TRACE_ALWAYS, "(%s) has MRBT indexes, cannot bulk-load\n",
+               _ptable->name());
+        return (false);
+    }
+    if (!is_bulkloading()) {
+        _pbulk = new bulk_loader_t(_ptable);
+    }
+    return (true);
+}
+
+
+
 mcs_lock table_man_t::register_table_lock;
 std::map<stid_t, table_man_t*> table_man_t::stid_to_tableman;
 
@@ -987,11 +1049,20 @@ w_rc_t table_man_t::index_probe(ss_m* db,
     int key_sz = format_key(pindex, ptuple, *ptuple->_rep);
     assert (ptuple->_rep->_dest); // if NULL invalid key
 
+    // read-mostly tables may answer from memory
+    if (_pcache && (lock_mode != EX)) {
+        if (_pcache->probe(pindex, ptuple->_rep->_dest, ptuple, found)) {
+            if (!found) return RC(se_TUPLE_NOT_FOUND);
+            return (RCOK);
+        }
+    }
+
     int pnum = get_pnum(pindex, ptuple);
 
     if (pindex->is_mr()) {
 
         // Do the probe
+        PERFCTR_REGION(_pc_probe,"index-probe");
         W_DO(ss_m::find_mr_assoc(pindex->fid(pnum),
                                  vec_t(ptuple->_rep->_dest, key_sz),
                                  &(ptuple->_rid),
@@ -1003,6 +1074,7 @@ w_rc_t table_man_t::index_probe(ss_m* db,
                                  ));
     }
     else {
+        PERFCTR_REGION(_pc_probe,"index-probe");
         W_DO(ss_m::find_assoc(pindex->fid(pnum),
                               vec_t(ptuple->_rep->_dest, key_sz),
                               &(ptuple->_rid),
@@ -1018,7 +1090,10 @@ w_rc_t table_man_t::index_probe(ss_m* db,
     pin_i pin;
     latch_mode_t heap_latch_mode = LATCH_SH;
     if (system_mode & (PD_MRBT_PART | PD_MRBT_LEAF)) heap_latch_mode = LATCH_NLS;
-    W_DO(pin.pin(ptuple->rid(), 0, lock_mode, heap_latch_mode));
+    {
+        PERFCTR_REGION(_pc_lock,"rec-lock");
+        W_DO(pin.pin(ptuple->rid(), 0, lock_mode, heap_latch_mode));
+    }
 
     if (!load(ptuple, pin.body())) {
         pin.unpin();
@@ -1031,6 +1106,84 @@ w_rc_t table_man_t::index_probe(ss_m* db,
 
 
 
+/* orders the positions of a batch of probes by their formatted keys */
+struct probe_key_less_t
+{
+    const char*           _keys;
+    uint_t                _ksz;
+    const bulk_key_cmp_t* _cmp;
+
+    probe_key_less_t(const char* keys, const uint_t ksz, const bulk_key_cmp_t* cmp)
+        : _keys(keys), _ksz(ksz), _cmp(cmp) { }
+
+    inline bool operator()(const uint_t a, const uint_t b) const {
+        return (_cmp->compare(_keys + a*_ksz, _keys + b*_ksz) < 0);
+    }
+};
+
+
+/********************************************************************* 
+ *
+ *  @fn:    index_probe_batch
+ *
+ *  @brief: Probes the index for the keys of a group of tuples, in key
+ *          order. On the first key not found the probe stops and
+ *          returns se_TUPLE_NOT_FOUND.
+ *
+ *  @note:  Shore does not give us a handle to the leaf, so each key is
+ *          still a find_assoc() from the root. Sorting makes the lock
+ *          order deterministic and the consecutive descents share their
+ *          pages.
+ *
+ *********************************************************************/
+
+w_rc_t table_man_t::index_probe_batch(ss_m* db,
+                                      index_desc_t* pindex,
+                                      table_tuple** ptuples,
+                                      const uint_t count,
+                                      const lock_mode_t lock_mode,
+                                      const lpid_t& root)
+{
+    assert (_ptable);
+    assert (pindex);
+    assert (ptuples);
+
+    if (count == 0) return (RCOK);
+    if (count == 1) return (index_probe(db, pindex, ptuples[0], lock_mode, root));
+
+    // 1. format the keys
+    uint_t ksz = 0;
+    for (uint_t i=0; i<pindex->field_count(); i++) {
+        ksz += _ptable->desc(pindex->key_index(i))->fieldmaxsize();
+    }
+    array_guard_t<char> keys = new char[count*ksz];
+    array_guard_t<uint_t> order = new uint_t[count];
+    for (uint_t i=0; i<count; i++) {
+        assert (ptuples[i]);
+        assert (ptuples[i]->_rep);
+        int sz = format_key(pindex, ptuples[i], *ptuples[i]->_rep);
+        assert (ptuples[i]->_rep->_dest);
+        assert (sz == (int)ksz);
+        memcpy(keys + i*ksz, ptuples[i]->_rep->_dest, sz);
+        order[i] = i;
+    }
+
+    // 2. sort the positions by key
+    bulk_key_cmp_t cmp;
+    cmp.setup(_ptable, pindex);
+    std::sort(&order[0], &order[0] + count, probe_key_less_t(keys, ksz, &cmp));
+
+    // 3. probe
+    for (uint_t i=0; i<count; i++) {
+        W_DO(index_probe(db, pindex, ptuples[order[i]], lock_mode, root));
+    }
+    return (RCOK);
+}
+
+
+
+
+
 /* -------------------------- */
 /* --- tuple manipulation --- */
 /* -------------------------- */
@@ -1073,18 +1226,47 @@ w_rc_t table_man_t::add_tuple(ss_m* db,
     int tsz = format(ptuple, *ptuple->_rep);
     assert (ptuple->_rep->_dest); // if NULL invalid
 
-    W_DO(db->create_rec(_ptable->fid(), 
-                        vec_t(), 
-                        tsz,
-                        vec_t(ptuple->_rep->_dest, tsz),
-                        ptuple->_rid,
-                        bIgnoreLocks
-                        ));
+    {
+        // the record with its log insert
+        PERFCTR_REGION(_pc_log,"rec-insert");
+        W_DO(db->create_rec(_ptable->heap_fid(_ptable->my_heap_part()), 
+                            vec_t(), 
+                            tsz,
+                            vec_t(ptuple->_rep->_dest, tsz),
+                            ptuple->_rid,
+                            bIgnoreLocks
+                            ));
+    }
+    invalidate_cache();
+    if (_pzones) _pzones->add(ptuple);
+
+    // the record is now the formatted row
+    ptuple->reset_dirty(true);
 
     // update the indexes
     index_desc_t* index = _ptable->indexes();
     int ksz = 0;
 
+    if (is_bulkloading()) {
+        // only collect the entries, the indexes are built at the end,
+        // unless the buffers are over their memory cap
+        while (index) {
+            ksz = format_key(index, ptuple, *ptuple->_rep);
+            assert (ptuple->_rep->_dest); // if dest == NULL there is invalid key
+            int pnum = get_pnum(index, ptuple);
+            if (!_pbulk->buf(index, pnum)->add(ptuple->_rep->_dest, 
+                                               ksz, ptuple->_rid)) {
+                W_DO(db->create_assoc(index->fid(pnum),
+                                      vec_t(ptuple->_rep->_dest, ksz),
+                                      vec_t(&(ptuple->_rid), sizeof(rid_t)),
+                                      bIgnoreLocks
+                                      ));
+            }
+            index = index->next();
+        }
+        return (RCOK);
+    }
+
     while (index) {
         ksz = format_key(index, ptuple, *ptuple->_rep);
         assert (ptuple->_rep->_dest); // if dest == NULL there is invalid key
@@ -1329,6 +1511,8 @@ w_rc_t table_man_t::add_plp_tuple(ss_m* db,
 {
     assert (system_mode & (PD_MRBT_PART | PD_MRBT_LEAF));
 
+    invalidate_cache();
+
     // figure out what lock mode will be used
     bool bIgnoreLocks = false;
     if (lock_mode==NL) bIgnoreLocks = true;
@@ -1353,6 +1537,7 @@ w_rc_t table_man_t::add_plp_tuple(ss_m* db,
                              bIgnoreLocks && primary_index->is_latchless(),
                              reloc_func,
                              primary_root));
+    ptuple->reset_dirty(true);
 
     // Update the remaining indexes
     index_desc_t* index = _ptable->indexes();
@@ -1420,6 +1605,9 @@ w_rc_t table_man_t::delete_tuple(ss_m* db,
 
     if (!ptuple->is_rid_valid()) return RC(se_NO_CURRENT_TUPLE);
 
+    invalidate_cache();
+    if (_pzones) _pzones->invalidate();
+
     uint4_t system_mode = _ptable->get_pd();
     rid_t todelete = ptuple->rid();
 
@@ -1467,11 +1655,13 @@ w_rc_t table_man_t::delete_tuple(ss_m* db,
 
     }
     else {
+        PERFCTR_REGION(_pc_log,"rec-delete");
         W_DO(db->destroy_rec(todelete, bIgnoreLocks));
     }
 
     // invalidate tuple
     ptuple->set_rid(rid_t::null);
+    ptuple->reset_dirty(false);
     return (RCOK);
 }
 
@@ -1539,6 +1729,72 @@ w_rc_t table_man_t::delete_index_entry(ss_m* db,
 
 
 
+/********************************************************************* 
+ *
+ *  @fn:    _update_ranges
+ *
+ *  @brief: The byte ranges of the record that hold the dirty fields of
+ *          the row, in increasing order. Ranges closer than
+ *          UPDATE_RANGE_GAP bytes are merged, since each range costs a
+ *          log record header. Returns -1 if the whole record should be
+ *          rewritten (the image is not known, or a variable-length
+ *          field changed).
+ *
+ *********************************************************************/
+
+const offset_t UPDATE_RANGE_GAP = 32;
+
+static int _update_ranges(table_row_t* ptuple, update_range_t* ranges)
+{
+    if (!ptuple->is_image_valid()) return (-1);
+    if (!ptuple->dirty_count()) return (0);
+
+    int nranges = 0;
+
+    // the null bitmap, if a nullable field changed
+    for (uint_t i=0; i<ptuple->_field_cnt; i++) {
+        if (ptuple->is_dirty(i) && ptuple->_pvalues[i].field_desc()->allow_null()) {
+            ranges[0]._start = 0;
+            ranges[0]._len = ptuple->get_fixed_offset();
+            nranges = 1;
+            break;
+        }
+    }
+
+    offset_t offset = ptuple->get_fixed_offset();
+    for (uint_t i=0; i<ptuple->_field_cnt; i++) {
+        field_value_t& fv = ptuple->_pvalues[i];
+        if (fv.is_variable_length()) {
+            // the fields after it move, rewrite everything
+            if (ptuple->is_dirty(i)) return (-1);
+            continue;
+        }
+
+        if (ptuple->is_dirty(i)) {
+            offset_t end = offset + fv.maxsize();
+            if (nranges && 
+                (offset <= ranges[nranges-1]._start + ranges[nranges-1]._len + UPDATE_RANGE_GAP)) {
+                // extend the last one
+                ranges[nranges-1]._len = end - ranges[nranges-1]._start;
+            }
+            else if (nranges == MAX_UPDATE_RANGES) {
+                // too many, a single range from the first to here
+                ranges[0]._len = end - ranges[0]._start;
+                nranges = 1;
+            }
+            else {
+                ranges[nranges]._start = offset;
+                ranges[nranges]._len = fv.maxsize();
+                nranges++;
+            }
+        }
+        offset += fv.maxsize();
+    }
+    return (nranges);
+}
+
+
+
 /********************************************************************* 
  *
  *  @fn:    update_tuple
@@ -1551,6 +1807,9 @@ w_rc_t table_man_t::delete_index_entry(ss_m* db,
  *          There is no need of updating the indexes. That's why there
  *          is not parameter to primary_root.
  *
+ *  @note:  If the row was loaded from the record, only the bytes of the
+ *          fields that were set since are updated (and logged). 
+ *
  *  !!! In order to update a field included by an index !!!
  *  !!! the tuple should be deleted and inserted again  !!!
  *
@@ -1579,44 +1838,74 @@ w_rc_t table_man_t::update_tuple(ss_m* /* db */,
 
     // pin record
     pin_i pin;
-    W_DO(pin.pin(ptuple->rid(), 0, lock_mode, heap_latch_mode));
+    {
+        PERFCTR_REGION(_pc_lock,"rec-lock");
+        W_DO(pin.pin(ptuple->rid(), 0, lock_mode, heap_latch_mode));
+    }
     int current_size = pin.body_size();
 
+    // after the record is locked, so that a concurrent refresh waits for us
+    invalidate_cache();
 
-    // update record
+    // update record, with its log inserts
+    PERFCTR_REGION(_pc_log,"rec-update");
     int tsz = format(ptuple, *ptuple->_rep);
     assert (ptuple->_rep->_dest); // if NULL invalid
 
-    // a. if updated record cannot fit in the previous spot
     w_rc_t rc;
-    if (current_size < tsz) {
-        zvec_t azv(tsz - current_size);
-
-        if (no_heap_latch) {
-            rc = pin.append_mrbt_rec(azv,heap_latch_mode);
-        }
-        else {
-            rc = pin.append_rec(azv);
+    update_range_t ranges[MAX_UPDATE_RANGES];
+    int nranges = -1;
+    if (current_size == tsz) nranges = _update_ranges(ptuple, ranges);
+
+    if (nranges >= 0) {
+        // a. only the dirty fields
+        for (int i=0; i<nranges; i++) {
+            vec_t adata(ptuple->_rep->_dest + ranges[i]._start, ranges[i]._len);
+            if (no_heap_latch) {
+                rc = pin.update_mrbt_rec(ranges[i]._start, adata, bIgnoreLocks, true);
+            } else {
+                rc = pin.update_rec(ranges[i]._start, adata, bIgnoreLocks);
+            }
+            if (rc.is_error()) break;
         }
+        if (!rc.is_error()) stat_inc(_partial_updates);
+    }
+    else {
+        // b. if updated record cannot fit in the previous spot
+        if (current_size < tsz) {
+            zvec_t azv(tsz - current_size);
 
-        // on error unpin 
-        if (rc.is_error()) {
-            TRACE( TRACE_DEBUG, "Error updating (by append) record\n");
-            pin.unpin();
+            if (no_heap_latch) {
+                rc = pin.append_mrbt_rec(azv,heap_latch_mode);
+            }
+            else {
+                rc = pin.append_rec(azv);
+            }
+
+            // on error unpin 
+            if (rc.is_error()) {
+                TRACE( TRACE_DEBUG, "Error updating (by append) record\n");
+                pin.unpin();
+            }
+            W_DO(rc);
         }
-        W_DO(rc);
-    }
 
     
-    // b. else, simply update
-    if (no_heap_latch) {
-        rc = pin.update_mrbt_rec(0, vec_t(ptuple->_rep->_dest, tsz),
-                                 bIgnoreLocks, true);
-    } else {
-        rc = pin.update_rec(0, vec_t(ptuple->_rep->_dest, tsz), bIgnoreLocks);
+        // c. else, simply update
+        if (no_heap_latch) {
+            rc = pin.update_mrbt_rec(0, vec_t(ptuple->_rep->_dest, tsz),
+                                     bIgnoreLocks, true);
+        } else {
+            rc = pin.update_rec(0, vec_t(ptuple->_rep->_dest, tsz), bIgnoreLocks);
+        }
+        if (!rc.is_error()) stat_inc(_full_updates);
     }
 
     if (rc.is_error()) TRACE( TRACE_DEBUG, "Error updating record\n");
+    else {
+        ptuple->reset_dirty(true);
+        if (_pzones) _pzones->add(ptuple);
+    }
 
     // 3. unpin
     pin.unpin();
@@ -1625,6 +1914,17 @@ w_rc_t table_man_t::update_tuple(ss_m* /* db */,
 
 
 
+void table_man_t::print_update_stats() const
+{
+    uint64_t partial = partial_updates();
+    uint64_t full = full_updates();
+    if (partial + full == 0) return;
+    TRACE( TRACE_STATISTICS, "%s: (%lld) partial updates, (%lld) full updates\n",
+           _ptable->name(), (long long)partial, (long long)full);
+}
+
+
+
 /********************************************************************* 
  *
  *  @fn:    read_tuple
@@ -1654,7 +1954,10 @@ w_rc_t table_man_t::read_tuple(table_tuple* ptuple,
     }
 
     pin_i  pin;
-    W_DO(pin.pin(ptuple->rid(), 0, lock_mode, heap_latch_mode));
+    {
+        PERFCTR_REGION(_pc_lock,"rec-lock");
+        W_DO(pin.pin(ptuple->rid(), 0, lock_mode, heap_latch_mode));
+    }
     if (!load(ptuple, pin.body())) {
         pin.unpin();
         return RC(se_WRONG_DISK_DATA);
@@ -1693,11 +1996,14 @@ w_rc_t table_man_t::fetch_table(ss_m* db, lock_mode_t alm)
 
     W_DO(db->begin_xct());
 	
-    // 1. scan the table
-    scan_file_i t_scan(_ptable->fid(), ss_m::t_cc_record, false, alm);
-    while(!eof) {
-	W_DO(t_scan.next_page(handle, 0, eof));
-	counter++;
+    // 1. scan the table (all the heap sub-files)
+    for (int part=0; part<_ptable->heap_parts(); part++) {
+	scan_file_i t_scan(_ptable->heap_fid(part), ss_m::t_cc_record, false, alm);
+	eof = false;
+	while(!eof) {
+	    W_DO(t_scan.next_page(handle, 0, eof));
+	    counter++;
+	}
     }
     TRACE( TRACE_ALWAYS, "%s:%d pages\n", _ptable->name(), counter);
 
@@ -1752,6 +2058,32 @@ void table_fetcher_t::work()
 
 
 
+/* ---------------------- */
+/* --- column builder --- */
+/* ---------------------- */
+
+
+column_builder_t::column_builder_t(ShoreEnv* env)
+    : thread_t("DB_COLUMNS"), _env(env)
+{
+}
+
+column_builder_t::~column_builder_t()
+{
+}
+
+void column_builder_t::work()
+{
+    assert(_env);
+    w_rc_t e = _env->db_columns();
+    if(e.is_error()) {
+	cerr << "Error while building the columnar replicas!" << endl << e << endl;
+    }
+}
+
+
+
+
 /* ------------------- */
 /* --- db printer  --- */
 /* ------------------- */
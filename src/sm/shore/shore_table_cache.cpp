@@ -0,0 +1,387 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   shore_table_cache.cpp
+ *
+ *  @brief:  Implementation of the in-memory copy of read-mostly tables
+ *
+ */
+
+#include "sm/shore/shore_table_cache.h"
+#include "sm/shore/shore_table.h"
+
+#include <algorithm>
+
+
+ENTER_NAMESPACE(shore);
+
+
+
+/* orders the rows of a snapshot by their key on one index */
+struct cached_key_less_t
+{
+    const char*           _keys;
+    uint_t                _ksz;
+    const bulk_key_cmp_t* _cmp;
+
+    cached_key_less_t(const char* keys, const uint_t ksz, const bulk_key_cmp_t* cmp)
+        : _keys(keys), _ksz(ksz), _cmp(cmp) { }
+
+    inline bool operator()(const uint_t a, const uint_t b) const {
+        return (_cmp->compare(_keys + a*_ksz, _keys + b*_ksz) < 0);
+    }
+};
+
+
+
+/********************************************************************
+ *
+ *  @fn:    index_entries_t::bound
+ *
+ *  @brief: Binary search over the sorted keys. Returns the first
+ *          position whose key is >= key (> key if bUpper).
+ *
+ ********************************************************************/
+
+uint_t table_cache_t::index_entries_t::bound(const char* akey,
+                                             const bool bUpper) const
+{
+    uint_t lo = 0;
+    uint_t hi = _sorted.size();
+    while (lo < hi) {
+        uint_t mid = lo + ((hi - lo) >> 1);
+        int r = _cmp.compare(key(mid), akey);
+        if ((r < 0) || (bUpper && (r == 0))) lo = mid + 1;
+        else hi = mid;
+    }
+    return (lo);
+}
+
+
+table_cache_t::snapshot_t::~snapshot_t()
+{
+    for (uint_t i=0; i<_indexes.size(); i++) delete (_indexes[i]);
+    for (uint_t i=0; i<_rows.size(); i++) delete (_rows[i]);
+    _indexes.clear();
+    _rows.clear();
+}
+
+
+
+
+/********************************************************************
+ *
+ *  class table_cache_t
+ *
+ ********************************************************************/
+
+table_cache_t::table_cache_t(table_man_t* pmanager)
+    : _pmanager(pmanager), _ptable(NULL),
+      _valid(false), _version(0), _refreshes(0)
+{
+    assert (_pmanager);
+    _ptable = _pmanager->table();
+    assert (_ptable);
+}
+
+table_cache_t::~table_cache_t()
+{
+    _valid = false;
+}
+
+
+
+/********************************************************************
+ *
+ *  @fn:    invalidate
+ *
+ *  @brief: The version is bumped before clearing the flag, so that a
+ *          concurrent refresh either sees the new version, or its
+ *          flag is cleared after it was set (see refresh)
+ *
+ ********************************************************************/
+
+void table_cache_t::invalidate()
+{
+    atomic_inc_uint(&_version);
+    _valid = false;
+}
+
+
+
+/********************************************************************
+ *
+ *  @fn:    refresh
+ *
+ *  @brief: Reads the whole table, with SH locks, in a new transaction.
+ *          The snapshot is published only if nobody wrote to the table
+ *          while it was being built.
+ *
+ ********************************************************************/
+
+w_rc_t table_cache_t::refresh(ss_m* db)
+{
+    assert (db);
+    CRITICAL_SECTION(refresh_cs, _refresh_lock);
+    if (_valid) return (RCOK);
+
+    uint_t version = _version;
+    membar_consumer();
+
+    snapshot_t* psnap = new snapshot_t();
+    W_DO(db->begin_xct());
+    w_rc_t e = _build(db, psnap);
+    if (e.is_error()) {
+        delete (psnap);
+        W_IGNORE(db->abort_xct());
+        return (e);
+    }
+    W_DO(db->commit_xct());
+
+    if (version != _version) {
+        // written while building, leave it invalid
+        delete (psnap);
+        return (RCOK);
+    }
+
+    // publish, the previous one is freed by its last reader
+    uint_t rows = psnap->_rows.size();
+    _snapshots.publish(psnap);
+    membar_producer();
+    _valid = true;
+
+    // an invalidation may have slipped in between the check and the set
+    if (atomic_cas_uint(&_version, version, version) != version) {
+        _valid = false;
+        return (RCOK);
+    }
+
+    _refreshes++;
+    TRACE( TRACE_DEBUG, "(%s) cached (%d) rows\n",
+           _ptable->name(), rows);
+    return (RCOK);
+}
+
+
+
+/********************************************************************
+ *
+ *  @fn:    _build
+ *
+ *  @brief: Decodes all the records of the heap file, then formats and
+ *          sorts the keys of each index
+ *
+ ********************************************************************/
+
+w_rc_t table_cache_t::_build(ss_m* db, snapshot_t* psnap)
+{
+    assert (psnap);
+
+    // 1. decode the rows (of all the heap sub-files)
+    for (int part=0; part<_ptable->heap_parts(); part++) {
+        scan_file_i scan(_ptable->heap_fid(part), ss_m::t_cc_record, false, SH);
+        pin_i* handle = NULL;
+        bool eof = false;
+        W_DO(scan.next(handle, 0, eof));
+        while (!eof) {
+            table_row_t* prow = new table_row_t(_ptable);
+            psnap->_rows.push_back(prow);
+            if (!_pmanager->load(prow, handle->body()))
+                return RC(se_WRONG_DISK_DATA);
+            prow->set_rid(handle->rid());
+            W_DO(scan.next(handle, 0, eof));
+        }
+    }
+
+    // 2. the keys of each index
+    rep_row_t arep(_pmanager->ts());
+    arep.set(_ptable->maxsize());
+
+    const uint_t nrows = psnap->_rows.size();
+    index_desc_t* pindex = _ptable->indexes();
+    while (pindex) {
+        index_entries_t* pentries = new index_entries_t();
+        psnap->_indexes.push_back(pentries);
+
+        pentries->_pindex = pindex;
+        for (uint_t i=0; i<pindex->field_count(); i++) {
+            pentries->_ksz += _ptable->desc(pindex->key_index(i))->fieldmaxsize();
+        }
+        pentries->_cmp.setup(_ptable, pindex);
+        pentries->_keys = new char[(nrows ? nrows : 1)*pentries->_ksz];
+        pentries->_sorted.resize(nrows);
+
+        for (uint_t r=0; r<nrows; r++) {
+            int ksz = _pmanager->format_key(pindex, psnap->_rows[r], arep);
+            assert (arep._dest);
+            assert (ksz == (int)pentries->_ksz);
+            memcpy(pentries->_keys + r*pentries->_ksz, arep._dest, ksz);
+            pentries->_sorted[r] = r;
+        }
+        std::sort(pentries->_sorted.begin(), pentries->_sorted.end(),
+                  cached_key_less_t(pentries->_keys, pentries->_ksz,
+                                    &pentries->_cmp));
+        pindex = pindex->next();
+    }
+    return (RCOK);
+}
+
+
+
+table_cache_t::index_entries_t*
+table_cache_t::_entries(snapshot_t* psnap, index_desc_t* pindex) const
+{
+    assert (psnap);
+    // Tables have a handful of indexes, a linear search is enough
+    for (uint_t i=0; i<psnap->_indexes.size(); i++) {
+        if (psnap->_indexes[i]->_pindex == pindex)
+            return (psnap->_indexes[i]);
+    }
+    assert (0); // unknown index
+    return (NULL);
+}
+
+
+
+/********************************************************************
+ *
+ *  @fn:    probe
+ *
+ *  @brief: Point lookup on one of the indexes
+ *
+ ********************************************************************/
+
+bool table_cache_t::probe(index_desc_t* pindex, const char* key,
+                          table_row_t* ptuple, bool& found)
+{
+    assert (pindex);
+    assert (key);
+    assert (ptuple);
+
+    snapshot_t* psnap = _pin();
+    if (!psnap) return (false);
+
+    index_entries_t* pentries = _entries(psnap, pindex);
+    uint_t pos = pentries->bound(key, false);
+    found = ((pos < pentries->_sorted.size()) &&
+             (pentries->_cmp.compare(pentries->key(pos), key) == 0));
+    if (found) {
+        copy_row(ptuple, psnap->_rows[pentries->_sorted[pos]]);
+    }
+    _snapshots.unpin(psnap);
+    return (true);
+}
+
+
+
+/********************************************************************
+ *
+ *  @fn:    range
+ *
+ *  @brief: The rows of the closed key range [low,high] of an index
+ *
+ ********************************************************************/
+
+bool table_cache_t::range(index_desc_t* pindex,
+                          const char* low, const char* high,
+                          vector<const table_row_t*>& rows,
+                          pin_t& pin)
+{
+    assert (pindex);
+    assert (low);
+    assert (high);
+
+    pin.release();
+    snapshot_t* psnap = _pin();
+    if (!psnap) return (false);
+    pin._pcache = this;
+    pin._psnap = psnap;
+
+    index_entries_t* pentries = _entries(psnap, pindex);
+    uint_t first = pentries->bound(low, false);
+    uint_t last  = pentries->bound(high, true);
+    rows.clear();
+    for (uint_t pos=first; pos<last; pos++) {
+        rows.push_back(psnap->_rows[pentries->_sorted[pos]]);
+    }
+    return (true);
+}
+
+
+
+/********************************************************************
+ *
+ *  @fn:    copy_row
+ *
+ *  @brief: Copies the decoded values, so that a hit costs a few
+ *          memcpy and no disk-format parsing
+ *
+ ********************************************************************/
+
+void table_cache_t::copy_row(table_row_t* pdest, const table_row_t* psrc)
+{
+    assert (pdest);
+    assert (psrc);
+    assert (pdest->_field_cnt == psrc->_field_cnt);
+
+    for (uint_t i=0; i<psrc->_field_cnt; i++) {
+        const field_value_t& src = psrc->_pvalues[i];
+        field_value_t& dest = pdest->_pvalues[i];
+        if (src._null_flag) {
+            dest.set_null();
+            continue;
+        }
+        switch (dest.field_desc()->type()) {
+        case SQL_TIME:
+            dest.set_value(src._value._time, src._real_size);
+            break;
+        case SQL_VARCHAR:
+        case SQL_FIXCHAR:
+        case SQL_NUMERIC:
+        case SQL_SNUMERIC:
+            dest.set_value(src._value._string, src._real_size);
+            break;
+        default:
+            dest.set_value(&src._value, src._max_size);
+            break;
+        }
+    }
+    pdest->set_rid(psrc->rid());
+
+    // the values came from the snapshot, not from the record
+    pdest->reset_dirty(false);
+}
+
+
+
+void table_cache_t::print_stats() const
+{
+    snapshot_t* psnap = _pin();
+    TRACE( TRACE_STATISTICS, "%s: %s (%d) rows, (%d) refreshes\n",
+           _ptable->name(), (psnap ? "valid" : "invalid"),
+           (psnap ? psnap->_rows.size() : 0), _refreshes);
+    if (psnap) _snapshots.unpin(psnap);
+}
+
+
+EXIT_NAMESPACE(shore);
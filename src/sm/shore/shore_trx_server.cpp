@@ -0,0 +1,556 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   shore_trx_server.cpp
+ *
+ *  @brief:  Implementation of the transaction server
+ */
+
+#include "sm/shore/shore_trx_server.h"
+
+#include "util/tcp.h"
+
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+
+ENTER_NAMESPACE(shore);
+
+
+// events handled per epoll_wait
+const int SRV_MAX_EVENTS = 256;
+
+// bytes read per read() call
+const uint SRV_READ_CHUNK = 65536;
+
+
+trx_server_t::trx_server_t(c_str tname, ShoreEnv* env, 
+                           const int port, const int duration,
+                           const uint max_inflight,
+                           const std::vector<base_client_t*>& stubs,
+                           const mapSupTrxs& sup_trxs)
+    : thread_t(tname), _env(env), _port(port), _duration(duration),
+      _max_inflight(max_inflight), _stubs(stubs), _sup_trxs(sup_trxs),
+      _listen_fd(-1), _epoll_fd(-1), _inflight(0), _reap(false),
+      _accepted(0), _requests(0), _committed(0), _aborted(0), _rejected(0),
+      _rv(0)
+{
+    assert (_env);
+    assert (!_stubs.empty());
+    assert (_max_inflight);
+
+    _slots.resize(_max_inflight);
+    _free_slots.reserve(_max_inflight);
+    for (int i=_max_inflight-1; i>=0; i--) {
+        _free_slots.push_back(i);
+    }
+}
+
+trx_server_t::~trx_server_t()
+{
+    _close();
+}
+
+
+/******************************************************************** 
+ *
+ *  @fn:    _open/_close
+ *
+ *  @brief: Set up and tear down the listening socket and the epoll set
+ *
+ ********************************************************************/
+
+int trx_server_t::_open()
+{
+    _listen_fd = open_listenfd(_port);
+    if (_listen_fd < 0) {
+        TRACE( TRACE_ALWAYS, "Could not open port (%d) (%s)\n",
+               _port, strerror(errno));
+        return (1);
+    }
+    fcntl(_listen_fd, F_SETFL, fcntl(_listen_fd, F_GETFL) | O_NONBLOCK);
+
+    _epoll_fd = epoll_create(SRV_MAX_EVENTS);
+    if (_epoll_fd < 0) {
+        TRACE( TRACE_ALWAYS, "epoll_create failed (%s)\n", strerror(errno));
+        return (1);
+    }
+
+    // the listening socket is the only one with a NULL pointer
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.ptr = NULL;
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _listen_fd, &ev) < 0) {
+        TRACE( TRACE_ALWAYS, "epoll_ctl failed (%s)\n", strerror(errno));
+        return (1);
+    }
+
+    TRACE( TRACE_ALWAYS, "Serving at port (%d) for (%d) secs\n", 
+           _port, _duration);
+    return (0);
+}
+
+void trx_server_t::_close()
+{
+    for (uint i=0; i<_conns.size(); i++) {
+        if (!_conns[i]->_closed) close(_conns[i]->_fd);
+        delete (_conns[i]);
+    }
+    _conns.clear();
+    _dirty.clear();
+    _stalled.clear();
+
+    if (_listen_fd >= 0) {
+        close(_listen_fd);
+        _listen_fd = -1;
+    }
+    if (_epoll_fd >= 0) {
+        close(_epoll_fd);
+        _epoll_fd = -1;
+    }
+}
+
+
+/******************************************************************** 
+ *
+ *  @fn:    work
+ *
+ *  @brief: The event loop. It stops accepting requests after the
+ *          duration, and exits once the in-flight ones completed.
+ *
+ *  @note:  While requests are in flight it polls (zero timeout), so
+ *          that completions are returned as soon as they are pushed.
+ *
+ ********************************************************************/
+
+void trx_server_t::work()
+{
+    if (_open()) {
+        _close();
+        _rv = 1;
+        return;
+    }
+
+    // DORA begins the xcts at the submitting thread
+    string sysname = envVar::instance()->getSysName();
+    bool bBaseline = (sysname.compare("baseline")==0);
+    if (!bBaseline) {
+        me()->alloc_sdesc_cache();
+    }
+
+    struct epoll_event events[SRV_MAX_EVENTS];
+    stopwatch_t timer;
+    long long end = timer.now() + _duration*1000000LL;
+    bool bStopping = false;
+
+    while (true) {
+
+        // 1. Check for the end of the run
+        if (!bStopping && 
+            (base_client_t::is_test_aborted() || (timer.now() >= end))) {
+            TRACE( TRACE_ALWAYS, "Stopping, (%d) requests in flight\n", 
+                   _inflight);
+            bStopping = true;
+            epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, _listen_fd, NULL);
+            close(_listen_fd);
+            _listen_fd = -1;
+        }
+        if (bStopping && (_inflight == 0)) break;
+
+        // 2. Network events
+        int n = epoll_wait(_epoll_fd, events, SRV_MAX_EVENTS, 
+                           (_inflight ? 0 : 10));
+        for (int i=0; i<n; i++) {
+            conn_t* pconn = (conn_t*)events[i].data.ptr;
+            if (pconn == NULL) {
+                if (!bStopping) _accept();
+                continue;
+            }
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                _drop(pconn);
+                continue;
+            }
+            if ((events[i].events & EPOLLIN) && !bStopping) {
+                _read(pconn);
+            }
+            if ((events[i].events & EPOLLOUT) && !pconn->_closed) {
+                _flush(pconn);
+            }
+        }
+
+        // 3. Completions
+        if (_drain() && !bStopping) {
+            // resume the connections that hit the in-flight limit
+            std::vector<conn_t*> stalled;
+            stalled.swap(_stalled);
+            for (uint i=0; i<stalled.size(); i++) {
+                stalled[i]->_stalled = false;
+                if (!stalled[i]->_closed) _parse(stalled[i]);
+            }
+        }
+
+        if (_reap) _reap_closed();
+    }
+
+    if (!bBaseline) {
+        me()->free_sdesc_cache();
+    }
+    _close();
+}
+
+
+/******************************************************************** 
+ *
+ *  @fn:    _accept
+ *
+ *  @brief: Accepts all the pending connections
+ *
+ ********************************************************************/
+
+void trx_server_t::_accept()
+{
+    while (true) {
+        int fd = accept(_listen_fd, NULL, NULL);
+        if (fd < 0) {
+            if ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR)) {
+                TRACE( TRACE_ALWAYS, "accept failed (%s)\n", strerror(errno));
+            }
+            return;
+        }
+
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        conn_t* pconn = new conn_t(fd);
+        struct epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.ptr = pconn;
+        if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+            TRACE( TRACE_ALWAYS, "epoll_ctl failed (%s)\n", strerror(errno));
+            close(fd);
+            delete (pconn);
+            continue;
+        }
+        _conns.push_back(pconn);
+        ++_accepted;
+        TRACE( TRACE_DEBUG, "Accepted connection (%d)\n", fd);
+    }
+}
+
+
+/******************************************************************** 
+ *
+ *  @fn:    _read
+ *
+ *  @brief: Reads whatever is available and parses the complete frames
+ *
+ ********************************************************************/
+
+void trx_server_t::_read(conn_t* pconn)
+{
+    while (true) {
+        uint sz = pconn->_rbuf.size();
+        pconn->_rbuf.resize(sz + SRV_READ_CHUNK);
+        ssize_t n = read(pconn->_fd, &pconn->_rbuf[sz], SRV_READ_CHUNK);
+        if (n > 0) {
+            pconn->_rbuf.resize(sz + n);
+            if ((uint)n < SRV_READ_CHUNK) break;
+            continue;
+        }
+        pconn->_rbuf.resize(sz);
+        if ((n < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK))) break;
+        if ((n < 0) && (errno == EINTR)) continue;
+
+        // peer closed, or error
+        _drop(pconn);
+        return;
+    }
+
+    if (!pconn->_stalled) _parse(pconn);
+}
+
+
+/******************************************************************** 
+ *
+ *  @fn:    _parse
+ *
+ *  @brief: Decodes and submits the complete frames of the read buffer,
+ *          as long as the server is below its in-flight limit
+ *
+ ********************************************************************/
+
+void trx_server_t::_parse(conn_t* pconn)
+{
+    std::vector<char>& rbuf = pconn->_rbuf;
+
+    if (!pconn->_hello) {
+        if (rbuf.size() - pconn->_roff < sizeof(trx_proto_hello_t)) return;
+        trx_proto_hello_t hello;
+        memcpy(&hello, &rbuf[pconn->_roff], sizeof(hello));
+        pconn->_roff += sizeof(hello);
+        if ((hello._magic != TRX_PROTO_MAGIC) || 
+            (hello._version != TRX_PROTO_VERSION)) {
+            TRACE( TRACE_ALWAYS, "Bad handshake (%x) (%d)\n",
+                   hello._magic, hello._version);
+            _drop(pconn);
+            return;
+        }
+        pconn->_hello = true;
+    }
+
+    trx_proto_req_t req;
+    while (rbuf.size() - pconn->_roff >= sizeof(trx_proto_req_t)) {
+        if (_inflight >= _max_inflight) {
+            pconn->_stalled = true;
+            _stalled.push_back(pconn);
+            break;
+        }
+        memcpy(&req, &rbuf[pconn->_roff], sizeof(req));
+        pconn->_roff += sizeof(req);
+        _submit(pconn, req);
+        if (pconn->_closed) return;
+    }
+
+    // keep only the partial frame
+    if (pconn->_roff) {
+        rbuf.erase(rbuf.begin(), rbuf.begin() + pconn->_roff);
+        pconn->_roff = 0;
+    }
+
+    if (pconn->_dirty) _flush(pconn);
+}
+
+
+/******************************************************************** 
+ *
+ *  @fn:    _submit
+ *
+ *  @brief: Submits a request through the stub of its selected id.
+ *          The index of its in-flight slot is the xct id, so that the
+ *          completion can be matched back to the connection.
+ *
+ ********************************************************************/
+
+void trx_server_t::_submit(conn_t* pconn, const trx_proto_req_t& req)
+{
+    if ((_sup_trxs.find(req._xct_type) == _sup_trxs.end()) ||
+        (req._sel_id < 0) || (req._sel_id >= (int)_stubs.size())) 
+    {
+        ++_rejected;
+        _reply(pconn, req._tag, TRX_PROTO_REJECTED);
+        return;
+    }
+
+    int idx = _free_slots.back();
+    _free_slots.pop_back();
+    _slots[idx]._conn = pconn;
+    _slots[idx]._tag = req._tag;
+    ++_inflight;
+    ++pconn->_inflight;
+    ++_requests;
+
+    w_rc_t e = _stubs[req._sel_id]->submit_notified(req._xct_type, idx);
+    if (e.is_error()) {
+        TRACE( TRACE_ALWAYS, "Submit failed [0x%x]\n", e.err_num());
+        // nothing will be pushed for it
+        _free_slots.push_back(idx);
+        --_inflight;
+        --pconn->_inflight;
+        ++_aborted;
+        _reply(pconn, req._tag, TRX_PROTO_ROLLBACKED);
+    }
+}
+
+
+/******************************************************************** 
+ *
+ *  @fn:    _drain
+ *
+ *  @brief: Turns the completions pushed to the stubs' rings into 
+ *          responses, and writes them
+ *
+ *  @return: The number of completions
+ *
+ ********************************************************************/
+
+int trx_server_t::_drain()
+{
+    int cnt = 0;
+    completion_t rec;
+    for (uint s=0; s<_stubs.size(); s++) {
+        completion_queue_t* pcq = _stubs[s]->completions();
+        while (pcq->try_pop(rec)) {
+            assert ((rec._xct_id >= 0) && (rec._xct_id < (int)_slots.size()));
+            slot_t& aslot = _slots[rec._xct_id];
+            conn_t* pconn = aslot._conn;
+            aslot._conn = NULL;
+            _free_slots.push_back(rec._xct_id);
+            --_inflight;
+            --pconn->_inflight;
+            ++cnt;
+
+            if (rec._state == TRX_PROTO_COMMITTED) ++_committed;
+            else ++_aborted;
+
+            if (!pconn->_closed) {
+                _reply(pconn, aslot._tag, rec._state);
+            }
+            else if (pconn->_inflight == 0) {
+                _reap = true;
+            }
+        }
+    }
+
+    // write the responses
+    for (uint i=0; i<_dirty.size(); i++) {
+        if (!_dirty[i]->_closed) _flush(_dirty[i]);
+        _dirty[i]->_dirty = false;
+    }
+    _dirty.clear();
+    return (cnt);
+}
+
+
+/******************************************************************** 
+ *
+ *  @fn:    _reply/_flush
+ *
+ *  @brief: Buffers a response, and writes the buffered responses
+ *
+ ********************************************************************/
+
+void trx_server_t::_reply(conn_t* pconn, const uint32_t tag, const int32_t state)
+{
+    trx_proto_resp_t resp;
+    resp._tag = tag;
+    resp._state = state;
+    const char* p = (const char*)&resp;
+    pconn->_wbuf.insert(pconn->_wbuf.end(), p, p + sizeof(resp));
+    if (!pconn->_dirty) {
+        pconn->_dirty = true;
+        _dirty.push_back(pconn);
+    }
+}
+
+void trx_server_t::_flush(conn_t* pconn)
+{
+    std::vector<char>& wbuf = pconn->_wbuf;
+    while (pconn->_woff < wbuf.size()) {
+        ssize_t n = write(pconn->_fd, &wbuf[pconn->_woff], 
+                          wbuf.size() - pconn->_woff);
+        if (n >= 0) {
+            pconn->_woff += n;
+            continue;
+        }
+        if (errno == EINTR) continue;
+        if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+            // wait until the socket is writable
+            if (!pconn->_writing) {
+                struct epoll_event ev;
+                ev.events = EPOLLIN | EPOLLOUT;
+                ev.data.ptr = pconn;
+                epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, pconn->_fd, &ev);
+                pconn->_writing = true;
+            }
+            return;
+        }
+        _drop(pconn);
+        return;
+    }
+
+    wbuf.clear();
+    pconn->_woff = 0;
+    if (pconn->_writing) {
+        struct epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.ptr = pconn;
+        epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, pconn->_fd, &ev);
+        pconn->_writing = false;
+    }
+}
+
+
+/******************************************************************** 
+ *
+ *  @fn:    _drop/_reap_closed
+ *
+ *  @brief: A dropped connection is closed immediately, but freed only
+ *          after its in-flight requests completed
+ *
+ ********************************************************************/
+
+void trx_server_t::_drop(conn_t* pconn)
+{
+    if (pconn->_closed) return;
+    TRACE( TRACE_DEBUG, "Closing connection (%d) (%d) in flight\n", 
+           pconn->_fd, pconn->_inflight);
+    epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, pconn->_fd, NULL);
+    close(pconn->_fd);
+    pconn->_closed = true;
+    pconn->_wbuf.clear();
+    pconn->_woff = 0;
+    _reap = true;
+}
+
+void trx_server_t::_reap_closed()
+{
+    _reap = false;
+    uint j = 0;
+    for (uint i=0; i<_conns.size(); i++) {
+        conn_t* pconn = _conns[i];
+        if (pconn->_closed && (pconn->_inflight == 0) && 
+            !pconn->_stalled && !pconn->_dirty) {
+            delete (pconn);
+        }
+        else {
+            _conns[j++] = pconn;
+        }
+    }
+    _conns.resize(j);
+}
+
+
+/******************************************************************** 
+ *
+ *  @fn:    print_stats
+ *
+ ********************************************************************/
+
+void trx_server_t::print_stats() const
+{
+    TRACE( TRACE_ALWAYS, "Connections: (%ld)\n" \
+           "Requests:    (%ld)\n" \
+           "Committed:   (%ld)\n" \
+           "Aborted:     (%ld)\n" \
+           "Rejected:    (%ld)\n",
+           _accepted, _requests, _committed, _aborted, _rejected);
+}
+
+
+EXIT_NAMESPACE(shore);
@@ -0,0 +1,613 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   shore_zone_map.cpp
+ *
+ *  @brief:  Implementation of the page-range zone maps of heap files
+ *
+ */
+
+#include "sm/shore/shore_zone_map.h"
+#include "sm/shore/shore_table.h"
+
+
+ENTER_NAMESPACE(shore);
+
+
+
+// whether rid a is before rid b in the order of the pages
+static inline bool _rid_before(const rid_t& a, const rid_t& b)
+{
+    return ((a.pid.page < b.pid.page) ||
+            ((a.pid.page == b.pid.page) && (a.slot < b.slot)));
+}
+
+static inline bool _is_string(const sqltype_t type)
+{
+    return ((type == SQL_FIXCHAR) || (type == SQL_VARCHAR));
+}
+
+
+
+/********************************************************************
+ *
+ *  class zone_map_t
+ *
+ ********************************************************************/
+
+zone_map_t::zone_map_t(table_man_t* pmanager, const vector<uint_t>& cols,
+                       const uint_t range_pages)
+    : _pmanager(pmanager), _ptable(NULL), _range_pages(range_pages),
+      _valid(false), _version(0), _refreshes(0),
+      _scans(0), _ranges_read(0), _ranges_skipped(0)
+{
+    assert (_pmanager);
+    assert (_range_pages);
+    _ptable = _pmanager->table();
+    assert (_ptable);
+
+    for (uint_t i=0; i<cols.size(); i++) {
+        assert (cols[i] < _ptable->field_count());
+        field_desc_t* pfd = _ptable->desc(cols[i]);
+        switch (pfd->type()) {
+        case SQL_TIME:
+        case SQL_NUMERIC:
+        case SQL_SNUMERIC:
+            TRACE( TRACE_ALWAYS, "(%s) field (%s) of unsupported type, ignored\n",
+                   _ptable->name(), pfd->name());
+            break;
+        default:
+            _cols.push_back(cols[i]);
+            _types.push_back(pfd->type());
+        }
+    }
+}
+
+zone_map_t::~zone_map_t()
+{
+    _valid = false;
+    _clear(_ranges);
+}
+
+
+void zone_map_t::_clear(range_map& ranges)
+{
+    for (range_map::iterator it = ranges.begin(); it != ranges.end(); ++it) {
+        delete (it->second);
+    }
+    ranges.clear();
+}
+
+
+void zone_map_t::reset()
+{
+    CRITICAL_SECTION(cs, _lock);
+    _clear(_ranges);
+    _version++;
+    _valid = true;
+}
+
+
+void zone_map_t::invalidate()
+{
+    CRITICAL_SECTION(cs, _lock);
+    _version++;
+    _valid = false;
+}
+
+
+
+/********************************************************************
+ *
+ *  @fn:    _part_of
+ *
+ *  @brief: The heap sub-file of a record, -1 if it is not in the table
+ *
+ ********************************************************************/
+
+int zone_map_t::_part_of(const rid_t& rid)
+{
+    for (int i=0; i<_ptable->heap_parts(); i++) {
+        if (_ptable->heap_fid(i) == rid.pid.stid()) return (i);
+    }
+    return (-1);
+}
+
+
+
+/********************************************************************
+ *
+ *  @fn:    _values
+ *
+ *  @brief: The values of the registered columns of a row, each as a
+ *          zone with a single value
+ *
+ ********************************************************************/
+
+void zone_map_t::_values(const table_row_t* prow, vector<zone_t>& vals) const
+{
+    vals.resize(_cols.size());
+    for (uint_t i=0; i<_cols.size(); i++) {
+        const uint_t idx = _cols[i];
+        zone_t& z = vals[i];
+        bool bOk = false;
+        switch (_types[i]) {
+        case SQL_BIT:      { bool v;      bOk = prow->get_value(idx, v); z._imin = (v ? 1 : 0); break; }
+        case SQL_SMALLINT: { short v;     bOk = prow->get_value(idx, v); z._imin = v; break; }
+        case SQL_INT:      { int v;       bOk = prow->get_value(idx, v); z._imin = v; break; }
+        case SQL_LONG:     { long long v; bOk = prow->get_value(idx, v); z._imin = v; break; }
+        case SQL_CHAR:     { char v;      bOk = prow->get_value(idx, v); z._imin = v; break; }
+        case SQL_FLOAT:    { bOk = prow->get_value(idx, z._dmin); break; }
+        case SQL_FIXCHAR:
+        case SQL_VARCHAR:
+            {
+                const uint_t sz = _ptable->desc(idx)->fieldmaxsize() + 1;
+                array_guard_t<char> buf(new char[sz]);
+                bOk = prow->get_value(idx, buf, sz);
+                if (bOk) z._smin = buf.get();
+                break;
+            }
+        default:
+            assert (0); // filtered by the constructor
+        }
+        // get_value() returns false on NULL
+        z._empty = !bOk;
+        z._imax = z._imin;
+        z._dmax = z._dmin;
+        z._smax = z._smin;
+    }
+}
+
+
+
+/********************************************************************
+ *
+ *  @fn:    _add
+ *
+ *  @brief: Widens the zones of the range of rid with the values of a row
+ *
+ ********************************************************************/
+
+void zone_map_t::_add(range_map& ranges, const rid_t& rid, const int part,
+                      const vector<zone_t>& vals)
+{
+    const uint64_t k = key(part, rid.pid.page);
+    zone_range_t* pr = NULL;
+    range_map::iterator it = ranges.find(k);
+    if (it == ranges.end()) {
+        pr = new zone_range_t(part, rid.pid.page / _range_pages, _cols.size());
+        ranges[k] = pr;
+    }
+    else {
+        pr = it->second;
+    }
+
+    if ((pr->_first == rid_t::null) || _rid_before(rid, pr->_first)) {
+        pr->_first = rid;
+    }
+    pr->_pages.insert(rid.pid.page);
+
+    for (uint_t i=0; i<_cols.size(); i++) {
+        const zone_t& v = vals[i];
+        if (v._empty) continue;
+        zone_t& z = pr->_zones[i];
+        if (z._empty) {
+            z = v;
+            continue;
+        }
+        if (_is_string(_types[i])) {
+            if (v._smin < z._smin) z._smin = v._smin;
+            if (v._smax > z._smax) z._smax = v._smax;
+        }
+        else if (_types[i] == SQL_FLOAT) {
+            if (v._dmin < z._dmin) z._dmin = v._dmin;
+            if (v._dmax > z._dmax) z._dmax = v._dmax;
+        }
+        else {
+            if (v._imin < z._imin) z._imin = v._imin;
+            if (v._imax > z._imax) z._imax = v._imax;
+        }
+    }
+}
+
+
+
+/********************************************************************
+ *
+ *  @fn:    add
+ *
+ *  @brief: While the map is not valid it only bumps the version, so
+ *          that a refresh that is running does not publish a map that
+ *          may have missed the row.
+ *
+ ********************************************************************/
+
+void zone_map_t::add(const table_row_t* prow)
+{
+    assert (prow);
+    assert (prow->is_rid_valid());
+
+    const rid_t rid = prow->rid();
+    const int part = _part_of(rid);
+    vector<zone_t> vals;
+    if (part >= 0) _values(prow, vals);
+
+    CRITICAL_SECTION(cs, _lock);
+    if (!_valid || (part < 0)) {
+        _version++;
+        _valid = false;
+        return;
+    }
+    _add(_ranges, rid, part, vals);
+}
+
+
+
+/********************************************************************
+ *
+ *  @fn:    refresh
+ *
+ *  @brief: Reads the whole table, with SH locks, in a new transaction.
+ *          The map is published only if nobody wrote to the table
+ *          while it was being built.
+ *
+ ********************************************************************/
+
+w_rc_t zone_map_t::refresh(ss_m* db)
+{
+    assert (db);
+    CRITICAL_SECTION(refresh_cs, _refresh_lock);
+    if (_valid) return (RCOK);
+
+    uint_t version;
+    {
+        CRITICAL_SECTION(cs, _lock);
+        version = _version;
+    }
+
+    time_t tstart = time(NULL);
+    range_map ranges;
+    W_DO(db->begin_xct());
+    w_rc_t e = _build(db, ranges);
+    if (e.is_error()) {
+        _clear(ranges);
+        W_IGNORE(db->abort_xct());
+        return (e);
+    }
+    e = db->commit_xct();
+    if (e.is_error()) {
+        _clear(ranges);
+        return (e);
+    }
+
+    bool bPublished = false;
+    {
+        CRITICAL_SECTION(cs, _lock);
+        // not if written while building, then it stays invalid
+        if (version == _version) {
+            _ranges.swap(ranges);
+            _valid = true;
+            bPublished = true;
+        }
+    }
+    _clear(ranges); // the previous ones, or the discarded
+    if (!bPublished) return (RCOK);
+
+    _refreshes++;
+    TRACE( TRACE_ALWAYS, "(%s) zone maps built in (%d) secs\n",
+           _ptable->name(), (time(NULL) - tstart));
+    print_stats();
+    return (RCOK);
+}
+
+
+w_rc_t zone_map_t::_build(ss_m* db, range_map& ranges)
+{
+    table_row_t arow(_ptable);
+    vector<zone_t> vals;
+
+    for (int part=0; part<_ptable->heap_parts(); part++) {
+        scan_file_i scan(_ptable->heap_fid(part), ss_m::t_cc_record, false, SH);
+        pin_i* handle = NULL;
+        bool eof = false;
+        W_DO(scan.next(handle, 0, eof));
+        while (!eof) {
+            if (!_pmanager->load(&arow, handle->body()))
+                return RC(se_WRONG_DISK_DATA);
+            _values(&arow, vals);
+            _add(ranges, handle->rid(), part, vals);
+            W_DO(scan.next(handle, 0, eof));
+        }
+    }
+    return (RCOK);
+}
+
+
+
+/********************************************************************
+ *
+ *  @fn:    qualifying
+ *
+ *  @brief: A range qualifies if the zone of every predicate overlaps
+ *          it. A column with only NULLs in the range never does.
+ *
+ ********************************************************************/
+
+bool zone_map_t::_overlaps(const zone_range_t* pr,
+                           const vector<column_pred_t>& preds) const
+{
+    for (uint_t i=0; i<preds.size(); i++) {
+        const column_pred_t& p = preds[i];
+        if (p._btype == column_pred_t::CPB_NONE) continue;
+        uint_t j = 0;
+        while ((j < _cols.size()) && (_cols[j] != p._col)) j++;
+        if (j == _cols.size()) continue; // not registered
+
+        const zone_t& z = pr->_zones[j];
+        if (z._empty) return (false);
+        bool bOverlaps;
+        if (_is_string(_types[j])) {
+            bOverlaps = p.overlaps(z._smin.c_str(), z._smax.c_str());
+        }
+        else if (_types[j] == SQL_FLOAT) {
+            bOverlaps = p.overlaps(z._dmin, z._dmax);
+        }
+        else {
+            bOverlaps = p.overlaps(z._imin, z._imax);
+        }
+        if (!bOverlaps) return (false);
+    }
+    return (true);
+}
+
+
+bool zone_map_t::qualifying(const vector<column_pred_t>& preds,
+                            vector<zone_span_t>& spans)
+{
+    spans.clear();
+    CRITICAL_SECTION(cs, _lock);
+    if (!_valid) return (false);
+
+    uint_t skipped = 0;
+    for (range_map::const_iterator it = _ranges.begin();
+         it != _ranges.end(); ++it)
+    {
+        const zone_range_t* pr = it->second;
+        if (!_overlaps(pr, preds)) {
+            skipped++;
+            continue;
+        }
+        zone_span_t span;
+        span._part = pr->_part;
+        span._key = pr->_key;
+        span._first = pr->_first;
+        span._pages.assign(pr->_pages.begin(), pr->_pages.end());
+        spans.push_back(span);
+    }
+
+    _scans++;
+    _ranges_read += spans.size();
+    _ranges_skipped += skipped;
+    return (true);
+}
+
+
+
+void zone_map_t::print_stats()
+{
+    CRITICAL_SECTION(cs, _lock);
+    if (!_valid) {
+        TRACE( TRACE_STATISTICS, "%s: invalid, (%d) refreshes\n",
+               _ptable->name(), _refreshes);
+        return;
+    }
+
+    uint_t pages = 0;
+    for (range_map::const_iterator it = _ranges.begin();
+         it != _ranges.end(); ++it)
+    {
+        pages += it->second->_pages.size();
+    }
+    TRACE( TRACE_STATISTICS, "%s: (%d) columns, (%d) ranges of (%d) pages, (%d) pages with records, (%d) refreshes\n",
+           _ptable->name(), _cols.size(), _ranges.size(), _range_pages,
+           pages, _refreshes);
+    TRACE( TRACE_STATISTICS, "%s: (%d) scans read (%d) ranges, skipped (%d)\n",
+           _ptable->name(), _scans, _ranges_read, _ranges_skipped);
+}
+
+
+
+
+/********************************************************************
+ *
+ *  class zone_cursor_t
+ *
+ ********************************************************************/
+
+zone_cursor_t::zone_cursor_t(zone_map_t* pzones,
+                             const vector<column_pred_t>& preds,
+                             const lock_mode_t lm)
+    : _pzones(pzones), _ptable(NULL), _lm(lm), _opened(false),
+      _next_span(0), _fixup(false), _next_fixup(0),
+      _part(-1), _seeked(false), _on_page(false), _page(0),
+      _pages_read(0), _seeks(0)
+{
+    assert (_pzones);
+    _ptable = _pzones->table();
+    if (!_pzones->qualifying(preds, _spans)) return;
+
+    _visited.resize(_spans.size());
+    for (uint_t i=0; i<_spans.size(); i++) {
+        const zone_span_t& s = _spans[i];
+        _span_of[_pzones->key(s._part, s._key*_pzones->range_pages())] = i;
+    }
+    _opened = true;
+}
+
+
+// whether some page of the span was not returned yet
+bool zone_cursor_t::_missed(const uint_t span) const
+{
+    const vector<shpid_t>& pages = _spans[span]._pages;
+    for (uint_t i=0; i<pages.size(); i++) {
+        if (!_visited[span].count(pages[i])) return (true);
+    }
+    return (false);
+}
+
+
+
+/********************************************************************
+ *
+ *  @fn:    _open_next
+ *
+ *  @brief: Opens a scan at the first record of the next range that has
+ *          pages not returned yet. Each range is seeked to once. When
+ *          there are no more, opens the full scans of the last pass.
+ *          Returns false when the cursor is done.
+ *
+ ********************************************************************/
+
+bool zone_cursor_t::_open_next()
+{
+    _scan.done();
+    _on_page = false;
+
+    if (!_fixup) {
+        while (_next_span < _spans.size()) {
+            const uint_t s = _next_span++;
+            if (!_missed(s)) continue;
+            _part = _spans[s]._part;
+            _scan = new scan_file_i(_ptable->heap_fid(_part), _spans[s]._first,
+                                    ss_m::t_cc_record, false, _lm);
+            _seeked = true;
+            _seeks++;
+            return (true);
+        }
+
+        // the sub-files with pages that could not be reached by seeking
+        _fixup = true;
+        for (uint_t s=0; s<_spans.size(); s++) {
+            if (!_missed(s)) continue;
+            if (_fixup_parts.empty() || (_fixup_parts.back() != _spans[s]._part))
+                _fixup_parts.push_back(_spans[s]._part);
+        }
+    }
+
+    if (_next_fixup < _fixup_parts.size()) {
+        _part = _fixup_parts[_next_fixup++];
+        TRACE( TRACE_DEBUG, "(%s) full pass over sub-file (%d)\n",
+               _ptable->name(), _part);
+        _scan = new scan_file_i(_ptable->heap_fid(_part),
+                                ss_m::t_cc_record, false, _lm);
+        _seeked = false;
+        return (true);
+    }
+    return (false);
+}
+
+
+
+/********************************************************************
+ *
+ *  @fn:    next
+ *
+ *  @brief: The next record of a qualifying page. A page is returned
+ *          only the first time the scan gets to it, and the scan is
+ *          repositioned as soon as it gets to a page of a range that
+ *          does not qualify.
+ *
+ ********************************************************************/
+
+w_rc_t zone_cursor_t::next(pin_i*& handle, bool& eof)
+{
+    assert (_opened);
+    eof = false;
+    bool bNextPage = false;
+
+    while (true) {
+        if (!_scan) {
+            if (!_open_next()) {
+                eof = true;
+                return (RCOK);
+            }
+            bNextPage = false;
+        }
+
+        bool bEnd = false;
+        w_rc_t e = (bNextPage ? _scan->next_page(handle, 0, bEnd)
+                              : _scan->next(handle, 0, bEnd));
+        bNextPage = false;
+        if (e.is_error()) {
+            // The record a range starts from may be gone (e.g. its insert
+            // was rolled back). The last pass reads the range, and fails
+            // again if the error was not because of the seek.
+            if (_seeked) {
+                _scan.done();
+                continue;
+            }
+            return (e);
+        }
+        _seeked = false;
+        if (bEnd) {
+            _scan.done();
+            continue;
+        }
+
+        const shpid_t page = handle->rid().pid.page;
+        if (_on_page && (page == _page)) return (RCOK);
+        _on_page = false;
+
+        std::map<uint64_t,uint_t>::const_iterator it =
+            _span_of.find(_pzones->key(_part, page));
+        if (it == _span_of.end()) {
+            // past the qualifying ranges, seek to the next one
+            if (_fixup) bNextPage = true;
+            else _scan.done();
+            continue;
+        }
+        if (!_visited[it->second].insert(page).second) {
+            // already returned
+            bNextPage = true;
+            continue;
+        }
+
+        _on_page = true;
+        _page = page;
+        _pages_read++;
+        return (RCOK);
+    }
+}
+
+
+pin_i* zone_cursor_t::cursor()
+{
+    if (!_scan) return (NULL);
+    pin_i* rval;
+    bool eof;
+    _scan->cursor(rval, eof);
+    return (eof ? NULL : rval);
+}
+
+
+EXIT_NAMESPACE(shore);
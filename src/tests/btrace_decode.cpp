@@ -0,0 +1,342 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   btrace_decode.cpp
+ *
+ *  @brief:  Offline decoder of the dumps of the binary tracing backend
+ *           ("trace dump <file>" at the shell)
+ *
+ *  @note:   Usage: btrace_decode [-json] <dump> [<output>]
+ *
+ *           Without -json it prints one line per record, ordered by
+ *           time across all the threads, with the format of the TRACE()
+ *           filled with the recorded arguments. Strings are not
+ *           recorded, they are printed as their address.
+ *
+ *           With -json it writes the Chrome trace-event format, which can
+ *           be loaded in chrome://tracing or Perfetto.
+ */
+
+#define BTRACE_DECODER
+#include "util/btrace.h"
+#include "trace/trace_types.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+using std::string;
+using std::vector;
+
+
+struct site_t
+{
+    uint32_t _line;
+    uint8_t  _arg_kind[BTRACE_ARGS];
+    string   _file;
+    string   _function;
+    string   _format;
+};
+
+struct thread_rec_t
+{
+    btrace_rec_t _rec;
+    uint32_t     _tid;
+};
+
+static bool rec_earlier(const thread_rec_t& a, const thread_rec_t& b)
+{
+    return (a._rec._tsc < b._rec._tsc);
+}
+
+
+
+static bool read_str(FILE* f, const uint16_t len, string& out)
+{
+    out.resize(len);
+    if (len == 0) return (true);
+    return (fread(&out[0], 1, len, f) == len);
+}
+
+
+static const char* type_name(const uint32_t type)
+{
+#define TYPE_NAME(x) if (type & x) return (#x);
+    TYPE_NAME(TRACE_TRX_FLOW);
+    TYPE_NAME(TRACE_RECORD_FLOW);
+    TYPE_NAME(TRACE_TUPLE_FLOW);
+    TYPE_NAME(TRACE_PACKET_FLOW);
+    TYPE_NAME(TRACE_SYNC_COND);
+    TYPE_NAME(TRACE_SYNC_LOCK);
+    TYPE_NAME(TRACE_THREAD_LIFE_CYCLE);
+    TYPE_NAME(TRACE_TEMP_FILE);
+    TYPE_NAME(TRACE_CPU_BINDING);
+    TYPE_NAME(TRACE_QUERY_PROGRESS);
+    TYPE_NAME(TRACE_NETWORK);
+    TYPE_NAME(TRACE_RESPONSE_TIME);
+    TYPE_NAME(TRACE_WORK_SHARING);
+    TYPE_NAME(TRACE_KEY_COMP);
+    TYPE_NAME(TRACE_DEBUG);
+#undef TYPE_NAME
+    return ("TRACE_OTHER");
+}
+
+
+
+/*********************************************************************
+ *
+ *  @fn:    format_rec
+ *
+ *  @brief: Fills the format string of the site with the recorded
+ *          arguments. Each conversion is printed with its own spec.
+ *
+ *********************************************************************/
+
+static string format_rec(const site_t& s, const btrace_rec_t& r)
+{
+    string out;
+    int iarg = 0;
+    const char* p = s._format.c_str();
+    char buf[512];
+
+    while (*p) {
+        if (*p != '%') { out += *p++; continue; }
+        if (p[1] == '%') { out += '%'; p += 2; continue; }
+
+        // copy the conversion spec
+        const char* start = p++;
+        bool bStar = false;
+        while (*p && strchr("-+ #0123456789.*'hlLqjzt", *p)) {
+            if (*p == '*') bStar = true;
+            p++;
+        }
+        if (!*p) break;
+        char conv = *p++;
+        string spec(start, p - start);
+
+        if (bStar) {
+            // the width/precision was recorded as an argument, skip it
+            iarg++;
+            spec = string("%") + conv;
+        }
+
+        if (iarg >= BTRACE_ARGS || s._arg_kind[iarg] == BTA_NONE) {
+            out += "?";
+            iarg++;
+            continue;
+        }
+
+        int64_t v = r._arg[iarg];
+        switch (s._arg_kind[iarg]) {
+        case BTA_INT:
+            snprintf(buf, sizeof(buf), spec.c_str(), (int)v);
+            break;
+        case BTA_LONG:
+            snprintf(buf, sizeof(buf), spec.c_str(), (long)v);
+            break;
+        case BTA_LLONG:
+            snprintf(buf, sizeof(buf), spec.c_str(), (long long)v);
+            break;
+        case BTA_DOUBLE: {
+            double d;
+            memcpy(&d, &v, sizeof(double));
+            snprintf(buf, sizeof(buf), spec.c_str(), d);
+            break; }
+        case BTA_PTR:
+            if (conv == 's')
+                snprintf(buf, sizeof(buf), "<str@%p>", (void*)(intptr_t)v);
+            else
+                snprintf(buf, sizeof(buf), "%p", (void*)(intptr_t)v);
+            break;
+        default:
+            buf[0] = '\0';
+        }
+        out += buf;
+        iarg++;
+    }
+
+    // strip the trailing newlines
+    while (!out.empty() && (out[out.size()-1] == '\n' || out[out.size()-1] == '\r'))
+        out.erase(out.size()-1);
+    return (out);
+}
+
+
+static string json_escape(const string& s)
+{
+    string out;
+    char buf[8];
+    for (size_t i=0; i<s.size(); i++) {
+        unsigned char c = s[i];
+        switch (c) {
+        case '"':  out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (c < 0x20) {
+                snprintf(buf, sizeof(buf), "\\u%04x", c);
+                out += buf;
+            }
+            else out += c;
+        }
+    }
+    return (out);
+}
+
+
+static const char* basename_of(const string& path)
+{
+    size_t pos = path.rfind('/');
+    return (pos == string::npos ? path.c_str() : path.c_str() + pos + 1);
+}
+
+
+
+static void usage(const char* prog)
+{
+    fprintf(stderr, "Usage: %s [-json] <dump> [<output>]\n", prog);
+}
+
+
+int main(int argc, char* argv[])
+{
+    bool bJson = false;
+    int a = 1;
+    if (a < argc && !strcmp(argv[a], "-json")) { bJson = true; a++; }
+    if (a >= argc) { usage(argv[0]); return (1); }
+
+    FILE* in = fopen(argv[a], "r");
+    if (!in) { perror(argv[a]); return (1); }
+    FILE* out = stdout;
+    if (a+1 < argc) {
+        out = fopen(argv[a+1], "w");
+        if (!out) { perror(argv[a+1]); return (1); }
+    }
+
+    // 1. header
+    btrace_file_hdr_t fh;
+    if ((fread(&fh, sizeof(fh), 1, in) != 1) || (fh._magic != BTRACE_MAGIC)) {
+        fprintf(stderr, "%s: not a trace dump\n", argv[a]);
+        return (1);
+    }
+    if (fh._version != BTRACE_VERSION) {
+        fprintf(stderr, "%s: unsupported version (%u)\n", argv[a], fh._version);
+        return (1);
+    }
+    if (fh._tsc_per_usec <= 0) fh._tsc_per_usec = 1000.0;
+
+    // 2. sites
+    vector<site_t> sites(fh._site_count);
+    for (uint32_t i=0; i<fh._site_count; i++) {
+        btrace_site_hdr_t sh;
+        site_t s;
+        if (fread(&sh, sizeof(sh), 1, in) != 1 ||
+            !read_str(in, sh._file_len, s._file) ||
+            !read_str(in, sh._function_len, s._function) ||
+            !read_str(in, sh._format_len, s._format)) {
+            fprintf(stderr, "%s: truncated site table\n", argv[a]);
+            return (1);
+        }
+        s._line = sh._line;
+        memcpy(s._arg_kind, sh._arg_kind, BTRACE_ARGS);
+        if (sh._id >= sites.size()) sites.resize(sh._id+1);
+        sites[sh._id] = s;
+    }
+
+    // 3. threads and their records
+    vector<string> names;
+    vector<thread_rec_t> recs;
+    uint64_t lost = 0;
+    for (uint32_t i=0; i<fh._thread_count; i++) {
+        btrace_thread_hdr_t th;
+        string name;
+        if (fread(&th, sizeof(th), 1, in) != 1 || !read_str(in, th._name_len, name)) {
+            fprintf(stderr, "%s: truncated thread table\n", argv[a]);
+            return (1);
+        }
+        if (th._tid >= names.size()) names.resize(th._tid+1);
+        names[th._tid] = name;
+        lost += th._lost;
+
+        for (uint64_t j=0; j<th._rec_count; j++) {
+            thread_rec_t tr;
+            if (fread(&tr._rec, sizeof(btrace_rec_t), 1, in) != 1) {
+                fprintf(stderr, "%s: truncated records of (%s)\n", argv[a], name.c_str());
+                return (1);
+            }
+            tr._tid = th._tid;
+            recs.push_back(tr);
+        }
+    }
+    fclose(in);
+
+    std::stable_sort(recs.begin(), recs.end(), rec_earlier);
+
+    // 4. output
+    if (bJson) {
+        fprintf(out, "{\"traceEvents\":[\n");
+        bool bFirst = true;
+        for (uint32_t t=0; t<names.size(); t++) {
+            fprintf(out, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                    "\"args\":{\"name\":\"%s\"}}",
+                    (bFirst ? "" : ",\n"), t, json_escape(names[t]).c_str());
+            bFirst = false;
+        }
+        for (size_t i=0; i<recs.size(); i++) {
+            const btrace_rec_t& r = recs[i]._rec;
+            if (r._site >= sites.size()) continue;
+            const site_t& s = sites[r._site];
+            double us = (double)(int64_t)(r._tsc - fh._tsc_start) / fh._tsc_per_usec;
+            fprintf(out, "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"i\",\"s\":\"t\","
+                    "\"ts\":%.3f,\"pid\":1,\"tid\":%u,"
+                    "\"args\":{\"msg\":\"%s\",\"site\":\"%s:%u\"}}",
+                    (bFirst ? "" : ",\n"),
+                    json_escape(s._function).c_str(), type_name(r._type), us, recs[i]._tid,
+                    json_escape(format_rec(s, r)).c_str(),
+                    json_escape(basename_of(s._file)).c_str(), s._line);
+            bFirst = false;
+        }
+        fprintf(out, "\n],\"displayTimeUnit\":\"ns\"}\n");
+    }
+    else {
+        for (size_t i=0; i<recs.size(); i++) {
+            const btrace_rec_t& r = recs[i]._rec;
+            if (r._site >= sites.size()) continue;
+            const site_t& s = sites[r._site];
+            double us = (double)(int64_t)(r._tsc - fh._tsc_start) / fh._tsc_per_usec;
+            fprintf(out, "%14.3f %s: %s:%u:%s: %s\n", us,
+                    names[recs[i]._tid].c_str(), basename_of(s._file), s._line,
+                    s._function.c_str(), format_rec(s, r).c_str());
+        }
+    }
+
+    fprintf(stderr, "%lu records, %u threads, %u sites, %llu lost\n",
+            (unsigned long)recs.size(), fh._thread_count, fh._site_count,
+            (unsigned long long)lost);
+    if (out != stdout) fclose(out);
+    return (0);
+}
@@ -34,6 +34,9 @@
 #include "workload/tpcc/shore_tpcc_env.h"
 #include "workload/tpcc/shore_tpcc_client.h"
 
+#include "workload/ch/shore_ch_env.h"
+#include "workload/ch/shore_ch_client.h"
+
 #include "workload/tm1/shore_tm1_env.h"
 #include "workload/tm1/shore_tm1_client.h"
 
@@ -72,6 +75,7 @@
 using namespace shore;
 
 using namespace tpcc;
+using namespace ch;
 using namespace tm1;
 using namespace tpcb;
 using namespace tpch;
@@ -134,7 +138,7 @@ void initsysnamemap()
 
 
 // Value-definitions of the different Benchmarks
-enum BenchmarkValue { bmTPCC, bmTM1, bmTPCB, bmTPCH , bmSSB, bmTPCE };
+enum BenchmarkValue { bmTPCC, bmCH, bmTM1, bmTPCB, bmTPCH , bmSSB, bmTPCE };
 
 // Map to associate string with then enum values
 
@@ -143,6 +147,7 @@ static map<string,BenchmarkValue> mBenchmarkValue;
 void initbenchmarkmap() 
 {
     mBenchmarkValue["tpcc"]  = bmTPCC;
+    mBenchmarkValue["ch"]    = bmCH;
     mBenchmarkValue["tm1"]   = bmTM1;
     mBenchmarkValue["tpcb"]  = bmTPCB;
     mBenchmarkValue["tpch"]  = bmTPCH;
@@ -188,6 +193,8 @@ public:
                                   const int iNumOfThreads, const int iDuration,
                                   const int iSelectedTrx, const int iIterations,
                                   const eBindingType abt);
+    virtual int _cmd_SERVE_impl(const double iQueriedSF, const int iDuration,
+                                const int iPort);
 
     virtual w_rc_t prepareNewRun() { assert(_dbinst); return(_dbinst->newrun()); }
 
@@ -222,6 +229,7 @@ int kit_t<Client,DB>::load_bp_map(void)
     _sup_bps[BT_NONE]          = "NoBinding";
     _sup_bps[BT_NEXT]          = "Adjacent";
     _sup_bps[BT_SPREAD]        = "SpreadToCores";
+    _sup_bps[BT_TOPOLOGY]      = "Topology";
     return (_sup_bps.size());
 }
 
@@ -332,6 +340,7 @@ int kit_t<Client,DB>::_cmd_TEST_impl(const double iQueriedSF,
         // reset starting cpu and wh id
         _current_prs_id = _start_prs_id;
         int wh_id = 0;
+        _env->reset_client_placement();
 
         _env->reset_stats();
 
@@ -351,6 +360,9 @@ int kit_t<Client,DB>::_cmd_TEST_impl(const double iQueriedSF,
             if (iSpread) {
                 wh_id = (i%(int)iQueriedSF)+1;
             }
+            if (abt == BT_TOPOLOGY) {
+                _current_prs_id = topology_cpu(i, wh_id, iQueriedSF, iNumOfThreads);
+            }
 
             testers[i] = new Client(c_str("CL-%d",i), i, _dbinst, 
                                     MT_NUM_OF_TRXS, iSelectedTrx, iNumOfTrxs,
@@ -437,10 +449,12 @@ int kit_t<Client,DB>::_cmd_MEASURE_impl(const double iQueriedSF,
     Client* testers[MAX_NUM_OF_THR];
     _current_prs_id = _start_prs_id;     // reset starting cpu and wh id
     int wh_id = 0;
+    _env->reset_client_placement();
     
     // 1. prepare for measurement
     _env->set_measure(MST_WARMUP);
     shell_expect_clients(iNumOfThreads);
+    metrics_sampler_t* psampler = metrics_sampler_t::start(_env);
 
     // 2. create and fork client threads
     for (int i=0; i<iNumOfThreads; i++) {
@@ -448,6 +462,9 @@ int kit_t<Client,DB>::_cmd_MEASURE_impl(const double iQueriedSF,
         if (iSpread) {
             wh_id = (i%(int)iQueriedSF)+1;
         }
+        if (abt == BT_TOPOLOGY) {
+            _current_prs_id = topology_cpu(i, wh_id, iQueriedSF, iNumOfThreads);
+        }
 
         testers[i] = new Client(c_str("CL-%d",i), i, _dbinst, 
                                 MT_TIME_DUR, iSelectedTrx, 0,
@@ -459,6 +476,14 @@ int kit_t<Client,DB>::_cmd_MEASURE_impl(const double iQueriedSF,
     
     // give them some time (2secs) to start-up
     shell_await_clients();    
+
+    // the scripted skew scenario, if any
+    skew_scheduler_t* pskew = NULL;
+    if (!_env->get_skew_plan()->empty()) {
+        pskew = new skew_scheduler_t(c_str("skew"), _env, 
+                                     *_env->get_skew_plan());
+        pskew->fork();
+    }
     
     // 2. run iterations
     int remaining = 0;
@@ -527,6 +552,12 @@ int kit_t<Client,DB>::_cmd_MEASURE_impl(const double iQueriedSF,
         delete (testers[i]);
     }
 
+    if (pskew) {
+        pskew->join();
+        delete (pskew);
+    }
+    metrics_sampler_t::finish(psampler);
+
     // set measurement state
     _env->set_measure(MST_DONE);
 
@@ -547,11 +578,91 @@ int kit_t<Client,DB>::_cmd_MEASURE_impl(const double iQueriedSF,
 }
 
 
+// cmd: SERVE
+
+template<class Client,class DB>
+int kit_t<Client,DB>::_cmd_SERVE_impl(const double iQueriedSF, 
+                                      const int iDuration,
+                                      const int iPort)
+{
+    TRACE( TRACE_ALWAYS, "serving: queried (%.1f) duration (%d) port (%d)\n",
+           iQueriedSF, iDuration, iPort);
+
+    _dbinst->upd_sf();
+    _dbinst->set_qf(iQueriedSF);
+
+    envVar* ev = envVar::instance();
+    int maxInflight = ev->getVarInt("srv-max-inflight",DF_SRV_MAX_INFLIGHT);
+    if (maxInflight < 1) maxInflight = DF_SRV_MAX_INFLIGHT;
+
+    // 1. One stub per selected id, 0 picks a random one in the queried SF.
+    //    Their threads are never forked, the server submits through them.
+    std::vector<base_client_t*> stubs;
+    for (int i=0; i<=(int)iQueriedSF; i++) {
+        Client* astub = new Client(c_str("SRV-%d",i), i, _dbinst, 
+                                   MT_TIME_DUR, 0, 0,
+                                   PBIND_NONE, i, iQueriedSF);
+        assert (astub);
+        astub->set_max_inflight(maxInflight);
+        stubs.push_back(astub);
+    }
+
+    _env->reset_stats();
+#ifdef HAVE_CPUMON
+    _g_mon->cntr_reset();
+#endif
+
+    // 2. Serve for the duration
+    TRACE(TRACE_ALWAYS, "begin measurement\n");
+    _env->set_measure(MST_MEASURE);
+    metrics_sampler_t* psampler = metrics_sampler_t::start(_env);
+    stopwatch_t timer;
+
+    trx_server_t* server = new trx_server_t(c_str("server"), _env, 
+                                            iPort, iDuration, maxInflight,
+                                            stubs, _sup_trxs);
+    server->fork();
+    server->join();
+    metrics_sampler_t::finish(psampler);
+
+    double delay = timer.time();
+#ifdef HAVE_CPUMON
+    _g_mon->cntr_pause();
+    ulong_t miochs = _g_mon->iochars()/MILLION;
+    double usage = _g_mon->get_avg_usage(true);
+#else
+    ulong_t miochs = 0;
+    double usage = 0;
+#endif
+    TRACE(TRACE_ALWAYS, "end measurement\n");
+    if (!server->rv()) {
+        server->print_stats();
+        _env->print_throughput(iQueriedSF,0,server->accepted(),delay,
+                               miochs, usage);
+    }
+    delete (server);
+
+    for (uint i=0; i<stubs.size(); i++) {
+        delete (stubs[i]);
+    }
+
+    // 3. Prepare for the next round
+    _env->set_measure(MST_DONE);
+    w_rc_t e = prepareNewRun();
+    if (e.is_error()) {
+        TRACE( TRACE_ALWAYS, "!!! Problem preparing for the next run\n");
+    }
+    return (SHELL_NEXT_CONTINUE);
+}
+
+
+
 ///////////////////////////////
 // Declare the possible kits //
 
 // Baseline
 typedef kit_t<baseline_tpcc_client_t,ShoreTPCCEnv> baselineTPCCKit;
+typedef kit_t<baseline_ch_client_t,ShoreCHEnv> baselineCHKit;
 typedef kit_t<baseline_tm1_client_t,ShoreTM1Env> baselineTM1Kit;
 typedef kit_t<baseline_tpcb_client_t,ShoreTPCBEnv> baselineTPCBKit;
 typedef kit_t<baseline_tpch_client_t,ShoreTPCHEnv> baselineTPCHKit;
@@ -758,6 +869,20 @@ int main(int argc, char* argv[])
         }
     }
 
+    // CH-benCHmark
+    if (benchmarkname.compare("ch")==0) {
+        dbname = "(ch-" + physical + "-";
+        switch (mSysnameValue[sysname]) {
+        case snBaseline:
+            dbname += "base) ";
+            kit = new baselineCHKit(dbname.c_str(),netmode,netport,inputfilemode,inputfile);
+            break;
+        default:
+            TRACE( TRACE_ALWAYS, "Not supported configuration. Exiting...\n");
+            return (3);
+        }
+    }
+
     // TM1
     if (benchmarkname.compare("tm1")==0) {
         dbname = "(tatp-" + physical + "-";
@@ -0,0 +1,216 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   test_predicates.cpp
+ *
+ *  @brief:  Checks the page-at-a-time selection of the QPipe predicates
+ *           (predicate_filter_t::select_page and select_batch) against
+ *           their tuple-at-a-time select()
+ *
+ *  @note:   The records look like the ones of the table scans, in the
+ *           disk format: the tuples have an odd size and the fields are
+ *           not aligned. Every predicate runs on pages of random fill
+ *           (so that the SIMD loops have a scalar tail), on the whole
+ *           page and on an already thinned selection vector.
+ *           Run by "make check", exits non-zero on a mismatch.
+ */
+
+#include "qpipe/common/predicates.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace qpipe;
+using std::vector;
+
+
+// the fields of a record
+const size_t F_INT1  = 1;    // int, in [0,50)
+const size_t F_INT2  = 5;    // int, in [0,11)
+const size_t F_DBL   = 9;    // double, integral or not, in [0,11)
+const size_t F_DATE  = 17;   // FIXCHAR(15), 'YYYY-MM-DD' and garbage
+const size_t F_TYPE  = 32;   // FIXCHAR(25), NUL-terminated
+const size_t REC_SZ  = 57;
+
+const int PAGES = 200;
+
+static const char* TYPES[] = {
+    "PROMO BURNISHED COPPER", "STANDARD POLISHED BRASS", "PROMO",
+    "ECONOMY PROMO TIN", "SMALL PLATED STEEL", "PROMOTION", "%PROMO",
+    "LARGE BRUSHED BRASS", ""
+};
+
+static unsigned int _seed = 4711;
+static int rnd(int n) { return (rand_r(&_seed) % n); }
+
+
+static void fill_record(char* rec)
+{
+    for (size_t i=0; i<REC_SZ; i++) rec[i] = (char)rnd(256);
+
+    int i1 = rnd(50);
+    int i2 = rnd(11);
+    double d = rnd(2) ? (double)rnd(11) : rnd(1100)/100.0;
+    memcpy(rec + F_INT1, &i1, sizeof(int));
+    memcpy(rec + F_INT2, &i2, sizeof(int));
+    memcpy(rec + F_DBL, &d, sizeof(double));
+
+    char date[16];
+    sprintf(date, "%04d-%02d-%02d", 1992 + rnd(7), 1 + rnd(12), 1 + rnd(28));
+    memcpy(rec + F_DATE, date, 10);
+
+    const char* type = TYPES[rnd(sizeof(TYPES)/sizeof(TYPES[0]))];
+    memset(rec + F_TYPE, 0, 25);
+    memcpy(rec + F_TYPE, type, strlen(type));
+}
+
+
+// the indexes that select() picks, among the ones in (sel)
+static vector<unsigned int> expected(predicate_t* p, page* pg,
+                                     const vector<unsigned int>& sel)
+{
+    vector<unsigned int> exp;
+    for (size_t i=0; i<sel.size(); i++) {
+        if (p->select(pg->get_tuple(sel[i])))
+            exp.push_back(sel[i]);
+    }
+    return (exp);
+}
+
+static bool same(const unsigned int* got, size_t n,
+                 const vector<unsigned int>& exp)
+{
+    if (n != exp.size()) return (false);
+    for (size_t i=0; i<n; i++) {
+        if (got[i] != exp[i]) return (false);
+    }
+    return (true);
+}
+
+
+// runs one predicate on all the pages, returns the number of mismatches
+static int check(const char* name, predicate_t* p)
+{
+    int errors = 0;
+    size_t selected = 0;
+    size_t total = 0;
+
+    predicate_filter_t filter(REC_SZ, p, name);
+    selection_t sel;
+    guard<page> pg = page::alloc(REC_SZ);
+
+    for (int round=0; round<PAGES; round++) {
+        pg->clear();
+        size_t count = rnd(pg->capacity() + 1);
+        for (size_t i=0; i<count; i++)
+            fill_record(pg->allocate_tuple().data);
+        total += count;
+
+        // the whole page, through the filter
+        vector<unsigned int> all;
+        for (size_t i=0; i<count; i++) all.push_back(i);
+        vector<unsigned int> exp = expected(p, pg, all);
+        size_t n = filter.select_page(pg, sel);
+        selected += n;
+        if (!same(sel.data(), n, exp)) {
+            printf("%s: page %d, (%d) tuples, select_page() picked (%d), select() (%d)\n",
+                   name, round, (int)count, (int)n, (int)exp.size());
+            errors++;
+        }
+
+        // every other tuple, then every third of those: a vector that
+        // was already refined by other terms
+        vector<unsigned int> some;
+        for (size_t i=0; i<count; i++) {
+            if ((i % 2) && (i % 3)) some.push_back(i);
+        }
+        exp = expected(p, pg, some);
+        vector<unsigned int> vsel(some);
+        n = p->select_batch(pg->base(), pg->tuple_size(),
+                            (vsel.empty() ? NULL : &vsel[0]), vsel.size());
+        if (!same((vsel.empty() ? NULL : &vsel[0]), n, exp)) {
+            printf("%s: page %d, (%d) of (%d) tuples, select_batch() picked (%d), select() (%d)\n",
+                   name, round, (int)some.size(), (int)count,
+                   (int)n, (int)exp.size());
+            errors++;
+        }
+    }
+
+    printf("%-40s %s (%d of %d tuples selected)\n",
+           name, (errors ? "FAILED" : "ok"), (int)selected, (int)total);
+    return (errors);
+}
+
+
+// the conjunction of the TPC-H Q6 scan, on these fields
+static predicate_t* q6_like()
+{
+    and_predicate_t* p = new and_predicate_t();
+    p->add(new range_predicate_t<double>(5 - 1e-6, 7 + 1e-6, F_DBL));
+    p->add(new scalar_predicate_t<int, less>(24, F_INT1));
+    p->add(new fixchar_range_predicate_t("1994-01-01", "1995-01-01", F_DATE));
+    return (p);
+}
+
+static predicate_t* or_of_ranges()
+{
+    or_predicate_t* p = new or_predicate_t();
+    p->add(new range_predicate_t<int>(1, 3, F_INT2));
+    p->add(new fixchar_range_predicate_t("1998-06-01", "1999-01-01", F_DATE));
+    return (p);
+}
+
+
+int main(int, char**)
+{
+    int errors = 0;
+
+    errors += check("int ==", new scalar_predicate_t<int, equal_to>(7, F_INT1));
+    errors += check("int !=", new scalar_predicate_t<int, not_equal_to>(7, F_INT1));
+    errors += check("int <", new scalar_predicate_t<int, less>(25, F_INT1));
+    errors += check("int <=", new scalar_predicate_t<int, less_equal>(25, F_INT1));
+    errors += check("int >", new scalar_predicate_t<int, greater>(25, F_INT1));
+    errors += check("int >=", new scalar_predicate_t<int, greater_equal>(25, F_INT1));
+    errors += check("int between", new range_predicate_t<int>(4, 6, F_INT2));
+    errors += check("int field <", new field_predicate_t<int, less>(F_INT2, F_INT1));
+    errors += check("double <", new scalar_predicate_t<double, less>(5.5, F_DBL));
+    errors += check("double between", new range_predicate_t<double>(2.5, 7, F_DBL));
+    errors += check("date range", new fixchar_range_predicate_t("1994-01-01", "1995-01-01", F_DATE));
+    errors += check("date month", new fixchar_range_predicate_t("1995-09-01", "1995-10-01", F_DATE));
+    errors += check("like PROMO%", new like_predicate_t("PROMO%", F_TYPE));
+    errors += check("like %BRASS", new like_predicate_t("%BRASS", F_TYPE));
+    errors += check("like %O%O%", new like_predicate_t("%O%O%", F_TYPE));
+    errors += check("like PROMO", new like_predicate_t("PROMO", F_TYPE));
+    errors += check("not like %PROMO%", new not_like_predicate_t("%PROMO%", F_TYPE));
+    errors += check("and (Q6)", q6_like());
+    errors += check("or", or_of_ranges());
+    errors += check("and ()", new and_predicate_t());
+
+    if (errors) {
+        printf("(%d) mismatches\n", errors);
+        return (1);
+    }
+    return (0);
+}
@@ -0,0 +1,337 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   trx_load_driver.cpp
+ *
+ *  @brief:  Load driver of the trx server ("serve" at the shell)
+ *
+ *  @note:   Usage: trx_load_driver [-h <host>] [-p <port>] [-c <conns>]
+ *                  [-d <depth>] [-s <secs>] [-x <trx_id>] [-w <sel_ids>]
+ *
+ *           Opens <conns> connections, one thread each, and keeps <depth>
+ *           requests of type <trx_id> in flight on each of them for <secs>
+ *           seconds. The selected id of each request is picked uniformly
+ *           in [1,<sel_ids>], or left to the server (0) if <sel_ids> is 0.
+ *           Prints the throughput and the latency percentiles seen by
+ *           the clients, so protocol and network overhead are included.
+ *
+ *           It does not depend on Shore, only on the protocol header.
+ */
+
+#include "sm/shore/shore_trx_proto.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+
+#include <pthread.h>
+#include <unistd.h>
+#include <errno.h>
+#include <netdb.h>
+#include <sys/time.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+using std::vector;
+
+
+struct driver_conf_t
+{
+    const char* _host;
+    int         _port;
+    int         _conns;
+    int         _depth;
+    int         _secs;
+    int         _xct_type;
+    int         _sel_ids;
+};
+
+struct driver_stats_t
+{
+    long         _committed;
+    long         _aborted;
+    long         _rejected;
+    vector<uint> _lat_us;
+    int          _rv;
+
+    driver_stats_t() : _committed(0), _aborted(0), _rejected(0), _rv(0) { }
+};
+
+struct driver_thread_t
+{
+    int                   _id;
+    const driver_conf_t*  _conf;
+    driver_stats_t        _stats;
+    pthread_t             _tid;
+};
+
+
+static long long now_us()
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (tv.tv_sec*1000000LL + tv.tv_usec);
+}
+
+static int connect_to(const char* host, const int port)
+{
+    struct addrinfo hints, *res;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    char sport[16];
+    snprintf(sport, sizeof(sport), "%d", port);
+    if (getaddrinfo(host, sport, &hints, &res) != 0) return (-1);
+
+    int fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+    if ((fd >= 0) && (connect(fd, res->ai_addr, res->ai_addrlen) < 0)) {
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(res);
+    if (fd >= 0) {
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    return (fd);
+}
+
+static int write_all(const int fd, const char* buf, size_t sz)
+{
+    while (sz) {
+        ssize_t n = write(fd, buf, sz);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return (-1);
+        }
+        buf += n;
+        sz -= n;
+    }
+    return (0);
+}
+
+
+/******************************************************************** 
+ *
+ *  @fn:    run_conn
+ *
+ *  @brief: One connection. The tag of a request is the index of its
+ *          pipeline slot, whose send time gives the latency.
+ *
+ ********************************************************************/
+
+static void* run_conn(void* arg)
+{
+    driver_thread_t* pthr = (driver_thread_t*)arg;
+    const driver_conf_t& conf = *pthr->_conf;
+    driver_stats_t& stats = pthr->_stats;
+    unsigned int seed = 7919 * (pthr->_id + 1);
+
+    int fd = connect_to(conf._host, conf._port);
+    if (fd < 0) {
+        fprintf(stderr, "conn %d: cannot connect to %s:%d (%s)\n",
+                pthr->_id, conf._host, conf._port, strerror(errno));
+        stats._rv = 1;
+        return (NULL);
+    }
+
+    trx_proto_hello_t hello;
+    hello._magic = TRX_PROTO_MAGIC;
+    hello._version = TRX_PROTO_VERSION;
+
+    vector<long long> sent(conf._depth);
+    vector<trx_proto_req_t> out;
+    out.reserve(conf._depth);
+
+    // fill the pipeline
+    long long start = now_us();
+    long long end = start + conf._secs*1000000LL;
+    for (int i=0; i<conf._depth; i++) {
+        trx_proto_req_t req;
+        req._tag = i;
+        req._xct_type = conf._xct_type;
+        req._sel_id = (conf._sel_ids ? 1 + rand_r(&seed)%conf._sel_ids : 0);
+        out.push_back(req);
+        sent[i] = start;
+    }
+    if ((write_all(fd, (const char*)&hello, sizeof(hello)) < 0) ||
+        (write_all(fd, (const char*)&out[0], out.size()*sizeof(trx_proto_req_t)) < 0)) {
+        fprintf(stderr, "conn %d: write failed (%s)\n", pthr->_id, strerror(errno));
+        close(fd);
+        stats._rv = 1;
+        return (NULL);
+    }
+
+    int outstanding = conf._depth;
+    bool bStopping = false;
+    vector<char> rbuf(64*1024);
+    size_t rlen = 0;
+
+    while (outstanding > 0) {
+        ssize_t n = read(fd, &rbuf[rlen], rbuf.size() - rlen);
+        if (n <= 0) {
+            if ((n < 0) && (errno == EINTR)) continue;
+            fprintf(stderr, "conn %d: server closed (%d outstanding)\n",
+                    pthr->_id, outstanding);
+            stats._rv = 1;
+            break;
+        }
+        rlen += n;
+
+        long long t = now_us();
+        if (t >= end) bStopping = true;
+
+        // consume the complete responses, and refill their slots
+        out.clear();
+        size_t off = 0;
+        trx_proto_resp_t resp;
+        while (rlen - off >= sizeof(resp)) {
+            memcpy(&resp, &rbuf[off], sizeof(resp));
+            off += sizeof(resp);
+            --outstanding;
+
+            if (resp._state == TRX_PROTO_COMMITTED) ++stats._committed;
+            else if (resp._state == TRX_PROTO_REJECTED) ++stats._rejected;
+            else ++stats._aborted;
+
+            if (resp._tag < (uint32_t)conf._depth) {
+                stats._lat_us.push_back((uint)(t - sent[resp._tag]));
+                if (!bStopping) {
+                    trx_proto_req_t req;
+                    req._tag = resp._tag;
+                    req._xct_type = conf._xct_type;
+                    req._sel_id = (conf._sel_ids ? 1 + rand_r(&seed)%conf._sel_ids : 0);
+                    out.push_back(req);
+                    sent[resp._tag] = t;
+                    ++outstanding;
+                }
+            }
+        }
+        memmove(&rbuf[0], &rbuf[off], rlen - off);
+        rlen -= off;
+
+        if (!out.empty() &&
+            (write_all(fd, (const char*)&out[0], out.size()*sizeof(trx_proto_req_t)) < 0)) {
+            fprintf(stderr, "conn %d: write failed (%s)\n", pthr->_id, strerror(errno));
+            stats._rv = 1;
+            break;
+        }
+    }
+
+    close(fd);
+    return (NULL);
+}
+
+
+static void usage(const char* prog)
+{
+    fprintf(stderr, "Usage: %s [-h <host>] [-p <port>] [-c <conns>] [-d <depth>] "
+            "[-s <secs>] [-x <trx_id>] [-w <sel_ids>]\n"
+            "  -h  server host (default localhost)\n"
+            "  -p  server port (default 4040)\n"
+            "  -c  connections, one thread each (default 8)\n"
+            "  -d  requests in flight per connection (default 16)\n"
+            "  -s  duration in secs (default 20)\n"
+            "  -x  trx id, as listed by \"trxs\" at the shell (default 0=mix)\n"
+            "  -w  selected ids are picked in [1,<sel_ids>], 0 leaves it\n"
+            "      to the server (default 0)\n", prog);
+}
+
+
+int main(int argc, char* argv[])
+{
+    driver_conf_t conf;
+    conf._host = "localhost";
+    conf._port = 4040;
+    conf._conns = 8;
+    conf._depth = 16;
+    conf._secs = 20;
+    conf._xct_type = 0;
+    conf._sel_ids = 0;
+
+    int c;
+    while ((c = getopt(argc, argv, "h:p:c:d:s:x:w:")) != -1) {
+        switch (c) {
+        case 'h': conf._host = optarg; break;
+        case 'p': conf._port = atoi(optarg); break;
+        case 'c': conf._conns = atoi(optarg); break;
+        case 'd': conf._depth = atoi(optarg); break;
+        case 's': conf._secs = atoi(optarg); break;
+        case 'x': conf._xct_type = atoi(optarg); break;
+        case 'w': conf._sel_ids = atoi(optarg); break;
+        default:
+            usage(argv[0]);
+            return (1);
+        }
+    }
+    if ((conf._conns < 1) || (conf._depth < 1) || (conf._secs < 1) || 
+        (conf._sel_ids < 0)) {
+        usage(argv[0]);
+        return (1);
+    }
+
+    vector<driver_thread_t> thrs(conf._conns);
+    long long start = now_us();
+    for (int i=0; i<conf._conns; i++) {
+        thrs[i]._id = i;
+        thrs[i]._conf = &conf;
+        pthread_create(&thrs[i]._tid, NULL, run_conn, &thrs[i]);
+    }
+
+    long committed = 0, aborted = 0, rejected = 0;
+    int failed = 0;
+    vector<uint> lat;
+    for (int i=0; i<conf._conns; i++) {
+        pthread_join(thrs[i]._tid, NULL);
+        committed += thrs[i]._stats._committed;
+        aborted   += thrs[i]._stats._aborted;
+        rejected  += thrs[i]._stats._rejected;
+        failed    += thrs[i]._stats._rv;
+        lat.insert(lat.end(), thrs[i]._stats._lat_us.begin(), 
+                   thrs[i]._stats._lat_us.end());
+    }
+    double secs = (now_us() - start) / 1e6;
+
+    std::sort(lat.begin(), lat.end());
+    double avg = 0;
+    for (uint i=0; i<lat.size(); i++) avg += lat[i];
+    if (!lat.empty()) avg /= lat.size();
+
+    printf("Conns:      (%d) (%d failed)\n", conf._conns, failed);
+    printf("Depth:      (%d)\n", conf._depth);
+    printf("Secs:       (%.2f)\n", secs);
+    printf("Committed:  (%ld)\n", committed);
+    printf("Aborted:    (%ld)\n", aborted);
+    printf("Rejected:   (%ld)\n", rejected);
+    printf("TPS:        (%.2f)\n", committed / secs);
+    if (!lat.empty()) {
+        printf("Lat avg:    (%.1fus)\n", avg);
+        printf("Lat p50:    (%uus)\n", lat[lat.size()/2]);
+        printf("Lat p99:    (%uus)\n", lat[(lat.size()*99)/100]);
+        printf("Lat max:    (%uus)\n", lat.back());
+    }
+    return (failed ? 2 : 0);
+}
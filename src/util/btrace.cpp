@@ -0,0 +1,508 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   btrace.cpp
+ *
+ *  @brief:  Per-thread binary trace rings
+ *
+ *  @note:   A call site (file,line) gets an id the first time it logs.
+ *           The kinds of its arguments are found once from the format
+ *           string, so logging a record is a hash probe, a few va_arg
+ *           and a store to the thread's ring.
+ */
+
+#include "util/btrace.h"
+#include "util/trace.h"
+#include "util/sync.h"
+#include "util/thread.h"
+
+#include "k_defines.h"
+
+#include <vector>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+
+using std::vector;
+
+
+volatile bool _g_btrace_enabled = false;
+
+
+
+/*********************************************************************
+ *
+ *  Internal structures
+ *
+ *********************************************************************/
+
+// Max number of distinct TRACE() call sites (power of two)
+static const uint32_t BTRACE_MAX_SITES = 1 << 13;
+
+struct btrace_site_t
+{
+    uint32_t    _id;
+    int         _line;
+    const char* _file;
+    const char* _function;
+    const char* _format;
+    uint8_t     _arg_kind[BTRACE_ARGS];
+};
+
+struct btrace_ring_t
+{
+    btrace_rec_t*     _recs;
+    uint64_t          _mask;
+    volatile uint64_t _head;     // next record to write, never wraps
+    uint32_t          _tid;
+    char              _name[64];
+};
+
+
+// site hash table (lock-free reads) and list by id
+static btrace_site_t* volatile _sites[BTRACE_MAX_SITES];
+static vector<btrace_site_t*>   _site_list;
+static pthread_mutex_t          _site_mutex = thread_mutex_create();
+
+// all the rings ever created
+static vector<btrace_ring_t*>   _rings;
+static pthread_mutex_t          _ring_mutex = thread_mutex_create();
+static __thread btrace_ring_t*  _my_ring = NULL;
+
+static uint32_t          _ring_recs    = BTRACE_DEFAULT_RING_RECS;
+static double            _tsc_per_usec = 1000.0;
+static volatile uint64_t _tsc_start    = 0;   // records before are ignored
+
+
+
+/*********************************************************************
+ *
+ *  @fn:    btrace_tsc
+ *
+ *  @brief: Reads the time stamp counter. On other architectures it
+ *          returns nanoseconds of the monotonic clock.
+ *
+ *********************************************************************/
+
+static inline uint64_t btrace_tsc()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    uint32_t lo, hi;
+    asm volatile ("rdtsc" : "=a" (lo), "=d" (hi));
+    return (((uint64_t)hi << 32) | lo);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec*1000000000ULL + ts.tv_nsec);
+#endif
+}
+
+// Orders the stores of the record before the store of the head. On x86
+// stores are not reordered with other stores, the compiler is enough.
+static inline void btrace_store_fence()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    asm volatile ("" ::: "memory");
+#else
+    __sync_synchronize();
+#endif
+}
+
+static uint64_t btrace_usecs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec*1000000ULL + ts.tv_nsec/1000);
+}
+
+
+// Measures the tsc rate over a short sleep
+static void btrace_calibrate()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    uint64_t us0  = btrace_usecs();
+    uint64_t tsc0 = btrace_tsc();
+    struct timespec req = { 0, 20*1000*1000 };
+    while (nanosleep(&req, &req) == -1 && errno == EINTR) ;
+    uint64_t tsc1 = btrace_tsc();
+    uint64_t us1  = btrace_usecs();
+    if (us1 > us0) {
+        _tsc_per_usec = (double)(tsc1 - tsc0) / (double)(us1 - us0);
+    }
+#else
+    _tsc_per_usec = 1000.0;
+#endif
+}
+
+
+
+/*********************************************************************
+ *
+ *  @fn:    parse_arg_kinds
+ *
+ *  @brief: Finds how the first BTRACE_ARGS arguments of a printf-style
+ *          format are passed. A '*' width or precision consumes an int.
+ *
+ *********************************************************************/
+
+static void parse_arg_kinds(const char* format, uint8_t* kinds)
+{
+    memset(kinds, BTA_NONE, BTRACE_ARGS);
+    int nargs = 0;
+
+    for (const char* p = format; *p && nargs < BTRACE_ARGS; p++) {
+        if (*p != '%') continue;
+        p++;
+        if (*p == '%') continue;
+
+        // flags, width, precision
+        while (*p && strchr("-+ #0123456789.*'", *p)) {
+            if (*p == '*' && nargs < BTRACE_ARGS) kinds[nargs++] = BTA_INT;
+            p++;
+        }
+        if (nargs >= BTRACE_ARGS) break;
+
+        // length modifiers
+        int longs = 0;
+        bool bLongDouble = false;
+        while (*p && strchr("hlLqjzt", *p)) {
+            if (*p == 'l') longs++;
+            else if (*p == 'q' || *p == 'j') longs = 2;
+            else if (*p == 'z' || *p == 't') longs = 1;
+            else if (*p == 'L') bLongDouble = true;
+            p++;
+        }
+
+        switch (*p) {
+        case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'c':
+            kinds[nargs++] = (longs == 0 ? BTA_INT :
+                              (longs == 1 ? BTA_LONG : BTA_LLONG));
+            break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G':
+        case 'a': case 'A':
+            // a long double cannot be stored, stop here
+            if (bLongDouble) return;
+            kinds[nargs++] = BTA_DOUBLE;
+            break;
+        case 's': case 'p': case 'n':
+            kinds[nargs++] = BTA_PTR;
+            break;
+        default:
+            // unknown conversion, we cannot tell how the rest is passed
+            return;
+        }
+        if (!*p) return;
+    }
+}
+
+
+
+/*********************************************************************
+ *
+ *  @fn:    get_site
+ *
+ *  @brief: Returns the site of (format,line), registering it if needed
+ *
+ *********************************************************************/
+
+static inline uint32_t site_hash(const char* format, int line)
+{
+    uint64_t h = ((uint64_t)(uintptr_t)format >> 3) * 0x9e3779b97f4a7c15ULL;
+    h ^= (uint64_t)line * 0xff51afd7ed558ccdULL;
+    return ((uint32_t)(h >> 40) & (BTRACE_MAX_SITES-1));
+}
+
+static btrace_site_t* get_site(const char* file, int line,
+                               const char* function, const char* format)
+{
+    uint32_t h = site_hash(format, line);
+
+    // fast path, no locks
+    for (uint32_t i=0; i<BTRACE_MAX_SITES; i++) {
+        btrace_site_t* s = _sites[(h+i) & (BTRACE_MAX_SITES-1)];
+        if (s == NULL) break;
+        if ((s->_format == format) && (s->_line == line)) return (s);
+    }
+
+    // first time, register it
+    critical_section_t cs(_site_mutex);
+    for (uint32_t i=0; i<BTRACE_MAX_SITES; i++) {
+        uint32_t slot = (h+i) & (BTRACE_MAX_SITES-1);
+        btrace_site_t* s = _sites[slot];
+        if (s == NULL) {
+            if (_site_list.size() >= BTRACE_MAX_SITES/2) return (NULL); // full
+            s = new btrace_site_t();
+            s->_id       = _site_list.size();
+            s->_line     = line;
+            s->_file     = file;
+            s->_function = function;
+            s->_format   = format;
+            parse_arg_kinds(format, s->_arg_kind);
+            _site_list.push_back(s);
+            __sync_synchronize(); // publish the site filled
+            _sites[slot] = s;
+            return (s);
+        }
+        if ((s->_format == format) && (s->_line == line)) return (s);
+    }
+    return (NULL);
+}
+
+
+
+/*********************************************************************
+ *
+ *  @fn:    get_ring
+ *
+ *  @brief: Returns the ring of the calling thread, creating it the
+ *          first time
+ *
+ *********************************************************************/
+
+static btrace_ring_t* get_ring()
+{
+    if (_my_ring) return (_my_ring);
+
+    btrace_ring_t* r = new btrace_ring_t();
+    r->_recs = new btrace_rec_t[_ring_recs];
+    memset(r->_recs, 0, sizeof(btrace_rec_t)*_ring_recs);
+    r->_mask = _ring_recs - 1;
+    r->_head = 0;
+
+    thread_t* self = thread_get_self();
+    if (self) {
+        strncpy(r->_name, self->thread_name().data(), sizeof(r->_name)-1);
+    }
+    else {
+        snprintf(r->_name, sizeof(r->_name), "%lu", (unsigned long)pthread_self());
+    }
+    r->_name[sizeof(r->_name)-1] = '\0';
+
+    {
+        critical_section_t cs(_ring_mutex);
+        r->_tid = _rings.size();
+        _rings.push_back(r);
+    }
+    _my_ring = r;
+    return (r);
+}
+
+
+
+/*********************************************************************
+ *
+ *  Exported functions
+ *
+ *********************************************************************/
+
+void btrace_enable(const uint32_t ring_recs)
+{
+    // round up to a power of two
+    uint32_t recs = 1024;
+    while (recs < ring_recs) recs <<= 1;
+    _ring_recs = recs;
+
+    btrace_calibrate();
+    _tsc_start = btrace_tsc();
+    __sync_synchronize();
+    _g_btrace_enabled = true;
+}
+
+void btrace_disable()
+{
+    _g_btrace_enabled = false;
+}
+
+void btrace_clear()
+{
+    // the rings belong to their threads, records older than this
+    // are skipped when dumping
+    _tsc_start = btrace_tsc();
+}
+
+
+
+void btrace_log(unsigned int type,
+                const char* file, int line, const char* function,
+                const char* format, va_list ap)
+{
+    btrace_site_t* s = get_site(file, line, function, format);
+    if (s == NULL) return;
+
+    btrace_ring_t* r = get_ring();
+    btrace_rec_t* rec = &r->_recs[r->_head & r->_mask];
+    rec->_tsc  = btrace_tsc();
+    rec->_site = s->_id;
+    rec->_type = type;
+
+    for (int i=0; i<BTRACE_ARGS; i++) {
+        switch (s->_arg_kind[i]) {
+        case BTA_INT:    rec->_arg[i] = va_arg(ap, int); break;
+        case BTA_LONG:   rec->_arg[i] = va_arg(ap, long); break;
+        case BTA_LLONG:  rec->_arg[i] = va_arg(ap, long long); break;
+        case BTA_PTR:    rec->_arg[i] = (int64_t)(uintptr_t)va_arg(ap, void*); break;
+        case BTA_DOUBLE: {
+            double d = va_arg(ap, double);
+            memcpy(&rec->_arg[i], &d, sizeof(double));
+            break; }
+        default:         rec->_arg[i] = 0; break;
+        }
+    }
+
+    // the record is complete before it becomes visible to the dumper
+    btrace_store_fence();
+    r->_head = r->_head + 1;
+}
+
+
+
+/*********************************************************************
+ *
+ *  @fn:    btrace_dump
+ *
+ *  @brief: Writes the sites and the rings to a file
+ *
+ *  @note:  The threads keep on writing while we copy their rings. The
+ *          records that may have been overwritten during the copy are
+ *          dropped and counted as lost.
+ *
+ *********************************************************************/
+
+static void write_str(FILE* f, const char* s, const uint16_t len)
+{
+    if (len) fwrite(s, 1, len, f);
+}
+
+static uint16_t str_len(const char* s)
+{
+    if (!s) return (0);
+    size_t l = strlen(s);
+    return (l > 0xffff ? 0xffff : (uint16_t)l);
+}
+
+int btrace_dump(const char* path)
+{
+    FILE* f = fopen(path, "w");
+    if (!f) {
+        TRACE( TRACE_ALWAYS, "Cannot open (%s)\n", path);
+        return (1);
+    }
+
+    vector<btrace_site_t*> sites;
+    {
+        critical_section_t cs(_site_mutex);
+        sites = _site_list;
+    }
+    vector<btrace_ring_t*> rings;
+    {
+        critical_section_t cs(_ring_mutex);
+        rings = _rings;
+    }
+
+    btrace_file_hdr_t fh;
+    memset(&fh, 0, sizeof(fh));
+    fh._magic        = BTRACE_MAGIC;
+    fh._version      = BTRACE_VERSION;
+    fh._tsc_per_usec = _tsc_per_usec;
+    fh._tsc_start    = _tsc_start;
+    fh._site_count   = sites.size();
+    fh._thread_count = rings.size();
+    fwrite(&fh, sizeof(fh), 1, f);
+
+    for (uint32_t i=0; i<sites.size(); i++) {
+        btrace_site_t* s = sites[i];
+        btrace_site_hdr_t sh;
+        memset(&sh, 0, sizeof(sh));
+        sh._id   = s->_id;
+        sh._line = s->_line;
+        memcpy(sh._arg_kind, s->_arg_kind, BTRACE_ARGS);
+        sh._file_len     = str_len(s->_file);
+        sh._function_len = str_len(s->_function);
+        sh._format_len   = str_len(s->_format);
+        fwrite(&sh, sizeof(sh), 1, f);
+        write_str(f, s->_file, sh._file_len);
+        write_str(f, s->_function, sh._function_len);
+        write_str(f, s->_format, sh._format_len);
+    }
+
+    uint64_t total = 0;
+    uint64_t lost = 0;
+    for (uint32_t i=0; i<rings.size(); i++) {
+        btrace_ring_t* r = rings[i];
+        uint64_t cap   = r->_mask + 1;
+        uint64_t head1 = r->_head;
+        uint64_t first = (head1 > cap ? head1 - cap : 0);
+
+        vector<btrace_rec_t> recs;
+        recs.reserve(head1 - first);
+        for (uint64_t j=first; j<head1; j++) {
+            recs.push_back(r->_recs[j & r->_mask]);
+        }
+        __sync_synchronize();
+
+        // records the writer may have reused while we were copying
+        uint64_t head2 = r->_head;
+        uint64_t unsafe = (head2 > cap ? head2 - cap : 0);
+        uint64_t skip = (unsafe > first ? unsafe - first : 0);
+        if (skip > recs.size()) skip = recs.size();
+
+        vector<btrace_rec_t> out;
+        out.reserve(recs.size() - skip);
+        for (uint64_t j=skip; j<recs.size(); j++) {
+            if (recs[j]._tsc >= fh._tsc_start) out.push_back(recs[j]);
+        }
+
+        btrace_thread_hdr_t th;
+        memset(&th, 0, sizeof(th));
+        th._tid       = r->_tid;
+        th._name_len  = str_len(r->_name);
+        th._rec_count = out.size();
+        th._lost      = first + skip;
+        fwrite(&th, sizeof(th), 1, f);
+        write_str(f, r->_name, th._name_len);
+        if (!out.empty()) {
+            fwrite(&out[0], sizeof(btrace_rec_t), out.size(), f);
+        }
+        total += out.size();
+        lost += th._lost;
+    }
+
+    fclose(f);
+    TRACE( TRACE_ALWAYS, "Dumped (%lld) records of (%d) threads to (%s). Lost (%lld)\n",
+           (long long)total, (int)rings.size(), path, (long long)lost);
+    return (0);
+}
+
+
+
+void btrace_print_stats()
+{
+    critical_section_t cs(_ring_mutex);
+    TRACE( TRACE_ALWAYS, "Binary tracing (%s). Sites (%d). Threads (%d). Ring (%d) recs\n",
+           (btrace_enabled() ? "on" : "off"), (int)_site_list.size(),
+           (int)_rings.size(), _ring_recs);
+    for (uint32_t i=0; i<_rings.size(); i++) {
+        TRACE( TRACE_ALWAYS, "%3d %-20s (%lld) records\n",
+               _rings[i]->_tid, _rings[i]->_name, (long long)_rings[i]->_head);
+    }
+}
@@ -24,6 +24,7 @@
 #include "util.h"
 #include "util/config.h"
 #include "util/command/tracer.h"
+#include "util/btrace.h"
 
 #include "k_defines.h"
 
@@ -118,6 +119,26 @@ int trace_cmd_t::handle(const char* cmd)
         return (SHELL_NEXT_CONTINUE);
     }
 
+    if (!strcasecmp(tag, "binary")) {
+        binary(cmd);
+        return (SHELL_NEXT_CONTINUE);
+    }
+
+    if (!strcasecmp(tag, "dump")) {
+        char fname[SERVER_COMMAND_BUFFER_SIZE];
+        if ( sscanf(cmd, "%*s %*s %s", fname) < 1 ) {
+            usage();
+            return (SHELL_NEXT_CONTINUE);
+        }
+        btrace_dump(fname);
+        return (SHELL_NEXT_CONTINUE);
+    }
+
+    if (!strcasecmp(tag, "clear")) {
+        btrace_clear();
+        return (SHELL_NEXT_CONTINUE);
+    }
+
     TRACE(TRACE_ALWAYS, "Unrecognized tag %s\n", tag);
     usage();
     return (SHELL_NEXT_CONTINUE);
@@ -125,6 +146,35 @@ int trace_cmd_t::handle(const char* cmd)
 
 
 
+/** Switches the binary (per-thread ring) backend on or off */
+
+void trace_cmd_t::binary(const char* cmd)
+{
+    char onoff[SERVER_COMMAND_BUFFER_SIZE];
+    int recs = BTRACE_DEFAULT_RING_RECS;
+
+    int args = sscanf(cmd, "%*s %*s %s %d", onoff, &recs);
+    if (args < 1) {
+        btrace_print_stats();
+        return;
+    }
+
+    if (!strcasecmp(onoff, "on")) {
+        if (recs <= 0) recs = BTRACE_DEFAULT_RING_RECS;
+        btrace_enable(recs);
+        TRACE(TRACE_ALWAYS, "Binary tracing enabled\n");
+    }
+    else if (!strcasecmp(onoff, "off")) {
+        btrace_disable();
+        TRACE(TRACE_ALWAYS, "Binary tracing disabled\n");
+    }
+    else {
+        usage();
+    }
+}
+
+
+
 void trace_cmd_t::enable(const char* type)
 {
     map<c_str, int>::iterator it;
@@ -186,4 +236,7 @@ void trace_cmd_t::print_enabled_types() {
 
 void trace_cmd_t::usage() {
     TRACE(TRACE_ALWAYS, "trace known|list|enable <type>|disable <type>\n");
+    TRACE(TRACE_ALWAYS, "trace binary [on [<ring-records>]|off]|dump <file>|clear\n");
+    TRACE(TRACE_ALWAYS, "  binary - per-thread binary rings instead of printing\n");
+    TRACE(TRACE_ALWAYS, "  dump   - writes the rings, decode with btrace_decode\n");
 }
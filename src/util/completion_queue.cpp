@@ -0,0 +1,172 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   completion_queue.cpp
+ *
+ *  @brief:  Implementation of the per-client completion ring
+ */
+
+#include "util/completion_queue.h"
+
+#include <sched.h>
+
+
+completion_queue_t::completion_queue_t(const uint capacity)
+    : _tail(0), _head(0), _parked(0), _spin(CQ_MIN_SPIN),
+      _requested(0), _wanted(0), _waited(0),
+      _spin_hits(0), _parks(0)
+{
+    // round up to a power of two
+    uint64_t sz = 2;
+    while (sz < capacity) sz <<= 1;
+    _mask = sz - 1;
+
+    _slots = new slot_t[sz];
+    for (uint64_t i=0; i<sz; i++) {
+        _slots[i]._seq = i;
+    }
+
+    if (pthread_mutex_init(&_lock,NULL)) {
+        assert (0); // failed to init mutex
+    }
+    if (pthread_cond_init(&_cond,NULL)) {
+        assert (0); // failed to init cond var
+    }
+}
+
+completion_queue_t::~completion_queue_t()
+{
+    pthread_cond_destroy(&_cond);
+    pthread_mutex_destroy(&_lock);
+    delete [] _slots;
+}
+
+
+/******************************************************************** 
+ *
+ *  @fn:    push
+ *
+ *  @brief: Publishes a completion record. Called by any thread.
+ *
+ *  @note:  The client never has more notifications in flight than the
+ *          capacity of its ring, so the ring is full only transiently,
+ *          while the owner is still reading a slot.
+ *
+ ********************************************************************/
+
+void completion_queue_t::push(const int xct_id, const int state)
+{
+    uint64_t pos = *&_tail;
+    slot_t* pslot = NULL;
+    while (true) {
+        pslot = &_slots[pos & _mask];
+        uint64_t seq = pslot->_seq;
+        membar_consumer();
+        int64_t diff = (int64_t)seq - (int64_t)pos;
+        if (diff == 0) {
+            // the slot is free, try to claim it
+            uint64_t cur = atomic_cas_64(&_tail, pos, pos+1);
+            if (cur == pos) break;
+            pos = cur;
+        }
+        else if (diff < 0) {
+            // full, wait for the owner to consume
+            sched_yield();
+            pos = *&_tail;
+        }
+        else {
+            // another producer claimed it
+            pos = *&_tail;
+        }
+    }
+
+    pslot->_rec._xct_id = xct_id;
+    pslot->_rec._state = state;
+    membar_producer();
+    pslot->_seq = pos + 1;
+
+    // Wake up the owner only if it is parked. The full barrier orders
+    // the publish above with the read of the flag (see pop).
+    membar_enter();
+    if (*&_parked) {
+        CRITICAL_SECTION(cs, _lock);
+        pthread_cond_signal(&_cond);
+    }
+}
+
+
+/******************************************************************** 
+ *
+ *  @fn:    try_pop
+ *
+ *  @brief: Consumes a record, if there is one. Only the owner calls it.
+ *
+ ********************************************************************/
+
+bool completion_queue_t::try_pop(completion_t& rec)
+{
+    slot_t* pslot = &_slots[_head & _mask];
+    uint64_t seq = pslot->_seq;
+    membar_consumer();
+    if (seq != _head + 1) {
+        return (false);
+    }
+
+    rec = pslot->_rec;
+    membar_exit();
+    pslot->_seq = _head + _mask + 1;
+    ++_head;
+    return (true);
+}
+
+
+/******************************************************************** 
+ *
+ *  @fn:    pop
+ *
+ *  @brief: Consumes a record. Polls the ring first and parks only if
+ *          nothing arrived. The spin grows when it pays off and
+ *          shrinks when the owner has to park anyway.
+ *
+ ********************************************************************/
+
+void completion_queue_t::pop(completion_t& rec)
+{
+    for (uint i=0; i<_spin; i++) {
+        if (try_pop(rec)) {
+            ++_spin_hits;
+            if (_spin < CQ_MAX_SPIN) _spin <<= 1;
+            return;
+        }
+    }
+
+    CRITICAL_SECTION(cs, _lock);
+    _parked = 1;
+    membar_enter();
+    while (!try_pop(rec)) {
+        pthread_cond_wait(&_cond, &_lock);
+    }
+    _parked = 0;
+    ++_parks;
+    if (_spin > CQ_MIN_SPIN) _spin >>= 1;
+}
@@ -0,0 +1,376 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   fileclone.cpp
+ *
+ *  @brief:  Implementation of the fast file copies (reflink, or parallel
+ *           sparse copy)
+ *
+ */
+
+#include "util/fileclone.h"
+#include "util/thread.h"
+#include "util/trace.h"
+#include "util/c_str.h"
+
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <cassert>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/ioctl.h>
+
+#ifdef __linux
+#include <linux/fs.h>
+#endif
+
+using std::string;
+using std::vector;
+
+
+// Each copier gets chunks of at most this size, round-robin
+const off_t FCLONE_CHUNK_SIZE = 64*1024*1024;
+const size_t FCLONE_BUF_SIZE  = 1024*1024;
+const int FCLONE_MAX_THREADS  = 64;
+
+
+struct fclone_extent_t
+{
+    off_t _offset;
+    off_t _len;
+    fclone_extent_t(const off_t offset, const off_t len)
+        : _offset(offset), _len(len) { }
+};
+
+
+
+/*********************************************************************
+ *
+ *  @class: fclone_copier_t
+ *
+ *  @brief: Copies every threads-th chunk of the extents list
+ *
+ *********************************************************************/
+
+class fclone_copier_t : public thread_t
+{
+private:
+    int _sfd;
+    int _dfd;
+    const vector<fclone_extent_t>* _chunks;
+    int _id;
+    int _threads;
+
+public:
+    int   _rv;
+    off_t _copied;
+
+    fclone_copier_t(const c_str& tname, int sfd, int dfd,
+                    const vector<fclone_extent_t>* chunks,
+                    const int id, const int threads)
+        : thread_t(tname), _sfd(sfd), _dfd(dfd), _chunks(chunks),
+          _id(id), _threads(threads), _rv(0), _copied(0)
+    { }
+
+    ~fclone_copier_t() { }
+
+    void work();
+
+}; // EOF: fclone_copier_t
+
+
+void fclone_copier_t::work()
+{
+    vector<char> buf(FCLONE_BUF_SIZE);
+    for (size_t i=_id; i<_chunks->size(); i+=_threads) {
+        off_t off = (*_chunks)[i]._offset;
+        off_t end = off + (*_chunks)[i]._len;
+        while (off < end) {
+            size_t toread = FCLONE_BUF_SIZE;
+            if (end - off < (off_t)toread) toread = end - off;
+            ssize_t r = pread(_sfd, &buf[0], toread, off);
+            if (r < 0) {
+                if (errno == EINTR) continue;
+                _rv = errno;
+                return;
+            }
+            if (r == 0) break; // the file shrunk
+            ssize_t done = 0;
+            while (done < r) {
+                ssize_t w = pwrite(_dfd, &buf[done], r - done, off + done);
+                if (w < 0) {
+                    if (errno == EINTR) continue;
+                    _rv = errno;
+                    return;
+                }
+                done += w;
+            }
+            off += r;
+            _copied += r;
+        }
+    }
+}
+
+
+
+/*********************************************************************
+ *
+ *  @fn:    _fclone_size
+ *
+ *  @brief: The size of a file or a block device
+ *
+ *********************************************************************/
+
+static int _fclone_size(const int fd, off_t& size, bool& bBlock)
+{
+    struct stat st;
+    if (fstat(fd, &st)) return (errno);
+    bBlock = S_ISBLK(st.st_mode);
+    size = st.st_size;
+#if defined(__linux) && defined(BLKGETSIZE64)
+    if (bBlock) {
+        unsigned long long bytes = 0;
+        if (ioctl(fd, BLKGETSIZE64, &bytes)) return (errno);
+        size = (off_t)bytes;
+    }
+#endif
+    return (0);
+}
+
+
+
+/*********************************************************************
+ *
+ *  @fn:    _fclone_extents
+ *
+ *  @brief: The regions of the file that have data. Without SEEK_DATA
+ *          support (or on block devices) the whole file is one region.
+ *
+ *********************************************************************/
+
+static void _fclone_extents(const int fd, const off_t size, const bool bBlock,
+                            vector<fclone_extent_t>& extents)
+{
+    extents.clear();
+#ifdef SEEK_DATA
+    if (!bBlock) {
+        off_t pos = 0;
+        bool bSupported = true;
+        while (pos < size) {
+            off_t data = lseek(fd, pos, SEEK_DATA);
+            if (data < 0) {
+                // ENXIO: only a hole until the end
+                if (errno != ENXIO) bSupported = false;
+                break;
+            }
+            off_t hole = lseek(fd, data, SEEK_HOLE);
+            if (hole < 0) { bSupported = false; break; }
+            if (hole > size) hole = size;
+            extents.push_back(fclone_extent_t(data, hole - data));
+            pos = hole;
+        }
+        if (bSupported) return;
+        extents.clear();
+    }
+#endif
+    if (size > 0) extents.push_back(fclone_extent_t(0, size));
+}
+
+
+
+/*********************************************************************
+ *
+ *  @fn:    fclone_file
+ *
+ *  @brief: Reflinks src to dst, or falls back to the parallel sparse
+ *          copy
+ *
+ *********************************************************************/
+
+int fclone_file(const char* src, const char* dst, const int threads,
+                fclone_method_t* pmethod, off_t* pbytes)
+{
+    assert (src);
+    assert (dst);
+
+    int sfd = open(src, O_RDONLY);
+    if (sfd < 0) return (errno);
+
+    off_t size = 0;
+    bool bSrcBlock = false;
+    int rv = _fclone_size(sfd, size, bSrcBlock);
+    if (rv) { close(sfd); return (rv); }
+
+    int dfd = open(dst, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (dfd < 0) { rv = errno; close(sfd); return (rv); }
+
+    off_t dsize = 0;
+    bool bDstBlock = false;
+    if ((rv = _fclone_size(dfd, dsize, bDstBlock))) {
+        close(sfd); close(dfd);
+        return (rv);
+    }
+
+#if defined(__linux) && defined(FICLONE)
+    // 1. Reflink, if both are files of the same (supporting) filesystem
+    if (!bSrcBlock && !bDstBlock && (ioctl(dfd, FICLONE, sfd) == 0)) {
+        close(sfd);
+        close(dfd);
+        if (pmethod) *pmethod = FCLONE_REFLINK;
+        if (pbytes) *pbytes = 0;
+        return (0);
+    }
+#endif
+
+    // 2. Sparse copy. The file was emptied when opened, so the regions
+    //    that are holes in the source stay holes in the copy.
+    if (!bDstBlock) {
+        if (ftruncate(dfd, size)) {
+            rv = errno;
+            close(sfd); close(dfd);
+            return (rv);
+        }
+    }
+
+    vector<fclone_extent_t> extents;
+    _fclone_extents(sfd, size, bSrcBlock, extents);
+
+    vector<fclone_extent_t> chunks;
+    for (size_t i=0; i<extents.size(); i++) {
+        for (off_t off=0; off<extents[i]._len; off+=FCLONE_CHUNK_SIZE) {
+            off_t len = extents[i]._len - off;
+            if (len > FCLONE_CHUNK_SIZE) len = FCLONE_CHUNK_SIZE;
+            chunks.push_back(fclone_extent_t(extents[i]._offset + off, len));
+        }
+    }
+
+    int nthreads = threads;
+    if (nthreads < 1) nthreads = 1;
+    if (nthreads > FCLONE_MAX_THREADS) nthreads = FCLONE_MAX_THREADS;
+    if (nthreads > (int)chunks.size()) nthreads = chunks.size();
+
+    vector<fclone_copier_t*> copiers;
+    for (int i=0; i<nthreads; i++) {
+        copiers.push_back(new fclone_copier_t(c_str("fclone-%d", i), sfd, dfd,
+                                              &chunks, i, nthreads));
+        copiers[i]->fork();
+    }
+
+    off_t copied = 0;
+    for (int i=0; i<nthreads; i++) {
+        copiers[i]->join();
+        if (copiers[i]->_rv && !rv) rv = copiers[i]->_rv;
+        copied += copiers[i]->_copied;
+        delete (copiers[i]);
+    }
+
+    if (!rv && fsync(dfd)) rv = errno;
+    close(sfd);
+    close(dfd);
+
+    TRACE( TRACE_DEBUG, "(%s) -> (%s): %lld of %lld bytes in (%d) extents\n",
+           src, dst, (long long)copied, (long long)size, (int)extents.size());
+
+    if (pmethod) *pmethod = FCLONE_SPARSE_COPY;
+    if (pbytes) *pbytes = copied;
+    return (rv);
+}
+
+
+
+int fmake_dir(const char* dir)
+{
+    assert (dir);
+    string path(dir);
+    for (size_t pos = path.find('/', 1); ; pos = path.find('/', pos+1)) {
+        string prefix = path.substr(0, pos);
+        if (!prefix.empty() && mkdir(prefix.c_str(), 0755) && (errno != EEXIST))
+            return (errno);
+        if (pos == string::npos) break;
+    }
+    return (0);
+}
+
+
+
+/*********************************************************************
+ *
+ *  @fn:    _fclone_list
+ *
+ *  @brief: The names of the regular files of a directory
+ *
+ *********************************************************************/
+
+static int _fclone_list(const char* dir, vector<string>& files)
+{
+    DIR* pdir = opendir(dir);
+    if (!pdir) return (errno);
+    struct dirent* pent;
+    while ((pent = readdir(pdir)) != NULL) {
+        string path = string(dir) + "/" + pent->d_name;
+        struct stat st;
+        if (!stat(path.c_str(), &st) && S_ISREG(st.st_mode))
+            files.push_back(pent->d_name);
+    }
+    closedir(pdir);
+    return (0);
+}
+
+
+int fclone_dir(const char* srcdir, const char* dstdir, const int threads)
+{
+    vector<string> files;
+    int rv = _fclone_list(srcdir, files);
+    if (rv) return (rv);
+    if ((rv = fmake_dir(dstdir))) return (rv);
+
+    for (size_t i=0; i<files.size(); i++) {
+        string src = string(srcdir) + "/" + files[i];
+        string dst = string(dstdir) + "/" + files[i];
+        if ((rv = fclone_file(src.c_str(), dst.c_str(), threads))) {
+            TRACE( TRACE_ALWAYS, "Cannot copy (%s): %s\n",
+                   src.c_str(), strerror(rv));
+            return (rv);
+        }
+    }
+    return (0);
+}
+
+
+int fclean_dir(const char* dir)
+{
+    vector<string> files;
+    int rv = _fclone_list(dir, files);
+    if (rv) return (rv);
+    for (size_t i=0; i<files.size(); i++) {
+        string path = string(dir) + "/" + files[i];
+        if (unlink(path.c_str()) && (errno != ENOENT)) return (errno);
+    }
+    return (0);
+}
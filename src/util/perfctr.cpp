@@ -0,0 +1,339 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   perfctr.cpp
+ *
+ *  @brief:  Per-thread hardware performance counters per region
+ *
+ *  @note:   Each thread has a table with a slot per region, written only
+ *           by itself. The tables are never freed, so that the counts of
+ *           the threads that exited are still printed, only the counters
+ *           are closed when a thread exits.
+ */
+
+#include "util/perfctr.h"
+#include "util/trace.h"
+#include "util/sync.h"
+#include "util/thread.h"
+
+#include "k_defines.h"
+
+#include <vector>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+
+#ifdef CFG_PERFCTRS
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#endif
+
+using std::vector;
+
+
+
+/*********************************************************************
+ *
+ *  Internal structures
+ *
+ *********************************************************************/
+
+struct perfctr_slot_t
+{
+    uint64_t         _count;
+    perfctr_values_t _sum;
+
+    perfctr_slot_t() : _count(0) { }
+};
+
+struct perfctr_thread_t
+{
+    int            _fd[PCE_EVENTS];   // -1 if the event did not open
+    int            _nopen;            // the group reads only those
+    bool           _failed;
+    uint64_t       _lost;             // readings the group was not counting
+    perfctr_slot_t _slots[PERFCTR_MAX_REGIONS];
+
+    perfctr_thread_t() : _nopen(0), _failed(false), _lost(0) {
+        for (int i=0; i<PCE_EVENTS; i++) _fd[i] = -1;
+    }
+};
+
+
+static const char*              _region_names[PERFCTR_MAX_REGIONS];
+static volatile int             _region_count = 0;
+static pthread_mutex_t          _region_mutex = thread_mutex_create();
+
+static vector<perfctr_thread_t*> _tables;
+static pthread_mutex_t          _table_mutex = thread_mutex_create();
+static __thread perfctr_thread_t* _my_table = NULL;
+
+
+
+/*********************************************************************
+ *
+ *  @fn:    perfctr_region
+ *
+ *  @brief: Registers a region by name, the same name gets the same id
+ *
+ *********************************************************************/
+
+int perfctr_region(const char* name)
+{
+    assert (name);
+    critical_section_t cs(_region_mutex);
+    for (int i=0; i<_region_count; i++) {
+        if (strcmp(_region_names[i], name) == 0) return (i);
+    }
+    if (_region_count == PERFCTR_MAX_REGIONS) {
+        TRACE( TRACE_ALWAYS, "Too many perf counter regions, (%s) ignored\n",
+               name);
+        return (PERFCTR_NO_REGION);
+    }
+    _region_names[_region_count] = strdup(name);
+    return (_region_count++);
+}
+
+
+
+#ifdef CFG_PERFCTRS
+
+static const uint64_t _event_config[PCE_EVENTS] = { 
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_REFERENCES,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES
+};
+
+// the layout of a group read with the times
+struct perfctr_group_read_t
+{
+    uint64_t _nr;
+    uint64_t _time_enabled;
+    uint64_t _time_running;
+    uint64_t _values[PCE_EVENTS];
+};
+
+static pthread_key_t  _close_key;
+static pthread_once_t _close_once = PTHREAD_ONCE_INIT;
+
+// closes the counters of an exiting thread, its table is kept
+static void _close_counters(void* arg)
+{
+    perfctr_thread_t* ptable = (perfctr_thread_t*)arg;
+    for (int i=PCE_EVENTS-1; i>=0; i--) {
+        if (ptable->_fd[i] >= 0) close(ptable->_fd[i]);
+        ptable->_fd[i] = -1;
+    }
+    ptable->_failed = true;
+}
+
+static void _create_close_key()
+{
+    pthread_key_create(&_close_key, _close_counters);
+}
+
+static int _open_event(const int ev, const int group_fd)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = _event_config[ev];
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = (PERF_FORMAT_GROUP | 
+                        PERF_FORMAT_TOTAL_TIME_ENABLED |
+                        PERF_FORMAT_TOTAL_TIME_RUNNING);
+    return (syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+
+
+/*********************************************************************
+ *
+ *  @fn:    _open_counters
+ *
+ *  @brief: Creates the table of the calling thread and opens its group.
+ *          The cycles are the leader, the events the CPU does not have
+ *          are left out.
+ *
+ *********************************************************************/
+
+static perfctr_thread_t* _open_counters()
+{
+    perfctr_thread_t* ptable = new perfctr_thread_t();
+    
+    ptable->_fd[PCE_CYCLES] = _open_event(PCE_CYCLES, -1);
+    if (ptable->_fd[PCE_CYCLES] < 0) {
+        static bool warned = false;
+        if (!warned) {
+            warned = true;
+            TRACE( TRACE_ALWAYS, 
+                   "perf_event_open failed (%s), no perf counters\n",
+                   strerror(errno));
+        }
+        ptable->_failed = true;
+    }
+    else {
+        ptable->_nopen = 1;
+        for (int i=PCE_CYCLES+1; i<PCE_EVENTS; i++) {
+            ptable->_fd[i] = _open_event(i, ptable->_fd[PCE_CYCLES]);
+            if (ptable->_fd[i] >= 0) ptable->_nopen++;
+        }
+        pthread_once(&_close_once, _create_close_key);
+        pthread_setspecific(_close_key, ptable);
+    }
+
+    critical_section_t cs(_table_mutex);
+    _tables.push_back(ptable);
+    return (ptable);
+}
+
+
+/*********************************************************************
+ *
+ *  @fn:    perfctr_read
+ *
+ *  @brief: One read() of the whole group. The times tell whether the 
+ *          group was on the PMU all the time between two readings.
+ *
+ *********************************************************************/
+
+bool perfctr_read(perfctr_values_t& vals)
+{
+    if (!_my_table) _my_table = _open_counters();
+    if (_my_table->_failed) return (false);
+
+    perfctr_group_read_t gr;
+    ssize_t sz = read(_my_table->_fd[PCE_CYCLES], &gr, sizeof(gr));
+    if ((sz < (ssize_t)(3*sizeof(uint64_t))) || 
+        (gr._nr != (uint64_t)_my_table->_nopen)) return (false);
+
+    int j = 0;
+    for (int i=0; i<PCE_EVENTS; i++) {
+        vals._v[i] = ((_my_table->_fd[i] >= 0) ? gr._values[j++] : 0);
+    }
+    vals._enabled = gr._time_enabled;
+    vals._running = gr._time_running;
+    return (true);
+}
+
+
+void perfctr_add(const int region, const perfctr_values_t& from, 
+                 const perfctr_values_t& to)
+{
+    assert ((region >= 0) && (region < PERFCTR_MAX_REGIONS));
+    assert (_my_table);
+
+    // multiplexed with other groups in between, the counts are partial
+    if ((to._running - from._running) != (to._enabled - from._enabled)) {
+        ++_my_table->_lost;
+        return;
+    }
+
+    perfctr_slot_t& aslot = _my_table->_slots[region];
+    ++aslot._count;
+    for (int i=0; i<PCE_EVENTS; i++) {
+        aslot._sum._v[i] += (to._v[i] - from._v[i]);
+    }
+}
+
+#else // CFG_PERFCTRS
+
+bool perfctr_read(perfctr_values_t& /* vals */)
+{
+    return (false);
+}
+
+void perfctr_add(const int /* region */, const perfctr_values_t& /* from */, 
+                 const perfctr_values_t& /* to */)
+{
+}
+
+#endif // CFG_PERFCTRS
+
+
+
+/*********************************************************************
+ *
+ *  @fn:    perfctr_print
+ *
+ *  @brief: Prints the average counts per region entry, summed over all
+ *          the threads, and zeroes them
+ *
+ *********************************************************************/
+
+void perfctr_print()
+{
+#ifdef CFG_PERFCTRS
+    vector<perfctr_slot_t> sums(PERFCTR_MAX_REGIONS);
+    uint64_t lost = 0;
+    uint threads = 0;
+    {
+        critical_section_t cs(_table_mutex);
+        threads = _tables.size();
+        for (uint t=0; t<_tables.size(); t++) {
+            for (int r=0; r<PERFCTR_MAX_REGIONS; r++) {
+                sums[r]._count += _tables[t]->_slots[r]._count;
+                sums[r]._sum += _tables[t]->_slots[r]._sum;
+            }
+            lost += _tables[t]->_lost;
+        }
+    }
+
+    TRACE( TRACE_ALWAYS, "Perf counters. Threads (%d). Lost readings (%lld)\n",
+           threads, (long long)lost);
+    TRACE( TRACE_ALWAYS, "%-24s %10s %12s %12s %6s %10s %10s %10s\n",
+           "Region", "Count", "Cycles", "Instrs", "IPC", 
+           "LLC-refs", "LLC-miss", "Br-miss");
+
+    int regions = *&_region_count;
+    for (int r=0; r<regions; r++) {
+        if (sums[r]._count == 0) continue;
+        double n = sums[r]._count;
+        const uint64_t* v = sums[r]._sum._v;
+        TRACE( TRACE_ALWAYS, "%-24s %10lld %12.0f %12.0f %6.2f %10.1f %10.1f %10.1f\n",
+               _region_names[r], (long long)sums[r]._count,
+               v[PCE_CYCLES]/n, v[PCE_INSTRUCTIONS]/n,
+               (v[PCE_CYCLES] ? (double)v[PCE_INSTRUCTIONS]/v[PCE_CYCLES] : 0),
+               v[PCE_LLC_REFS]/n, v[PCE_LLC_MISSES]/n, v[PCE_BR_MISSES]/n);
+    }
+
+    perfctr_reset();
+#endif
+}
+
+
+void perfctr_reset()
+{
+    critical_section_t cs(_table_mutex);
+    for (uint t=0; t<_tables.size(); t++) {
+        for (int r=0; r<PERFCTR_MAX_REGIONS; r++) {
+            _tables[t]->_slots[r]._count = 0;
+            _tables[t]->_slots[r]._sum.reset();
+        }
+        _tables[t]->_lost = 0;
+    }
+}
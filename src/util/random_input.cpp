@@ -118,8 +118,10 @@ int ZRand(const int low, const int high)
 
 void setZipf(const bool isEnabled, const double s)
 {
-    _g_enableZipf = isEnabled;
+    // s first, it may change while the inputs are generated
     _g_ZipfS = s;
+    membar_producer();
+    _g_enableZipf = isEnabled;
 }
 
 
@@ -31,6 +31,8 @@
 #include "util/skewer.h"
 #include "util/random_input.h"
 
+#include <algorithm>
+
 /*********************************************************************
  * 
  * @class skewer
@@ -60,6 +62,54 @@ void skewer_t::set(int area, int lower, int upper, int load)
 }
 
 
+/******************************************************************** 
+ *
+ *  @fn:    place()
+ *
+ *  @brief: Sets a single hot interval at the given spot. It is used by
+ *          the scripted skew scenarios, which need the hot spot to be
+ *          at the same place in every run.
+ *
+ ********************************************************************/
+
+void skewer_t::place(int lower, int upper, int first, int count, int load)
+{
+    assert (upper >= lower);
+    int n = upper - lower + 1;
+    count = (count < 1) ? 1 : ((count > n) ? n : count);
+    first = lower + (((first - lower) % n) + n) % n;
+
+    _lower = lower;
+    _upper = upper;
+    _load = (load < 0) ? 0 : ((load > 100) ? 100 : load);
+    _area = (count * 100) / n;
+
+    spots_t& sp = _standby();
+    sp.clear();
+    sp._load = _load;
+    int last = first + count - 1;
+    if (last <= _upper) {
+        sp.insert_interval(0, first, last);
+    } else {
+        // wraps around
+        sp.insert_interval(0, _lower, _lower + (last - _upper) - 1);
+        sp.insert_interval(1, first, _upper);
+    }
+    _set_non_intervals();
+    _publish();
+    _is_used = true;
+}
+
+
+void skewer_t::place_pct(int lower, int upper, double pos, double area, int load)
+{
+    int n = upper - lower + 1;
+    int first = lower + (int)((pos * n) / 100);
+    int count = (int)((area * n) / 100 + 0.5);
+    place(lower, upper, first, count, load);
+}
+
+
 /******************************************************************** 
  *
  *  @fn:    clear()
@@ -68,11 +118,33 @@ void skewer_t::set(int area, int lower, int upper, int load)
  *
  ********************************************************************/
 
+void skewer_t::spots_t::clear() {
+    _load = 0;
+    _intervals = 0;
+    _non_intervals = 0;
+}
+
+void skewer_t::spots_t::insert_interval(int at, int lower, int upper) {
+    assert ((at >= 0) && (at <= _intervals) && (_intervals < SKEW_MAX_INTERVALS));
+    for (int i=_intervals; i>at; i--) {
+        _interval_l[i] = _interval_l[i-1];
+        _interval_u[i] = _interval_u[i-1];
+    }
+    _interval_l[at] = lower;
+    _interval_u[at] = upper;
+    _intervals++;
+}
+
+void skewer_t::spots_t::add_non_interval(int lower, int upper) {
+    assert (_non_intervals <= SKEW_MAX_INTERVALS);
+    _non_interval_l[_non_intervals] = lower;
+    _non_interval_u[_non_intervals] = upper;
+    _non_intervals++;
+}
+
 void skewer_t::clear() {
-    _interval_l.clear();
-    _interval_u.clear();
-    _non_interval_l.clear();
-    _non_interval_u.clear();
+    _standby().clear();
+    _publish();
     _is_used = false;
 }
 
@@ -87,7 +159,6 @@ void skewer_t::clear() {
  ********************************************************************/
 
 void skewer_t::reset(skew_type_t type) {
-    clear();
     if(type == SKEW_CHAOTIC) {
 	_load = URand(0,100);
 	_area = URand(1,100);
@@ -115,6 +186,27 @@ bool skewer_t::is_used() {
 }
 
 
+/******************************************************************** 
+ *
+ *  @fn:    _publish()
+ *
+ *  @brief: Makes the standby spots the active ones
+ *
+ *  @note:  The spots are double-buffered so that the input creators
+ *          never read intervals that are being rebuilt. A reader that
+ *          stalls across two consecutive changes could still see a
+ *          torn set. Since the intervals are fixed arrays, it reads
+ *          stale values but never freed memory, and get_input() 
+ *          bounds the counts and keeps its output in the boundaries.
+ *
+ ********************************************************************/
+
+void skewer_t::_publish() {
+    membar_producer();
+    _active = 1 - _active;
+}
+
+
 /******************************************************************** 
  *
  *  @fn:    _set_intervals()
@@ -129,6 +221,9 @@ bool skewer_t::is_used() {
  ********************************************************************/
 
 void skewer_t::_set_intervals() {    
+    spots_t& sp = _standby();
+    sp.clear();
+    sp._load = _load;
     // for intervals
     if(URand(1,100) < 70) { // a continuous spot
 	int interval_lower = URand(_lower,_upper);
@@ -144,23 +239,37 @@ void skewer_t::_set_intervals() {
 	_add_interval(interval_lower_2, interval_upper_2);
     }
     // for outside of intervals
-    for(int i=0; i<_interval_u.size(); i++) {
-	if(i==0 && _interval_l[i] > _lower) {
-	    _non_interval_l.push_back(_lower);
-	    _non_interval_u.push_back(_interval_l[i]-1);
+    _set_non_intervals();
+    _publish();
+    // pin: to debug
+    //print_intervals();
+}
+
+
+/******************************************************************** 
+ *
+ *  @fn:    _set_non_intervals()
+ *
+ *  @brief: sets the intervals outside of the standby intervals
+ *
+ ********************************************************************/
+
+void skewer_t::_set_non_intervals() {
+    spots_t& sp = _standby();
+    int* interval_l = sp._interval_l;
+    int* interval_u = sp._interval_u;
+    for(int i=0; i<sp._intervals; i++) {
+	if(i==0 && interval_l[i] > _lower) {
+	    sp.add_non_interval(_lower, interval_l[i]-1);
 	}
-	if(i+1<_interval_u.size()) {
-	    if(_interval_u[i]+1 < _interval_l[i+1]) {
-		_non_interval_l.push_back(_interval_u[i]+1);
-		_non_interval_u.push_back(_interval_l[i+1]-1);
+	if(i+1<sp._intervals) {
+	    if(interval_u[i]+1 < interval_l[i+1]) {
+		sp.add_non_interval(interval_u[i]+1, interval_l[i+1]-1);
 	    }
-	}  else if(_interval_u[i] < _upper) {
-	    _non_interval_l.push_back(_interval_u[i]+1);
-	    _non_interval_u.push_back(_upper);
+	}  else if(interval_u[i] < _upper) {
+	    sp.add_non_interval(interval_u[i]+1, _upper);
 	}
     }
-    // pin: to debug
-    //print_intervals();
 }
 
 
@@ -177,45 +286,33 @@ void skewer_t::_set_intervals() {
  ********************************************************************/
 
 void skewer_t::_add_interval(int interval_lower, int interval_upper) {
+    spots_t& sp = _standby();
     // pin: a very ugly check for a special case, try to get rid of this later
     if(interval_lower == _upper && interval_upper-1>_upper) {
 	interval_lower--;
 	interval_upper--;
     }
     if(interval_upper-1 > _upper) {
-	if(_interval_l.size() == 1) {
-	    _interval_l.insert(_interval_l.begin(), _lower);
-	    _interval_u.insert(_interval_u.begin(), interval_upper - _upper - 2 + _lower);
-	    _interval_l.push_back(interval_lower + 1);
-	    _interval_u.push_back(_upper);
-	} else if(_interval_l.size() == 2) {
-	    if(_interval_u[0] > interval_upper - _upper - 2 + _lower) {
-		_interval_l.insert(_interval_l.begin(), _lower);
-		_interval_u.insert(_interval_u.begin(), interval_upper - _upper - 2 + _lower);
+	if(sp._intervals == 1) {
+	    sp.insert_interval(0, _lower, interval_upper - _upper - 2 + _lower);
+	    sp.insert_interval(sp._intervals, interval_lower + 1, _upper);
+	} else if(sp._intervals == 2) {
+	    if(sp._interval_u[0] > interval_upper - _upper - 2 + _lower) {
+		sp.insert_interval(0, _lower, interval_upper - _upper - 2 + _lower);
 	    } else {
-		vector<int>::iterator iter = _interval_l.begin();
-		_interval_l.insert(++iter, _lower);
-		iter = _interval_u.begin();
-		_interval_u.insert(++iter, interval_upper - _upper - 2 + _lower);
+		sp.insert_interval(1, _lower, interval_upper - _upper - 2 + _lower);
 	    }
-	    if(_interval_l[2] < interval_lower+1) {
-		_interval_l.push_back(interval_lower+1);
-		_interval_u.push_back(_upper);
+	    if(sp._interval_l[2] < interval_lower+1) {
+		sp.insert_interval(3, interval_lower+1, _upper);
 	    } else {
-		_interval_l.push_back(_interval_l[2]);
-		_interval_u.push_back(_interval_u[2]);
-		_interval_l[2] = interval_lower+1;
-		_interval_u[2] = _upper;
+		sp.insert_interval(2, interval_lower+1, _upper);
 	    }
 	} else {
-	    _interval_l.push_back(_lower);
-	    _interval_u.push_back(interval_upper - _upper - 2 + _lower);
-	    _interval_l.push_back(interval_lower+1);
-	    _interval_u.push_back(_upper);
+	    sp.insert_interval(sp._intervals, _lower, interval_upper - _upper - 2 + _lower);
+	    sp.insert_interval(sp._intervals, interval_lower+1, _upper);
 	}
     } else {
-	_interval_l.push_back(interval_lower);
-	_interval_u.push_back(interval_upper - 1);
+	sp.insert_interval(sp._intervals, interval_lower, interval_upper - 1);
     }
 }
 
@@ -229,22 +326,30 @@ void skewer_t::_add_interval(int interval_lower, int interval_upper) {
  ********************************************************************/
 
 int skewer_t::get_input() {
+    const spots_t& sp = _spots[_active];
+    membar_consumer();
+    int intervals = std::min(*&sp._intervals, SKEW_MAX_INTERVALS);
+    int non_intervals = std::min(*&sp._non_intervals, SKEW_MAX_INTERVALS+1);
     int input = 0;
     bool is_set = false;
     int rand = URand(1,100);
-    int load = _load / _interval_u.size();
-    for(int i=0; !is_set && i<_interval_u.size(); i++) {
-	if(rand < load * (i+1)) {
-	    input = UZRand(_interval_l[i],_interval_u[i]);
-	    is_set = true;
+    if(intervals > 0) {
+	int load = sp._load / intervals;
+	for(int i=0; !is_set && i<intervals; i++) {
+	    if(rand < load * (i+1)) {
+		input = UZRand(sp._interval_l[i],sp._interval_u[i]);
+		is_set = true;
+	    }
 	}
     }
-    rand = rand - _load;
-    load = (100 - _load) / _non_interval_u.size();
-    for(int i=0; !is_set && i<_non_interval_u.size(); i++) {
-	if(rand < load * (i+1)) {
-	    input = UZRand(_non_interval_l[i],_non_interval_u[i]);
-	    is_set = true;
+    rand = rand - sp._load;
+    if(non_intervals > 0) {
+	int load = (100 - sp._load) / non_intervals;
+	for(int i=0; !is_set && i<non_intervals; i++) {
+	    if(rand < load * (i+1)) {
+		input = UZRand(sp._non_interval_l[i],sp._non_interval_u[i]);
+		is_set = true;
+	    }
 	}
     }
     if(!is_set || (input < _lower) || (input > _upper)) {
@@ -264,12 +369,13 @@ int skewer_t::get_input() {
  ********************************************************************/
 
 void skewer_t::print_intervals() {
+    const spots_t& sp = _spots[_active];
     cout << "print intervals for (load)" << endl;
-    for(int i=0; i<_interval_u.size(); i++) {
-	cout << _interval_l[i] << " - " <<  _interval_u[i] << endl;
+    for(int i=0; i<sp._intervals; i++) {
+	cout << sp._interval_l[i] << " - " <<  sp._interval_u[i] << endl;
     }
     cout << "print intervals for (100-load)" << endl;
-    for(int i=0; i<_non_interval_u.size(); i++) {
-	cout << _non_interval_l[i] << " - " <<  _non_interval_u[i] << endl;
+    for(int i=0; i<sp._non_intervals; i++) {
+	cout << sp._non_interval_l[i] << " - " <<  sp._non_interval_u[i] << endl;
     }
 }
@@ -0,0 +1,192 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   stat_counter.cpp
+ *
+ *  @brief:  Per-thread tables of statistics counters
+ *
+ *  @note:   Each thread has a table with a slot per counter, written 
+ *           only by itself. When a thread exits its counts are moved to
+ *           the table of the exited threads and its table is freed.
+ */
+
+#include "util/stat_counter.h"
+#include "util/trace.h"
+#include "util/sync.h"
+#include "util/thread.h"
+
+#include "k_defines.h"
+
+#include <vector>
+#include <string.h>
+#include <pthread.h>
+
+using std::vector;
+
+
+
+/*********************************************************************
+ *
+ *  Internal structures
+ *
+ *********************************************************************/
+
+struct stat_thread_t
+{
+    uint64_t _v[STAT_MAX_COUNTERS];
+
+    stat_thread_t() { memset(_v, 0, sizeof(_v)); }
+};
+
+
+static const char*            _counter_names[STAT_MAX_COUNTERS];
+static int                    _counter_count = 0;
+static pthread_mutex_t        _counter_mutex = thread_mutex_create();
+
+static vector<stat_thread_t*> _tables;
+static stat_thread_t          _exited;       // the counts of the exited threads
+static pthread_mutex_t        _table_mutex = thread_mutex_create();
+static __thread stat_thread_t* _my_table = NULL;
+
+static pthread_key_t  _exit_key;
+static pthread_once_t _exit_once = PTHREAD_ONCE_INIT;
+
+
+
+/*********************************************************************
+ *
+ *  @fn:    stat_counter
+ *
+ *  @brief: Registers a counter by name, the same name gets the same id
+ *
+ *********************************************************************/
+
+int stat_counter(const char* name)
+{
+    assert (name);
+    critical_section_t cs(_counter_mutex);
+    for (int i=0; i<_counter_count; i++) {
+        if (strcmp(_counter_names[i], name) == 0) return (i);
+    }
+    if (_counter_count == STAT_MAX_COUNTERS) {
+        TRACE( TRACE_ALWAYS, "Too many stat counters, (%s) ignored\n",
+               name);
+        return (STAT_NO_COUNTER);
+    }
+    _counter_names[_counter_count] = strdup(name);
+    return (_counter_count++);
+}
+
+
+
+/*********************************************************************
+ *
+ *  @fn:    _open_table, _close_table
+ *
+ *  @brief: Create the table of the calling thread, and fold it into the
+ *          counts of the exited threads when the thread exits
+ *
+ *********************************************************************/
+
+static void _close_table(void* arg)
+{
+    stat_thread_t* ptable = (stat_thread_t*)arg;
+    {
+        critical_section_t cs(_table_mutex);
+        for (uint t=0; t<_tables.size(); t++) {
+            if (_tables[t] != ptable) continue;
+            _tables[t] = _tables.back();
+            _tables.pop_back();
+            break;
+        }
+        for (int i=0; i<STAT_MAX_COUNTERS; i++) _exited._v[i] += ptable->_v[i];
+    }
+    if (_my_table == ptable) _my_table = NULL;
+    delete ptable;
+}
+
+static void _create_exit_key()
+{
+    pthread_key_create(&_exit_key, _close_table);
+}
+
+static stat_thread_t* _open_table()
+{
+    stat_thread_t* ptable = new stat_thread_t();
+    pthread_once(&_exit_once, _create_exit_key);
+    pthread_setspecific(_exit_key, ptable);
+
+    critical_section_t cs(_table_mutex);
+    _tables.push_back(ptable);
+    return (ptable);
+}
+
+
+
+/*********************************************************************
+ *
+ *  @fn:    stat_add
+ *
+ *  @brief: Adds to the slot of the counter in the thread's own table
+ *
+ *********************************************************************/
+
+void stat_add(const int counter, const uint64_t value)
+{
+    if (counter == STAT_NO_COUNTER) return;
+    assert (counter < STAT_MAX_COUNTERS);
+    if (!_my_table) _my_table = _open_table();
+    _my_table->_v[counter] += value;
+}
+
+
+
+/*********************************************************************
+ *
+ *  @fn:    stat_sum, stat_reset
+ *
+ *  @brief: Sum and zero a counter over the tables of all the threads
+ *
+ *********************************************************************/
+
+uint64_t stat_sum(const int counter)
+{
+    if (counter == STAT_NO_COUNTER) return (0);
+    critical_section_t cs(_table_mutex);
+    uint64_t sum = _exited._v[counter];
+    for (uint t=0; t<_tables.size(); t++) {
+        sum += *&_tables[t]->_v[counter];
+    }
+    return (sum);
+}
+
+
+void stat_reset(const int counter)
+{
+    if (counter == STAT_NO_COUNTER) return;
+    critical_section_t cs(_table_mutex);
+    _exited._v[counter] = 0;
+    for (uint t=0; t<_tables.size(); t++) {
+        _tables[t]->_v[counter] = 0;
+    }
+}
@@ -0,0 +1,438 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   topology.cpp
+ *
+ *  @brief:  Implementation of the sysfs-based machine topology and the
+ *           node-aware cpu placement helper
+ */
+
+#include "util/topology.h"
+#include "util/trace.h"
+#include "util/sync.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cassert>
+#include <algorithm>
+
+#include <unistd.h>
+#include <dirent.h>
+
+
+static const char* SYSFS_CPU  = "/sys/devices/system/cpu";
+static const char* SYSFS_NODE = "/sys/devices/system/node";
+
+
+// Reads the first line of a sysfs file. Returns false if it is not there.
+static bool _read_line(const string& path, string& out)
+{
+    FILE* fd = fopen(path.c_str(), "r");
+    if (!fd) return (false);
+    char buf[1024];
+    bool ok = (fgets(buf, sizeof(buf), fd) != NULL);
+    fclose(fd);
+    if (!ok) return (false);
+    out = buf;
+    while (!out.empty() && ((out[out.size()-1]=='\n')||(out[out.size()-1]==' ')))
+        out.erase(out.size()-1);
+    return (true);
+}
+
+static int _read_int(const string& path, const int defvalue)
+{
+    string s;
+    if (!_read_line(path,s) || s.empty()) return (defvalue);
+    return (atoi(s.c_str()));
+}
+
+
+/********************************************************************
+ *
+ *  @fn:    parse_cpulist()
+ *
+ *  @brief: Parses the "0-3,8,10-11" format used by sysfs
+ *
+ ********************************************************************/
+
+void cpu_topology_t::parse_cpulist(const string& alist, vector<int>& out)
+{
+    out.clear();
+    const char* p = alist.c_str();
+    while (*p) {
+        char* end = NULL;
+        long lo = strtol(p, &end, 10);
+        if (end == p) break;
+        long hi = lo;
+        p = end;
+        if (*p == '-') {
+            ++p;
+            hi = strtol(p, &end, 10);
+            if (end == p) break;
+            p = end;
+        }
+        for (long i=lo; i<=hi; i++) out.push_back((int)i);
+        if (*p == ',') ++p;
+    }
+}
+
+
+
+/********************************************************************
+ *
+ *  @class: cpu_topology_t
+ *
+ ********************************************************************/
+
+cpu_topology_t::cpu_topology_t()
+    : _sockets(1), _from_sysfs(false)
+{
+    _load();
+    _order_nodes();
+}
+
+
+/********************************************************************
+ *
+ *  @fn:    _load()
+ *
+ *  @brief: Reads the online cpus and, for each one, its package, core,
+ *          SMT siblings and last-level cache. Then assigns cpus to
+ *          NUMA nodes. If any of the essential files is missing it
+ *          falls back to a flat, single-node topology.
+ *
+ ********************************************************************/
+
+void cpu_topology_t::_load()
+{
+    string s;
+    vector<int> online;
+    if (!_read_line(string(SYSFS_CPU) + "/online", s)) {
+        _load_flat(sysconf(_SC_NPROCESSORS_ONLN));
+        return;
+    }
+    parse_cpulist(s, online);
+    if (online.empty()) {
+        _load_flat(sysconf(_SC_NPROCESSORS_ONLN));
+        return;
+    }
+
+    int maxid = *std::max_element(online.begin(), online.end());
+    _cpus.resize(maxid+1);
+
+    map<int,int> sockets;
+    for (uint i=0; i<online.size(); i++) {
+        int id = online[i];
+        char path[256];
+        cpu_desc_t& d = _cpus[id];
+        d._id = id;
+
+        snprintf(path, sizeof(path), "%s/cpu%d/topology/physical_package_id", SYSFS_CPU, id);
+        d._socket = std::max(0, _read_int(path, 0));
+        sockets[d._socket] = 1;
+
+        snprintf(path, sizeof(path), "%s/cpu%d/topology/core_id", SYSFS_CPU, id);
+        d._core = _read_int(path, id);
+
+        // The position among the SMT siblings
+        snprintf(path, sizeof(path), "%s/cpu%d/topology/thread_siblings_list", SYSFS_CPU, id);
+        vector<int> sibs;
+        if (_read_line(path, s)) parse_cpulist(s, sibs);
+        d._smt = 0;
+        for (uint j=0; j<sibs.size(); j++) {
+            if (sibs[j] < id) d._smt++;
+        }
+
+        // The last-level cache is the one with the highest level
+        d._llc = id;
+        int bestlevel = -1;
+        for (int idx=0; ; idx++) {
+            snprintf(path, sizeof(path), "%s/cpu%d/cache/index%d/level", SYSFS_CPU, id, idx);
+            int level = _read_int(path, -1);
+            if (level < 0) break;
+            if (level <= bestlevel) continue;
+            snprintf(path, sizeof(path), "%s/cpu%d/cache/index%d/shared_cpu_list", SYSFS_CPU, id, idx);
+            vector<int> shared;
+            if (_read_line(path, s)) parse_cpulist(s, shared);
+            if (shared.empty()) continue;
+            bestlevel = level;
+            d._llc = *std::min_element(shared.begin(), shared.end());
+        }
+    }
+    _sockets = sockets.size();
+
+    // NUMA nodes. Without node information, use the sockets as nodes.
+    map<int, vector<processorid_t> > nodes;
+    DIR* dir = opendir(SYSFS_NODE);
+    if (dir) {
+        struct dirent* de;
+        while ((de = readdir(dir)) != NULL) {
+            int nid;
+            if (sscanf(de->d_name, "node%d", &nid) != 1) continue;
+            char path[256];
+            snprintf(path, sizeof(path), "%s/node%d/cpulist", SYSFS_NODE, nid);
+            vector<int> cpus;
+            if (_read_line(path, s)) parse_cpulist(s, cpus);
+            for (uint j=0; j<cpus.size(); j++) {
+                if ((cpus[j] <= maxid) && (_cpus[cpus[j]]._id != PBIND_NONE))
+                    nodes[nid].push_back(cpus[j]);
+            }
+        }
+        closedir(dir);
+    }
+
+    if (nodes.empty()) {
+        for (uint i=0; i<online.size(); i++) {
+            nodes[_cpus[online[i]]._socket].push_back(online[i]);
+        }
+    }
+
+    // Renumber the nodes densely, in the order of their sysfs ids
+    for (map<int, vector<processorid_t> >::iterator it = nodes.begin();
+         it != nodes.end(); it++) {
+        if ((*it).second.empty()) continue;
+        int dense = _node_cpus.size();
+        for (uint j=0; j<(*it).second.size(); j++) {
+            _cpus[(*it).second[j]]._node = dense;
+        }
+        _node_cpus.push_back((*it).second);
+    }
+
+    // Cpus that are online but were not listed by any node
+    for (uint i=0; i<online.size(); i++) {
+        bool found = false;
+        for (uint n=0; n<_node_cpus.size() && !found; n++) {
+            found = (std::find(_node_cpus[n].begin(), _node_cpus[n].end(),
+                               online[i]) != _node_cpus[n].end());
+        }
+        if (!found) {
+            if (_node_cpus.empty()) _node_cpus.resize(1);
+            _cpus[online[i]]._node = 0;
+            _node_cpus[0].push_back(online[i]);
+        }
+    }
+
+    _from_sysfs = true;
+}
+
+
+void cpu_topology_t::_load_flat(const int cpus)
+{
+    int count = (cpus > 0 ? cpus : 1);
+    _cpus.resize(count);
+    _node_cpus.resize(1);
+    for (int i=0; i<count; i++) {
+        _cpus[i]._id = i;
+        _cpus[i]._core = i;
+        _cpus[i]._llc = 0;
+        _node_cpus[0].push_back(i);
+    }
+    _sockets = 1;
+    _from_sysfs = false;
+}
+
+
+// Orders the cpus of each node: first the first thread of each core,
+// then the second threads, etc. Inside each class by socket, LLC and
+// core, so that consecutive cpus share as much as possible.
+struct _cpu_order_cmp
+{
+    const vector<cpu_desc_t>& _cpus;
+    _cpu_order_cmp(const vector<cpu_desc_t>& cpus) : _cpus(cpus) { }
+    bool operator()(const processorid_t a, const processorid_t b) const {
+        const cpu_desc_t& x = _cpus[a];
+        const cpu_desc_t& y = _cpus[b];
+        if (x._smt != y._smt)       return (x._smt < y._smt);
+        if (x._socket != y._socket) return (x._socket < y._socket);
+        if (x._llc != y._llc)       return (x._llc < y._llc);
+        if (x._core != y._core)     return (x._core < y._core);
+        return (a < b);
+    }
+};
+
+void cpu_topology_t::_order_nodes()
+{
+    for (uint n=0; n<_node_cpus.size(); n++) {
+        std::sort(_node_cpus[n].begin(), _node_cpus[n].end(),
+                  _cpu_order_cmp(_cpus));
+    }
+}
+
+
+const cpu_desc_t& cpu_topology_t::cpu(const processorid_t acpu) const
+{
+    assert ((acpu >= 0) && (acpu < (int)_cpus.size()));
+    return (_cpus[acpu]);
+}
+
+int cpu_topology_t::node_of(const processorid_t acpu) const
+{
+    if ((acpu < 0) || (acpu >= (int)_cpus.size())) return (0);
+    return (_cpus[acpu]._node);
+}
+
+const vector<processorid_t>& cpu_topology_t::node_cpus(const int anode) const
+{
+    assert ((anode >= 0) && (anode < (int)_node_cpus.size()));
+    return (_node_cpus[anode]);
+}
+
+int cpu_topology_t::node_for_range(const uint apos, const uint atotal) const
+{
+    if (atotal == 0) return (0);
+    uint64_t node = ((uint64_t)apos * _node_cpus.size()) / atotal;
+    return ((int)std::min(node, (uint64_t)(_node_cpus.size()-1)));
+}
+
+bool cpu_topology_t::are_siblings(const processorid_t a, 
+                                  const processorid_t b) const
+{
+    const cpu_desc_t& x = cpu(a);
+    const cpu_desc_t& y = cpu(b);
+    return ((x._socket == y._socket) && (x._core == y._core));
+}
+
+bool cpu_topology_t::share_llc(const processorid_t a, 
+                               const processorid_t b) const
+{
+    return (cpu(a)._llc == cpu(b)._llc);
+}
+
+
+void cpu_topology_t::print() const
+{
+    TRACE( TRACE_ALWAYS, "Topology (%s): cpus (%d) sockets (%d) nodes (%d)\n",
+           (_from_sysfs ? "sysfs" : "flat"), 
+           (int)_cpus.size(), _sockets, (int)_node_cpus.size());
+    for (uint n=0; n<_node_cpus.size(); n++) {
+        string list;
+        char buf[16];
+        for (uint j=0; j<_node_cpus[n].size(); j++) {
+            snprintf(buf, sizeof(buf), "%s%d", (j ? "," : ""), _node_cpus[n][j]);
+            list += buf;
+        }
+        TRACE( TRACE_ALWAYS, "Node (%d): %s\n", n, list.c_str());
+    }
+}
+
+
+
+/********************************************************************
+ *
+ *  @class: cpu_placement_t
+ *
+ ********************************************************************/
+
+cpu_placement_t::cpu_placement_t(const char* aname, const int max_cpus)
+    : _name(aname), _max_cpus(max_cpus), _lock(thread_mutex_create())
+{
+    cpu_topology_t* topo = cpu_topology_t::instance();
+    _usable.resize(topo->node_count());
+    for (int n=0; n<topo->node_count(); n++) {
+        const vector<processorid_t>& cpus = topo->node_cpus(n);
+        for (uint j=0; j<cpus.size(); j++) {
+            if ((_max_cpus <= 0) || (cpus[j] < _max_cpus)) {
+                _usable[n].push_back(cpus[j]);
+            }
+        }
+    }
+    _cursor.resize(_usable.size(), 0);
+}
+
+cpu_placement_t::~cpu_placement_t()
+{
+    thread_mutex_destroy(_lock);
+}
+
+void cpu_placement_t::reset()
+{
+    critical_section_t cs(_lock);
+    std::fill(_cursor.begin(), _cursor.end(), 0);
+    _map.clear();
+}
+
+// Returns anode, or the next node with usable cpus. -1 if there are none.
+int cpu_placement_t::_usable_node(const int anode) const
+{
+    int nodes = _usable.size();
+    for (int i=0; i<nodes; i++) {
+        int n = (anode + i) % nodes;
+        if (!_usable[n].empty()) return (n);
+    }
+    return (-1);
+}
+
+void cpu_placement_t::_record(const string& aowner, const processorid_t acpu)
+{
+    _map[aowner] = acpu;
+    TRACE( TRACE_CPU_BINDING, "(%s) %s -> (%d)\n", 
+           _name.c_str(), aowner.c_str(), acpu);
+}
+
+processorid_t cpu_placement_t::next(const int anode, const string& aowner)
+{
+    critical_section_t cs(_lock);
+    int n = _usable_node(anode<0 ? 0 : anode);
+    if (n < 0) return (PBIND_NONE);
+    processorid_t acpu = _usable[n][_cursor[n] % _usable[n].size()];
+    _cursor[n]++;
+    _record(aowner, acpu);
+    return (acpu);
+}
+
+processorid_t cpu_placement_t::next_for_range(const uint apos, const uint atotal,
+                                              const string& aowner)
+{
+    return (next(cpu_topology_t::instance()->node_for_range(apos,atotal), aowner));
+}
+
+processorid_t cpu_placement_t::tail(const int anode, const uint nth, 
+                                    const string& aowner)
+{
+    critical_section_t cs(_lock);
+    int n = _usable_node(anode<0 ? 0 : anode);
+    if (n < 0) return (PBIND_NONE);
+    uint sz = _usable[n].size();
+    processorid_t acpu = _usable[n][sz - 1 - (nth % sz)];
+    _record(aowner, acpu);
+    return (acpu);
+}
+
+
+void cpu_placement_t::print() const
+{
+    cpu_topology_t* topo = cpu_topology_t::instance();
+    TRACE( TRACE_ALWAYS, "Placement (%s): (%d) threads\n", 
+           _name.c_str(), (int)_map.size());
+    for (PlacementMapCIt it = _map.begin(); it != _map.end(); it++) {
+        processorid_t acpu = (*it).second;
+        if (acpu == PBIND_NONE) {
+            TRACE( TRACE_ALWAYS, "%-24s -> unbound\n", (*it).first.c_str());
+            continue;
+        }
+        const cpu_desc_t& d = topo->cpu(acpu);
+        TRACE( TRACE_ALWAYS, 
+               "%-24s -> cpu (%d) node (%d) socket (%d) core (%d) smt (%d)\n",
+               (*it).first.c_str(), acpu, d._node, d._socket, d._core, d._smt);
+    }
+}
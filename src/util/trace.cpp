@@ -32,6 +32,7 @@
  */
 
 #include "util/trace.h"              /* for prototypes */
+#include "util/btrace.h"
 #include "util/sync.h"
 
 #include "k_defines.h"
@@ -76,6 +77,15 @@ static void trace_stream(FILE* out_stream,
 static unsigned int trace_current_setting = ~0u;
 
 
+/**
+ *  @brief Types that are output for the user (results, statistics,
+ *  shell replies). They are always printed, even when the binary
+ *  tracing backend is enabled.
+ */
+static const unsigned int TRACE_TEXT_ONLY = 
+    TRACE_ALWAYS | TRACE_STATISTICS | TRACE_QUERY_RESULTS;
+
+
 
 /* definitions of exported functions */
 
@@ -115,8 +125,11 @@ void tracer::operator()(unsigned int trace_type, char const* format, ...)
     va_list ap;
     va_start(ap, format);
   
-    /* currently, we only support printing to streams */
-    trace_stream(stdout, _file, _line, _function, format, ap);
+    /* either append a binary record to the thread's ring, or print */
+    if (btrace_enabled() && !(trace_type & TRACE_TEXT_ONLY))
+        btrace_log(trace_type, _file, _line, _function, format, ap);
+    else
+        trace_stream(stdout, _file, _line, _function, format, ap);
 
     va_end(ap);
     return;
@@ -0,0 +1,188 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   ch_input.cpp
+ *
+ *  @brief:  Implementation of the CH-benCHmark query input and of the
+ *           generated SUPPLIER, NATION and REGION tables
+ *
+ */
+
+#include "workload/ch/ch_input.h"
+
+#include <cstring>
+#include <cctype>
+
+
+ENTER_NAMESPACE(ch);
+
+
+
+/* ------------------------- */
+/* --- NATION and REGION --- */
+/* ------------------------- */
+
+static const char* ch_regions[CH_REGIONS] = {
+    "Africa", "America", "Asia", "Europe", "Middle East"
+};
+
+struct ch_nation_t
+{
+    const char* _name;
+    int         _region;
+};
+
+// Nation i has key ch_nation_chars[i]
+static const char ch_nation_chars[] =
+    "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+
+static const ch_nation_t ch_nations[CH_NATIONS] = {
+    { "Algeria", 0 },        { "Egypt", 0 },          { "Ethiopia", 0 },
+    { "Kenya", 0 },          { "Morocco", 0 },        { "Mozambique", 0 },
+    { "Nigeria", 0 },        { "South Africa", 0 },   { "Tanzania", 0 },
+    { "Tunisia", 0 },        { "Ghana", 0 },          { "Senegal", 0 },
+    { "Argentina", 1 },      { "Brazil", 1 },         { "Canada", 1 },
+    { "Chile", 1 },          { "Colombia", 1 },       { "Mexico", 1 },
+    { "Peru", 1 },           { "United States", 1 },  { "Venezuela", 1 },
+    { "Uruguay", 1 },        { "Ecuador", 1 },        { "Bolivia", 1 },
+    { "Cuba", 1 },           { "Cambodia", 2 },       { "China", 2 },
+    { "India", 2 },          { "Indonesia", 2 },      { "Japan", 2 },
+    { "Vietnam", 2 },        { "Thailand", 2 },       { "Malaysia", 2 },
+    { "Philippines", 2 },    { "Korea", 2 },          { "Pakistan", 2 },
+    { "Bangladesh", 2 },     { "Singapore", 2 },      { "Germany", 3 },
+    { "France", 3 },         { "Romania", 3 },        { "Russia", 3 },
+    { "United Kingdom", 3 }, { "Italy", 3 },          { "Spain", 3 },
+    { "Poland", 3 },         { "Greece", 3 },         { "Portugal", 3 },
+    { "Sweden", 3 },         { "Norway", 3 },         { "Switzerland", 3 },
+    { "Iran", 4 },           { "Iraq", 4 },           { "Jordan", 4 },
+    { "Saudi Arabia", 4 },   { "Israel", 4 },         { "Lebanon", 4 },
+    { "Syria", 4 },          { "Oman", 4 },           { "Kuwait", 4 },
+    { "Qatar", 4 },          { "Yemen", 4 }
+};
+
+
+int ch_nation_key(const int nation)
+{
+    assert ((nation>=0) && (nation<CH_NATIONS));
+    return ((int)ch_nation_chars[nation]);
+}
+
+int ch_nation_of_key(const int nationkey)
+{
+    const char* pos = (nationkey > 0 ? strchr(ch_nation_chars, nationkey) : NULL);
+    return (pos ? (int)(pos - ch_nation_chars) : -1);
+}
+
+const char* ch_nation_name(const int nation)
+{
+    assert ((nation>=0) && (nation<CH_NATIONS));
+    return (ch_nations[nation]._name);
+}
+
+int ch_nation_region(const int nation)
+{
+    assert ((nation>=0) && (nation<CH_NATIONS));
+    return (ch_nations[nation]._region);
+}
+
+const char* ch_region_name(const int region)
+{
+    assert ((region>=0) && (region<CH_REGIONS));
+    return (ch_regions[region]);
+}
+
+int ch_find_nation(const char* name)
+{
+    for (int i=0; i<CH_NATIONS; i++) {
+        if (strcmp(ch_nations[i]._name, name) == 0) return (i);
+    }
+    return (-1);
+}
+
+int ch_find_region(const char* name)
+{
+    for (int i=0; i<CH_REGIONS; i++) {
+        if (strcmp(ch_regions[i], name) == 0) return (i);
+    }
+    return (-1);
+}
+
+
+
+/* ---------------- */
+/* --- SUPPLIER --- */
+/* ---------------- */
+
+int ch_supplier_nation(const int suppkey)
+{
+    return (suppkey % CH_NATIONS);
+}
+
+// Roughly 1 every 200 suppliers has a comment with "bad" in it
+bool ch_supplier_is_bad(const int suppkey)
+{
+    return ((suppkey % 200) == 17);
+}
+
+int ch_customer_nation(const char* c_state)
+{
+    assert (c_state);
+    return (ch_nation_of_key((unsigned char)c_state[0]));
+}
+
+
+
+/* ------------------- */
+/* --- QUERY INPUT --- */
+/* ------------------- */
+
+ch_query_input_t& ch_query_input_t::operator=(const ch_query_input_t& rhs)
+{
+    _wh_cnt  = rhs._wh_cnt;
+    _d1999   = rhs._d1999;
+    _d2007   = rhs._d2007;
+    _d2010   = rhs._d2010;
+    _d2012   = rhs._d2012;
+    _d2020   = rhs._d2020;
+    _min_qty = rhs._min_qty;
+    _max_qty = rhs._max_qty;
+    return (*this);
+}
+
+
+ch_query_input_t create_ch_query_input(const double sf, const int /* specificWH */)
+{
+    ch_query_input_t chin;
+    chin._wh_cnt  = (sf < 1 ? 1 : (int)sf);
+    chin._d1999   = str_to_timet("1999-01-01");
+    chin._d2007   = str_to_timet("2007-01-02");
+    chin._d2010   = str_to_timet("2010-05-23") + 12*3600;
+    chin._d2012   = str_to_timet("2012-01-02");
+    chin._d2020   = str_to_timet("2020-01-01");
+    chin._min_qty = 1;
+    chin._max_qty = 100000;
+    return (chin);
+}
+
+
+EXIT_NAMESPACE(ch);
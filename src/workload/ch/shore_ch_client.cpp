@@ -0,0 +1,164 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   shore_ch_client.cpp
+ *
+ *  @brief:  Implementation of the client for the CH-benCHmark
+ *
+ */
+
+#include "workload/ch/shore_ch_client.h"
+
+ENTER_NAMESPACE(ch);
+
+
+/********************************************************************* 
+ *
+ *  baseline_ch_client_t
+ *
+ *********************************************************************/
+
+
+baseline_ch_client_t::baseline_ch_client_t(c_str tname, const int id, 
+                                           ShoreCHEnv* env, 
+                                           const MeasurementType aType, 
+                                           const int trxid, 
+                                           const int numOfTrxs, 
+                                           processorid_t aprsid, 
+                                           const int sWH, const double qf) 
+    : base_client_t(tname,id,env,aType,trxid,numOfTrxs,aprsid),
+      _wh(sWH), _qf(qf), _chenv(env)
+{
+    assert (env);
+    assert (_wh>=0 && _qf>0);
+    
+    // pick worker threads
+    _worker = _env->worker(_id);
+    assert (_worker);
+    _olap_worker = _chenv->olap_worker(_id);
+    assert (_olap_worker);
+
+    // the role in the HTAP mix, and where the query stream starts
+    _bOlap = _chenv->is_olap_client(_id);
+    _next_query = _id % CH_QUERIES;
+}
+
+
+int baseline_ch_client_t::load_sup_xct(mapSupTrxs& stmap)
+{
+    // clears the supported trx map and loads its own
+    stmap.clear();
+
+    // The mixes
+    stmap[XCT_CH_HTAP]      = "CH-HTAP";
+    stmap[XCT_CH_QUERY_MIX] = "CH-QueryMix";
+
+    // Baseline TPC-C trxs
+    stmap[XCT_MIX]          = "TPCC-Mix";
+    stmap[XCT_NEW_ORDER]    = "TPCC-NewOrder";
+    stmap[XCT_PAYMENT]      = "TPCC-Payment";
+    stmap[XCT_ORDER_STATUS] = "TPCC-OrderStatus";
+    stmap[XCT_DELIVERY]     = "TPCC-Delivery";
+    stmap[XCT_STOCK_LEVEL]  = "TPCC-StockLevel";
+
+    // The analytical queries
+    stmap[XCT_CH_Q1]        = "CH-Q1";
+    stmap[XCT_CH_Q2]        = "CH-Q2";
+    stmap[XCT_CH_Q3]        = "CH-Q3";
+    stmap[XCT_CH_Q4]        = "CH-Q4";
+    stmap[XCT_CH_Q5]        = "CH-Q5";
+    stmap[XCT_CH_Q6]        = "CH-Q6";
+    stmap[XCT_CH_Q7]        = "CH-Q7";
+    stmap[XCT_CH_Q8]        = "CH-Q8";
+    stmap[XCT_CH_Q9]        = "CH-Q9";
+    stmap[XCT_CH_Q10]       = "CH-Q10";
+    stmap[XCT_CH_Q11]       = "CH-Q11";
+    stmap[XCT_CH_Q12]       = "CH-Q12";
+    stmap[XCT_CH_Q13]       = "CH-Q13";
+    stmap[XCT_CH_Q14]       = "CH-Q14";
+    stmap[XCT_CH_Q15]       = "CH-Q15";
+    stmap[XCT_CH_Q16]       = "CH-Q16";
+    stmap[XCT_CH_Q17]       = "CH-Q17";
+    stmap[XCT_CH_Q18]       = "CH-Q18";
+    stmap[XCT_CH_Q19]       = "CH-Q19";
+    stmap[XCT_CH_Q20]       = "CH-Q20";
+    stmap[XCT_CH_Q21]       = "CH-Q21";
+    stmap[XCT_CH_Q22]       = "CH-Q22";
+
+    return (stmap.size());
+}
+
+
+/********************************************************************* 
+ *
+ *  @fn:    submit_one
+ *
+ *  @brief: Entry point for running one TPC-C xct or CH query
+ *
+ *  @note:  The execution of this trx will not be stopped even if the
+ *          measure internal has expired.
+ *
+ *********************************************************************/
+ 
+w_rc_t baseline_ch_client_t::submit_one(int xct_type, int xctid) 
+{    
+    // Resolve the mixes
+    int atype = xct_type;
+    if ((xct_type == XCT_CH_QUERY_MIX) || 
+        ((xct_type == XCT_CH_HTAP) && _bOlap)) {
+        atype = XCT_CH_Q1 + _next_query;
+        _next_query = (_next_query + 1) % CH_QUERIES;
+    }
+    else if (xct_type == XCT_CH_HTAP) {
+        atype = XCT_MIX;
+    }
+
+    // Set input
+    trx_result_tuple_t atrt;
+    bool bWake = false;
+    if (completion_queue_t* c = _cq->take_one()) {
+        atrt.set_notify(c);
+        TRACE( TRACE_TRX_FLOW, "Sleeping\n");
+        bWake = true;
+    }
+
+    // Pick a valid WH
+    int whid = _wh;
+    if (_wh==0) 
+        whid = URand(1,_qf); 
+
+    // Get one action from the trash stack
+    trx_request_t* arequest = new (_env->_request_pool) trx_request_t;
+    tid_t atid;
+    arequest->set(NULL,atid,xctid,atrt,atype,whid);    
+
+    // Enqueue to the analytical or the TPC-C worker thread
+    trx_worker_t* aworker = (is_ch_query(atype) ? _olap_worker : _worker);
+    assert (aworker);
+    aworker->enqueue(arequest,bWake);
+    return (RCOK);
+}
+
+
+
+EXIT_NAMESPACE(ch);
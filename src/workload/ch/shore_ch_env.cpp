@@ -0,0 +1,220 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   shore_ch_env.cpp
+ *
+ *  @brief:  Declaration of the Shore CH-benCHmark environment
+ *
+ */
+
+#include "workload/ch/shore_ch_env.h"
+
+
+ENTER_NAMESPACE(ch);
+
+
+
+/******************************************************************** 
+ *
+ *  ShoreCHEnv functions
+ *
+ ********************************************************************/ 
+
+ShoreCHEnv::ShoreCHEnv()
+    : ShoreTPCCEnv(), _olap_worker_cnt(0), _olap_ratio(0)
+{
+}
+
+ShoreCHEnv::~ShoreCHEnv() 
+{ 
+}
+
+
+
+/******************************************************************** 
+ *
+ *  @fn:    Related to the analytical workers and clients
+ *
+ *  @brief: The analytical queries have their own set of workers
+ *
+ ********************************************************************/
+
+uint ShoreCHEnv::upd_olap_worker_cnt()
+{
+    envVar* ev = envVar::instance();
+    int workers = ev->getVarInt("ch-olap-workers",4);
+    if (workers < 1) workers = 1;
+    _olap_worker_cnt = workers;
+
+    _olap_ratio = ev->getVarInt("ch-olap-ratio",10);
+    if (_olap_ratio < 0) _olap_ratio = 0;
+    if (_olap_ratio > 100) _olap_ratio = 100;
+    return (_olap_worker_cnt);
+}
+
+
+trx_worker_t* ShoreCHEnv::olap_worker(const uint idx)
+{
+    assert (_olap_worker_cnt);
+    return (_olap_workers[idx%_olap_worker_cnt]);
+}
+
+
+/******************************************************************** 
+ *
+ *  @fn:    is_olap_client
+ *
+ *  @brief: Spreads the analytical clients evenly over the client ids,
+ *          so that any number of clients gets (close to) the ratio.
+ *          E.g. with a ratio of 25, clients 3, 7, 11, ... are analytical.
+ *
+ ********************************************************************/
+
+bool ShoreCHEnv::is_olap_client(const int id) const
+{
+    return ((((id+1)*_olap_ratio)/100) > ((id*_olap_ratio)/100));
+}
+
+
+
+/******************************************************************** 
+ *
+ *  @fn:    info()
+ *
+ *  @brief: Prints information about the current db instance status
+ *
+ ********************************************************************/
+
+int ShoreCHEnv::info() const
+{
+    ShoreTPCCEnv::info();
+    TRACE( TRACE_ALWAYS, "OLAP Workers = (%d)\n", _olap_worker_cnt);
+    TRACE( TRACE_ALWAYS, "OLAP Ratio   = (%d%%)\n", _olap_ratio);
+    return (0);
+}
+
+
+
+/******************************************************************** 
+ *
+ *  @fn:    statistics
+ *
+ *  @brief: Prints statistics for the analytical queries, then the 
+ *          TPC-C ones
+ *
+ ********************************************************************/
+
+int ShoreCHEnv::statistics() 
+{
+    {
+        // read the current query statistics
+        CRITICAL_SECTION(cs, _statmap_mutex);
+        ShoreCHTrxStats rval;
+        rval -= rval; // dirty hack to set all zeros
+        for (ch_statmap_t::iterator it=_ch_statmap.begin(); 
+             it != _ch_statmap.end(); ++it) 
+            rval += *it->second;
+
+        const uint* patt = &rval.attempted.ch_q1;
+        const uint* pabt = &rval.failed.ch_q1;
+        const uint* pdld = &rval.deadlocked.ch_q1;
+        for (int q=0; q<CH_QUERIES; q++) {
+            if (patt[q] == 0) continue;
+            TRACE( TRACE_STATISTICS, "CH-Q%d. Att (%d). Abt (%d). Dld (%d)\n",
+                   q+1, patt[q], pabt[q], pdld[q]);
+        }
+    }
+
+    return (ShoreTPCCEnv::statistics());
+}
+
+
+
+/******************************************************************** 
+ *
+ *  @fn:    conf
+ *
+ *  @brief: Rereads the TPC-C and the CH parameters
+ *
+ ********************************************************************/
+
+int ShoreCHEnv::conf()
+{
+    ShoreTPCCEnv::conf();
+    upd_olap_worker_cnt();
+    return (0);
+}
+
+
+
+/******************************************************************** 
+ *
+ *  @fn:    start/stop
+ *
+ *  @brief: Start/stop the TPC-C workers and the analytical ones
+ *
+ ********************************************************************/
+
+int ShoreCHEnv::start()
+{
+    upd_olap_worker_cnt();
+
+    int rv = ShoreTPCCEnv::start();
+    if (rv) return (rv);
+
+    assert (_olap_workers.empty());
+
+    // read from env params the loopcnt
+    int lc = envVar::instance()->getVarInt("db-worker-queueloops",0);    
+
+    WorkerPtr aworker;
+    for (uint i=0; i<_olap_worker_cnt; i++) {
+        aworker = new Worker(this,c_str("olap-%d", i),PBIND_NONE,_bUseSLI);
+        _olap_workers.push_back(aworker);
+        aworker->init(lc);
+        aworker->start();
+        aworker->fork();
+    }
+    return (0);
+}
+
+
+int ShoreCHEnv::stop()
+{
+    int i=0;
+    for (WorkerIt it = _olap_workers.begin(); it != _olap_workers.end(); ++it) {
+        i++;
+        TRACE( TRACE_DEBUG, "Stopping olap worker (%d)\n", i);
+        if (*it) {
+            (*it)->stop();
+            (*it)->join();
+            delete (*it);
+        }
+    }
+    _olap_workers.clear();
+
+    return (ShoreTPCCEnv::stop());
+}
+
+
+EXIT_NAMESPACE(ch);
@@ -0,0 +1,1950 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   shore_ch_xct.cpp
+ *
+ *  @brief:  Implementation of the Baseline CH-benCHmark queries
+ *
+ *  @note:   The queries are evaluated with file scans and in-memory hash
+ *           (map) joins and aggregations, like the Baseline TPC-H ones.
+ *
+ *           The joins with STOCK that only derive the supplier key
+ *           (mod(s_w_id*s_i_id,10000)) always match exactly one STOCK
+ *           row, so they are not executed; the key is computed from the
+ *           ORDER_LINE columns. STOCK is scanned by the queries that use
+ *           its columns (Q2, Q11, Q16, Q20).
+ */
+
+#include "workload/ch/shore_ch_env.h"
+
+#include <vector>
+#include <map>
+#include <set>
+#include <string>
+#include <algorithm>
+
+using std::vector;
+using std::map;
+using std::set;
+using std::string;
+
+
+ENTER_NAMESPACE(ch);
+
+
+
+/********************************************************************
+ *
+ * Thread-local CH query stats
+ *
+ ********************************************************************/
+
+
+static __thread ShoreCHTrxStats my_stats;
+
+void ShoreCHEnv::env_thread_init()
+{
+    ShoreTPCCEnv::env_thread_init();
+    CRITICAL_SECTION(stat_mutex_cs, _statmap_mutex);
+    _ch_statmap[pthread_self()] = &my_stats;
+}
+
+void ShoreCHEnv::env_thread_fini()
+{
+    ShoreTPCCEnv::env_thread_fini();
+    CRITICAL_SECTION(stat_mutex_cs, _statmap_mutex);
+    _ch_statmap.erase(pthread_self());
+}
+
+
+/********************************************************************
+ *
+ *  @fn:    _get_ch_stats
+ *
+ *  @brief: Returns a structure with the current query stats
+ *
+ ********************************************************************/
+
+ShoreCHTrxStats ShoreCHEnv::_get_ch_stats()
+{
+    CRITICAL_SECTION(cs, _statmap_mutex);
+    ShoreCHTrxStats rval;
+    rval -= rval; // dirty hack to set all zeros
+    for (ch_statmap_t::iterator it=_ch_statmap.begin(); it != _ch_statmap.end(); ++it)
+	rval += *it->second;
+    return (rval);
+}
+
+
+/********************************************************************
+ *
+ *  @fn:    reset_stats
+ *
+ *  @brief: Updates the last gathered statistics, of both sides
+ *
+ ********************************************************************/
+
+void ShoreCHEnv::reset_stats()
+{
+    ShoreTPCCEnv::reset_stats();
+    CRITICAL_SECTION(last_stats_cs, _last_stats_mutex);
+    _last_ch_stats = _get_ch_stats();
+}
+
+
+/********************************************************************
+ *
+ *  @fn:    print_throughput
+ *
+ *  @brief: Prints the TPC-C (tpm-C) and the analytical (QphH)
+ *          throughput of the same measurement side by side
+ *
+ ********************************************************************/
+
+void ShoreCHEnv::print_throughput(const double iQueriedSF,
+                                  const int iSpread,
+                                  const int iNumOfThreads,
+                                  const double delay,
+                                  const ulong_t mioch,
+                                  const double avgcpuusage)
+{
+    CRITICAL_SECTION(last_stats_cs, _last_stats_mutex);
+
+    // get the current statistics, and the diff
+    ShoreTPCCTrxStats current_stats = _get_stats();
+    current_stats -= _last_stats;
+    ShoreCHTrxStats current_ch_stats = _get_ch_stats();
+    current_ch_stats -= _last_ch_stats;
+
+    uint trxs_att  = current_stats.attempted.total();
+    uint trxs_abt  = current_stats.failed.total();
+    uint trxs_dld  = current_stats.deadlocked.total();
+    int nords_com = current_stats.attempted.new_order - current_stats.failed.new_order - current_stats.deadlocked.new_order;
+
+    uint qs_att = current_ch_stats.attempted.total();
+    uint qs_abt = current_ch_stats.failed.total();
+    uint qs_dld = current_ch_stats.deadlocked.total();
+    uint qs_com = qs_att - qs_abt - qs_dld;
+
+    int olap_threads = 0;
+    for (int i=0; i<iNumOfThreads; i++) {
+        if (is_olap_client(i)) olap_threads++;
+    }
+
+    TRACE( TRACE_ALWAYS, "*******\n"                \
+           "QueriedSF: (%.1f)\n"                    \
+           "Spread:    (%s)\n"                      \
+           "Threads:   (%d) (%d OLAP in HTAP)\n"    \
+           "Secs:      (%.2f)\n"                    \
+           "IOChars:   (%.2fM/s)\n"                 \
+           "AvgCPUs:   (%.1f) (%.1f%%)\n"           \
+           "-- OLTP --\n"                           \
+           "Trxs Att:  (%d)\n"                      \
+           "Trxs Abt:  (%d)\n"                      \
+           "Trxs Dld:  (%d)\n"                      \
+           "NOrd Com:  (%d)\n"                      \
+           "TPS:       (%.2f)\n"                    \
+           "tpm-C:     (%.2f)\n"                    \
+           "-- OLAP --\n"                           \
+           "Qs Att:    (%d)\n"                      \
+           "Qs Abt:    (%d)\n"                      \
+           "Qs Dld:    (%d)\n"                      \
+           "Qs Com:    (%d)\n"                      \
+           "QphH:      (%.2f)\n",
+           iQueriedSF,
+           (iSpread ? "Yes" : "No"),
+           iNumOfThreads, olap_threads,
+           delay, mioch/delay, avgcpuusage,
+           100*avgcpuusage/get_max_cpu_count(),
+           trxs_att, trxs_abt, trxs_dld, nords_com,
+           (trxs_att-trxs_abt-trxs_dld)/delay,
+           60*nords_com/delay,
+           qs_att, qs_abt, qs_dld, qs_com,
+           3600*qs_com/delay);
+}
+
+
+
+
+/********************************************************************
+ *
+ * CH-benCHmark QUERIES (TRXS)
+ *
+ * (1) The run_XXX functions are wrappers to the real transactions
+ * (2) The xct_XXX functions are the implementation of the transactions
+ *
+ ********************************************************************/
+
+
+/*********************************************************************
+ *
+ *  @fn:    run_one_xct
+ *
+ *  @brief: Baseline client - Entry point for running one query, or
+ *          one TPC-C trx
+ *
+ *  @note:  The execution of this trx will not be stopped even if the
+ *          measure internal has expired.
+ *
+ *********************************************************************/
+
+w_rc_t ShoreCHEnv::run_one_xct(Request* prequest)
+{
+    // if CH query mix
+    if (prequest->type() == XCT_CH_QUERY_MIX) {
+        prequest->set_type(XCT_CH_Q1 + smthread_t::rand()%CH_QUERIES);
+    }
+
+    switch (prequest->type()) {
+
+    case XCT_CH_Q1:
+        return (run_ch_q1(prequest));
+
+    case XCT_CH_Q2:
+        return (run_ch_q2(prequest));
+
+    case XCT_CH_Q3:
+        return (run_ch_q3(prequest));
+
+    case XCT_CH_Q4:
+        return (run_ch_q4(prequest));
+
+    case XCT_CH_Q5:
+        return (run_ch_q5(prequest));
+
+    case XCT_CH_Q6:
+        return (run_ch_q6(prequest));
+
+    case XCT_CH_Q7:
+        return (run_ch_q7(prequest));
+
+    case XCT_CH_Q8:
+        return (run_ch_q8(prequest));
+
+    case XCT_CH_Q9:
+        return (run_ch_q9(prequest));
+
+    case XCT_CH_Q10:
+        return (run_ch_q10(prequest));
+
+    case XCT_CH_Q11:
+        return (run_ch_q11(prequest));
+
+    case XCT_CH_Q12:
+        return (run_ch_q12(prequest));
+
+    case XCT_CH_Q13:
+        return (run_ch_q13(prequest));
+
+    case XCT_CH_Q14:
+        return (run_ch_q14(prequest));
+
+    case XCT_CH_Q15:
+        return (run_ch_q15(prequest));
+
+    case XCT_CH_Q16:
+        return (run_ch_q16(prequest));
+
+    case XCT_CH_Q17:
+        return (run_ch_q17(prequest));
+
+    case XCT_CH_Q18:
+        return (run_ch_q18(prequest));
+
+    case XCT_CH_Q19:
+        return (run_ch_q19(prequest));
+
+    case XCT_CH_Q20:
+        return (run_ch_q20(prequest));
+
+    case XCT_CH_Q21:
+        return (run_ch_q21(prequest));
+
+    case XCT_CH_Q22:
+        return (run_ch_q22(prequest));
+
+    default:
+        // the TPC-C transactions
+        return (ShoreTPCCEnv::run_one_xct(prequest));
+    }
+    return (RCOK);
+}
+
+
+/********************************************************************
+ *
+ * CH TRXs Wrappers
+ *
+ * @brief: They are wrappers to the functions that execute the transaction
+ *         body. Their responsibility is to:
+ *
+ *         1. Prepare the corresponding input
+ *         2. Check the return of the trx function and abort the trx,
+ *            if something went wrong
+ *         3. Update the ch db environment statistics
+ *
+ ********************************************************************/
+
+DEFINE_TRX(ShoreCHEnv,ch_q1);
+DEFINE_TRX(ShoreCHEnv,ch_q2);
+DEFINE_TRX(ShoreCHEnv,ch_q3);
+DEFINE_TRX(ShoreCHEnv,ch_q4);
+DEFINE_TRX(ShoreCHEnv,ch_q5);
+DEFINE_TRX(ShoreCHEnv,ch_q6);
+DEFINE_TRX(ShoreCHEnv,ch_q7);
+DEFINE_TRX(ShoreCHEnv,ch_q8);
+DEFINE_TRX(ShoreCHEnv,ch_q9);
+DEFINE_TRX(ShoreCHEnv,ch_q10);
+DEFINE_TRX(ShoreCHEnv,ch_q11);
+DEFINE_TRX(ShoreCHEnv,ch_q12);
+DEFINE_TRX(ShoreCHEnv,ch_q13);
+DEFINE_TRX(ShoreCHEnv,ch_q14);
+DEFINE_TRX(ShoreCHEnv,ch_q15);
+DEFINE_TRX(ShoreCHEnv,ch_q16);
+DEFINE_TRX(ShoreCHEnv,ch_q17);
+DEFINE_TRX(ShoreCHEnv,ch_q18);
+DEFINE_TRX(ShoreCHEnv,ch_q19);
+DEFINE_TRX(ShoreCHEnv,ch_q20);
+DEFINE_TRX(ShoreCHEnv,ch_q21);
+DEFINE_TRX(ShoreCHEnv,ch_q22);
+
+
+
+/********************************************************************
+ *
+ * Helpers shared by the queries
+ *
+ ********************************************************************/
+
+// (w,d,o) of an order and (w,d,c) of a customer
+typedef unsigned long long ch_key_t;
+
+static inline ch_key_t ch_key(const int w, const int d, const int id)
+{
+    return ((((ch_key_t)w*16 + d) << 32) | (ch_key_t)id);
+}
+
+static inline int ch_year(const double tstamp)
+{
+    time_t t = (time_t)tstamp;
+    struct tm atm;
+    localtime_r(&t, &atm);
+    return (atm.tm_year + 1900);
+}
+
+static inline bool ch_ends_with(const char* s, const char* suffix)
+{
+    uint_t len = strlen(s);
+    uint_t slen = strlen(suffix);
+    return ((len >= slen) && (strcmp(s + len - slen, suffix) == 0));
+}
+
+static inline bool ch_starts_with(const char* s, const char* prefix)
+{
+    return (strncmp(s, prefix, strlen(prefix)) == 0);
+}
+
+static inline void ch_supplier_name(const int suppkey, char* buf)
+{
+    sprintf(buf, "Supplier#%09d", suppkey);
+}
+
+
+// Opens a file scan over a table
+template <class TableDesc, class Manager>
+static w_rc_t ch_open_scan(ss_m* db, Manager* pmanager,
+                           guard< table_scan_iter_impl<TableDesc> >& iter)
+{
+    table_scan_iter_impl<TableDesc>* tmp_iter;
+    W_DO(pmanager->get_iter_for_file_scan(db, tmp_iter));
+    iter = tmp_iter;
+    return (RCOK);
+}
+
+
+// The decoded fields of the ITEM rows, indexed by I_ID
+struct ch_item_t
+{
+    bool _valid;
+    int  _price;
+    char _name[25];
+    char _data[51];
+};
+
+
+static w_rc_t ch_load_items(ShoreCHEnv* env, ss_m* db, vector<ch_item_t>& items)
+{
+    tuple_guard<item_man_impl> pritem(env->item_man());
+    rep_row_t areprow(env->item_man()->ts());
+    areprow.set(env->item_desc()->maxsize());
+    pritem->_rep = &areprow;
+
+    items.clear();
+    items.resize(ITEMS+1);
+    for (uint_t i=0; i<items.size(); i++) items[i]._valid = false;
+
+    guard< table_scan_iter_impl<item_t> > i_iter;
+    W_DO(ch_open_scan(db, env->item_man(), i_iter));
+    bool eof;
+    W_DO(i_iter->next(db, eof, *pritem));
+    while (!eof) {
+        int i_id = item_row_t::get_I_ID(pritem);
+        if ((i_id > 0) && (i_id < (int)items.size())) {
+            ch_item_t& aitem = items[i_id];
+            aitem._valid = true;
+            aitem._price = item_row_t::get_I_PRICE(pritem);
+            item_row_t::get_I_NAME(pritem, aitem._name);
+            item_row_t::get_I_DATA(pritem, aitem._data);
+        }
+        W_DO(i_iter->next(db, eof, *pritem));
+    }
+    return (RCOK);
+}
+
+
+// The decoded fields of the ORDER rows
+struct ch_order_t
+{
+    int    _c_id;
+    double _entry_d;
+    int    _carrier_id;
+    int    _ol_cnt;
+};
+
+typedef map<ch_key_t, ch_order_t> ch_order_map;
+
+
+// The orders with o_entry_d in [lo,hi]
+static w_rc_t ch_load_orders(ShoreCHEnv* env, ss_m* db, ch_order_map& orders,
+                             const double lo, const double hi)
+{
+    tuple_guard<order_man_impl> prord(env->order_man());
+    rep_row_t areprow(env->order_man()->ts());
+    areprow.set(env->order_desc()->maxsize());
+    prord->_rep = &areprow;
+
+    guard< table_scan_iter_impl<order_t> > o_iter;
+    W_DO(ch_open_scan(db, env->order_man(), o_iter));
+    bool eof;
+    W_DO(o_iter->next(db, eof, *prord));
+    ch_order_t aorder;
+    while (!eof) {
+        aorder._entry_d = order_row_t::get_O_ENTRY_D(prord);
+        if ((aorder._entry_d >= lo) && (aorder._entry_d <= hi)) {
+            aorder._c_id       = order_row_t::get_O_C_ID(prord);
+            aorder._carrier_id = order_row_t::get_O_CARRIER_ID(prord);
+            aorder._ol_cnt     = order_row_t::get_O_OL_CNT(prord);
+            orders[ch_key(order_row_t::get_O_W_ID(prord),
+                          order_row_t::get_O_D_ID(prord),
+                          order_row_t::get_O_ID(prord))] = aorder;
+        }
+        W_DO(o_iter->next(db, eof, *prord));
+    }
+    return (RCOK);
+}
+
+
+// The decoded fields of the CUSTOMER rows
+struct ch_customer_t
+{
+    int    _c_id;
+    int    _nation;
+    char   _state[3];
+    char   _last[17];
+    char   _city[21];
+    char   _phone[17];
+    double _balance;
+};
+
+typedef map<ch_key_t, ch_customer_t> ch_customer_map;
+
+
+static w_rc_t ch_load_customers(ShoreCHEnv* env, ss_m* db, ch_customer_map& custs)
+{
+    tuple_guard<customer_man_impl> prcust(env->customer_man());
+    rep_row_t areprow(env->customer_man()->ts());
+    areprow.set(env->customer_desc()->maxsize());
+    prcust->_rep = &areprow;
+
+    guard< table_scan_iter_impl<customer_t> > c_iter;
+    W_DO(ch_open_scan(db, env->customer_man(), c_iter));
+    bool eof;
+    W_DO(c_iter->next(db, eof, *prcust));
+    ch_customer_t acust;
+    while (!eof) {
+        acust._c_id = customer_row_t::get_C_ID(prcust);
+        customer_row_t::get_C_STATE(prcust, acust._state);
+        customer_row_t::get_C_LAST(prcust, acust._last);
+        customer_row_t::get_C_CITY(prcust, acust._city);
+        customer_row_t::get_C_PHONE(prcust, acust._phone);
+        acust._balance = customer_row_t::get_C_BALANCE(prcust);
+        acust._nation = ch_customer_nation(acust._state);
+        custs[ch_key(customer_row_t::get_C_W_ID(prcust),
+                     customer_row_t::get_C_D_ID(prcust),
+                     acust._c_id)] = acust;
+        W_DO(c_iter->next(db, eof, *prcust));
+    }
+    return (RCOK);
+}
+
+
+// The decoded fields of the ORDER_LINE rows
+struct ch_orderline_t
+{
+    int    _o_id;
+    int    _d_id;
+    int    _w_id;
+    int    _number;
+    int    _i_id;
+    int    _supply_w_id;
+    double _delivery_d;
+    int    _quantity;
+    int    _amount;
+
+    void fetch(table_row_t* prow) {
+        _o_id        = order_line_row_t::get_OL_O_ID(prow);
+        _d_id        = order_line_row_t::get_OL_D_ID(prow);
+        _w_id        = order_line_row_t::get_OL_W_ID(prow);
+        _number      = order_line_row_t::get_OL_NUMBER(prow);
+        _i_id        = order_line_row_t::get_OL_I_ID(prow);
+        _supply_w_id = order_line_row_t::get_OL_SUPPLY_W_ID(prow);
+        _delivery_d  = order_line_row_t::get_OL_DELIVERY_D(prow);
+        _quantity    = order_line_row_t::get_OL_QUANTITY(prow);
+        _amount      = order_line_row_t::get_OL_AMOUNT(prow);
+    }
+
+    ch_key_t okey() const { return (ch_key(_w_id, _d_id, _o_id)); }
+};
+
+
+// Scans ORDER_LINE
+class ch_ol_scan_t
+{
+private:
+    ShoreCHEnv* _env;
+    ss_m* _db;
+    tuple_guard<order_line_man_impl> _prol;
+    rep_row_t _rep;
+    guard< table_scan_iter_impl<order_line_t> > _iter;
+
+public:
+    ch_ol_scan_t(ShoreCHEnv* env, ss_m* db)
+        : _env(env), _db(db), _prol(env->order_line_man()),
+          _rep(env->order_line_man()->ts())
+    {
+        _rep.set(env->order_line_desc()->maxsize());
+        _prol->_rep = &_rep;
+    }
+
+    w_rc_t open() {
+        return (ch_open_scan(_db, _env->order_line_man(), _iter));
+    }
+
+    w_rc_t next(bool& eof, ch_orderline_t& aol) {
+        W_DO(_iter->next(_db, eof, *_prol));
+        if (!eof) aol.fetch(_prol);
+        return (RCOK);
+    }
+
+}; // EOF: ch_ol_scan_t
+
+
+
+/********************************************************************
+ *
+ * CH Q1
+ *
+ * select ol_number, sum(ol_quantity), sum(ol_amount), avg(ol_quantity),
+ *        avg(ol_amount), count(*)
+ * from order_line where ol_delivery_d > '2007-01-02'
+ * group by ol_number order by ol_number
+ *
+ ********************************************************************/
+
+struct ch_q1_value_t
+{
+    double _sum_qty;
+    double _sum_amount;
+    int    _count;
+};
+
+w_rc_t ShoreCHEnv::xct_ch_q1(const int /* xct_id */, ch_q1_input_t& in)
+{
+    // ensure a valid environment
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    map<int, ch_q1_value_t> groups;
+
+    ch_ol_scan_t ol_scan(this, _pssm);
+    W_DO(ol_scan.open());
+    bool eof;
+    ch_orderline_t aol;
+    W_DO(ol_scan.next(eof, aol));
+    while (!eof) {
+        if (aol._delivery_d > in._d2007) {
+            map<int, ch_q1_value_t>::iterator it = groups.find(aol._number);
+            if (it == groups.end()) {
+                ch_q1_value_t zero = { 0, 0, 0 };
+                it = groups.insert(std::make_pair(aol._number, zero)).first;
+            }
+            it->second._sum_qty += aol._quantity;
+            it->second._sum_amount += aol._amount;
+            it->second._count++;
+        }
+        W_DO(ol_scan.next(eof, aol));
+    }
+
+    for (map<int, ch_q1_value_t>::iterator it = groups.begin();
+         it != groups.end(); ++it) {
+        TRACE( TRACE_QUERY_RESULTS, "%d|%.0f|%.2f|%.2f|%.2f|%d\n",
+               it->first, it->second._sum_qty, it->second._sum_amount,
+               it->second._sum_qty / it->second._count,
+               it->second._sum_amount / it->second._count,
+               it->second._count);
+    }
+    return (RCOK);
+
+} // EOF: CH Q1
+
+
+
+/********************************************************************
+ *
+ * CH Q2
+ *
+ * The suppliers of Europe with the minimum stock quantity, for the
+ * items whose i_data ends with 'b'
+ *
+ ********************************************************************/
+
+struct ch_q2_row_t
+{
+    int _nation;
+    int _suppkey;
+    int _i_id;
+
+    bool operator<(const ch_q2_row_t& rhs) const {
+        int c = strcmp(ch_nation_name(_nation), ch_nation_name(rhs._nation));
+        if (c != 0) return (c < 0);
+        if (_suppkey != rhs._suppkey) return (_suppkey < rhs._suppkey);
+        return (_i_id < rhs._i_id);
+    }
+};
+
+w_rc_t ShoreCHEnv::xct_ch_q2(const int /* xct_id */, ch_q2_input_t& /* in */)
+{
+    // ensure a valid environment
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    const int europe = ch_find_region("Europe");
+
+    vector<ch_item_t> items;
+    W_DO(ch_load_items(this, _pssm, items));
+
+    // 1. The minimum quantity per item over the European suppliers, and
+    //    the candidate stock rows
+    map<int, int> min_qty;
+    vector< std::pair<ch_q2_row_t,int> > candidates;
+
+    tuple_guard<stock_man_impl> prst(_pstock_man);
+    rep_row_t areprow(_pstock_man->ts());
+    areprow.set(_pstock_desc->maxsize());
+    prst->_rep = &areprow;
+
+    guard< table_scan_iter_impl<stock_t> > s_iter;
+    W_DO(ch_open_scan(_pssm, stock_man(), s_iter));
+    bool eof;
+    W_DO(s_iter->next(_pssm, eof, *prst));
+    while (!eof) {
+        int s_i_id = stock_row_t::get_S_I_ID(prst);
+        int s_w_id = stock_row_t::get_S_W_ID(prst);
+        int suppkey = ch_supplier_of(s_w_id, s_i_id);
+        int nation = ch_supplier_nation(suppkey);
+        if ((ch_nation_region(nation) == europe) &&
+            (s_i_id < (int)items.size()) && items[s_i_id]._valid &&
+            ch_ends_with(items[s_i_id]._data, "b"))
+            {
+                int qty = stock_row_t::get_S_QUANTITY(prst);
+                map<int, int>::iterator it = min_qty.find(s_i_id);
+                if (it == min_qty.end()) min_qty[s_i_id] = qty;
+                else if (qty < it->second) it->second = qty;
+
+                ch_q2_row_t arow = { nation, suppkey, s_i_id };
+                candidates.push_back(std::make_pair(arow, qty));
+            }
+        W_DO(s_iter->next(_pssm, eof, *prst));
+    }
+
+    // 2. Keep the rows with the minimum quantity
+    vector<ch_q2_row_t> result;
+    for (uint_t i=0; i<candidates.size(); i++) {
+        if (candidates[i].second == min_qty[candidates[i].first._i_id])
+            result.push_back(candidates[i].first);
+    }
+    std::sort(result.begin(), result.end());
+
+    char sname[32];
+    for (uint_t i=0; i<result.size(); i++) {
+        ch_supplier_name(result[i]._suppkey, sname);
+        TRACE( TRACE_QUERY_RESULTS, "%d|%s|%s|%d|%s\n",
+               result[i]._suppkey, sname, ch_nation_name(result[i]._nation),
+               result[i]._i_id, items[result[i]._i_id]._name);
+    }
+    return (RCOK);
+
+} // EOF: CH Q2
+
+
+
+/********************************************************************
+ *
+ * CH Q3
+ *
+ * The revenue of the new (undelivered) orders of the customers of the
+ * states starting with 'A'
+ *
+ ********************************************************************/
+
+struct ch_q3_row_t
+{
+    ch_key_t _okey;
+    double   _entry_d;
+    double   _revenue;
+
+    bool operator<(const ch_q3_row_t& rhs) const {
+        if (_revenue != rhs._revenue) return (_revenue > rhs._revenue);
+        return (_entry_d < rhs._entry_d);
+    }
+};
+
+w_rc_t ShoreCHEnv::xct_ch_q3(const int /* xct_id */, ch_q3_input_t& in)
+{
+    // ensure a valid environment
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    // 1. The customers
+    ch_customer_map custs;
+    W_DO(ch_load_customers(this, _pssm, custs));
+
+    // 2. The new orders
+    set<ch_key_t> neworders;
+    {
+        tuple_guard<new_order_man_impl> prno(_pnew_order_man);
+        rep_row_t areprow(_pnew_order_man->ts());
+        areprow.set(_pnew_order_desc->maxsize());
+        prno->_rep = &areprow;
+
+        guard< table_scan_iter_impl<new_order_t> > no_iter;
+        W_DO(ch_open_scan(_pssm, new_order_man(), no_iter));
+        bool eof;
+        W_DO(no_iter->next(_pssm, eof, *prno));
+        while (!eof) {
+            neworders.insert(ch_key(new_order_row_t::get_NO_W_ID(prno),
+                                    new_order_row_t::get_NO_D_ID(prno),
+                                    new_order_row_t::get_NO_O_ID(prno)));
+            W_DO(no_iter->next(_pssm, eof, *prno));
+        }
+    }
+
+    // 3. The qualifying orders
+    ch_order_map orders;
+    W_DO(ch_load_orders(this, _pssm, orders, in._d2007 + 1, 1e18));
+    map<ch_key_t, ch_q3_row_t> groups;
+    for (ch_order_map::iterator it = orders.begin(); it != orders.end(); ++it) {
+        if (neworders.find(it->first) == neworders.end()) continue;
+        ch_key_t ckey = (it->first & ~0xFFFFFFFFULL) | it->second._c_id;
+        ch_customer_map::iterator cit = custs.find(ckey);
+        if ((cit == custs.end()) || (cit->second._state[0] != 'A')) continue;
+        ch_q3_row_t arow = { it->first, it->second._entry_d, 0 };
+        groups[it->first] = arow;
+    }
+
+    // 4. Their revenue
+    ch_ol_scan_t ol_scan(this, _pssm);
+    W_DO(ol_scan.open());
+    bool eof;
+    ch_orderline_t aol;
+    W_DO(ol_scan.next(eof, aol));
+    while (!eof) {
+        map<ch_key_t, ch_q3_row_t>::iterator it = groups.find(aol.okey());
+        if (it != groups.end()) it->second._revenue += aol._amount;
+        W_DO(ol_scan.next(eof, aol));
+    }
+
+    vector<ch_q3_row_t> result;
+    for (map<ch_key_t, ch_q3_row_t>::iterator it = groups.begin();
+         it != groups.end(); ++it)
+        result.push_back(it->second);
+    std::sort(result.begin(), result.end());
+
+    for (uint_t i=0; i<result.size(); i++) {
+        TRACE( TRACE_QUERY_RESULTS, "%d|%d|%d|%.2f|%.0f\n",
+               (int)(result[i]._okey & 0xFFFFFFFFULL),
+               (int)((result[i]._okey >> 32) / 16),
+               (int)((result[i]._okey >> 32) % 16),
+               result[i]._revenue, result[i]._entry_d);
+    }
+    return (RCOK);
+
+} // EOF: CH Q3
+
+
+
+/********************************************************************
+ *
+ * CH Q4
+ *
+ * The orders of 2007-2012 with at least one line delivered after the
+ * order entry, per number of lines
+ *
+ ********************************************************************/
+
+w_rc_t ShoreCHEnv::xct_ch_q4(const int /* xct_id */, ch_q4_input_t& in)
+{
+    // ensure a valid environment
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    ch_order_map orders;
+    W_DO(ch_load_orders(this, _pssm, orders, in._d2007, in._d2012 - 1));
+
+    set<ch_key_t> qualified;
+    ch_ol_scan_t ol_scan(this, _pssm);
+    W_DO(ol_scan.open());
+    bool eof;
+    ch_orderline_t aol;
+    W_DO(ol_scan.next(eof, aol));
+    while (!eof) {
+        ch_order_map::iterator it = orders.find(aol.okey());
+        if ((it != orders.end()) && (aol._delivery_d >= it->second._entry_d))
+            qualified.insert(it->first);
+        W_DO(ol_scan.next(eof, aol));
+    }
+
+    map<int, int> counts;
+    for (set<ch_key_t>::iterator it = qualified.begin(); it != qualified.end(); ++it)
+        counts[orders[*it]._ol_cnt]++;
+
+    for (map<int, int>::iterator it = counts.begin(); it != counts.end(); ++it)
+        TRACE( TRACE_QUERY_RESULTS, "%d|%d\n", it->first, it->second);
+    return (RCOK);
+
+} // EOF: CH Q4
+
+
+
+/********************************************************************
+ *
+ * CH Q5
+ *
+ * The revenue per European nation, of the lines whose supplier is of
+ * the same nation as the customer
+ *
+ ********************************************************************/
+
+static bool ch_revenue_desc(const std::pair<int,double>& a,
+                            const std::pair<int,double>& b)
+{
+    return (a.second > b.second);
+}
+
+w_rc_t ShoreCHEnv::xct_ch_q5(const int /* xct_id */, ch_q5_input_t& in)
+{
+    // ensure a valid environment
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    const int europe = ch_find_region("Europe");
+
+    ch_customer_map custs;
+    W_DO(ch_load_customers(this, _pssm, custs));
+
+    // the European customer nation of each qualifying order
+    ch_order_map orders;
+    W_DO(ch_load_orders(this, _pssm, orders, in._d2007, 1e18));
+    map<ch_key_t, int> onation;
+    for (ch_order_map::iterator it = orders.begin(); it != orders.end(); ++it) {
+        ch_key_t ckey = (it->first & ~0xFFFFFFFFULL) | it->second._c_id;
+        ch_customer_map::iterator cit = custs.find(ckey);
+        if ((cit == custs.end()) || (cit->second._nation < 0)) continue;
+        if (ch_nation_region(cit->second._nation) != europe) continue;
+        onation[it->first] = cit->second._nation;
+    }
+
+    map<int, double> revenue;
+    ch_ol_scan_t ol_scan(this, _pssm);
+    W_DO(ol_scan.open());
+    bool eof;
+    ch_orderline_t aol;
+    W_DO(ol_scan.next(eof, aol));
+    while (!eof) {
+        map<ch_key_t, int>::iterator it = onation.find(aol.okey());
+        if ((it != onation.end()) &&
+            (ch_supplier_nation(ch_supplier_of(aol._w_id, aol._i_id)) == it->second))
+            revenue[it->second] += aol._amount;
+        W_DO(ol_scan.next(eof, aol));
+    }
+
+    vector< std::pair<int,double> > result(revenue.begin(), revenue.end());
+    std::sort(result.begin(), result.end(), ch_revenue_desc);
+    for (uint_t i=0; i<result.size(); i++)
+        TRACE( TRACE_QUERY_RESULTS, "%s|%.2f\n",
+               ch_nation_name(result[i].first), result[i].second);
+    return (RCOK);
+
+} // EOF: CH Q5
+
+
+
+/********************************************************************
+ *
+ * CH Q6
+ *
+ * select sum(ol_amount) from order_line
+ * where ol_delivery_d >= '1999-01-01' and ol_delivery_d < '2020-01-01'
+ *   and ol_quantity between 1 and 100000
+ *
+ ********************************************************************/
+
+w_rc_t ShoreCHEnv::xct_ch_q6(const int /* xct_id */, ch_q6_input_t& in)
+{
+    // ensure a valid environment
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    double revenue = 0;
+    ch_ol_scan_t ol_scan(this, _pssm);
+    W_DO(ol_scan.open());
+    bool eof;
+    ch_orderline_t aol;
+    W_DO(ol_scan.next(eof, aol));
+    while (!eof) {
+        if ((aol._delivery_d >= in._d1999) && (aol._delivery_d < in._d2020) &&
+            (aol._quantity >= in._min_qty) && (aol._quantity <= in._max_qty))
+            revenue += aol._amount;
+        W_DO(ol_scan.next(eof, aol));
+    }
+
+    TRACE( TRACE_QUERY_RESULTS, "%.2f\n", revenue);
+    return (RCOK);
+
+} // EOF: CH Q6
+
+
+
+/********************************************************************
+ *
+ * CH Q7
+ *
+ * The revenue of the trade between Germany and Cambodia, per supplier
+ * nation, customer nation and year
+ *
+ ********************************************************************/
+
+struct ch_q7_key_t
+{
+    int _supp_nation;
+    int _cust_nation;
+    int _year;
+
+    bool operator<(const ch_q7_key_t& rhs) const {
+        if (_supp_nation != rhs._supp_nation) return (_supp_nation < rhs._supp_nation);
+        if (_cust_nation != rhs._cust_nation) return (_cust_nation < rhs._cust_nation);
+        return (_year < rhs._year);
+    }
+};
+
+w_rc_t ShoreCHEnv::xct_ch_q7(const int /* xct_id */, ch_q7_input_t& in)
+{
+    // ensure a valid environment
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    const int germany  = ch_find_nation("Germany");
+    const int cambodia = ch_find_nation("Cambodia");
+
+    ch_customer_map custs;
+    W_DO(ch_load_customers(this, _pssm, custs));
+
+    ch_order_map orders;
+    W_DO(ch_load_orders(this, _pssm, orders, 0, 1e18));
+
+    // order -> (customer nation, year), for the customers of the two
+    map<ch_key_t, std::pair<int,int> > oinfo;
+    for (ch_order_map::iterator it = orders.begin(); it != orders.end(); ++it) {
+        ch_key_t ckey = (it->first & ~0xFFFFFFFFULL) | it->second._c_id;
+        ch_customer_map::iterator cit = custs.find(ckey);
+        if (cit == custs.end()) continue;
+        int nation = cit->second._nation;
+        if ((nation != germany) && (nation != cambodia)) continue;
+        oinfo[it->first] = std::make_pair(nation, ch_year(it->second._entry_d));
+    }
+
+    map<ch_q7_key_t, double> revenue;
+    ch_ol_scan_t ol_scan(this, _pssm);
+    W_DO(ol_scan.open());
+    bool eof;
+    ch_orderline_t aol;
+    W_DO(ol_scan.next(eof, aol));
+    while (!eof) {
+        if ((aol._delivery_d >= in._d2007) && (aol._delivery_d <= in._d2012)) {
+            map<ch_key_t, std::pair<int,int> >::iterator it = oinfo.find(aol.okey());
+            if (it != oinfo.end()) {
+                int snation = ch_supplier_nation(ch_supplier_of(aol._supply_w_id,
+                                                                aol._i_id));
+                int cnation = it->second.first;
+                if (((snation == germany) && (cnation == cambodia)) ||
+                    ((snation == cambodia) && (cnation == germany))) {
+                    ch_q7_key_t akey = { snation, cnation, it->second.second };
+                    revenue[akey] += aol._amount;
+                }
+            }
+        }
+        W_DO(ol_scan.next(eof, aol));
+    }
+
+    for (map<ch_q7_key_t, double>::iterator it = revenue.begin();
+         it != revenue.end(); ++it)
+        TRACE( TRACE_QUERY_RESULTS, "%s|%s|%d|%.2f\n",
+               ch_nation_name(it->first._supp_nation),
+               ch_nation_name(it->first._cust_nation),
+               it->first._year, it->second);
+    return (RCOK);
+
+} // EOF: CH Q7
+
+
+
+/********************************************************************
+ *
+ * CH Q8
+ *
+ * The yearly market share of the German suppliers, for the European
+ * customers and the items below 1000 whose i_data ends with 'b'
+ *
+ ********************************************************************/
+
+w_rc_t ShoreCHEnv::xct_ch_q8(const int /* xct_id */, ch_q8_input_t& in)
+{
+    // ensure a valid environment
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    const int europe  = ch_find_region("Europe");
+    const int germany = ch_find_nation("Germany");
+
+    vector<ch_item_t> items;
+    W_DO(ch_load_items(this, _pssm, items));
+
+    ch_customer_map custs;
+    W_DO(ch_load_customers(this, _pssm, custs));
+
+    ch_order_map orders;
+    W_DO(ch_load_orders(this, _pssm, orders, in._d2007, in._d2012));
+
+    // order -> year, for the European customers
+    map<ch_key_t, int> oyear;
+    for (ch_order_map::iterator it = orders.begin(); it != orders.end(); ++it) {
+        ch_key_t ckey = (it->first & ~0xFFFFFFFFULL) | it->second._c_id;
+        ch_customer_map::iterator cit = custs.find(ckey);
+        if ((cit == custs.end()) || (cit->second._nation < 0)) continue;
+        if (ch_nation_region(cit->second._nation) != europe) continue;
+        oyear[it->first] = ch_year(it->second._entry_d);
+    }
+
+    map<int, std::pair<double,double> > share; // year -> (germany, all)
+    ch_ol_scan_t ol_scan(this, _pssm);
+    W_DO(ol_scan.open());
+    bool eof;
+    ch_orderline_t aol;
+    W_DO(ol_scan.next(eof, aol));
+    while (!eof) {
+        if ((aol._i_id < 1000) && items[aol._i_id]._valid &&
+            ch_ends_with(items[aol._i_id]._data, "b"))
+            {
+                map<ch_key_t, int>::iterator it = oyear.find(aol.okey());
+                if (it != oyear.end()) {
+                    std::pair<double,double>& s = share[it->second];
+                    s.second += aol._amount;
+                    if (ch_supplier_nation(ch_supplier_of(aol._supply_w_id,
+                                                          aol._i_id)) == germany)
+                        s.first += aol._amount;
+                }
+            }
+        W_DO(ol_scan.next(eof, aol));
+    }
+
+    for (map<int, std::pair<double,double> >::iterator it = share.begin();
+         it != share.end(); ++it)
+        TRACE( TRACE_QUERY_RESULTS, "%d|%.4f\n", it->first,
+               (it->second.second > 0 ? it->second.first / it->second.second : 0));
+    return (RCOK);
+
+} // EOF: CH Q8
+
+
+
+/********************************************************************
+ *
+ * CH Q9
+ *
+ * The revenue per supplier nation and year, of the items whose i_data
+ * ends with 'BB'
+ *
+ ********************************************************************/
+
+struct ch_q9_key_t
+{
+    int _nation;
+    int _year;
+
+    bool operator<(const ch_q9_key_t& rhs) const {
+        int c = strcmp(ch_nation_name(_nation), ch_nation_name(rhs._nation));
+        if (c != 0) return (c < 0);
+        return (_year > rhs._year);
+    }
+};
+
+w_rc_t ShoreCHEnv::xct_ch_q9(const int /* xct_id */, ch_q9_input_t& /* in */)
+{
+    // ensure a valid environment
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    vector<ch_item_t> items;
+    W_DO(ch_load_items(this, _pssm, items));
+
+    ch_order_map orders;
+    W_DO(ch_load_orders(this, _pssm, orders, 0, 1e18));
+
+    map<ch_q9_key_t, double> profit;
+    ch_ol_scan_t ol_scan(this, _pssm);
+    W_DO(ol_scan.open());
+    bool eof;
+    ch_orderline_t aol;
+    W_DO(ol_scan.next(eof, aol));
+    while (!eof) {
+        if ((aol._i_id < (int)items.size()) && items[aol._i_id]._valid &&
+            ch_ends_with(items[aol._i_id]._data, "BB"))
+            {
+                ch_order_map::iterator it = orders.find(aol.okey());
+                if (it != orders.end()) {
+                    ch_q9_key_t akey = {
+                        ch_supplier_nation(ch_supplier_of(aol._supply_w_id, aol._i_id)),
+                        ch_year(it->second._entry_d) };
+                    profit[akey] += aol._amount;
+                }
+            }
+        W_DO(ol_scan.next(eof, aol));
+    }
+
+    for (map<ch_q9_key_t, double>::iterator it = profit.begin();
+         it != profit.end(); ++it)
+        TRACE( TRACE_QUERY_RESULTS, "%s|%d|%.2f\n",
+               ch_nation_name(it->first._nation), it->first._year, it->second);
+    return (RCOK);
+
+} // EOF: CH Q9
+
+
+
+/********************************************************************
+ *
+ * CH Q10
+ *
+ * The customers with the most revenue from lines delivered after the
+ * order entry, for orders since 2007
+ *
+ ********************************************************************/
+
+static bool ch_revenue_desc_key(const std::pair<ch_key_t,double>& a,
+                                const std::pair<ch_key_t,double>& b)
+{
+    return (a.second > b.second);
+}
+
+w_rc_t ShoreCHEnv::xct_ch_q10(const int /* xct_id */, ch_q10_input_t& in)
+{
+    // ensure a valid environment
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    ch_order_map orders;
+    W_DO(ch_load_orders(this, _pssm, orders, in._d2007, 1e18));
+
+    map<ch_key_t, double> revenue; // per customer
+    ch_ol_scan_t ol_scan(this, _pssm);
+    W_DO(ol_scan.open());
+    bool eof;
+    ch_orderline_t aol;
+    W_DO(ol_scan.next(eof, aol));
+    while (!eof) {
+        ch_order_map::iterator it = orders.find(aol.okey());
+        if ((it != orders.end()) && (it->second._entry_d <= aol._delivery_d)) {
+            ch_key_t ckey = (it->first & ~0xFFFFFFFFULL) | it->second._c_id;
+            revenue[ckey] += aol._amount;
+        }
+        W_DO(ol_scan.next(eof, aol));
+    }
+
+    ch_customer_map custs;
+    W_DO(ch_load_customers(this, _pssm, custs));
+
+    vector< std::pair<ch_key_t,double> > result(revenue.begin(), revenue.end());
+    std::sort(result.begin(), result.end(), ch_revenue_desc_key);
+    for (uint_t i=0; i<result.size(); i++) {
+        ch_customer_map::iterator cit = custs.find(result[i].first);
+        if ((cit == custs.end()) || (cit->second._nation < 0)) continue;
+        TRACE( TRACE_QUERY_RESULTS, "%d|%s|%.2f|%s|%s|%s\n",
+               cit->second._c_id, cit->second._last, result[i].second,
+               cit->second._city, cit->second._phone,
+               ch_nation_name(cit->second._nation));
+    }
+    return (RCOK);
+
+} // EOF: CH Q10
+
+
+
+/********************************************************************
+ *
+ * CH Q11
+ *
+ * The items with the largest share of the orders of the German
+ * suppliers' stock
+ *
+ ********************************************************************/
+
+w_rc_t ShoreCHEnv::xct_ch_q11(const int /* xct_id */, ch_q11_input_t& /* in */)
+{
+    // ensure a valid environment
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    const int germany = ch_find_nation("Germany");
+
+    map<int, double> ordercount;
+    double total = 0;
+
+    tuple_guard<stock_man_impl> prst(_pstock_man);
+    rep_row_t areprow(_pstock_man->ts());
+    areprow.set(_pstock_desc->maxsize());
+    prst->_rep = &areprow;
+
+    guard< table_scan_iter_impl<stock_t> > s_iter;
+    W_DO(ch_open_scan(_pssm, stock_man(), s_iter));
+    bool eof;
+    W_DO(s_iter->next(_pssm, eof, *prst));
+    while (!eof) {
+        int s_i_id = stock_row_t::get_S_I_ID(prst);
+        int s_w_id = stock_row_t::get_S_W_ID(prst);
+        if (ch_supplier_nation(ch_supplier_of(s_w_id, s_i_id)) == germany) {
+            int cnt = stock_row_t::get_S_ORDER_CNT(prst);
+            ordercount[s_i_id] += cnt;
+            total += cnt;
+        }
+        W_DO(s_iter->next(_pssm, eof, *prst));
+    }
+
+    vector< std::pair<int,double> > result;
+    for (map<int, double>::iterator it = ordercount.begin();
+         it != ordercount.end(); ++it) {
+        if (it->second > total * 0.005) result.push_back(*it);
+    }
+    std::sort(result.begin(), result.end(), ch_revenue_desc);
+    for (uint_t i=0; i<result.size(); i++)
+        TRACE( TRACE_QUERY_RESULTS, "%d|%.0f\n", result[i].first, result[i].second);
+    return (RCOK);
+
+} // EOF: CH Q11
+
+
+
+/********************************************************************
+ *
+ * CH Q12
+ *
+ * The high (carrier 1 or 2) and low priority lines delivered after
+ * the order entry, per number of order lines
+ *
+ ********************************************************************/
+
+w_rc_t ShoreCHEnv::xct_ch_q12(const int /* xct_id */, ch_q12_input_t& in)
+{
+    // ensure a valid environment
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    ch_order_map orders;
+    W_DO(ch_load_orders(this, _pssm, orders, 0, 1e18));
+
+    map<int, std::pair<int,int> > counts; // ol_cnt -> (high, low)
+    ch_ol_scan_t ol_scan(this, _pssm);
+    W_DO(ol_scan.open());
+    bool eof;
+    ch_orderline_t aol;
+    W_DO(ol_scan.next(eof, aol));
+    while (!eof) {
+        ch_order_map::iterator it = orders.find(aol.okey());
+        if ((it != orders.end()) && (it->second._entry_d <= aol._delivery_d) &&
+            (aol._delivery_d < in._d2020)) {
+            std::pair<int,int>& c = counts[it->second._ol_cnt];
+            if ((it->second._carrier_id == 1) || (it->second._carrier_id == 2))
+                c.first++;
+            else
+                c.second++;
+        }
+        W_DO(ol_scan.next(eof, aol));
+    }
+
+    for (map<int, std::pair<int,int> >::iterator it = counts.begin();
+         it != counts.end(); ++it)
+        TRACE( TRACE_QUERY_RESULTS, "%d|%d|%d\n",
+               it->first, it->second.first, it->second.second);
+    return (RCOK);
+
+} // EOF: CH Q12
+
+
+
+/********************************************************************
+ *
+ * CH Q13
+ *
+ * The distribution of the customers by their number of orders with
+ * carrier above 8
+ *
+ ********************************************************************/
+
+static bool ch_q13_order(const std::pair<int,int>& a, const std::pair<int,int>& b)
+{
+    if (a.second != b.second) return (a.second > b.second);
+    return (a.first > b.first);
+}
+
+w_rc_t ShoreCHEnv::xct_ch_q13(const int /* xct_id */, ch_q13_input_t& /* in */)
+{
+    // ensure a valid environment
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    ch_customer_map custs;
+    W_DO(ch_load_customers(this, _pssm, custs));
+
+    ch_order_map orders;
+    W_DO(ch_load_orders(this, _pssm, orders, 0, 1e18));
+
+    // the left outer join: every customer starts with 0 orders
+    map<ch_key_t, int> c_count;
+    for (ch_customer_map::iterator it = custs.begin(); it != custs.end(); ++it)
+        c_count[it->first] = 0;
+    for (ch_order_map::iterator it = orders.begin(); it != orders.end(); ++it) {
+        if (it->second._carrier_id <= 8) continue;
+        ch_key_t ckey = (it->first & ~0xFFFFFFFFULL) | it->second._c_id;
+        map<ch_key_t, int>::iterator cit = c_count.find(ckey);
+        if (cit != c_count.end()) cit->second++;
+    }
+
+    map<int, int> custdist;
+    for (map<ch_key_t, int>::iterator it = c_count.begin(); it != c_count.end(); ++it)
+        custdist[it->second]++;
+
+    vector< std::pair<int,int> > result(custdist.begin(), custdist.end());
+    std::sort(result.begin(), result.end(), ch_q13_order);
+    for (uint_t i=0; i<result.size(); i++)
+        TRACE( TRACE_QUERY_RESULTS, "%d|%d\n", result[i].first, result[i].second);
+    return (RCOK);
+
+} // EOF: CH Q13
+
+
+
+/********************************************************************
+ *
+ * CH Q14
+ *
+ * The share of the promotional (i_data starting with 'PR') revenue
+ *
+ ********************************************************************/
+
+w_rc_t ShoreCHEnv::xct_ch_q14(const int /* xct_id */, ch_q14_input_t& in)
+{
+    // ensure a valid environment
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    vector<ch_item_t> items;
+    W_DO(ch_load_items(this, _pssm, items));
+
+    double promo = 0;
+    double total = 0;
+    ch_ol_scan_t ol_scan(this, _pssm);
+    W_DO(ol_scan.open());
+    bool eof;
+    ch_orderline_t aol;
+    W_DO(ol_scan.next(eof, aol));
+    while (!eof) {
+        if ((aol._delivery_d >= in._d2007) && (aol._delivery_d < in._d2020) &&
+            (aol._i_id < (int)items.size()) && items[aol._i_id]._valid) {
+            total += aol._amount;
+            if (ch_starts_with(items[aol._i_id]._data, "PR"))
+                promo += aol._amount;
+        }
+        W_DO(ol_scan.next(eof, aol));
+    }
+
+    TRACE( TRACE_QUERY_RESULTS, "%.2f\n", 100.0 * promo / (1 + total));
+    return (RCOK);
+
+} // EOF: CH Q14
+
+
+
+/********************************************************************
+ *
+ * CH Q15
+ *
+ * The suppliers with the maximum revenue since 2007
+ *
+ ********************************************************************/
+
+w_rc_t ShoreCHEnv::xct_ch_q15(const int /* xct_id */, ch_q15_input_t& in)
+{
+    // ensure a valid environment
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    vector<double> revenue(CH_SUPPLIERS, 0.0);
+    ch_ol_scan_t ol_scan(this, _pssm);
+    W_DO(ol_scan.open());
+    bool eof;
+    ch_orderline_t aol;
+    W_DO(ol_scan.next(eof, aol));
+    while (!eof) {
+        if (aol._delivery_d >= in._d2007)
+            revenue[ch_supplier_of(aol._supply_w_id, aol._i_id)] += aol._amount;
+        W_DO(ol_scan.next(eof, aol));
+    }
+
+    double max_revenue = *std::max_element(revenue.begin(), revenue.end());
+    char sname[32];
+    for (int s=0; s<CH_SUPPLIERS; s++) {
+        if ((revenue[s] != max_revenue) || (max_revenue == 0)) continue;
+        ch_supplier_name(s, sname);
+        TRACE( TRACE_QUERY_RESULTS, "%d|%s|%.2f\n", s, sname, revenue[s]);
+    }
+    return (RCOK);
+
+} // EOF: CH Q15
+
+
+
+/********************************************************************
+ *
+ * CH Q16
+ *
+ * The number of (not complained about) suppliers per item name, brand
+ * and price
+ *
+ ********************************************************************/
+
+static bool ch_q16_order(const std::pair<string,int>& a,
+                         const std::pair<string,int>& b)
+{
+    if (a.second != b.second) return (a.second > b.second);
+    return (a.first < b.first);
+}
+
+w_rc_t ShoreCHEnv::xct_ch_q16(const int /* xct_id */, ch_q16_input_t& /* in */)
+{
+    // ensure a valid environment
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    vector<ch_item_t> items;
+    W_DO(ch_load_items(this, _pssm, items));
+
+    // (i_name|brand|i_price) -> distinct suppliers
+    map<string, set<int> > groups;
+
+    tuple_guard<stock_man_impl> prst(_pstock_man);
+    rep_row_t areprow(_pstock_man->ts());
+    areprow.set(_pstock_desc->maxsize());
+    prst->_rep = &areprow;
+
+    guard< table_scan_iter_impl<stock_t> > s_iter;
+    W_DO(ch_open_scan(_pssm, stock_man(), s_iter));
+    bool eof;
+    char gkey[128];
+    W_DO(s_iter->next(_pssm, eof, *prst));
+    while (!eof) {
+        int s_i_id = stock_row_t::get_S_I_ID(prst);
+        int suppkey = ch_supplier_of(stock_row_t::get_S_W_ID(prst), s_i_id);
+        if ((s_i_id < (int)items.size()) && items[s_i_id]._valid &&
+            !ch_starts_with(items[s_i_id]._data, "zz") &&
+            !ch_supplier_is_bad(suppkey))
+            {
+                const ch_item_t& aitem = items[s_i_id];
+                snprintf(gkey, sizeof(gkey), "%s|%.3s|%d",
+                         aitem._name, aitem._data, aitem._price);
+                groups[gkey].insert(suppkey);
+            }
+        W_DO(s_iter->next(_pssm, eof, *prst));
+    }
+
+    vector< std::pair<string,int> > result;
+    for (map<string, set<int> >::iterator it = groups.begin();
+         it != groups.end(); ++it)
+        result.push_back(std::make_pair(it->first, (int)it->second.size()));
+    std::sort(result.begin(), result.end(), ch_q16_order);
+    for (uint_t i=0; i<result.size(); i++)
+        TRACE( TRACE_QUERY_RESULTS, "%s|%d\n",
+               result[i].first.c_str(), result[i].second);
+    return (RCOK);
+
+} // EOF: CH Q16
+
+
+
+/********************************************************************
+ *
+ * CH Q17
+ *
+ * The yearly revenue lost, if the small quantity lines of the items
+ * whose i_data ends with 'b' were not taken
+ *
+ ********************************************************************/
+
+w_rc_t ShoreCHEnv::xct_ch_q17(const int /* xct_id */, ch_q17_input_t& /* in */)
+{
+    // ensure a valid environment
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    vector<ch_item_t> items;
+    W_DO(ch_load_items(this, _pssm, items));
+
+    // 1. The average quantity per item
+    map<int, std::pair<double,int> > avg_qty;
+    {
+        ch_ol_scan_t ol_scan(this, _pssm);
+        W_DO(ol_scan.open());
+        bool eof;
+        ch_orderline_t aol;
+        W_DO(ol_scan.next(eof, aol));
+        while (!eof) {
+            if ((aol._i_id < (int)items.size()) && items[aol._i_id]._valid &&
+                ch_ends_with(items[aol._i_id]._data, "b")) {
+                std::pair<double,int>& a = avg_qty[aol._i_id];
+                a.first += aol._quantity;
+                a.second++;
+            }
+            W_DO(ol_scan.next(eof, aol));
+        }
+    }
+
+    // 2. The lines below the average
+    double revenue = 0;
+    {
+        ch_ol_scan_t ol_scan(this, _pssm);
+        W_DO(ol_scan.open());
+        bool eof;
+        ch_orderline_t aol;
+        W_DO(ol_scan.next(eof, aol));
+        while (!eof) {
+            map<int, std::pair<double,int> >::iterator it = avg_qty.find(aol._i_id);
+            if ((it != avg_qty.end()) &&
+                (aol._quantity < it->second.first / it->second.second))
+                revenue += aol._amount;
+            W_DO(ol_scan.next(eof, aol));
+        }
+    }
+
+    TRACE( TRACE_QUERY_RESULTS, "%.2f\n", revenue / 2.0);
+    return (RCOK);
+
+} // EOF: CH Q17
+
+
+
+/********************************************************************
+ *
+ * CH Q18
+ *
+ * The orders with a total amount above 200, with their customer
+ *
+ ********************************************************************/
+
+struct ch_q18_row_t
+{
+    ch_key_t _okey;
+    double   _entry_d;
+    double   _amount;
+
+    bool operator<(const ch_q18_row_t& rhs) const {
+        if (_amount != rhs._amount) return (_amount > rhs._amount);
+        return (_entry_d < rhs._entry_d);
+    }
+};
+
+w_rc_t ShoreCHEnv::xct_ch_q18(const int /* xct_id */, ch_q18_input_t& /* in */)
+{
+    // ensure a valid environment
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    map<ch_key_t, double> amount;
+    ch_ol_scan_t ol_scan(this, _pssm);
+    W_DO(ol_scan.open());
+    bool eof;
+    ch_orderline_t aol;
+    W_DO(ol_scan.next(eof, aol));
+    while (!eof) {
+        amount[aol.okey()] += aol._amount;
+        W_DO(ol_scan.next(eof, aol));
+    }
+
+    ch_order_map orders;
+    W_DO(ch_load_orders(this, _pssm, orders, 0, 1e18));
+    ch_customer_map custs;
+    W_DO(ch_load_customers(this, _pssm, custs));
+
+    vector<ch_q18_row_t> result;
+    for (map<ch_key_t, double>::iterator it = amount.begin(); it != amount.end(); ++it) {
+        if (it->second <= 200) continue;
+        ch_order_map::iterator oit = orders.find(it->first);
+        if (oit == orders.end()) continue;
+        ch_q18_row_t arow = { it->first, oit->second._entry_d, it->second };
+        result.push_back(arow);
+    }
+    std::sort(result.begin(), result.end());
+
+    for (uint_t i=0; i<result.size(); i++) {
+        const ch_order_t& aorder = orders[result[i]._okey];
+        ch_key_t ckey = (result[i]._okey & ~0xFFFFFFFFULL) | aorder._c_id;
+        ch_customer_map::iterator cit = custs.find(ckey);
+        if (cit == custs.end()) continue;
+        TRACE( TRACE_QUERY_RESULTS, "%s|%d|%d|%.0f|%d|%.2f\n",
+               cit->second._last, aorder._c_id,
+               (int)(result[i]._okey & 0xFFFFFFFFULL),
+               aorder._entry_d, aorder._ol_cnt, result[i]._amount);
+    }
+    return (RCOK);
+
+} // EOF: CH Q18
+
+
+
+/********************************************************************
+ *
+ * CH Q19
+ *
+ * The revenue of the small quantity lines of three groups of items
+ * (i_data ending with 'a', 'b', 'c') and warehouses
+ *
+ ********************************************************************/
+
+w_rc_t ShoreCHEnv::xct_ch_q19(const int /* xct_id */, ch_q19_input_t& /* in */)
+{
+    // ensure a valid environment
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    vector<ch_item_t> items;
+    W_DO(ch_load_items(this, _pssm, items));
+
+    double revenue = 0;
+    ch_ol_scan_t ol_scan(this, _pssm);
+    W_DO(ol_scan.open());
+    bool eof;
+    ch_orderline_t aol;
+    W_DO(ol_scan.next(eof, aol));
+    while (!eof) {
+        if ((aol._quantity >= 1) && (aol._quantity <= 10) &&
+            (aol._i_id < (int)items.size()) && items[aol._i_id]._valid) {
+            const ch_item_t& aitem = items[aol._i_id];
+            int w = aol._w_id;
+            if ((aitem._price >= 1) && (aitem._price <= 400000) &&
+                ((ch_ends_with(aitem._data, "a") && (w==1 || w==2 || w==3)) ||
+                 (ch_ends_with(aitem._data, "b") && (w==1 || w==2 || w==4)) ||
+                 (ch_ends_with(aitem._data, "c") && (w==1 || w==5 || w==3))))
+                revenue += aol._amount;
+        }
+        W_DO(ol_scan.next(eof, aol));
+    }
+
+    TRACE( TRACE_QUERY_RESULTS, "%.2f\n", revenue);
+    return (RCOK);
+
+} // EOF: CH Q19
+
+
+
+/********************************************************************
+ *
+ * CH Q20
+ *
+ * The German suppliers with excess stock of the items whose i_data
+ * starts with 'co'
+ *
+ ********************************************************************/
+
+static bool ch_supplier_name_less(const int a, const int b)
+{
+    char sa[32], sb[32];
+    ch_supplier_name(a, sa);
+    ch_supplier_name(b, sb);
+    return (strcmp(sa, sb) < 0);
+}
+
+w_rc_t ShoreCHEnv::xct_ch_q20(const int /* xct_id */, ch_q20_input_t& in)
+{
+    // ensure a valid environment
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    const int germany = ch_find_nation("Germany");
+
+    vector<ch_item_t> items;
+    W_DO(ch_load_items(this, _pssm, items));
+
+    // 1. The quantity ordered since 2010-05-23 per item
+    map<int, double> ordered;
+    {
+        ch_ol_scan_t ol_scan(this, _pssm);
+        W_DO(ol_scan.open());
+        bool eof;
+        ch_orderline_t aol;
+        W_DO(ol_scan.next(eof, aol));
+        while (!eof) {
+            if ((aol._delivery_d > in._d2010) &&
+                (aol._i_id < (int)items.size()) && items[aol._i_id]._valid &&
+                ch_starts_with(items[aol._i_id]._data, "co"))
+                ordered[aol._i_id] += aol._quantity;
+            W_DO(ol_scan.next(eof, aol));
+        }
+    }
+
+    // 2. The suppliers of the stock rows with more than half of it
+    set<int> suppliers;
+    {
+        tuple_guard<stock_man_impl> prst(_pstock_man);
+        rep_row_t areprow(_pstock_man->ts());
+        areprow.set(_pstock_desc->maxsize());
+        prst->_rep = &areprow;
+
+        guard< table_scan_iter_impl<stock_t> > s_iter;
+        W_DO(ch_open_scan(_pssm, stock_man(), s_iter));
+        bool eof;
+        W_DO(s_iter->next(_pssm, eof, *prst));
+        while (!eof) {
+            int s_i_id = stock_row_t::get_S_I_ID(prst);
+            map<int, double>::iterator it = ordered.find(s_i_id);
+            if ((it != ordered.end()) &&
+                (2 * stock_row_t::get_S_QUANTITY(prst) > it->second)) {
+                int suppkey = ch_supplier_of(stock_row_t::get_S_W_ID(prst), s_i_id);
+                if (ch_supplier_nation(suppkey) == germany)
+                    suppliers.insert(suppkey);
+            }
+            W_DO(s_iter->next(_pssm, eof, *prst));
+        }
+    }
+
+    vector<int> result(suppliers.begin(), suppliers.end());
+    std::sort(result.begin(), result.end(), ch_supplier_name_less);
+    char sname[32];
+    for (uint_t i=0; i<result.size(); i++) {
+        ch_supplier_name(result[i], sname);
+        TRACE( TRACE_QUERY_RESULTS, "%s\n", sname);
+    }
+    return (RCOK);
+
+} // EOF: CH Q20
+
+
+
+/********************************************************************
+ *
+ * CH Q21
+ *
+ * The German suppliers whose lines were the last delivered ones of
+ * (late) orders
+ *
+ ********************************************************************/
+
+static bool ch_q21_order(const std::pair<int,int>& a, const std::pair<int,int>& b)
+{
+    if (a.second != b.second) return (a.second > b.second);
+    return (ch_supplier_name_less(a.first, b.first));
+}
+
+w_rc_t ShoreCHEnv::xct_ch_q21(const int /* xct_id */, ch_q21_input_t& /* in */)
+{
+    // ensure a valid environment
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    const int germany = ch_find_nation("Germany");
+
+    ch_order_map orders;
+    W_DO(ch_load_orders(this, _pssm, orders, 0, 1e18));
+
+    // 1. The last delivery of each order
+    map<ch_key_t, double> last_delivery;
+    {
+        ch_ol_scan_t ol_scan(this, _pssm);
+        W_DO(ol_scan.open());
+        bool eof;
+        ch_orderline_t aol;
+        W_DO(ol_scan.next(eof, aol));
+        while (!eof) {
+            map<ch_key_t, double>::iterator it = last_delivery.find(aol.okey());
+            if (it == last_delivery.end()) last_delivery[aol.okey()] = aol._delivery_d;
+            else if (aol._delivery_d > it->second) it->second = aol._delivery_d;
+            W_DO(ol_scan.next(eof, aol));
+        }
+    }
+
+    // 2. The lines that no other line of the order was delivered after
+    map<int, int> numwait;
+    {
+        ch_ol_scan_t ol_scan(this, _pssm);
+        W_DO(ol_scan.open());
+        bool eof;
+        ch_orderline_t aol;
+        W_DO(ol_scan.next(eof, aol));
+        while (!eof) {
+            ch_key_t okey = aol.okey();
+            ch_order_map::iterator it = orders.find(okey);
+            if ((it != orders.end()) && (aol._delivery_d > it->second._entry_d) &&
+                (aol._delivery_d >= last_delivery[okey])) {
+                int suppkey = ch_supplier_of(aol._w_id, aol._i_id);
+                if (ch_supplier_nation(suppkey) == germany)
+                    numwait[suppkey]++;
+            }
+            W_DO(ol_scan.next(eof, aol));
+        }
+    }
+
+    vector< std::pair<int,int> > result(numwait.begin(), numwait.end());
+    std::sort(result.begin(), result.end(), ch_q21_order);
+    char sname[32];
+    for (uint_t i=0; i<result.size(); i++) {
+        ch_supplier_name(result[i].first, sname);
+        TRACE( TRACE_QUERY_RESULTS, "%s|%d\n", sname, result[i].second);
+    }
+    return (RCOK);
+
+} // EOF: CH Q21
+
+
+
+/********************************************************************
+ *
+ * CH Q22
+ *
+ * The customers, per state initial, with an above average balance and
+ * no orders, whose phone starts with 1-7
+ *
+ ********************************************************************/
+
+static inline bool ch_q22_phone(const char* phone)
+{
+    return ((phone[0] >= '1') && (phone[0] <= '7'));
+}
+
+w_rc_t ShoreCHEnv::xct_ch_q22(const int /* xct_id */, ch_q22_input_t& /* in */)
+{
+    // ensure a valid environment
+    assert (_pssm);
+    assert (_initialized);
+    assert (_loaded);
+
+    ch_customer_map custs;
+    W_DO(ch_load_customers(this, _pssm, custs));
+
+    // 1. The average positive balance
+    double sum = 0;
+    int cnt = 0;
+    for (ch_customer_map::iterator it = custs.begin(); it != custs.end(); ++it) {
+        if (ch_q22_phone(it->second._phone) && (it->second._balance > 0)) {
+            sum += it->second._balance;
+            cnt++;
+        }
+    }
+    double avg_balance = (cnt ? sum / cnt : 0);
+
+    // 2. The customers with orders
+    set<ch_key_t> with_orders;
+    {
+        ch_order_map orders;
+        W_DO(ch_load_orders(this, _pssm, orders, 0, 1e18));
+        for (ch_order_map::iterator it = orders.begin(); it != orders.end(); ++it)
+            with_orders.insert((it->first & ~0xFFFFFFFFULL) | it->second._c_id);
+    }
+
+    map<char, std::pair<int,double> > groups;
+    for (ch_customer_map::iterator it = custs.begin(); it != custs.end(); ++it) {
+        if (!ch_q22_phone(it->second._phone) ||
+            (it->second._balance <= avg_balance) ||
+            (with_orders.find(it->first) != with_orders.end()))
+            continue;
+        std::pair<int,double>& g = groups[it->second._state[0]];
+        g.first++;
+        g.second += it->second._balance;
+    }
+
+    for (map<char, std::pair<int,double> >::iterator it = groups.begin();
+         it != groups.end(); ++it)
+        TRACE( TRACE_QUERY_RESULTS, "%c|%d|%.2f\n",
+               it->first, it->second.first, it->second.second);
+    return (RCOK);
+
+} // EOF: CH Q22
+
+
+EXIT_NAMESPACE(ch);
@@ -31,6 +31,7 @@
 
 #include "workload/ssb/shore_ssb_env.h"
 #include "qpipe.h"
+#include "qpipe/common/predicates.h"
 
 using namespace shore;
 using namespace qpipe;
@@ -92,191 +93,96 @@ typedef struct q12_agg_tuple projected_tuple;
 
 
 
-class q12_lineorder_tscan_filter_t : public tuple_filter_t 
+// The scan filters select the records a page at a time, with the int
+// kernels of the predicates, and project their fields off the record.
+
+// lo_discount between 4 and 6 and lo_quantity between 26 and 35
+class q12_lineorder_tscan_filter_t : public predicate_filter_t 
 {
 private:
-    ShoreSSBEnv* _ssbdb;
-    table_row_t* _prline;
-    rep_row_t _rr;
-
-    ssb_lineorder_tuple _lineorder;
-    
-    /*VARIABLES TAKING VALUES FROM INPUT FOR SELECTION*/
-    int DISCOUNT_1;
-    int DISCOUNT_2;
-    int QUANTITY_1;
-    int QUANTITY_2;
+    size_t _extendedprice;
+    size_t _orderdate;
+    size_t _discount;
+
+    static predicate_t* _predicate(table_desc_t* plineorder) {
+        and_predicate_t* p = new and_predicate_t();
+        p->add(new range_predicate_t<int>(4, 6, plineorder->disk_offset(11)));
+        p->add(new range_predicate_t<int>(26, 35, plineorder->disk_offset(8)));
+        return (p);
+    }
 
 public:
 
-    q12_lineorder_tscan_filter_t(ShoreSSBEnv* ssbdb)//,q1_2_input_t &in) 
-        : tuple_filter_t(ssbdb->lineorder_desc()->maxsize()), _ssbdb(ssbdb)
+    q12_lineorder_tscan_filter_t(ShoreSSBEnv* ssbdb)
+        : predicate_filter_t(ssbdb->lineorder_desc()->maxsize(),
+                             _predicate(ssbdb->lineorder_desc()),
+                             "q12_lineorder_tscan_filter_t(LO_DISCOUNT between 4 and 6, LO_QUANTITY between 26 and 35)"),
+          _extendedprice(ssbdb->lineorder_desc()->disk_offset(9)),
+          _orderdate(ssbdb->lineorder_desc()->disk_offset(5)),
+          _discount(ssbdb->lineorder_desc()->disk_offset(11))
     {
-
-    	// Get a lineorder tupple from the tuple cache and allocate space
-        _prline = _ssbdb->lineorder_man()->get_tuple();
-        _rr.set_ts(_ssbdb->lineorder_man()->ts(),
-                   _ssbdb->lineorder_desc()->maxsize());
-        _prline->_rep = &_rr;
-        
-        DISCOUNT_1=4;
-        DISCOUNT_2=6;
-        QUANTITY_1=26;
-        QUANTITY_2=35;
-
     }
 
-    ~q12_lineorder_tscan_filter_t()
-    {
-        // Give back the lineorder tuple 
-        _ssbdb->lineorder_man()->give_tuple(_prline);
-    }
-
-
-    // Predication
-    bool select(const tuple_t &input) {
-
-        // Get next lineorder and read its shipdate
-        if (!_ssbdb->lineorder_man()->load(_prline, input.data)) {
-            assert(false); // RC(se_WRONG_DISK_DATA)
-        }
-
-        _prline->get_value(11, _lineorder.LO_DISCOUNT);
-        _prline->get_value(8, _lineorder.LO_QUANTITY);
-        
-        if (_lineorder.LO_DISCOUNT>=DISCOUNT_1 && _lineorder.LO_DISCOUNT<=DISCOUNT_2 && _lineorder.LO_QUANTITY>=QUANTITY_1 && _lineorder.LO_QUANTITY<=QUANTITY_2)
-            {       
-                TRACE( TRACE_RECORD_FLOW, "+ DISCOUNT |%d QUANTITY |%d --d\n",
-		       _lineorder.LO_DISCOUNT, _lineorder.LO_QUANTITY);
-		return (true);
-            }
-        else
-            {
-                TRACE( TRACE_RECORD_FLOW, ". DISCOUNT |%d QUANTITY |%d --d\n",
-		       _lineorder.LO_DISCOUNT, _lineorder.LO_QUANTITY);
-		return (false);
-            }
-    }
-
-    
     // Projection
     void project(tuple_t &d, const tuple_t &s) {        
 
         q12_lo_tuple *dest;
         dest = aligned_cast<q12_lo_tuple>(d.data);
 
-        _prline->get_value(5, _lineorder.LO_ORDERDATE);
-        _prline->get_value(9, _lineorder.LO_EXTENDEDPRICE);
-        _prline->get_value(11, _lineorder.LO_DISCOUNT);
-
+        dest->LO_ORDERDATE = load_field<int>(s.data + _orderdate);
+        dest->LO_EXTENDEDPRICE = load_field<int>(s.data + _extendedprice);
+        dest->LO_DISCOUNT = load_field<int>(s.data + _discount);
 
         TRACE( TRACE_RECORD_FLOW, "%d|%d|%d --d\n",
-               _lineorder.LO_ORDERDATE,
-               _lineorder.LO_EXTENDEDPRICE,
-               _lineorder.LO_DISCOUNT);
-
-        dest->LO_ORDERDATE = _lineorder.LO_ORDERDATE;
-        dest->LO_EXTENDEDPRICE = _lineorder.LO_EXTENDEDPRICE;
-        dest->LO_DISCOUNT = _lineorder.LO_DISCOUNT;
-
+               dest->LO_ORDERDATE,
+               dest->LO_EXTENDEDPRICE,
+               dest->LO_DISCOUNT);
     }
 
     q12_lineorder_tscan_filter_t* clone() const {
         return new q12_lineorder_tscan_filter_t(*this);
     }
-
-    c_str to_string() const {
-        return c_str("q1_2_lineorder_tscan_filter_t()");
-    }
 };
 
 
 
 
 
-class q12_date_tscan_filter_t : public tuple_filter_t 
+// d_yearmonthnum = 199401
+class q12_date_tscan_filter_t : public predicate_filter_t 
 {
 private:
-    ShoreSSBEnv* _ssbdb;
-    table_row_t* _prdate;
-    rep_row_t _rr;
-
-    ssb_date_tuple _date;
+    size_t _datekey;
 
-  /*VARIABLES TAKING VALUES FROM INPUT FOR SELECTION*/
-    int YEARMONTHNUM;
+    static predicate_t* _predicate(table_desc_t* pdate) {
+        return (new scalar_predicate_t<int>(199401, pdate->disk_offset(5)));
+    }
 
 public:
 
     q12_date_tscan_filter_t(ShoreSSBEnv* ssbdb, q1_2_input_t &in) 
-        : tuple_filter_t(ssbdb->date_desc()->maxsize()), _ssbdb(ssbdb)
+        : predicate_filter_t(ssbdb->date_desc()->maxsize(),
+                             _predicate(ssbdb->date_desc()),
+                             "q12_date_tscan_filter_t(D_YEARMONTHNUM = 199401)"),
+          _datekey(ssbdb->date_desc()->disk_offset(0))
     {
-
-    	// Get a date tupple from the tuple cache and allocate space
-        _prdate = _ssbdb->date_man()->get_tuple();
-        _rr.set_ts(_ssbdb->date_man()->ts(),
-                   _ssbdb->date_desc()->maxsize());
-        _prdate->_rep = &_rr;
-
-	YEARMONTHNUM=199401;
     }
 
-    ~q12_date_tscan_filter_t()
-    {
-        // Give back the date tuple 
-        _ssbdb->date_man()->give_tuple(_prdate);
-    }
-
-
-    // Predication
-    bool select(const tuple_t &input) {
-
-        // Get next date and read its shipdate
-        if (!_ssbdb->date_man()->load(_prdate, input.data)) {
-            assert(false); // RC(se_WRONG_DISK_DATA)
-        }
-
-        _prdate->get_value(5, _date.D_YEARMONTHNUM);
-
-	
-	if (_date.D_YEARMONTHNUM==YEARMONTHNUM)
-	    {
-		TRACE( TRACE_RECORD_FLOW, "+ YEARMONTHNUM |%d --d\n",
-		       _date.D_YEARMONTHNUM);
-		return (true);
-	    }
-	else
-	    {
-		TRACE( TRACE_RECORD_FLOW, ". YEARMONTHNUM |%d --d\n",
-		       _date.D_YEARMONTHNUM);
-		return (false);
-	    }
-
-    }
-
-    
     // Projection
     void project(tuple_t &d, const tuple_t &s) {        
 
         q12_d_tuple *dest;
         dest = aligned_cast<q12_d_tuple>(d.data);
 
-        _prdate->get_value(0, _date.D_DATEKEY);
+        dest->D_DATEKEY = load_field<int>(s.data + _datekey);
 
         TRACE( TRACE_RECORD_FLOW, "%d --d\n",
-               _date.D_DATEKEY);
-
-
-        dest->D_DATEKEY = _date.D_DATEKEY;
+               dest->D_DATEKEY);
     }
 
     q12_date_tscan_filter_t* clone() const {
         return new q12_date_tscan_filter_t(*this);
     }
-
-    c_str to_string() const {
-        return c_str("q12_date_tscan_filter_t()");
-    }
 };
 
 //Natural join
@@ -165,6 +165,8 @@ void ShoreSSBEnv::table_creator_t::work()
     _env->_pcustomer_man->register_table_man();
     _env->_plineorder_man->register_table_man();
 
+    // If bulk-loading, even the baseline only collects the index entries
+    _env->start_bulkload();
 
 
     // Do the baseline transaction
@@ -283,9 +285,9 @@ ShoreSSBEnv::ShoreSSBEnv()
     _scaling_factor = SSB_SCALING_FACTOR;
 
 #ifdef CFG_QPIPE
-    // Set the default scheduling policy. We will worry later about changing
-    // that, possibly through the shell
-    set_sched_policy(NULL);
+    // Set the scheduling policy (OS, RR_CPU, QUERY_CPU, RR_MODULE or
+    // PIPELINE). We will worry later about changing that through the shell
+    set_sched_policy(envVar::instance()->getVar("qpipe-sched-policy","OS").c_str());
 
     // Register stage containers
     register_stage_containers();
@@ -314,6 +316,13 @@ w_rc_t ShoreSSBEnv::load_schema()
     _pdate_man      = new date_man_impl(_pdate_desc.get());
     _pcustomer_man  = new customer_man_impl(_pcustomer_desc.get());
     _plineorder_man = new lineorder_man_impl(_plineorder_desc.get());
+
+    // the zone map of LO_ORDERDATE, if configured
+    int zone_pages = envVar::instance()->getVarInt("db-zonemaps",0);
+    if (zone_pages > 0) {
+        vector<uint_t> cols(1, 5); // LO_ORDERDATE
+        _plineorder_man->enable_zonemaps(cols, zone_pages);
+    }
                 
     return (RCOK);
 }
@@ -370,6 +379,11 @@ policy_t* ShoreSSBEnv::set_sched_policy(const char* spolicy)
             _sched_policy = new policy_rr_module_t();
             return (_sched_policy);
         }
+
+        if ( !strcmp(spolicy, "PIPELINE") ) {
+            _sched_policy = new policy_pipeline_t();
+            return (_sched_policy);
+        }
     }
     // Use the default scheduling policy (let the OS choose) 
     TRACE( TRACE_ALWAYS, "Default scheduling policy (OS)\n");
@@ -406,6 +420,33 @@ int ShoreSSBEnv::info() const
 
 int ShoreSSBEnv::statistics() 
 {
+#ifdef CFG_QPIPE
+    if (qpipe::coro_pool_t::enabled())
+        qpipe::coro_pool_t::instance()->print_stats();
+    qpipe::mem_broker_t::instance()->print_stats();
+    if (qpipe::result_cache_t::instance()->enabled())
+        qpipe::result_cache_t::instance()->print_stats();
+    if (qpipe::page_io_pool_t::instance() != NULL)
+        qpipe::page_io_pool_t::instance()->print_stats();
+#endif
+    return (0);
+}
+
+
+
+/******************************************************************** 
+ *
+ *  @fn:    mem_grants
+ *
+ *  @brief: Prints the memory grants of the QPipe packets
+ *
+ ********************************************************************/
+
+int ShoreSSBEnv::mem_grants() 
+{
+#ifdef CFG_QPIPE
+    qpipe::mem_broker_t::instance()->print_grants();
+#endif
     return (0);
 }
 
@@ -461,6 +502,9 @@ w_rc_t ShoreSSBEnv::loaddata()
     // 1. Call the function that initializes the dbgen
     ssb_dbgen_init();
 
+    // the tables are created empty, so is the zone map of LINEORDER
+    if (_plineorder_man->zonemaps()) _plineorder_man->zonemaps()->reset();
+
 
     time_t tstart = time(NULL);
 
@@ -517,6 +561,8 @@ w_rc_t ShoreSSBEnv::loaddata()
 	loaders[i]->join();
     }
 
+    W_DO(finish_bulkload(loaders_to_use));
+
     time_t tstop = time(NULL);
 
     // 5. Print stats
@@ -529,6 +575,11 @@ w_rc_t ShoreSSBEnv::loaddata()
     _loaded = true;
     chk->join();
 
+    // 7. Build the columnar replica of LINEORDER, if configured
+    if (envVar::instance()->getVarInt("db-columnar",0)) {
+        db_columns_init();
+    }
+
     return (RCOK);
 }
 
@@ -563,6 +614,22 @@ w_rc_t ShoreSSBEnv::warmup()
 }
 
 
+/****************************************************************** 
+ *
+ * @fn:    db_columns()
+ *
+ * @brief: (Re)builds the columnar replica of LINEORDER
+ *
+ ******************************************************************/
+
+w_rc_t ShoreSSBEnv::db_columns()
+{
+    _plineorder_man->enable_columns();
+    W_DO(_plineorder_man->refresh_columns(_pssm));
+    return (RCOK);
+}
+
+
 /******************************************************************** 
  *
  *  @fn:    dump
@@ -612,11 +679,13 @@ int ShoreSSBEnv::post_init()
 	db()->abort_xct();
 	return (rc.err_num());
     }
-    else {
-	TRACE( TRACE_ALWAYS, "-> Done\n");
-	db()->commit_xct();
-	return (0);
-    }
+    TRACE( TRACE_ALWAYS, "-> Done\n");
+    db()->commit_xct();
+
+    // the zone map of an existing database, if enabled
+    rc = _plineorder_man->refresh_zonemaps(db());
+    if (rc.is_error()) return (rc.err_num());
+    return (0);
 }
 
 
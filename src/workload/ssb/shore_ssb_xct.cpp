@@ -30,6 +30,7 @@
 
 #include "workload/ssb/shore_ssb_env.h"
 #include "workload/ssb/ssb_random.h"
+#include "workload/ssb/ssb_star_join.h"
 
 #include <vector>
 #include <map>
@@ -739,6 +740,83 @@ DEFINE_TRX(ShoreSSBEnv,qtest);
 //#define PRINT_TRX_RESULTS
 
 
+/******************************************************************** 
+ *
+ * SSB star joins
+ *
+ * @brief: The baseline Q1.1-Q4.3 run as star joins (ssb_star_join.h):
+ *         each dimension is scanned once into a direct-indexed array
+ *         and LINEORDER is scanned once, probing the arrays.
+ *
+ ********************************************************************/
+
+// the dimension columns the star joins use
+enum {
+    STAR_D_DATEKEY = 0, STAR_D_YEAR = 4, STAR_D_YEARMONTHNUM = 5,
+    STAR_D_YEARMONTH = 6, STAR_D_WEEKNUMINYEAR = 11
+};
+enum { STAR_P_PARTKEY = 0, STAR_P_MFGR = 2, STAR_P_CATEGORY = 3, STAR_P_BRAND = 4 };
+enum { STAR_S_SUPPKEY = 0, STAR_S_CITY = 3, STAR_S_NATION = 4, STAR_S_REGION = 5 };
+enum { STAR_C_CUSTKEY = 0, STAR_C_CITY = 3, STAR_C_NATION = 4, STAR_C_REGION = 5 };
+
+
+/******************************************************************** 
+ *
+ *  @fn:    star_scan
+ *
+ *  @brief: Scans a whole table, feeding each row to (sink), which is
+ *          either a star_dim_t (build) or a star_query_t (probe).
+ *          With (preds) the pages the zone maps rule out are skipped.
+ *
+ ********************************************************************/
+
+template <class TableDesc, class Sink>
+static w_rc_t star_scan(ss_m* db, table_man_impl<TableDesc>* pman, Sink& sink,
+                        const vector<column_pred_t>& preds = vector<column_pred_t>())
+{
+    tuple_guard< table_man_impl<TableDesc> > prrow(pman);
+    rep_row_t areprow(pman->ts());
+    areprow.set(pman->table()->maxsize());
+    prrow->_rep = &areprow;
+
+    guard< table_scan_iter_impl<TableDesc> > iter;
+    {
+	table_scan_iter_impl<TableDesc>* tmp_iter;
+	W_DO(pman->get_iter_for_file_scan(db, tmp_iter, preds));
+	iter = tmp_iter;
+    }
+
+    bool eof;
+    W_DO(iter->next(db, eof, *prrow));
+    while (!eof) {
+        sink.add_row(prrow);
+        W_DO(iter->next(db, eof, *prrow));
+    }
+    return (RCOK);
+}
+
+
+/******************************************************************** 
+ *
+ *  @fn:    star_join
+ *
+ *  @brief: Runs the LINEORDER pass of a query whose dimensions have
+ *          been built, and reports the result
+ *
+ ********************************************************************/
+
+static w_rc_t star_join(ss_m* db, lineorder_man_impl* plo_man, star_query_t& query)
+{
+    query.prepare();
+    vector<column_pred_t> preds;
+    query.scan_preds(preds);
+    W_DO(star_scan(db, plo_man, query, preds));
+    query.report();
+    return (RCOK);
+}
+
+
+
 /******************************************************************** 
  *
  * SSB QDATE
@@ -847,13 +925,31 @@ w_rc_t ShoreSSBEnv::xct_qtest(const int /* xct_id */,
  ********************************************************************/
 
 w_rc_t ShoreSSBEnv::xct_q1_1(const int /* xct_id */, 
-                            q1_1_input_t& /* in */)
+                            q1_1_input_t& in)
 {
     // ensure a valid environment
     assert (_pssm);
     assert (_initialized);
     assert (_loaded);
-    return (RC(smlevel_0::eNOTIMPLEMENTED));
+
+    /*
+      select sum(lo_extendedprice*lo_discount) as revenue
+      from lineorder, date
+      where lo_orderdate = d_datekey
+      and d_year = [YEAR]
+      and lo_discount between [DISCOUNT_LO] and [DISCOUNT_HI]
+      and lo_quantity < [QUANTITY];
+    */
+
+    star_dim_t date(STAR_D_DATEKEY, true);
+    date.where_int(STAR_D_YEAR, in.d_year);
+    W_DO(star_scan(_pssm, date_man(), date));
+
+    star_query_t query("q1_1", star_query_t::SUM_EXTPRICE_X_DISCOUNT);
+    query.join(star_query_t::LO_ORDERDATE, &date)
+        .where_discount(in.lo_discount_lo, in.lo_discount_hi)
+        .where_quantity(0, in.lo_quantity - 1);
+    return (star_join(_pssm, lineorder_man(), query));
 }
 
 
@@ -864,13 +960,31 @@ w_rc_t ShoreSSBEnv::xct_q1_1(const int /* xct_id */,
  ********************************************************************/
 
 w_rc_t ShoreSSBEnv::xct_q1_2(const int /* xct_id */, 
-                            q1_2_input_t& /* in */)
+                            q1_2_input_t& in)
 {
     // ensure a valid environment
     assert (_pssm);
     assert (_initialized);
     assert (_loaded);
-    return (RC(smlevel_0::eNOTIMPLEMENTED));
+
+    /*
+      select sum(lo_extendedprice*lo_discount) as revenue
+      from lineorder, date
+      where lo_orderdate = d_datekey
+      and d_yearmonthnum = [YEARMONTHNUM]
+      and lo_discount between [DISCOUNT_LO] and [DISCOUNT_HI]
+      and lo_quantity between [QUANTITY_LO] and [QUANTITY_HI];
+    */
+
+    star_dim_t date(STAR_D_DATEKEY, true);
+    date.where_int(STAR_D_YEARMONTHNUM, in.d_yearmonthnum);
+    W_DO(star_scan(_pssm, date_man(), date));
+
+    star_query_t query("q1_2", star_query_t::SUM_EXTPRICE_X_DISCOUNT);
+    query.join(star_query_t::LO_ORDERDATE, &date)
+        .where_discount(in.lo_discount_lo, in.lo_discount_hi)
+        .where_quantity(in.lo_quantity_lo, in.lo_quantity_hi);
+    return (star_join(_pssm, lineorder_man(), query));
 }
 
 
@@ -881,13 +995,33 @@ w_rc_t ShoreSSBEnv::xct_q1_2(const int /* xct_id */,
  ********************************************************************/
 
 w_rc_t ShoreSSBEnv::xct_q1_3(const int /* xct_id */, 
-                            q1_3_input_t& /* in */)
+                            q1_3_input_t& in)
 {
     // ensure a valid environment
     assert (_pssm);
     assert (_initialized);
     assert (_loaded);
-    return (RC(smlevel_0::eNOTIMPLEMENTED));
+
+    /*
+      select sum(lo_extendedprice*lo_discount) as revenue
+      from lineorder, date
+      where lo_orderdate = d_datekey
+      and d_weeknuminyear = [WEEK]
+      and d_year = [YEAR]
+      and lo_discount between [DISCOUNT_LO] and [DISCOUNT_HI]
+      and lo_quantity between [QUANTITY_LO] and [QUANTITY_HI];
+    */
+
+    star_dim_t date(STAR_D_DATEKEY, true);
+    date.where_int(STAR_D_WEEKNUMINYEAR, in.d_weeknuminyear)
+        .where_int(STAR_D_YEAR, in.d_year);
+    W_DO(star_scan(_pssm, date_man(), date));
+
+    star_query_t query("q1_3", star_query_t::SUM_EXTPRICE_X_DISCOUNT);
+    query.join(star_query_t::LO_ORDERDATE, &date)
+        .where_discount(in.lo_discount_lo, in.lo_discount_hi)
+        .where_quantity(in.lo_quantity_lo, in.lo_quantity_hi);
+    return (star_join(_pssm, lineorder_man(), query));
 }
 
 
@@ -899,13 +1033,43 @@ w_rc_t ShoreSSBEnv::xct_q1_3(const int /* xct_id */,
  ********************************************************************/
 
 w_rc_t ShoreSSBEnv::xct_q2_1(const int /* xct_id */, 
-                            q2_1_input_t& /* in */)
+                            q2_1_input_t& in)
 {
     // ensure a valid environment
     assert (_pssm);
     assert (_initialized);
     assert (_loaded);
-    return (RC(smlevel_0::eNOTIMPLEMENTED));
+
+    /*
+      select sum(lo_revenue), d_year, p_brand
+      from lineorder, date, part, supplier
+      where lo_orderdate = d_datekey
+      and lo_partkey = p_partkey
+      and lo_suppkey = s_suppkey
+      and p_category = [CATEGORY]
+      and s_region = [REGION]
+      group by d_year, p_brand
+      order by d_year, p_brand;
+    */
+
+    star_dim_t date(STAR_D_DATEKEY, true);
+    date.group_by_int(STAR_D_YEAR);
+    W_DO(star_scan(_pssm, date_man(), date));
+
+    star_dim_t part(STAR_P_PARTKEY);
+    part.where_str(STAR_P_CATEGORY, in.p_category)
+        .group_by_str(STAR_P_BRAND);
+    W_DO(star_scan(_pssm, part_man(), part));
+
+    star_dim_t supp(STAR_S_SUPPKEY);
+    supp.where_str(STAR_S_REGION, in.s_region);
+    W_DO(star_scan(_pssm, supplier_man(), supp));
+
+    star_query_t query("q2_1", star_query_t::SUM_REVENUE);
+    query.join(star_query_t::LO_ORDERDATE, &date)
+        .join(star_query_t::LO_PARTKEY, &part)
+        .join(star_query_t::LO_SUPPKEY, &supp);
+    return (star_join(_pssm, lineorder_man(), query));
 }
 
 
@@ -916,13 +1080,43 @@ w_rc_t ShoreSSBEnv::xct_q2_1(const int /* xct_id */,
  ********************************************************************/
 
 w_rc_t ShoreSSBEnv::xct_q2_2(const int /* xct_id */, 
-                            q2_2_input_t& /* in */)
+                            q2_2_input_t& in)
 {
     // ensure a valid environment
     assert (_pssm);
     assert (_initialized);
     assert (_loaded);
-    return (RC(smlevel_0::eNOTIMPLEMENTED));
+
+    /*
+      select sum(lo_revenue), d_year, p_brand
+      from lineorder, date, part, supplier
+      where lo_orderdate = d_datekey
+      and lo_partkey = p_partkey
+      and lo_suppkey = s_suppkey
+      and p_brand between [BRAND_1] and [BRAND_2]
+      and s_region = [REGION]
+      group by d_year, p_brand
+      order by d_year, p_brand;
+    */
+
+    star_dim_t date(STAR_D_DATEKEY, true);
+    date.group_by_int(STAR_D_YEAR);
+    W_DO(star_scan(_pssm, date_man(), date));
+
+    star_dim_t part(STAR_P_PARTKEY);
+    part.where_str_between(STAR_P_BRAND, in.p_brand_1, in.p_brand_2)
+        .group_by_str(STAR_P_BRAND);
+    W_DO(star_scan(_pssm, part_man(), part));
+
+    star_dim_t supp(STAR_S_SUPPKEY);
+    supp.where_str(STAR_S_REGION, in.s_region);
+    W_DO(star_scan(_pssm, supplier_man(), supp));
+
+    star_query_t query("q2_2", star_query_t::SUM_REVENUE);
+    query.join(star_query_t::LO_ORDERDATE, &date)
+        .join(star_query_t::LO_PARTKEY, &part)
+        .join(star_query_t::LO_SUPPKEY, &supp);
+    return (star_join(_pssm, lineorder_man(), query));
 }
 
 
@@ -933,13 +1127,43 @@ w_rc_t ShoreSSBEnv::xct_q2_2(const int /* xct_id */,
  ********************************************************************/
 
 w_rc_t ShoreSSBEnv::xct_q2_3(const int /* xct_id */, 
-                            q2_3_input_t& /* in */)
+                            q2_3_input_t& in)
 {
     // ensure a valid environment
     assert (_pssm);
     assert (_initialized);
     assert (_loaded);
-    return (RC(smlevel_0::eNOTIMPLEMENTED));
+
+    /*
+      select sum(lo_revenue), d_year, p_brand
+      from lineorder, date, part, supplier
+      where lo_orderdate = d_datekey
+      and lo_partkey = p_partkey
+      and lo_suppkey = s_suppkey
+      and p_brand = [BRAND]
+      and s_region = [REGION]
+      group by d_year, p_brand
+      order by d_year, p_brand;
+    */
+
+    star_dim_t date(STAR_D_DATEKEY, true);
+    date.group_by_int(STAR_D_YEAR);
+    W_DO(star_scan(_pssm, date_man(), date));
+
+    star_dim_t part(STAR_P_PARTKEY);
+    part.where_str(STAR_P_BRAND, in.p_brand)
+        .group_by_str(STAR_P_BRAND);
+    W_DO(star_scan(_pssm, part_man(), part));
+
+    star_dim_t supp(STAR_S_SUPPKEY);
+    supp.where_str(STAR_S_REGION, in.s_region);
+    W_DO(star_scan(_pssm, supplier_man(), supp));
+
+    star_query_t query("q2_3", star_query_t::SUM_REVENUE);
+    query.join(star_query_t::LO_ORDERDATE, &date)
+        .join(star_query_t::LO_PARTKEY, &part)
+        .join(star_query_t::LO_SUPPKEY, &supp);
+    return (star_join(_pssm, lineorder_man(), query));
 }
 
 
@@ -951,13 +1175,47 @@ w_rc_t ShoreSSBEnv::xct_q2_3(const int /* xct_id */,
  ********************************************************************/
 
 w_rc_t ShoreSSBEnv::xct_q3_1(const int /* xct_id */, 
-                            q3_1_input_t& /* in */)
+                            q3_1_input_t& in)
 {
     // ensure a valid environment
     assert (_pssm);
     assert (_initialized);
     assert (_loaded);
-    return (RC(smlevel_0::eNOTIMPLEMENTED));
+
+    /*
+      select c_nation, s_nation, d_year, sum(lo_revenue) as revenue
+      from customer, lineorder, supplier, date
+      where lo_custkey = c_custkey
+      and lo_suppkey = s_suppkey
+      and lo_orderdate = d_datekey
+      and c_region = [C_REGION]
+      and s_region = [S_REGION]
+      and d_year >= [YEAR_LO] and d_year <= [YEAR_HI]
+      group by c_nation, s_nation, d_year
+      order by d_year asc, revenue desc;
+    */
+
+    star_dim_t date(STAR_D_DATEKEY, true);
+    date.where_int_between(STAR_D_YEAR, in._year_lo, in._year_hi)
+        .group_by_int(STAR_D_YEAR);
+    W_DO(star_scan(_pssm, date_man(), date));
+
+    star_dim_t cust(STAR_C_CUSTKEY);
+    cust.where_str(STAR_C_REGION, in.c_region)
+        .group_by_str(STAR_C_NATION);
+    W_DO(star_scan(_pssm, customer_man(), cust));
+
+    star_dim_t supp(STAR_S_SUPPKEY);
+    supp.where_str(STAR_S_REGION, in.s_region)
+        .group_by_str(STAR_S_NATION);
+    W_DO(star_scan(_pssm, supplier_man(), supp));
+
+    star_query_t query("q3_1", star_query_t::SUM_REVENUE);
+    query.join(star_query_t::LO_ORDERDATE, &date)
+        .join(star_query_t::LO_CUSTKEY, &cust)
+        .join(star_query_t::LO_SUPPKEY, &supp)
+        .order_by_value_desc();
+    return (star_join(_pssm, lineorder_man(), query));
 }
 
 
@@ -968,13 +1226,47 @@ w_rc_t ShoreSSBEnv::xct_q3_1(const int /* xct_id */,
  ********************************************************************/
 
 w_rc_t ShoreSSBEnv::xct_q3_2(const int /* xct_id */, 
-                            q3_2_input_t& /* in */)
+                            q3_2_input_t& in)
 {
     // ensure a valid environment
     assert (_pssm);
     assert (_initialized);
     assert (_loaded);
-    return (RC(smlevel_0::eNOTIMPLEMENTED));
+
+    /*
+      select c_city, s_city, d_year, sum(lo_revenue) as revenue
+      from customer, lineorder, supplier, date
+      where lo_custkey = c_custkey
+      and lo_suppkey = s_suppkey
+      and lo_orderdate = d_datekey
+      and c_nation = [NATION]
+      and s_nation = [NATION]
+      and d_year >= [YEAR_LO] and d_year <= [YEAR_HI]
+      group by c_city, s_city, d_year
+      order by d_year asc, revenue desc;
+    */
+
+    star_dim_t date(STAR_D_DATEKEY, true);
+    date.where_int_between(STAR_D_YEAR, in._year_lo, in._year_hi)
+        .group_by_int(STAR_D_YEAR);
+    W_DO(star_scan(_pssm, date_man(), date));
+
+    star_dim_t cust(STAR_C_CUSTKEY);
+    cust.where_str(STAR_C_NATION, in._nation)
+        .group_by_str(STAR_C_CITY);
+    W_DO(star_scan(_pssm, customer_man(), cust));
+
+    star_dim_t supp(STAR_S_SUPPKEY);
+    supp.where_str(STAR_S_NATION, in._nation)
+        .group_by_str(STAR_S_CITY);
+    W_DO(star_scan(_pssm, supplier_man(), supp));
+
+    star_query_t query("q3_2", star_query_t::SUM_REVENUE);
+    query.join(star_query_t::LO_ORDERDATE, &date)
+        .join(star_query_t::LO_CUSTKEY, &cust)
+        .join(star_query_t::LO_SUPPKEY, &supp)
+        .order_by_value_desc();
+    return (star_join(_pssm, lineorder_man(), query));
 }
 
 
@@ -985,13 +1277,47 @@ w_rc_t ShoreSSBEnv::xct_q3_2(const int /* xct_id */,
  ********************************************************************/
 
 w_rc_t ShoreSSBEnv::xct_q3_3(const int /* xct_id */, 
-                            q3_3_input_t& /* in */)
+                            q3_3_input_t& in)
 {
     // ensure a valid environment
     assert (_pssm);
     assert (_initialized);
     assert (_loaded);
-    return (RC(smlevel_0::eNOTIMPLEMENTED));
+
+    /*
+      select c_city, s_city, d_year, sum(lo_revenue) as revenue
+      from customer, lineorder, supplier, date
+      where lo_custkey = c_custkey
+      and lo_suppkey = s_suppkey
+      and lo_orderdate = d_datekey
+      and (c_city = [C_CITY_1] or c_city = [C_CITY_2])
+      and (s_city = [S_CITY_1] or s_city = [S_CITY_2])
+      and d_year >= [YEAR_LO] and d_year <= [YEAR_HI]
+      group by c_city, s_city, d_year
+      order by d_year asc, revenue desc;
+    */
+
+    star_dim_t date(STAR_D_DATEKEY, true);
+    date.where_int_between(STAR_D_YEAR, in._year_lo, in._year_hi)
+        .group_by_int(STAR_D_YEAR);
+    W_DO(star_scan(_pssm, date_man(), date));
+
+    star_dim_t cust(STAR_C_CUSTKEY);
+    cust.where_str_in(STAR_C_CITY, in.c_city_1, in.c_city_2)
+        .group_by_str(STAR_C_CITY);
+    W_DO(star_scan(_pssm, customer_man(), cust));
+
+    star_dim_t supp(STAR_S_SUPPKEY);
+    supp.where_str_in(STAR_S_CITY, in.s_city_1, in.s_city_2)
+        .group_by_str(STAR_S_CITY);
+    W_DO(star_scan(_pssm, supplier_man(), supp));
+
+    star_query_t query("q3_3", star_query_t::SUM_REVENUE);
+    query.join(star_query_t::LO_ORDERDATE, &date)
+        .join(star_query_t::LO_CUSTKEY, &cust)
+        .join(star_query_t::LO_SUPPKEY, &supp)
+        .order_by_value_desc();
+    return (star_join(_pssm, lineorder_man(), query));
 }
 
 /******************************************************************** 
@@ -1001,13 +1327,47 @@ w_rc_t ShoreSSBEnv::xct_q3_3(const int /* xct_id */,
  ********************************************************************/
 
 w_rc_t ShoreSSBEnv::xct_q3_4(const int /* xct_id */, 
-                            q3_4_input_t& /* in */)
+                            q3_4_input_t& in)
 {
     // ensure a valid environment
     assert (_pssm);
     assert (_initialized);
     assert (_loaded);
-    return (RC(smlevel_0::eNOTIMPLEMENTED));
+
+    /*
+      select c_city, s_city, d_year, sum(lo_revenue) as revenue
+      from customer, lineorder, supplier, date
+      where lo_custkey = c_custkey
+      and lo_suppkey = s_suppkey
+      and lo_orderdate = d_datekey
+      and (c_city = [C_CITY_1] or c_city = [C_CITY_2])
+      and (s_city = [S_CITY_1] or s_city = [S_CITY_2])
+      and d_yearmonth = [YEARMONTH]
+      group by c_city, s_city, d_year
+      order by d_year asc, revenue desc;
+    */
+
+    star_dim_t date(STAR_D_DATEKEY, true);
+    date.where_str(STAR_D_YEARMONTH, in.d_yearmonth)
+        .group_by_int(STAR_D_YEAR);
+    W_DO(star_scan(_pssm, date_man(), date));
+
+    star_dim_t cust(STAR_C_CUSTKEY);
+    cust.where_str_in(STAR_C_CITY, in.c_city_1, in.c_city_2)
+        .group_by_str(STAR_C_CITY);
+    W_DO(star_scan(_pssm, customer_man(), cust));
+
+    star_dim_t supp(STAR_S_SUPPKEY);
+    supp.where_str_in(STAR_S_CITY, in.s_city_1, in.s_city_2)
+        .group_by_str(STAR_S_CITY);
+    W_DO(star_scan(_pssm, supplier_man(), supp));
+
+    star_query_t query("q3_4", star_query_t::SUM_REVENUE);
+    query.join(star_query_t::LO_ORDERDATE, &date)
+        .join(star_query_t::LO_CUSTKEY, &cust)
+        .join(star_query_t::LO_SUPPKEY, &supp)
+        .order_by_value_desc();
+    return (star_join(_pssm, lineorder_man(), query));
 }
 
 
@@ -1019,13 +1379,50 @@ w_rc_t ShoreSSBEnv::xct_q3_4(const int /* xct_id */,
  ********************************************************************/
 
 w_rc_t ShoreSSBEnv::xct_q4_1(const int /* xct_id */, 
-                            q4_1_input_t& /* in */)
+                            q4_1_input_t& in)
 {
     // ensure a valid environment
     assert (_pssm);
     assert (_initialized);
     assert (_loaded);
-    return (RC(smlevel_0::eNOTIMPLEMENTED));
+
+    /*
+      select d_year, c_nation, sum(lo_revenue - lo_supplycost) as profit
+      from date, customer, supplier, part, lineorder
+      where lo_custkey = c_custkey
+      and lo_suppkey = s_suppkey
+      and lo_partkey = p_partkey
+      and lo_orderdate = d_datekey
+      and c_region = [C_REGION]
+      and s_region = [S_REGION]
+      and (p_mfgr = [MFGR_1] or p_mfgr = [MFGR_2])
+      group by d_year, c_nation
+      order by d_year, c_nation;
+    */
+
+    star_dim_t date(STAR_D_DATEKEY, true);
+    date.group_by_int(STAR_D_YEAR);
+    W_DO(star_scan(_pssm, date_man(), date));
+
+    star_dim_t cust(STAR_C_CUSTKEY);
+    cust.where_str(STAR_C_REGION, in.c_region)
+        .group_by_str(STAR_C_NATION);
+    W_DO(star_scan(_pssm, customer_man(), cust));
+
+    star_dim_t supp(STAR_S_SUPPKEY);
+    supp.where_str(STAR_S_REGION, in.s_region);
+    W_DO(star_scan(_pssm, supplier_man(), supp));
+
+    star_dim_t part(STAR_P_PARTKEY);
+    part.where_str_in(STAR_P_MFGR, in.p_mfgr_1, in.p_mfgr_2);
+    W_DO(star_scan(_pssm, part_man(), part));
+
+    star_query_t query("q4_1", star_query_t::SUM_PROFIT);
+    query.join(star_query_t::LO_ORDERDATE, &date)
+        .join(star_query_t::LO_CUSTKEY, &cust)
+        .join(star_query_t::LO_SUPPKEY, &supp)
+        .join(star_query_t::LO_PARTKEY, &part);
+    return (star_join(_pssm, lineorder_man(), query));
 }
 
 
@@ -1036,13 +1433,54 @@ w_rc_t ShoreSSBEnv::xct_q4_1(const int /* xct_id */,
  ********************************************************************/
 
 w_rc_t ShoreSSBEnv::xct_q4_2(const int /* xct_id */, 
-                            q4_2_input_t& /* in */)
+                            q4_2_input_t& in)
 {
     // ensure a valid environment
     assert (_pssm);
     assert (_initialized);
     assert (_loaded);
-    return (RC(smlevel_0::eNOTIMPLEMENTED));
+
+    /*
+      select d_year, s_nation, p_category,
+      sum(lo_revenue - lo_supplycost) as profit
+      from date, customer, supplier, part, lineorder
+      where lo_custkey = c_custkey
+      and lo_suppkey = s_suppkey
+      and lo_partkey = p_partkey
+      and lo_orderdate = d_datekey
+      and c_region = [C_REGION]
+      and s_region = [S_REGION]
+      and (d_year = [YEAR_1] or d_year = [YEAR_2])
+      and (p_mfgr = [MFGR_1] or p_mfgr = [MFGR_2])
+      group by d_year, s_nation, p_category
+      order by d_year, s_nation, p_category;
+    */
+
+    star_dim_t date(STAR_D_DATEKEY, true);
+    date.where_int_in(STAR_D_YEAR, in.d_year_1, in.d_year_2)
+        .group_by_int(STAR_D_YEAR);
+    W_DO(star_scan(_pssm, date_man(), date));
+
+    star_dim_t supp(STAR_S_SUPPKEY);
+    supp.where_str(STAR_S_REGION, in.s_region)
+        .group_by_str(STAR_S_NATION);
+    W_DO(star_scan(_pssm, supplier_man(), supp));
+
+    star_dim_t part(STAR_P_PARTKEY);
+    part.where_str_in(STAR_P_MFGR, in.p_mfgr_1, in.p_mfgr_2)
+        .group_by_str(STAR_P_CATEGORY);
+    W_DO(star_scan(_pssm, part_man(), part));
+
+    star_dim_t cust(STAR_C_CUSTKEY);
+    cust.where_str(STAR_C_REGION, in.c_region);
+    W_DO(star_scan(_pssm, customer_man(), cust));
+
+    star_query_t query("q4_2", star_query_t::SUM_PROFIT);
+    query.join(star_query_t::LO_ORDERDATE, &date)
+        .join(star_query_t::LO_SUPPKEY, &supp)
+        .join(star_query_t::LO_PARTKEY, &part)
+        .join(star_query_t::LO_CUSTKEY, &cust);
+    return (star_join(_pssm, lineorder_man(), query));
 }
 
 
@@ -1053,13 +1491,51 @@ w_rc_t ShoreSSBEnv::xct_q4_2(const int /* xct_id */,
  ********************************************************************/
 
 w_rc_t ShoreSSBEnv::xct_q4_3(const int /* xct_id */, 
-                            q4_3_input_t& /* in */)
+                            q4_3_input_t& in)
 {
     // ensure a valid environment
     assert (_pssm);
     assert (_initialized);
     assert (_loaded);
-    return (RC(smlevel_0::eNOTIMPLEMENTED));
+
+    /*
+      select d_year, s_city, p_brand,
+      sum(lo_revenue - lo_supplycost) as profit
+      from date, customer, supplier, part, lineorder
+      where lo_custkey = c_custkey
+      and lo_suppkey = s_suppkey
+      and lo_partkey = p_partkey
+      and lo_orderdate = d_datekey
+      and s_nation = [NATION]
+      and (d_year = [YEAR_1] or d_year = [YEAR_2])
+      and p_category = [CATEGORY]
+      group by d_year, s_city, p_brand
+      order by d_year, s_city, p_brand;
+
+      The customer join has no predicate here (as in the QPipe plan)
+      and every lineorder has a customer, so it is not probed.
+    */
+
+    star_dim_t date(STAR_D_DATEKEY, true);
+    date.where_int_in(STAR_D_YEAR, in.d_year_1, in.d_year_2)
+        .group_by_int(STAR_D_YEAR);
+    W_DO(star_scan(_pssm, date_man(), date));
+
+    star_dim_t supp(STAR_S_SUPPKEY);
+    supp.where_str(STAR_S_NATION, in.s_nation)
+        .group_by_str(STAR_S_CITY);
+    W_DO(star_scan(_pssm, supplier_man(), supp));
+
+    star_dim_t part(STAR_P_PARTKEY);
+    part.where_str(STAR_P_CATEGORY, in.p_category)
+        .group_by_str(STAR_P_BRAND);
+    W_DO(star_scan(_pssm, part_man(), part));
+
+    star_query_t query("q4_3", star_query_t::SUM_PROFIT);
+    query.join(star_query_t::LO_ORDERDATE, &date)
+        .join(star_query_t::LO_SUPPKEY, &supp)
+        .join(star_query_t::LO_PARTKEY, &part);
+    return (star_join(_pssm, lineorder_man(), query));
 }
 
 
@@ -0,0 +1,460 @@
+/* -*- mode:C++; c-basic-offset:4 -*-
+     Shore-kits -- Benchmark implementations for Shore-MT
+
+                       Copyright (c) 2007-2009
+      Data Intensive Applications and Systems Labaratory (DIAS)
+               Ecole Polytechnique Federale de Lausanne
+
+                         All Rights Reserved.
+
+   Permission to use, copy, modify and distribute this software and
+   its documentation is hereby granted, provided that both the
+   copyright notice and this permission notice appear in all copies of
+   the software, derivative works or modified versions, and any
+   portions thereof, and that both notices appear in supporting
+   documentation.
+
+   This code is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS
+   DISCLAIM ANY LIABILITY OF ANY KIND FOR ANY DAMAGES WHATSOEVER
+   RESULTING FROM THE USE OF THIS SOFTWARE.
+*/
+
+/** @file:   ssb_star_join.cpp
+ *
+ *  @brief:  Implementation of the single-pass SSB star-join executor
+ */
+
+#include "workload/ssb/ssb_star_join.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+
+ENTER_NAMESPACE(ssb);
+
+
+// large enough for any SSB fixchar column
+static const uint STAR_STR_BUF = 64;
+
+
+/******************************************************************** 
+ *
+ * star_cond_t
+ *
+ ********************************************************************/
+
+bool star_cond_t::test(const table_row_t* prow) const
+{
+    switch (_op) {
+    case STR_IN:
+    case STR_BETWEEN: {
+        char buf[STAR_STR_BUF];
+        prow->get_value(_field, buf, STAR_STR_BUF);
+        if (_op == STR_IN)
+            return ((_s1 == buf) || (_s2.size() && _s2 == buf));
+        return ((strcmp(buf, _s1.c_str()) >= 0) && (strcmp(buf, _s2.c_str()) <= 0));
+    }
+    case INT_IN:
+    case INT_BETWEEN: {
+        int v;
+        prow->get_value(_field, v);
+        if (_op == INT_IN)
+            return ((v == _i1) || (v == _i2));
+        return ((v >= _i1) && (v <= _i2));
+    }
+    }
+    assert (0); // UNKNOWN OP
+    return (false);
+}
+
+
+
+/******************************************************************** 
+ *
+ * star_dim_t
+ *
+ ********************************************************************/
+
+star_dim_t::star_dim_t(const uint key_field, const bool date_key)
+    : _key_field(key_field), _date_key(date_key),
+      _group_field(-1), _group_int(false), _selected(0), _rows(0),
+      _min_key(0), _max_key(0)
+{
+    // a dimension that is not grouped by has a single group
+    _labels.push_back(string());
+}
+
+star_dim_t& star_dim_t::_add(const star_cond_t& cond)
+{
+    _conds.push_back(cond);
+    return (*this);
+}
+
+star_dim_t& star_dim_t::where_str(const uint field, const char* value)
+{
+    return (where_str_in(field, value, ""));
+}
+
+star_dim_t& star_dim_t::where_str_in(const uint field, 
+                                     const char* v1, const char* v2)
+{
+    star_cond_t c;
+    c._op = star_cond_t::STR_IN;
+    c._field = field;
+    c._s1 = v1;
+    c._s2 = v2;
+    return (_add(c));
+}
+
+star_dim_t& star_dim_t::where_str_between(const uint field, 
+                                          const char* lo, const char* hi)
+{
+    star_cond_t c;
+    c._op = star_cond_t::STR_BETWEEN;
+    c._field = field;
+    c._s1 = lo;
+    c._s2 = hi;
+    return (_add(c));
+}
+
+star_dim_t& star_dim_t::where_int(const uint field, const int value)
+{
+    return (where_int_in(field, value, value));
+}
+
+star_dim_t& star_dim_t::where_int_in(const uint field, const int v1, const int v2)
+{
+    star_cond_t c;
+    c._op = star_cond_t::INT_IN;
+    c._field = field;
+    c._i1 = v1;
+    c._i2 = v2;
+    return (_add(c));
+}
+
+star_dim_t& star_dim_t::where_int_between(const uint field, const int lo, const int hi)
+{
+    star_cond_t c;
+    c._op = star_cond_t::INT_BETWEEN;
+    c._field = field;
+    c._i1 = lo;
+    c._i2 = hi;
+    return (_add(c));
+}
+
+star_dim_t& star_dim_t::group_by_str(const uint field)
+{
+    _group_field = field;
+    _group_int = false;
+    _labels.clear();
+    return (*this);
+}
+
+star_dim_t& star_dim_t::group_by_int(const uint field)
+{
+    _group_field = field;
+    _group_int = true;
+    _labels.clear();
+    return (*this);
+}
+
+
+/******************************************************************** 
+ *
+ *  @fn:    add_row
+ *
+ *  @brief: Tests a dimension row and, if it passes, records the code
+ *          of its group in the slot of its key. Group codes are
+ *          handed out in order of first appearance; report() sorts.
+ *
+ ********************************************************************/
+
+void star_dim_t::add_row(const table_row_t* prow)
+{
+    ++_rows;
+    for (uint i=0; i<_conds.size(); i++) {
+        if (!_conds[i].test(prow)) 
+            return;
+    }
+
+    int key;
+    prow->get_value(_key_field, key);
+    if (!_selected || (key < _min_key)) _min_key = key;
+    if (!_selected || (key > _max_key)) _max_key = key;
+    uint slot = (_date_key ? date_slot(key) : key);
+    assert (slot < (1u<<30)); // keys are expected to be dense
+    if (slot >= _code.size())
+        _code.resize(std::max((size_t)slot+1, 2*_code.size()), NOT_SELECTED);
+
+    int code = 0;
+    if (_group_field >= 0) {
+        char buf[STAR_STR_BUF];
+        if (_group_int) {
+            int v;
+            prow->get_value(_group_field, v);
+            snprintf(buf, STAR_STR_BUF, "%d", v);
+        }
+        else {
+            prow->get_value(_group_field, buf, STAR_STR_BUF);
+        }
+
+        map<string,int>::iterator it = _dict.find(buf);
+        if (it == _dict.end()) {
+            code = _labels.size();
+            _labels.push_back(buf);
+            _dict[buf] = code;
+        }
+        else {
+            code = it->second;
+        }
+    }
+
+    _code[slot] = code;
+    ++_selected;
+}
+
+
+
+/******************************************************************** 
+ *
+ * star_query_t
+ *
+ ********************************************************************/
+
+star_query_t::star_query_t(const char* name, const measure_t measure)
+    : _name(name), _measure(measure),
+      _has_disc(false), _disc_lo(0), _disc_hi(0),
+      _has_qty(false), _qty_lo(0), _qty_hi(0),
+      _value_desc(false), _scanned(0), _joined(0)
+{
+}
+
+star_query_t& star_query_t::join(const uint lo_field, const star_dim_t* dim)
+{
+    join_t j;
+    j._lo_field = lo_field;
+    j._dim = dim;
+    j._stride = 0;
+    _joins.push_back(j);
+    return (*this);
+}
+
+star_query_t& star_query_t::where_discount(const int lo, const int hi)
+{
+    _has_disc = true;
+    _disc_lo = lo;
+    _disc_hi = hi;
+    return (*this);
+}
+
+star_query_t& star_query_t::where_quantity(const int lo, const int hi)
+{
+    _has_qty = true;
+    _qty_lo = lo;
+    _qty_hi = hi;
+    return (*this);
+}
+
+star_query_t& star_query_t::order_by_value_desc()
+{
+    _value_desc = true;
+    return (*this);
+}
+
+
+/******************************************************************** 
+ *
+ *  @fn:    prepare
+ *
+ *  @brief: The group index of a row is sum(code_i * stride_i), with
+ *          the first join as the most significant digit, so walking
+ *          the table in index order walks the groups in join order.
+ *
+ ********************************************************************/
+
+struct probe_less_t
+{
+    const vector<star_query_t::join_t>& _joins;
+    probe_less_t(const vector<star_query_t::join_t>& joins) : _joins(joins) { }
+
+    bool operator()(uint a, uint b) const {
+        return (_joins[a]._dim->selectivity() < _joins[b]._dim->selectivity());
+    }
+};
+
+void star_query_t::prepare()
+{
+    uint size = 1;
+    for (int i=_joins.size()-1; i>=0; i--) {
+        _joins[i]._stride = size;
+        size *= std::max(_joins[i]._dim->groups(), 1u);
+    }
+    _sums.assign(size, 0);
+    _hits.assign(size, 0);
+
+    // probe the most selective dimension first
+    _probe.clear();
+    for (uint i=0; i<_joins.size(); i++)
+        _probe.push_back(i);
+    std::stable_sort(_probe.begin(), _probe.end(), probe_less_t(_joins));
+    _scanned = 0;
+    _joined = 0;
+
+    TRACE( TRACE_DEBUG, "%s: %d groups\n", _name, size);
+}
+
+
+void star_query_t::scan_preds(vector<column_pred_t>& preds) const
+{
+    preds.clear();
+    for (uint i=0; i<_joins.size(); i++) {
+        const star_dim_t* dim = _joins[i]._dim;
+        if (dim->selected()) {
+            preds.push_back(column_pred_t(_joins[i]._lo_field).
+                            ge(dim->min_key()).le(dim->max_key()));
+        }
+        else {
+            // nothing joins
+            preds.push_back(column_pred_t(_joins[i]._lo_field).ge(1).le(0));
+        }
+    }
+    if (_has_disc) {
+        preds.push_back(column_pred_t(LO_DISCOUNT).ge(_disc_lo).le(_disc_hi));
+    }
+    if (_has_qty) {
+        preds.push_back(column_pred_t(LO_QUANTITY).ge(_qty_lo).le(_qty_hi));
+    }
+}
+
+
+void star_query_t::add_row(const table_row_t* prow)
+{
+    ++_scanned;
+
+    // the cheap LINEORDER predicates first (Q1.x)
+    if (_has_disc) {
+        int disc;
+        prow->get_value(LO_DISCOUNT, disc);
+        if ((disc < _disc_lo) || (disc > _disc_hi)) 
+            return;
+    }
+    if (_has_qty) {
+        int qty;
+        prow->get_value(LO_QUANTITY, qty);
+        if ((qty < _qty_lo) || (qty > _qty_hi)) 
+            return;
+    }
+
+    // probe the dimensions, stopping at the first miss
+    uint idx = 0;
+    for (uint p=0; p<_probe.size(); p++) {
+        const join_t& j = _joins[_probe[p]];
+        int key;
+        prow->get_value(j._lo_field, key);
+        int code = j._dim->probe(key);
+        if (code == star_dim_t::NOT_SELECTED) 
+            return;
+        idx += code * j._stride;
+    }
+    ++_joined;
+
+    long long value = 0;
+    switch (_measure) {
+    case SUM_EXTPRICE_X_DISCOUNT: {
+        int price, disc;
+        prow->get_value(LO_EXTENDEDPRICE, price);
+        prow->get_value(LO_DISCOUNT, disc);
+        value = (long long)price * disc;
+        break;
+    }
+    case SUM_REVENUE: {
+        int revenue;
+        prow->get_value(LO_REVENUE, revenue);
+        value = revenue;
+        break;
+    }
+    case SUM_PROFIT: {
+        int revenue, cost;
+        prow->get_value(LO_REVENUE, revenue);
+        prow->get_value(LO_SUPPLYCOST, cost);
+        value = (long long)revenue - cost;
+        break;
+    }
+    }
+
+    _sums[idx] += value;
+    ++_hits[idx];
+}
+
+
+/******************************************************************** 
+ *
+ *  @fn:    report
+ *
+ *  @brief: Decodes the non-empty groups, sorts them by their labels
+ *          (and by the measure if order_by_value_desc()) and traces
+ *          them at TRACE_QUERY_RESULTS.
+ *
+ ********************************************************************/
+
+struct star_row_t
+{
+    vector<const string*> _labels;
+    long long _value;
+};
+
+struct star_row_less_t
+{
+    bool _value_desc;
+    star_row_less_t(bool value_desc) : _value_desc(value_desc) { }
+
+    bool operator()(const star_row_t& a, const star_row_t& b) const {
+        size_t n = a._labels.size();
+        for (size_t i=0; i<n; i++) {
+            if (_value_desc && (i == 1) && (a._value != b._value))
+                return (a._value > b._value);
+            int c = a._labels[i]->compare(*b._labels[i]);
+            if (c) return (c < 0);
+        }
+        return (false);
+    }
+};
+
+uint star_query_t::report() const
+{
+    vector<star_row_t> rows;
+    for (uint idx=0; idx<_sums.size(); idx++) {
+        if (!_hits[idx]) 
+            continue;
+
+        star_row_t row;
+        row._value = _sums[idx];
+        uint rest = idx;
+        for (uint i=0; i<_joins.size(); i++) {
+            uint code = rest / _joins[i]._stride;
+            rest %= _joins[i]._stride;
+            if (_joins[i]._dim->grouped())
+                row._labels.push_back(&_joins[i]._dim->label(code));
+        }
+        rows.push_back(row);
+    }
+    std::sort(rows.begin(), rows.end(), star_row_less_t(_value_desc));
+
+    TRACE( TRACE_QUERY_RESULTS, "*** %s ANSWER (%lld rows scanned, %lld joined)\n",
+           _name, _scanned, _joined);
+    for (uint r=0; r<rows.size(); r++) {
+        string line;
+        for (uint i=0; i<rows[r]._labels.size(); i++) {
+            line += *rows[r]._labels[i];
+            line += "|";
+        }
+        TRACE( TRACE_QUERY_RESULTS, "%s%lld\n", line.c_str(), rows[r]._value);
+    }
+    return (rows.size());
+}
+
+
+EXIT_NAMESPACE(ssb);
@@ -225,6 +225,26 @@ void ShoreTM1Env::reset_skew()
 }
 
 
+/******************************************************************** 
+ *
+ *  @fn:    set_hot_spot()/clear_hot_spot()
+ *
+ *  @brief: places and removes the hot spot of a skew scenario for TM1
+ *
+ ********************************************************************/
+void ShoreTM1Env::set_hot_spot(double pos, double area, int load) 
+{
+    // for subscribers
+    s_skewer.place_pct(1, _scaling_factor * TM1_SUBS_PER_SF, pos, area, load);
+    _change_load = true;
+}
+
+void ShoreTM1Env::clear_hot_spot() 
+{
+    _change_load = false;
+}
+
+
 /******************************************************************** 
  *
  *  @fn:    info()
@@ -364,6 +384,8 @@ void  ShoreTM1Env::table_creator_t::work()
     _env->_psf_man->register_table_man();
     _env->_pcf_man->register_table_man();
 
+    // If bulk-loading, even the preloads only collect the index entries
+    _env->start_bulkload();
 
     // Preload (preloads_per_worker) records for each of the loaders
     int sub_id = 0;
@@ -577,6 +599,8 @@ w_rc_t ShoreTM1Env::loaddata()
 	loaders[i]->join();        
     }
 
+    W_DO(finish_bulkload(creator_loaders_to_use));
+
 
     // 3. Join the loading threads
     time_t tstop = time(NULL);
@@ -71,52 +71,13 @@ subscriber_t::subscriber_t(const uint4_t& pd)
     : table_desc_t("SUBSCRIBER", TM1_SUB_FCOUNT, pd) 
 #endif
 {
-    // Schema
-    _desc[0].setup(SQL_INT,         "S_ID");         // UNIQUE [1..SF]
-
-    _desc[1].setup(SQL_FIXCHAR,     "SUB_NBR", TM1_SUB_NBR_SZ);  
-
-    _desc[2].setup(SQL_BIT,         "BIT_1");        // BIT (0,1)
-    _desc[3].setup(SQL_BIT,         "BIT_2");
-    _desc[4].setup(SQL_BIT,         "BIT_3");
-    _desc[5].setup(SQL_BIT,         "BIT_4");
-    _desc[6].setup(SQL_BIT,         "BIT_5");
-    _desc[7].setup(SQL_BIT,         "BIT_6");
-    _desc[8].setup(SQL_BIT,         "BIT_7");
-    _desc[9].setup(SQL_BIT,         "BIT_8");
-    _desc[10].setup(SQL_BIT,        "BIT_9");
-    _desc[11].setup(SQL_BIT,        "BIT_10");
-
-    _desc[12].setup(SQL_SMALLINT,   "HEX_1");        // SMALLINT (0,15)
-    _desc[13].setup(SQL_SMALLINT,   "HEX_2");
-    _desc[14].setup(SQL_SMALLINT,   "HEX_3");
-    _desc[15].setup(SQL_SMALLINT,   "HEX_4");
-    _desc[16].setup(SQL_SMALLINT,   "HEX_5");
-    _desc[17].setup(SQL_SMALLINT,   "HEX_6");
-    _desc[18].setup(SQL_SMALLINT,   "HEX_7");
-    _desc[19].setup(SQL_SMALLINT,   "HEX_8");
-    _desc[20].setup(SQL_SMALLINT,   "HEX_9");
-    _desc[21].setup(SQL_SMALLINT,   "HEX_10");
-
-    _desc[22].setup(SQL_SMALLINT,   "BYTE2_1");      // SMALLINT (0,255)
-    _desc[23].setup(SQL_SMALLINT,   "BYTE2_2");
-    _desc[24].setup(SQL_SMALLINT,   "BYTE2_3");
-    _desc[25].setup(SQL_SMALLINT,   "BYTE2_4");
-    _desc[26].setup(SQL_SMALLINT,   "BYTE2_5");
-    _desc[27].setup(SQL_SMALLINT,   "BYTE2_6");
-    _desc[28].setup(SQL_SMALLINT,   "BYTE2_7");
-    _desc[29].setup(SQL_SMALLINT,   "BYTE2_8");
-    _desc[30].setup(SQL_SMALLINT,   "BYTE2_9");
-    _desc[31].setup(SQL_SMALLINT,   "BYTE2_10");
-
-    _desc[32].setup(SQL_INT,        "MSC_LOCATION"); // INT (0,2^32-1)
-    _desc[33].setup(SQL_INT,        "VLR_LOCATION");
-
-#ifdef CFG_HACK
-    int padding_sz = 100-10*sizeof(bool)-20*sizeof(short)-3*sizeof(int)
-        -TM1_SUB_NBR_SZ*sizeof(char);
-    _desc[34].setup(SQL_FIXCHAR,       "S_PADDING", padding_sz);
-#endif        
+    // Schema (see TM1_SUB_FIELDS)
+    //   S_ID          UNIQUE [1..SF]
+    //   BIT_XX        BIT (0,1)
+    //   HEX_XX        SMALLINT (0,15)
+    //   BYTE2_XX      SMALLINT (0,255)
+    //   MSC_LOCATION  INT (0,2^32-1)
+    setup_layout<subscriber_row_t>();
 
     // create unique index s_index on (s_id)
     uint keys1[1] = { 0 }; // IDX { S_ID }
@@ -146,20 +107,13 @@ access_info_t::access_info_t(const uint4_t& pd)
     : table_desc_t("ACCESS_INFO", TM1_AI_FCOUNT, pd) 
 #endif
 {
-    // Schema
-    _desc[0].setup(SQL_INT,        "S_ID");       // REF S.S_ID
-    _desc[1].setup(SQL_SMALLINT,   "AI_TYPE");    // SMALLINT (1,4)   - (AI.S_ID,AI.AI_TYPE) is PRIMARY KEY
-    _desc[2].setup(SQL_SMALLINT,   "DATA1");      // SMALLINT (0,255)
-    _desc[3].setup(SQL_SMALLINT,   "DATA2");     
-    _desc[4].setup(SQL_FIXCHAR,       "DATA3", TM1_AI_DATA3_SZ);   // CHAR (3). [A-Z]
-    _desc[5].setup(SQL_FIXCHAR,       "DATA4", TM1_AI_DATA4_SZ);   // CHAR (5). [A-Z]
-
-
-#ifdef CFG_HACK
-    int padding_sz = 50-3*sizeof(short)-1*sizeof(int)
-        -(TM1_AI_DATA3_SZ+TM1_AI_DATA4_SZ)*sizeof(char);
-    _desc[6].setup(SQL_FIXCHAR,       "AI_PADDING", padding_sz);
-#endif
+    // Schema (see TM1_AI_FIELDS)
+    //   S_ID          REF S.S_ID
+    //   AI_TYPE       SMALLINT (1,4) - (AI.S_ID,AI.AI_TYPE) is PRIMARY KEY
+    //   DATA1, DATA2  SMALLINT (0,255)
+    //   DATA3         CHAR (3). [A-Z]
+    //   DATA4         CHAR (5). [A-Z]
+    setup_layout<access_info_row_t>();
 
     // There are between 1 and 4 Acess_Info records per Subscriber.
     // 25% Subscribers with one record
@@ -180,19 +134,13 @@ special_facility_t::special_facility_t(const uint4_t& pd)
     : table_desc_t("SPECIAL_FACILITY", TM1_SF_FCOUNT, pd) 
 #endif
 {
-    // Schema
-    _desc[0].setup(SQL_INT,        "S_ID");         // REF S.S_ID
-    _desc[1].setup(SQL_SMALLINT,   "SF_TYPE");      // SMALLINT (1,4). (SF.S_ID,SF.SF_TYPE) PRIMARY KEY
-    _desc[2].setup(SQL_BIT,        "IS_ACTIVE");    // BIT (0,1). 85% is 1 - 15% is 0
-    _desc[3].setup(SQL_SMALLINT,   "ERROR_CNTRL");  // SMALLINT (0,255)
-    _desc[4].setup(SQL_SMALLINT,   "DATA_A");       
-    _desc[5].setup(SQL_FIXCHAR,       "DATA_B", TM1_SF_DATA_B_SZ);  // CHAR (5) [A-Z] 
-
-#ifdef CFG_HACK
-    int padding_sz = 50-1*sizeof(bool)-3*sizeof(short)-1*sizeof(int)
-        -TM1_SF_DATA_B_SZ*sizeof(char);
-    _desc[6].setup(SQL_FIXCHAR,       "SF_PADDING", padding_sz);
-#endif
+    // Schema (see TM1_SF_FIELDS)
+    //   S_ID          REF S.S_ID
+    //   SF_TYPE       SMALLINT (1,4). (SF.S_ID,SF.SF_TYPE) PRIMARY KEY
+    //   IS_ACTIVE     BIT (0,1). 85% is 1 - 15% is 0
+    //   ERROR_CNTRL   SMALLINT (0,255)
+    //   DATA_B        CHAR (5) [A-Z]
+    setup_layout<special_facility_row_t>();
 
     // There are between 1 and 4 Special_Facility records per Subscriber.
     // 25% Subscribers with one sf
@@ -213,17 +161,12 @@ call_forwarding_t::call_forwarding_t(const uint4_t& pd)
     : table_desc_t("CALL_FORWARDING", TM1_CF_FCOUNT, pd)
 #endif
 {
-    // Schema
-    _desc[0].setup(SQL_INT,        "S_ID");        // REF SF.S_ID
-    _desc[1].setup(SQL_SMALLINT,   "SF_TYPE");     // REF SF.SF_TYPE
-    _desc[2].setup(SQL_SMALLINT,   "START_TIME");  // SMALLINT {0,8,16}
-    _desc[3].setup(SQL_SMALLINT,   "END_TIME");    // SMALLINT START_TIME + URAND(1,8)
-    _desc[4].setup(SQL_FIXCHAR,    "NUMBERX", TM1_CF_NUMBERX_SZ); // CHAR (15) [0-9]
-
-#ifdef CFG_HACK
-    int padding_sz = 50-3*sizeof(short)-1*sizeof(int)-TM1_CF_NUMBERX_SZ*sizeof(char);
-    _desc[5].setup(SQL_FIXCHAR,       "CF_PADDING", padding_sz);
-#endif
+    // Schema (see TM1_CF_FIELDS)
+    //   S_ID, SF_TYPE REF SF.(S_ID,SF_TYPE)
+    //   START_TIME    SMALLINT {0,8,16}
+    //   END_TIME      SMALLINT START_TIME + URAND(1,8)
+    //   NUMBERX       CHAR (15) [0-9]
+    setup_layout<call_forwarding_row_t>();
 
     // create unique index cf_idx on (s_id, sf_type, start_time)
     uint keys[3] = { 0, 1, 2 }; // IDX { S_ID, SF_TYPE, START_TIME }
@@ -54,7 +54,7 @@ w_rc_t sub_man_impl::sub_idx_probe(ss_m* db,
                                    const int s_id)
 {
     assert (ptuple);    
-    ptuple->set_value(0, s_id);
+    subscriber_row_t::set_S_ID(ptuple, s_id);
     return (index_probe_by_name(db, "S_IDX", ptuple));
 }
 
@@ -63,7 +63,7 @@ w_rc_t sub_man_impl::sub_idx_upd(ss_m* db,
                                  const int s_id)
 {
     assert (ptuple);    
-    ptuple->set_value(0, s_id);
+    subscriber_row_t::set_S_ID(ptuple, s_id);
     return (index_probe_forupdate_by_name(db, "S_IDX", ptuple));
 }
 
@@ -72,7 +72,7 @@ w_rc_t sub_man_impl::sub_idx_nl(ss_m* db,
                                 const int s_id)
 {
     assert (ptuple);    
-    ptuple->set_value(0, s_id);
+    subscriber_row_t::set_S_ID(ptuple, s_id);
     return (index_probe_nl_by_name(db, "S_IDX", ptuple));
 }
 
@@ -83,7 +83,7 @@ w_rc_t sub_man_impl::sub_nbr_idx_probe(ss_m* db,
                                        const char* s_nbr)
 {
     assert (ptuple);    
-    ptuple->set_value(1, s_nbr);
+    subscriber_row_t::set_SUB_NBR(ptuple, s_nbr);
     return (index_probe_by_name(db, "SUB_NBR_IDX", ptuple));
 }
 
@@ -92,7 +92,7 @@ w_rc_t sub_man_impl::sub_nbr_idx_upd(ss_m* db,
                                      const char* s_nbr)
 {
     assert (ptuple);    
-    ptuple->set_value(1, s_nbr);
+    subscriber_row_t::set_SUB_NBR(ptuple, s_nbr);
     return (index_probe_forupdate_by_name(db, "SUB_NBR_IDX", ptuple));
 }
 
@@ -101,7 +101,7 @@ w_rc_t sub_man_impl::sub_nbr_idx_nl(ss_m* db,
                                     const char* s_nbr)
 {
     assert (ptuple);    
-    ptuple->set_value(1, s_nbr);
+    subscriber_row_t::set_SUB_NBR(ptuple, s_nbr);
     return (index_probe_nl_by_name(db, "SUB_NBR_IDX", ptuple));
 }
 
@@ -132,11 +132,11 @@ w_rc_t sub_man_impl::sub_get_idx_iter(ss_m* db,
 
     // Low bound
     sprintf(aSubNbr,"%015d",sub_id);
-    ptuple->set_value(1, aSubNbr);
+    subscriber_row_t::set_SUB_NBR(ptuple, aSubNbr);
 
 #ifdef USE_DORA_EXT_IDX
     // The extended DORA index: SUB_NBR_IDX: {1 - 0}
-    if(!need_tuple) { ptuple->set_value(0, 0); }
+    if(!need_tuple) { subscriber_row_t::set_S_ID(ptuple, 0); }
 #endif
 
     lowsz = format_key(pindex, ptuple, replow);
@@ -144,10 +144,10 @@ w_rc_t sub_man_impl::sub_get_idx_iter(ss_m* db,
 
     // High bound
     sprintf(aSubNbr,"%015d",(sub_id+range));
-    ptuple->set_value(1, aSubNbr);
+    subscriber_row_t::set_SUB_NBR(ptuple, aSubNbr);
 	
 #ifdef USE_DORA_EXT_IDX
-    if(!need_tuple) { ptuple->set_value(0, MAX_INT); } // largest S_ID
+    if(!need_tuple) { subscriber_row_t::set_S_ID(ptuple, MAX_INT); } // largest S_ID
 #endif
 
     highsz = format_key(pindex, ptuple, rephigh);
@@ -172,8 +172,8 @@ w_rc_t ai_man_impl::ai_idx_probe(ss_m* db,
                                  const int s_id, const short ai_type)
 {
     assert (ptuple);    
-    ptuple->set_value(0, s_id);
-    ptuple->set_value(1, ai_type);
+    access_info_row_t::set_S_ID(ptuple, s_id);
+    access_info_row_t::set_AI_TYPE(ptuple, ai_type);
     return (index_probe_by_name(db, "AI_IDX", ptuple));
 }
 
@@ -182,8 +182,8 @@ w_rc_t ai_man_impl::ai_idx_upd(ss_m* db,
                                const int s_id, const short ai_type)
 {
     assert (ptuple);    
-    ptuple->set_value(0, s_id);
-    ptuple->set_value(1, ai_type);
+    access_info_row_t::set_S_ID(ptuple, s_id);
+    access_info_row_t::set_AI_TYPE(ptuple, ai_type);
     return (index_probe_forupdate_by_name(db, "AI_IDX", ptuple));
 }
 
@@ -192,8 +192,8 @@ w_rc_t ai_man_impl::ai_idx_nl(ss_m* db,
                               const int s_id, const short ai_type)
 {
     assert (ptuple);    
-    ptuple->set_value(0, s_id);
-    ptuple->set_value(1, ai_type);
+    access_info_row_t::set_S_ID(ptuple, s_id);
+    access_info_row_t::set_AI_TYPE(ptuple, ai_type);
     return (index_probe_nl_by_name(db, "AI_IDX", ptuple));
 }
 
@@ -209,8 +209,8 @@ w_rc_t sf_man_impl::sf_idx_probe(ss_m* db,
                                  const int s_id, const short sf_type)
 {
     assert (ptuple);    
-    ptuple->set_value(0, s_id);
-    ptuple->set_value(1, sf_type);
+    special_facility_row_t::set_S_ID(ptuple, s_id);
+    special_facility_row_t::set_SF_TYPE(ptuple, sf_type);
     return (index_probe_by_name(db, "SF_IDX", ptuple));
 }
 
@@ -219,8 +219,8 @@ w_rc_t sf_man_impl::sf_idx_upd(ss_m* db,
                                const int s_id, const short sf_type)
 {
     assert (ptuple);    
-    ptuple->set_value(0, s_id);
-    ptuple->set_value(1, sf_type);
+    special_facility_row_t::set_S_ID(ptuple, s_id);
+    special_facility_row_t::set_SF_TYPE(ptuple, sf_type);
     return (index_probe_forupdate_by_name(db, "SF_IDX", ptuple));
 }
 
@@ -229,8 +229,8 @@ w_rc_t sf_man_impl::sf_idx_nl(ss_m* db,
                               const int s_id, const short sf_type)
 {
     assert (ptuple);    
-    ptuple->set_value(0, s_id);
-    ptuple->set_value(1, sf_type);
+    special_facility_row_t::set_S_ID(ptuple, s_id);
+    special_facility_row_t::set_SF_TYPE(ptuple, sf_type);
     return (index_probe_nl_by_name(db, "SF_IDX", ptuple));
 }
 
@@ -256,13 +256,13 @@ w_rc_t sf_man_impl::sf_get_idx_iter(ss_m* db,
     // CF_IDX: { 0 - 1 }
 
     // prepare the key to be probed
-    ptuple->set_value(0, sub_id);
-    ptuple->set_value(1, (short)1); // smallest SF_TYPE (1-4)
+    special_facility_row_t::set_S_ID(ptuple, sub_id);
+    special_facility_row_t::set_SF_TYPE(ptuple, 1); // smallest SF_TYPE (1-4)
 
     int lowsz = format_key(pindex, ptuple, replow);
     assert (replow._dest);
 
-    ptuple->set_value(1, (short)4); // largest SF_TYPE (1-4)
+    special_facility_row_t::set_SF_TYPE(ptuple, 4); // largest SF_TYPE (1-4)
 
     int highsz = format_key(pindex, ptuple, rephigh);
     assert (rephigh._dest);    
@@ -301,9 +301,9 @@ w_rc_t cf_man_impl::cf_idx_probe(ss_m* db,
                                  const short stime)
 {
     assert (ptuple);    
-    ptuple->set_value(0, s_id);
-    ptuple->set_value(1, sf_type);
-    ptuple->set_value(2, stime);
+    call_forwarding_row_t::set_S_ID(ptuple, s_id);
+    call_forwarding_row_t::set_SF_TYPE(ptuple, sf_type);
+    call_forwarding_row_t::set_START_TIME(ptuple, stime);
     return (index_probe_by_name(db, "CF_IDX", ptuple));
 }
 
@@ -313,9 +313,9 @@ w_rc_t cf_man_impl::cf_idx_upd(ss_m* db,
                                const short stime)
 {
     assert (ptuple);    
-    ptuple->set_value(0, s_id);
-    ptuple->set_value(1, sf_type);
-    ptuple->set_value(2, stime);
+    call_forwarding_row_t::set_S_ID(ptuple, s_id);
+    call_forwarding_row_t::set_SF_TYPE(ptuple, sf_type);
+    call_forwarding_row_t::set_START_TIME(ptuple, stime);
     return (index_probe_forupdate_by_name(db, "CF_IDX", ptuple));
 }
 
@@ -325,9 +325,9 @@ w_rc_t cf_man_impl::cf_idx_nl(ss_m* db,
                               const short stime)
 {
     assert (ptuple);    
-    ptuple->set_value(0, s_id);
-    ptuple->set_value(1, sf_type);
-    ptuple->set_value(2, stime);
+    call_forwarding_row_t::set_S_ID(ptuple, s_id);
+    call_forwarding_row_t::set_SF_TYPE(ptuple, sf_type);
+    call_forwarding_row_t::set_START_TIME(ptuple, stime);
     return (index_probe_nl_by_name(db, "CF_IDX", ptuple));
 }
 
@@ -355,15 +355,15 @@ w_rc_t cf_man_impl::cf_get_idx_iter(ss_m* db,
     // CF_IDX: {0 - 1 - 2}
 
     // prepare the key to be probed
-    ptuple->set_value(0, sub_id);
-    ptuple->set_value(1, sf_type);
-    ptuple->set_value(2, s_time);
+    call_forwarding_row_t::set_S_ID(ptuple, sub_id);
+    call_forwarding_row_t::set_SF_TYPE(ptuple, sf_type);
+    call_forwarding_row_t::set_START_TIME(ptuple, s_time);
 
     int lowsz = format_key(pindex, ptuple, replow);
     assert (replow._dest);
 
 
-    ptuple->set_value(2, (short)24); // largest S_TIME
+    call_forwarding_row_t::set_START_TIME(ptuple, 24); // largest S_TIME
 
     int highsz = format_key(pindex, ptuple, rephigh);
     assert (rephigh._dest);    
@@ -316,53 +316,53 @@ w_rc_t ShoreTM1Env::xct_populate_one(const int sub_id)
 
     // POPULATE SUBSCRIBER
 
-    prsub->set_value(0, sub_id);
+    subscriber_row_t::set_S_ID(prsub, sub_id);
     char asubnbr[STRSIZE(TM1_SUB_NBR_SZ)];
     memset(asubnbr,0,STRSIZE(TM1_SUB_NBR_SZ));
     sprintf(asubnbr,"%015d",sub_id);
-    prsub->set_value(1, asubnbr);
+    subscriber_row_t::set_SUB_NBR(prsub, asubnbr);
     
     // BIT_XX
-    prsub->set_value(2,  URandBool());
-    prsub->set_value(3,  URandBool());
-    prsub->set_value(4,  URandBool());
-    prsub->set_value(5,  URandBool());
-    prsub->set_value(6,  URandBool());
-    prsub->set_value(7,  URandBool());
-    prsub->set_value(8,  URandBool());
-    prsub->set_value(9,  URandBool());
-    prsub->set_value(10, URandBool());
-    prsub->set_value(11, URandBool());
+    subscriber_row_t::set_BIT_1(prsub, URandBool());
+    subscriber_row_t::set_BIT_2(prsub, URandBool());
+    subscriber_row_t::set_BIT_3(prsub, URandBool());
+    subscriber_row_t::set_BIT_4(prsub, URandBool());
+    subscriber_row_t::set_BIT_5(prsub, URandBool());
+    subscriber_row_t::set_BIT_6(prsub, URandBool());
+    subscriber_row_t::set_BIT_7(prsub, URandBool());
+    subscriber_row_t::set_BIT_8(prsub, URandBool());
+    subscriber_row_t::set_BIT_9(prsub, URandBool());
+    subscriber_row_t::set_BIT_10(prsub, URandBool());
     
     // HEX_XX
-    prsub->set_value(12, URandShort(0,15));
-    prsub->set_value(13, URandShort(0,15));
-    prsub->set_value(14, URandShort(0,15));
-    prsub->set_value(15, URandShort(0,15));
-    prsub->set_value(16, URandShort(0,15));
-    prsub->set_value(17, URandShort(0,15));
-    prsub->set_value(18, URandShort(0,15));
-    prsub->set_value(19, URandShort(0,15));
-    prsub->set_value(20, URandShort(0,15));
-    prsub->set_value(21, URandShort(0,15));
+    subscriber_row_t::set_HEX_1(prsub, URandShort(0,15));
+    subscriber_row_t::set_HEX_2(prsub, URandShort(0,15));
+    subscriber_row_t::set_HEX_3(prsub, URandShort(0,15));
+    subscriber_row_t::set_HEX_4(prsub, URandShort(0,15));
+    subscriber_row_t::set_HEX_5(prsub, URandShort(0,15));
+    subscriber_row_t::set_HEX_6(prsub, URandShort(0,15));
+    subscriber_row_t::set_HEX_7(prsub, URandShort(0,15));
+    subscriber_row_t::set_HEX_8(prsub, URandShort(0,15));
+    subscriber_row_t::set_HEX_9(prsub, URandShort(0,15));
+    subscriber_row_t::set_HEX_10(prsub, URandShort(0,15));
     
     // BYTE2_XX
-    prsub->set_value(22, URandShort(0,255));
-    prsub->set_value(23, URandShort(0,255));
-    prsub->set_value(24, URandShort(0,255));
-    prsub->set_value(25, URandShort(0,255));
-    prsub->set_value(26, URandShort(0,255));
-    prsub->set_value(27, URandShort(0,255));
-    prsub->set_value(28, URandShort(0,255));
-    prsub->set_value(29, URandShort(0,255));
-    prsub->set_value(30, URandShort(0,255));
-    prsub->set_value(31, URandShort(0,255));
+    subscriber_row_t::set_BYTE2_1(prsub, URandShort(0,255));
+    subscriber_row_t::set_BYTE2_2(prsub, URandShort(0,255));
+    subscriber_row_t::set_BYTE2_3(prsub, URandShort(0,255));
+    subscriber_row_t::set_BYTE2_4(prsub, URandShort(0,255));
+    subscriber_row_t::set_BYTE2_5(prsub, URandShort(0,255));
+    subscriber_row_t::set_BYTE2_6(prsub, URandShort(0,255));
+    subscriber_row_t::set_BYTE2_7(prsub, URandShort(0,255));
+    subscriber_row_t::set_BYTE2_8(prsub, URandShort(0,255));
+    subscriber_row_t::set_BYTE2_9(prsub, URandShort(0,255));
+    subscriber_row_t::set_BYTE2_10(prsub, URandShort(0,255));
     
-    prsub->set_value(32, URand(0,(2<<16)-1));
-    prsub->set_value(33, URand(0,(2<<16)-1));
+    subscriber_row_t::set_MSC_LOCATION(prsub, URand(0,(2<<16)-1));
+    subscriber_row_t::set_VLR_LOCATION(prsub, URand(0,(2<<16)-1));
     
 #ifdef CFG_HACK
-    prsub->set_value(34, "padding");         // PADDING
+    subscriber_row_t::set_S_PADDING(prsub, "padding");         // PADDING
 #endif
     
     W_DO(_psub_man->add_tuple(_pssm, prsub));
@@ -375,27 +375,27 @@ w_rc_t ShoreTM1Env::xct_populate_one(const int sub_id)
     
     for (i=0; i<num_ai; ++i) {
 	
-	prai->set_value(0, sub_id);
+	access_info_row_t::set_S_ID(prai, sub_id);
 	
 	// AI_TYPE
 	type = i+1;
-	prai->set_value(1, type);
+	access_info_row_t::set_AI_TYPE(prai, type);
 	
 	// DATA 1,2
-	prai->set_value(2, URandShort(0,255));
-	prai->set_value(3, URandShort(0,255));
+	access_info_row_t::set_DATA1(prai, URandShort(0,255));
+	access_info_row_t::set_DATA2(prai, URandShort(0,255));
 	
 	// DATA 3,4
 	char data3[TM1_AI_DATA3_SZ];
 	URandFillStrCaps(data3,TM1_AI_DATA3_SZ);
-	prai->set_value(4, data3);
+	access_info_row_t::set_DATA3(prai, data3);
 	
 	char data4[TM1_AI_DATA4_SZ];
 	URandFillStrCaps(data4,TM1_AI_DATA4_SZ);
-	prai->set_value(5, data4);      
+	access_info_row_t::set_DATA4(prai, data4);      
 		
 #ifdef CFG_HACK
-	prai->set_value(6, "padding");            // PADDING
+	access_info_row_t::set_AI_PADDING(prai, "padding");            // PADDING
 #endif
 	
 	W_DO(_pai_man->add_tuple(_pssm, prai));
@@ -408,23 +408,23 @@ w_rc_t ShoreTM1Env::xct_populate_one(const int sub_id)
     
     for (i=0; i<num_sf; ++i) {
 	
-	prsf->set_value(0, sub_id);
+	special_facility_row_t::set_S_ID(prsf, sub_id);
         
 	// SF_TYPE 
 	type = i+1;
-	prsf->set_value(1, type);	
+	special_facility_row_t::set_SF_TYPE(prsf, type);	
 
-	prsf->set_value(2, (URand(1,100)<85? true : false));
-	prsf->set_value(3, URandShort(0,255));
-	prsf->set_value(4, URandShort(0,255));
+	special_facility_row_t::set_IS_ACTIVE(prsf, (URand(1,100)<85? true : false));
+	special_facility_row_t::set_ERROR_CNTRL(prsf, URandShort(0,255));
+	special_facility_row_t::set_DATA_A(prsf, URandShort(0,255));
 	
 	// DATA_B
 	char datab[TM1_SF_DATA_B_SZ];
 	URandFillStrCaps(datab,TM1_SF_DATA_B_SZ);
-	prsf->set_value(5, datab);
+	special_facility_row_t::set_DATA_B(prsf, datab);
 	
 #ifdef CFG_HACK
-	prsf->set_value(6, "padding");            // PADDING
+	special_facility_row_t::set_SF_PADDING(prsf, "padding");            // PADDING
 #endif
 	
 	W_DO(_psf_man->add_tuple(_pssm, prsf));
@@ -442,22 +442,22 @@ w_rc_t ShoreTM1Env::xct_populate_one(const int sub_id)
         
 	for (j=0; j<num_cf; ++j) {
 	    
-	    prcf->set_value(0, sub_id);
+	    call_forwarding_row_t::set_S_ID(prcf, sub_id);
 	    
 	    type = i+1;
-	    prcf->set_value(1, type);
+	    call_forwarding_row_t::set_SF_TYPE(prcf, type);
 	    
 	    atime = j*8;
-	    prcf->set_value(2, atime);
+	    call_forwarding_row_t::set_START_TIME(prcf, atime);
 	    
 	    atime = j*8 + URandShort(1,8);
-	    prcf->set_value(3, atime);
+	    call_forwarding_row_t::set_END_TIME(prcf, atime);
             
 	    char numbx[TM1_CF_NUMBERX_SZ];
 	    URandFillStrNumbx(numbx,TM1_CF_NUMBERX_SZ);
-	    prcf->set_value(4, numbx);                	    
+	    call_forwarding_row_t::set_NUMBERX(prcf, numbx);                	    
 #ifdef CFG_HACK
-	    prcf->set_value(5, "padding");                // PADDING
+	    call_forwarding_row_t::set_CF_PADDING(prcf, "padding");                // PADDING
 #endif
 	    
 	    W_DO(_pcf_man->add_tuple(_pssm, prcf));          
@@ -513,51 +513,9 @@ w_rc_t ShoreTM1Env::xct_get_sub_data(const int xct_id,
 	   xct_id, gsdin._s_id);
     W_DO(_psub_man->sub_idx_probe(_pssm, prsub, gsdin._s_id));
     
-    tm1_sub_t asub;
-    
     // READ SUBSCRIBER
-    
-    prsub->get_value(0,  asub.S_ID);
-    prsub->get_value(1,  asub.SUB_NBR, 17);
-    
-    // BIT_XX
-    prsub->get_value(2,  asub.BIT_XX[0]);
-    prsub->get_value(3,  asub.BIT_XX[1]);
-    prsub->get_value(4,  asub.BIT_XX[2]);
-    prsub->get_value(5,  asub.BIT_XX[3]);
-    prsub->get_value(6,  asub.BIT_XX[4]);
-    prsub->get_value(7,  asub.BIT_XX[5]);
-    prsub->get_value(8,  asub.BIT_XX[6]);
-    prsub->get_value(9,  asub.BIT_XX[7]);
-    prsub->get_value(10, asub.BIT_XX[8]);
-    prsub->get_value(11, asub.BIT_XX[9]);
-    
-    // HEX_XX
-    prsub->get_value(12, asub.HEX_XX[0]);
-    prsub->get_value(13, asub.HEX_XX[1]);
-    prsub->get_value(14, asub.HEX_XX[2]);
-    prsub->get_value(15, asub.HEX_XX[3]);
-    prsub->get_value(16, asub.HEX_XX[4]);
-    prsub->get_value(17, asub.HEX_XX[5]);
-    prsub->get_value(18, asub.HEX_XX[6]);
-    prsub->get_value(19, asub.HEX_XX[7]);
-    prsub->get_value(20, asub.HEX_XX[8]);
-    prsub->get_value(21, asub.HEX_XX[9]);
-    
-    // BYTE2_XX
-    prsub->get_value(22, asub.BYTE2_XX[0]);
-    prsub->get_value(23, asub.BYTE2_XX[1]);
-    prsub->get_value(24, asub.BYTE2_XX[2]);
-    prsub->get_value(25, asub.BYTE2_XX[3]);
-    prsub->get_value(26, asub.BYTE2_XX[4]);
-    prsub->get_value(27, asub.BYTE2_XX[5]);
-    prsub->get_value(28, asub.BYTE2_XX[6]);
-    prsub->get_value(29, asub.BYTE2_XX[7]);
-    prsub->get_value(30, asub.BYTE2_XX[8]);
-    prsub->get_value(31, asub.BYTE2_XX[9]);
-    
-    prsub->get_value(32, asub.MSC_LOCATION);
-    prsub->get_value(33, asub.VLR_LOCATION);
+    subscriber_row_t asub;
+    asub.fetch(prsub);
     
 #ifdef PRINT_TRX_RESULTS
     // at the end of the transaction 
@@ -632,7 +590,7 @@ w_rc_t ShoreTM1Env::xct_get_new_dest(const int xct_id,
 	   xct_id, gndin._s_id, gndin._sf_type);
     W_DO(_psf_man->sf_idx_probe(_pssm, prsf, 
 				gndin._s_id, gndin._sf_type));    
-    prsf->get_value(2, asf.IS_ACTIVE);
+    asf.IS_ACTIVE = special_facility_row_t::get_IS_ACTIVE(prsf);
 
     // If it is and active special facility
     // 2. Retrieve the call forwarding destination (read-only)
@@ -650,9 +608,9 @@ w_rc_t ShoreTM1Env::xct_get_new_dest(const int xct_id,
 	W_DO(cf_iter->next(_pssm, eof, *prcf));
 	while (!eof) {	    
 	    // check the retrieved CF e_time                
-	    prcf->get_value(3, acf.END_TIME);
+	    acf.END_TIME = call_forwarding_row_t::get_END_TIME(prcf);
 	    if (acf.END_TIME > gndin._e_time) {
-		prcf->get_value(4, acf.NUMBERX, 17);
+		call_forwarding_row_t::get_NUMBERX(prcf, acf.NUMBERX);
 		TRACE( TRACE_TRX_FLOW, "App: %d GND: found (%d) (%d) (%s)\n", 
 		       xct_id, gndin._e_time, acf.END_TIME, acf.NUMBERX);
 		bFound = true;
@@ -718,10 +676,10 @@ w_rc_t ShoreTM1Env::xct_get_acc_data(const int xct_id,
 	   xct_id, gadin._s_id, gadin._ai_type);
     W_DO(_pai_man->ai_idx_probe(_pssm, prai, gadin._s_id, gadin._ai_type));
     tm1_ai_t aai;
-    prai->get_value(2,  aai.DATA1);
-    prai->get_value(3,  aai.DATA2);
-    prai->get_value(4,  aai.DATA3, 5);
-    prai->get_value(5,  aai.DATA4, 9);
+    aai.DATA1 = access_info_row_t::get_DATA1(prai);
+    aai.DATA2 = access_info_row_t::get_DATA2(prai);
+    access_info_row_t::get_DATA3(prai, aai.DATA3);
+    access_info_row_t::get_DATA4(prai, aai.DATA4);
 
 #ifdef PRINT_TRX_RESULTS
     // at the end of the transaction 
@@ -786,14 +744,14 @@ w_rc_t ShoreTM1Env::xct_upd_sub_data(const int xct_id,
     TRACE( TRACE_TRX_FLOW, "App: %d USD:sf-idx-upd (%d) (%d)\n", 
 	   xct_id, usdin._s_id, usdin._sf_type);
     W_DO(_psf_man->sf_idx_upd(_pssm, prsf, usdin._s_id, usdin._sf_type));    
-    prsf->set_value(4, usdin._a_data);        
+    special_facility_row_t::set_DATA_A(prsf, usdin._a_data);        
     W_DO(_psf_man->update_tuple(_pssm, prsf));
 
     // 2. Update Subscriber
     TRACE( TRACE_TRX_FLOW, "App: %d USD:sub-idx-upd (%d)\n", 
 	   xct_id, usdin._s_id);
     W_DO(_psub_man->sub_idx_upd(_pssm, prsub, usdin._s_id));
-    prsub->set_value(2, usdin._a_bit);
+    subscriber_row_t::set_BIT_1(prsub, usdin._a_bit);
     W_DO(_psub_man->update_tuple(_pssm, prsub));
 
 #ifdef PRINT_TRX_RESULTS
@@ -847,7 +805,7 @@ w_rc_t ShoreTM1Env::xct_upd_loc(const int xct_id,
     TRACE( TRACE_TRX_FLOW, "App: %d UL:sub-nbr-idx-upd (%d)\n", 
 	   xct_id, ulin._s_id);
     W_DO(_psub_man->sub_nbr_idx_upd(_pssm, prsub, ulin._sub_nbr));
-    prsub->set_value(33, ulin._vlr_loc);
+    subscriber_row_t::set_VLR_LOCATION(prsub, ulin._vlr_loc);
     W_DO(_psub_man->update_tuple(_pssm, prsub));
 
 #ifdef PRINT_TRX_RESULTS
@@ -924,7 +882,7 @@ w_rc_t ShoreTM1Env::xct_ins_call_fwd(const int xct_id,
     TRACE( TRACE_TRX_FLOW, "App: %d ICF:sub-nbr-idx (%d)\n", 
 	   xct_id, icfin._s_id);
     W_DO(_psub_man->sub_nbr_idx_probe(_pssm, prsub, icfin._sub_nbr));
-    prsub->get_value(0, icfin._s_id);
+    icfin._s_id = subscriber_row_t::get_S_ID(prsub);
         
     // 2. Retrieve SpecialFacility (Read-only)
     guard<index_scan_iter_impl<special_facility_t> > sf_iter;
@@ -938,7 +896,7 @@ w_rc_t ShoreTM1Env::xct_ins_call_fwd(const int xct_id,
     W_DO(sf_iter->next(_pssm, eof, *prsf));
     while (!eof) {
 	// check the retrieved SF sf_type
-	prsf->get_value(1, asf.SF_TYPE);
+	asf.SF_TYPE = special_facility_row_t::get_SF_TYPE(prsf);
 	if (asf.SF_TYPE == icfin._sf_type) {
 	    TRACE( TRACE_TRX_FLOW, "App: %d ICF: found (%d) (%d)\n", 
 		   xct_id, icfin._s_id, asf.SF_TYPE);
@@ -960,13 +918,13 @@ w_rc_t ShoreTM1Env::xct_ins_call_fwd(const int xct_id,
     // idx probes return se_TUPLE_NOT_FOUND
     if (e.err_num() == se_TUPLE_NOT_FOUND) { 	
 	// 4. Insert Call Forwarding record
-	prcf->set_value(0, icfin._s_id);
-	prcf->set_value(1, icfin._sf_type);
-	prcf->set_value(2, icfin._s_time);
-	prcf->set_value(3, icfin._e_time);
-	prcf->set_value(4, icfin._numberx);                	
+	call_forwarding_row_t::set_S_ID(prcf, icfin._s_id);
+	call_forwarding_row_t::set_SF_TYPE(prcf, icfin._sf_type);
+	call_forwarding_row_t::set_START_TIME(prcf, icfin._s_time);
+	call_forwarding_row_t::set_END_TIME(prcf, icfin._e_time);
+	call_forwarding_row_t::set_NUMBERX(prcf, icfin._numberx);                	
 #ifdef CFG_HACK
-	prcf->set_value(5, "padding"); // PADDING
+	call_forwarding_row_t::set_CF_PADDING(prcf, "padding"); // PADDING
 #endif
 	TRACE (TRACE_TRX_FLOW, "App: %d ICF:ins-cf\n", xct_id);
 	W_DO(_pcf_man->add_tuple(_pssm, prcf));
@@ -1035,7 +993,7 @@ w_rc_t ShoreTM1Env::xct_del_call_fwd(const int xct_id,
     TRACE( TRACE_TRX_FLOW, "App: %d DCF:sub-nbr-idx (%d)\n", 
 	   xct_id, dcfin._s_id);
     W_DO(_psub_man->sub_nbr_idx_probe(_pssm, prsub, dcfin._sub_nbr));
-    prsub->get_value(0, dcfin._s_id);
+    dcfin._s_id = subscriber_row_t::get_S_ID(prsub);
     
     // 2. Delete CallForwarding record
     TRACE( TRACE_TRX_FLOW, "App: %d DCF:cf-idx-upd (%d) (%d) (%d)\n", 
@@ -1120,8 +1078,8 @@ w_rc_t ShoreTM1Env::xct_get_sub_nbr(const int xct_id,
     // 2. Read all the returned records
     W_DO(sub_iter->next(_pssm, eof, *prsub));
     while (!eof) {
-	prsub->get_value(0, sid);
-	prsub->get_value(33, vlrloc);
+	sid = subscriber_row_t::get_S_ID(prsub);
+	vlrloc = subscriber_row_t::get_VLR_LOCATION(prsub);
 	TRACE( TRACE_TRX_FLOW, "App: %d GSN: read (%d) (%d)\n", 
 	       xct_id, sid, vlrloc);
 	W_DO(sub_iter->next(_pssm, eof, *prsub));
@@ -1168,7 +1126,7 @@ w_rc_t ShoreTM1Env::xct_ins_call_fwd_bench(const int xct_id,
     TRACE( TRACE_TRX_FLOW, "App: %d ICFB:sub-nbr-idx (%d)\n",
 	   xct_id, icfbin._s_id);
     W_DO(_psub_man->sub_nbr_idx_probe(_pssm, prsub, icfbin._sub_nbr));
-    prsub->get_value(0, icfbin._s_id);
+    icfbin._s_id = subscriber_row_t::get_S_ID(prsub);
 
     // 2. Check if it can successfully insert
     TRACE( TRACE_TRX_FLOW, "App: %d ICFB:cf-idx-probe (%d) (%d) (%d)\n",
@@ -1182,13 +1140,13 @@ w_rc_t ShoreTM1Env::xct_ins_call_fwd_bench(const int xct_id,
 	    W_DO(e);	    
 	}
 	// 3. Insert Call Forwarding record
-	prcf->set_value(0, icfbin._s_id);
-	prcf->set_value(1, icfbin._sf_type);
-	prcf->set_value(2, icfbin._s_time);
-	prcf->set_value(3, icfbin._e_time);
-	prcf->set_value(4, icfbin._numberx);	    
+	call_forwarding_row_t::set_S_ID(prcf, icfbin._s_id);
+	call_forwarding_row_t::set_SF_TYPE(prcf, icfbin._sf_type);
+	call_forwarding_row_t::set_START_TIME(prcf, icfbin._s_time);
+	call_forwarding_row_t::set_END_TIME(prcf, icfbin._e_time);
+	call_forwarding_row_t::set_NUMBERX(prcf, icfbin._numberx);	    
 #ifdef CFG_HACK
-	prcf->set_value(5, "padding"); // PADDING
+	call_forwarding_row_t::set_CF_PADDING(prcf, "padding"); // PADDING
 #endif	    
 	TRACE( TRACE_TRX_FLOW, "App: %d ICF:ins-cf\n", xct_id);	    
 	W_DO(_pcf_man->add_tuple(_pssm, prcf));
@@ -1257,7 +1215,7 @@ w_rc_t ShoreTM1Env::xct_del_call_fwd_bench(const int xct_id,
     TRACE( TRACE_TRX_FLOW, "App: %d DCFB:sub-nbr-idx (%d)\n",
 	   xct_id, dcfbin._s_id);	
     W_DO(_psub_man->sub_nbr_idx_probe(_pssm, prsub, dcfbin._sub_nbr));
-    prsub->get_value(0, dcfbin._s_id);
+    dcfbin._s_id = subscriber_row_t::get_S_ID(prsub);
 	
     // 2. Delete CallForwarding record
     TRACE( TRACE_TRX_FLOW, "App: %d DCFB:cf-idx-upd (%d) (%d) (%d)\n",
@@ -1271,16 +1229,16 @@ w_rc_t ShoreTM1Env::xct_del_call_fwd_bench(const int xct_id,
 	    W_DO(e);
 	}
 	// 3. Insert Call Forwarding record
-	prcf->set_value(0, dcfbin._s_id);
-	prcf->set_value(1, dcfbin._sf_type);
-	prcf->set_value(2, dcfbin._s_time);
+	call_forwarding_row_t::set_S_ID(prcf, dcfbin._s_id);
+	call_forwarding_row_t::set_SF_TYPE(prcf, dcfbin._sf_type);
+	call_forwarding_row_t::set_START_TIME(prcf, dcfbin._s_time);
 	short atime = URand(1,24);
-	prcf->set_value(3, atime);
+	call_forwarding_row_t::set_END_TIME(prcf, atime);
 	char numbx[TM1_CF_NUMBERX_SZ];
 	URandFillStrNumbx(numbx,TM1_CF_NUMBERX_SZ);
-	prcf->set_value(4, numbx);
+	call_forwarding_row_t::set_NUMBERX(prcf, numbx);
 #ifdef CFG_HACK
-	prcf->set_value(5, "padding"); // PADDING
+	call_forwarding_row_t::set_CF_PADDING(prcf, "padding"); // PADDING
 #endif
 	TRACE( TRACE_TRX_FLOW, "App: %d DCFB:ins-cf\n", xct_id);
 	W_DO(_pcf_man->add_tuple(_pssm, prcf));
@@ -95,7 +95,7 @@ w_rc_t baseline_tpcb_client_t::submit_one(int xct_type, int xctid)
     // Set input
     trx_result_tuple_t atrt;
     bool bWake = false;
-    if (condex* c = _cp->take_one()) {
+    if (completion_queue_t* c = _cq->take_one()) {
         atrt.set_notify(c);
         TRACE( TRACE_TRX_FLOW, "Sleeping\n");
         bWake = true;
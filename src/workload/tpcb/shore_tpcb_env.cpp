@@ -230,6 +230,30 @@ void ShoreTPCBEnv::reset_skew()
 }
 
 
+/******************************************************************** 
+ *
+ *  @fn:    set_hot_spot()/clear_hot_spot()
+ *
+ *  @brief: places and removes the hot spot of a skew scenario for TPC-B
+ *
+ ********************************************************************/
+void ShoreTPCBEnv::set_hot_spot(double pos, double area, int load) 
+{
+    // for branches
+    b_skewer.place_pct(0, _scaling_factor-1, pos, area, load);
+    // for tellers
+    t_skewer.place_pct(0, TPCB_TELLERS_PER_BRANCH-1, pos, area, load);
+    // for accounts
+    a_skewer.place_pct(0, TPCB_ACCOUNTS_PER_BRANCH-1, pos, area, load);
+    _change_load = true;
+}
+
+void ShoreTPCBEnv::clear_hot_spot() 
+{
+    _change_load = false;
+}
+
+
 /******************************************************************** 
  *
  *  @fn:    info()
@@ -541,6 +565,10 @@ w_rc_t ShoreTPCBEnv::loaddata()
 	tc->join();
     }
 
+    // If bulk-loading, the loaders only collect the index entries. The
+    // indexes with preloaded accounts are filled by sorted inserts.
+    bool bbulkload = start_bulkload();
+
 
     // 3. Create and file up the loading workers 
 
@@ -563,6 +591,10 @@ w_rc_t ShoreTPCBEnv::loaddata()
 	loaders[i]->join();        
     }
 
+    if (bbulkload) {
+        W_DO(finish_bulkload(loaders_to_use));
+    }
+
     time_t tstop = time(NULL);
 
     // 5. Print stats
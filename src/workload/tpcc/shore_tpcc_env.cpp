@@ -264,6 +264,13 @@ w_rc_t ShoreTPCCEnv::load_schema()
     _pitem_desc       = new item_t(get_pd());
     _pstock_desc      = new stock_t(get_pd());
 
+    // the insert-only tables are appended by each worker to its own part
+    if (get_pd() & PD_HEAP_PART) {
+        _phistory_desc->set_heap_parts(heap_parts());
+        _pnew_order_desc->set_heap_parts(heap_parts());
+        _porder_desc->set_heap_parts(heap_parts());
+        _porder_line_desc->set_heap_parts(heap_parts());
+    }
 
     // initiate the table managers
     _pwarehouse_man  = new warehouse_man_impl(_pwarehouse_desc.get());
@@ -413,6 +420,26 @@ void ShoreTPCCEnv::reset_skew()
 }
 
 
+/******************************************************************** 
+ *
+ *  @fn:    set_hot_spot()/clear_hot_spot()
+ *
+ *  @brief: places and removes the hot spot of a skew scenario for TPC-C
+ *
+ ********************************************************************/
+void ShoreTPCCEnv::set_hot_spot(double pos, double area, int load) 
+{
+    // for warehouses
+    w_skewer.place_pct(1, _scaling_factor, pos, area, load);
+    _change_load = true;
+}
+
+void ShoreTPCCEnv::clear_hot_spot() 
+{
+    _change_load = false;
+}
+
+
 /******************************************************************** 
  *
  *  @fn:    info()
@@ -549,6 +576,10 @@ w_rc_t ShoreTPCCEnv::loaddata()
 	tc->join();
     }
 
+    // If bulk-loading, the loaders only collect the index entries
+    // (the warehouses and districts are already indexed)
+    bool bbulkload = start_bulkload();
+
     // 2. Fire up a checkpointer thread
     guard<checkpointer_t> chk(new checkpointer_t(this));
     chk->fork();
@@ -574,6 +605,10 @@ w_rc_t ShoreTPCCEnv::loaddata()
 	loaders[i]->join();
     }
 
+    if (bbulkload) {
+        W_DO(finish_bulkload(loaders_to_use));
+    }
+
     time_t tstop = time(NULL);
 
     // 4. Print stats
@@ -673,7 +708,7 @@ int ShoreTPCCEnv::post_init()
     conf();
 
     // If the database is set to be padded
-    if (get_pd() == PD_PADDED) {
+    if (get_pd() & PD_PADDED) {
         TRACE( TRACE_ALWAYS, "Checking for WH record padding...\n");
 
         W_COERCE(db()->begin_xct());
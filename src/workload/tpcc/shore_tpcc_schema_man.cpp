@@ -57,7 +57,7 @@ warehouse_man_impl::wh_index_probe(ss_m* db,
                                    const int w_id)
 {
     assert (ptuple);    
-    ptuple->set_value(0, w_id);
+    warehouse_row_t::set_W_ID(ptuple, w_id);
     return (index_probe_by_name(db, "W_IDX", ptuple));
 }
 
@@ -68,7 +68,7 @@ warehouse_man_impl::wh_index_probe_forupdate(ss_m* db,
                                              const int w_id)
 {
     assert (ptuple);    
-    ptuple->set_value(0, w_id);
+    warehouse_row_t::set_W_ID(ptuple, w_id);
     return (index_probe_forupdate_by_name(db, "W_IDX", ptuple));
 }
 
@@ -79,7 +79,7 @@ warehouse_man_impl::wh_index_probe_nl(ss_m* db,
                                       const int w_id)
 {
     assert (ptuple);    
-    ptuple->set_value(0, w_id);
+    warehouse_row_t::set_W_ID(ptuple, w_id);
     return (index_probe_nl_by_name(db, "W_IDX", ptuple));
 }
 
@@ -96,9 +96,9 @@ warehouse_man_impl::wh_update_ytd(ss_m* db,
     assert (ptuple->is_rid_valid());
 
     double ytd;
-    ptuple->get_value(8, ytd);
+    ytd = warehouse_row_t::get_W_YTD(ptuple);
     ytd += amount;
-    ptuple->set_value(8, ytd);
+    warehouse_row_t::set_W_YTD(ptuple, ytd);
     W_DO(update_tuple(db, ptuple, lm));
     return (RCOK);
 }
@@ -125,8 +125,8 @@ w_rc_t district_man_impl::dist_index_probe(ss_m* db,
                                            const int d_id)
 {
     assert (ptuple);
-    ptuple->set_value(0, d_id);
-    ptuple->set_value(1, w_id);
+    district_row_t::set_D_ID(ptuple, d_id);
+    district_row_t::set_D_W_ID(ptuple, w_id);
     return (index_probe_by_name(db, "D_IDX", ptuple));
 }
 
@@ -136,8 +136,8 @@ w_rc_t district_man_impl::dist_index_probe_forupdate(ss_m* db,
                                                      const int d_id)
 {
     assert (ptuple);
-    ptuple->set_value(0, d_id);
-    ptuple->set_value(1, w_id);
+    district_row_t::set_D_ID(ptuple, d_id);
+    district_row_t::set_D_W_ID(ptuple, w_id);
     return (index_probe_forupdate_by_name(db, "D_IDX", ptuple));
 }
 
@@ -147,8 +147,8 @@ w_rc_t district_man_impl::dist_index_probe_nl(ss_m* db,
                                               const int d_id)
 {
     assert (ptuple);
-    ptuple->set_value(0, d_id);
-    ptuple->set_value(1, w_id);
+    district_row_t::set_D_ID(ptuple, d_id);
+    district_row_t::set_D_W_ID(ptuple, w_id);
     return (index_probe_nl_by_name(db, "D_IDX", ptuple));
 }
 
@@ -163,9 +163,9 @@ w_rc_t district_man_impl::dist_update_ytd(ss_m* db,
     assert (ptuple->is_rid_valid());
 
     double d_ytd;
-    ptuple->get_value(9, d_ytd);
+    d_ytd = district_row_t::get_D_YTD(ptuple);
     d_ytd += amount;
-    ptuple->set_value(9, d_ytd);
+    district_row_t::set_D_YTD(ptuple, d_ytd);
     W_DO(update_tuple(db, ptuple, lm));
     return (RCOK);
 }
@@ -187,7 +187,7 @@ w_rc_t district_man_impl::dist_update_next_o_id(ss_m* db,
     assert (ptuple);
     assert (ptuple->is_rid_valid());
 
-    ptuple->set_value(10, next_o_id);
+    district_row_t::set_D_NEXT_O_ID(ptuple, next_o_id);
     return (update_tuple(db, ptuple, lm));
 }
 
@@ -226,11 +226,11 @@ w_rc_t customer_man_impl::cust_get_iter_by_index(ss_m* db,
     // C_NAME_IDX: {2 - 1 - 5 - 3 - 0}
 
     // prepare the key to be probed
-    ptuple->set_value(0, 0);
-    ptuple->set_value(1, d_id);
-    ptuple->set_value(2, w_id);
-    ptuple->set_value(3, "");
-    ptuple->set_value(5, c_last);
+    customer_row_t::set_C_ID(ptuple, 0);
+    customer_row_t::set_C_D_ID(ptuple, d_id);
+    customer_row_t::set_C_W_ID(ptuple, w_id);
+    customer_row_t::set_C_FIRST(ptuple, "");
+    customer_row_t::set_C_LAST(ptuple, c_last);
 
     int lowsz = format_key(pindex, ptuple, replow);
     assert (replow._dest);
@@ -238,7 +238,7 @@ w_rc_t customer_man_impl::cust_get_iter_by_index(ss_m* db,
     char   temp[2];
     temp[0] = MAX('z', 'Z')+1;
     temp[1] = '\0';
-    ptuple->set_value(3, temp);
+    customer_row_t::set_C_FIRST(ptuple, temp);
 
     int highsz = format_key(pindex, ptuple, rephigh);
     assert (rephigh._dest);    
@@ -284,9 +284,9 @@ w_rc_t customer_man_impl::cust_index_probe_by_name(ss_m* db,
                                                    const int c_id)
 {
     assert (idx_name);
-    ptuple->set_value(0, c_id);
-    ptuple->set_value(1, d_id);
-    ptuple->set_value(2, w_id);
+    customer_row_t::set_C_ID(ptuple, c_id);
+    customer_row_t::set_C_D_ID(ptuple, d_id);
+    customer_row_t::set_C_W_ID(ptuple, w_id);
     return (index_probe_by_name(db, idx_name, ptuple));
 }
 
@@ -297,9 +297,9 @@ w_rc_t customer_man_impl::cust_index_probe_forupdate(ss_m * db,
                                                      const int c_id)
 {
     assert (ptuple);
-    ptuple->set_value(0, c_id);
-    ptuple->set_value(1, d_id);
-    ptuple->set_value(2, w_id);
+    customer_row_t::set_C_ID(ptuple, c_id);
+    customer_row_t::set_C_D_ID(ptuple, d_id);
+    customer_row_t::set_C_W_ID(ptuple, w_id);
     return (index_probe_forupdate_by_name(db, "C_IDX", ptuple));
 }
 
@@ -310,9 +310,9 @@ w_rc_t customer_man_impl::cust_index_probe_nl(ss_m * db,
                                               const int c_id)
 {
     assert (ptuple);
-    ptuple->set_value(0, c_id);
-    ptuple->set_value(1, d_id);
-    ptuple->set_value(2, w_id);
+    customer_row_t::set_C_ID(ptuple, c_id);
+    customer_row_t::set_C_D_ID(ptuple, d_id);
+    customer_row_t::set_C_W_ID(ptuple, w_id);
     return (index_probe_nl_by_name(db, "C_IDX", ptuple));
 }
 
@@ -324,15 +324,15 @@ w_rc_t customer_man_impl::cust_update_tuple(ss_m* db,
                                             lock_mode_t lm)
 {
     assert (ptuple);
-    ptuple->set_value(16, acustomer.C_BALANCE);
-    ptuple->set_value(17, acustomer.C_YTD_PAYMENT);
-    ptuple->set_value(19, acustomer.C_PAYMENT_CNT);
+    customer_row_t::set_C_BALANCE(ptuple, acustomer.C_BALANCE);
+    customer_row_t::set_C_YTD_PAYMENT(ptuple, acustomer.C_YTD_PAYMENT);
+    customer_row_t::set_C_PAYMENT_CNT(ptuple, acustomer.C_PAYMENT_CNT);
 
     if (adata1)
-	ptuple->set_value(20, adata1);
+	customer_row_t::set_C_DATA_1(ptuple, adata1);
 
     if (adata2)
-	ptuple->set_value(21, adata2);
+	customer_row_t::set_C_DATA_2(ptuple, adata2);
 
     return (update_tuple(db, ptuple, lm));
 }
@@ -356,8 +356,8 @@ w_rc_t customer_man_impl::cust_update_discount_balance(ss_m* db,
 {
     assert (ptuple);
     assert (discount>=0);
-    ptuple->set_value(15, discount);
-    ptuple->set_value(16, balance);
+    customer_row_t::set_C_DISCOUNT(ptuple, discount);
+    customer_row_t::set_C_BALANCE(ptuple, balance);
     return (update_tuple(db, ptuple, lm));
 }
 
@@ -394,15 +394,15 @@ w_rc_t new_order_man_impl::no_get_iter_by_index(ss_m* db,
     assert (pindex);
 
     /* get the lowest key value */
-    ptuple->set_value(0, 0);
-    ptuple->set_value(1, d_id);
-    ptuple->set_value(2, w_id);
+    new_order_row_t::set_NO_O_ID(ptuple, 0);
+    new_order_row_t::set_NO_D_ID(ptuple, d_id);
+    new_order_row_t::set_NO_W_ID(ptuple, w_id);
 
     int lowsz = format_key(pindex, ptuple, replow);
     assert (replow._dest);
 
     /* get the highest key value */
-    ptuple->set_value(1, d_id+1);
+    new_order_row_t::set_NO_D_ID(ptuple, d_id+1);
 
     int highsz = format_key(pindex, ptuple, rephigh);
     assert (rephigh._dest);
@@ -440,9 +440,9 @@ w_rc_t new_order_man_impl::no_delete_by_index(ss_m* db,
     // 1. idx probe new_order
     // 2. deletes the retrieved new_order
 
-    ptuple->set_value(0, o_id);
-    ptuple->set_value(1, d_id);
-    ptuple->set_value(2, w_id);
+    new_order_row_t::set_NO_O_ID(ptuple, o_id);
+    new_order_row_t::set_NO_D_ID(ptuple, d_id);
+    new_order_row_t::set_NO_W_ID(ptuple, w_id);
 //     W_DO(index_probe_forupdate_by_name(db, "NO_IDX", ptuple));
     W_DO(delete_tuple(db, ptuple));
 
@@ -462,9 +462,9 @@ w_rc_t new_order_man_impl::no_delete_by_index_nl(ss_m* db,
     // 1. idx probe new_order
     // 2. deletes the retrieved new_order
 
-    ptuple->set_value(0, o_id);
-    ptuple->set_value(1, d_id);
-    ptuple->set_value(2, w_id);
+    new_order_row_t::set_NO_O_ID(ptuple, o_id);
+    new_order_row_t::set_NO_D_ID(ptuple, d_id);
+    new_order_row_t::set_NO_W_ID(ptuple, w_id);
     //W_DO(index_probe_nl_by_name(db, "NO_IDX", ptuple));
     W_DO(delete_tuple(db, ptuple, NL));
 
@@ -497,16 +497,16 @@ w_rc_t order_man_impl::ord_get_iter_by_index(ss_m* db,
     assert (pindex);
 
     /* get the lowest key value */
-    ptuple->set_value(0, 0);
-    ptuple->set_value(1, c_id);
-    ptuple->set_value(2, d_id);
-    ptuple->set_value(3, w_id);
+    order_row_t::set_O_ID(ptuple, 0);
+    order_row_t::set_O_C_ID(ptuple, c_id);
+    order_row_t::set_O_D_ID(ptuple, d_id);
+    order_row_t::set_O_W_ID(ptuple, w_id);
 
     int lowsz = format_key(pindex, ptuple, replow);
     assert (replow._dest);
 
     /* get the highest key value */
-    ptuple->set_value(1, c_id+1);
+    order_row_t::set_O_C_ID(ptuple, c_id+1);
 
     int highsz  = format_key(pindex, ptuple, rephigh);
     assert (rephigh._dest);
@@ -544,7 +544,7 @@ w_rc_t order_man_impl::ord_update_carrier_by_index(ss_m* db,
 
     W_DO(index_probe_forupdate_by_name(db, "O_IDX", ptuple));
 
-    ptuple->set_value(5, carrier_id);
+    order_row_t::set_O_CARRIER_ID(ptuple, carrier_id);
     W_DO(update_tuple(db, ptuple));
 
     return (RCOK);
@@ -563,7 +563,7 @@ w_rc_t order_man_impl::ord_update_carrier_by_index_nl(ss_m* db,
 
     W_DO(index_probe_nl_by_name(db, "O_IDX", ptuple));
 
-    ptuple->set_value(5, carrier_id);
+    order_row_t::set_O_CARRIER_ID(ptuple, carrier_id);
     W_DO(update_tuple(db, ptuple, NL));
 
     return (RCOK);
@@ -598,16 +598,16 @@ w_rc_t order_line_man_impl::ol_get_range_iter_by_index(ss_m* db,
     assert (pindex);
 
     // get the lowest key value
-    ptuple->set_value(0, low_o_id);
-    ptuple->set_value(1, d_id);
-    ptuple->set_value(2, w_id);
-    ptuple->set_value(3, (int)0);  /* assuming that ol_number starts from 1 */
+    order_line_row_t::set_OL_O_ID(ptuple, low_o_id);
+    order_line_row_t::set_OL_D_ID(ptuple, d_id);
+    order_line_row_t::set_OL_W_ID(ptuple, w_id);
+    order_line_row_t::set_OL_NUMBER(ptuple, 0);  /* assuming that ol_number starts from 1 */
 
     int lowsz = format_key(pindex, ptuple, replow);
     assert (replow._dest);
 
     // get the highest key value
-    ptuple->set_value(0, high_o_id+1);
+    order_line_row_t::set_OL_O_ID(ptuple, high_o_id+1);
 
     int highsz = format_key(pindex, ptuple, rephigh);
     assert (rephigh._dest);
@@ -658,16 +658,16 @@ w_rc_t order_line_man_impl::ol_get_probe_iter_by_index(ss_m* db,
     index_desc_t* pindex = _ptable->find_index("OL_IDX");
     assert (pindex);
 
-    ptuple->set_value(0, o_id);
-    ptuple->set_value(1, d_id);
-    ptuple->set_value(2, w_id);
-    ptuple->set_value(3, (int)0);
+    order_line_row_t::set_OL_O_ID(ptuple, o_id);
+    order_line_row_t::set_OL_D_ID(ptuple, d_id);
+    order_line_row_t::set_OL_W_ID(ptuple, w_id);
+    order_line_row_t::set_OL_NUMBER(ptuple, 0);
 
     int lowsz = format_key(pindex, ptuple, replow);
     assert (replow._dest);
 
     /* get the highest key value */
-    ptuple->set_value(0, o_id+1);
+    order_line_row_t::set_OL_O_ID(ptuple, o_id+1);
 
     int highsz = format_key(pindex, ptuple, rephigh);
     assert (rephigh._dest);
@@ -705,7 +705,7 @@ w_rc_t item_man_impl::it_index_probe(ss_m* db,
                                      const int i_id)
 {
     assert (ptuple);
-    ptuple->set_value(0, i_id);
+    item_row_t::set_I_ID(ptuple, i_id);
     return (index_probe_by_name(db, "I_IDX", ptuple));
 }
 
@@ -714,7 +714,7 @@ w_rc_t item_man_impl::it_index_probe_forupdate(ss_m* db,
                                                const int i_id)
 {
     assert (ptuple);
-    ptuple->set_value(0, i_id);
+    item_row_t::set_I_ID(ptuple, i_id);
     return (index_probe_forupdate_by_name(db, "I_IDX", ptuple));
 }
 
@@ -723,10 +723,23 @@ w_rc_t item_man_impl::it_index_probe_nl(ss_m* db,
                                         const int i_id)
 {
     assert (ptuple);
-    ptuple->set_value(0, i_id);
+    item_row_t::set_I_ID(ptuple, i_id);
     return (index_probe_nl_by_name(db, "I_IDX", ptuple));
 }
 
+w_rc_t item_man_impl::it_index_probe_batch(ss_m* db, 
+                                           item_tuple** ptuples,
+                                           const int* i_ids,
+                                           const int count)
+{
+    assert (ptuples);
+    assert (i_ids);
+    for (int i=0; i<count; i++) {
+        item_row_t::set_I_ID(ptuples[i], i_ids[i]);
+    }
+    return (index_probe_batch_by_name(db, "I_IDX", ptuples, count));
+}
+
 
 
 /* ------------- */
@@ -740,8 +753,8 @@ w_rc_t stock_man_impl::st_index_probe(ss_m* db,
                                       const int i_id)
 {
     assert (ptuple);
-    ptuple->set_value(0, i_id);
-    ptuple->set_value(1, w_id);
+    stock_row_t::set_S_I_ID(ptuple, i_id);
+    stock_row_t::set_S_W_ID(ptuple, w_id);
     return (index_probe_by_name(db, "S_IDX", ptuple));
 }
 
@@ -751,19 +764,36 @@ w_rc_t stock_man_impl::st_index_probe_forupdate(ss_m* db,
                                                 const int i_id)
 {
     assert (ptuple);
-    ptuple->set_value(0, i_id);
-    ptuple->set_value(1, w_id);
+    stock_row_t::set_S_I_ID(ptuple, i_id);
+    stock_row_t::set_S_W_ID(ptuple, w_id);
     return (index_probe_forupdate_by_name(db, "S_IDX", ptuple));
 }
 
+w_rc_t stock_man_impl::st_index_probe_batch(ss_m* db,
+                                            stock_tuple** ptuples,
+                                            const int* w_ids,
+                                            const int* i_ids,
+                                            const int count,
+                                            lock_mode_t lm)
+{
+    assert (ptuples);
+    assert (w_ids);
+    assert (i_ids);
+    for (int i=0; i<count; i++) {
+        stock_row_t::set_S_I_ID(ptuples[i], i_ids[i]);
+        stock_row_t::set_S_W_ID(ptuples[i], w_ids[i]);
+    }
+    return (index_probe_batch_by_name(db, "S_IDX", ptuples, count, lm));
+}
+
 w_rc_t stock_man_impl::st_index_probe_nl(ss_m* db,
                                          stock_tuple* ptuple,
                                          const int w_id,
                                          const int i_id)
 {
     assert (ptuple);
-    ptuple->set_value(0, i_id);
-    ptuple->set_value(1, w_id);
+    stock_row_t::set_S_I_ID(ptuple, i_id);
+    stock_row_t::set_S_W_ID(ptuple, w_id);
     return (index_probe_nl_by_name(db, "S_IDX", ptuple));
 }
 
@@ -777,10 +807,10 @@ w_rc_t  stock_man_impl::st_update_tuple(ss_m* db,
     assert (ptuple);
     assert (ptuple->is_rid_valid());
 
-    ptuple->set_value(2, pstock->S_REMOTE_CNT);
-    ptuple->set_value(3, pstock->S_QUANTITY);
-    ptuple->set_value(4, pstock->S_ORDER_CNT);
-    ptuple->set_value(5, pstock->S_YTD);
+    stock_row_t::set_S_REMOTE_CNT(ptuple, pstock->S_REMOTE_CNT);
+    stock_row_t::set_S_QUANTITY(ptuple, pstock->S_QUANTITY);
+    stock_row_t::set_S_ORDER_CNT(ptuple, pstock->S_ORDER_CNT);
+    stock_row_t::set_S_YTD(ptuple, pstock->S_YTD);
     //    return (table_man_impl<stock_t>::update_tuple(db, ptuple));
     return (update_tuple(db, ptuple, lm));
 }
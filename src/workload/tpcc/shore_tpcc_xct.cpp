@@ -363,29 +363,29 @@ w_rc_t ShoreTPCCEnv::xct_populate_baseline(const int /* xct_id */,
 
 	    if(j == 0) {
 		// warehouse
-		prwh->set_value(0, i);
-		prwh->set_value(1, name);
-		prwh->set_value(2, street_1);
-		prwh->set_value(3, street_2);
-		prwh->set_value(4, city);
-		prwh->set_value(5, state);
-		prwh->set_value(6, zip);
-		prwh->set_value(7, tax);
-		prwh->set_value(8, 300000.0);
+		warehouse_row_t::set_W_ID(prwh, i);
+		warehouse_row_t::set_W_NAME(prwh, name);
+		warehouse_row_t::set_W_STREET1(prwh, street_1);
+		warehouse_row_t::set_W_STREET2(prwh, street_2);
+		warehouse_row_t::set_W_CITY(prwh, city);
+		warehouse_row_t::set_W_STATE(prwh, state);
+		warehouse_row_t::set_W_ZIP(prwh, zip);
+		warehouse_row_t::set_W_TAX(prwh, tax);
+		warehouse_row_t::set_W_YTD(prwh, 300000.0);
 		W_DO(_pwarehouse_man->add_tuple(_pssm, prwh));
 	    } else {
 		// dist
-		prdist->set_value(0, j);
-		prdist->set_value(1, i);
-		prdist->set_value(2, name);
-		prdist->set_value(3, street_1);
-		prdist->set_value(4, street_2);
-		prdist->set_value(5, city);
-		prdist->set_value(6, state);
-		prdist->set_value(7, zip);
-		prdist->set_value(8, tax);
-		prdist->set_value(9, 300000.0);
-		prdist->set_value(10, CUSTOMERS_PER_DISTRICT+1);
+		district_row_t::set_D_ID(prdist, j);
+		district_row_t::set_D_W_ID(prdist, i);
+		district_row_t::set_D_NAME(prdist, name);
+		district_row_t::set_D_STREET1(prdist, street_1);
+		district_row_t::set_D_STREET2(prdist, street_2);
+		district_row_t::set_D_CITY(prdist, city);
+		district_row_t::set_D_STATE(prdist, state);
+		district_row_t::set_D_ZIP(prdist, zip);
+		district_row_t::set_D_TAX(prdist, tax);
+		district_row_t::set_D_YTD(prdist, 300000.0);
+		district_row_t::set_D_NEXT_O_ID(prdist, CUSTOMERS_PER_DISTRICT+1);
 		W_DO(_pdistrict_man->add_tuple(_pssm, prdist));
 	    }
 	}
@@ -457,33 +457,33 @@ w_rc_t ShoreTPCCEnv::xct_populate_one_unit(const int /* xct_id */,
 	    create_random_a_string(dist_info, 24, 24);
 	    int amount = rand_integer(0, 999999);
 	    // insert oline
-	    prol->set_value(0, oid);
-	    prol->set_value(1, did);
-	    prol->set_value(2, wid);
-	    prol->set_value(3, j);
-	    prol->set_value(4, item_num);
-	    prol->set_value(5, wid);
-	    prol->set_value(6, is_new? 0.0 : currtmstmp);
-	    prol->set_value(7, 5);
-	    prol->set_value(8, amount);
-	    prol->set_value(9, dist_info);
+	    order_line_row_t::set_OL_O_ID(prol, oid);
+	    order_line_row_t::set_OL_D_ID(prol, did);
+	    order_line_row_t::set_OL_W_ID(prol, wid);
+	    order_line_row_t::set_OL_NUMBER(prol, j);
+	    order_line_row_t::set_OL_I_ID(prol, item_num);
+	    order_line_row_t::set_OL_SUPPLY_W_ID(prol, wid);
+	    order_line_row_t::set_OL_DELIVERY_D(prol, is_new? 0.0 : currtmstmp);
+	    order_line_row_t::set_OL_QUANTITY(prol, 5);
+	    order_line_row_t::set_OL_AMOUNT(prol, amount);
+	    order_line_row_t::set_OL_DIST_INFO(prol, dist_info);
 	    W_DO(_porder_line_man->add_tuple(_pssm, prol));
 	}
 	// insert order
-	prord->set_value(0, oid);
-	prord->set_value(1, o_cid);
-	prord->set_value(2, did);
-	prord->set_value(3, wid);
-	prord->set_value(4, currtmstmp);
-	prord->set_value(5, carrier);
-	prord->set_value(6, olines);
-	prord->set_value(7, all_local);
+	order_row_t::set_O_ID(prord, oid);
+	order_row_t::set_O_C_ID(prord, o_cid);
+	order_row_t::set_O_D_ID(prord, did);
+	order_row_t::set_O_W_ID(prord, wid);
+	order_row_t::set_O_ENTRY_D(prord, currtmstmp);
+	order_row_t::set_O_CARRIER_ID(prord, carrier);
+	order_row_t::set_O_OL_CNT(prord, olines);
+	order_row_t::set_O_ALL_LOCAL(prord, all_local);
 	W_DO(_porder_man->add_tuple(_pssm, prord));
 	// insert new order
 	if(is_new) {
-	    prno->set_value(0, oid);
-	    prno->set_value(1, did);
-	    prno->set_value(2, wid);
+	    new_order_row_t::set_NO_O_ID(prno, oid);
+	    new_order_row_t::set_NO_D_ID(prno, did);
+	    new_order_row_t::set_NO_W_ID(prno, wid);
 	    W_DO(_pnew_order_man->add_tuple(_pssm, prno));
 	}
     }
@@ -500,16 +500,16 @@ w_rc_t ShoreTPCCEnv::xct_populate_one_unit(const int /* xct_id */,
 	    create_random_a_string(stock_dist[j], 24, 24);
 	}
 	// insert stock
-	prst->set_value(0, stock_num);
-	prst->set_value(1, wid);
-	prst->set_value(2, (int)0);
-	prst->set_value(3, qty);
-	prst->set_value(4, (int)0);
-	prst->set_value(5, (int)0);
+	stock_row_t::set_S_I_ID(prst, stock_num);
+	stock_row_t::set_S_W_ID(prst, wid);
+	stock_row_t::set_S_REMOTE_CNT(prst, 0);
+	stock_row_t::set_S_QUANTITY(prst, qty);
+	stock_row_t::set_S_ORDER_CNT(prst, 0);
+	stock_row_t::set_S_YTD(prst, 0);
 	for(int k=0; k < 10; k++) {
 	    prst->set_value(6+k, stock_dist[k]);
 	}
-	prst->set_value(16, stock_data);
+	stock_row_t::set_S_DATA(prst, stock_data);
 	W_DO(_pstock_man->add_tuple(_pssm, prst));
 	
 	// ITEM
@@ -521,11 +521,11 @@ w_rc_t ShoreTPCCEnv::xct_populate_one_unit(const int /* xct_id */,
 	    create_random_a_string( item_name, 14, 24);
 	    create_a_string_with_original( item_data, 26, 50, 10) ;    
 	    // insert item
-	    pritem->set_value(0, stock_num);
-	    pritem->set_value(1, im_id);
-	    pritem->set_value(2, item_name);
-	    pritem->set_value(3, item_price);
-	    pritem->set_value(4, item_data);	    
+	    item_row_t::set_I_ID(pritem, stock_num);
+	    item_row_t::set_I_IM_ID(pritem, im_id);
+	    item_row_t::set_I_NAME(pritem, item_name);
+	    item_row_t::set_I_PRICE(pritem, item_price);
+	    item_row_t::set_I_DATA(pritem, item_data);	    
 	    W_DO(_pitem_man->add_tuple(_pssm, pritem));
 	}
     }
@@ -538,14 +538,14 @@ w_rc_t ShoreTPCCEnv::xct_populate_one_unit(const int /* xct_id */,
 	double amount = 1000; // $10.00
 	create_random_a_string(hist_data, 12, 24);
 	// insert hist
-	prhist->set_value(0, cid);
-	prhist->set_value(1, did);
-	prhist->set_value(2, wid);
-	prhist->set_value(3, did);
-	prhist->set_value(4, did);
-	prhist->set_value(5, currtmstmp);
-	prhist->set_value(6, amount);
-	prhist->set_value(7, hist_data);
+	history_row_t::set_H_C_ID(prhist, cid);
+	history_row_t::set_H_C_D_ID(prhist, did);
+	history_row_t::set_H_C_W_ID(prhist, wid);
+	history_row_t::set_H_D_ID(prhist, did);
+	history_row_t::set_H_W_ID(prhist, did);
+	history_row_t::set_H_DATE(prhist, currtmstmp);
+	history_row_t::set_H_AMOUNT(prhist, amount);
+	history_row_t::set_H_DATA(prhist, hist_data);
 	W_DO(_phistory_man->add_tuple(_pssm, prhist));
     }
 
@@ -579,28 +579,28 @@ w_rc_t ShoreTPCCEnv::xct_populate_one_unit(const int /* xct_id */,
 	create_random_a_string( cust_data1, 250, 250);
 	create_random_a_string( cust_data2, 50,  250);	
 	// insert cust
-	prcust->set_value(0, cid);
-	prcust->set_value(1, did);
-	prcust->set_value(2, wid);
-	prcust->set_value(3, cust_first);
-	prcust->set_value(4, "OE");
-	prcust->set_value(5, cust_last);
-	prcust->set_value(6, cust_street_1);
-	prcust->set_value(7, cust_street_2);
-	prcust->set_value(8, cust_city);
-	prcust->set_value(9, cust_state);
-	prcust->set_value(10, cust_zip);
-	prcust->set_value(11, cust_phone);
-	prcust->set_value(12, currtmstmp);
-	prcust->set_value(13, cust_credit);
-	prcust->set_value(14, 50000.0);
-	prcust->set_value(15, cust_discount);
-	prcust->set_value(16, 0.0);
-	prcust->set_value(17, -10.0);
-	prcust->set_value(18, 10.0);
-	prcust->set_value(19, 1);
-	prcust->set_value(20, cust_data1);
-	prcust->set_value(21, cust_data2);	
+	customer_row_t::set_C_ID(prcust, cid);
+	customer_row_t::set_C_D_ID(prcust, did);
+	customer_row_t::set_C_W_ID(prcust, wid);
+	customer_row_t::set_C_FIRST(prcust, cust_first);
+	customer_row_t::set_C_MIDDLE(prcust, "OE");
+	customer_row_t::set_C_LAST(prcust, cust_last);
+	customer_row_t::set_C_STREET1(prcust, cust_street_1);
+	customer_row_t::set_C_STREET2(prcust, cust_street_2);
+	customer_row_t::set_C_CITY(prcust, cust_city);
+	customer_row_t::set_C_STATE(prcust, cust_state);
+	customer_row_t::set_C_ZIP(prcust, cust_zip);
+	customer_row_t::set_C_PHONE(prcust, cust_phone);
+	customer_row_t::set_C_SINCE(prcust, currtmstmp);
+	customer_row_t::set_C_CREDIT(prcust, cust_credit);
+	customer_row_t::set_C_CREDIT_LIM(prcust, 50000.0);
+	customer_row_t::set_C_DISCOUNT(prcust, cust_discount);
+	customer_row_t::set_C_BALANCE(prcust, 0.0);
+	customer_row_t::set_C_YTD_PAYMENT(prcust, -10.0);
+	customer_row_t::set_C_LAST_PAYMENT(prcust, 10.0);
+	customer_row_t::set_C_PAYMENT_CNT(prcust, 1);
+	customer_row_t::set_C_DATA_1(prcust, cust_data1);
+	customer_row_t::set_C_DATA_2(prcust, cust_data2);	
 	W_DO(_pcustomer_man->add_tuple(_pssm, prcust));
     }
     
@@ -735,8 +735,6 @@ w_rc_t ShoreTPCCEnv::xct_new_order(const int xct_id,
     tuple_guard<customer_man_impl> prcust(_pcustomer_man);
     tuple_guard<new_order_man_impl> prno(_pnew_order_man);
     tuple_guard<order_man_impl> prord(_porder_man);
-    tuple_guard<item_man_impl> pritem(_pitem_man);
-    tuple_guard<stock_man_impl> prst(_pstock_man);
     tuple_guard<order_line_man_impl> prol(_porder_line_man);
 
     rep_row_t areprow(_pcustomer_man->ts());
@@ -749,8 +747,6 @@ w_rc_t ShoreTPCCEnv::xct_new_order(const int xct_id,
     prcust->_rep = &areprow;
     prno->_rep = &areprow;
     prord->_rep = &areprow;
-    pritem->_rep = &areprow;
-    prst->_rep = &areprow;
     prol->_rep = &areprow;
 
 
@@ -767,7 +763,7 @@ w_rc_t ShoreTPCCEnv::xct_new_order(const int xct_id,
     W_DO(_pwarehouse_man->wh_index_probe(_pssm, prwh, pnoin._wh_id));
 
     tpcc_warehouse_tuple awh;
-    prwh->get_value(7, awh.W_TAX);
+    awh.W_TAX = warehouse_row_t::get_W_TAX(prwh);
 
 
     /* SELECT d_tax, d_next_o_id
@@ -784,8 +780,8 @@ w_rc_t ShoreTPCCEnv::xct_new_order(const int xct_id,
 						    pnoin._wh_id, pnoin._d_id));
     
     tpcc_district_tuple adist;
-    prdist->get_value(8, adist.D_TAX);
-    prdist->get_value(10, adist.D_NEXT_O_ID);
+    adist.D_TAX = district_row_t::get_D_TAX(prdist);
+    adist.D_NEXT_O_ID = district_row_t::get_D_NEXT_O_ID(prdist);
     adist.D_NEXT_O_ID++;
 
     // 3. retrieve customer
@@ -795,9 +791,9 @@ w_rc_t ShoreTPCCEnv::xct_new_order(const int xct_id,
 					  pnoin._d_id, pnoin._c_id));
     
     tpcc_customer_tuple  acust;
-    prcust->get_value(15, acust.C_DISCOUNT);
-    prcust->get_value(13, acust.C_CREDIT, 3);
-    prcust->get_value(5, acust.C_LAST, 17);
+    acust.C_DISCOUNT = customer_row_t::get_C_DISCOUNT(prcust);
+    customer_row_t::get_C_CREDIT(prcust, acust.C_CREDIT);
+    customer_row_t::get_C_LAST(prcust, acust.C_LAST);
     
     
     /* UPDATE district
@@ -812,58 +808,84 @@ w_rc_t ShoreTPCCEnv::xct_new_order(const int xct_id,
 
     double total_amount = 0;
 
-    for (int item_cnt=0; item_cnt<pnoin._ol_cnt; item_cnt++) {
+    /* SELECT i_price, i_name, i_data
+     * FROM item
+     * WHERE i_id = :ol_i_id
+     *
+     * SELECT s_quantity, s_remote_cnt, s_data,
+     *        s_dist0, s_dist1, s_dist2, ...
+     * FROM stock
+     * WHERE s_i_id = :ol_i_id AND s_w_id = :ol_supply_w_id
+     *
+     * plan: batched index probes on "I_IDX" and "S_IDX", for all the
+     *       items of the order. The stock rows are locked in key order,
+     *       so that concurrent new orders do not deadlock on them.
+     */
 
-	// 4. for all items read item, and update stock, and order line
-	int ol_i_id = pnoin.items[item_cnt]._ol_i_id;
-	int ol_supply_w_id = pnoin.items[item_cnt]._ol_supply_wh_id;
-	
-	
-	/* SELECT i_price, i_name, i_data
-	 * FROM item
-	 * WHERE i_id = :ol_i_id
-	 *
-	 * plan: index probe on "I_IDX"
-	 */
+    // 4. read all the items and the stock rows
+    int ol_cnt = pnoin._ol_cnt;
+    int ol_i_ids[MAX_OL_PER_ORDER];
+    int ol_supply_w_ids[MAX_OL_PER_ORDER];
+    for (int item_cnt=0; item_cnt<ol_cnt; item_cnt++) {
+        ol_i_ids[item_cnt] = pnoin.items[item_cnt]._ol_i_id;
+        ol_supply_w_ids[item_cnt] = pnoin.items[item_cnt]._ol_supply_wh_id;
+    }
+
+    tuple_batch_guard<item_man_impl> pritems(_pitem_man, ol_cnt);
+    tuple_batch_guard<stock_man_impl> prsts(_pstock_man, ol_cnt);
+    pritems.set_rep(&areprow);
+    prsts.set_rep(&areprow);
+
+    TRACE( TRACE_TRX_FLOW, "App: %d NO:item-idx-probe-batch (%d)\n", 
+           xct_id, ol_cnt);
+    W_DO(_pitem_man->it_index_probe_batch(_pssm, pritems, ol_i_ids, ol_cnt));
+
+    TRACE( TRACE_TRX_FLOW, "App: %d NO:stock-idx-upd-batch (%d)\n", 
+           xct_id, ol_cnt);
+    W_DO(_pstock_man->st_index_probe_batch(_pssm, prsts, ol_supply_w_ids,
+                                           ol_i_ids, ol_cnt, EX));
+
+    for (int item_cnt=0; item_cnt<ol_cnt; item_cnt++) {
+
+	// 5. for all items update stock, and insert order line
+	int ol_i_id = ol_i_ids[item_cnt];
+	int ol_supply_w_id = ol_supply_w_ids[item_cnt];
+	table_row_t* pritem = pritems[item_cnt];
+	table_row_t* prst = prsts[item_cnt];
 	
 	tpcc_item_tuple aitem;
-	TRACE( TRACE_TRX_FLOW, "App: %d NO:item-idx-probe (%d)\n", 
-	       xct_id, ol_i_id);
-	W_DO(_pitem_man->it_index_probe(_pssm, pritem, ol_i_id));
-	
-	pritem->get_value(4, aitem.I_DATA, 51);
-	pritem->get_value(3, aitem.I_PRICE);
-	pritem->get_value(2, aitem.I_NAME, 25);
+	item_row_t::get_I_DATA(pritem, aitem.I_DATA);
+	aitem.I_PRICE = item_row_t::get_I_PRICE(pritem);
+	item_row_t::get_I_NAME(pritem, aitem.I_NAME);
 	
 	int item_amount = aitem.I_PRICE * pnoin.items[item_cnt]._ol_quantity; 
 	total_amount += item_amount;
 	//info->items[item_cnt].ol_amount = amount;
 	
-	
-	/* SELECT s_quantity, s_remote_cnt, s_data,
-	 *        s_dist0, s_dist1, s_dist2, ...
-	 * FROM stock
-	 * WHERE s_i_id = :ol_i_id AND s_w_id = :ol_supply_w_id
-	 *
-	 * plan: index probe on "S_IDX"
-	 */
-	
+	// an item ordered twice: re-read the row updated by the earlier line
+	for (int prev=0; prev<item_cnt; prev++) {
+	    if ((ol_i_ids[prev] == ol_i_id) && 
+		(ol_supply_w_ids[prev] == ol_supply_w_id)) {
+		TRACE( TRACE_TRX_FLOW, "App: %d NO:stock-idx-upd (%d) (%d)\n", 
+		       xct_id, ol_supply_w_id, ol_i_id);
+		W_DO(_pstock_man->st_index_probe_forupdate(_pssm, prst,
+							   ol_supply_w_id, ol_i_id));
+		break;
+	    }
+	}
+
 	tpcc_stock_tuple astock;
-	TRACE( TRACE_TRX_FLOW, "App: %d NO:stock-idx-upd (%d) (%d)\n", 
-	       xct_id, ol_supply_w_id, ol_i_id);
-	W_DO(_pstock_man->st_index_probe_forupdate(_pssm, prst,
-						   ol_supply_w_id, ol_i_id));
-	prst->get_value(0, astock.S_I_ID);
-	prst->get_value(1, astock.S_W_ID);
-	prst->get_value(5, astock.S_YTD);
+	astock.S_I_ID = stock_row_t::get_S_I_ID(prst);
+	astock.S_W_ID = stock_row_t::get_S_W_ID(prst);
+	astock.S_YTD = stock_row_t::get_S_YTD(prst);
 	astock.S_YTD += pnoin.items[item_cnt]._ol_quantity;
-	prst->get_value(2, astock.S_REMOTE_CNT);        
-	prst->get_value(3, astock.S_QUANTITY);
+	astock.S_REMOTE_CNT = stock_row_t::get_S_REMOTE_CNT(prst);        
+	astock.S_QUANTITY = stock_row_t::get_S_QUANTITY(prst);
 	astock.S_QUANTITY -= pnoin.items[item_cnt]._ol_quantity;
 	if (astock.S_QUANTITY < 10) astock.S_QUANTITY += 91;
 	//prst->get_value(6+pnoin._d_id, astock.S_DIST[6+pnoin._d_id], 25);
 	prst->get_value(6+pnoin._d_id, astock.S_DIST[pnoin._d_id], 25);
-	prst->get_value(16, astock.S_DATA, 51);
+	stock_row_t::get_S_DATA(prst, astock.S_DATA);
 
 	char c_s_brand_generic;
 	if (strstr(aitem.I_DATA, "ORIGINAL") != NULL && 
@@ -871,7 +893,7 @@ w_rc_t ShoreTPCCEnv::xct_new_order(const int xct_id,
 	    c_s_brand_generic = 'B';
 	else c_s_brand_generic = 'G';
 	
-	prst->get_value(4, astock.S_ORDER_CNT);
+	astock.S_ORDER_CNT = stock_row_t::get_S_ORDER_CNT(prst);
 	astock.S_ORDER_CNT++;
 	
 	if (pnoin._wh_id != ol_supply_w_id) {
@@ -894,17 +916,17 @@ w_rc_t ShoreTPCCEnv::xct_new_order(const int xct_id,
 	 *        '0001-01-01-00.00.01.000000', ol_quantity, iol_amount, dist)
 	 */
 	
-	prol->set_value(0, adist.D_NEXT_O_ID);
-	prol->set_value(1, pnoin._d_id);
-	prol->set_value(2, pnoin._wh_id);
-	prol->set_value(3, item_cnt+1);
-	prol->set_value(4, ol_i_id);
-	prol->set_value(5, ol_supply_w_id);
-	prol->set_value(6, pnoin._tstamp);
-	prol->set_value(7, pnoin.items[item_cnt]._ol_quantity);
-	prol->set_value(8, item_amount);	
+	order_line_row_t::set_OL_O_ID(prol, adist.D_NEXT_O_ID);
+	order_line_row_t::set_OL_D_ID(prol, pnoin._d_id);
+	order_line_row_t::set_OL_W_ID(prol, pnoin._wh_id);
+	order_line_row_t::set_OL_NUMBER(prol, item_cnt+1);
+	order_line_row_t::set_OL_I_ID(prol, ol_i_id);
+	order_line_row_t::set_OL_SUPPLY_W_ID(prol, ol_supply_w_id);
+	order_line_row_t::set_OL_DELIVERY_D(prol, pnoin._tstamp);
+	order_line_row_t::set_OL_QUANTITY(prol, pnoin.items[item_cnt]._ol_quantity);
+	order_line_row_t::set_OL_AMOUNT(prol, item_amount);	
 	//prol->set_value(9, astock.S_DIST[6+pnoin._d_id]);
-	prol->set_value(9, astock.S_DIST[pnoin._d_id]);
+	order_line_row_t::set_OL_DIST_INFO(prol, astock.S_DIST[pnoin._d_id]);
 	TRACE( TRACE_TRX_FLOW, "App: %d NO:ol-add-tuple (%d) (%d) (%d) (%d)\n", 
 	       xct_id, pnoin._wh_id, pnoin._d_id,
 	       adist.D_NEXT_O_ID, item_cnt+1);
@@ -916,15 +938,15 @@ w_rc_t ShoreTPCCEnv::xct_new_order(const int xct_id,
      * VALUES (o_id, o_d_id, o_w_id, o_c_id, o_entry_d, o_ol_cnt, o_all_local)
      */
 
-    // 5. insert row to orders and new_order
-    prord->set_value(0, adist.D_NEXT_O_ID);
-    prord->set_value(1, pnoin._c_id);
-    prord->set_value(2, pnoin._d_id);
-    prord->set_value(3, pnoin._wh_id);
-    prord->set_value(4, pnoin._tstamp);
-    prord->set_value(5, 0);
-    prord->set_value(6, pnoin._ol_cnt);
-    prord->set_value(7, pnoin._all_local);
+    // 6. insert row to orders and new_order
+    order_row_t::set_O_ID(prord, adist.D_NEXT_O_ID);
+    order_row_t::set_O_C_ID(prord, pnoin._c_id);
+    order_row_t::set_O_D_ID(prord, pnoin._d_id);
+    order_row_t::set_O_W_ID(prord, pnoin._wh_id);
+    order_row_t::set_O_ENTRY_D(prord, pnoin._tstamp);
+    order_row_t::set_O_CARRIER_ID(prord, 0);
+    order_row_t::set_O_OL_CNT(prord, pnoin._ol_cnt);
+    order_row_t::set_O_ALL_LOCAL(prord, pnoin._all_local);
     TRACE( TRACE_TRX_FLOW, "App: %d NO:ord-add-tuple (%d)\n", 
 	   xct_id, adist.D_NEXT_O_ID);
     W_DO(_porder_man->add_tuple(_pssm, prord));
@@ -932,9 +954,9 @@ w_rc_t ShoreTPCCEnv::xct_new_order(const int xct_id,
     
     /* INSERT INTO new_order VALUES (o_id, d_id, w_id) */
     
-    prno->set_value(0, adist.D_NEXT_O_ID);
-    prno->set_value(1, pnoin._d_id);
-    prno->set_value(2, pnoin._wh_id);
+    new_order_row_t::set_NO_O_ID(prno, adist.D_NEXT_O_ID);
+    new_order_row_t::set_NO_D_ID(prno, pnoin._d_id);
+    new_order_row_t::set_NO_W_ID(prno, pnoin._wh_id);
     TRACE( TRACE_TRX_FLOW, "App: %d NO:nord-add-tuple (%d) (%d) (%d)\n", 
 	   xct_id, pnoin._wh_id, pnoin._d_id, adist.D_NEXT_O_ID);
     W_DO(_pnew_order_man->add_tuple(_pssm, prno));
@@ -947,8 +969,8 @@ w_rc_t ShoreTPCCEnv::xct_new_order(const int xct_id,
     prcust->print_tuple();
     prno->print_tuple();
     prord->print_tuple();
-    pritem->print_tuple();
-    prst->print_tuple();
+    pritems[0]->print_tuple();
+    prsts[0]->print_tuple();
     prol->print_tuple();
 #endif
 
@@ -1049,7 +1071,7 @@ w_rc_t ShoreTPCCEnv::xct_payment(const int xct_id,
 	while (!eof) {
 	    // push the retrieved customer id to the vector
 	    ++count;
-	    prcust->get_value(0, a_c_id);
+	    a_c_id = customer_row_t::get_C_ID(prcust);
 	    v_c_id.push_back(a_c_id);
 	    TRACE( TRACE_TRX_FLOW, "App: %d PAY:cust-iter-next (%d)\n", 
 		   xct_id, a_c_id);
@@ -1083,25 +1105,25 @@ w_rc_t ShoreTPCCEnv::xct_payment(const int xct_id,
     tpcc_customer_tuple acust;
     
     // retrieve customer
-    prcust->get_value(3,  acust.C_FIRST, 17);
-    prcust->get_value(4,  acust.C_MIDDLE, 3);
-    prcust->get_value(5,  acust.C_LAST, 17);
-    prcust->get_value(6,  acust.C_STREET_1, 21);
-    prcust->get_value(7,  acust.C_STREET_2, 21);
-    prcust->get_value(8,  acust.C_CITY, 21);
-    prcust->get_value(9,  acust.C_STATE, 3);
-    prcust->get_value(10, acust.C_ZIP, 10);
-    prcust->get_value(11, acust.C_PHONE, 17);
-    prcust->get_value(12, acust.C_SINCE);
-    prcust->get_value(13, acust.C_CREDIT, 3);
-    prcust->get_value(14, acust.C_CREDIT_LIM);
-    prcust->get_value(15, acust.C_DISCOUNT);
-    prcust->get_value(16, acust.C_BALANCE);
-    prcust->get_value(17, acust.C_YTD_PAYMENT);
-    prcust->get_value(18, acust.C_LAST_PAYMENT);
-    prcust->get_value(19, acust.C_PAYMENT_CNT);
-    prcust->get_value(20, acust.C_DATA_1, 251);
-    prcust->get_value(21, acust.C_DATA_2, 251);
+    customer_row_t::get_C_FIRST(prcust, acust.C_FIRST);
+    customer_row_t::get_C_MIDDLE(prcust, acust.C_MIDDLE);
+    customer_row_t::get_C_LAST(prcust, acust.C_LAST);
+    customer_row_t::get_C_STREET1(prcust, acust.C_STREET_1);
+    customer_row_t::get_C_STREET2(prcust, acust.C_STREET_2);
+    customer_row_t::get_C_CITY(prcust, acust.C_CITY);
+    customer_row_t::get_C_STATE(prcust, acust.C_STATE);
+    customer_row_t::get_C_ZIP(prcust, acust.C_ZIP);
+    customer_row_t::get_C_PHONE(prcust, acust.C_PHONE);
+    acust.C_SINCE = customer_row_t::get_C_SINCE(prcust);
+    customer_row_t::get_C_CREDIT(prcust, acust.C_CREDIT);
+    acust.C_CREDIT_LIM = customer_row_t::get_C_CREDIT_LIM(prcust);
+    acust.C_DISCOUNT = customer_row_t::get_C_DISCOUNT(prcust);
+    acust.C_BALANCE = customer_row_t::get_C_BALANCE(prcust);
+    acust.C_YTD_PAYMENT = customer_row_t::get_C_YTD_PAYMENT(prcust);
+    acust.C_LAST_PAYMENT = customer_row_t::get_C_LAST_PAYMENT(prcust);
+    acust.C_PAYMENT_CNT = customer_row_t::get_C_PAYMENT_CNT(prcust);
+    customer_row_t::get_C_DATA_1(prcust, acust.C_DATA_1);
+    customer_row_t::get_C_DATA_2(prcust, acust.C_DATA_2);
     
     // update customer fields
     acust.C_BALANCE -= ppin._h_amount;
@@ -1157,12 +1179,12 @@ w_rc_t ShoreTPCCEnv::xct_payment(const int xct_id,
     W_DO(_pdistrict_man->dist_update_ytd(_pssm, prdist, ppin._h_amount));
 
     tpcc_district_tuple adistr;
-    prdist->get_value(2, adistr.D_NAME, 11);
-    prdist->get_value(3, adistr.D_STREET_1, 21);
-    prdist->get_value(4, adistr.D_STREET_2, 21);
-    prdist->get_value(5, adistr.D_CITY, 21);
-    prdist->get_value(6, adistr.D_STATE, 3);
-    prdist->get_value(7, adistr.D_ZIP, 10);
+    district_row_t::get_D_NAME(prdist, adistr.D_NAME);
+    district_row_t::get_D_STREET1(prdist, adistr.D_STREET_1);
+    district_row_t::get_D_STREET2(prdist, adistr.D_STREET_2);
+    district_row_t::get_D_CITY(prdist, adistr.D_CITY);
+    district_row_t::get_D_STATE(prdist, adistr.D_STATE);
+    district_row_t::get_D_ZIP(prdist, adistr.D_ZIP);
     
     
     /* UPDATE warehouse SET w_ytd = wytd + :h_amount
@@ -1180,12 +1202,12 @@ w_rc_t ShoreTPCCEnv::xct_payment(const int xct_id,
     W_DO(_pwarehouse_man->wh_update_ytd(_pssm, prwh, ppin._h_amount));
 
     tpcc_warehouse_tuple awh;
-    prwh->get_value(1, awh.W_NAME, 11);
-    prwh->get_value(2, awh.W_STREET_1, 21);
-    prwh->get_value(3, awh.W_STREET_2, 21);
-    prwh->get_value(4, awh.W_CITY, 21);
-    prwh->get_value(5, awh.W_STATE, 3);
-    prwh->get_value(6, awh.W_ZIP, 10);
+    warehouse_row_t::get_W_NAME(prwh, awh.W_NAME);
+    warehouse_row_t::get_W_STREET1(prwh, awh.W_STREET_1);
+    warehouse_row_t::get_W_STREET2(prwh, awh.W_STREET_2);
+    warehouse_row_t::get_W_CITY(prwh, awh.W_CITY);
+    warehouse_row_t::get_W_STATE(prwh, awh.W_STATE);
+    warehouse_row_t::get_W_ZIP(prwh, awh.W_ZIP);
     
     
     /* INSERT INTO history
@@ -1197,14 +1219,14 @@ w_rc_t ShoreTPCCEnv::xct_payment(const int xct_id,
     sprintf(ahist.H_DATA, "%s   %s", awh.W_NAME, adistr.D_NAME);
     ahist.H_DATE = time(NULL);
     
-    prhist->set_value(0, ppin._c_id);
-    prhist->set_value(1, c_d);
-    prhist->set_value(2, c_w);
-    prhist->set_value(3, ppin._home_d_id);
-    prhist->set_value(4, ppin._home_wh_id);
-    prhist->set_value(5, ahist.H_DATE);
-    prhist->set_value(6, ppin._h_amount * 100.0);
-    prhist->set_value(7, ahist.H_DATA);
+    history_row_t::set_H_C_ID(prhist, ppin._c_id);
+    history_row_t::set_H_C_D_ID(prhist, c_d);
+    history_row_t::set_H_C_W_ID(prhist, c_w);
+    history_row_t::set_H_D_ID(prhist, ppin._home_d_id);
+    history_row_t::set_H_W_ID(prhist, ppin._home_wh_id);
+    history_row_t::set_H_DATE(prhist, ahist.H_DATE);
+    history_row_t::set_H_AMOUNT(prhist, ppin._h_amount * 100.0);
+    history_row_t::set_H_DATA(prhist, ahist.H_DATA);
     
     TRACE( TRACE_TRX_FLOW, "App: %d PAY:hist-add-tuple\n", xct_id);
     W_DO(_phistory_man->add_tuple(_pssm, prhist));
@@ -1307,7 +1329,7 @@ w_rc_t ShoreTPCCEnv::xct_order_status(const int xct_id,
 	while (!eof) {
 	    // push the retrieved customer id to the vector
 	    ++count;
-	    prcust->get_value(0, id);            
+	    id = customer_row_t::get_C_ID(prcust);            
 	    c_id_list.push_back(id);
 	    TRACE( TRACE_TRX_FLOW, "App: %d ORDST:cust-iter-next\n", xct_id);
 	    W_DO(c_iter->next(_pssm, eof, *prcust));
@@ -1334,10 +1356,10 @@ w_rc_t ShoreTPCCEnv::xct_order_status(const int xct_id,
 					  w_id, d_id, pstin._c_id));
     
     tpcc_customer_tuple acust;
-    prcust->get_value(3,  acust.C_FIRST, 17);
-    prcust->get_value(4,  acust.C_MIDDLE, 3);
-    prcust->get_value(5,  acust.C_LAST, 17);
-    prcust->get_value(16, acust.C_BALANCE);
+    customer_row_t::get_C_FIRST(prcust, acust.C_FIRST);
+    customer_row_t::get_C_MIDDLE(prcust, acust.C_MIDDLE);
+    customer_row_t::get_C_LAST(prcust, acust.C_LAST);
+    acust.C_BALANCE = customer_row_t::get_C_BALANCE(prcust);
     
     // 2. retrieve the last order of this customer
     
@@ -1364,10 +1386,10 @@ w_rc_t ShoreTPCCEnv::xct_order_status(const int xct_id,
     
     W_DO(o_iter->next(_pssm, eof, *prord));
     while (!eof) {
-	prord->get_value(0, aorder.O_ID);
-	prord->get_value(4, aorder.O_ENTRY_D);
-	prord->get_value(5, aorder.O_CARRIER_ID);
-	prord->get_value(6, aorder.O_OL_CNT);
+	aorder.O_ID = order_row_t::get_O_ID(prord);
+	aorder.O_ENTRY_D = order_row_t::get_O_ENTRY_D(prord);
+	aorder.O_CARRIER_ID = order_row_t::get_O_CARRIER_ID(prord);
+	aorder.O_OL_CNT = order_row_t::get_O_OL_CNT(prord);
 	W_DO(o_iter->next(_pssm, eof, *prord));
     }
     
@@ -1400,11 +1422,11 @@ w_rc_t ShoreTPCCEnv::xct_order_status(const int xct_id,
     
     W_DO(ol_iter->next(_pssm, eof, *prol));
     while (!eof) {
-	prol->get_value(4, porderlines[i].OL_I_ID);
-	prol->get_value(5, porderlines[i].OL_SUPPLY_W_ID);
-	prol->get_value(6, porderlines[i].OL_DELIVERY_D);
-	prol->get_value(7, porderlines[i].OL_QUANTITY);
-	prol->get_value(8, porderlines[i].OL_AMOUNT);
+	porderlines[i].OL_I_ID = order_line_row_t::get_OL_I_ID(prol);
+	porderlines[i].OL_SUPPLY_W_ID = order_line_row_t::get_OL_SUPPLY_W_ID(prol);
+	porderlines[i].OL_DELIVERY_D = order_line_row_t::get_OL_DELIVERY_D(prol);
+	porderlines[i].OL_QUANTITY = order_line_row_t::get_OL_QUANTITY(prol);
+	porderlines[i].OL_AMOUNT = order_line_row_t::get_OL_AMOUNT(prol);
 	i++;
 	W_DO(ol_iter->next(_pssm, eof, *prol));
     }
@@ -1535,7 +1557,7 @@ w_rc_t ShoreTPCCEnv::_xct_delivery_helper(const int xct_id,
 	if (eof) continue; // skip this district
 	
 	int no_o_id;
-	prno->get_value(0, no_o_id);
+	no_o_id = new_order_row_t::get_NO_O_ID(prno);
 	assert (no_o_id);
 	
 	// 2. Delete the retrieved new order
@@ -1565,14 +1587,14 @@ w_rc_t ShoreTPCCEnv::_xct_delivery_helper(const int xct_id,
 	TRACE( TRACE_TRX_FLOW,
 	       "App: %d DEL:ord-idx-probe-upd (%d) (%d) (%d)\n", 
 	       xct_id, w_id, d_id, no_o_id);	
-	prord->set_value(0, no_o_id);
-	prord->set_value(2, d_id);
-	prord->set_value(3, w_id);
+	order_row_t::set_O_ID(prord, no_o_id);
+	order_row_t::set_O_D_ID(prord, d_id);
+	order_row_t::set_O_W_ID(prord, w_id);
 	W_DO(_porder_man->ord_update_carrier_by_index(_pssm, prord,
 						      carrier_id));
 
 	int  c_id;
-	prord->get_value(1, c_id);
+	c_id = order_row_t::get_O_C_ID(prord);
 	
 	// 4a. Calculate the total amount of the orders from orderlines
 	// 4b. Update all the orderlines with the current timestamp
@@ -1606,10 +1628,10 @@ w_rc_t ShoreTPCCEnv::_xct_delivery_helper(const int xct_id,
 	while (!eof) {
 	    // update the total amount
 	    int current_amount;
-	    prol->get_value(8, current_amount);
+	    current_amount = order_line_row_t::get_OL_AMOUNT(prol);
 	    total_amount += current_amount;
 	    // update orderline
-	    prol->set_value(6, ts_start);
+	    order_line_row_t::set_OL_DELIVERY_D(prol, ts_start);
 	    W_DO(_porder_line_man->update_tuple(_pssm, prol));
 	    // go to the next orderline
 	    W_DO(ol_iter->next(_pssm, eof, *prol));
@@ -1631,8 +1653,8 @@ w_rc_t ShoreTPCCEnv::_xct_delivery_helper(const int xct_id,
 							w_id, d_id, c_id));
 	
 	double   balance;
-	prcust->get_value(16, balance);
-	prcust->set_value(16, balance+total_amount);
+	balance = customer_row_t::get_C_BALANCE(prcust);
+	customer_row_t::set_C_BALANCE(prcust, balance+total_amount);
 	W_DO(_pcustomer_man->update_tuple(_pssm, prcust));
 	
 	if(SPLIT_TRX && dlist.size()) {
@@ -1680,7 +1702,6 @@ w_rc_t ShoreTPCCEnv::xct_stock_level(const int xct_id,
 
     tuple_guard<district_man_impl> prdist(_pdistrict_man);
     tuple_guard<order_line_man_impl> prol(_porder_line_man);
-    tuple_guard<stock_man_impl> prst(_pstock_man);
 
     rep_row_t areprow(_pdistrict_man->ts());
 
@@ -1689,7 +1710,6 @@ w_rc_t ShoreTPCCEnv::xct_stock_level(const int xct_id,
 
     prdist->_rep = &areprow;
     prol->_rep = &areprow;
-    prst->_rep = &areprow;
 
     // 1. get next_o_id from the district
     
@@ -1706,7 +1726,7 @@ w_rc_t ShoreTPCCEnv::xct_stock_level(const int xct_id,
 					  pslin._wh_id, pslin._d_id));
 
     int next_o_id = 0;
-    prdist->get_value(10, next_o_id);
+    next_o_id = district_row_t::get_D_NEXT_O_ID(prdist);
 
     
     /*
@@ -1766,10 +1786,10 @@ w_rc_t ShoreTPCCEnv::xct_stock_level(const int xct_id,
     while (!eof) {
 	int temp_oid, temp_iid;
 	int temp_wid, temp_did;        
-	prol->get_value(4, temp_iid);
-	prol->get_value(0, temp_oid);
-	prol->get_value(2, temp_wid);
-	prol->get_value(1, temp_did);
+	temp_iid = order_line_row_t::get_OL_I_ID(prol);
+	temp_oid = order_line_row_t::get_OL_O_ID(prol);
+	temp_wid = order_line_row_t::get_OL_W_ID(prol);
+	temp_did = order_line_row_t::get_OL_D_ID(prol);
 	rsb.set_value(0, temp_iid);
 	rsb.set_value(1, temp_wid);
 	rsb.set_value(2, temp_did);
@@ -1784,37 +1804,52 @@ w_rc_t ShoreTPCCEnv::xct_stock_level(const int xct_id,
     int last_i_id = -1;
     int count = 0;
 
+    // the stock is probed for a batch of distinct items at a time
+    const int SL_PROBE_BATCH = 32;
+    int i_ids[SL_PROBE_BATCH];
+    int w_ids[SL_PROBE_BATCH];
+    int nprobes = 0;
+    tuple_batch_guard<stock_man_impl> prsts(_pstock_man, SL_PROBE_BATCH);
+    prsts.set_rep(&areprow);
+
     // 2c. Nested loop join order_line with stock
     W_DO(ol_list_sort_iter.next(_pssm, eof, rsb));
-    while (!eof) {
-	// use the index to find the corresponding stock tuple
-	int i_id;
-	int w_id;
-	rsb.get_value(0, i_id);
-	rsb.get_value(1, w_id);
-
-	// 2d. Index probe the Stock
-	W_DO(_pstock_man->st_index_probe(_pssm, prst, w_id, i_id));
-
-	// check if stock quantity below threshold 
-	int quantity;
-	prst->get_value(3, quantity);
-	if (quantity < pslin._threshold) {
-	    // Do join on the two tuples	    
-	    /* the work is to count the number of unique item id. We keep
-	     * two pieces of information here: the last item id and the
-	     * current count.  This is enough because the item id is in
-	     * increasing order.
+    while (!eof || nprobes) {
+	if (!eof) {
+	    int i_id;
+	    int w_id;
+	    rsb.get_value(0, i_id);
+	    rsb.get_value(1, w_id);
+
+	    /* the work is to count the number of unique item id. The item
+	     * id is in increasing order, so keeping the last one is enough
+	     * to probe each item once.
 	     */
 	    if (last_i_id != i_id) {
 		last_i_id = i_id;
-		count++;
-	    }            
-	    TRACE( TRACE_TRX_FLOW, "App: %d STO:found-one (%d) (%d) (%d)\n", 
-		   xct_id, count, i_id, quantity);
-	    
+		i_ids[nprobes] = i_id;
+		w_ids[nprobes] = w_id;
+		nprobes++;
+	    }
+	    W_DO(ol_list_sort_iter.next(_pssm, eof, rsb));
+	}
+
+	if ((nprobes == SL_PROBE_BATCH) || (eof && nprobes)) {
+	    // 2d. Index probe the Stock
+	    W_DO(_pstock_man->st_index_probe_batch(_pssm, prsts, w_ids,
+						   i_ids, nprobes));
+
+	    // check if stock quantity below threshold 
+	    for (int i=0; i<nprobes; i++) {
+		int quantity = stock_row_t::get_S_QUANTITY(prsts[i]);
+		if (quantity < pslin._threshold) {
+		    count++;
+		    TRACE( TRACE_TRX_FLOW, "App: %d STO:found-one (%d) (%d) (%d)\n", 
+			   xct_id, count, i_ids[i], quantity);
+		}
+	    }
+	    nprobes = 0;
 	}
-	W_DO(ol_list_sort_iter.next(_pssm, eof, rsb));
     }
     
 #ifdef PRINT_TRX_RESULTS
@@ -1886,12 +1921,12 @@ w_rc_t ShoreTPCCEnv::xct_mbench_wh(const int xct_id,
     W_DO(_pwarehouse_man->wh_update_ytd(_pssm, prwh, mbin._amount));
 
     tpcc_warehouse_tuple awh;
-    prwh->get_value(1, awh.W_NAME, 11);
-    prwh->get_value(2, awh.W_STREET_1, 21);
-    prwh->get_value(3, awh.W_STREET_2, 21);
-    prwh->get_value(4, awh.W_CITY, 21);
-    prwh->get_value(5, awh.W_STATE, 3);
-    prwh->get_value(6, awh.W_ZIP, 10);
+    warehouse_row_t::get_W_NAME(prwh, awh.W_NAME);
+    warehouse_row_t::get_W_STREET1(prwh, awh.W_STREET_1);
+    warehouse_row_t::get_W_STREET2(prwh, awh.W_STREET_2);
+    warehouse_row_t::get_W_CITY(prwh, awh.W_CITY);
+    warehouse_row_t::get_W_STATE(prwh, awh.W_STATE);
+    warehouse_row_t::get_W_ZIP(prwh, awh.W_ZIP);
 
 #ifdef PRINT_TRX_RESULTS
     // at the end of the transaction 
@@ -1954,25 +1989,25 @@ w_rc_t ShoreTPCCEnv::xct_mbench_cust(const int xct_id,
     tpcc_customer_tuple acust;
     
     // retrieve customer
-    prcust->get_value(3,  acust.C_FIRST, 17);
-    prcust->get_value(4,  acust.C_MIDDLE, 3);
-    prcust->get_value(5,  acust.C_LAST, 17);
-    prcust->get_value(6,  acust.C_STREET_1, 21);
-    prcust->get_value(7,  acust.C_STREET_2, 21);
-    prcust->get_value(8,  acust.C_CITY, 21);
-    prcust->get_value(9,  acust.C_STATE, 3);
-    prcust->get_value(10, acust.C_ZIP, 10);
-    prcust->get_value(11, acust.C_PHONE, 17);
-    prcust->get_value(12, acust.C_SINCE);
-    prcust->get_value(13, acust.C_CREDIT, 3);
-    prcust->get_value(14, acust.C_CREDIT_LIM);
-    prcust->get_value(15, acust.C_DISCOUNT);
-    prcust->get_value(16, acust.C_BALANCE);
-    prcust->get_value(17, acust.C_YTD_PAYMENT);
-    prcust->get_value(18, acust.C_LAST_PAYMENT);
-    prcust->get_value(19, acust.C_PAYMENT_CNT);
-    prcust->get_value(20, acust.C_DATA_1, 251);
-    prcust->get_value(21, acust.C_DATA_2, 251);
+    customer_row_t::get_C_FIRST(prcust, acust.C_FIRST);
+    customer_row_t::get_C_MIDDLE(prcust, acust.C_MIDDLE);
+    customer_row_t::get_C_LAST(prcust, acust.C_LAST);
+    customer_row_t::get_C_STREET1(prcust, acust.C_STREET_1);
+    customer_row_t::get_C_STREET2(prcust, acust.C_STREET_2);
+    customer_row_t::get_C_CITY(prcust, acust.C_CITY);
+    customer_row_t::get_C_STATE(prcust, acust.C_STATE);
+    customer_row_t::get_C_ZIP(prcust, acust.C_ZIP);
+    customer_row_t::get_C_PHONE(prcust, acust.C_PHONE);
+    acust.C_SINCE = customer_row_t::get_C_SINCE(prcust);
+    customer_row_t::get_C_CREDIT(prcust, acust.C_CREDIT);
+    acust.C_CREDIT_LIM = customer_row_t::get_C_CREDIT_LIM(prcust);
+    acust.C_DISCOUNT = customer_row_t::get_C_DISCOUNT(prcust);
+    acust.C_BALANCE = customer_row_t::get_C_BALANCE(prcust);
+    acust.C_YTD_PAYMENT = customer_row_t::get_C_YTD_PAYMENT(prcust);
+    acust.C_LAST_PAYMENT = customer_row_t::get_C_LAST_PAYMENT(prcust);
+    acust.C_PAYMENT_CNT = customer_row_t::get_C_PAYMENT_CNT(prcust);
+    customer_row_t::get_C_DATA_1(prcust, acust.C_DATA_1);
+    customer_row_t::get_C_DATA_2(prcust, acust.C_DATA_2);
     
     // update customer fields
     acust.C_BALANCE -= mcin._amount;
@@ -611,6 +611,29 @@ char argv[20][100];
 	    return 0;
 	}
 
+	// Creates a generator for the customers [iStart, iStart+iCount), with
+	// the settings egen_init() parsed. Simultaneous generators must be
+	// given disjoint ranges aligned to the load unit. The caller owns it.
+	CGenerateAndLoad* egen_range_init(TIdent iStart, TIdent iCount)
+	{
+		assert(inputFiles!=NULL);
+
+		char szLogFileName[64];
+		snprintf(&szLogFileName[0], sizeof(szLogFileName),
+			 "EGenLoaderFrom%lldTo%lld.log",
+			 iStart, (iStart + iCount)-1);
+
+		// The generator keeps the logger, so it cannot live on the stack
+		CLogFormatTab * fmt= new CLogFormatTab();
+		CEGenLogger* log = new CEGenLogger(eDriverEGenLoader, 0, szLogFileName, fmt);
+
+		return (new CGenerateAndLoad(*inputFiles, iCount, iStart,
+					     iTotalCustomerCount, iLoadUnitSize,
+					     iScaleFactor, iDaysOfInitialTrades,
+					     pLoaderFactory, log, Output, szInDir,
+					     bGenerateUsingCache));
+	}
+
 	CCETxnInputGenerator*  transactions_input_init(int customers, int sf, int wdays) 
 	{	
 	//	TDriverCETxnSettings		m_DriverCETxnSettings;
@@ -34,6 +34,8 @@
 
 #include <w_defines.h>
 #include "workload/tpce/egen/CE.h"
+#include "workload/tpce/tpce_const.h"
+#include "util/progress.h"
 #include <stdio.h>
 
 using namespace shore;
@@ -152,47 +154,51 @@ void setRNGSeeds(CCETxnInputGenerator* gen, unsigned int UniqueId )
 }
 
 
-//check the cardinality of all tables to see if it is correctly generated
-void printCardinality()
-{
-   printf("accountPermissionBuffer.getCnt()  %d\n",accountPermissionBuffer.getCnt() );
-   printf("customerAccountBuffer.getCnt()  %d\n",customerAccountBuffer.getCnt() );
-   printf("customerTaxrateBuffer.getCnt()  %d\n",customerTaxrateBuffer.getCnt() );
-   printf("customerBuffer.getCnt()  %d\n",customerBuffer.getCnt() );
-   printf("holdingBuffer.getCnt()  %d\n",holdingBuffer.getCnt() );
-   printf("watchItemBuffer.getCnt()  %d\n",watchItemBuffer.getCnt() );
-   printf("watchListBuffer.getCnt()  %d\n",watchListBuffer.getCnt() );
-   printf("brokerBuffer.getCnt()  %d\n",brokerBuffer.getCnt() );
-   printf("cashTransactionBuffer.getCnt()  %d\n",cashTransactionBuffer.getCnt() );
-   printf("chargeBuffer.getCnt()  %d\n",chargeBuffer.getCnt() );
-   printf("holdingHistoryBuffer.getCnt()  %d\n",holdingHistoryBuffer.getCnt() );
-   printf("holdingSummaryBuffer.getCnt()  %d\n",holdingSummaryBuffer.getCnt() );
-   printf("commissionRateBuffer.getCnt()  %d\n",commissionRateBuffer.getCnt() );
-   printf("companyBuffer.getCnt()  %d\n",companyBuffer.getCnt() );
-   printf("companyCompetitorBuffer.getCnt()  %d\n",companyCompetitorBuffer.getCnt() );
-   printf("dailyMarketBuffer.getCnt()  %d\n",dailyMarketBuffer.getCnt() );
-  
+//check the cardinality of all tables to see if it is correctly generated,
+//summing the rows each loader generated
+#define PRINT_LOADED_CNT(buf)                                    \
+    do { long cnt = 0;                                          \
+        for (int i=0; i<nctxs; i++) cnt += ctxs[i]->buf.getCnt(); \
+        printf(#buf ".getCnt()  %ld\n", cnt); } while(0)
 
-   printf("settlementBuffer.getCnt()  %d\n",settlementBuffer.getCnt() );
-   printf("tradeBuffer.getCnt()  %d\n",tradeBuffer.getCnt() );
-   printf("tradeHistoryBuffer.getCnt()  %d\n",tradeHistoryBuffer.getCnt() );
-   printf("tradeTypeBuffer.getCnt()  %d\n",tradeTypeBuffer.getCnt() );
-
-
-   printf("exchangeBuffer.getCnt()  %d\n",exchangeBuffer.getCnt() );
-   printf("financialBuffer.getCnt()  %d\n",financialBuffer.getCnt() );
-   printf("industryBuffer.getCnt()  %d\n",industryBuffer.getCnt() );
-   printf("newsItemBuffer.getCnt()  %d\n",newsItemBuffer.getCnt() );
-   printf("lastTradeBuffer.getCnt()  %d\n",lastTradeBuffer.getCnt() );
-   printf("newsXRefBuffer.getCnt()  %d\n",newsXRefBuffer.getCnt() );
-   printf("sectorBuffer.getCnt()  %d\n",sectorBuffer.getCnt() );
-   printf("securityBuffer.getCnt()  %d\n",securityBuffer.getCnt() );
-   printf("addressBuffer.getCnt()  %d\n",addressBuffer.getCnt() );
-   printf("statusTypeBuffer.getCnt()  %d\n",statusTypeBuffer.getCnt() );
-   printf("taxrateBuffer.getCnt()  %d\n",taxrateBuffer.getCnt() );
-   printf("zipCodeBuffer.getCnt()  %d\n",zipCodeBuffer.getCnt() );
+void printCardinality(egen_load_ctx_t** ctxs, const int nctxs)
+{
+   PRINT_LOADED_CNT(accountPermissionBuffer);
+   PRINT_LOADED_CNT(customerAccountBuffer);
+   PRINT_LOADED_CNT(customerTaxrateBuffer);
+   PRINT_LOADED_CNT(customerBuffer);
+   PRINT_LOADED_CNT(holdingBuffer);
+   PRINT_LOADED_CNT(watchItemBuffer);
+   PRINT_LOADED_CNT(watchListBuffer);
+   PRINT_LOADED_CNT(brokerBuffer);
+   PRINT_LOADED_CNT(cashTransactionBuffer);
+   PRINT_LOADED_CNT(chargeBuffer);
+   PRINT_LOADED_CNT(holdingHistoryBuffer);
+   PRINT_LOADED_CNT(holdingSummaryBuffer);
+   PRINT_LOADED_CNT(commissionRateBuffer);
+   PRINT_LOADED_CNT(companyBuffer);
+   PRINT_LOADED_CNT(companyCompetitorBuffer);
+   PRINT_LOADED_CNT(dailyMarketBuffer);
+   PRINT_LOADED_CNT(settlementBuffer);
+   PRINT_LOADED_CNT(tradeBuffer);
+   PRINT_LOADED_CNT(tradeHistoryBuffer);
+   PRINT_LOADED_CNT(tradeTypeBuffer);
+   PRINT_LOADED_CNT(exchangeBuffer);
+   PRINT_LOADED_CNT(financialBuffer);
+   PRINT_LOADED_CNT(industryBuffer);
+   PRINT_LOADED_CNT(newsItemBuffer);
+   PRINT_LOADED_CNT(lastTradeBuffer);
+   PRINT_LOADED_CNT(newsXRefBuffer);
+   PRINT_LOADED_CNT(sectorBuffer);
+   PRINT_LOADED_CNT(securityBuffer);
+   PRINT_LOADED_CNT(addressBuffer);
+   PRINT_LOADED_CNT(statusTypeBuffer);
+   PRINT_LOADED_CNT(taxrateBuffer);
+   PRINT_LOADED_CNT(zipCodeBuffer);
 }
 
+#undef PRINT_LOADED_CNT
+
 
 void testInputs()
 {
@@ -244,7 +250,7 @@ void testInputs()
 
 /** Construction  */
 ShoreTPCEEnv::ShoreTPCEEnv():
-    ShoreEnv(), _num_invalid_input(0)
+    ShoreEnv(), _use_ref_caches(false), _num_invalid_input(0)
 {
     // read the scaling factor from the configuration file
     
@@ -347,6 +353,14 @@ w_rc_t ShoreTPCEEnv::load_schema()
     _ptaxrate_desc  = new taxrate_t(get_pd());
     _pzip_code_desc  = new zip_code_t(get_pd());
 
+    // the trades, their history and settlements are appended by each
+    // worker to its own part
+    if (get_pd() & PD_HEAP_PART) {
+        _ptrade_desc->set_heap_parts(heap_parts());
+        _ptrade_history_desc->set_heap_parts(heap_parts());
+        _psettlement_desc->set_heap_parts(heap_parts());
+    }
+
 
     //     initiate the table managers
     _paccount_permission_man   = new account_permission_man_impl(_paccount_permission_desc.get());
@@ -521,6 +535,18 @@ int ShoreTPCEEnv::statistics()
 	  rval.failed.trade_cleanup,
 	  rval.deadlocked.trade_cleanup);
    
+   if (_use_ref_caches) {
+       _psector_man->cache()->print_stats();
+       _pcharge_man->cache()->print_stats();
+       _pcommission_rate_man->cache()->print_stats();
+       _pexchange_man->cache()->print_stats();
+       _pindustry_man->cache()->print_stats();
+       _pstatus_type_man->cache()->print_stats();
+       _ptaxrate_man->cache()->print_stats();
+       _ptrade_type_man->cache()->print_stats();
+       _pzip_code_man->cache()->print_stats();
+   }
+
    ShoreEnv::statistics();
    
    return (0);
@@ -602,19 +628,26 @@ struct ShoreTPCEEnv::checkpointer_t : public thread_t {
 
 /****************************************************************** 
  *
- * @struct: table_creator_t
+ * @class: table_builder_t
  *
- * @brief:  Helper class for creating the environment tables and
- *          loading a number of records in a single-threaded fashion
+ * @brief:  Helper class for loading one phase of the environment
+ *          tables. The fixed tables are loaded by a single builder,
+ *          while the scaling and growing tables are loaded by one
+ *          builder per disjoint range of customers.
  *
  ******************************************************************/
 
 class ShoreTPCEEnv::table_builder_t : public thread_t {
+public:
+    enum load_phase_t { LP_FIXED, LP_SCALING, LP_GROWING };
+private:
     ShoreTPCEEnv* _env;
-    int my_load_unit;
+    egen_load_ctx_t* _ctx;
+    load_phase_t _phase;
 public:
-    table_builder_t(ShoreTPCEEnv* env)
-	: thread_t("TPC-E loader"), _env(env) { }
+    table_builder_t(ShoreTPCEEnv* env, const int id, 
+                    egen_load_ctx_t* ctx, load_phase_t phase)
+	: thread_t(c_str("LD-%d",id)), _env(env), _ctx(ctx), _phase(phase) { }
     virtual void work();
 };
 
@@ -622,55 +655,69 @@ void ShoreTPCEEnv::table_builder_t::work()
 {
     w_rc_t e = RCOK;
 
-    //populating fixed
-    populate_small_input_t in;
-    long log_space_needed = 0;
-    _env->read_small();
- retry:
-    W_COERCE(_env->db()->begin_xct());
+    // All the populate functions generate through the loader context
+    my_egen = _ctx;
+    progress_reset(&_ctx->progress);
+
+    switch (_phase) {
+    case LP_FIXED: {
+        //populating fixed
+        populate_small_input_t in;
+        long log_space_needed = 0;
+        _env->read_small();
+    retry:
+        W_COERCE(_env->db()->begin_xct());
+
+        if(log_space_needed > 0) {
+            W_COERCE(_env->db()->xct_reserve_log_space(log_space_needed));
+        }
 
-    if(log_space_needed > 0) {
-        W_COERCE(_env->db()->xct_reserve_log_space(log_space_needed));
+        e = _env->xct_populate_small(1, in);    
+        CHECK_XCT_RETURN(e,log_space_needed,retry,_env);
+        _env->release_small();
+        progress_done("fixed tables");
+        break;
     }
 
-    e = _env->xct_populate_small(1, in);    
-    CHECK_XCT_RETURN(e,log_space_needed,retry,_env);
-    _env->release_small();
-
-    //populating scaling tables
-    _env->populate_address(); 
-    _env->populate_customer();
-    _env->populate_ca_and_ap();
-    _env->populate_customer_taxrate();
-    _env->populate_wl_and_wi(); 
-
-    _env->populate_company(); 
-    _env->populate_company_competitor();
-    _env->populate_daily_market();
-    _env->populate_financial();
-    _env->populate_last_trade();
-    _env-> populate_ni_and_nx();
-    _env->populate_security();
-
-    //populate growing tables
-    _env-> populate_growing();
-    printCardinality();
-#ifdef COMPILE_FLAT_FILE_LOAD 
-    fclose(fshs);
-    fclose(fssec);
-#endif
-    //  testInputs();
-    _env->find_maxtrade_id();
+    case LP_SCALING:
+        //populating scaling tables
+        _env->populate_address(); 
+        _env->populate_customer();
+        _env->populate_ca_and_ap();
+        _env->populate_customer_taxrate();
+        _env->populate_wl_and_wi(); 
+
+        _env->populate_company(); 
+        _env->populate_company_competitor();
+        _env->populate_daily_market();
+        _env->populate_financial();
+        _env->populate_last_trade();
+        _env->populate_ni_and_nx();
+        _env->populate_security();
+        progress_done(c_str("scaling tables of customers %lld..%lld",
+                            (long long)_ctx->start, 
+                            (long long)(_ctx->start + _ctx->count - 1)));
+        break;
+
+    case LP_GROWING:
+        //populate growing tables
+        _env->populate_growing();
+        progress_done(c_str("growing tables of customers %lld..%lld",
+                            (long long)_ctx->start, 
+                            (long long)(_ctx->start + _ctx->count - 1)));
+        break;
+    }
 
+    my_egen = NULL;
 }
 
 
 
 /****************************************************************** 
  *
- * @class: table_builder_t
+ * @struct: table_creator_t
  *
- * @brief:  Helper class for loading the environment tables
+ * @brief:  Helper class for creating the environment tables
  *
  ******************************************************************/
 
@@ -792,25 +839,99 @@ w_rc_t ShoreTPCEEnv::loaddata()
 	tc->fork();
 	tc->join();
     }
+
+    // The creator does not register the tables, which the bulk-loading
+    // needs. If enabled, the loader only collects the index entries.
+    if (envVar::instance()->getVarInt("db-bulkload",0)) {
+        W_DO(load_and_register_fids());
+        start_bulkload();
+    }
+
     // 3. Fire up a checkpointer 
     guard<checkpointer_t> chk(new checkpointer_t(this));
     chk->fork();
  
 
-    // 4. Fire up the loaders
-    TRACE( TRACE_ALWAYS, "Firing up %d loaders ..\n", 1);
+    // 4. Split the customers among the loaders. EGen generates the
+    //    scaling and growing tables by load units of customers, so each
+    //    loader gets a disjoint range of whole load units.
+    int loaders_to_use = envVar::instance()->getVarInt("db-loaders",10);
+#ifdef COMPILE_FLAT_FILE_LOAD 
+    // The flat-file output of EGen is not safe for concurrent generators
+    loaders_to_use = 1;
+#endif
+    long total_units = _customers / TPCE_CUSTS_PER_LU;
+    if (loaders_to_use > total_units) loaders_to_use = total_units;
+    if (loaders_to_use < 1) loaders_to_use = 1;
+    long units_per_loader = (total_units + loaders_to_use - 1) / loaders_to_use;
+    loaders_to_use = (total_units + units_per_loader - 1) / units_per_loader;
+
+    // The fixed tables are generated by the global generator, the
+    // customer ranges by one generator each
+    array_guard_t< guard<egen_load_ctx_t> > ctxs(new guard<egen_load_ctx_t>[loaders_to_use+1]);
+    array_guard_t< guard<CGenerateAndLoad> > gens(new guard<CGenerateAndLoad>[loaders_to_use]);
+    ctxs[loaders_to_use] = new egen_load_ctx_t(pGenerateAndLoad, iDefaultStartFromCustomer, _customers);
+    for(int i=0; i < loaders_to_use; i++) {
+        long start = i*units_per_loader;
+        long count = (start+units_per_loader > total_units)? total_units-start : units_per_loader;
+        TIdent first = iDefaultStartFromCustomer + start*TPCE_CUSTS_PER_LU;
+        gens[i] = egen_range_init(first, count*TPCE_CUSTS_PER_LU);
+        ctxs[i] = new egen_load_ctx_t(gens[i], first, count*TPCE_CUSTS_PER_LU);
+    }
+
+    // 5. First phase: the fixed tables in parallel with the scaling
+    //    tables of each customer range
+    TRACE( TRACE_ALWAYS, "Firing up %d loaders for the fixed and scaling tables ..\n",
+           loaders_to_use+1);
     {
-      guard<table_builder_t>loader = new table_builder_t(this);
-      // array_guard_t< guard<table_builder_t> > loaders(new guard<table_builder_t>[loaders_to_use]);
-      loader->fork();
-      loader->join();
-    }  
+        array_guard_t< guard<table_builder_t> > loaders(new guard<table_builder_t>[loaders_to_use+1]);
+        loaders[loaders_to_use] = new table_builder_t(this, loaders_to_use, ctxs[loaders_to_use],
+                                                      table_builder_t::LP_FIXED);
+        loaders[loaders_to_use]->fork();
+        for(int i=0; i < loaders_to_use; i++) {
+            loaders[i] = new table_builder_t(this, i, ctxs[i], table_builder_t::LP_SCALING);
+            loaders[i]->fork();
+        }
+        for(int i=0; i <= loaders_to_use; i++) {
+            loaders[i]->join();
+        }
+    }
+
+    // 6. Second phase: the growing (trade) tables of each customer range
+    TRACE( TRACE_ALWAYS, "Firing up %d loaders for the growing tables ..\n",
+           loaders_to_use);
+    {
+        array_guard_t< guard<table_builder_t> > loaders(new guard<table_builder_t>[loaders_to_use]);
+        for(int i=0; i < loaders_to_use; i++) {
+            loaders[i] = new table_builder_t(this, i, ctxs[i], table_builder_t::LP_GROWING);
+            loaders[i]->fork();
+        }
+        for(int i=0; i < loaders_to_use; i++) {
+            loaders[i]->join();
+        }
+    }
 
-    // 5. Print stats
+    {
+        array_guard_t<egen_load_ctx_t*> pctxs(new egen_load_ctx_t*[loaders_to_use+1]);
+        for(int i=0; i <= loaders_to_use; i++) pctxs[i] = ctxs[i];
+        printCardinality(pctxs, loaders_to_use+1);
+    }
+#ifdef COMPILE_FLAT_FILE_LOAD 
+    fclose(fshs);
+    fclose(fssec);
+#endif
+    //  testInputs();
+
+    // If bulk-loading, build the indexes before probing them
+    W_COERCE(finish_bulkload(envVar::instance()->getVarInt("db-loaders",10)));
+    find_maxtrade_id();
+    build_ref_caches();
+
+    // 7. Print stats
     time_t tstop = time(NULL);
     TRACE( TRACE_ALWAYS, "Loading finished in (%d) secs...\n", (tstop - tstart));
 
-    // 6. Notify that the env is loaded
+    // 8. Notify that the env is loaded
     _loaded = true;
     chk->join();
    return (RCOK);
@@ -894,10 +1015,75 @@ int ShoreTPCEEnv::post_init()
     }
 
     this->find_maxtrade_id();
+    this->build_ref_caches();
     return (0);
 }
 
 
+
+/********************************************************************* 
+ *
+ *  @fn:    build_ref_caches
+ *
+ *  @brief: If db-ref-cache is set, keeps the decoded rows of the nine
+ *          fixed tables in memory. Their non-EX index probes are then
+ *          answered without going to Shore.
+ *
+ *  @note:  Should be called in the context of an smthread, without an
+ *          attached xct
+ *
+ *********************************************************************/ 
+
+void ShoreTPCEEnv::build_ref_caches()
+{
+    if (!envVar::instance()->getVarInt("db-ref-cache",1)) return;
+
+    _psector_man->enable_cache();
+    _pcharge_man->enable_cache();
+    _pcommission_rate_man->enable_cache();
+    _pexchange_man->enable_cache();
+    _pindustry_man->enable_cache();
+    _pstatus_type_man->enable_cache();
+    _ptaxrate_man->enable_cache();
+    _ptrade_type_man->enable_cache();
+    _pzip_code_man->enable_cache();
+
+    w_rc_t e = refresh_ref_caches();
+    if (e.is_error()) {
+        TRACE( TRACE_ALWAYS, "Building the fixed table caches failed [0x%x]\n",
+               e.err_num());
+        return;
+    }
+    _use_ref_caches = true;
+    TRACE( TRACE_ALWAYS, "Fixed tables cached\n");
+}
+
+
+/********************************************************************* 
+ *
+ *  @fn:    refresh_ref_caches
+ *
+ *  @brief: Rebuilds the caches that were invalidated by an update. 
+ *          Valid caches are left untouched, so this is cheap when
+ *          nothing changed.
+ *
+ *********************************************************************/ 
+
+w_rc_t ShoreTPCEEnv::refresh_ref_caches()
+{
+    W_DO(_psector_man->refresh_cache(db()));
+    W_DO(_pcharge_man->refresh_cache(db()));
+    W_DO(_pcommission_rate_man->refresh_cache(db()));
+    W_DO(_pexchange_man->refresh_cache(db()));
+    W_DO(_pindustry_man->refresh_cache(db()));
+    W_DO(_pstatus_type_man->refresh_cache(db()));
+    W_DO(_ptaxrate_man->refresh_cache(db()));
+    W_DO(_ptrade_type_man->refresh_cache(db()));
+    W_DO(_pzip_code_man->refresh_cache(db()));
+    return (RCOK);
+}
+
+
 /********************************************************************* 
  *
  *  @fn:    _post_init_impl
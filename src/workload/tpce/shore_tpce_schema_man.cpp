@@ -321,6 +321,73 @@ w_rc_t commission_rate_man_impl::cr_get_iter_by_index(ss_m* db,
     return (RCOK);
 }
 
+w_rc_t commission_rate_man_impl::cr_get_rate(ss_m* db,
+                                             commission_rate_tuple* ptuple,
+                                             rep_row_t &replow,
+                                             rep_row_t &rephigh,
+                                             const short c_tier, 
+                                             const char* type_id, 
+                                             const char* s_ex_id,
+                                             const int trade_qty,
+                                             double& rate)
+{
+    assert (ptuple);
+    assert (_ptable);
+
+    int to_qty;
+
+    // (_pcache is the row cache here)
+    table_cache_t* pcache = cache();
+    if (pcache) {
+        index_desc_t* pindex = _ptable->find_index("CR_INDEX");
+        assert (pindex);
+
+        ptuple->set_value(0, c_tier);
+        ptuple->set_value(1, type_id);
+        ptuple->set_value(2, s_ex_id);
+        ptuple->set_value(3, (int)0);
+        format_key(pindex, ptuple, replow);
+        assert (replow._dest);
+
+        ptuple->set_value(3, trade_qty);
+        format_key(pindex, ptuple, rephigh);
+        assert (rephigh._dest);
+
+        vector<const table_row_t*> rows;
+        table_cache_t::pin_t pin;
+        if (pcache->range(pindex, replow._dest, rephigh._dest, rows, pin)) {
+            for (uint_t i=0; i<rows.size(); i++) {
+                rows[i]->get_value(4, to_qty);
+                if (to_qty >= trade_qty) {
+                    rows[i]->get_value(5, rate);
+                    break;
+                }
+            }
+            return (RCOK);
+        }
+    }
+
+    guard<commission_rate_index_iter> cr_iter;
+    {
+        commission_rate_index_iter* tmp_cr_iter;
+        W_DO(cr_get_iter_by_index(db, tmp_cr_iter, ptuple, replow, rephigh,
+                                  c_tier, type_id, s_ex_id, trade_qty));
+        cr_iter = tmp_cr_iter;
+    }
+
+    bool eof;
+    W_DO(cr_iter->next(db, eof, *ptuple));
+    while (!eof) {
+        ptuple->get_value(4, to_qty);
+        if (to_qty >= trade_qty) {
+            ptuple->get_value(5, rate);
+            break;
+        }
+        W_DO(cr_iter->next(db, eof, *ptuple));
+    }
+    return (RCOK);
+}
+
 
 /* ----------------- */
 /* --- COMPANY ----- */
@@ -1456,6 +1523,14 @@ w_rc_t settlement_man_impl::se_index_probe(ss_m* db, settlement_tuple* ptuple,co
     return (index_probe_by_name(db, "SE_INDEX", ptuple));
 }
 
+w_rc_t settlement_man_impl::se_index_probe_batch(ss_m* db, settlement_tuple** ptuples, const TIdent* tr_ids, const int count)
+{
+    assert (ptuples);
+    assert (tr_ids);
+    for (int i=0; i<count; i++) ptuples[i]->set_value(0, tr_ids[i]);
+    return (index_probe_batch_by_name(db, "SE_INDEX", ptuples, count));
+}
+
 w_rc_t settlement_man_impl::se_index_probe_forupdate(ss_m* db, settlement_tuple* ptuple, const TIdent tr_id)
 {
     assert (ptuple);    
@@ -1508,6 +1583,14 @@ w_rc_t trade_man_impl::t_index_probe(ss_m* db, trade_tuple* ptuple, const TIdent
     return (index_probe_by_name(db, "T_INDEX", ptuple));
 }
 
+w_rc_t trade_man_impl::t_index_probe_batch(ss_m* db, trade_tuple** ptuples, const TIdent* trade_ids, const int count)
+{
+    assert (ptuples);
+    assert (trade_ids);
+    for (int i=0; i<count; i++) ptuples[i]->set_value(0, trade_ids[i]);
+    return (index_probe_batch_by_name(db, "T_INDEX", ptuples, count));
+}
+
 w_rc_t trade_man_impl::t_update_tax_by_index(ss_m* db,
                                              trade_tuple* ptuple,
                                              const TIdent t_id,
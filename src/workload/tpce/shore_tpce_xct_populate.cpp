@@ -42,6 +42,7 @@
 #include "workload/tpce/egen/CE.h"
 #include "workload/tpce/egen/TxnHarnessStructs.h"
 #include "workload/tpce/shore_tpce_egen.h"
+#include "util/progress.h"
 
 using namespace shore;
 using namespace TPCE;
@@ -72,43 +73,49 @@ int TradeOrderCnt;
 unsigned long lastTradeId = 0;
 
 //buffers for Egen data
-AccountPermissionBuffer accountPermissionBuffer (3015);
-CustomerBuffer customerBuffer (1005);
-CustomerAccountBuffer customerAccountBuffer (1005);
-CustomerTaxrateBuffer  customerTaxrateBuffer (2010);
-HoldingBuffer holdingBuffer(10000);
-HoldingHistoryBuffer holdingHistoryBuffer(2*loadUnit);
-HoldingSummaryBuffer holdingSummaryBuffer(6000);
-WatchItemBuffer watchItemBuffer (iMaxItemsInWL*1020+5000);
-WatchListBuffer watchListBuffer (1020);
-
-BrokerBuffer brokerBuffer(100);
-CashTransactionBuffer cashTransactionBuffer(loadUnit);
-ChargeBuffer chargeBuffer(20);
-CommissionRateBuffer commissionRateBuffer (245);
-SettlementBuffer settlementBuffer(loadUnit);
-TradeBuffer tradeBuffer(loadUnit);
-TradeHistoryBuffer tradeHistoryBuffer(3*loadUnit);
-TradeTypeBuffer tradeTypeBuffer (10);
-
-
-CompanyBuffer companyBuffer (1000);
-CompanyCompetitorBuffer companyCompetitorBuffer(3000);
-DailyMarketBuffer dailyMarketBuffer(3000);
-ExchangeBuffer exchangeBuffer(9);
-FinancialBuffer financialBuffer (1500);
-IndustryBuffer industryBuffer(107);
-LastTradeBuffer lastTradeBuffer (1005);
-NewsItemBuffer newsItemBuffer(200); 
-NewsXRefBuffer newsXRefBuffer(200);//big
-SectorBuffer sectorBuffer(17);
-SecurityBuffer securityBuffer(1005);
-
-
-AddressBuffer addressBuffer(1005);
-StatusTypeBuffer statusTypeBuffer (10);
-TaxrateBuffer taxrateBuffer (325);
-ZipCodeBuffer zipCodeBuffer (14850);
+egen_load_ctx_t::egen_load_ctx_t(CGenerateAndLoad* agen, TIdent astart, TIdent acount)
+    : gen(agen), start(astart), count(acount), progress(0),
+      accountPermissionBuffer (3015),
+      customerBuffer (1005),
+      customerAccountBuffer (1005),
+      customerTaxrateBuffer (2010),
+      holdingBuffer(10000),
+      holdingHistoryBuffer(2*loadUnit),
+      holdingSummaryBuffer(6000),
+      watchItemBuffer (iMaxItemsInWL*1020+5000),
+      watchListBuffer (1020),
+
+      brokerBuffer(100),
+      cashTransactionBuffer(loadUnit),
+      chargeBuffer(20),
+      commissionRateBuffer (245),
+      settlementBuffer(loadUnit),
+      tradeBuffer(loadUnit),
+      tradeHistoryBuffer(3*loadUnit),
+      tradeTypeBuffer (10),
+
+      companyBuffer (1000),
+      companyCompetitorBuffer(3000),
+      dailyMarketBuffer(3000),
+      exchangeBuffer(9),
+      financialBuffer (1500),
+      industryBuffer(107),
+      lastTradeBuffer (1005),
+      newsItemBuffer(200),
+      newsXRefBuffer(200),//big
+      sectorBuffer(17),
+      securityBuffer(1005),
+
+      addressBuffer(1005),
+      statusTypeBuffer (10),
+      taxrateBuffer (325),
+      zipCodeBuffer (14850)
+{
+}
+
+// The loader context of the calling thread. Set by each loader thread
+// before it populates any table.
+__thread egen_load_ctx_t* my_egen = NULL;
 
 /******************************************************************** 
  *
@@ -274,7 +281,12 @@ w_rc_t ShoreTPCEEnv::run_one_xct(Request* prequest)
 	return run_trade_update(prequest);
 
     case XCT_TPCE_DATA_MAINTENANCE:
-	return run_data_maintenance(prequest);
+	{
+	    // the xct has finished, rebuild what it invalidated
+	    w_rc_t e = run_data_maintenance(prequest);
+	    if (_use_ref_caches) W_DO(refresh_ref_caches());
+	    return (e);
+	}
 
     case XCT_TPCE_TRADE_CLEANUP:
 	return run_trade_cleanup(prequest);
@@ -364,13 +376,13 @@ w_rc_t ShoreTPCEEnv::_load_one_sector(rep_row_t& areprow, PSECTOR_ROW record)
 
 void ShoreTPCEEnv::_read_sector()
 {
-    bool isLast = pGenerateAndLoad->isLastSector();
+    bool isLast = my_egen->gen->isLastSector();
     while(!isLast) {
-	PSECTOR_ROW record = pGenerateAndLoad->getSectorRow();
-	sectorBuffer.append(record);
-	isLast= pGenerateAndLoad->isLastSector();
+	PSECTOR_ROW record = my_egen->gen->getSectorRow();
+	my_egen->sectorBuffer.append(record);
+	isLast= my_egen->gen->isLastSector();
     }
-    sectorBuffer.setMoreToRead(false);
+    my_egen->sectorBuffer.setMoreToRead(false);
 }
 
 // Populates one CHARGE
@@ -389,13 +401,13 @@ w_rc_t ShoreTPCEEnv::_load_one_charge(rep_row_t& areprow, PCHARGE_ROW record)
 
 void ShoreTPCEEnv::_read_charge()
 {
-    bool isLast = pGenerateAndLoad->isLastCharge();
+    bool isLast = my_egen->gen->isLastCharge();
     while(!isLast) {
-	PCHARGE_ROW record = pGenerateAndLoad->getChargeRow();
-	chargeBuffer.append(record);
-	isLast= pGenerateAndLoad->isLastCharge();
+	PCHARGE_ROW record = my_egen->gen->getChargeRow();
+	my_egen->chargeBuffer.append(record);
+	isLast= my_egen->gen->isLastCharge();
     }
-    chargeBuffer.setMoreToRead(false);
+    my_egen->chargeBuffer.setMoreToRead(false);
 }
 
 // Populates one COMMISSION_RATE
@@ -418,13 +430,13 @@ w_rc_t ShoreTPCEEnv::_load_one_commission_rate(rep_row_t& areprow,
 
 void ShoreTPCEEnv::_read_commission_rate()
 {
-    bool isLast = pGenerateAndLoad->isLastCommissionRate();
+    bool isLast = my_egen->gen->isLastCommissionRate();
     while(!isLast) {
-	PCOMMISSION_RATE_ROW record = pGenerateAndLoad->getCommissionRateRow();
-	commissionRateBuffer.append(record);
-	isLast= pGenerateAndLoad->isLastCommissionRate();
+	PCOMMISSION_RATE_ROW record = my_egen->gen->getCommissionRateRow();
+	my_egen->commissionRateBuffer.append(record);
+	isLast= my_egen->gen->isLastCommissionRate();
     }
-    commissionRateBuffer.setMoreToRead(false);
+    my_egen->commissionRateBuffer.setMoreToRead(false);
 }
 
 // Populates one EXCHANGE
@@ -447,14 +459,14 @@ w_rc_t ShoreTPCEEnv::_load_one_exchange(rep_row_t& areprow, PEXCHANGE_ROW record
 
 void ShoreTPCEEnv::_read_exchange()
 {
-    bool isLast = pGenerateAndLoad->isLastExchange();
+    bool isLast = my_egen->gen->isLastExchange();
     while(!isLast) {
 	assert(testCnt<10);
-	PEXCHANGE_ROW record = pGenerateAndLoad->getExchangeRow();
-	exchangeBuffer.append(record);    
-	isLast= pGenerateAndLoad->isLastExchange();
+	PEXCHANGE_ROW record = my_egen->gen->getExchangeRow();
+	my_egen->exchangeBuffer.append(record);    
+	isLast= my_egen->gen->isLastExchange();
     }
-    exchangeBuffer.setMoreToRead(false);
+    my_egen->exchangeBuffer.setMoreToRead(false);
 }
 
 // Populates one INDUSTRY
@@ -473,13 +485,13 @@ w_rc_t ShoreTPCEEnv::_load_one_industry(rep_row_t& areprow, PINDUSTRY_ROW record
 
 void ShoreTPCEEnv::_read_industry()
 {
-    bool isLast = pGenerateAndLoad->isLastIndustry();
+    bool isLast = my_egen->gen->isLastIndustry();
     while(!isLast) {
-	PINDUSTRY_ROW record = pGenerateAndLoad->getIndustryRow();
-	industryBuffer.append(record);
-	isLast= pGenerateAndLoad->isLastIndustry();
+	PINDUSTRY_ROW record = my_egen->gen->getIndustryRow();
+	my_egen->industryBuffer.append(record);
+	isLast= my_egen->gen->isLastIndustry();
     }
-    industryBuffer.setMoreToRead(false);
+    my_egen->industryBuffer.setMoreToRead(false);
 }
 
 // Populates one STATUS_TYPE
@@ -498,13 +510,13 @@ w_rc_t ShoreTPCEEnv::_load_one_status_type(rep_row_t& areprow,
 
 void ShoreTPCEEnv::_read_status_type()
 {
-    bool isLast = pGenerateAndLoad->isLastStatusType();
+    bool isLast = my_egen->gen->isLastStatusType();
     while(!isLast){
-	PSTATUS_TYPE_ROW record = pGenerateAndLoad->getStatusTypeRow();
-	statusTypeBuffer.append(record);
-	isLast= pGenerateAndLoad->isLastStatusType();
+	PSTATUS_TYPE_ROW record = my_egen->gen->getStatusTypeRow();
+	my_egen->statusTypeBuffer.append(record);
+	isLast= my_egen->gen->isLastStatusType();
     }
-    statusTypeBuffer.setMoreToRead(false);
+    my_egen->statusTypeBuffer.setMoreToRead(false);
 }
 
 // Populates one TAXRATE
@@ -525,11 +537,11 @@ void ShoreTPCEEnv::_read_taxrate()
 {
     bool hasNext;
     do{
-	PTAXRATE_ROW record = pGenerateAndLoad->getTaxrateRow();
-	taxrateBuffer.append(record);
-	hasNext= pGenerateAndLoad->hasNextTaxrate();
+	PTAXRATE_ROW record = my_egen->gen->getTaxrateRow();
+	my_egen->taxrateBuffer.append(record);
+	hasNext= my_egen->gen->hasNextTaxrate();
     } while(hasNext);
-    taxrateBuffer.setMoreToRead(false);
+    my_egen->taxrateBuffer.setMoreToRead(false);
 }
 
 // Populates one TRADE_TYPE
@@ -550,13 +562,13 @@ w_rc_t ShoreTPCEEnv::_load_one_trade_type(rep_row_t& areprow,
 
 void ShoreTPCEEnv::_read_trade_type()
 {
-    bool isLast = pGenerateAndLoad->isLastTradeType();
+    bool isLast = my_egen->gen->isLastTradeType();
     while(!isLast) {
-	PTRADE_TYPE_ROW record = pGenerateAndLoad->getTradeTypeRow();
-	tradeTypeBuffer.append(record);
-	isLast= pGenerateAndLoad->isLastTradeType();
+	PTRADE_TYPE_ROW record = my_egen->gen->getTradeTypeRow();
+	my_egen->tradeTypeBuffer.append(record);
+	isLast= my_egen->gen->isLastTradeType();
     }
-    tradeTypeBuffer.setMoreToRead(false);
+    my_egen->tradeTypeBuffer.setMoreToRead(false);
 }
 
 // Populates one ZIP_CODE
@@ -575,13 +587,13 @@ w_rc_t ShoreTPCEEnv::_load_one_zip_code(rep_row_t& areprow, PZIP_CODE_ROW record
 
 void ShoreTPCEEnv::_read_zip_code()
 {
-    bool hasNext = pGenerateAndLoad->hasNextZipCode();
+    bool hasNext = my_egen->gen->hasNextZipCode();
     while(hasNext) {
-	PZIP_CODE_ROW record = pGenerateAndLoad->getZipCodeRow();
-	zipCodeBuffer.append(record);
-	hasNext= pGenerateAndLoad->hasNextZipCode();
+	PZIP_CODE_ROW record = my_egen->gen->getZipCodeRow();
+	my_egen->zipCodeBuffer.append(record);
+	hasNext= my_egen->gen->hasNextZipCode();
     }
-    zipCodeBuffer.setMoreToRead(false);
+    my_egen->zipCodeBuffer.setMoreToRead(false);
 }
 
 // Populates one CUSTOMER
@@ -626,11 +638,11 @@ void ShoreTPCEEnv::_read_customer()
 {
     bool hasNext;
     do {
-	hasNext= pGenerateAndLoad->hasNextCustomer();
-	PCUSTOMER_ROW record = pGenerateAndLoad->getCustomerRow();
-	customerBuffer.append(record);
-    } while((hasNext && customerBuffer.hasSpace()));
-    customerBuffer.setMoreToRead(hasNext);
+	hasNext= my_egen->gen->hasNextCustomer();
+	PCUSTOMER_ROW record = my_egen->gen->getCustomerRow();
+	my_egen->customerBuffer.append(record);
+    } while((hasNext && my_egen->customerBuffer.hasSpace()));
+    my_egen->customerBuffer.setMoreToRead(hasNext);
 }
 
 // Populates one CUSTOMER_TAXRATE
@@ -650,16 +662,16 @@ w_rc_t ShoreTPCEEnv::_load_one_customer_taxrate(rep_row_t& areprow,
 void ShoreTPCEEnv::_read_customer_taxrate()
 {
     bool hasNext;
-    int taxrates=pGenerateAndLoad->getTaxratesCount();
+    int taxrates=my_egen->gen->getTaxratesCount();
     do {
-	hasNext= pGenerateAndLoad->hasNextCustomerTaxrate();
+	hasNext= my_egen->gen->hasNextCustomerTaxrate();
 	for(int i=0; i<taxrates; i++) {
 	    PCUSTOMER_TAXRATE_ROW record =
-		pGenerateAndLoad->getCustomerTaxrateRow(i);
-	    customerTaxrateBuffer.append(record);
+		my_egen->gen->getCustomerTaxrateRow(i);
+	    my_egen->customerTaxrateBuffer.append(record);
 	}
-    } while((hasNext && customerTaxrateBuffer.hasSpace()));    
-    customerTaxrateBuffer.setMoreToRead(hasNext);
+    } while((hasNext && my_egen->customerTaxrateBuffer.hasSpace()));    
+    my_egen->customerTaxrateBuffer.setMoreToRead(hasNext);
 }
 
 // Populates one CUSTOMER_ACCOUNT
@@ -701,17 +713,17 @@ void ShoreTPCEEnv::_read_ca_and_ap()
 {
     bool hasNext;
     do {
-	hasNext= pGenerateAndLoad->hasNextCustomerAccount();
-	PCUSTOMER_ACCOUNT_ROW record = pGenerateAndLoad->getCustomerAccountRow();
-	customerAccountBuffer.append(record);
-	int perms = pGenerateAndLoad->PermissionsPerCustomer();
+	hasNext= my_egen->gen->hasNextCustomerAccount();
+	PCUSTOMER_ACCOUNT_ROW record = my_egen->gen->getCustomerAccountRow();
+	my_egen->customerAccountBuffer.append(record);
+	int perms = my_egen->gen->PermissionsPerCustomer();
 	for(int i=0; i<perms; i++) {
 	    PACCOUNT_PERMISSION_ROW row =
-		pGenerateAndLoad->getAccountPermissionRow(i);
-	    accountPermissionBuffer.append(row);
+		my_egen->gen->getAccountPermissionRow(i);
+	    my_egen->accountPermissionBuffer.append(row);
 	}
-    } while((hasNext && customerAccountBuffer.hasSpace()));
-    customerAccountBuffer.setMoreToRead(hasNext);
+    } while((hasNext && my_egen->customerAccountBuffer.hasSpace()));
+    my_egen->customerAccountBuffer.setMoreToRead(hasNext);
 }
 
 // Populates one ADDRESS
@@ -734,11 +746,11 @@ void ShoreTPCEEnv::_read_address()
 {
     bool hasNext;
     do {
-	hasNext= pGenerateAndLoad->hasNextAddress();
-	PADDRESS_ROW record = pGenerateAndLoad->getAddressRow();
-	addressBuffer.append(record);
-    } while((hasNext && addressBuffer.hasSpace()));
-    addressBuffer.setMoreToRead(hasNext);
+	hasNext= my_egen->gen->hasNextAddress();
+	PADDRESS_ROW record = my_egen->gen->getAddressRow();
+	my_egen->addressBuffer.append(record);
+    } while((hasNext && my_egen->addressBuffer.hasSpace()));
+    my_egen->addressBuffer.setMoreToRead(hasNext);
 }
 
 // Populates one WATCH_LIST
@@ -773,16 +785,16 @@ void ShoreTPCEEnv::_read_wl_and_wi()
 {
     bool hasNext;
     do {
-	hasNext= pGenerateAndLoad->hasNextWatchList();
-	PWATCH_LIST_ROW record = pGenerateAndLoad->getWatchListRow();
-	watchListBuffer.append(record);
-	int items = pGenerateAndLoad->ItemsPerWatchList();
+	hasNext= my_egen->gen->hasNextWatchList();
+	PWATCH_LIST_ROW record = my_egen->gen->getWatchListRow();
+	my_egen->watchListBuffer.append(record);
+	int items = my_egen->gen->ItemsPerWatchList();
 	for(int i=0; i<items; ++i) {
-	    PWATCH_ITEM_ROW row = pGenerateAndLoad->getWatchItemRow(i);
-	    watchItemBuffer.append(row);
+	    PWATCH_ITEM_ROW row = my_egen->gen->getWatchItemRow(i);
+	    my_egen->watchItemBuffer.append(row);
 	}
-    } while(hasNext && watchListBuffer.hasSpace());
-    watchListBuffer.setMoreToRead(hasNext);
+    } while(hasNext && my_egen->watchListBuffer.hasSpace());
+    my_egen->watchListBuffer.setMoreToRead(hasNext);
 }
 
 // Populates one COMPANY
@@ -809,11 +821,11 @@ void ShoreTPCEEnv::_read_company()
 {
     bool hasNext;
     do {
-	hasNext= pGenerateAndLoad->hasNextCompany();
-	PCOMPANY_ROW record = pGenerateAndLoad->getCompanyRow();
-	companyBuffer.append(record);
-    } while((hasNext && companyBuffer.hasSpace()));
-    companyBuffer.setMoreToRead(hasNext);
+	hasNext= my_egen->gen->hasNextCompany();
+	PCOMPANY_ROW record = my_egen->gen->getCompanyRow();
+	my_egen->companyBuffer.append(record);
+    } while((hasNext && my_egen->companyBuffer.hasSpace()));
+    my_egen->companyBuffer.setMoreToRead(hasNext);
 }
 
 // Populates one COMPANY_COMPETITOR
@@ -835,12 +847,12 @@ void ShoreTPCEEnv::_read_company_competitor()
 {
     bool hasNext;
     do {
-	hasNext= pGenerateAndLoad->hasNextCompanyCompetitor();
+	hasNext= my_egen->gen->hasNextCompanyCompetitor();
 	PCOMPANY_COMPETITOR_ROW record =
-	    pGenerateAndLoad->getCompanyCompetitorRow();
-	companyCompetitorBuffer.append(record);
-    } while((hasNext && companyCompetitorBuffer.hasSpace()));
-    companyCompetitorBuffer.setMoreToRead(hasNext);
+	    my_egen->gen->getCompanyCompetitorRow();
+	my_egen->companyCompetitorBuffer.append(record);
+    } while((hasNext && my_egen->companyCompetitorBuffer.hasSpace()));
+    my_egen->companyCompetitorBuffer.setMoreToRead(hasNext);
 }
 
 // Populates one DAILY_MARKET
@@ -865,11 +877,11 @@ void ShoreTPCEEnv::_read_daily_market()
 {
     bool hasNext;
     do {
-	hasNext= pGenerateAndLoad->hasNextDailyMarket();
-	PDAILY_MARKET_ROW record = pGenerateAndLoad->getDailyMarketRow();
-	dailyMarketBuffer.append(record);
-    } while((hasNext && dailyMarketBuffer.hasSpace()));
-    dailyMarketBuffer.setMoreToRead(hasNext);
+	hasNext= my_egen->gen->hasNextDailyMarket();
+	PDAILY_MARKET_ROW record = my_egen->gen->getDailyMarketRow();
+	my_egen->dailyMarketBuffer.append(record);
+    } while((hasNext && my_egen->dailyMarketBuffer.hasSpace()));
+    my_egen->dailyMarketBuffer.setMoreToRead(hasNext);
 }
 
 // Populates one FINANCIAL
@@ -901,11 +913,11 @@ void ShoreTPCEEnv::_read_financial()
 {
     bool hasNext;
     do {
-	hasNext= pGenerateAndLoad->hasNextFinancial();
-	PFINANCIAL_ROW record = pGenerateAndLoad->getFinancialRow();
-	financialBuffer.append(record);
-    } while((hasNext && financialBuffer.hasSpace()));
-    financialBuffer.setMoreToRead(hasNext);
+	hasNext= my_egen->gen->hasNextFinancial();
+	PFINANCIAL_ROW record = my_egen->gen->getFinancialRow();
+	my_egen->financialBuffer.append(record);
+    } while((hasNext && my_egen->financialBuffer.hasSpace()));
+    my_egen->financialBuffer.setMoreToRead(hasNext);
 }
 
 // Populates one LAST_TRADE
@@ -929,11 +941,11 @@ void ShoreTPCEEnv::_read_last_trade()
 {
     bool hasNext;
     do {
-	hasNext= pGenerateAndLoad->hasNextLastTrade();
-	PLAST_TRADE_ROW record = pGenerateAndLoad->getLastTradeRow();
-	lastTradeBuffer.append(record);
-    } while((hasNext && lastTradeBuffer.hasSpace()));
-    lastTradeBuffer.setMoreToRead(hasNext);
+	hasNext= my_egen->gen->hasNextLastTrade();
+	PLAST_TRADE_ROW record = my_egen->gen->getLastTradeRow();
+	my_egen->lastTradeBuffer.append(record);
+    } while((hasNext && my_egen->lastTradeBuffer.hasSpace()));
+    my_egen->lastTradeBuffer.setMoreToRead(hasNext);
 }
 
 // Populates one NEWS_ITEM
@@ -973,14 +985,14 @@ void ShoreTPCEEnv::_read_ni_and_nx()
 {
     bool hasNext;
     do {
-	hasNext= pGenerateAndLoad->hasNextNewsItemAndNewsXRef();
-	PNEWS_ITEM_ROW record1 = pGenerateAndLoad->getNewsItemRow();
-	PNEWS_XREF_ROW record2 = pGenerateAndLoad->getNewsXRefRow();
-	newsItemBuffer.append(record1);
-	newsXRefBuffer.append(record2);
-    } while((hasNext && newsItemBuffer.hasSpace()));
-    newsItemBuffer.setMoreToRead(hasNext);
-    newsXRefBuffer.setMoreToRead(hasNext);
+	hasNext= my_egen->gen->hasNextNewsItemAndNewsXRef();
+	PNEWS_ITEM_ROW record1 = my_egen->gen->getNewsItemRow();
+	PNEWS_XREF_ROW record2 = my_egen->gen->getNewsXRefRow();
+	my_egen->newsItemBuffer.append(record1);
+	my_egen->newsXRefBuffer.append(record2);
+    } while((hasNext && my_egen->newsItemBuffer.hasSpace()));
+    my_egen->newsItemBuffer.setMoreToRead(hasNext);
+    my_egen->newsXRefBuffer.setMoreToRead(hasNext);
 }
 
 // Populates one SECURITY
@@ -1018,11 +1030,11 @@ void ShoreTPCEEnv::_read_security()
 {
     bool hasNext;
     do {
-	hasNext= pGenerateAndLoad->hasNextSecurity();
-	PSECURITY_ROW record = pGenerateAndLoad->getSecurityRow();
-	securityBuffer.append(record);
-    } while((hasNext && securityBuffer.hasSpace()));
-    securityBuffer.setMoreToRead(hasNext);
+	hasNext= my_egen->gen->hasNextSecurity();
+	PSECURITY_ROW record = my_egen->gen->getSecurityRow();
+	my_egen->securityBuffer.append(record);
+    } while((hasNext && my_egen->securityBuffer.hasSpace()));
+    my_egen->securityBuffer.setMoreToRead(hasNext);
 }
 
 // Populates one TRADE
@@ -1118,29 +1130,29 @@ void ShoreTPCEEnv::_read_trade_unit()
 {
     bool hasNext;
     do {
-	hasNext= pGenerateAndLoad->hasNextTrade();
-	PTRADE_ROW row = pGenerateAndLoad->getTradeRow();
-	tradeBuffer.append(row);
-	int hist = pGenerateAndLoad->getTradeHistoryRowCount();
+	hasNext= my_egen->gen->hasNextTrade();
+	PTRADE_ROW row = my_egen->gen->getTradeRow();
+	my_egen->tradeBuffer.append(row);
+	int hist = my_egen->gen->getTradeHistoryRowCount();
 	for(int i=0; i<hist; i++) {
-	    PTRADE_HISTORY_ROW record = pGenerateAndLoad->getTradeHistoryRow(i);
-	    tradeHistoryBuffer.append(record);
+	    PTRADE_HISTORY_ROW record = my_egen->gen->getTradeHistoryRow(i);
+	    my_egen->tradeHistoryBuffer.append(record);
 	}
-	if(pGenerateAndLoad->shouldProcessSettlementRow()) {
-	    PSETTLEMENT_ROW record = pGenerateAndLoad->getSettlementRow();
-	    settlementBuffer.append(record);
+	if(my_egen->gen->shouldProcessSettlementRow()) {
+	    PSETTLEMENT_ROW record = my_egen->gen->getSettlementRow();
+	    my_egen->settlementBuffer.append(record);
 	}
-	if(pGenerateAndLoad->shouldProcessCashTransactionRow()) {
-	    PCASH_TRANSACTION_ROW record=pGenerateAndLoad->getCashTransactionRow();
-	    cashTransactionBuffer.append(record);
+	if(my_egen->gen->shouldProcessCashTransactionRow()) {
+	    PCASH_TRANSACTION_ROW record=my_egen->gen->getCashTransactionRow();
+	    my_egen->cashTransactionBuffer.append(record);
 	}
-	hist = pGenerateAndLoad->getHoldingHistoryRowCount();
+	hist = my_egen->gen->getHoldingHistoryRowCount();
 	for(int i=0; i<hist; i++) {
-	    PHOLDING_HISTORY_ROW record=pGenerateAndLoad->getHoldingHistoryRow(i);
-	    holdingHistoryBuffer.append(record);
+	    PHOLDING_HISTORY_ROW record=my_egen->gen->getHoldingHistoryRow(i);
+	    my_egen->holdingHistoryBuffer.append(record);
 	}
-    } while((hasNext && tradeBuffer.hasSpace()));
-    tradeBuffer.setMoreToRead(hasNext);
+    } while((hasNext && my_egen->tradeBuffer.hasSpace()));
+    my_egen->tradeBuffer.setMoreToRead(hasNext);
 }
 
 // Populates one BROKER
@@ -1163,11 +1175,11 @@ void ShoreTPCEEnv::_read_broker()
 {
     bool hasNext;
     do {
-	hasNext= pGenerateAndLoad->hasNextBroker();
-	PBROKER_ROW record = pGenerateAndLoad->getBrokerRow();
-	brokerBuffer.append(record);
-    } while((hasNext && brokerBuffer.hasSpace()));
-    brokerBuffer.setMoreToRead(hasNext);
+	hasNext= my_egen->gen->hasNextBroker();
+	PBROKER_ROW record = my_egen->gen->getBrokerRow();
+	my_egen->brokerBuffer.append(record);
+    } while((hasNext && my_egen->brokerBuffer.hasSpace()));
+    my_egen->brokerBuffer.setMoreToRead(hasNext);
 }
 
 // Populates one HOLDING
@@ -1191,11 +1203,11 @@ void ShoreTPCEEnv::_read_holding()
 {
     bool hasNext;
     do {
-	hasNext= pGenerateAndLoad->hasNextHolding();
-	PHOLDING_ROW record = pGenerateAndLoad->getHoldingRow();
-	holdingBuffer.append(record);
-    } while((hasNext && holdingBuffer.hasSpace()));
-    holdingBuffer.setMoreToRead(hasNext);
+	hasNext= my_egen->gen->hasNextHolding();
+	PHOLDING_ROW record = my_egen->gen->getHoldingRow();
+	my_egen->holdingBuffer.append(record);
+    } while((hasNext && my_egen->holdingBuffer.hasSpace()));
+    my_egen->holdingBuffer.setMoreToRead(hasNext);
 }
 
 // Populates one HOLDING_SUMMARY
@@ -1221,11 +1233,11 @@ void ShoreTPCEEnv::_read_holding_summary()
 {
     bool hasNext;
     do {
-	hasNext= pGenerateAndLoad->hasNextHoldingSummary();
-	PHOLDING_SUMMARY_ROW record = pGenerateAndLoad->getHoldingSummaryRow();
-	holdingSummaryBuffer.append(record);
-    } while((hasNext && holdingSummaryBuffer.hasSpace()));
-    holdingSummaryBuffer.setMoreToRead(hasNext);
+	hasNext= my_egen->gen->hasNextHoldingSummary();
+	PHOLDING_SUMMARY_ROW record = my_egen->gen->getHoldingSummaryRow();
+	my_egen->holdingSummaryBuffer.append(record);
+    } while((hasNext && my_egen->holdingSummaryBuffer.hasSpace()));
+    my_egen->holdingSummaryBuffer.setMoreToRead(hasNext);
 }
 
 // Populates one TRADE_REQUEST
@@ -1260,68 +1272,77 @@ w_rc_t ShoreTPCEEnv::xct_populate_small(const int xct_id,
 
     // 2. Build the small tables
     TRACE( TRACE_ALWAYS, "Building CHARGE !!!\n");
-    int rows=chargeBuffer.getSize();
+    int rows=my_egen->chargeBuffer.getSize();
     for(int i=0; i<rows; i++){
-	PCHARGE_ROW record = chargeBuffer.get(i);
+	PCHARGE_ROW record = my_egen->chargeBuffer.get(i);
 	W_DO(_load_one_charge(areprow, record));
+	progress_update(&my_egen->progress);
     }
-    pGenerateAndLoad->ReleaseCharge();
+    my_egen->gen->ReleaseCharge();
     TRACE( TRACE_ALWAYS, "Building COMMISSION_RATE !!!\n");
-    rows=commissionRateBuffer.getSize();
+    rows=my_egen->commissionRateBuffer.getSize();
     for(int i=0; i<rows; i++){
-	PCOMMISSION_RATE_ROW record = commissionRateBuffer.get(i);
+	PCOMMISSION_RATE_ROW record = my_egen->commissionRateBuffer.get(i);
 	W_DO(_load_one_commission_rate(areprow, record));
+	progress_update(&my_egen->progress);
     }
-    pGenerateAndLoad->ReleaseCommissionRate();
+    my_egen->gen->ReleaseCommissionRate();
     TRACE( TRACE_ALWAYS, "Building EXCHANGE !!!\n");
-    rows=exchangeBuffer.getSize();
+    rows=my_egen->exchangeBuffer.getSize();
     for(int i=0; i<rows; i++){
-	PEXCHANGE_ROW record = exchangeBuffer.get(i);
+	PEXCHANGE_ROW record = my_egen->exchangeBuffer.get(i);
 	W_DO(_load_one_exchange(areprow, record));
+	progress_update(&my_egen->progress);
     }
-    pGenerateAndLoad->ReleaseExchange();
+    my_egen->gen->ReleaseExchange();
     TRACE( TRACE_ALWAYS, "Building INDUSTRY !!!\n");
-    rows=industryBuffer.getSize();
+    rows=my_egen->industryBuffer.getSize();
     for(int i=0; i<rows; i++){
-	PINDUSTRY_ROW record = industryBuffer.get(i);
+	PINDUSTRY_ROW record = my_egen->industryBuffer.get(i);
 	W_DO(_load_one_industry(areprow, record));
+	progress_update(&my_egen->progress);
     }
-    pGenerateAndLoad->ReleaseIndustry();
+    my_egen->gen->ReleaseIndustry();
     TRACE( TRACE_ALWAYS, "Building SECTOR !!!\n");
-    rows=sectorBuffer.getSize();
+    rows=my_egen->sectorBuffer.getSize();
     for(int i=0; i<rows; i++){
-	PSECTOR_ROW record = sectorBuffer.get(i);
+	PSECTOR_ROW record = my_egen->sectorBuffer.get(i);
 	W_DO(_load_one_sector(areprow, record));
+	progress_update(&my_egen->progress);
     }
-    pGenerateAndLoad->ReleaseSector();
+    my_egen->gen->ReleaseSector();
     TRACE( TRACE_ALWAYS, "Building STATUS_TYPE !!!\n");
-    rows=statusTypeBuffer.getSize();
+    rows=my_egen->statusTypeBuffer.getSize();
     for(int i=0; i<rows; i++){
-	PSTATUS_TYPE_ROW record = statusTypeBuffer.get(i);
+	PSTATUS_TYPE_ROW record = my_egen->statusTypeBuffer.get(i);
 	W_DO(_load_one_status_type(areprow, record));
+	progress_update(&my_egen->progress);
     }
-    pGenerateAndLoad->ReleaseStatusType();
+    my_egen->gen->ReleaseStatusType();
     TRACE( TRACE_ALWAYS, "Building TAXRATE !!!\n");
-    rows=taxrateBuffer.getSize();
+    rows=my_egen->taxrateBuffer.getSize();
     for(int i=0; i<rows; i++){
-	PTAXRATE_ROW record = taxrateBuffer.get(i);
+	PTAXRATE_ROW record = my_egen->taxrateBuffer.get(i);
 	W_DO(_load_one_taxrate(areprow, record));
+	progress_update(&my_egen->progress);
     }
-    pGenerateAndLoad->ReleaseTaxrate();
+    my_egen->gen->ReleaseTaxrate();
     TRACE( TRACE_ALWAYS, "Building TRADE_TYPE !!!\n");
-    rows=tradeTypeBuffer.getSize();
+    rows=my_egen->tradeTypeBuffer.getSize();
     for(int i=0; i<rows; i++){
-	PTRADE_TYPE_ROW record = tradeTypeBuffer.get(i);
+	PTRADE_TYPE_ROW record = my_egen->tradeTypeBuffer.get(i);
 	W_DO(_load_one_trade_type(areprow, record));
+	progress_update(&my_egen->progress);
     }
-    pGenerateAndLoad->ReleaseTradeType();
+    my_egen->gen->ReleaseTradeType();
     TRACE( TRACE_ALWAYS, "Building ZIP CODE !!!\n");
-    rows=zipCodeBuffer.getSize();
+    rows=my_egen->zipCodeBuffer.getSize();
     for(int i=0; i<rows; i++){
-	PZIP_CODE_ROW record = zipCodeBuffer.get(i);
+	PZIP_CODE_ROW record = my_egen->zipCodeBuffer.get(i);
 	W_DO(_load_one_zip_code(areprow, record));
+	progress_update(&my_egen->progress);
     }
-    pGenerateAndLoad->ReleaseZipCode();
+    my_egen->gen->ReleaseZipCode();
 
     return (_pssm->commit_xct());
 }
@@ -1336,10 +1357,11 @@ w_rc_t ShoreTPCEEnv::xct_populate_customer(const int xct_id,
     rep_row_t areprow(_pcustomer_man->ts());
     areprow.set(_pcustomer_desc->maxsize());
 
-    int rows=customerBuffer.getSize();
+    int rows=my_egen->customerBuffer.getSize();
     for(int i=0; i<rows; i++) {
-	PCUSTOMER_ROW record = customerBuffer.get(i);
+	PCUSTOMER_ROW record = my_egen->customerBuffer.get(i);
 	W_DO(_load_one_customer(areprow, record));
+	progress_update(&my_egen->progress);
     }
 
     return (_pssm->commit_xct());
@@ -1347,11 +1369,11 @@ w_rc_t ShoreTPCEEnv::xct_populate_customer(const int xct_id,
 
 void ShoreTPCEEnv::populate_customer()
 {	
-    pGenerateAndLoad->InitCustomer();
+    my_egen->gen->InitCustomer();
     TRACE( TRACE_ALWAYS, "Building CUSTOMER !!!\n");
-    while(customerBuffer.hasMoreToRead()){
+    while(my_egen->customerBuffer.hasMoreToRead()){
 	long log_space_needed = 0;
-	customerBuffer.reset();
+	my_egen->customerBuffer.reset();
 	_read_customer();
 	populate_customer_input_t in;
     retry:
@@ -1359,8 +1381,8 @@ void ShoreTPCEEnv::populate_customer()
 	CHECK_XCT_RETURN(this->xct_populate_customer(1, in),
 			 log_space_needed, retry, this);
     }
-    pGenerateAndLoad->ReleaseCustomer();
-    customerBuffer.release();
+    my_egen->gen->ReleaseCustomer();
+    my_egen->customerBuffer.release();
 }
 
 //address
@@ -1373,10 +1395,11 @@ w_rc_t ShoreTPCEEnv::xct_populate_address(const int xct_id,
     rep_row_t areprow(_paddress_man->ts());
     areprow.set(_paddress_desc->maxsize());
 
-    int rows=addressBuffer.getSize();
+    int rows=my_egen->addressBuffer.getSize();
     for(int i=0; i<rows; i++){
-	PADDRESS_ROW record = addressBuffer.get(i);
+	PADDRESS_ROW record = my_egen->addressBuffer.get(i);
 	W_DO(_load_one_address(areprow, record));
+	progress_update(&my_egen->progress);
     }
 
     return (_pssm->commit_xct());
@@ -1384,11 +1407,11 @@ w_rc_t ShoreTPCEEnv::xct_populate_address(const int xct_id,
 
 void ShoreTPCEEnv::populate_address()
 {	
-    pGenerateAndLoad->InitAddress();
+    my_egen->gen->InitAddress();
     TRACE( TRACE_ALWAYS, "Building ADDRESS !!!\n");
-    while(addressBuffer.hasMoreToRead()){
+    while(my_egen->addressBuffer.hasMoreToRead()){
 	long log_space_needed = 0;
-	addressBuffer.reset();
+	my_egen->addressBuffer.reset();
 	_read_address();
 	populate_address_input_t in;
     retry:
@@ -1396,8 +1419,8 @@ void ShoreTPCEEnv::populate_address()
 	CHECK_XCT_RETURN(this->xct_populate_address(1, in),
 			 log_space_needed, retry, this);
     }
-    pGenerateAndLoad->ReleaseAddress();
-    addressBuffer.release();
+    my_egen->gen->ReleaseAddress();
+    my_egen->addressBuffer.release();
 }
 
 //CustomerAccount and AccountPermission
@@ -1410,15 +1433,17 @@ w_rc_t ShoreTPCEEnv::xct_populate_ca_and_ap(const int xct_id,
     rep_row_t areprow(_pcustomer_account_man->ts());
     areprow.set(_pcustomer_account_desc->maxsize());
 
-    int rows=customerAccountBuffer.getSize();
+    int rows=my_egen->customerAccountBuffer.getSize();
     for(int i=0; i<rows; i++){
-	PCUSTOMER_ACCOUNT_ROW record = customerAccountBuffer.get(i);
+	PCUSTOMER_ACCOUNT_ROW record = my_egen->customerAccountBuffer.get(i);
 	W_DO(_load_one_customer_account(areprow, record));
+	progress_update(&my_egen->progress);
     }
-    rows=accountPermissionBuffer.getSize();
+    rows=my_egen->accountPermissionBuffer.getSize();
     for(int i=0; i<rows; i++){
-	PACCOUNT_PERMISSION_ROW record = accountPermissionBuffer.get(i);
+	PACCOUNT_PERMISSION_ROW record = my_egen->accountPermissionBuffer.get(i);
 	W_DO(_load_one_account_permission(areprow, record));
+	progress_update(&my_egen->progress);
     }
     
     return (_pssm->commit_xct());
@@ -1426,12 +1451,12 @@ w_rc_t ShoreTPCEEnv::xct_populate_ca_and_ap(const int xct_id,
 
 void ShoreTPCEEnv::populate_ca_and_ap()
 {
-    pGenerateAndLoad->InitCustomerAccountAndAccountPermission();
+    my_egen->gen->InitCustomerAccountAndAccountPermission();
     TRACE( TRACE_ALWAYS, "Building CustomerAccount and AccountPermission !!!\n");
-    while(customerAccountBuffer.hasMoreToRead()){
+    while(my_egen->customerAccountBuffer.hasMoreToRead()){
 	long log_space_needed = 0;
-	customerAccountBuffer.reset();
-	accountPermissionBuffer.reset();
+	my_egen->customerAccountBuffer.reset();
+	my_egen->accountPermissionBuffer.reset();
 	_read_ca_and_ap();
 	populate_ca_and_ap_input_t in;
     retry:
@@ -1439,9 +1464,9 @@ void ShoreTPCEEnv::populate_ca_and_ap()
 	CHECK_XCT_RETURN(this->xct_populate_ca_and_ap(1, in),
 			 log_space_needed, retry, this);
     }
-    pGenerateAndLoad->ReleaseCustomerAccountAndAccountPermission();
-    customerAccountBuffer.release();
-    accountPermissionBuffer.release();
+    my_egen->gen->ReleaseCustomerAccountAndAccountPermission();
+    my_egen->customerAccountBuffer.release();
+    my_egen->accountPermissionBuffer.release();
 }
 
 //Watch List and Watch Item
@@ -1454,15 +1479,17 @@ w_rc_t ShoreTPCEEnv::xct_populate_wl_and_wi(const int xct_id,
     rep_row_t areprow(_pwatch_item_man->ts());
     areprow.set(_pwatch_item_desc->maxsize());
 
-    int rows=watchListBuffer.getSize();
+    int rows=my_egen->watchListBuffer.getSize();
     for(int i=0; i<rows; i++){
-	PWATCH_LIST_ROW record = watchListBuffer.get(i);
+	PWATCH_LIST_ROW record = my_egen->watchListBuffer.get(i);
 	W_DO(_load_one_watch_list(areprow, record));
+	progress_update(&my_egen->progress);
     }
-    rows=watchItemBuffer.getSize();
+    rows=my_egen->watchItemBuffer.getSize();
     for(int i=0; i<rows; i++){
-	PWATCH_ITEM_ROW record = watchItemBuffer.get(i);
+	PWATCH_ITEM_ROW record = my_egen->watchItemBuffer.get(i);
 	W_DO(_load_one_watch_item(areprow, record));
+	progress_update(&my_egen->progress);
     }
 
     return (_pssm->commit_xct());
@@ -1470,12 +1497,12 @@ w_rc_t ShoreTPCEEnv::xct_populate_wl_and_wi(const int xct_id,
 
 void ShoreTPCEEnv::populate_wl_and_wi()
 {	
-    pGenerateAndLoad->InitWatchListAndWatchItem();
+    my_egen->gen->InitWatchListAndWatchItem();
     TRACE( TRACE_ALWAYS, "Building WATCH_LIST table and WATCH_ITEM !!!\n");
-    while(watchListBuffer.hasMoreToRead()){
+    while(my_egen->watchListBuffer.hasMoreToRead()){
 	long log_space_needed = 0;
-	watchItemBuffer.reset();
-	watchListBuffer.reset();
+	my_egen->watchItemBuffer.reset();
+	my_egen->watchListBuffer.reset();
 	_read_wl_and_wi();
 	populate_wl_and_wi_input_t in;
     retry:
@@ -1483,9 +1510,9 @@ void ShoreTPCEEnv::populate_wl_and_wi()
 	CHECK_XCT_RETURN(this->xct_populate_wl_and_wi(1, in),
 			 log_space_needed, retry, this);
     }
-    pGenerateAndLoad->ReleaseWatchListAndWatchItem();
-    watchItemBuffer.release();
-    watchListBuffer.release();
+    my_egen->gen->ReleaseWatchListAndWatchItem();
+    my_egen->watchItemBuffer.release();
+    my_egen->watchListBuffer.release();
 }
 
 //CUSTOMER_TAXRATE
@@ -1498,10 +1525,11 @@ w_rc_t ShoreTPCEEnv::xct_populate_customer_taxrate(const int xct_id,
     rep_row_t areprow(_pcustomer_taxrate_man->ts());
     areprow.set(_pcustomer_taxrate_desc->maxsize());
 
-    int rows=customerTaxrateBuffer.getSize();
+    int rows=my_egen->customerTaxrateBuffer.getSize();
     for(int i=0; i<rows; i++){
-	PCUSTOMER_TAXRATE_ROW record = customerTaxrateBuffer.get(i);
+	PCUSTOMER_TAXRATE_ROW record = my_egen->customerTaxrateBuffer.get(i);
 	W_DO(_load_one_customer_taxrate(areprow, record));
+	progress_update(&my_egen->progress);
     }
 
     return (_pssm->commit_xct());
@@ -1509,11 +1537,11 @@ w_rc_t ShoreTPCEEnv::xct_populate_customer_taxrate(const int xct_id,
 
 void ShoreTPCEEnv::populate_customer_taxrate()
 {	
-    pGenerateAndLoad->InitCustomerTaxrate();
+    my_egen->gen->InitCustomerTaxrate();
     TRACE( TRACE_ALWAYS, "Building CUSTOMER_TAXRATE !!!\n");
-    while(customerTaxrateBuffer.hasMoreToRead()){
+    while(my_egen->customerTaxrateBuffer.hasMoreToRead()){
 	long log_space_needed = 0;
-	customerTaxrateBuffer.reset();
+	my_egen->customerTaxrateBuffer.reset();
 	_read_customer_taxrate();
 	populate_customer_taxrate_input_t in;
     retry:
@@ -1521,8 +1549,8 @@ void ShoreTPCEEnv::populate_customer_taxrate()
 	CHECK_XCT_RETURN(this->xct_populate_customer_taxrate(1, in),
 			 log_space_needed, retry, this);
     }
-    pGenerateAndLoad->ReleaseCustomerTaxrate();
-    customerTaxrateBuffer.release();
+    my_egen->gen->ReleaseCustomerTaxrate();
+    my_egen->customerTaxrateBuffer.release();
 }
 
 //COMPANY
@@ -1535,10 +1563,11 @@ w_rc_t ShoreTPCEEnv::xct_populate_company(const int xct_id,
     rep_row_t areprow(_pcompany_man->ts());
     areprow.set(_pcompany_desc->maxsize());
 
-    int rows=companyBuffer.getSize();
+    int rows=my_egen->companyBuffer.getSize();
     for(int i=0; i<rows; i++){
-	PCOMPANY_ROW record = companyBuffer.get(i);
+	PCOMPANY_ROW record = my_egen->companyBuffer.get(i);
 	W_DO(_load_one_company(areprow, record));
+	progress_update(&my_egen->progress);
     }
 
     return (_pssm->commit_xct());
@@ -1546,11 +1575,11 @@ w_rc_t ShoreTPCEEnv::xct_populate_company(const int xct_id,
 
 void ShoreTPCEEnv::populate_company()
 {	
-    pGenerateAndLoad->InitCompany();
+    my_egen->gen->InitCompany();
     TRACE( TRACE_ALWAYS, "Building COMPANY  !!!\n");
-    while(companyBuffer.hasMoreToRead()){
+    while(my_egen->companyBuffer.hasMoreToRead()){
 	long log_space_needed = 0;
-	companyBuffer.reset();
+	my_egen->companyBuffer.reset();
 	_read_company();
 	populate_company_input_t in;
     retry:
@@ -1558,8 +1587,8 @@ void ShoreTPCEEnv::populate_company()
 	CHECK_XCT_RETURN(this->xct_populate_company(1, in),
 			 log_space_needed, retry, this);
     }
-    pGenerateAndLoad->ReleaseCompany();
-    companyBuffer.release();
+    my_egen->gen->ReleaseCompany();
+    my_egen->companyBuffer.release();
 }
 
 //COMPANY COMPETITOR
@@ -1572,10 +1601,11 @@ w_rc_t ShoreTPCEEnv::xct_populate_company_competitor(const int xct_id,
     rep_row_t areprow(_pcompany_competitor_man->ts());
     areprow.set(_pcompany_competitor_desc->maxsize());
 
-    int rows=companyCompetitorBuffer.getSize();
+    int rows=my_egen->companyCompetitorBuffer.getSize();
     for(int i=0; i<rows; i++){
-	PCOMPANY_COMPETITOR_ROW record = companyCompetitorBuffer.get(i);
+	PCOMPANY_COMPETITOR_ROW record = my_egen->companyCompetitorBuffer.get(i);
 	W_DO(_load_one_company_competitor(areprow, record));
+	progress_update(&my_egen->progress);
     }
 
     return (_pssm->commit_xct());
@@ -1583,11 +1613,11 @@ w_rc_t ShoreTPCEEnv::xct_populate_company_competitor(const int xct_id,
 
 void ShoreTPCEEnv::populate_company_competitor()
 {	
-    pGenerateAndLoad->InitCompanyCompetitor();
+    my_egen->gen->InitCompanyCompetitor();
     TRACE( TRACE_ALWAYS, "Building COMPANY COMPETITOR !!!\n");
-    while(companyCompetitorBuffer.hasMoreToRead()){
+    while(my_egen->companyCompetitorBuffer.hasMoreToRead()){
 	long log_space_needed = 0;
-	companyCompetitorBuffer.reset();
+	my_egen->companyCompetitorBuffer.reset();
 	_read_company_competitor();
 	populate_company_competitor_input_t in;
     retry:
@@ -1595,8 +1625,8 @@ void ShoreTPCEEnv::populate_company_competitor()
 	CHECK_XCT_RETURN(this->xct_populate_company_competitor(1, in),
 			 log_space_needed, retry, this);
     }
-    pGenerateAndLoad->ReleaseCompanyCompetitor();
-    companyCompetitorBuffer.release();
+    my_egen->gen->ReleaseCompanyCompetitor();
+    my_egen->companyCompetitorBuffer.release();
 }
 
 //COMPANY
@@ -1609,10 +1639,11 @@ w_rc_t ShoreTPCEEnv::xct_populate_daily_market(const int xct_id,
     rep_row_t areprow(_pdaily_market_man->ts());
     areprow.set(_pdaily_market_desc->maxsize());
 
-    int rows=dailyMarketBuffer.getSize();
+    int rows=my_egen->dailyMarketBuffer.getSize();
     for(int i=0; i<rows; i++){
-	PDAILY_MARKET_ROW record = dailyMarketBuffer.get(i);
+	PDAILY_MARKET_ROW record = my_egen->dailyMarketBuffer.get(i);
 	W_DO(_load_one_daily_market(areprow, record));
+	progress_update(&my_egen->progress);
     }
 
     return (_pssm->commit_xct());
@@ -1620,11 +1651,11 @@ w_rc_t ShoreTPCEEnv::xct_populate_daily_market(const int xct_id,
 
 void ShoreTPCEEnv::populate_daily_market()
 {	
-    pGenerateAndLoad->InitDailyMarket();
+    my_egen->gen->InitDailyMarket();
     TRACE( TRACE_ALWAYS, "DAILY_MARKET   !!!\n");
-    while(dailyMarketBuffer.hasMoreToRead()){
+    while(my_egen->dailyMarketBuffer.hasMoreToRead()){
 	long log_space_needed = 0;
-	dailyMarketBuffer.reset();
+	my_egen->dailyMarketBuffer.reset();
 	_read_daily_market();
 	populate_daily_market_input_t in;
     retry:
@@ -1632,8 +1663,8 @@ void ShoreTPCEEnv::populate_daily_market()
 	CHECK_XCT_RETURN(this->xct_populate_daily_market(1, in),
 			 log_space_needed, retry, this);
     }
-    pGenerateAndLoad->ReleaseDailyMarket();
-    dailyMarketBuffer.release();
+    my_egen->gen->ReleaseDailyMarket();
+    my_egen->dailyMarketBuffer.release();
 }
 
 //FINANCIAL
@@ -1646,10 +1677,11 @@ w_rc_t ShoreTPCEEnv::xct_populate_financial(const int xct_id,
     rep_row_t areprow(_pfinancial_man->ts());
     areprow.set(_pfinancial_desc->maxsize());
 
-    int rows=financialBuffer.getSize();
+    int rows=my_egen->financialBuffer.getSize();
     for(int i=0; i<rows; i++){
-	PFINANCIAL_ROW record = financialBuffer.get(i);
+	PFINANCIAL_ROW record = my_egen->financialBuffer.get(i);
 	W_DO(_load_one_financial(areprow, record));
+	progress_update(&my_egen->progress);
     }
 
     return (_pssm->commit_xct());
@@ -1657,11 +1689,11 @@ w_rc_t ShoreTPCEEnv::xct_populate_financial(const int xct_id,
 
 void ShoreTPCEEnv::populate_financial()
 {	
-    pGenerateAndLoad->InitFinancial();
+    my_egen->gen->InitFinancial();
     TRACE( TRACE_ALWAYS, "Building FINANCIAL  !!!\n");
-    while(financialBuffer.hasMoreToRead()){
+    while(my_egen->financialBuffer.hasMoreToRead()){
 	long log_space_needed = 0;
-	financialBuffer.reset();
+	my_egen->financialBuffer.reset();
 	_read_financial();
 	populate_financial_input_t in;
     retry:
@@ -1669,8 +1701,8 @@ void ShoreTPCEEnv::populate_financial()
 	CHECK_XCT_RETURN(this->xct_populate_financial(1, in),
 			 log_space_needed, retry, this);
     }
-    pGenerateAndLoad->ReleaseFinancial();
-    financialBuffer.release();
+    my_egen->gen->ReleaseFinancial();
+    my_egen->financialBuffer.release();
 }
 
 //SECURITY
@@ -1683,10 +1715,11 @@ w_rc_t ShoreTPCEEnv::xct_populate_security(const int xct_id,
     rep_row_t areprow(_psecurity_man->ts());
     areprow.set(_psecurity_desc->maxsize());
 
-    int rows=securityBuffer.getSize();
+    int rows=my_egen->securityBuffer.getSize();
     for(int i=0; i<rows; i++){
-	PSECURITY_ROW record = securityBuffer.get(i);
+	PSECURITY_ROW record = my_egen->securityBuffer.get(i);
 	W_DO(_load_one_security(areprow, record));
+	progress_update(&my_egen->progress);
     }
 
     return (_pssm->commit_xct());
@@ -1694,11 +1727,11 @@ w_rc_t ShoreTPCEEnv::xct_populate_security(const int xct_id,
 
 void ShoreTPCEEnv::populate_security()
 {	
-    pGenerateAndLoad->InitSecurity();
+    my_egen->gen->InitSecurity();
     TRACE( TRACE_ALWAYS, "Building SECURITY  !!!\n");
-    while(securityBuffer.hasMoreToRead()){
+    while(my_egen->securityBuffer.hasMoreToRead()){
 	long log_space_needed = 0;
-	securityBuffer.reset();
+	my_egen->securityBuffer.reset();
 	_read_security();
 	populate_security_input_t in;
     retry:
@@ -1706,8 +1739,8 @@ void ShoreTPCEEnv::populate_security()
 	CHECK_XCT_RETURN(this->xct_populate_security(1, in),
 			 log_space_needed, retry, this);
     }
-    pGenerateAndLoad->ReleaseSecurity();
-    securityBuffer.release();
+    my_egen->gen->ReleaseSecurity();
+    my_egen->securityBuffer.release();
 }
 
 //LAST_TRADE
@@ -1720,10 +1753,11 @@ w_rc_t ShoreTPCEEnv::xct_populate_last_trade(const int xct_id,
     rep_row_t areprow(_plast_trade_man->ts());
     areprow.set(_plast_trade_desc->maxsize());
 
-    int rows=lastTradeBuffer.getSize();
+    int rows=my_egen->lastTradeBuffer.getSize();
     for(int i=0; i<rows; i++){
-	PLAST_TRADE_ROW record = lastTradeBuffer.get(i);
+	PLAST_TRADE_ROW record = my_egen->lastTradeBuffer.get(i);
 	W_DO(_load_one_last_trade(areprow, record));
+	progress_update(&my_egen->progress);
     }
 
     return (_pssm->commit_xct());
@@ -1731,11 +1765,11 @@ w_rc_t ShoreTPCEEnv::xct_populate_last_trade(const int xct_id,
 
 void ShoreTPCEEnv::populate_last_trade()
 {	
-    pGenerateAndLoad->InitLastTrade();
+    my_egen->gen->InitLastTrade();
     TRACE( TRACE_ALWAYS, "Building LAST_TRADE  !!!\n");
-    while(lastTradeBuffer.hasMoreToRead()){
+    while(my_egen->lastTradeBuffer.hasMoreToRead()){
 	long log_space_needed = 0;
-	lastTradeBuffer.reset();
+	my_egen->lastTradeBuffer.reset();
 	_read_last_trade();
 	populate_last_trade_input_t in;
     retry:
@@ -1743,8 +1777,8 @@ void ShoreTPCEEnv::populate_last_trade()
 	CHECK_XCT_RETURN(this->xct_populate_last_trade(1, in),
 			 log_space_needed, retry, this);
     }
-    pGenerateAndLoad->ReleaseLastTrade();
-    lastTradeBuffer.release();
+    my_egen->gen->ReleaseLastTrade();
+    my_egen->lastTradeBuffer.release();
 }
 
 //Watch List and Watch Item
@@ -1757,15 +1791,17 @@ w_rc_t ShoreTPCEEnv::xct_populate_ni_and_nx(const int xct_id,
     rep_row_t areprow(_pnews_item_man->ts());
     areprow.set(_pnews_item_desc->maxsize());
 
-    int rows=newsXRefBuffer.getSize();
+    int rows=my_egen->newsXRefBuffer.getSize();
     for(int i=0; i<rows; i++){
-	PNEWS_XREF_ROW record = newsXRefBuffer.get(i);
+	PNEWS_XREF_ROW record = my_egen->newsXRefBuffer.get(i);
 	W_DO(_load_one_news_xref(areprow, record));
+	progress_update(&my_egen->progress);
     }
-    rows=newsItemBuffer.getSize();
+    rows=my_egen->newsItemBuffer.getSize();
     for(int i=0; i<rows; i++){
-	PNEWS_ITEM_ROW record = newsItemBuffer.get(i);
+	PNEWS_ITEM_ROW record = my_egen->newsItemBuffer.get(i);
 	W_DO(_load_one_news_item(areprow, record));
+	progress_update(&my_egen->progress);
     }
 
     return (_pssm->commit_xct());
@@ -1773,12 +1809,12 @@ w_rc_t ShoreTPCEEnv::xct_populate_ni_and_nx(const int xct_id,
 
 void ShoreTPCEEnv::populate_ni_and_nx()
 {	
-    pGenerateAndLoad->InitNewsItemAndNewsXRef();
+    my_egen->gen->InitNewsItemAndNewsXRef();
     TRACE( TRACE_ALWAYS, "Building NEWS_ITEM and NEWS_XREF !!!\n");
-    while(newsItemBuffer.hasMoreToRead()){
+    while(my_egen->newsItemBuffer.hasMoreToRead()){
 	long log_space_needed = 0;
-	newsItemBuffer.reset();
-	newsXRefBuffer.reset();
+	my_egen->newsItemBuffer.reset();
+	my_egen->newsXRefBuffer.reset();
 	_read_ni_and_nx();
 	populate_ni_and_nx_input_t in;
     retry:
@@ -1786,9 +1822,9 @@ void ShoreTPCEEnv::populate_ni_and_nx()
 	CHECK_XCT_RETURN(this->xct_populate_ni_and_nx(1, in),
 			 log_space_needed, retry, this);
     }
-    pGenerateAndLoad->ReleaseNewsItemAndNewsXRef();
-    newsItemBuffer.release();
-    newsXRefBuffer.release();
+    my_egen->gen->ReleaseNewsItemAndNewsXRef();
+    my_egen->newsItemBuffer.release();
+    my_egen->newsXRefBuffer.release();
 }
 
 //populating growing tables
@@ -1801,30 +1837,35 @@ w_rc_t ShoreTPCEEnv::xct_populate_unit_trade(const int xct_id,
     rep_row_t areprow(_pnews_item_man->ts());
     areprow.set(_pnews_item_desc->maxsize());
 
-    int rows=tradeBuffer.getSize();
+    int rows=my_egen->tradeBuffer.getSize();
     for(int i=0; i<rows; i++){
-	PTRADE_ROW record = tradeBuffer.get(i);
+	PTRADE_ROW record = my_egen->tradeBuffer.get(i);
 	W_DO(_load_one_trade(areprow, record));
+	progress_update(&my_egen->progress);
     }
-    rows=tradeHistoryBuffer.getSize();
+    rows=my_egen->tradeHistoryBuffer.getSize();
     for(int i=0; i<rows; i++){
-	PTRADE_HISTORY_ROW record = tradeHistoryBuffer.get(i);
+	PTRADE_HISTORY_ROW record = my_egen->tradeHistoryBuffer.get(i);
 	W_DO(_load_one_trade_history(areprow, record));
+	progress_update(&my_egen->progress);
     }
-    rows=settlementBuffer.getSize();
+    rows=my_egen->settlementBuffer.getSize();
     for(int i=0; i<rows; i++){
-	PSETTLEMENT_ROW record = settlementBuffer.get(i);
+	PSETTLEMENT_ROW record = my_egen->settlementBuffer.get(i);
 	W_DO(_load_one_settlement(areprow, record));
+	progress_update(&my_egen->progress);
     }
-    rows=cashTransactionBuffer.getSize();
+    rows=my_egen->cashTransactionBuffer.getSize();
     for(int i=0; i<rows; i++){
-	PCASH_TRANSACTION_ROW record = cashTransactionBuffer.get(i);
+	PCASH_TRANSACTION_ROW record = my_egen->cashTransactionBuffer.get(i);
 	W_DO(_load_one_cash_transaction(areprow, record));
+	progress_update(&my_egen->progress);
     }
-    rows=holdingHistoryBuffer.getSize();
+    rows=my_egen->holdingHistoryBuffer.getSize();
     for(int i=0; i<rows; i++){
-	PHOLDING_HISTORY_ROW record = holdingHistoryBuffer.get(i);
+	PHOLDING_HISTORY_ROW record = my_egen->holdingHistoryBuffer.get(i);
 	W_DO(_load_one_holding_history(areprow, record));
+	progress_update(&my_egen->progress);
     }
 
     return (_pssm->commit_xct());
@@ -1840,10 +1881,11 @@ w_rc_t ShoreTPCEEnv::xct_populate_broker(const int xct_id,
     rep_row_t areprow(_pbroker_man->ts());
     areprow.set(_pbroker_desc->maxsize());
 
-    int rows=brokerBuffer.getSize();
+    int rows=my_egen->brokerBuffer.getSize();
     for(int i=0; i<rows; i++){
-	PBROKER_ROW record = brokerBuffer.get(i);
+	PBROKER_ROW record = my_egen->brokerBuffer.get(i);
 	W_DO(_load_one_broker(areprow, record));
+	progress_update(&my_egen->progress);
     }
 
     return (_pssm->commit_xct());
@@ -1851,9 +1893,9 @@ w_rc_t ShoreTPCEEnv::xct_populate_broker(const int xct_id,
 
 void ShoreTPCEEnv::populate_broker()
 {	
-    while(brokerBuffer.hasMoreToRead()) {
+    while(my_egen->brokerBuffer.hasMoreToRead()) {
 	long log_space_needed = 0;
-	brokerBuffer.reset();
+	my_egen->brokerBuffer.reset();
 	_read_broker();
 	populate_broker_input_t in;
     retry:
@@ -1873,10 +1915,11 @@ w_rc_t ShoreTPCEEnv::xct_populate_holding_summary(const int xct_id,
     rep_row_t areprow(_pholding_summary_man->ts());
     areprow.set(_pholding_summary_desc->maxsize());
 
-    int rows=holdingSummaryBuffer.getSize();
+    int rows=my_egen->holdingSummaryBuffer.getSize();
     for(int i=0; i<rows; i++){
-	PHOLDING_SUMMARY_ROW record = holdingSummaryBuffer.get(i);
+	PHOLDING_SUMMARY_ROW record = my_egen->holdingSummaryBuffer.get(i);
 	W_DO(_load_one_holding_summary(areprow, record));
+	progress_update(&my_egen->progress);
     }
 
     return (_pssm->commit_xct());
@@ -1884,9 +1927,9 @@ w_rc_t ShoreTPCEEnv::xct_populate_holding_summary(const int xct_id,
 
 void ShoreTPCEEnv::populate_holding_summary()
 {	
-    while(holdingSummaryBuffer.hasMoreToRead()){
+    while(my_egen->holdingSummaryBuffer.hasMoreToRead()){
 	long log_space_needed = 0;
-	holdingSummaryBuffer.reset();
+	my_egen->holdingSummaryBuffer.reset();
 	_read_holding_summary();
 	populate_holding_summary_input_t in;
     retry:
@@ -1906,10 +1949,11 @@ w_rc_t ShoreTPCEEnv::xct_populate_holding(const int xct_id,
     rep_row_t areprow(_pholding_man->ts());
     areprow.set(_pholding_desc->maxsize());
 
-    int rows=holdingBuffer.getSize();
+    int rows=my_egen->holdingBuffer.getSize();
     for(int i=0; i<rows; i++){
-	PHOLDING_ROW record = holdingBuffer.get(i);
+	PHOLDING_ROW record = my_egen->holdingBuffer.get(i);
 	W_DO(_load_one_holding(areprow, record));
+	progress_update(&my_egen->progress);
     }
 
     return (_pssm->commit_xct());
@@ -1917,9 +1961,9 @@ w_rc_t ShoreTPCEEnv::xct_populate_holding(const int xct_id,
 
 void ShoreTPCEEnv::populate_holding()
 {	
-    while(holdingBuffer.hasMoreToRead()){
+    while(my_egen->holdingBuffer.hasMoreToRead()){
 	long log_space_needed = 0;
-	holdingBuffer.reset();
+	my_egen->holdingBuffer.reset();
 	_read_holding();
 	populate_holding_input_t in;
     retry:
@@ -1931,13 +1975,13 @@ void ShoreTPCEEnv::populate_holding()
 
 void ShoreTPCEEnv::populate_unit_trade()
 {
-     while(tradeBuffer.hasMoreToRead()){
+     while(my_egen->tradeBuffer.hasMoreToRead()){
 	long log_space_needed = 0;
-	tradeBuffer.reset();
-	tradeHistoryBuffer.reset();
-	settlementBuffer.reset();
-	cashTransactionBuffer.reset();
-	holdingHistoryBuffer.reset();
+	my_egen->tradeBuffer.reset();
+	my_egen->tradeHistoryBuffer.reset();
+	my_egen->settlementBuffer.reset();
+	my_egen->cashTransactionBuffer.reset();
+	my_egen->holdingHistoryBuffer.reset();
 	_read_trade_unit();
 	printf("\n\n Populating trade unit\n\n" );
 	populate_unit_trade_input_t in;
@@ -1950,7 +1994,7 @@ void ShoreTPCEEnv::populate_unit_trade()
 
 void ShoreTPCEEnv::populate_growing()
 {	
-    pGenerateAndLoad->InitHoldingAndTrade();
+    my_egen->gen->InitHoldingAndTrade();
     TRACE( TRACE_ALWAYS, "Building growing tables  !!!\n");
     int cnt =0;
     do {
@@ -1959,24 +2003,24 @@ void ShoreTPCEEnv::populate_growing()
 	populate_holding_summary();
 	populate_holding();
 	printf("\nload unit %d\n",++cnt);
-	tradeBuffer.newLoadUnit();
-	tradeHistoryBuffer.newLoadUnit();
-	settlementBuffer.newLoadUnit();
-	cashTransactionBuffer.newLoadUnit();
-	holdingHistoryBuffer.newLoadUnit();
-	brokerBuffer.newLoadUnit();
-	holdingSummaryBuffer.newLoadUnit();
-	holdingBuffer.newLoadUnit();	
-    } while(pGenerateAndLoad->hasNextLoadUnit());
-    pGenerateAndLoad->ReleaseHoldingAndTrade();
-    tradeBuffer.release();
-    tradeHistoryBuffer.release();
-    settlementBuffer.release();
-    cashTransactionBuffer.release();
-    holdingHistoryBuffer.release();
-    brokerBuffer.release();
-    holdingSummaryBuffer.release();
-    holdingBuffer.release();
+	my_egen->tradeBuffer.newLoadUnit();
+	my_egen->tradeHistoryBuffer.newLoadUnit();
+	my_egen->settlementBuffer.newLoadUnit();
+	my_egen->cashTransactionBuffer.newLoadUnit();
+	my_egen->holdingHistoryBuffer.newLoadUnit();
+	my_egen->brokerBuffer.newLoadUnit();
+	my_egen->holdingSummaryBuffer.newLoadUnit();
+	my_egen->holdingBuffer.newLoadUnit();	
+    } while(my_egen->gen->hasNextLoadUnit());
+    my_egen->gen->ReleaseHoldingAndTrade();
+    my_egen->tradeBuffer.release();
+    my_egen->tradeHistoryBuffer.release();
+    my_egen->settlementBuffer.release();
+    my_egen->cashTransactionBuffer.release();
+    my_egen->holdingHistoryBuffer.release();
+    my_egen->brokerBuffer.release();
+    my_egen->holdingSummaryBuffer.release();
+    my_egen->holdingBuffer.release();
 }
 
 w_rc_t ShoreTPCEEnv::xct_find_maxtrade_id(const int xct_id,
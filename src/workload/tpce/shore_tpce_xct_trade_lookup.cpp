@@ -110,7 +110,26 @@ w_rc_t ShoreTPCEEnv::xct_trade_lookup(const int xct_id,
     //BEGIN FRAME1
     int num_found = 0;
     if(ptlin._frame_to_execute == 1) {	
+	// the trades and their settlements are probed in one batch each
+	tuple_batch_guard<trade_man_impl> prtrades(_ptrade_man, max_trades);
+	tuple_batch_guard<settlement_man_impl> prsettlements(_psettlement_man, max_trades);
+	prtrades.set_rep(&areprow);
+	prsettlements.set_rep(&areprow);
+
+	TRACE( TRACE_TRX_FLOW, "App: %d TL:t-idx-probe-batch (%d) \n",
+	       xct_id, max_trades);
+	W_DO(_ptrade_man->t_index_probe_batch(_pssm, prtrades,
+					      ptlin._trade_id, max_trades));
+
+	TRACE( TRACE_TRX_FLOW, "App: %d TL:se-idx-probe-batch (%d) \n",
+	       xct_id, max_trades);
+	W_DO(_psettlement_man->se_index_probe_batch(_pssm, prsettlements,
+						    ptlin._trade_id, max_trades));
+
 	for (num_found = 0; num_found < max_trades; num_found++){
+	    table_row_t* prtrade = prtrades[num_found];
+	    table_row_t* prsettlement = prsettlements[num_found];
+
 	    /**
 	     *	select
 	     *		bid_price[i] = T_BID_PRICE,
@@ -125,11 +144,6 @@ w_rc_t ShoreTPCEEnv::xct_trade_lookup(const int xct_id,
 	     *		T_ID = trade_id[i] and
 	     *		T_TT_ID = TT_ID
 	     */		
-	    TRACE( TRACE_TRX_FLOW, "App: %d TL:t-idx-probe (%ld) \n",
-		   xct_id, ptlin._trade_id[num_found]);
-	    W_DO(_ptrade_man->t_index_probe(_pssm, prtrade,
-					    ptlin._trade_id[num_found]));
-
 	    prtrade->get_value(4, is_cash[num_found]);
 	    prtrade->get_value(7, bid_price[num_found]);
 	    prtrade->get_value(9, exec_name[num_found], 50); //49
@@ -152,11 +166,6 @@ w_rc_t ShoreTPCEEnv::xct_trade_lookup(const int xct_id,
 	     *	where
 	     *		SE_T_ID = trade_id[i]
 	     */	    
-	    TRACE( TRACE_TRX_FLOW, "App: %d TL:se-idx-probe (%ld) \n",
-		   xct_id, ptlin._trade_id[num_found]);
-	    W_DO(_psettlement_man->se_index_probe(_pssm, prsettlement,
-						  ptlin._trade_id[num_found]));
-
 	    prsettlement->get_value(3, settlement_amount[num_found]);
 	    prsettlement->get_value(2, settlement_cash_due_date[num_found]);
 	    prsettlement->get_value(1, settlement_cash_type[num_found], 41); //40
@@ -274,6 +283,13 @@ w_rc_t ShoreTPCEEnv::xct_trade_lookup(const int xct_id,
 	    W_DO(t_iter->next(_pssm, eof, *prtrade));
 	}
 	
+	tuple_batch_guard<settlement_man_impl> prsettlements(_psettlement_man, num_found);
+	prsettlements.set_rep(&areprow);
+	TRACE( TRACE_TRX_FLOW, "App: %d TL:se-idx-probe-batch (%d) \n",
+	       xct_id, num_found);
+	W_DO(_psettlement_man->se_index_probe_batch(_pssm, prsettlements,
+						    trade_list, num_found));
+
 	for(int i = 0; i < num_found; i++) {
 	    /**
 	     *	select
@@ -285,10 +301,7 @@ w_rc_t ShoreTPCEEnv::xct_trade_lookup(const int xct_id,
 	     *	where
 	     *		SE_T_ID = trade_list[i]
 	     */
-	    TRACE( TRACE_TRX_FLOW, "App: %d TL:se-idx-probe (%ld) \n",
-		   xct_id, trade_list[i]);
-	    W_DO(_psettlement_man->se_index_probe(_pssm, prsettlement,
-						  trade_list[i]));
+	    table_row_t* prsettlement = prsettlements[i];
 
 	    prsettlement->get_value(3, settlement_amount[i]);
 	    prsettlement->get_value(2, settlement_cash_due_date[i]);
@@ -408,6 +421,13 @@ w_rc_t ShoreTPCEEnv::xct_trade_lookup(const int xct_id,
 	    W_DO(t_iter->next(_pssm, eof, *prtrade));
 	}
 	
+	tuple_batch_guard<settlement_man_impl> prsettlements(_psettlement_man, num_found);
+	prsettlements.set_rep(&areprow);
+	TRACE( TRACE_TRX_FLOW, "TL: %d SE:se-idx-probe-batch (%d) \n",
+	       xct_id, num_found);
+	W_DO(_psettlement_man->se_index_probe_batch(_pssm, prsettlements,
+						    trade_list, num_found));
+
 	for(int i = 0; i < num_found; i++){
 	    /**
 	     *	select
@@ -419,11 +439,8 @@ w_rc_t ShoreTPCEEnv::xct_trade_lookup(const int xct_id,
 	     *	where
 	     *		SE_T_ID = trade_list[i]
 	     */
-	    TRACE( TRACE_TRX_FLOW, "TL: %d SE:se-idx-probe (%ld) \n",
-		   xct_id, trade_list[i]);
-	    W_DO(_psettlement_man->se_index_probe(_pssm, prsettlement,
-						  trade_list[i]));
-		
+	    table_row_t* prsettlement = prsettlements[i];
+
 	    prsettlement->get_value(1, settlement_cash_type[i], 41); //40
 	    prsettlement->get_value(3, settlement_amount[i]);
 	    prsettlement->get_value(2, settlement_cash_due_date[i]);
@@ -537,34 +537,12 @@ w_rc_t ShoreTPCEEnv::xct_trade_order(const int xct_id, trade_order_input_t& ptoi
      *		CR_FROM_QTY <= trade_qty and
      *		CR_TO_QTY >= trade_qty
      */
-    guard< index_scan_iter_impl<commission_rate_t> > cr_iter;
-    {
-	index_scan_iter_impl<commission_rate_t>* tmp_cr_iter;
-	TRACE(TRACE_TRX_FLOW, "App: %d TR:cr-iter-by-idx (%d) (%s) (%s) (%d)\n",
-	      xct_id, cust_tier, ptoin._trade_type_id, exch_id, ptoin._trade_qty);
-	W_DO(_pcommission_rate_man->cr_get_iter_by_index(_pssm, tmp_cr_iter,
-							 prcommrate, lowrep,
-							 highrep, cust_tier,
-							 ptoin._trade_type_id,
-							 exch_id,
-							 ptoin._trade_qty));
-	cr_iter = tmp_cr_iter;
-    }
-
-    TRACE( TRACE_TRX_FLOW, "App: %d TO:cr-iter-next \n", xct_id);
-    W_DO(cr_iter->next(_pssm, eof, *prcommrate));
-    while (!eof) {
-	int to_qty;
-	prcommrate->get_value(4, to_qty);
-	
-	if(to_qty >= ptoin._trade_qty){
-	    prcommrate->get_value(5, comm_rate);
-	    break;
-	}
-	
-	TRACE( TRACE_TRX_FLOW, "App: %d TO:cr-iter-next \n", xct_id);
-	W_DO(cr_iter->next(_pssm, eof, *prcommrate));	
-    }
+    TRACE( TRACE_TRX_FLOW, "App: %d TO:cr-get-rate (%d) (%s) (%s) (%d)\n",
+	   xct_id, cust_tier, ptoin._trade_type_id, exch_id, ptoin._trade_qty);
+    W_DO(_pcommission_rate_man->cr_get_rate(_pssm, prcommrate, lowrep, highrep,
+					    cust_tier, ptoin._trade_type_id,
+					    exch_id, ptoin._trade_qty,
+					    comm_rate));
     
     /**
      *
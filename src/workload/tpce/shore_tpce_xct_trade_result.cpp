@@ -853,29 +853,11 @@ w_rc_t ShoreTPCEEnv::xct_trade_result(const int xct_id,
      *	WHERE	CR_C_TIER = c_tier and CR_TT_ID = type_id and CR_EX_ID = s_ex_id
      *	        and CR_FROM_QTY <= trade_qty and CR_TO_QTY >= trade_qty
      */
-    guard< index_scan_iter_impl<commission_rate_t> > cr_iter;
-    {
-	index_scan_iter_impl<commission_rate_t>* tmp_cr_iter;
-	TRACE( TRACE_TRX_FLOW, "App: %d TR:cr-iter-by-idx (%d) (%s) (%ld) (%d) \n",
-	       xct_id, c_tier, type_id, s_ex_id, trade_qty);
-	W_DO(_pcommission_rate_man->cr_get_iter_by_index(_pssm, tmp_cr_iter,
-							 prcommissionrate, lowrep,
-							 highrep, c_tier, type_id,
-							 s_ex_id, trade_qty));
-	cr_iter = tmp_cr_iter;
-    }
-    TRACE( TRACE_TRX_FLOW, "App: %d TR:cr-iter-next \n", xct_id);
-    W_DO(cr_iter->next(_pssm, eof, *prcommissionrate));
-    while (!eof) {			  
-	int to_qty;
-	prcommissionrate->get_value(4, to_qty);
-	if(to_qty >= trade_qty){				
-	    prcommissionrate->get_value(5, comm_rate);
-	    break;
-	}
-	TRACE( TRACE_TRX_FLOW, "App: %d TR:cr-iter-next \n", xct_id);
-	W_DO(cr_iter->next(_pssm, eof, *prcommissionrate));
-    }
+    TRACE( TRACE_TRX_FLOW, "App: %d TR:cr-get-rate (%d) (%s) (%s) (%d) \n",
+	   xct_id, c_tier, type_id, s_ex_id, trade_qty);
+    W_DO(_pcommission_rate_man->cr_get_rate(_pssm, prcommissionrate, lowrep,
+					    highrep, c_tier, type_id,
+					    s_ex_id, trade_qty, comm_rate));
     //END FRAME4
     assert(comm_rate > 0.00);  //Harness control
 
@@ -401,7 +401,7 @@ struct q11_aggregate_t : public tuple_aggregate_t {
 		return new q11_aggregate_t(*this);
 	}
 	virtual c_str to_string() const {
-		return "q11_aggregate_t";
+		return c_str("q11_aggregate_t(%d)", _subQuery);
 	}
 };
 
@@ -468,7 +468,7 @@ struct q11_threshold_filter_t : public tuple_filter_t
 	}
 
 	virtual c_str to_string() const {
-		return c_str("q11_threshold_filter_t");
+		return c_str("q11_threshold_filter_t(%.6f)", _fraction);
 	}
 };
 
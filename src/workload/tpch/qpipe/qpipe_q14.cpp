@@ -30,7 +30,7 @@
  */
 
 #include "workload/tpch/shore_tpch_env.h"
-//#include "qpipe/common/predicates.h"
+#include "qpipe/common/predicates.h"
 //#include "workload/tpch/tpch_struct.h"
 #include "workload/tpch/tpch_util.h"
 #include "qpipe.h"
@@ -85,186 +85,126 @@ struct q14_tuple {
     double PROMO_REVENUE;
 };
 
+// The Q14 shipdate range, as 'YYYY-MM-DD' strings: [date1, date2)
+static void q14_shipdates(const q14_input_t& in, char* date1, char* date2)
+{
+    timet_to_str(date1, in.l_shipdate);
+    timet_to_str(date2, time_add_month(in.l_shipdate, 1));
+    date1[10] = date2[10] = '\0'; // YYYY-MM-DD
+}
+
+static c_str q14_lineitem_filter_name(const q14_input_t& in)
+{
+    char date1[15];
+    char date2[15];
+    q14_shipdates(in, date1, date2);
+    return (c_str("select L_EXTENDEDPRICE, L_DISCOUNT, L_PARTKEY "
+                  "where L_SHIPDATE >= %s and L_SHIPDATE < %s",
+                  date1, date2));
+}
+
 /**
  * @brief select L_PARTKEY, L_EXTENDEDPRICE, L_DISCOUNT from LINEITEM
  * where L_SHIPDATE >= [date] and L_SHIPDATE < [date] + 1 month
+ *
+ * The shipdates are compared on the records, a page at a time, and
+ * the projection reads its fields off the record.
  */
-class q14_lineitem_tscan_filter_t : public tuple_filter_t 
+class q14_lineitem_tscan_filter_t : public predicate_filter_t 
 {
 private:
-    ShoreTPCHEnv* _tpchdb;
-    table_row_t* _prline;
-    rep_row_t _rr;
-
-    /*One lineitem tuple*/
-    tpch_lineitem_tuple _lineitem;
-    /*The columns needed for the selection*/
-    time_t _shipdate;
+    size_t _partkey;
+    size_t _extendedprice;
+    size_t _discount;
 
-  //and_predicate_t _filter;
+    static predicate_t* _predicate(table_desc_t* plineitem,
+                                   const q14_input_t& in)
+    {
+        char date1[15];
+        char date2[15];
+        q14_shipdates(in, date1, date2);
+        return (new fixchar_range_predicate_t(date1, date2,
+                                              plineitem->disk_offset(10)));
+    }
 
-    /* Random Predicates */
-    q14_input_t* q14_input;
-    time_t date1, date2;
 public:
     q14_lineitem_tscan_filter_t(ShoreTPCHEnv* tpchdb, q14_input_t &in)
-        : tuple_filter_t(tpchdb->lineitem_desc()->maxsize()), _tpchdb(tpchdb)
+        : predicate_filter_t(tpchdb->lineitem_desc()->maxsize(),
+                             _predicate(tpchdb->lineitem_desc(), in),
+                             q14_lineitem_filter_name(in)),
+          _partkey(tpchdb->lineitem_desc()->disk_offset(1)),
+          _extendedprice(tpchdb->lineitem_desc()->disk_offset(5)),
+          _discount(tpchdb->lineitem_desc()->disk_offset(6))
     {
-   	// Get a lineitem tupple from the tuple cache and allocate space
-        _prline = _tpchdb->lineitem_man()->get_tuple();
-        _rr.set_ts(_tpchdb->lineitem_man()->ts(),
-                   _tpchdb->lineitem_desc()->maxsize());
-        _prline->_rep = &_rr;
-
-      //size_t offset = offsetof(tpch_lineitem_tuple, L_SHIPDATE);
-      //predicate_t* p;
-
-        // L_SHIPDATE >= [date]
-	
-	q14_input=&in;
-        date1 = q14_input->l_shipdate;
-	// L_SHIPDATE < [date] + 1 month
-        date2 = time_add_month(date1, 1);
-
         char shdate1[15];
         char shdate2[15];
-
-        timet_to_str(shdate1, date1);
-        timet_to_str(shdate2, date2);
-
+        q14_shipdates(in, shdate1, shdate2);
         TRACE(TRACE_ALWAYS, "Random predicates:\n%s <= L_SHIPDATE < %s\n", shdate1, shdate2);
-
-        //p = new scalar_predicate_t<time_t, greater_equal>(date1, offset);
-        //_filter.add(p);
-
-        // L_SHIPDATE < [date] + 1 month
-        //date2 = time_add_month(date1, 1);
-        //p = new scalar_predicate_t<time_t, less>(date2, offset);
-        //_filter.add(p);
-    }
-
-    ~q14_lineitem_tscan_filter_t()
-    {
-        // Give back the lineitem tuple
-        _tpchdb->lineitem_man()->give_tuple(_prline);
     }
 
     virtual void project(tuple_t &d, const tuple_t &s) {
         q14_lineitem_scan_tuple *dest;
         dest = aligned_cast<q14_lineitem_scan_tuple>(d.data);
 
-        _prline->get_value(1, _lineitem.L_PARTKEY);
-        _prline->get_value(5, _lineitem.L_EXTENDEDPRICE);
-        _prline->get_value(6, _lineitem.L_DISCOUNT);
-
-        /*TRACE( TRACE_RECORD_FLOW, "%d %.2f|%.2f\n",
-               _lineitem.L_PARTKEY,
-               _lineitem.L_EXTENDEDPRICE / 100.0,
-               _lineitem.L_DISCOUNT / 100.0);*/
-
-        dest->L_PARTKEY=_lineitem.L_PARTKEY;
-        dest->L_EXTENDEDPRICE = _lineitem.L_EXTENDEDPRICE/100.0;
-        dest->L_DISCOUNT = _lineitem.L_DISCOUNT/100.0;
+        dest->L_PARTKEY = load_field<int>(s.data + _partkey);
+        dest->L_EXTENDEDPRICE = load_field<double>(s.data + _extendedprice)/100.0;
+        dest->L_DISCOUNT = load_field<double>(s.data + _discount)/100.0;
 #warning MA: Discount from TPCH dbgen is created between 0 and 100 instead between 0 and 1.
     }
 
-    virtual bool select(const tuple_t &t) 
-    {
-        if (!_tpchdb->lineitem_man()->load(_prline, t.data)) {
-            assert(false); // RC(se_WRONG_DISK_DATA)
-        }
-
-	_prline->get_value(10, _lineitem.L_SHIPDATE, 15);
-	_shipdate = str_to_timet(_lineitem.L_SHIPDATE);
-
-	if (_shipdate>=date1 && _shipdate<date2)
-	  {
-	    return (true);
-	  }
-	else
-	  {
-	    return (false);
-	  }
-
-    }
     virtual q14_lineitem_tscan_filter_t* clone() const {
         return new q14_lineitem_tscan_filter_t(*this);
     }
-    virtual c_str to_string() const {
-      char* d1=new char[15];
-      char* d2=new char[15];
-      timet_to_str(d1,date1);
-      timet_to_str(d2,date2);
-        c_str result("select L_EXTENDEDPRICE, L_DISCOUNT, L_PARTKEY "
-                     "where L_SHIPDATE >= %s and L_SHIPDATE < %s",
-                     d1, d2);
-        free(d1);
-        free(d2);
-        return result;
-    }
 };
 
 
+// The shipdate range of the lineitem scan, pushed down to the zone
+// maps. The filter re-checks the rows.
+static vector<column_pred_t> q14_lineitem_preds(const q14_input_t& in)
+{
+    char date1[15];
+    char date2[15];
+    q14_shipdates(in, date1, date2);
+
+    vector<column_pred_t> preds;
+    preds.push_back(column_pred_t(10).ge(date1).lt(date2));
+    return (preds);
+}
+
+
 /**
  * @brief select P_PARTKEY, P_TYPE from PART
+ *
+ * There is no selection (the empty conjunction selects every row), 
+ * the projection reads the two fields off the record.
  */
-class q14_part_tscan_filter_t : public tuple_filter_t 
+class q14_part_tscan_filter_t : public predicate_filter_t 
 {
 private:
-    ShoreTPCHEnv* _tpchdb;
-    table_row_t* _prpart;
-    rep_row_t _rr;
-
-    /*One lineitem tuple*/
-    tpch_part_tuple _part;
+    size_t _partkey;
+    size_t _type;
 public:
     q14_part_tscan_filter_t(ShoreTPCHEnv* tpchdb)
-        : tuple_filter_t(tpchdb->part_desc()->maxsize()), _tpchdb(tpchdb)
+        : predicate_filter_t(tpchdb->part_desc()->maxsize(),
+                             new and_predicate_t(),
+                             "select P_PARTKEY, P_TYPE"),
+          _partkey(tpchdb->part_desc()->disk_offset(0)),
+          _type(tpchdb->part_desc()->disk_offset(4))
     {
-   	// Get a lineitem tupple from the tuple cache and allocate space
-        _prpart = _tpchdb->part_man()->get_tuple();
-        _rr.set_ts(_tpchdb->part_man()->ts(),
-                   _tpchdb->part_desc()->maxsize());
-        _prpart->_rep = &_rr;
-    }
-
-    ~q14_part_tscan_filter_t()
-    {
-        // Give back the lineitem tuple
-        _tpchdb->part_man()->give_tuple(_prpart);
     }
 
     virtual void project(tuple_t &d, const tuple_t &s) {
         q14_part_scan_tuple *dest;
         dest = aligned_cast<q14_part_scan_tuple>(d.data);
 
-        _prpart->get_value(0, _part.P_PARTKEY);
-        _prpart->get_value(4, _part.P_TYPE, 25);
-
-        /*TRACE( TRACE_RECORD_FLOW, "%d %s\n",
-               _part.P_PARTKEY,
-               _part.P_TYPE);*/
-
-        dest->P_PARTKEY=_part.P_PARTKEY;
-	memcpy(dest->P_TYPE, _part.P_TYPE, sizeof(dest->P_TYPE));
-    }
-
-    virtual bool select(const tuple_t &t) 
-    {
-        if (!_tpchdb->part_man()->load(_prpart, t.data)) {
-            assert(false); // RC(se_WRONG_DISK_DATA)
-        }
-
-	return (true);
+        dest->P_PARTKEY = load_field<int>(s.data + _partkey);
+        memcpy(dest->P_TYPE, s.data + _type, sizeof(dest->P_TYPE) - 1);
+        dest->P_TYPE[sizeof(dest->P_TYPE) - 1] = '\0';
     }
 
     virtual q14_part_tscan_filter_t* clone() const {
         return new q14_part_tscan_filter_t(*this);
     }
-    virtual c_str to_string() const {
-      c_str result("select L_EXTENDEDPRICE, L_DISCOUNT, L_PARTKEY ");
-        return result;
-    }
 };
 
 //Join
@@ -318,12 +258,12 @@ struct q14_join : tuple_join_t {
  */
 struct q14_aggregate : tuple_aggregate_t {
     default_key_extractor_t _extractor;
-    //like_predicate_t _filter;
+    like_predicate_t _filter;
 
     q14_aggregate()
         : tuple_aggregate_t(sizeof(q14_tuple)),
-          _extractor(0, 0)//,
-          //_filter("PROMO%", offsetof(join_tuple, P_TYPE))
+          _extractor(0, 0),
+          _filter("PROMO%", offsetof(q14_join_tuple, P_TYPE))
     {
     }
 
@@ -336,8 +276,7 @@ struct q14_aggregate : tuple_aggregate_t {
 
         double value = tuple->L_EXTENDEDPRICE*(1 - tuple->L_DISCOUNT);
         agg->TOTAL_SUM += value;
-        //if(_filter.select(t))
-	if (strstr(tuple->P_TYPE,"PROMO"))
+        if(_filter.select(t))
 	{
 	    //TRACE ( TRACE_ALWAYS, "%s\n",tuple->P_TYPE);
 	    agg->PROMO_SUM += value;
@@ -395,6 +334,8 @@ w_rc_t ShoreTPCHEnv::xct_qpipe_q14(const int xct_id,
                                          pxct
                                          //, SH
                                          );
+    q14_tscan_lineitem_packet->where(q14_lineitem_preds(in));
+    q14_tscan_lineitem_packet->use_zones(_plineitem_man->zonemaps());
 
     //part scan
     tuple_fifo* q14_tscan_part_out = new tuple_fifo(sizeof(q14_part_scan_tuple));
@@ -187,6 +187,27 @@ public:
 };
 
 
+// The shipdate range of the lineitem scan, pushed down to the zone
+// maps. The last day is included, the filter re-checks the rows.
+static vector<column_pred_t> q15_lineitem_preds(const q15_input_t& in)
+{
+	time_t firstdate = in.l_shipdate;
+	struct tm *tm = gmtime(&firstdate);
+	tm->tm_mon += 3;
+	time_t lastdate = mktime(tm);
+
+	char date1[15];
+	char date2[15];
+	timet_to_str(date1, firstdate);
+	timet_to_str(date2, lastdate);
+	date1[10] = date2[10] = '\0'; // YYYY-MM-DD
+
+	vector<column_pred_t> preds;
+	preds.push_back(column_pred_t(10).ge(date1).le(date2));
+	return (preds);
+}
+
+
 class q15_supplier_tscan_filter_t : public tuple_filter_t
 {
 private:
@@ -421,13 +442,15 @@ w_rc_t ShoreTPCHEnv::xct_qpipe_q15(const int xct_id,
 
 	//TSCAN LINEITEM
 	tuple_fifo* q15_lineitem_buffer = new tuple_fifo(sizeof(q15_projected_lineitem_tuple));
-	packet_t* q15_lineitem_tscan_packet =
+	tscan_packet_t* q15_lineitem_tscan_packet =
 			new tscan_packet_t("lineitem TSCAN",
 					q15_lineitem_buffer,
 					new q15_lineitem_tscan_filter_t(this, in),
 					this->db(),
 					_plineitem_desc.get(),
 					pxct);
+	q15_lineitem_tscan_packet->where(q15_lineitem_preds(in));
+	q15_lineitem_tscan_packet->use_zones(_plineitem_man->zonemaps());
 
 	//AGGREGATE: GROUP BY L_SUPPKEY, SUM
 	tuple_fifo* q15_l_agg_buffer = new tuple_fifo(sizeof(q15_projected_lineitem_tuple));
@@ -421,7 +421,7 @@ struct q18_qty_filter_t : public tuple_filter_t {
 	}
 
 	virtual c_str to_string() const {
-		return c_str("q18_qty_filter_t");
+		return c_str("q18_qty_filter_t(%.2f)", _quantity.to_double());
 	}
 };
 
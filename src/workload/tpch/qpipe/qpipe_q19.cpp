@@ -205,7 +205,7 @@ public:
 	}
 
 	c_str to_string() const {
-		return c_str("q19_part_tscan_filter_t()");
+		return c_str("q19_part_tscan_filter_t(%s, %s, %s)", _brand1, _brand2, _brand3);
 	}
 };
 
@@ -336,7 +336,7 @@ struct q19_join_filter_t : public tuple_filter_t {
 	}
 
 	virtual c_str to_string() const {
-		return c_str("q19_join_filter_t");
+		return c_str("q19_join_filter_t(%d, %d, %d)", _quantity[0], _quantity[1], _quantity[2]);
 	}
 };
 
@@ -278,7 +278,7 @@ public:
 	}
 
 	c_str to_string() const {
-		return c_str("q20_part_tscan_filter_t()");
+		return c_str("q20_part_tscan_filter_t(%s)", _color);
 	}
 };
 
@@ -487,7 +487,11 @@ public:
 	}
 
 	c_str to_string() const {
-		return c_str("q20_lineitem_tscan_filter_t()");
+		char f_shipdate[15];
+		char l_shipdate[15];
+		timet_to_str(f_shipdate, _first_shipdate);
+		timet_to_str(l_shipdate, _last_shipdate);
+		return c_str("q20_lineitem_tscan_filter_t(between(%s, %s))", f_shipdate, l_shipdate);
 	}
 };
 
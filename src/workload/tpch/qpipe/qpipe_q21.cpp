@@ -210,7 +210,7 @@ public:
 	}
 
 	c_str to_string() const {
-		return c_str("q21_nation_tscan_filter_t()");
+		return c_str("q21_nation_tscan_filter_t(%s)", _nname);
 	}
 };
 
@@ -178,8 +178,7 @@ public:
 	}
 
 	c_str to_string() const {
-		//return c_str("q3_customer_tscan_filter_t(%s)", _mktsegment);
-		return c_str("q3_customer_tscan_filter_t");
+		return c_str("q3_customer_tscan_filter_t(%s)", _mktsegment);
 	}
 };
 
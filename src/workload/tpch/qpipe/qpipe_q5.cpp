@@ -208,7 +208,7 @@ public:
 	}
 
 	c_str to_string() const {
-		return c_str("q5_region_tscan_filter_t()");
+		return c_str("q5_region_tscan_filter_t(%s)", _name);
 	}
 };
 
@@ -404,7 +404,11 @@ public:
 	}
 
 	c_str to_string() const {
-		return c_str("q5_orders_tscan_filter_t()");
+		char t1[15];
+		char t2[15];
+		timet_to_str(t1, q5_input->o_orderdate);
+		timet_to_str(t2, _last_orderdate);
+		return c_str("q5_orders_tscan_filter_t(between(%s, %s))", t1, t2);
 	}
 };
 
@@ -31,6 +31,7 @@
 
 #include "workload/tpch/shore_tpch_env.h"
 #include "qpipe.h"
+#include "qpipe/common/predicates.h"
 
 using namespace shore;
 using namespace qpipe;
@@ -77,38 +78,68 @@ struct q6_aggregate_tuple {
 };
 
 
-//Q6 scan filter (selection and projection)
-class q6_tscan_filter_t : public tuple_filter_t 
+// The Q6 shipdate range, as 'YYYY-MM-DD' strings: [date1, date2)
+static void q6_shipdates(const q6_input_t& in, char* date1, char* date2)
+{
+    struct tm date;
+    gmtime_r(&(in.l_shipdate), &date);
+    date.tm_year ++;
+    time_t last_shipdate = mktime(&date);
+
+    timet_to_str(date1, in.l_shipdate);
+    timet_to_str(date2, last_shipdate);
+    date1[10] = date2[10] = '\0'; // YYYY-MM-DD
+}
+
+
+// The Q6 selection, on the lineitem records. The discount is stored
+// multiplied by 100, so its range is widened a bit for the rounding of
+// the multiplication. The cheap double compares go first, the dates are
+// compared only for the rows that pass them.
+static predicate_t* q6_predicate(table_desc_t* plineitem, const q6_input_t& in)
+{
+    char date1[15];
+    char date2[15];
+    q6_shipdates(in, date1, date2);
+
+    and_predicate_t* p = new and_predicate_t();
+    p->add(new range_predicate_t<double>((in.l_discount-0.01)*100.0 - 1e-6,
+                                         (in.l_discount+0.01)*100.0 + 1e-6,
+                                         plineitem->disk_offset(6)));
+    p->add(new scalar_predicate_t<double, less>(in.l_quantity,
+                                                plineitem->disk_offset(4)));
+    p->add(new fixchar_range_predicate_t(date1, date2,
+                                         plineitem->disk_offset(10)));
+    return (p);
+}
+
+static c_str q6_filter_name(const q6_input_t& in)
+{
+    char date1[15];
+    char date2[15];
+    q6_shipdates(in, date1, date2);
+    return (c_str("q6_tscan_filter_t(%s, %s, %lf, %lf)",
+                  date1, date2, in.l_discount, in.l_quantity));
+}
+
+
+//Q6 scan filter (selection and projection). The selection is evaluated
+//a page at a time, the projection reads its fields off the record.
+class q6_tscan_filter_t : public predicate_filter_t 
 {
 private:
-    ShoreTPCHEnv* _tpchdb;
-    table_row_t* _prline;
-    rep_row_t _rr;
-
-    /*One lineitem tuple*/
-    tpch_lineitem_tuple _lineitem;
-    /*The columns needed for the selection*/
-    time_t _shipdate;
-    double _discount;
-    double _quantity;
-
-    /* Random Predicates */
-    /* TPC-H Specification 2.9.3 */
-    q6_input_t* q6_input;
-    time_t _last_l_shipdate;
+    size_t _extendedprice;
+    size_t _discount;
+
 public:
 
     q6_tscan_filter_t(ShoreTPCHEnv* tpchdb, q6_input_t &in)
-        : tuple_filter_t(tpchdb->lineitem_desc()->maxsize()), _tpchdb(tpchdb)
-          //: tuple_filter_t(sizeof(tpch_lineitem_tuple)), _tpchdb(tpchdb)
+        : predicate_filter_t(tpchdb->lineitem_desc()->maxsize(),
+                             q6_predicate(tpchdb->lineitem_desc(), in),
+                             q6_filter_name(in)),
+          _extendedprice(tpchdb->lineitem_desc()->disk_offset(5)),
+          _discount(tpchdb->lineitem_desc()->disk_offset(6))
     {
-
-    	// Get a lineitem tupple from the tuple cache and allocate space
-        _prline = _tpchdb->lineitem_man()->get_tuple();
-        _rr.set_ts(_tpchdb->lineitem_man()->ts(),
-                   _tpchdb->lineitem_desc()->maxsize());
-        _prline->_rep = &_rr;
-
         // Generate the random predicates
 	/* Predicate:
    	   l_shipdate >= 'YEAR-01-01'
@@ -116,55 +147,10 @@ public:
 	   and l_discount between DISCOUNT - 0.01 and DISCOUNT + 0.01
 	   and l_quantity < QUANTITY
 	*/        
-	q6_input=&in;
-      	struct tm date;
-	gmtime_r(&(q6_input->l_shipdate), &date);
-	date.tm_year ++;
-	_last_l_shipdate=mktime(&date);
-
 	char date1[15];
 	char date2[15];
-	timet_to_str(date1,q6_input->l_shipdate);
-	timet_to_str(date2,_last_l_shipdate);
-	TRACE(TRACE_ALWAYS, "Random predicates: Date: %s-%s, Discount: %lf, Quantity: %lf\n", date1, date2, q6_input->l_discount, q6_input->l_quantity);
-    }
-
-    ~q6_tscan_filter_t()
-    {
-        // Give back the lineitem tuple 
-        _tpchdb->lineitem_man()->give_tuple(_prline);
-    }
-
-
-    // Predication
-    bool select(const tuple_t &input) {
-
-        // Get next lineitem and read its shipdate
-        if (!_tpchdb->lineitem_man()->load(_prline, input.data)) {
-            assert(false); // RC(se_WRONG_DISK_DATA)
-        }
-
-        _prline->get_value(10, _lineitem.L_SHIPDATE, 15); //get column 10 (15 characters)
-        _shipdate = str_to_timet(_lineitem.L_SHIPDATE);        
-        _prline->get_value(6, _lineitem.L_DISCOUNT); //get column 6 (float)
-        _discount=_lineitem.L_DISCOUNT/100.0;
-#warning MA: Discount from TPCH dbgen is created between 0 and 100 instead between 0 and 1.
-        _prline->get_value(4, _lineitem.L_QUANTITY); //get column 4 (float)
-        _quantity=_lineitem.L_QUANTITY;
-
-
-
-        // Return true if it passes the filter
-		if  ( _shipdate >= q6_input->l_shipdate && _shipdate < _last_l_shipdate && _discount>=(q6_input->l_discount-0.01) &&
-				_discount<=(q6_input->l_discount+0.01) && _quantity<q6_input->l_quantity) {
-
-			//TRACE(TRACE_RECORD_FLOW, "+ %s, %lf, %lf\n", _lineitem.L_SHIPDATE, _lineitem.L_DISCOUNT, _lineitem.L_QUANTITY);
-			return (true);
-		}
-		else {
-				//TRACE(TRACE_RECORD_FLOW, ". %s, %lf, %lf\n", _lineitem.L_SHIPDATE, _lineitem.L_DISCOUNT, _lineitem.L_QUANTITY);
-			return (false);
-		}
+	q6_shipdates(in, date1, date2);
+	TRACE(TRACE_ALWAYS, "Random predicates: Date: %s-%s, Discount: %lf, Quantity: %lf\n", date1, date2, in.l_discount, in.l_quantity);
     }
 
     
@@ -174,30 +160,36 @@ public:
         q6_projected_lineitem_tuple *dest;
         dest = aligned_cast<q6_projected_lineitem_tuple>(d.data);
 
-        _prline->get_value(5, _lineitem.L_EXTENDEDPRICE);
-        _prline->get_value(6, _lineitem.L_DISCOUNT);
-
-        /*TRACE( TRACE_RECORD_FLOW, "%.2f|%.2f\n",
-               _lineitem.L_EXTENDEDPRICE / 100.0,
-               _lineitem.L_DISCOUNT / 100.0);*/
-
-        dest->L_EXTENDEDPRICE = _lineitem.L_EXTENDEDPRICE / 100.0;
-        dest->L_DISCOUNT = _lineitem.L_DISCOUNT/100.0;
+        dest->L_EXTENDEDPRICE = load_field<double>(s.data + _extendedprice) / 100.0;
+        dest->L_DISCOUNT = load_field<double>(s.data + _discount) / 100.0;
 #warning MA: Discount from TPCH dbgen is created between 0 and 100 instead between 0 and 1.
     }
 
     q6_tscan_filter_t* clone() const {
         return new q6_tscan_filter_t(*this);
     }
-
-    c_str to_string() const {
-	char date[15];
-	timet_to_str(date,q6_input->l_shipdate);
-        return c_str("q6_tscan_filter_t(%s, %lf, %lf)", date, q6_input->l_discount, q6_input->l_quantity);
-    }
 };
 
 
+// The Q6 selection, pushed down to the lineitem scan. The values are
+// in the stored (scaled) domain. The ranges only need to include the
+// qualifying rows, the filter re-checks them: the discount is widened a
+// bit because of the multiplication.
+static vector<column_pred_t> q6_column_preds(const q6_input_t& in)
+{
+    char date1[15];
+    char date2[15];
+    q6_shipdates(in, date1, date2);
+
+    vector<column_pred_t> preds;
+    preds.push_back(column_pred_t(10).ge(date1).lt(date2));
+    preds.push_back(column_pred_t(6).ge((in.l_discount-0.01)*100.0 - 1e-6).
+                    le((in.l_discount+0.01)*100.0 + 1e-6));
+    preds.push_back(column_pred_t(4).lt(in.l_quantity));
+    return (preds);
+}
+
+
 //Multiplication
 /**
  * @brief This sieve receives a double[2] and output a double.
@@ -366,6 +358,14 @@ where
                            /*, SH */
                            );
 
+#ifndef USE_ECHO
+    // Scan the columnar replica instead, if lineitem has one, or skip
+    // pages by its zone maps
+    q6_tscan_packet->where(q6_column_preds(in));
+    q6_tscan_packet->use_columns(_plineitem_man->columns());
+    q6_tscan_packet->use_zones(_plineitem_man->zonemaps());
+#endif
+
 
     // ECHO (filter)
 #ifdef USE_ECHO
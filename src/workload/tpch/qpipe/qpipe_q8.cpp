@@ -964,7 +964,7 @@ struct q8_aggregate_t : public tuple_aggregate_t {
 		return new q8_aggregate_t(*this);
 	}
 	virtual c_str to_string() const {
-		return "q8_aggregate_t";
+		return c_str("q8_aggregate_t(%s)", _nation);
 	}
 };
 
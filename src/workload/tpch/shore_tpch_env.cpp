@@ -178,6 +178,8 @@ void ShoreTPCHEnv::table_creator_t::work()
     _env->_porders_man->register_table_man();
     _env->_plineitem_man->register_table_man();
 
+    // If bulk-loading, even the baseline only collects the index entries
+    _env->start_bulkload();
 
     // Do the baseline transaction
     populate_baseline_input_t in = {_sf, _loader_count, DIVISOR, 
@@ -297,9 +299,9 @@ ShoreTPCHEnv::ShoreTPCHEnv()
     _scaling_factor = TPCH_SCALING_FACTOR;
 
 #ifdef CFG_QPIPE
-    // Set the default scheduling policy. We will worry later about changing
-    // that, possibly through the shell
-    set_sched_policy(NULL);
+    // Set the scheduling policy (OS, RR_CPU, QUERY_CPU, RR_MODULE or
+    // PIPELINE). We will worry later about changing that through the shell
+    set_sched_policy(envVar::instance()->getVar("qpipe-sched-policy","OS").c_str());
 
     // Register stage containers
     register_stage_containers();
@@ -334,6 +336,18 @@ w_rc_t ShoreTPCHEnv::load_schema()
     _pcustomer_man = new customer_man_impl(_pcustomer_desc.get());
     _porders_man   = new orders_man_impl(_porders_desc.get());
     _plineitem_man = new lineitem_man_impl(_plineitem_desc.get());
+
+    // the zone maps of the date columns of the fact tables, if configured
+    int zone_pages = envVar::instance()->getVarInt("db-zonemaps",0);
+    if (zone_pages > 0) {
+        vector<uint_t> lcols;
+        lcols.push_back(10); // L_SHIPDATE
+        lcols.push_back(11); // L_COMMITDATE
+        lcols.push_back(12); // L_RECEIPTDATE
+        _plineitem_man->enable_zonemaps(lcols, zone_pages);
+        vector<uint_t> ocols(1, 4); // O_ORDERDATE
+        _porders_man->enable_zonemaps(ocols, zone_pages);
+    }
                 
     return (RCOK);
 }
@@ -395,6 +409,11 @@ policy_t* ShoreTPCHEnv::set_sched_policy(const char* spolicy)
             _sched_policy = new policy_rr_module_t();
             return (_sched_policy);
         }
+
+        if ( !strcmp(spolicy, "PIPELINE") ) {
+            _sched_policy = new policy_pipeline_t();
+            return (_sched_policy);
+        }
     }
     // Use the default scheduling policy (let the OS choose) 
     TRACE( TRACE_ALWAYS, "Default scheduling policy (OS)\n");
@@ -431,6 +450,33 @@ int ShoreTPCHEnv::info() const
 
 int ShoreTPCHEnv::statistics() 
 {
+#ifdef CFG_QPIPE
+    if (qpipe::coro_pool_t::enabled())
+        qpipe::coro_pool_t::instance()->print_stats();
+    qpipe::mem_broker_t::instance()->print_stats();
+    if (qpipe::result_cache_t::instance()->enabled())
+        qpipe::result_cache_t::instance()->print_stats();
+    if (qpipe::page_io_pool_t::instance() != NULL)
+        qpipe::page_io_pool_t::instance()->print_stats();
+#endif
+    return (0);
+}
+
+
+
+/******************************************************************** 
+ *
+ *  @fn:    mem_grants
+ *
+ *  @brief: Prints the memory grants of the QPipe packets
+ *
+ ********************************************************************/
+
+int ShoreTPCHEnv::mem_grants() 
+{
+#ifdef CFG_QPIPE
+    qpipe::mem_broker_t::instance()->print_grants();
+#endif
     return (0);
 }
 
@@ -486,6 +532,10 @@ w_rc_t ShoreTPCHEnv::loaddata()
     // 1. Call the function that initializes the dbgen
     dbgen_init();
 
+    // the tables are created empty, so are their zone maps
+    if (_plineitem_man->zonemaps()) _plineitem_man->zonemaps()->reset();
+    if (_porders_man->zonemaps()) _porders_man->zonemaps()->reset();
+
 
     time_t tstart = time(NULL);
 
@@ -541,6 +591,8 @@ w_rc_t ShoreTPCHEnv::loaddata()
 	loaders[i]->join();
     }
 
+    W_DO(finish_bulkload(loaders_to_use));
+
     time_t tstop = time(NULL);
 
     // 5. Print stats
@@ -551,6 +603,11 @@ w_rc_t ShoreTPCHEnv::loaddata()
     _loaded = true;
     chk->join();
 
+    // 7. Build the columnar replicas, if configured
+    if (envVar::instance()->getVarInt("db-columnar",0)) {
+        db_columns_init();
+    }
+
     return (RCOK);
 }
 
@@ -585,6 +642,24 @@ w_rc_t ShoreTPCHEnv::warmup()
 }
 
 
+/****************************************************************** 
+ *
+ * @fn:    db_columns()
+ *
+ * @brief: (Re)builds the columnar replicas of LINEITEM and ORDERS
+ *
+ ******************************************************************/
+
+w_rc_t ShoreTPCHEnv::db_columns()
+{
+    _plineitem_man->enable_columns();
+    _porders_man->enable_columns();
+    W_DO(_plineitem_man->refresh_columns(_pssm));
+    W_DO(_porders_man->refresh_columns(_pssm));
+    return (RCOK);
+}
+
+
 /******************************************************************** 
  *
  *  @fn:    dump
@@ -634,11 +709,14 @@ int ShoreTPCHEnv::post_init()
 	db()->abort_xct();
 	return (rc.err_num());
     }
-    else {
-	TRACE( TRACE_ALWAYS, "-> Done\n");
-	db()->commit_xct();
-	return (0);
-    }
+    TRACE( TRACE_ALWAYS, "-> Done\n");
+    db()->commit_xct();
+
+    // the zone maps of an existing database, if enabled
+    rc = _plineitem_man->refresh_zonemaps(db());
+    if (!rc.is_error()) rc = _porders_man->refresh_zonemaps(db());
+    if (rc.is_error()) return (rc.err_num());
+    return (0);
 }
 
 
@@ -1799,6 +1799,31 @@ w_rc_t ShoreTPCHEnv::xct_q6(const int /* xct_id */, q6_input_t& pq6in)
     }
     date.tm_year ++;
     time_t last_shipdate = mktime(&date);
+
+    bool eof;
+    tpch_lineitem_tuple aline;
+    double q6_result = 0;
+
+    // scan the columnar replica instead of the index, if there is a valid one
+    column_scan_t cscan(_plineitem_man->columns());
+    if (cscan.opened()) {
+	char lowdate[15];
+	char highdate[15];
+	timet_to_str(lowdate, pq6in.l_shipdate);
+	timet_to_str(highdate, last_shipdate);
+	lowdate[10] = highdate[10] = '\0'; // YYYY-MM-DD
+
+	cscan.where(column_pred_t(10).ge(lowdate).lt(highdate));
+	cscan.where(column_pred_t(6).gt(pq6in.l_discount - 0.01).
+		    lt(pq6in.l_discount + 0.01));
+	cscan.where(column_pred_t(4).lt(pq6in.l_quantity));
+	while (cscan.next_block()) {
+	    for (uint i=0; i<cscan.count(); i++) {
+		q6_result += (cscan.get_double(5,i) * cscan.get_double(6,i));
+	    }
+	}
+	return RCOK;
+    }
     
     guard< index_scan_iter_impl<lineitem_t> > l_iter;
     {
@@ -1810,10 +1835,6 @@ w_rc_t ShoreTPCHEnv::xct_q6(const int /* xct_id */, q6_input_t& pq6in)
 	l_iter = tmp_l_iter;
     }
 
-    bool eof;
-    tpch_lineitem_tuple aline;
-    double q6_result = 0;
-
     W_DO(l_iter->next(_pssm, eof, *prlineitem));
 
     while (!eof) {